@@ -0,0 +1,132 @@
+// `bvh_build` time per million triangles and ray query throughput, on a wavy height field
+// of about 2M triangles (`./bench_bvh <triangles>` picks another size).
+#include "../src/f32/bvh.h"
+#include "../src/f32/math_impl.h"
+#include "../src/cpu/features.h"
+#include <time.h>
+
+#define RAYS 1000000
+#define BUILD_ROUNDS 3
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+static u32 rng=12345;
+
+/// Uniform in [0,1).
+static f32 random_f32() {
+  rng=rng*1664525u+1013904223u;
+  return (f32)(rng>>8)*(1.0F/16777216.0F);
+}
+
+/// A `side` by `side` grid of quads over [-1,1]^2, two triangles each.
+static void height_field(usize side,Vec3* vertices,u32* indices) {
+  const usize columns=side+1;
+  for(usize j=0;j<columns;j++) {
+    for(usize i=0;i<columns;i++) {
+      const f32 x=2.0F*(f32)i/(f32)side-1.0F;
+      const f32 y=2.0F*(f32)j/(f32)side-1.0F;
+      vertices[j*columns+i]=vec3_new(x,y,0.1F*sinf(12.0F*x)*cosf(9.0F*y));
+    }
+  }
+  for(usize j=0;j<side;j++) {
+    for(usize i=0;i<side;i++) {
+      const u32 v=(u32)(j*columns+i);
+      u32* quad=indices+6*(j*side+i);
+      quad[0]=v;
+      quad[1]=v+1;
+      quad[2]=v+(u32)columns;
+      quad[3]=v+1;
+      quad[4]=v+(u32)columns+1;
+      quad[5]=v+(u32)columns;
+    }
+  }
+}
+
+static void measure_build(const char* name,const Vec3* vertices,const u32* indices,usize triangles,BvhOptions options) {
+  f64 best=F32_INFINITY;
+  for(usize r=0;r<BUILD_ROUNDS;r++) {
+    const f64 start=now_ns();
+    Bvh bvh=bvh_build(vertices,indices,triangles,options);
+    best=MIN(best,now_ns()-start);
+    bvh_free(&bvh);
+  }
+  printf("%-36s %8.1f ms/Mtri\n",name,best*1e-6/((f64)triangles*1e-6));
+}
+
+static void measure_queries(const char* name,const Bvh* bvh,const Ray* rays) {
+  f64 start=now_ns();
+  usize hits=0;
+  for(usize i=0;i<RAYS;i++) {
+    BvhHit hit;
+    hits+=bvh_closest_hit(bvh,rays[i],&hit);
+  }
+  f64 elapsed=now_ns()-start;
+  printf("%-36s %8.2f Mrays/s closest (%zu hits)\n",name,(f64)RAYS*1e3/elapsed,hits);
+  start=now_ns();
+  hits=0;
+  for(usize i=0;i<RAYS;i++) {
+    hits+=bvh_any_hit(bvh,rays[i]);
+  }
+  elapsed=now_ns()-start;
+  printf("%-36s %8.2f Mrays/s any (%zu hits)\n",name,(f64)RAYS*1e3/elapsed,hits);
+}
+
+int main(int argc,char** argv) {
+  const usize requested=argc>1? (usize)strtoull(argv[1],NULL,10) : 2000000;
+  usize side=1;
+  while(2*(side+1)*(side+1)<=requested) {
+    side++;
+  }
+  const usize triangles=2*side*side;
+  Vec3* vertices=malloc((side+1)*(side+1)*sizeof(Vec3));
+  u32* indices=malloc(3*triangles*sizeof(u32));
+  Ray* primary=malloc(RAYS*sizeof(Ray));
+  Ray* incoherent=malloc(RAYS*sizeof(Ray));
+  if(vertices==NULL || indices==NULL || primary==NULL || incoherent==NULL) {
+    panic("bench_bvh: out of memory\n");
+  }
+  height_field(side,vertices,indices);
+  // Primary rays from a pinhole above the field, in scanline order, so neighbours visit
+  // the same nodes; and rays with random origins and directions, which mostly miss the
+  // caches.
+  const usize width=1000;
+  for(usize i=0;i<RAYS;i++) {
+    const f32 x=2.0F*(f32)(i%width)/(f32)width-1.0F;
+    const f32 y=2.0F*(f32)(i/width)/(f32)(RAYS/width)-1.0F;
+    primary[i]=ray_new(vec3_new(0.0F,-2.0F,2.0F),vec3_new(x,y+2.0F,-2.0F));
+    incoherent[i]=ray_new(
+      vec3_new(2.0F*random_f32()-1.0F,2.0F*random_f32()-1.0F,0.5F),
+      vec3_new(2.0F*random_f32()-1.0F,2.0F*random_f32()-1.0F,-random_f32()));
+  }
+
+  printf("tier: %s, %zu triangles\n",cmeth_cpu_tier_name(cmeth_cpu_tier()),triangles);
+  BvhOptions options=BVH_OPTIONS_DEFAULT;
+  options.threads=1;
+  measure_build("bvh_build width=2 threads=1",vertices,indices,triangles,options);
+  options.width=8;
+  measure_build("bvh_build width=8 threads=1",vertices,indices,triangles,options);
+  options.threads=0;
+  measure_build("bvh_build width=8 threads=all",vertices,indices,triangles,options);
+  options.width=2;
+  measure_build("bvh_build width=2 threads=all",vertices,indices,triangles,options);
+
+  Bvh bvh=bvh_build(vertices,indices,triangles,options);
+  measure_queries("bvh width=2 primary",&bvh,primary);
+  measure_queries("bvh width=2 incoherent",&bvh,incoherent);
+  bvh_free(&bvh);
+  options.width=8;
+  bvh=bvh_build(vertices,indices,triangles,options);
+  measure_queries("bvh width=8 primary",&bvh,primary);
+  measure_queries("bvh width=8 incoherent",&bvh,incoherent);
+  bvh_free(&bvh);
+
+  free(incoherent);
+  free(primary);
+  free(indices);
+  free(vertices);
+  return 0;
+}
@@ -0,0 +1,250 @@
+#define _GNU_SOURCE
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <x86intrin.h>
+#include "harness.h"
+#include "../src/cpu/features.h"
+
+// Cycles come from a `perf_event_open` cpu-cycles counter when the kernel allows it, and
+// from `rdtsc` otherwise. The report says which: TSC ticks run at the nominal frequency, so
+// they only equal core cycles when turbo and power saving are off.
+
+typedef struct {
+  const char* filter;
+  usize samples;
+  u64 sample_ns;
+  u64 warmup_ns;
+  i32 cpu;
+  const char* out;
+  const char* compare;
+  f64 threshold;
+} BenchOptions;
+
+static i32 _perf_fd=-1;
+
+
+static u64 _now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (u64)ts.tv_sec*1000000000ull+(u64)ts.tv_nsec;
+}
+
+static void _open_cycle_counter() {
+  struct perf_event_attr attr;
+  memset(&attr,0,sizeof(attr));
+  attr.type=PERF_TYPE_HARDWARE;
+  attr.size=sizeof(attr);
+  attr.config=PERF_COUNT_HW_CPU_CYCLES;
+  attr.exclude_kernel=1;
+  attr.exclude_hv=1;
+  _perf_fd=(i32)syscall(SYS_perf_event_open,&attr,0,-1,-1,0);
+  if(_perf_fd>=0) {
+    ioctl(_perf_fd,PERF_EVENT_IOC_ENABLE,0);
+  }
+}
+
+static u64 _cycles() {
+  if(_perf_fd>=0) {
+    u64 count=0;
+    if(read(_perf_fd,&count,sizeof(count))==sizeof(count)) {
+      return count;
+    }
+  }
+  _mm_lfence();
+  const u64 tsc=__rdtsc();
+  _mm_lfence();
+  return tsc;
+}
+
+static int _cmp_f64(const void* a,const void* b) {
+  const f64 x=*(const f64*)a;
+  const f64 y=*(const f64*)b;
+  return (x>y)-(x<y);
+}
+
+/// Nearest-rank percentile of a sorted array.
+static f64 _percentile(const f64* sorted,usize len,f64 pct) {
+  usize rank=(usize)(pct/100.0*(f64)len+0.999999);
+  if(rank<1) rank=1;
+  if(rank>len) rank=len;
+  return sorted[rank-1];
+}
+
+static BenchResult _run_bench(const Bench* bench,const BenchOptions* options) {
+  // Calibrate the iteration count so one sample lasts at least `sample_ns`.
+  usize iters=1;
+  for(;;) {
+    const u64 start=_now_ns();
+    bench->run(iters);
+    if(_now_ns()-start>=options->sample_ns || iters>=((usize)1<<40)) break;
+    iters*=2;
+  }
+
+  const u64 warmup_end=_now_ns()+options->warmup_ns;
+  while(_now_ns()<warmup_end) {
+    bench->run(iters);
+  }
+
+  f64* ns=malloc(options->samples*sizeof(f64));
+  f64* cycles=malloc(options->samples*sizeof(f64));
+  const f64 ops=(f64)iters*(f64)bench->ops_per_iter;
+  for(usize s=0;s<options->samples;s++) {
+    const u64 c0=_cycles();
+    const u64 t0=_now_ns();
+    bench->run(iters);
+    const u64 t1=_now_ns();
+    const u64 c1=_cycles();
+    ns[s]=(f64)(t1-t0)/ops;
+    cycles[s]=(f64)(c1-c0)/ops;
+  }
+  qsort(ns,options->samples,sizeof(f64),_cmp_f64);
+  qsort(cycles,options->samples,sizeof(f64),_cmp_f64);
+
+  const BenchResult result={
+    .name=bench->name,
+    .median_ns=_percentile(ns,options->samples,50.0),
+    .p99_ns=_percentile(ns,options->samples,99.0),
+    .median_cycles=_percentile(cycles,options->samples,50.0),
+    .p99_cycles=_percentile(cycles,options->samples,99.0),
+  };
+  free(ns);
+  free(cycles);
+  return result;
+}
+
+static void _write_json(FILE* out,const BenchResult* results,usize count,i32 cpu) {
+  fprintf(out,"{\n  \"tier\": \"%s\",\n  \"cpu\": %d,\n  \"cycles_source\": \"%s\",\n  \"results\": [\n",
+    cmeth_cpu_tier_name(cmeth_cpu_tier()),cpu,_perf_fd>=0? "perf" : "tsc");
+  for(usize i=0;i<count;i++) {
+    fprintf(out,"    {\"name\": \"%s\", \"median_ns\": %.4f, \"p99_ns\": %.4f, \"median_cycles\": %.4f, \"p99_cycles\": %.4f}%s\n",
+      results[i].name,results[i].median_ns,results[i].p99_ns,results[i].median_cycles,results[i].p99_cycles,
+      i+1<count? "," : "");
+  }
+  fprintf(out,"  ]\n}\n");
+}
+
+/// Looks up `"median_ns"` of the entry named `name` in a report written by `_write_json`.
+static bool _baseline_median(const char* json,const char* name,f64* median) {
+  char key[256];
+  snprintf(key,sizeof(key),"\"name\": \"%s\",",name);
+  const char* entry=strstr(json,key);
+  if(entry==NULL) return false;
+  const char* field=strstr(entry,"\"median_ns\":");
+  if(field==NULL) return false;
+  *median=strtod(field+strlen("\"median_ns\":"),NULL);
+  return true;
+}
+
+static char* _read_file(const char* path) {
+  FILE* file=fopen(path,"rb");
+  if(file==NULL) return NULL;
+  fseek(file,0,SEEK_END);
+  const long len=ftell(file);
+  fseek(file,0,SEEK_SET);
+  char* text=malloc((usize)len+1);
+  const usize read=fread(text,1,(usize)len,file);
+  text[read]='\0';
+  fclose(file);
+  return text;
+}
+
+static usize _compare(const char* path,const BenchResult* results,usize count,f64 threshold) {
+  char* json=_read_file(path);
+  if(json==NULL) {
+    fprintf(stderr,"bench: cannot read baseline %s\n",path);
+    return 1;
+  }
+
+  usize regressions=0;
+  for(usize i=0;i<count;i++) {
+    f64 base;
+    if(!_baseline_median(json,results[i].name,&base)) {
+      fprintf(stderr,"  new       %-36s %10.3f ns\n",results[i].name,results[i].median_ns);
+      continue;
+    }
+    const f64 change=(results[i].median_ns/base-1.0)*100.0;
+    if(change>threshold) {
+      regressions++;
+      fprintf(stderr,"  REGRESSED %-36s %10.3f -> %10.3f ns (%+.1f%%)\n",results[i].name,base,results[i].median_ns,change);
+    } else if(change< -threshold) {
+      fprintf(stderr,"  improved  %-36s %10.3f -> %10.3f ns (%+.1f%%)\n",results[i].name,base,results[i].median_ns,change);
+    }
+  }
+  fprintf(stderr,"bench: %zu regression(s) beyond %.1f%% against %s\n",regressions,threshold,path);
+  free(json);
+  return regressions;
+}
+
+static BenchOptions _parse_options(int argc,char** argv) {
+  BenchOptions options={
+    .filter=NULL,
+    .samples=31,
+    .sample_ns=200000,
+    .warmup_ns=20000000,
+    .cpu=-1,
+    .out=NULL,
+    .compare=NULL,
+    .threshold=5.0,
+  };
+  for(int i=1;i<argc;i++) {
+    const char* arg=argv[i];
+    if(strncmp(arg,"--filter=",9)==0) options.filter=arg+9;
+    else if(strncmp(arg,"--samples=",10)==0) options.samples=strtoull(arg+10,NULL,10);
+    else if(strncmp(arg,"--sample-us=",12)==0) options.sample_ns=strtoull(arg+12,NULL,10)*1000;
+    else if(strncmp(arg,"--warmup-ms=",12)==0) options.warmup_ns=strtoull(arg+12,NULL,10)*1000000;
+    else if(strncmp(arg,"--cpu=",6)==0) options.cpu=(i32)strtol(arg+6,NULL,10);
+    else if(strncmp(arg,"--out=",6)==0) options.out=arg+6;
+    else if(strncmp(arg,"--compare=",10)==0) options.compare=*(arg+10)? arg+10 : NULL;
+    else if(strncmp(arg,"--threshold=",12)==0) options.threshold=strtod(arg+12,NULL);
+    else {
+      panic("bench: unknown option %s\n",arg)
+    }
+  }
+  if(options.samples==0) {
+    options.samples=1;
+  }
+  return options;
+}
+
+int bench_main(int argc,char** argv,const Bench* benches,usize count) {
+  BenchOptions options=_parse_options(argc,argv);
+
+  if(options.cpu<0) {
+    options.cpu=sched_getcpu();
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(options.cpu,&set);
+  if(sched_setaffinity(0,sizeof(set),&set)!=0) {
+    fprintf(stderr,"bench: could not pin to cpu %d, running unpinned\n",options.cpu);
+  }
+  _open_cycle_counter();
+
+  BenchResult* results=malloc(count*sizeof(BenchResult));
+  usize ran=0;
+  for(usize i=0;i<count;i++) {
+    if(options.filter!=NULL && strstr(benches[i].name,options.filter)==NULL) continue;
+    results[ran]=_run_bench(&benches[i],&options);
+    fprintf(stderr,"%-36s %10.3f ns  p99 %10.3f ns  %10.2f cyc\n",
+      results[ran].name,results[ran].median_ns,results[ran].p99_ns,results[ran].median_cycles);
+    ran++;
+  }
+
+  FILE* out=options.out? fopen(options.out,"w") : stdout;
+  if(out==NULL) {
+    panic("bench: cannot write %s\n",options.out)
+  }
+  _write_json(out,results,ran,options.cpu);
+  if(out!=stdout) {
+    fclose(out);
+  }
+
+  const usize regressions=options.compare? _compare(options.compare,results,ran,options.threshold) : 0;
+  free(results);
+  return regressions>0;
+}
@@ -0,0 +1,37 @@
+#ifndef CMETH_BENCH_HARNESS_H
+#define CMETH_BENCH_HARNESS_H
+#include "../src/prelude.h"
+
+
+/// One timed function. `run(iters)` performs `iters*ops_per_iter` operations.
+typedef struct {
+  const char* name;
+  void (*run)(usize iters);
+  usize ops_per_iter;
+} Bench;
+
+/// Statistics of one benchmark, per operation.
+typedef struct {
+  const char* name;
+  f64 median_ns;
+  f64 p99_ns;
+  f64 median_cycles;
+  f64 p99_cycles;
+} BenchResult;
+
+/// Runs every bench in `benches` according to `argv` and reports them.
+///
+/// Options:
+/// - `--filter=SUBSTR` only runs benches whose name contains `SUBSTR`.
+/// - `--samples=N` timed samples per bench (default 31).
+/// - `--sample-us=N` minimum length of a sample in microseconds (default 200).
+/// - `--warmup-ms=N` untimed warmup per bench (default 20).
+/// - `--cpu=N` pins the process to cpu `N` (default: the cpu it starts on).
+/// - `--out=PATH` writes the JSON report to `PATH` instead of stdout.
+/// - `--compare=PATH` compares medians against a previous JSON report.
+/// - `--threshold=PCT` flags medians more than `PCT` percent slower (default 5).
+///
+/// Returns the process exit code: non-zero if `--compare` found a regression.
+int bench_main(int argc,char** argv,const Bench* benches,usize count);
+
+#endif
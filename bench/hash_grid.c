@@ -0,0 +1,81 @@
+// `hash_grid_rebuild` time and neighbour iteration throughput over 1M particles in a unit
+// cube (`./bench_hash_grid <particles>` picks another size). Rebuilds are measured for
+// particles in random order and in the order of the previous rebuild, as a simulation that
+// keeps its particles in grid order sees them.
+#include "../src/f32/hash_grid.h"
+#include "../src/f32/math_impl.h"
+#include "../src/cpu/features.h"
+#include <time.h>
+
+#define ROUNDS 5
+#define NEIGHBOUR_QUERIES 100000
+#define CELL_SIZE 0.02F
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+static u32 rng=12345;
+
+/// Uniform in [0,1).
+static f32 random_f32() {
+  rng=rng*1664525u+1013904223u;
+  return (f32)(rng>>8)*(1.0F/16777216.0F);
+}
+
+static void measure_rebuild(const char* name,HashGrid* grid,const Vec3* points,usize n) {
+  f64 best=F32_INFINITY;
+  for(usize r=0;r<ROUNDS;r++) {
+    const f64 start=now_ns();
+    hash_grid_rebuild(grid,points,n);
+    best=MIN(best,now_ns()-start);
+  }
+  printf("%-44s %8.2f ms\n",name,best*1e-6);
+}
+
+int main(int argc,char** argv) {
+  const usize n=argc>1? (usize)strtoull(argv[1],NULL,10) : 1000000;
+  Vec3* points=malloc(n*sizeof(Vec3));
+  Vec3* sorted=malloc(n*sizeof(Vec3));
+  if(points==NULL || sorted==NULL) {
+    panic("bench_hash_grid: out of memory\n");
+  }
+  for(usize i=0;i<n;i++) {
+    points[i]=vec3_new(random_f32(),random_f32(),random_f32());
+  }
+
+  printf("tier: %s, %zu particles\n",cmeth_cpu_tier_name(cmeth_cpu_tier()),n);
+  HashGrid single=hash_grid_new(CELL_SIZE,1);
+  HashGrid all=hash_grid_new(CELL_SIZE,0);
+  measure_rebuild("hash_grid_rebuild random threads=1",&single,points,n);
+  measure_rebuild("hash_grid_rebuild random threads=all",&all,points,n);
+  for(usize i=0;i<n;i++) {
+    sorted[i]=vec3_new(all.xs[i],all.ys[i],all.zs[i]);
+  }
+  measure_rebuild("hash_grid_rebuild grid order threads=1",&single,sorted,n);
+  measure_rebuild("hash_grid_rebuild grid order threads=all",&all,sorted,n);
+
+  // Neighbours of the particles in grid order, as a simulation step visits them.
+  const f64 start=now_ns();
+  usize neighbours=0;
+  const usize queries=n<NEIGHBOUR_QUERIES? n : NEIGHBOUR_QUERIES;
+  for(usize i=0;i<queries;i++) {
+    HashGridIter iter=hash_grid_neighbours(&all,sorted[i],CELL_SIZE);
+    u32 index;
+    f32 distance_squared;
+    while(hash_grid_next(&iter,&index,&distance_squared)) {
+      neighbours++;
+    }
+  }
+  const f64 elapsed=now_ns()-start;
+  printf("%-44s %8.1f ns/particle (%.1f neighbours)\n","hash_grid_neighbours radius=cell",
+    elapsed/(f64)queries,(f64)neighbours/(f64)queries);
+
+  hash_grid_free(&all);
+  hash_grid_free(&single);
+  free(sorted);
+  free(points);
+  return 0;
+}
@@ -0,0 +1,91 @@
+// `kdtree_build` time per million points and batched query throughput against the brute
+// force `vec3_distance_squared` loop, on a noisy spherical shell of 1M points
+// (`./bench_kdtree <points>` picks another size).
+#include "../src/f32/kdtree.h"
+#include "../src/f32/math_impl.h"
+#include "../src/cpu/features.h"
+#include <time.h>
+
+#define QUERIES 100000
+#define BRUTE_QUERIES 100
+#define K 8
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+static u32 rng=12345;
+
+/// Uniform in [-1,1).
+static f32 random_f32() {
+  rng=rng*1664525u+1013904223u;
+  return (f32)(rng>>8)*(2.0F/16777216.0F)-1.0F;
+}
+
+static void measure_build(const char* name,const Vec3* points,usize n,usize threads) {
+  const f64 start=now_ns();
+  KdTree tree=kdtree_build(points,n,threads);
+  printf("%-40s %8.1f ms/Mpt\n",name,(now_ns()-start)*1e-6/((f64)n*1e-6));
+  kdtree_free(&tree);
+}
+
+int main(int argc,char** argv) {
+  const usize n=argc>1? (usize)strtoull(argv[1],NULL,10) : 1000000;
+  Vec3* points=malloc(n*sizeof(Vec3));
+  Vec3* queries=malloc(QUERIES*sizeof(Vec3));
+  u32* indices=malloc(QUERIES*K*sizeof(u32));
+  f32* distances=malloc(QUERIES*K*sizeof(f32));
+  usize* counts=malloc(QUERIES*sizeof(usize));
+  if(points==NULL || queries==NULL || indices==NULL || distances==NULL || counts==NULL) {
+    panic("bench_kdtree: out of memory\n");
+  }
+  for(usize i=0;i<n;i++) {
+    const Vec3 dir=vec3_normalize_or(vec3_new(random_f32(),random_f32(),random_f32()),VEC3_X);
+    points[i]=vec3_mul_f32(dir,1.0F+0.01F*random_f32());
+  }
+  for(usize i=0;i<QUERIES;i++) {
+    queries[i]=vec3_add(points[(usize)(0.5F*(random_f32()+1.0F)*(f32)(n-1))],
+      vec3_new(0.01F*random_f32(),0.01F*random_f32(),0.01F*random_f32()));
+  }
+
+  printf("tier: %s, %zu points\n",cmeth_cpu_tier_name(cmeth_cpu_tier()),n);
+  measure_build("kdtree_build threads=1",points,n,1);
+  measure_build("kdtree_build threads=all",points,n,0);
+
+  KdTree tree=kdtree_build(points,n,0);
+  f64 start=now_ns();
+  kdtree_nearest_batch(&tree,queries,QUERIES,K,indices,distances,1);
+  printf("%-40s %8.3f us/query\n","kdtree_nearest_batch k=8 threads=1",(now_ns()-start)*1e-3/QUERIES);
+  start=now_ns();
+  kdtree_nearest_batch(&tree,queries,QUERIES,K,indices,distances,0);
+  printf("%-40s %8.3f us/query\n","kdtree_nearest_batch k=8 threads=all",(now_ns()-start)*1e-3/QUERIES);
+  start=now_ns();
+  kdtree_radius_batch(&tree,queries,QUERIES,0.02F,K,indices,distances,counts,0);
+  printf("%-40s %8.3f us/query\n","kdtree_radius_batch r=0.02 threads=all",(now_ns()-start)*1e-3/QUERIES);
+  kdtree_free(&tree);
+
+  // The loop the tree replaces: the nearest point only, so it is a lower bound of k=8.
+  start=now_ns();
+  u32 nearest=0;
+  for(usize q=0;q<BRUTE_QUERIES;q++) {
+    f32 best=F32_INFINITY;
+    for(usize i=0;i<n;i++) {
+      const f32 d=vec3_distance_squared(queries[q],points[i]);
+      if(d<best) {
+        best=d;
+        nearest=(u32)i;
+      }
+    }
+  }
+  __asm__ volatile("" : : "r"(nearest));
+  printf("%-40s %8.3f us/query\n","brute force k=1",(now_ns()-start)*1e-3/BRUTE_QUERIES);
+
+  free(counts);
+  free(distances);
+  free(indices);
+  free(queries);
+  free(points);
+  return 0;
+}
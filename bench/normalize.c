@@ -0,0 +1,46 @@
+// Precise against `_fast` normalization, inlined (`CMETH_HEADER_ONLY`) and over SoA arrays.
+#include "../src/f32/vec3.h"
+#include "../src/f32/vec3_soa.h"
+#include "../src/cpu/features.h"
+#include <time.h>
+
+#define LEN 4096
+#define ROUNDS 4000
+
+static Vec3 v[LEN];
+static Vec3 out[LEN];
+static f32 xs[LEN],ys[LEN],zs[LEN];
+static f32 xo[LEN],yo[LEN],zo[LEN];
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+#define MEASURE(NAME,BODY) { \
+  const f64 start=now_ns(); \
+  for(usize r=0;r<ROUNDS;r++) { \
+    BODY; \
+    __asm__ volatile("" : : "r"(out),"r"(xo),"r"(yo),"r"(zo) : "memory"); \
+  } \
+  printf("%-36s %8.3f ns/vec\n",NAME,(now_ns()-start)/((f64)LEN*ROUNDS)); \
+}
+
+int main() {
+  for(usize i=0;i<LEN;i++) {
+    v[i]=vec3_new((f32)i-2048.0F,(f32)(i%7)+1.0F,(f32)(i%13)*0.25F);
+    xs[i]=v[i].x;
+    ys[i]=v[i].y;
+    zs[i]=v[i].z;
+  }
+  const Vec3Soa soa=vec3_soa(xs,ys,zs,LEN);
+  const Vec3Soa soa_out=vec3_soa(xo,yo,zo,LEN);
+
+  printf("tier: %s\n",cmeth_cpu_tier_name(cmeth_cpu_tier()));
+  MEASURE("vec3_normalize_or_zero",for(usize i=0;i<LEN;i++) out[i]=vec3_normalize_or_zero(v[i]));
+  MEASURE("vec3_normalize_or_zero_fast",for(usize i=0;i<LEN;i++) out[i]=vec3_normalize_or_zero_fast(v[i]));
+  MEASURE("vec3_soa_normalize_or_zero",vec3_soa_normalize_or_zero(soa,soa_out));
+  MEASURE("vec3_soa_normalize_or_zero_fast",vec3_soa_normalize_or_zero_fast(soa,soa_out));
+  return 0;
+}
@@ -0,0 +1,129 @@
+// Scaling of the `_parallel` array kernels with the size of the `cmeth_parallel_for` pool,
+// on 16M floats and 4M points (`./bench_parallel <points>` picks another point count),
+// against the single-threaded kernels they split. Also times an empty job, which is the
+// cost of waking the workers and waiting for them.
+#include "../src/f32/math_batch.h"
+#include "../src/f32/affine3a_batch.h"
+#include "../src/f32/vec3_soa.h"
+#include "../src/f32/vec3_reduce.h"
+#include "../src/f32/math_impl.h"
+#include "../src/cpu/features.h"
+#include "../src/thread/pool.h"
+#include <time.h>
+
+#define ROUNDS 5
+#define EMPTY_JOBS 10000
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+static u32 rng=12345;
+
+/// Uniform in [-1,1).
+static f32 random_f32() {
+  rng=rng*1664525u+1013904223u;
+  return (f32)(rng>>8)*(2.0F/16777216.0F)-1.0F;
+}
+
+static void report(const char* name,usize threads,f64 best,f64 single) {
+  char label[64];
+  snprintf(label,sizeof(label),"%s x%zu",name,threads);
+  printf("%-40s %8.2f ms %6.2fx\n",label,best*1e-6,single/best);
+}
+
+static void touch(void* ctx,usize begin,usize end) {
+  __atomic_fetch_add((usize*)ctx,end-begin,__ATOMIC_RELAXED);
+}
+
+int main(int argc,char** argv) {
+  const usize n=argc>1? (usize)strtoull(argv[1],NULL,10) : 4u<<20;
+  const usize floats=4*n;
+  f32* x=malloc(floats*sizeof(f32));
+  f32* out=malloc(floats*sizeof(f32));
+  Vec3* points=malloc(n*sizeof(Vec3));
+  Vec3* moved=malloc(n*sizeof(Vec3));
+  f32* planes=malloc(3*n*sizeof(f32));
+  if(x==NULL || out==NULL || points==NULL || moved==NULL || planes==NULL) {
+    panic("bench_parallel: out of memory\n");
+  }
+  for(usize i=0;i<floats;i++) {
+    x[i]=random_f32()*100.0F;
+  }
+  for(usize i=0;i<n;i++) {
+    points[i]=vec3_new(random_f32(),random_f32(),random_f32());
+  }
+  for(usize i=0;i<3*n;i++) {
+    planes[i]=random_f32();
+  }
+  const Vec3Soa soa=vec3_soa(planes,planes+n,planes+2*n,n);
+  const Affine3A tf=affine3a_from_mat3_translation(mat3_from_rotation_z(0.3F),VEC3_ONE);
+
+  cmeth_thread_pool_configure(THREAD_POOL_OPTIONS_DEFAULT);
+  const usize online=cmeth_thread_pool_threads();
+  printf("tier: %s, %zu points, up to %zu threads\n",cmeth_cpu_tier_name(cmeth_cpu_tier()),n,online);
+  f64 single[4]={F32_INFINITY,F32_INFINITY,F32_INFINITY,F32_INFINITY};
+  Vec3 sum=VEC3_ZERO;
+  for(usize r=0;r<ROUNDS;r++) {
+    f64 t[5];
+    t[0]=now_ns();
+    f32_sin_batch(x,out,floats);
+    t[1]=now_ns();
+    affine3a_transform_points(&tf,points,moved,n);
+    t[2]=now_ns();
+    vec3_soa_normalize_or_zero(soa,soa);
+    t[3]=now_ns();
+    sum=vec3_add(sum,vec3_sum(points,n,VEC3_SUMMATION_PAIRWISE));
+    t[4]=now_ns();
+    for(usize k=0;k<4;k++) {
+      single[k]=MIN(single[k],t[k+1]-t[k]);
+    }
+  }
+  report("f32_sin_batch",1,single[0],single[0]);
+  report("affine3a_transform_points",1,single[1],single[1]);
+  report("vec3_soa_normalize_or_zero",1,single[2],single[2]);
+  report("vec3_sum",1,single[3],single[3]);
+
+  for(usize threads=1;threads<=online;threads*=2) {
+    cmeth_thread_pool_configure((ThreadPoolOptions){.threads=threads,.pin=true});
+    f64 best[5]={F32_INFINITY,F32_INFINITY,F32_INFINITY,F32_INFINITY,F32_INFINITY};
+    for(usize r=0;r<ROUNDS;r++) {
+      f64 t[6];
+      t[0]=now_ns();
+      f32_sin_batch_parallel(x,out,floats);
+      t[1]=now_ns();
+      affine3a_transform_points_parallel(&tf,points,moved,n);
+      t[2]=now_ns();
+      vec3_soa_normalize_or_zero_parallel(soa,soa);
+      t[3]=now_ns();
+      sum=vec3_add(sum,vec3_sum_parallel(points,n,VEC3_SUMMATION_PAIRWISE));
+      t[4]=now_ns();
+      usize touched=0;
+      for(usize j=0;j<EMPTY_JOBS;j++) {
+        cmeth_parallel_for(threads,1,touch,&touched);
+      }
+      t[5]=now_ns();
+      for(usize k=0;k<5;k++) {
+        best[k]=MIN(best[k],t[k+1]-t[k]);
+      }
+    }
+    report("f32_sin_batch_parallel",threads,best[0],single[0]);
+    report("affine3a_transform_points_parallel",threads,best[1],single[1]);
+    report("vec3_soa_normalize_or_zero_parallel",threads,best[2],single[2]);
+    report("vec3_sum_parallel",threads,best[3],single[3]);
+    char label[64];
+    snprintf(label,sizeof(label),"empty job x%zu",threads);
+    printf("%-40s %8.2f us\n",label,best[4]*1e-3/EMPTY_JOBS);
+  }
+  cmeth_thread_pool_shutdown();
+  printf("(sums: %g)\n",sum.x+sum.y+sum.z);
+
+  free(planes);
+  free(moved);
+  free(points);
+  free(out);
+  free(x);
+  return 0;
+}
@@ -0,0 +1,57 @@
+// Training workload for `make pgo`.
+//
+// Runs the `vec3`/`trig` API over a spread of inputs, including the zero, non-finite and
+// out-of-range cases, so the recorded branch profile matches real callers rather than one
+// hot path. Links against the `pgo-generate` archive; the counts land in ./pgo on exit.
+#include "../src/f32/vec3.h"
+#include "../src/f32/trig.h"
+#include "../src/f32/vec3_soa.h"
+
+#define LEN 4096
+#define ROUNDS 200
+
+static Vec3 points[LEN];
+static f32 xs[LEN],ys[LEN],zs[LEN],out[LEN];
+
+static u32 rng=0x9e3779b9;
+
+static f32 next_f32(f32 scale) {
+  rng^=rng<<13;
+  rng^=rng>>17;
+  rng^=rng<<5;
+  return ((f32)(rng>>8)/16777216.0F*2.0F-1.0F)*scale;
+}
+
+int main() {
+  for(usize i=0;i<LEN;i++) {
+    const f32 scale=(i%64==0)? 0.0F : (i%16==0)? 1e6F : 10.0F;
+    points[i]=vec3_new(next_f32(scale),next_f32(scale),next_f32(scale));
+    xs[i]=points[i].x;
+    ys[i]=points[i].y;
+    zs[i]=points[i].z;
+  }
+  points[1]=VEC3_INFINITY;
+  points[2]=VEC3_NAN;
+
+  f32 sink=0.0F;
+  for(usize r=0;r<ROUNDS;r++) {
+    for(usize i=0;i+1<LEN;i++) {
+      const Vec3 a=points[i];
+      const Vec3 b=points[i+1];
+      const Vec3 n=vec3_normalize_or_zero(a);
+      const Vec3 c=vec3_cross(n,vec3_normalize_or(b,VEC3_Y));
+      sink+=vec3_dot(c,a)+vec3_len(vec3_lerp(a,b,0.25F));
+      sink+=vec3_distance_squared(vec3_clamp(a,VEC3_NEG_ONE,VEC3_ONE),vec3_min(a,b));
+      sink+=vec3_element_sum(vec3_rem_euclid(a,vec3_add_f32(vec3_abs(b),1.0F)));
+      sink+=vec3_max_element(vec3_floor(vec3_mul_f32(vec3_max(a,b),0.5F)));
+      sink+=_atan2f(a.y,a.x)+_acos_approx_f32(n.z)+f32_div_euclid(a.x,b.y);
+      sink+=(f32)vec3_is_negative_bitmask(a)+(f32)vec3_is_finite(b);
+    }
+    Vec3Soa soa=vec3_soa(xs,ys,zs,LEN-r);
+    vec3_soa_len(soa,out);
+    sink+=out[r];
+  }
+
+  printf("pgo training done (sink=%g)\n",sink);
+  return 0;
+}
@@ -0,0 +1,52 @@
+// ns/op of the `vec3`/`trig` API as linked from `libcmeth.a`, for comparing build profiles.
+//
+// `make profile-report` builds one of these per profile and prints their rows side by side.
+// Unlike bench/vec3_inline.c this never uses `CMETH_HEADER_ONLY`: the point is to measure the
+// code inside the archive.
+#include "../src/f32/vec3.h"
+#include "../src/f32/trig.h"
+#include <time.h>
+
+#define LEN 1024
+#define ROUNDS 2000
+
+static Vec3 a[LEN];
+static Vec3 b[LEN];
+static volatile f32 sink;
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+#define MEASURE(NAME,EXPR) {                                   \
+  f32 acc=0.0F;                                                \
+  const f64 start=now_ns();                                    \
+  for(usize r=0;r<ROUNDS;r++) {                                \
+    for(usize i=0;i<LEN;i++) {                                 \
+      acc+=(EXPR);                                             \
+    }                                                          \
+  }                                                            \
+  sink=acc;                                                    \
+  printf("%-28s %-8s %8.2f ns/op\n",NAME,profile,(now_ns()-start)/((f64)LEN*ROUNDS)); \
+}
+
+int main(int argc,char** argv) {
+  const char* profile=argc>1? argv[1] : "?";
+  for(usize i=0;i<LEN;i++) {
+    a[i]=vec3_new((f32)i*0.01F-5.0F,(f32)(i%7)-3.0F,1.0F/(f32)(i+1));
+    b[i]=vec3_new((f32)(i%11)-5.0F,(f32)i*-0.02F,2.0F);
+  }
+
+  MEASURE("vec3_dot",vec3_dot(a[i],b[i]));
+  MEASURE("vec3_cross",vec3_cross(a[i],b[i]).y);
+  MEASURE("vec3_normalize_or_zero",vec3_normalize_or_zero(a[i]).x);
+  MEASURE("vec3_distance",vec3_distance(a[i],b[i]));
+  MEASURE("vec3_lerp",vec3_lerp(a[i],b[i],0.25F).z);
+  MEASURE("vec3_clamp",vec3_clamp(a[i],VEC3_NEG_ONE,VEC3_ONE).x);
+  MEASURE("vec3_rem_euclid",vec3_rem_euclid(a[i],b[i]).x);
+  MEASURE("_atan2f",_atan2f(a[i].y,a[i].x));
+  MEASURE("_acos_approx_f32",_acos_approx_f32(a[i].z));
+  return 0;
+}
@@ -0,0 +1,1077 @@
+#include "harness.h"
+#include "../src/bool/bvec3.h"
+#include "../src/bool/bvec3a.h"
+#include "../src/f32/math_impl.h"
+#include "../src/f32/trig.h"
+#include "../src/f32/vec3.h"
+#include "../src/f32/vec3a.h"
+#include "../src/f32/vec3_soa.h"
+#include "../src/f32/vec3_batch.h"
+#include "../src/f32/math_batch.h"
+#include "../src/f32/mat3.h"
+#include "../src/f32/mat4.h"
+#include "../src/f32/affine3a.h"
+#include "../src/f32/affine3a_batch.h"
+#include "../src/f32/quat.h"
+#include "../src/f32/quat_batch.h"
+#include "../src/f32/aabb.h"
+#include "../src/f32/ray.h"
+#include "../src/f32/ray_batch.h"
+#include "../src/f32/vec3_packed.h"
+#include "../src/f32/vec3_buffer.h"
+#include "../src/f32/vec3_reduce.h"
+#include "../src/f64/math_impl.h"
+#include "../src/f64/dvec3.h"
+#include "../src/f64/dvec3_batch.h"
+#include "../src/i32/ivec3.h"
+#include "../src/i32/ivec3_batch.h"
+#include "../src/u32/uvec3.h"
+#include <math.h>
+#include <stdlib.h>
+
+/// Every public function of the library, timed on a ring of precomputed
+/// inputs so the loop body only measures the call. `i & (LEN-1)` walks the
+/// ring; results go through `black_box` so nothing is dead-code eliminated.
+#define LEN 1024
+#define AT(arr) (arr)[i & (LEN-1)]
+
+#define V AT(v)
+#define W AT(w)
+#define U AT(u)
+#define N AT(n)
+#define VA AT(va)
+#define WA AT(wa)
+#define UA AT(ua)
+#define NA AT(na)
+#define B AT(b)
+#define BW AT(bw)
+#define BA AT(ba)
+#define BWA AT(bwa)
+#define F AT(f)
+#define G AT(g)
+#define H AT(h)
+#define IDX AT(idx)
+#define FLAG AT(flag)
+#define M3 AT(m3)
+#define M3W AT(m3w)
+#define M4 AT(m4)
+#define M4W AT(m4w)
+#define AF AT(af)
+#define AFW AT(afw)
+#define Q AT(q)
+#define QW AT(qw)
+#define BOX AT(box)
+#define BOXW AT(boxw)
+#define RAY AT(ray)
+#define DV AT(dv)
+#define DW AT(dw)
+#define DU AT(du)
+#define DN AT(dn)
+#define DF AT(df)
+#define DG AT(dg)
+#define DH AT(dh)
+#define IV AT(iv)
+#define IW AT(iw)
+#define ID AT(id)
+#define IS AT(is)
+#define UV AT(uv)
+#define UW AT(uw)
+#define UD AT(ud)
+#define US AT(us)
+
+#define black_box(EXPR) { \
+  const __typeof__(EXPR) _value=(EXPR); \
+  __asm__ volatile("" : : "m"(_value)); \
+}
+
+static Vec3 v[LEN],w[LEN],u[LEN],n[LEN],n2[LEN];
+static Vec3A va[LEN],wa[LEN],ua[LEN],na[LEN];
+static BVec3 b[LEN],bw[LEN];
+static BVec3A ba[LEN],bwa[LEN];
+static f32 f[LEN],g[LEN],h[LEN];
+static usize idx[LEN];
+static bool flag[LEN];
+static f64 d3[LEN][3];
+static f32 f3[LEN][3];
+static f32 f4[LEN][4];
+static bool b3[LEN][3];
+static __m128 m[LEN];
+static Mat3 m3[LEN],m3w[LEN];
+static Mat4 m4[LEN],m4w[LEN];
+static Affine3A af[LEN],afw[LEN];
+static Quat q[LEN],qw[LEN],qo[LEN];
+static Aabb box[LEN],boxw[LEN];
+static Ray ray[LEN];
+static Vec3F16 n_f16[LEN],n_f16_out[LEN];
+static Vec3Snorm16 n_snorm16[LEN],n_snorm16_out[LEN];
+static Vec3Oct32 n_oct32[LEN],n_oct32_out[LEN];
+static DVec3 dv[LEN],dw[LEN],du[LEN],dn[LEN];
+static f64 df[LEN],dg[LEN],dh[LEN];
+static f64 d4[LEN][4];
+static IVec3 iv[LEN],iw[LEN],id[LEN],ivo[LEN];
+static UVec3 uv[LEN],uw[LEN],ud[LEN];
+static i32 is[LEN],i3[LEN][3];
+static u32 us[LEN],u3[LEN][3];
+static f32 f9[LEN][9];
+static f32 f16[LEN][16];
+
+static Vec3 acc_v;
+static DVec3 acc_dv;
+static IVec3 acc_iv;
+static UVec3 acc_uv;
+static Vec3A acc_va;
+static BVec3 acc_b;
+static BVec3A acc_ba;
+static f32 slice[3];
+static f64 dslice[3];
+static i32 islice[3];
+static u32 uslice[3];
+static f32 cols[16];
+
+static f32 xs[LEN],ys[LEN],zs[LEN];
+static f32 xs2[LEN],ys2[LEN],zs2[LEN];
+static f32 xo[LEN],yo[LEN],zo[LEN];
+static f32 out[LEN],out2[LEN];
+static Vec3Soa soa_a,soa_b,soa_out;
+static Vec3Buffer vbuf;
+static Aabb bounds_out;
+static Mat3 covariance_out;
+static Vec3 vo[LEN];
+static DVec3 dvo[LEN];
+static f64 dout[LEN];
+
+/// Benches that take one scalar-sized input per iteration.
+#define SCALAR_BENCHES(X) \
+  /* bool/bvec3.h */ \
+  X(bvec3,bvec3(FLAG,FLAG,FLAG)) \
+  X(bvec3_new,bvec3_new(FLAG,FLAG,FLAG)) \
+  X(bvec3_splat,bvec3_splat(FLAG)) \
+  X(bvec3_from_array,bvec3_from_array(AT(b3))) \
+  X(bvec3_from_bitmask,bvec3_from_bitmask((u32)IDX)) \
+  X(bvec3_bitmask,bvec3_bitmask(B)) \
+  X(bvec3_any,bvec3_any(B)) \
+  X(bvec3_all,bvec3_all(B)) \
+  X(bvec3_test,bvec3_test(B,IDX)) \
+  X(bvec3_set,(bvec3_set(&acc_b,IDX,FLAG),0)) \
+  X(bvec3_default,bvec3_default()) \
+  X(bvec3_bitand,bvec3_bitand(B,BW)) \
+  X(bvec3_bitand_assign,(bvec3_bitand_assign(&acc_b,B),0)) \
+  X(bvec3_bitor,bvec3_bitor(B,BW)) \
+  X(bvec3_bitor_assign,(bvec3_bitor_assign(&acc_b,B),0)) \
+  X(bvec3_bitxor,bvec3_bitxor(B,BW)) \
+  X(bvec3_bitxor_assign,(bvec3_bitxor_assign(&acc_b,B),0)) \
+  X(bvec3_bitnot,bvec3_bitnot(B)) \
+  /* bool/bvec3a.h */ \
+  X(bvec3a,bvec3a(FLAG,FLAG,FLAG)) \
+  X(bvec3a_new,bvec3a_new(FLAG,FLAG,FLAG)) \
+  X(bvec3a_splat,bvec3a_splat(FLAG)) \
+  X(bvec3a_from_array,bvec3a_from_array(AT(b3))) \
+  X(bvec3a_from_m128,bvec3a_from_m128(AT(m))) \
+  X(bvec3a_from_bitmask,bvec3a_from_bitmask((u32)IDX)) \
+  X(bvec3a_from_bvec3,bvec3a_from_bvec3(B)) \
+  X(bvec3_from_bvec3a,bvec3_from_bvec3a(BA)) \
+  X(bvec3a_bitmask,bvec3a_bitmask(BA)) \
+  X(bvec3a_any,bvec3a_any(BA)) \
+  X(bvec3a_all,bvec3a_all(BA)) \
+  X(bvec3a_test,bvec3a_test(BA,IDX)) \
+  X(bvec3a_set,(bvec3a_set(&acc_ba,IDX,FLAG),0)) \
+  X(bvec3a_default,bvec3a_default()) \
+  X(bvec3a_bitand,bvec3a_bitand(BA,BWA)) \
+  X(bvec3a_bitand_assign,(bvec3a_bitand_assign(&acc_ba,BA),0)) \
+  X(bvec3a_bitor,bvec3a_bitor(BA,BWA)) \
+  X(bvec3a_bitor_assign,(bvec3a_bitor_assign(&acc_ba,BA),0)) \
+  X(bvec3a_bitxor,bvec3a_bitxor(BA,BWA)) \
+  X(bvec3a_bitxor_assign,(bvec3a_bitxor_assign(&acc_ba,BA),0)) \
+  X(bvec3a_bitnot,bvec3a_bitnot(BA)) \
+  /* f32/math_impl.h */ \
+  X(f32_abs,f32_abs(F)) \
+  X(f32_signum,f32_signum(F)) \
+  X(f32_is_nan,f32_is_nan(F)) \
+  X(f32_copysign,f32_copysign(F,G)) \
+  X(f32_is_sign_negative,f32_is_sign_negative(F)) \
+  X(f32_is_finite,f32_is_finite(F)) \
+  X(f32_sqrt,f32_sqrt(G)) \
+  X(f32_rsqrt_fast,f32_rsqrt_fast(G)) \
+  X(f32_div_euclid,f32_div_euclid(F,G)) \
+  X(f32_trunc,f32_trunc(F)) \
+  X(f32_rem,f32_rem(F,G)) \
+  X(f32_rem_euclid,f32_rem_euclid(F,G)) \
+  X(f32_neg,f32_neg(F)) \
+  X(f32_eq,f32_eq(F,G)) \
+  X(f32_ne,f32_ne(F,G)) \
+  X(f32_ge,f32_ge(F,G)) \
+  X(f32_gt,f32_gt(F,G)) \
+  X(f32_le,f32_le(F,G)) \
+  X(f32_lt,f32_lt(F,G)) \
+  X(f32_round,f32_round(F)) \
+  X(f32_floor,f32_floor(F)) \
+  X(f32_ceil,f32_ceil(F)) \
+  X(f32_exp,f32_exp(F)) \
+  X(f32_pow,f32_pow(G,F)) \
+  X(f32_mul_add,f32_mul_add(F,G,H)) \
+  X(f32_to_bits,f32_to_bits(F)) \
+  X(f32_from_bits,f32_from_bits((u32)IDX)) \
+  X(f32_acos_approx,f32_acos_approx(F)) \
+  /* f32/trig.h */ \
+  X(_acos_approx_f32,_acos_approx_f32(F)) \
+  X(_atan2f,_atan2f(F,G)) \
+  X(_atanf,_atanf(F)) \
+  /* f32/vec3.h */ \
+  X(vec3,vec3(F,G,H)) \
+  X(vec3_new,vec3_new(F,G,H)) \
+  X(vec3_splat,vec3_splat(F)) \
+  X(vec3_select,vec3_select(B,V,W)) \
+  X(vec3_map,vec3_map(V,fabsf)) \
+  X(vec3_from_array,vec3_from_array(AT(d3))) \
+  X(vec3_write_to_slice,(vec3_write_to_slice(V,slice),0)) \
+  X(vec3_from_vec4,vec3_from_vec4(AT(f4))) \
+  X(vec3_with_x,vec3_with_x(V,F)) \
+  X(vec3_with_y,vec3_with_y(V,F)) \
+  X(vec3_with_z,vec3_with_z(V,F)) \
+  X(vec3_dot,vec3_dot(V,W)) \
+  X(vec3_dot_into_vec,vec3_dot_into_vec(V,W)) \
+  X(vec3_cross,vec3_cross(V,W)) \
+  X(vec3_min,vec3_min(V,W)) \
+  X(vec3_max,vec3_max(V,W)) \
+  X(vec3_clamp,vec3_clamp(V,VEC3_NEG_ONE,VEC3_ONE)) \
+  X(vec3_min_element,vec3_min_element(V)) \
+  X(vec3_max_element,vec3_max_element(V)) \
+  X(vec3_element_sum,vec3_element_sum(V)) \
+  X(vec3_element_product,vec3_element_product(V)) \
+  X(vec3_cmpeq,vec3_cmpeq(V,W)) \
+  X(vec3_cmpne,vec3_cmpne(V,W)) \
+  X(vec3_cmpge,vec3_cmpge(V,W)) \
+  X(vec3_cmpgt,vec3_cmpgt(V,W)) \
+  X(vec3_cmple,vec3_cmple(V,W)) \
+  X(vec3_cmplt,vec3_cmplt(V,W)) \
+  X(vec3_abs,vec3_abs(V)) \
+  X(vec3_signum,vec3_signum(V)) \
+  X(vec3_copysign,vec3_copysign(V,W)) \
+  X(vec3_is_negative_bitmask,vec3_is_negative_bitmask(V)) \
+  X(vec3_is_finite,vec3_is_finite(V)) \
+  X(vec3_is_nan,vec3_is_nan(V)) \
+  X(vec3_len,vec3_len(V)) \
+  X(vec3_len_squared,vec3_len_squared(V)) \
+  X(vec3_len_recip,vec3_len_recip(V)) \
+  X(vec3_len_recip_fast,vec3_len_recip_fast(V)) \
+  X(vec3_distance,vec3_distance(V,W)) \
+  X(vec3_distance_squared,vec3_distance_squared(V,W)) \
+  X(vec3_div_euclid,vec3_div_euclid(V,W)) \
+  X(vec3_rem_euclid,vec3_rem_euclid(V,W)) \
+  X(vec3_normalize,vec3_normalize(V)) \
+  X(vec3_normalize_or,vec3_normalize_or(V,W)) \
+  X(vec3_normalize_or_zero,vec3_normalize_or_zero(V)) \
+  X(vec3_normalize_fast,vec3_normalize_fast(V)) \
+  X(vec3_normalize_or_fast,vec3_normalize_or_fast(V,W)) \
+  X(vec3_normalize_or_zero_fast,vec3_normalize_or_zero_fast(V)) \
+  X(vec3_is_normalized,vec3_is_normalized(V)) \
+  X(vec3_project_into,vec3_project_into(V,W)) \
+  X(vec3_reject_from,vec3_reject_from(V,W)) \
+  X(vec3_project_onto_normalized,vec3_project_onto_normalized(V,N)) \
+  X(vec3_reject_from_normalized,vec3_reject_from_normalized(V,N)) \
+  X(vec3_round,vec3_round(V)) \
+  X(vec3_floor,vec3_floor(V)) \
+  X(vec3_ceil,vec3_ceil(V)) \
+  X(vec3_trunc,vec3_trunc(V)) \
+  X(vec3_fract,vec3_fract(V)) \
+  X(vec3_fract_gl,vec3_fract_gl(V)) \
+  X(vec3_exp,vec3_exp(V)) \
+  X(vec3_pow,vec3_pow(vec3_abs(V),1.5F)) \
+  X(vec3_recip,vec3_recip(V)) \
+  X(vec3_lerp,vec3_lerp(V,W,F)) \
+  X(vec3_move_towards,vec3_move_towards(&AT(v),W,G)) \
+  X(vec3_midpoint,vec3_midpoint(V,W)) \
+  X(vec3_abs_diff_eq,vec3_abs_diff_eq(V,W,F)) \
+  X(vec3_clamp_length,vec3_clamp_length(V,0.5F,2.0F)) \
+  X(vec3_clamp_length_max,vec3_clamp_length_max(V,2.0F)) \
+  X(vec3_clamp_length_min,vec3_clamp_length_min(V,0.5F)) \
+  X(vec3_mul_add,vec3_mul_add(V,W,U)) \
+  X(vec3_dot_fma,vec3_dot_fma(V,W)) \
+  X(vec3_cross_fma,vec3_cross_fma(V,W)) \
+  X(vec3_len_squared_fma,vec3_len_squared_fma(V)) \
+  X(vec3_lerp_fma,vec3_lerp_fma(V,W,F)) \
+  X(vec3_default,vec3_default()) \
+  X(vec3_div,vec3_div(V,W)) \
+  X(vec3_div_assign,(vec3_div_assign(&acc_v,V),0)) \
+  X(vec3_div_f32,vec3_div_f32(V,F)) \
+  X(vec3_div_assign_f32,(vec3_div_assign_f32(&acc_v,F),0)) \
+  X(f32_div_vec3,f32_div_vec3(F,V)) \
+  X(vec3_mul,vec3_mul(V,W)) \
+  X(vec3_mul_assign,(vec3_mul_assign(&acc_v,V),0)) \
+  X(vec3_mul_f32,vec3_mul_f32(V,F)) \
+  X(vec3_mul_assign_f32,(vec3_mul_assign_f32(&acc_v,F),0)) \
+  X(f32_mul_vec3,f32_mul_vec3(F,V)) \
+  X(vec3_add,vec3_add(V,W)) \
+  X(vec3_add_assign,(vec3_add_assign(&acc_v,V),0)) \
+  X(vec3_add_f32,vec3_add_f32(V,F)) \
+  X(vec3_add_assign_f32,(vec3_add_assign_f32(&acc_v,F),0)) \
+  X(f32_add_vec3,f32_add_vec3(F,V)) \
+  X(vec3_sub,vec3_sub(V,W)) \
+  X(vec3_sub_assign,(vec3_sub_assign(&acc_v,V),0)) \
+  X(vec3_sub_f32,vec3_sub_f32(V,F)) \
+  X(vec3_sub_assign_f32,(vec3_sub_assign_f32(&acc_v,F),0)) \
+  X(f32_sub_vec3,f32_sub_vec3(F,V)) \
+  X(vec3_rem,vec3_rem(V,W)) \
+  X(vec3_rem_assign,(vec3_rem_assign(&acc_v,V),0)) \
+  X(vec3_rem_f32,vec3_rem_f32(V,F)) \
+  X(vec3_rem_assign_f32,(vec3_rem_assign_f32(&acc_v,F),0)) \
+  X(f32_rem_vec3,f32_rem_vec3(F,V)) \
+  X(vec3_neg,vec3_neg(V)) \
+  X(vec3_index,*vec3_index(&acc_v,IDX)) \
+  /* f32/vec3a.h */ \
+  X(vec3a,vec3a(F,G,H)) \
+  X(vec3a_new,vec3a_new(F,G,H)) \
+  X(vec3a_splat,vec3a_splat(F)) \
+  X(vec3a_from_m128,vec3a_from_m128(AT(m))) \
+  X(vec3a_from_vec3,vec3a_from_vec3(V)) \
+  X(vec3_from_vec3a,vec3_from_vec3a(VA)) \
+  X(vec3a_x,vec3a_x(VA)) \
+  X(vec3a_y,vec3a_y(VA)) \
+  X(vec3a_z,vec3a_z(VA)) \
+  X(vec3a_select,vec3a_select(BA,VA,WA)) \
+  X(vec3a_map,vec3a_map(VA,fabsf)) \
+  X(vec3a_from_array,vec3a_from_array(AT(f3))) \
+  X(vec3a_write_to_slice,(vec3a_write_to_slice(VA,slice),0)) \
+  X(vec3a_from_vec4,vec3a_from_vec4(AT(f4))) \
+  X(vec3a_with_x,vec3a_with_x(VA,F)) \
+  X(vec3a_with_y,vec3a_with_y(VA,F)) \
+  X(vec3a_with_z,vec3a_with_z(VA,F)) \
+  X(vec3a_dot,vec3a_dot(VA,WA)) \
+  X(vec3a_dot_into_vec,vec3a_dot_into_vec(VA,WA)) \
+  X(vec3a_cross,vec3a_cross(VA,WA)) \
+  X(vec3a_min,vec3a_min(VA,WA)) \
+  X(vec3a_max,vec3a_max(VA,WA)) \
+  X(vec3a_clamp,vec3a_clamp(VA,VEC3A_NEG_ONE,VEC3A_ONE)) \
+  X(vec3a_min_element,vec3a_min_element(VA)) \
+  X(vec3a_max_element,vec3a_max_element(VA)) \
+  X(vec3a_element_sum,vec3a_element_sum(VA)) \
+  X(vec3a_element_product,vec3a_element_product(VA)) \
+  X(vec3a_cmpeq,vec3a_cmpeq(VA,WA)) \
+  X(vec3a_cmpne,vec3a_cmpne(VA,WA)) \
+  X(vec3a_cmpge,vec3a_cmpge(VA,WA)) \
+  X(vec3a_cmpgt,vec3a_cmpgt(VA,WA)) \
+  X(vec3a_cmple,vec3a_cmple(VA,WA)) \
+  X(vec3a_cmplt,vec3a_cmplt(VA,WA)) \
+  X(vec3a_abs,vec3a_abs(VA)) \
+  X(vec3a_signum,vec3a_signum(VA)) \
+  X(vec3a_copysign,vec3a_copysign(VA,WA)) \
+  X(vec3a_is_negative_bitmask,vec3a_is_negative_bitmask(VA)) \
+  X(vec3a_is_finite,vec3a_is_finite(VA)) \
+  X(vec3a_is_nan,vec3a_is_nan(VA)) \
+  X(vec3a_len,vec3a_len(VA)) \
+  X(vec3a_len_squared,vec3a_len_squared(VA)) \
+  X(vec3a_len_recip,vec3a_len_recip(VA)) \
+  X(vec3a_len_recip_fast,vec3a_len_recip_fast(VA)) \
+  X(vec3a_distance,vec3a_distance(VA,WA)) \
+  X(vec3a_distance_squared,vec3a_distance_squared(VA,WA)) \
+  X(vec3a_div_euclid,vec3a_div_euclid(VA,WA)) \
+  X(vec3a_rem_euclid,vec3a_rem_euclid(VA,WA)) \
+  X(vec3a_normalize,vec3a_normalize(VA)) \
+  X(vec3a_normalize_or,vec3a_normalize_or(VA,WA)) \
+  X(vec3a_normalize_or_zero,vec3a_normalize_or_zero(VA)) \
+  X(vec3a_normalize_fast,vec3a_normalize_fast(VA)) \
+  X(vec3a_normalize_or_fast,vec3a_normalize_or_fast(VA,WA)) \
+  X(vec3a_normalize_or_zero_fast,vec3a_normalize_or_zero_fast(VA)) \
+  X(vec3a_is_normalized,vec3a_is_normalized(VA)) \
+  X(vec3a_project_into,vec3a_project_into(VA,WA)) \
+  X(vec3a_reject_from,vec3a_reject_from(VA,WA)) \
+  X(vec3a_project_onto_normalized,vec3a_project_onto_normalized(VA,NA)) \
+  X(vec3a_reject_from_normalized,vec3a_reject_from_normalized(VA,NA)) \
+  X(vec3a_round,vec3a_round(VA)) \
+  X(vec3a_floor,vec3a_floor(VA)) \
+  X(vec3a_ceil,vec3a_ceil(VA)) \
+  X(vec3a_trunc,vec3a_trunc(VA)) \
+  X(vec3a_fract,vec3a_fract(VA)) \
+  X(vec3a_fract_gl,vec3a_fract_gl(VA)) \
+  X(vec3a_exp,vec3a_exp(VA)) \
+  X(vec3a_pow,vec3a_pow(vec3a_abs(VA),1.5F)) \
+  X(vec3a_recip,vec3a_recip(VA)) \
+  X(vec3a_lerp,vec3a_lerp(VA,WA,F)) \
+  X(vec3a_move_towards,vec3a_move_towards(VA,WA,F)) \
+  X(vec3a_midpoint,vec3a_midpoint(VA,WA)) \
+  X(vec3a_abs_diff_eq,vec3a_abs_diff_eq(VA,WA,F)) \
+  X(vec3a_clamp_length,vec3a_clamp_length(VA,0.5F,2.0F)) \
+  X(vec3a_clamp_length_max,vec3a_clamp_length_max(VA,2.0F)) \
+  X(vec3a_clamp_length_min,vec3a_clamp_length_min(VA,0.5F)) \
+  X(vec3a_mul_add,vec3a_mul_add(VA,WA,UA)) \
+  X(vec3a_default,vec3a_default()) \
+  X(vec3a_div,vec3a_div(VA,WA)) \
+  X(vec3a_div_assign,(vec3a_div_assign(&acc_va,VA),0)) \
+  X(vec3a_div_f32,vec3a_div_f32(VA,F)) \
+  X(vec3a_div_assign_f32,(vec3a_div_assign_f32(&acc_va,F),0)) \
+  X(f32_div_vec3a,f32_div_vec3a(F,VA)) \
+  X(vec3a_mul,vec3a_mul(VA,WA)) \
+  X(vec3a_mul_assign,(vec3a_mul_assign(&acc_va,VA),0)) \
+  X(vec3a_mul_f32,vec3a_mul_f32(VA,F)) \
+  X(vec3a_mul_assign_f32,(vec3a_mul_assign_f32(&acc_va,F),0)) \
+  X(f32_mul_vec3a,f32_mul_vec3a(F,VA)) \
+  X(vec3a_add,vec3a_add(VA,WA)) \
+  X(vec3a_add_assign,(vec3a_add_assign(&acc_va,VA),0)) \
+  X(vec3a_add_f32,vec3a_add_f32(VA,F)) \
+  X(vec3a_add_assign_f32,(vec3a_add_assign_f32(&acc_va,F),0)) \
+  X(f32_add_vec3a,f32_add_vec3a(F,VA)) \
+  X(vec3a_sub,vec3a_sub(VA,WA)) \
+  X(vec3a_sub_assign,(vec3a_sub_assign(&acc_va,VA),0)) \
+  X(vec3a_sub_f32,vec3a_sub_f32(VA,F)) \
+  X(vec3a_sub_assign_f32,(vec3a_sub_assign_f32(&acc_va,F),0)) \
+  X(f32_sub_vec3a,f32_sub_vec3a(F,VA)) \
+  X(vec3a_rem,vec3a_rem(VA,WA)) \
+  X(vec3a_rem_assign,(vec3a_rem_assign(&acc_va,VA),0)) \
+  X(vec3a_rem_f32,vec3a_rem_f32(VA,F)) \
+  X(vec3a_rem_assign_f32,(vec3a_rem_assign_f32(&acc_va,F),0)) \
+  X(f32_rem_vec3a,f32_rem_vec3a(F,VA)) \
+  X(vec3a_neg,vec3a_neg(VA)) \
+  X(vec3a_index,*vec3a_index(&acc_va,IDX)) \
+  /* f32/vec3_soa.h */ \
+  X(vec3_soa,vec3_soa(xs,ys,zs,LEN).len) \
+  X(vec3_soa_get,vec3_soa_get(soa_a,i & (LEN-1))) \
+  X(vec3_soa_set,(vec3_soa_set(soa_out,i & (LEN-1),V),0)) \
+  /* f32/mat3.h */ \
+  X(mat3_from_cols,mat3_from_cols(VA,WA,UA)) \
+  X(mat3_from_cols_array,mat3_from_cols_array(AT(f9))) \
+  X(mat3_to_cols_array,(mat3_to_cols_array(M3,cols),0)) \
+  X(mat3_from_diagonal,mat3_from_diagonal(V)) \
+  X(mat3_from_scale,mat3_from_scale(V)) \
+  X(mat3_from_axis_angle,mat3_from_axis_angle(N,F)) \
+  X(mat3_from_rotation_x,mat3_from_rotation_x(F)) \
+  X(mat3_from_rotation_y,mat3_from_rotation_y(F)) \
+  X(mat3_from_rotation_z,mat3_from_rotation_z(F)) \
+  X(mat3_col,mat3_col(M3,IDX)) \
+  X(mat3_row,mat3_row(M3,IDX)) \
+  X(mat3_is_finite,mat3_is_finite(M3)) \
+  X(mat3_is_nan,mat3_is_nan(M3)) \
+  X(mat3_transpose,mat3_transpose(M3)) \
+  X(mat3_determinant,mat3_determinant(M3)) \
+  X(mat3_inverse,mat3_inverse(M3)) \
+  X(mat3_mul_vec3,mat3_mul_vec3(M3,V)) \
+  X(mat3_mul_vec3a,mat3_mul_vec3a(M3,VA)) \
+  X(mat3_mul_mat3,mat3_mul_mat3(M3,M3W)) \
+  X(mat3_add_mat3,mat3_add_mat3(M3,M3W)) \
+  X(mat3_sub_mat3,mat3_sub_mat3(M3,M3W)) \
+  X(mat3_mul_f32,mat3_mul_f32(M3,F)) \
+  X(mat3_abs_diff_eq,mat3_abs_diff_eq(M3,M3W,G)) \
+  /* f32/mat4.h */ \
+  X(mat4_from_cols,mat4_from_cols(AT(m),AT(m),AT(m),AT(m))) \
+  X(mat4_from_cols_array,mat4_from_cols_array(AT(f16))) \
+  X(mat4_to_cols_array,(mat4_to_cols_array(M4,cols),0)) \
+  X(mat4_from_diagonal,mat4_from_diagonal(AT(f4))) \
+  X(mat4_from_mat3,mat4_from_mat3(M3)) \
+  X(mat4_from_mat3_translation,mat4_from_mat3_translation(M3,V)) \
+  X(mat4_from_translation,mat4_from_translation(V)) \
+  X(mat4_from_scale,mat4_from_scale(V)) \
+  X(mat4_col,mat4_col(M4,IDX)) \
+  X(mat4_row,mat4_row(M4,IDX)) \
+  X(mat4_is_finite,mat4_is_finite(M4)) \
+  X(mat4_is_nan,mat4_is_nan(M4)) \
+  X(mat4_transpose,mat4_transpose(M4)) \
+  X(mat4_determinant,mat4_determinant(M4)) \
+  X(mat4_inverse,mat4_inverse(M4)) \
+  X(mat4_mul_m128,mat4_mul_m128(M4,AT(m))) \
+  X(mat4_mul_mat4,mat4_mul_mat4(M4,M4W)) \
+  X(mat4_add_mat4,mat4_add_mat4(M4,M4W)) \
+  X(mat4_sub_mat4,mat4_sub_mat4(M4,M4W)) \
+  X(mat4_mul_f32,mat4_mul_f32(M4,F)) \
+  X(mat4_transform_point3,mat4_transform_point3(M4,V)) \
+  X(mat4_transform_vector3,mat4_transform_vector3(M4,V)) \
+  X(mat4_project_point3,mat4_project_point3(M4,V)) \
+  X(mat4_transform_point3a,mat4_transform_point3a(M4,VA)) \
+  X(mat4_transform_vector3a,mat4_transform_vector3a(M4,VA)) \
+  X(mat4_abs_diff_eq,mat4_abs_diff_eq(M4,M4W,G)) \
+  /* f32/affine3a.h */ \
+  X(affine3a_from_cols,affine3a_from_cols(VA,WA,UA,NA)) \
+  X(affine3a_from_mat3,affine3a_from_mat3(M3)) \
+  X(affine3a_from_mat3_translation,affine3a_from_mat3_translation(M3,V)) \
+  X(affine3a_from_translation,affine3a_from_translation(V)) \
+  X(affine3a_from_scale,affine3a_from_scale(V)) \
+  X(affine3a_from_mat4,affine3a_from_mat4(M4)) \
+  X(affine3a_to_mat4,affine3a_to_mat4(AF)) \
+  X(affine3a_is_finite,affine3a_is_finite(AF)) \
+  X(affine3a_is_nan,affine3a_is_nan(AF)) \
+  X(affine3a_determinant,affine3a_determinant(AF)) \
+  X(affine3a_inverse,affine3a_inverse(AF)) \
+  X(affine3a_mul_affine3a,affine3a_mul_affine3a(AF,AFW)) \
+  X(affine3a_transform_point3,affine3a_transform_point3(AF,V)) \
+  X(affine3a_transform_vector3,affine3a_transform_vector3(AF,V)) \
+  X(affine3a_transform_point3a,affine3a_transform_point3a(AF,VA)) \
+  X(affine3a_transform_vector3a,affine3a_transform_vector3a(AF,VA)) \
+  X(affine3a_abs_diff_eq,affine3a_abs_diff_eq(AF,AFW,G)) \
+  /* f32/quat.h */ \
+  X(quat_from_xyzw,quat_from_xyzw(F,G,H,F)) \
+  X(quat_from_array,quat_from_array(AT(f4))) \
+  X(quat_write_to_slice,(quat_write_to_slice(Q,cols),0)) \
+  X(quat_from_m128,quat_from_m128(AT(m))) \
+  X(quat_xyz,quat_xyz(Q)) \
+  X(quat_w,quat_w(Q)) \
+  X(quat_from_axis_angle,quat_from_axis_angle(N,F)) \
+  X(quat_from_scaled_axis,quat_from_scaled_axis(V)) \
+  X(quat_from_rotation_x,quat_from_rotation_x(F)) \
+  X(quat_from_rotation_y,quat_from_rotation_y(F)) \
+  X(quat_from_rotation_z,quat_from_rotation_z(F)) \
+  X(quat_from_mat3,quat_from_mat3(M3W)) \
+  X(mat3_from_quat,mat3_from_quat(Q)) \
+  X(quat_from_rotation_arc,quat_from_rotation_arc(N,AT(n2))) \
+  X(quat_to_axis_angle,(quat_to_axis_angle(Q,&acc_v,&slice[0]),0)) \
+  X(quat_to_scaled_axis,quat_to_scaled_axis(Q)) \
+  X(quat_conjugate,quat_conjugate(Q)) \
+  X(quat_inverse,quat_inverse(Q)) \
+  X(quat_dot,quat_dot(Q,QW)) \
+  X(quat_len,quat_len(Q)) \
+  X(quat_len_squared,quat_len_squared(Q)) \
+  X(quat_len_recip,quat_len_recip(Q)) \
+  X(quat_normalize,quat_normalize(Q)) \
+  X(quat_is_finite,quat_is_finite(Q)) \
+  X(quat_is_nan,quat_is_nan(Q)) \
+  X(quat_is_normalized,quat_is_normalized(Q)) \
+  X(quat_is_near_identity,quat_is_near_identity(Q)) \
+  X(quat_angle_between,quat_angle_between(Q,QW)) \
+  X(quat_abs_diff_eq,quat_abs_diff_eq(Q,QW,G)) \
+  X(quat_nlerp,quat_nlerp(Q,QW,H)) \
+  X(quat_slerp,quat_slerp(Q,QW,H)) \
+  X(quat_mul_vec3,quat_mul_vec3(Q,V)) \
+  X(quat_mul_vec3a,quat_mul_vec3a(Q,VA)) \
+  X(quat_mul_quat,quat_mul_quat(Q,QW)) \
+  X(quat_add_quat,quat_add_quat(Q,QW)) \
+  X(quat_sub_quat,quat_sub_quat(Q,QW)) \
+  X(quat_mul_f32,quat_mul_f32(Q,F)) \
+  X(quat_div_f32,quat_div_f32(Q,F)) \
+  X(quat_neg,quat_neg(Q)) \
+  /* f32/aabb.h */ \
+  X(aabb_new,aabb_new(V,W)) \
+  X(aabb_from_point,aabb_from_point(V)) \
+  X(aabb_from_center_half_size,aabb_from_center_half_size(V,W)) \
+  X(aabb_is_empty,aabb_is_empty(BOX)) \
+  X(aabb_is_finite,aabb_is_finite(BOX)) \
+  X(aabb_is_nan,aabb_is_nan(BOX)) \
+  X(aabb_union,aabb_union(BOX,BOXW)) \
+  X(aabb_intersection,aabb_intersection(BOX,BOXW)) \
+  X(aabb_expand,aabb_expand(BOX,V)) \
+  X(aabb_grow,aabb_grow(BOX,F)) \
+  X(aabb_size,aabb_size(BOX)) \
+  X(aabb_centroid,aabb_centroid(BOX)) \
+  X(aabb_surface_area,aabb_surface_area(BOX)) \
+  X(aabb_volume,aabb_volume(BOX)) \
+  X(aabb_contains_point,aabb_contains_point(BOX,V)) \
+  X(aabb_contains_aabb,aabb_contains_aabb(BOX,BOXW)) \
+  X(aabb_overlaps,aabb_overlaps(BOX,BOXW)) \
+  X(aabb_abs_diff_eq,aabb_abs_diff_eq(BOX,BOXW,G)) \
+  /* f32/ray.h */ \
+  X(ray_new,ray_new(V,N)) \
+  X(ray_new_range,ray_new_range(V,N,F,G)) \
+  X(ray_at,ray_at(RAY,F)) \
+  X(ray_is_finite,ray_is_finite(RAY)) \
+  X(ray_intersect_aabb,ray_intersect_aabb(RAY,BOX)) \
+  /* f32/vec3_packed.h */ \
+  X(vec3_to_f16,vec3_to_f16(V)) \
+  X(vec3_from_f16,vec3_from_f16(AT(n_f16))) \
+  X(vec3_to_snorm16,vec3_to_snorm16(N)) \
+  X(vec3_from_snorm16,vec3_from_snorm16(AT(n_snorm16))) \
+  X(vec3_to_oct32,vec3_to_oct32(N)) \
+  X(vec3_from_oct32,vec3_from_oct32(AT(n_oct32))) \
+  /* f64/math_impl.h */ \
+  X(f64_abs,f64_abs(DF)) \
+  X(f64_signum,f64_signum(DF)) \
+  X(f64_is_nan,f64_is_nan(DF)) \
+  X(f64_copysign,f64_copysign(DF,DG)) \
+  X(f64_is_sign_negative,f64_is_sign_negative(DF)) \
+  X(f64_is_finite,f64_is_finite(DF)) \
+  X(f64_sqrt,f64_sqrt(DG)) \
+  X(f64_div_euclid,f64_div_euclid(DF,DG)) \
+  X(f64_trunc,f64_trunc(DF)) \
+  X(f64_rem,f64_rem(DF,DG)) \
+  X(f64_rem_euclid,f64_rem_euclid(DF,DG)) \
+  X(f64_neg,f64_neg(DF)) \
+  X(f64_eq,f64_eq(DF,DG)) \
+  X(f64_ne,f64_ne(DF,DG)) \
+  X(f64_ge,f64_ge(DF,DG)) \
+  X(f64_gt,f64_gt(DF,DG)) \
+  X(f64_le,f64_le(DF,DG)) \
+  X(f64_lt,f64_lt(DF,DG)) \
+  X(f64_round,f64_round(DF)) \
+  X(f64_floor,f64_floor(DF)) \
+  X(f64_ceil,f64_ceil(DF)) \
+  X(f64_exp,f64_exp(DF)) \
+  X(f64_pow,f64_pow(DG,DF)) \
+  X(f64_mul_add,f64_mul_add(DF,DG,DH)) \
+  X(f64_to_bits,f64_to_bits(DF)) \
+  X(f64_from_bits,f64_from_bits((u64)IDX)) \
+  /* f64/dvec3.h */ \
+  X(dvec3,dvec3(DF,DG,DH)) \
+  X(dvec3_new,dvec3_new(DF,DG,DH)) \
+  X(dvec3_splat,dvec3_splat(DF)) \
+  X(dvec3_select,dvec3_select(B,DV,DW)) \
+  X(dvec3_map,dvec3_map(DV,fabs)) \
+  X(dvec3_from_array,dvec3_from_array(AT(d3))) \
+  X(dvec3_write_to_slice,(dvec3_write_to_slice(DV,dslice),0)) \
+  X(dvec3_from_vec4,dvec3_from_vec4(AT(d4))) \
+  X(dvec3_with_x,dvec3_with_x(DV,DF)) \
+  X(dvec3_with_y,dvec3_with_y(DV,DF)) \
+  X(dvec3_with_z,dvec3_with_z(DV,DF)) \
+  X(vec3_as_dvec3,vec3_as_dvec3(V)) \
+  X(dvec3_as_vec3,dvec3_as_vec3(DV)) \
+  X(dvec3_dot,dvec3_dot(DV,DW)) \
+  X(dvec3_dot_into_vec,dvec3_dot_into_vec(DV,DW)) \
+  X(dvec3_cross,dvec3_cross(DV,DW)) \
+  X(dvec3_min,dvec3_min(DV,DW)) \
+  X(dvec3_max,dvec3_max(DV,DW)) \
+  X(dvec3_clamp,dvec3_clamp(DV,DVEC3_NEG_ONE,DVEC3_ONE)) \
+  X(dvec3_min_element,dvec3_min_element(DV)) \
+  X(dvec3_max_element,dvec3_max_element(DV)) \
+  X(dvec3_element_sum,dvec3_element_sum(DV)) \
+  X(dvec3_element_product,dvec3_element_product(DV)) \
+  X(dvec3_cmpeq,dvec3_cmpeq(DV,DW)) \
+  X(dvec3_cmpne,dvec3_cmpne(DV,DW)) \
+  X(dvec3_cmpge,dvec3_cmpge(DV,DW)) \
+  X(dvec3_cmpgt,dvec3_cmpgt(DV,DW)) \
+  X(dvec3_cmple,dvec3_cmple(DV,DW)) \
+  X(dvec3_cmplt,dvec3_cmplt(DV,DW)) \
+  X(dvec3_abs,dvec3_abs(DV)) \
+  X(dvec3_signum,dvec3_signum(DV)) \
+  X(dvec3_copysign,dvec3_copysign(DV,DW)) \
+  X(dvec3_is_negative_bitmask,dvec3_is_negative_bitmask(DV)) \
+  X(dvec3_is_finite,dvec3_is_finite(DV)) \
+  X(dvec3_is_nan,dvec3_is_nan(DV)) \
+  X(dvec3_len,dvec3_len(DV)) \
+  X(dvec3_len_squared,dvec3_len_squared(DV)) \
+  X(dvec3_len_recip,dvec3_len_recip(DV)) \
+  X(dvec3_distance,dvec3_distance(DV,DW)) \
+  X(dvec3_distance_squared,dvec3_distance_squared(DV,DW)) \
+  X(dvec3_div_euclid,dvec3_div_euclid(DV,DW)) \
+  X(dvec3_rem_euclid,dvec3_rem_euclid(DV,DW)) \
+  X(dvec3_normalize,dvec3_normalize(DV)) \
+  X(dvec3_normalize_or,dvec3_normalize_or(DV,DW)) \
+  X(dvec3_normalize_or_zero,dvec3_normalize_or_zero(DV)) \
+  X(dvec3_is_normalized,dvec3_is_normalized(DV)) \
+  X(dvec3_project_into,dvec3_project_into(DV,DW)) \
+  X(dvec3_reject_from,dvec3_reject_from(DV,DW)) \
+  X(dvec3_project_onto_normalized,dvec3_project_onto_normalized(DV,DN)) \
+  X(dvec3_reject_from_normalized,dvec3_reject_from_normalized(DV,DN)) \
+  X(dvec3_round,dvec3_round(DV)) \
+  X(dvec3_floor,dvec3_floor(DV)) \
+  X(dvec3_ceil,dvec3_ceil(DV)) \
+  X(dvec3_trunc,dvec3_trunc(DV)) \
+  X(dvec3_fract,dvec3_fract(DV)) \
+  X(dvec3_fract_gl,dvec3_fract_gl(DV)) \
+  X(dvec3_exp,dvec3_exp(DV)) \
+  X(dvec3_pow,dvec3_pow(dvec3_abs(DV),1.5)) \
+  X(dvec3_recip,dvec3_recip(DV)) \
+  X(dvec3_lerp,dvec3_lerp(DV,DW,DF)) \
+  X(dvec3_move_towards,dvec3_move_towards(&AT(dv),DW,DG)) \
+  X(dvec3_midpoint,dvec3_midpoint(DV,DW)) \
+  X(dvec3_abs_diff_eq,dvec3_abs_diff_eq(DV,DW,DF)) \
+  X(dvec3_clamp_length,dvec3_clamp_length(DV,0.5,2.0)) \
+  X(dvec3_clamp_length_max,dvec3_clamp_length_max(DV,2.0)) \
+  X(dvec3_clamp_length_min,dvec3_clamp_length_min(DV,0.5)) \
+  X(dvec3_mul_add,dvec3_mul_add(DV,DW,DU)) \
+  X(dvec3_default,dvec3_default()) \
+  X(dvec3_div,dvec3_div(DV,DW)) \
+  X(dvec3_div_assign,(dvec3_div_assign(&acc_dv,DV),0)) \
+  X(dvec3_div_f64,dvec3_div_f64(DV,DF)) \
+  X(dvec3_div_assign_f64,(dvec3_div_assign_f64(&acc_dv,DF),0)) \
+  X(f64_div_dvec3,f64_div_dvec3(DF,DV)) \
+  X(dvec3_mul,dvec3_mul(DV,DW)) \
+  X(dvec3_mul_assign,(dvec3_mul_assign(&acc_dv,DV),0)) \
+  X(dvec3_mul_f64,dvec3_mul_f64(DV,DF)) \
+  X(dvec3_mul_assign_f64,(dvec3_mul_assign_f64(&acc_dv,DF),0)) \
+  X(f64_mul_dvec3,f64_mul_dvec3(DF,DV)) \
+  X(dvec3_add,dvec3_add(DV,DW)) \
+  X(dvec3_add_assign,(dvec3_add_assign(&acc_dv,DV),0)) \
+  X(dvec3_add_f64,dvec3_add_f64(DV,DF)) \
+  X(dvec3_add_assign_f64,(dvec3_add_assign_f64(&acc_dv,DF),0)) \
+  X(f64_add_dvec3,f64_add_dvec3(DF,DV)) \
+  X(dvec3_sub,dvec3_sub(DV,DW)) \
+  X(dvec3_sub_assign,(dvec3_sub_assign(&acc_dv,DV),0)) \
+  X(dvec3_sub_f64,dvec3_sub_f64(DV,DF)) \
+  X(dvec3_sub_assign_f64,(dvec3_sub_assign_f64(&acc_dv,DF),0)) \
+  X(f64_sub_dvec3,f64_sub_dvec3(DF,DV)) \
+  X(dvec3_rem,dvec3_rem(DV,DW)) \
+  X(dvec3_rem_assign,(dvec3_rem_assign(&acc_dv,DV),0)) \
+  X(dvec3_rem_f64,dvec3_rem_f64(DV,DF)) \
+  X(dvec3_rem_assign_f64,(dvec3_rem_assign_f64(&acc_dv,DF),0)) \
+  X(f64_rem_dvec3,f64_rem_dvec3(DF,DV)) \
+  X(dvec3_neg,dvec3_neg(DV)) \
+  X(dvec3_index,*dvec3_index(&acc_dv,IDX)) \
+  /* i32/ivec3.h */ \
+  X(ivec3,ivec3(IS,IS,IS)) \
+  X(ivec3_new,ivec3_new(IS,IS,IS)) \
+  X(ivec3_splat,ivec3_splat(IS)) \
+  X(ivec3_select,ivec3_select(B,IV,IW)) \
+  X(ivec3_from_array,ivec3_from_array(AT(i3))) \
+  X(ivec3_write_to_slice,(ivec3_write_to_slice(IV,islice),0)) \
+  X(ivec3_with_x,ivec3_with_x(IV,IS)) \
+  X(ivec3_with_y,ivec3_with_y(IV,IS)) \
+  X(ivec3_with_z,ivec3_with_z(IV,IS)) \
+  X(ivec3_dot,ivec3_dot(IV,IW)) \
+  X(ivec3_cross,ivec3_cross(IV,IW)) \
+  X(ivec3_min,ivec3_min(IV,IW)) \
+  X(ivec3_max,ivec3_max(IV,IW)) \
+  X(ivec3_clamp,ivec3_clamp(IV,ivec3_splat(-50),ivec3_splat(50))) \
+  X(ivec3_min_element,ivec3_min_element(IV)) \
+  X(ivec3_max_element,ivec3_max_element(IV)) \
+  X(ivec3_element_sum,ivec3_element_sum(IV)) \
+  X(ivec3_element_product,ivec3_element_product(IV)) \
+  X(ivec3_cmpeq,ivec3_cmpeq(IV,IW)) \
+  X(ivec3_cmpne,ivec3_cmpne(IV,IW)) \
+  X(ivec3_cmpge,ivec3_cmpge(IV,IW)) \
+  X(ivec3_cmpgt,ivec3_cmpgt(IV,IW)) \
+  X(ivec3_cmple,ivec3_cmple(IV,IW)) \
+  X(ivec3_cmplt,ivec3_cmplt(IV,IW)) \
+  X(ivec3_eq,ivec3_eq(IV,IW)) \
+  X(ivec3_hash,ivec3_hash(IV)) \
+  X(ivec3_abs,ivec3_abs(IV)) \
+  X(ivec3_signum,ivec3_signum(IV)) \
+  X(ivec3_is_negative_bitmask,ivec3_is_negative_bitmask(IV)) \
+  X(ivec3_len_squared,ivec3_len_squared(IV)) \
+  X(ivec3_distance_squared,ivec3_distance_squared(IV,IW)) \
+  X(ivec3_div_euclid,ivec3_div_euclid(IV,ID)) \
+  X(ivec3_rem_euclid,ivec3_rem_euclid(IV,ID)) \
+  X(ivec3_saturating_add,ivec3_saturating_add(IV,IW)) \
+  X(ivec3_saturating_sub,ivec3_saturating_sub(IV,IW)) \
+  X(ivec3_as_vec3,ivec3_as_vec3(IV)) \
+  X(ivec3_as_uvec3,ivec3_as_uvec3(IV)) \
+  X(uvec3_as_ivec3,uvec3_as_ivec3(UV)) \
+  X(vec3_as_ivec3,vec3_as_ivec3(V)) \
+  X(vec3_floor_as_ivec3,vec3_floor_as_ivec3(V)) \
+  X(vec3_round_as_ivec3,vec3_round_as_ivec3(V)) \
+  X(ivec3_default,ivec3_default()) \
+  X(ivec3_div,ivec3_div(IV,ID)) \
+  X(ivec3_div_assign,(ivec3_div_assign(&acc_iv,ID),0)) \
+  X(ivec3_div_i32,ivec3_div_i32(IV,IS|1)) \
+  X(ivec3_div_assign_i32,(ivec3_div_assign_i32(&acc_iv,IS|1),0)) \
+  X(ivec3_mul,ivec3_mul(IV,IW)) \
+  X(ivec3_mul_assign,(ivec3_mul_assign(&acc_iv,IV),0)) \
+  X(ivec3_mul_i32,ivec3_mul_i32(IV,IS)) \
+  X(ivec3_mul_assign_i32,(ivec3_mul_assign_i32(&acc_iv,IS),0)) \
+  X(ivec3_add,ivec3_add(IV,IW)) \
+  X(ivec3_add_assign,(ivec3_add_assign(&acc_iv,IV),0)) \
+  X(ivec3_add_i32,ivec3_add_i32(IV,IS)) \
+  X(ivec3_add_assign_i32,(ivec3_add_assign_i32(&acc_iv,IS),0)) \
+  X(ivec3_sub,ivec3_sub(IV,IW)) \
+  X(ivec3_sub_assign,(ivec3_sub_assign(&acc_iv,IV),0)) \
+  X(ivec3_sub_i32,ivec3_sub_i32(IV,IS)) \
+  X(ivec3_sub_assign_i32,(ivec3_sub_assign_i32(&acc_iv,IS),0)) \
+  X(ivec3_rem,ivec3_rem(IV,ID)) \
+  X(ivec3_rem_assign,(ivec3_rem_assign(&acc_iv,ID),0)) \
+  X(ivec3_rem_i32,ivec3_rem_i32(IV,IS|1)) \
+  X(ivec3_rem_assign_i32,(ivec3_rem_assign_i32(&acc_iv,IS|1),0)) \
+  X(ivec3_neg,ivec3_neg(IV)) \
+  X(ivec3_index,*ivec3_index(&acc_iv,IDX)) \
+  /* u32/uvec3.h */ \
+  X(uvec3,uvec3(US,US,US)) \
+  X(uvec3_new,uvec3_new(US,US,US)) \
+  X(uvec3_splat,uvec3_splat(US)) \
+  X(uvec3_select,uvec3_select(B,UV,UW)) \
+  X(uvec3_from_array,uvec3_from_array(AT(u3))) \
+  X(uvec3_write_to_slice,(uvec3_write_to_slice(UV,uslice),0)) \
+  X(uvec3_with_x,uvec3_with_x(UV,US)) \
+  X(uvec3_with_y,uvec3_with_y(UV,US)) \
+  X(uvec3_with_z,uvec3_with_z(UV,US)) \
+  X(uvec3_dot,uvec3_dot(UV,UW)) \
+  X(uvec3_cross,uvec3_cross(UV,UW)) \
+  X(uvec3_min,uvec3_min(UV,UW)) \
+  X(uvec3_max,uvec3_max(UV,UW)) \
+  X(uvec3_clamp,uvec3_clamp(UV,uvec3_splat(10),uvec3_splat(50))) \
+  X(uvec3_min_element,uvec3_min_element(UV)) \
+  X(uvec3_max_element,uvec3_max_element(UV)) \
+  X(uvec3_element_sum,uvec3_element_sum(UV)) \
+  X(uvec3_element_product,uvec3_element_product(UV)) \
+  X(uvec3_cmpeq,uvec3_cmpeq(UV,UW)) \
+  X(uvec3_cmpne,uvec3_cmpne(UV,UW)) \
+  X(uvec3_cmpge,uvec3_cmpge(UV,UW)) \
+  X(uvec3_cmpgt,uvec3_cmpgt(UV,UW)) \
+  X(uvec3_cmple,uvec3_cmple(UV,UW)) \
+  X(uvec3_cmplt,uvec3_cmplt(UV,UW)) \
+  X(uvec3_eq,uvec3_eq(UV,UW)) \
+  X(uvec3_hash,uvec3_hash(UV)) \
+  X(uvec3_len_squared,uvec3_len_squared(UV)) \
+  X(uvec3_saturating_add,uvec3_saturating_add(UV,UW)) \
+  X(uvec3_saturating_sub,uvec3_saturating_sub(UV,UW)) \
+  X(uvec3_as_vec3,uvec3_as_vec3(UV)) \
+  X(vec3_as_uvec3,vec3_as_uvec3(V)) \
+  X(vec3_floor_as_uvec3,vec3_floor_as_uvec3(V)) \
+  X(uvec3_default,uvec3_default()) \
+  X(uvec3_div,uvec3_div(UV,UD)) \
+  X(uvec3_div_assign,(uvec3_div_assign(&acc_uv,UD),0)) \
+  X(uvec3_div_u32,uvec3_div_u32(UV,US|1)) \
+  X(uvec3_div_assign_u32,(uvec3_div_assign_u32(&acc_uv,US|1),0)) \
+  X(uvec3_mul,uvec3_mul(UV,UW)) \
+  X(uvec3_mul_assign,(uvec3_mul_assign(&acc_uv,UV),0)) \
+  X(uvec3_mul_u32,uvec3_mul_u32(UV,US)) \
+  X(uvec3_mul_assign_u32,(uvec3_mul_assign_u32(&acc_uv,US),0)) \
+  X(uvec3_add,uvec3_add(UV,UW)) \
+  X(uvec3_add_assign,(uvec3_add_assign(&acc_uv,UV),0)) \
+  X(uvec3_add_u32,uvec3_add_u32(UV,US)) \
+  X(uvec3_add_assign_u32,(uvec3_add_assign_u32(&acc_uv,US),0)) \
+  X(uvec3_sub,uvec3_sub(UV,UW)) \
+  X(uvec3_sub_assign,(uvec3_sub_assign(&acc_uv,UV),0)) \
+  X(uvec3_sub_u32,uvec3_sub_u32(UV,US)) \
+  X(uvec3_sub_assign_u32,(uvec3_sub_assign_u32(&acc_uv,US),0)) \
+  X(uvec3_rem,uvec3_rem(UV,UD)) \
+  X(uvec3_rem_assign,(uvec3_rem_assign(&acc_uv,UD),0)) \
+  X(uvec3_rem_u32,uvec3_rem_u32(UV,US|1)) \
+  X(uvec3_rem_assign_u32,(uvec3_rem_assign_u32(&acc_uv,US|1),0)) \
+  X(uvec3_index,*uvec3_index(&acc_uv,IDX)) \
+
+/// Benches that process a whole `LEN`-element array per iteration.
+#define ARRAY_BENCHES(X) \
+  X(vec3_soa_dot,vec3_soa_dot(soa_a,soa_b,out)) \
+  X(vec3_soa_dot_parallel,vec3_soa_dot_parallel(soa_a,soa_b,out)) \
+  X(vec3_soa_cross,vec3_soa_cross(soa_a,soa_b,soa_out)) \
+  X(vec3_soa_len,vec3_soa_len(soa_a,out)) \
+  X(vec3_soa_len_parallel,vec3_soa_len_parallel(soa_a,out)) \
+  X(vec3_soa_len_squared,vec3_soa_len_squared(soa_a,out)) \
+  X(vec3_soa_normalize_or_zero,vec3_soa_normalize_or_zero(soa_a,soa_out)) \
+  X(vec3_soa_normalize_or_zero_parallel,vec3_soa_normalize_or_zero_parallel(soa_a,soa_out)) \
+  X(vec3_soa_distance_squared,vec3_soa_distance_squared(soa_a,soa_b,out)) \
+  X(vec3_soa_len_recip_fast,vec3_soa_len_recip_fast(soa_a,out)) \
+  X(vec3_soa_normalize_or_zero_fast,vec3_soa_normalize_or_zero_fast(soa_a,soa_out)) \
+  X(vec3_soa_mul_add,vec3_soa_mul_add(soa_a,soa_b,soa_out,soa_out)) \
+  X(vec3_soa_axpy,vec3_soa_axpy(F,soa_a,soa_out)) \
+  X(vec3_soa_lerp,vec3_soa_lerp(soa_a,soa_b,0.25F,soa_out)) \
+  /* f32/math_batch.h, each next to the libm loop it replaces */ \
+  X(f32_sin_batch,f32_sin_batch(f,out,LEN)) \
+  X(f32_sin_batch_parallel,f32_sin_batch_parallel(f,out,LEN)) \
+  X(libm_sinf,LIBM_LOOP(out[k]=sinf(f[k]))) \
+  X(f32_cos_batch,f32_cos_batch(f,out,LEN)) \
+  X(f32_cos_batch_parallel,f32_cos_batch_parallel(f,out,LEN)) \
+  X(libm_cosf,LIBM_LOOP(out[k]=cosf(f[k]))) \
+  X(f32_sincos_batch,f32_sincos_batch(f,out,out2,LEN)) \
+  X(f32_sincos_batch_parallel,f32_sincos_batch_parallel(f,out,out2,LEN)) \
+  X(libm_sinf_cosf,LIBM_LOOP(out[k]=sinf(f[k]);out2[k]=cosf(f[k]))) \
+  X(f32_exp_batch,f32_exp_batch(f,out,LEN)) \
+  X(f32_exp_batch_parallel,f32_exp_batch_parallel(f,out,LEN)) \
+  X(libm_expf,LIBM_LOOP(out[k]=expf(f[k]))) \
+  X(f32_log_batch,f32_log_batch(g,out,LEN)) \
+  X(f32_log_batch_parallel,f32_log_batch_parallel(g,out,LEN)) \
+  X(libm_logf,LIBM_LOOP(out[k]=logf(g[k]))) \
+  X(f32_atan_batch,f32_atan_batch(f,out,LEN)) \
+  X(f32_atan_batch_parallel,f32_atan_batch_parallel(f,out,LEN)) \
+  X(libm_atanf,LIBM_LOOP(out[k]=atanf(f[k]))) \
+  X(f32_atan2_batch,f32_atan2_batch(f,g,out,LEN)) \
+  X(f32_atan2_batch_parallel,f32_atan2_batch_parallel(f,g,out,LEN)) \
+  X(libm_atan2f,LIBM_LOOP(out[k]=atan2f(f[k],g[k]))) \
+  X(f32_acos_batch,f32_acos_batch(h,out,LEN)) \
+  X(f32_acos_batch_parallel,f32_acos_batch_parallel(h,out,LEN)) \
+  X(libm_acosf,LIBM_LOOP(out[k]=acosf(h[k]))) \
+  X(f32_trunc_batch,f32_trunc_batch(f,out,LEN)) \
+  X(libm_truncf,LIBM_LOOP(out[k]=truncf(f[k]))) \
+  X(f32_floor_batch,f32_floor_batch(f,out,LEN)) \
+  X(libm_floorf,LIBM_LOOP(out[k]=floorf(f[k]))) \
+  X(f32_round_batch,f32_round_batch(f,out,LEN)) \
+  X(libm_roundf,LIBM_LOOP(out[k]=roundf(f[k]))) \
+  X(f32_div_euclid_batch,f32_div_euclid_batch(f,g,out,LEN)) \
+  X(loop_f32_div_euclid,LIBM_LOOP(out[k]=f32_div_euclid(f[k],g[k]))) \
+  X(f32_rem_euclid_batch,f32_rem_euclid_batch(f,g,out,LEN)) \
+  X(f32_rem_euclid_batch_parallel,f32_rem_euclid_batch_parallel(f,g,out,LEN)) \
+  X(loop_f32_rem_euclid,LIBM_LOOP(out[k]=f32_rem_euclid(f[k],g[k]))) \
+  /* f32/vec3_batch.h, each next to the per-point loop it replaces */ \
+  X(vec3_trunc_batch,vec3_trunc_batch(v,vo,LEN)) \
+  X(vec3_floor_batch,vec3_floor_batch(v,vo,LEN)) \
+  X(vec3_round_batch,vec3_round_batch(v,vo,LEN)) \
+  X(loop_vec3_round,LIBM_LOOP(vo[k]=vec3_round(v[k]))) \
+  X(vec3_div_euclid_batch,vec3_div_euclid_batch(v,w,vo,LEN)) \
+  X(vec3_rem_euclid_batch,vec3_rem_euclid_batch(v,w,vo,LEN)) \
+  X(loop_vec3_rem_euclid,LIBM_LOOP(vo[k]=vec3_rem_euclid(v[k],w[k]))) \
+  /* f32/affine3a_batch.h, each next to the per-point loop it replaces */ \
+  X(affine3a_transform_points,affine3a_transform_points(&af[0],v,vo,LEN)) \
+  X(affine3a_transform_points_parallel,affine3a_transform_points_parallel(&af[0],v,vo,LEN)) \
+  X(loop_affine3a_transform_point3,LIBM_LOOP(vo[k]=affine3a_transform_point3(af[0],v[k]))) \
+  X(affine3a_transform_vectors,affine3a_transform_vectors(&af[0],v,vo,LEN)) \
+  X(affine3a_transform_vectors_parallel,affine3a_transform_vectors_parallel(&af[0],v,vo,LEN)) \
+  X(loop_affine3a_transform_vector3,LIBM_LOOP(vo[k]=affine3a_transform_vector3(af[0],v[k]))) \
+  /* f32/quat_batch.h, each next to the per-element loop it replaces */ \
+  X(quat_mul_vec3_batch,quat_mul_vec3_batch(&q[0],v,vo,LEN)) \
+  X(quat_mul_vec3_batch_parallel,quat_mul_vec3_batch_parallel(&q[0],v,vo,LEN)) \
+  X(loop_quat_mul_vec3,LIBM_LOOP(vo[k]=quat_mul_vec3(q[0],v[k]))) \
+  X(quat_nlerp_batch,quat_nlerp_batch(q,qw,0.3F,qo,LEN)) \
+  X(loop_quat_nlerp,LIBM_LOOP(qo[k]=quat_nlerp(q[k],qw[k],0.3F))) \
+  X(quat_slerp_batch,quat_slerp_batch(q,qw,0.3F,qo,LEN)) \
+  X(quat_slerp_batch_parallel,quat_slerp_batch_parallel(q,qw,0.3F,qo,LEN)) \
+  X(loop_quat_slerp,LIBM_LOOP(qo[k]=quat_slerp(q[k],qw[k],0.3F))) \
+  /* f32/ray_batch.h, each next to the per-element loop it replaces */ \
+  X(ray_intersect_aabbs,ray_intersect_aabbs(&ray[0],box,out,LEN)) \
+  X(ray_intersect_aabbs_parallel,ray_intersect_aabbs_parallel(&ray[0],box,out,LEN)) \
+  X(loop_ray_intersect_aabb,LIBM_LOOP(out[k]=ray_intersect_aabb(ray[0],box[k]))) \
+  X(aabb_intersect_rays,aabb_intersect_rays(&box[0],ray,out,LEN)) \
+  X(aabb_intersect_rays_parallel,aabb_intersect_rays_parallel(&box[0],ray,out,LEN)) \
+  X(loop_aabb_intersect_ray,LIBM_LOOP(out[k]=ray_intersect_aabb(ray[k],box[0]))) \
+  /* f32/vec3_packed.h */ \
+  X(vec3_to_f16_batch,vec3_to_f16_batch(v,n_f16_out,LEN)) \
+  X(vec3_from_f16_batch,vec3_from_f16_batch(n_f16,vo,LEN)) \
+  X(vec3_to_snorm16_batch,vec3_to_snorm16_batch(n,n_snorm16_out,LEN)) \
+  X(vec3_from_snorm16_batch,vec3_from_snorm16_batch(n_snorm16,vo,LEN)) \
+  X(vec3_to_oct32_batch,vec3_to_oct32_batch(n,n_oct32_out,LEN)) \
+  X(vec3_to_oct32_batch_parallel,vec3_to_oct32_batch_parallel(n,n_oct32_out,LEN)) \
+  X(vec3_from_oct32_batch,vec3_from_oct32_batch(n_oct32,vo,LEN)) \
+  /* f64/dvec3_batch.h, each next to the per-point loop it replaces */ \
+  X(dvec3_to_vec3_relative_batch,dvec3_to_vec3_relative_batch(dv,dw[0],vo,LEN)) \
+  X(loop_dvec3_as_vec3_sub,LIBM_LOOP(vo[k]=dvec3_as_vec3(dvec3_sub(dv[k],dw[0])))) \
+  X(vec3_to_dvec3_relative_batch,vec3_to_dvec3_relative_batch(v,dw[0],dvo,LEN)) \
+  X(loop_dvec3_add_vec3_as_dvec3,LIBM_LOOP(dvo[k]=dvec3_add(vec3_as_dvec3(v[k]),dw[0]))) \
+  X(dvec3_add_batch,dvec3_add_batch(dv,dw,dvo,LEN)) \
+  X(loop_dvec3_add,LIBM_LOOP(dvo[k]=dvec3_add(dv[k],dw[k]))) \
+  X(dvec3_sub_batch,dvec3_sub_batch(dv,dw,dvo,LEN)) \
+  X(loop_dvec3_sub,LIBM_LOOP(dvo[k]=dvec3_sub(dv[k],dw[k]))) \
+  X(dvec3_dot_batch,dvec3_dot_batch(dv,dw,dout,LEN)) \
+  X(loop_dvec3_dot,LIBM_LOOP(dout[k]=dvec3_dot(dv[k],dw[k]))) \
+  X(dvec3_cross_batch,dvec3_cross_batch(dv,dw,dvo,LEN)) \
+  X(loop_dvec3_cross,LIBM_LOOP(dvo[k]=dvec3_cross(dv[k],dw[k]))) \
+  X(dvec3_len_batch,dvec3_len_batch(dv,dout,LEN)) \
+  X(loop_dvec3_len,LIBM_LOOP(dout[k]=dvec3_len(dv[k]))) \
+  X(dvec3_distance_squared_batch,dvec3_distance_squared_batch(dv,dw,dout,LEN)) \
+  X(loop_dvec3_distance_squared,LIBM_LOOP(dout[k]=dvec3_distance_squared(dv[k],dw[k]))) \
+  X(dvec3_normalize_or_zero_batch,dvec3_normalize_or_zero_batch(dv,dvo,LEN)) \
+  X(dvec3_normalize_or_zero_batch_parallel,dvec3_normalize_or_zero_batch_parallel(dv,dvo,LEN)) \
+  X(loop_dvec3_normalize_or_zero,LIBM_LOOP(dvo[k]=dvec3_normalize_or_zero(dv[k]))) \
+  /* i32/ivec3_batch.h, each next to the per-point loop it replaces */ \
+  X(vec3_as_ivec3_batch,vec3_as_ivec3_batch(v,ivo,LEN)) \
+  X(loop_vec3_as_ivec3,LIBM_LOOP(ivo[k]=vec3_as_ivec3(v[k]))) \
+  X(vec3_floor_as_ivec3_batch,vec3_floor_as_ivec3_batch(v,ivo,LEN)) \
+  X(loop_vec3_floor_as_ivec3,LIBM_LOOP(ivo[k]=vec3_floor_as_ivec3(v[k]))) \
+  X(vec3_round_as_ivec3_batch,vec3_round_as_ivec3_batch(v,ivo,LEN)) \
+  X(loop_vec3_round_as_ivec3,LIBM_LOOP(ivo[k]=vec3_round_as_ivec3(v[k]))) \
+  X(vec3_grid_cells_batch,vec3_grid_cells_batch(v,w[0],0.25F,ivo,LEN)) \
+  X(vec3_grid_cells_batch_parallel,vec3_grid_cells_batch_parallel(v,w[0],0.25F,ivo,LEN)) \
+  X(ivec3_as_vec3_batch,ivec3_as_vec3_batch(iv,vo,LEN)) \
+  X(loop_ivec3_as_vec3,LIBM_LOOP(vo[k]=ivec3_as_vec3(iv[k]))) \
+  /* f32/vec3_buffer.h, each next to the per-point loop it replaces */ \
+  X(vec3_aos_to_soa,vec3_aos_to_soa(v,soa_out)) \
+  X(loop_vec3_aos_to_soa,LIBM_LOOP((xo[k]=v[k].x,yo[k]=v[k].y,zo[k]=v[k].z))) \
+  X(vec3_soa_to_aos,vec3_soa_to_aos(soa_a,vo)) \
+  X(loop_vec3_soa_to_aos,LIBM_LOOP(vo[k]=vec3_soa_get(soa_a,k))) \
+  X(vec3_buffer_to_soa_to_aos,(vec3_buffer_to_soa(&vbuf),vec3_buffer_to_aos(&vbuf))) \
+  /* f32/vec3_reduce.h, each next to the fold it replaces */ \
+  X(vec3_bounds,bounds_out=vec3_bounds(v,LEN)) \
+  X(loop_aabb_from_points,bounds_out=aabb_from_points(v,LEN)) \
+  X(vec3_sum_pairwise,acc_v=vec3_sum(v,LEN,VEC3_SUMMATION_PAIRWISE)) \
+  X(vec3_sum_kahan,acc_v=vec3_sum(v,LEN,VEC3_SUMMATION_KAHAN)) \
+  X(loop_vec3_add,acc_v=VEC3_ZERO; LIBM_LOOP(acc_v=vec3_add(acc_v,v[k]))) \
+  X(vec3_covariance_pairwise,covariance_out=vec3_covariance(v,LEN,VEC3_SUMMATION_PAIRWISE)) \
+  X(vec3_covariance_kahan,covariance_out=vec3_covariance(v,LEN,VEC3_SUMMATION_KAHAN)) \
+
+#define LIBM_LOOP(STMT) for(usize k=0;k<LEN;k++) { STMT; }
+
+#define DEFINE_SCALAR(NAME,EXPR) \
+  static void bench_##NAME(usize iters) { \
+    for(usize i=0;i<iters;i++) black_box(EXPR); \
+  }
+#define DEFINE_ARRAY(NAME,STMT) \
+  static void bench_##NAME(usize iters) { \
+    for(usize i=0;i<iters;i++) { \
+      STMT; \
+      __asm__ volatile("" : : : "memory"); \
+    } \
+  }
+
+SCALAR_BENCHES(DEFINE_SCALAR)
+ARRAY_BENCHES(DEFINE_ARRAY)
+
+#define ENTRY_SCALAR(NAME,EXPR) { #NAME,bench_##NAME,1 },
+#define ENTRY_ARRAY(NAME,STMT) { #NAME,bench_##NAME,LEN },
+
+static const Bench benches[]={
+  SCALAR_BENCHES(ENTRY_SCALAR)
+  ARRAY_BENCHES(ENTRY_ARRAY)
+};
+
+
+static inline f32 _rand_f32(f32 lo,f32 hi) {
+  return lo+(hi-lo)*(f32)rand()/(f32)RAND_MAX;
+}
+
+/// Nonzero, so divisions and normalizations stay on their common path.
+static inline f32 _rand_nonzero(void) {
+  const f32 x=_rand_f32(0.5F,10.0F);
+  return (rand()&1)? -x: x;
+}
+
+static inline Vec3 _rand_vec3(void) {
+  return vec3(_rand_nonzero(),_rand_nonzero(),_rand_nonzero());
+}
+
+static void _init(void) {
+  srand(0x5eed);
+  for(usize i=0;i<LEN;i++) {
+    v[i]=_rand_vec3();
+    w[i]=_rand_vec3();
+    u[i]=_rand_vec3();
+    n[i]=vec3_normalize(_rand_vec3());
+    va[i]=vec3a_from_vec3(v[i]);
+    wa[i]=vec3a_from_vec3(w[i]);
+    ua[i]=vec3a_from_vec3(u[i]);
+    na[i]=vec3a_from_vec3(n[i]);
+    b[i]=vec3_cmplt(v[i],w[i]);
+    bw[i]=vec3_cmpge(u[i],w[i]);
+    ba[i]=bvec3a_from_bvec3(b[i]);
+    bwa[i]=bvec3a_from_bvec3(bw[i]);
+    f[i]=_rand_nonzero();
+    g[i]=_rand_f32(0.5F,10.0F);
+    h[i]=_rand_f32(-1.0F,1.0F);
+    idx[i]=(usize)rand()%3;
+    flag[i]=rand()&1;
+    for(usize k=0;k<3;k++) {
+      d3[i][k]=_rand_nonzero();
+      f3[i][k]=_rand_nonzero();
+      b3[i][k]=rand()&1;
+    }
+    for(usize k=0;k<4;k++) f4[i][k]=_rand_nonzero();
+    m[i]=_mm_setr_ps(f[i],g[i],h[i],0.0F);
+    for(usize k=0;k<9;k++) f9[i][k]=_rand_nonzero();
+    for(usize k=0;k<16;k++) f16[i][k]=_rand_nonzero();
+    m3[i]=mat3_from_cols_array(f9[i]);
+    m3w[i]=mat3_from_cols(va[i],wa[i],ua[i]);
+    m4[i]=mat4_from_cols_array(f16[i]);
+    m4w[i]=mat4_from_mat3_translation(m3w[i],u[i]);
+    af[i]=affine3a_from_mat3_translation(m3[i],u[i]);
+    afw[i]=affine3a_from_mat3_translation(m3w[i],w[i]);
+    q[i]=quat_normalize(quat_from_array(f4[i]));
+    qw[i]=quat_from_axis_angle(n[i],f[i]);
+    n2[i]=vec3_normalize(_rand_vec3());
+    box[i]=aabb_from_center_half_size(v[i],vec3_abs(w[i]));
+    boxw[i]=aabb_from_center_half_size(w[i],vec3_abs(u[i]));
+    ray[i]=ray_new(vec3_mul_f32(u[i],4.0F),n[i]);
+    n_f16[i]=vec3_to_f16(n[i]);
+    n_snorm16[i]=vec3_to_snorm16(n[i]);
+    n_oct32[i]=vec3_to_oct32(n[i]);
+    dv[i]=dvec3_add(vec3_as_dvec3(v[i]),dvec3_new(6371000.0,0.0,0.0));
+    dw[i]=dvec3_add(vec3_as_dvec3(w[i]),dvec3_new(6371000.0,0.0,0.0));
+    du[i]=vec3_as_dvec3(u[i]);
+    dn[i]=dvec3_normalize(vec3_as_dvec3(n[i]));
+    df[i]=f[i];
+    dg[i]=g[i];
+    dh[i]=h[i];
+    for(usize k=0;k<4;k++) d4[i][k]=f4[i][k];
+    iv[i]=vec3_round_as_ivec3(vec3_mul_f32(v[i],10.0F));
+    iw[i]=vec3_round_as_ivec3(vec3_mul_f32(w[i],-10.0F));
+    id[i]=ivec3_new(rand()%9+1,-(rand()%9+1),rand()%9+1);
+    is[i]=rand()%201-100;
+    uv[i]=uvec3_new((u32)rand()%1000,(u32)rand()%1000,(u32)rand()%1000);
+    uw[i]=uvec3_new((u32)rand()%1000,(u32)rand()%1000,(u32)rand()%1000);
+    ud[i]=uvec3_new((u32)rand()%9+1,(u32)rand()%9+1,(u32)rand()%9+1);
+    us[i]=(u32)rand()%100;
+    for(usize k=0;k<3;k++) {
+      i3[i][k]=rand()%201-100;
+      u3[i][k]=(u32)rand()%1000;
+    }
+
+    xs[i]=v[i].x; ys[i]=v[i].y; zs[i]=v[i].z;
+    xs2[i]=w[i].x; ys2[i]=w[i].y; zs2[i]=w[i].z;
+  }
+
+  acc_v=VEC3_ONE;
+  acc_dv=DVEC3_ONE;
+  acc_iv=IVEC3_ONE;
+  acc_uv=UVEC3_ONE;
+  acc_va=VEC3A_ONE;
+  acc_b=BVEC3_FALSE;
+  acc_ba=BVEC3A_FALSE;
+  soa_a=vec3_soa(xs,ys,zs,LEN);
+  soa_b=vec3_soa(xs2,ys2,zs2,LEN);
+  soa_out=vec3_soa(xo,yo,zo,LEN);
+  vbuf=vec3_buffer_new(LEN,false);
+  vec3_buffer_assign(&vbuf,v,LEN);
+}
+
+int main(int argc,char** argv) {
+  _init();
+  return bench_main(argc,argv,benches,sizeof(benches)/sizeof(benches[0]));
+}
@@ -0,0 +1,423 @@
+// Accuracy sweep of the `f32` functions and approximations against an `f64` reference.
+//
+// One-argument functions run on every `f32` bit pattern (`--step=N` takes every `N`-th),
+// two-argument functions on a `--grid=N` by `N` grid of bit patterns spread evenly over
+// all `f32`s. Both also run on a short list of special values, and the grid crosses them
+// with each other. The inputs are cut into chunks run on the `cmeth_parallel_for` pool,
+// each chunk keeps its own statistics, and the chunks are combined in order, so a report
+// does not depend on the thread count.
+//
+// Where the reference or the result is a zero, an infinity or a NaN, the result must be
+// the reference rounded to `f32`, bit for bit (any NaN matches any NaN); anything else is
+// a special-case mismatch. Elsewhere the error is `|result-reference|` in units of the
+// `f32` spacing at the reference.
+//
+// Every function has a documented bound. The sweep exits with 1 when a function goes past
+// its bound or, unless its specials are not checked, has a special-case mismatch, so it
+// can gate a change to a fast path:
+//
+//   make ulp ULP_ARGS="--filter=atan2 --grid=65536"
+//
+// Options:
+// - `--filter=SUBSTR` only sweeps functions whose name contains `SUBSTR`.
+// - `--step=N` one-argument functions take every `N`-th bit pattern (default 1).
+// - `--grid=N` two-argument functions take `N*N` pairs (default 4097).
+// - `--threads=N` threads of the pool (default: `CMETH_THREADS`, or every online CPU).
+//
+// `CMETH_CPU_TIER` picks the kernels of the `_batch` functions as usual.
+#include "../src/f32/math_batch.h"
+#include "../src/f32/math_impl.h"
+#include "../src/f32/trig.h"
+#include "../src/cpu/features.h"
+#include "../src/thread/pool.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+/// Inputs per call of a function under test.
+#define ULP_BATCH 4096
+
+/// One-argument inputs per chunk of the pool.
+#define ULP_CHUNK (1u<<20)
+
+/// Specials reported in full per function at most.
+#define ULP_MISMATCHES_SHOWN 4
+
+/// Bit patterns every sweep runs on besides its evenly spread ones.
+static const u32 SPECIALS[]={
+  0x00000000,0x80000000, // +-0
+  0x00000001,0x80000001, // +-smallest subnormal
+  0x00800000,0x80800000, // +-smallest normal
+  0x3f000000,0xbf000000, // +-0.5
+  0x3f800000,0xbf800000, // +-1
+  0x40000000,0xc0000000, // +-2
+  0x7f7fffff,0xff7fffff, // +-largest finite
+  0x7f800000,0xff800000, // +-inf
+  0x7fc00000,0xffc00000, // +-quiet NaN
+  0x7f800001,            // signalling NaN
+};
+#define SPECIAL_COUNT (sizeof(SPECIALS)/sizeof(SPECIALS[0]))
+
+/// A function under test and its reference.
+typedef struct {
+  const char* name;
+  /// 1 or 2.
+  usize arity;
+  /// Writes `f(a[i])`, or `f(a[i],b[i])` with two arguments, to `out[i]`.
+  void (*run)(const f32* a,const f32* b,f32* out,usize n);
+  const f64 (*reference)(f64 a,f64 b);
+  /// Inputs the function is documented for, or `NULL` for all of them.
+  const bool (*domain)(f32 a,f32 b);
+  /// Largest error allowed, in ulp.
+  f64 bound;
+  /// Whether zeros, infinities and NaNs must match the reference.
+  bool specials;
+} UlpCase;
+
+/// What a run of inputs gave.
+typedef struct {
+  u64 count;
+  u64 mismatches;
+  f64 sum;
+  f64 max;
+  /// Inputs of `max`, the first ones to reach it.
+  f32 worst[2];
+  f32 worst_got;
+  f64 worst_want;
+  /// The first `ULP_MISMATCHES_SHOWN` special-case mismatches.
+  f32 mismatch[ULP_MISMATCHES_SHOWN][3];
+} UlpStats;
+
+typedef struct {
+  const UlpCase* c;
+  /// Evenly spread inputs along one axis, after the specials.
+  u64 spread;
+  /// Inputs along one axis, the specials included.
+  u64 len;
+  UlpStats* chunks;
+} UlpSweep;
+
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+static const bool _ulp_nonfinite_or_zero(f32 v) {
+  return v==0.0F || !f32_is_finite(v);
+}
+
+/// The spacing of `f32`s around `want`.
+static const f64 _ulp_spacing(f64 want) {
+  int e;
+  frexp(want,&e);
+  return ldexp(1.0,(MAX(e,-125))-24);
+}
+
+static void _ulp_record(UlpStats* s,f32 a,f32 b,f32 got,f64 want,bool specials) {
+  const f32 rounded=(f32)want;
+  // A zero result where the reference rounds to a tiny nonzero is an error like any other.
+  if(_ulp_nonfinite_or_zero(rounded) || !f32_is_finite(got)) {
+    const bool same=f32_is_nan(rounded)? f32_is_nan(got) : f32_to_bits(got)==f32_to_bits(rounded);
+    if(same) {
+      return;
+    }
+    if(specials) {
+      if(s->mismatches<ULP_MISMATCHES_SHOWN) {
+        s->mismatch[s->mismatches][0]=a;
+        s->mismatch[s->mismatches][1]=b;
+        s->mismatch[s->mismatches][2]=got;
+      }
+      s->mismatches++;
+      return;
+    }
+    if(f32_is_nan(rounded) || f32_is_nan(got)) {
+      return;
+    }
+  }
+  const f64 err=fabs((f64)got-want)/_ulp_spacing(want);
+  s->count++;
+  s->sum+=err;
+  if(err>s->max) {
+    s->max=err;
+    s->worst[0]=a;
+    s->worst[1]=b;
+    s->worst_got=got;
+    s->worst_want=want;
+  }
+}
+
+/// Combines `b`, which covers inputs after those of `a`, into `a`.
+static void _ulp_merge(UlpStats* a,const UlpStats* b) {
+  for(u64 k=0;k<b->mismatches && a->mismatches+k<ULP_MISMATCHES_SHOWN;k++) {
+    memcpy(a->mismatch[a->mismatches+k],b->mismatch[k],sizeof(a->mismatch[0]));
+  }
+  a->mismatches+=b->mismatches;
+  a->count+=b->count;
+  a->sum+=b->sum;
+  if(b->max>a->max) {
+    a->max=b->max;
+    memcpy(a->worst,b->worst,sizeof(a->worst));
+    a->worst_got=b->worst_got;
+    a->worst_want=b->worst_want;
+  }
+}
+
+/// The `i`-th input along an axis of `spread` bit patterns spread evenly over all of them,
+/// after the specials.
+static const f32 _ulp_input(u64 i,u64 spread) {
+  return f32_from_bits(i<SPECIAL_COUNT? SPECIALS[i] : (u32)(((i-SPECIAL_COUNT)<<32)/spread));
+}
+
+static const bool _ulp_signalling(f32 v) {
+  return f32_is_nan(v) && (f32_to_bits(v)&0x00400000)==0;
+}
+
+/// The reference of `c` at `a,b`. Widening to `f64` quiets a signalling NaN, which IEEE 754
+/// turns into NaN even where a quiet one gives a number, as in `pow(1,NaN)=1`.
+static const f64 _ulp_want(const UlpCase* c,f32 a,f32 b) {
+  if(_ulp_signalling(a) || (c->arity==2 && _ulp_signalling(b))) {
+    return NAN;
+  }
+  return c->reference(a,b);
+}
+
+/// Runs `a[i],b[i]` for `i<n` and records them into `s`, in order.
+static void _ulp_batch(const UlpCase* c,const f32* a,const f32* b,usize n,UlpStats* s) {
+  f32 keep_a[ULP_BATCH],keep_b[ULP_BATCH],out[ULP_BATCH];
+  usize kept=0;
+  for(usize i=0;i<n;i++) {
+    if(c->domain==NULL || c->domain(a[i],b[i])) {
+      keep_a[kept]=a[i];
+      keep_b[kept]=b[i];
+      kept++;
+    }
+  }
+  c->run(keep_a,keep_b,out,kept);
+  for(usize i=0;i<kept;i++) {
+    _ulp_record(s,keep_a[i],keep_b[i],out[i],_ulp_want(c,keep_a[i],keep_b[i]),c->specials);
+  }
+}
+
+/// Chunk `k`: `ULP_CHUNK` inputs of a one-argument sweep, or row `k` of the grid.
+static void _ulp_chunks(void* ctx,usize begin,usize end) {
+  const UlpSweep* sweep=ctx;
+  f32 a[ULP_BATCH],b[ULP_BATCH];
+  for(usize k=begin;k<end;k++) {
+    UlpStats* s=&sweep->chunks[k];
+    if(sweep->c->arity==1) {
+      const u64 first=(u64)k*ULP_CHUNK;
+      const u64 last=MIN(first+ULP_CHUNK,sweep->len);
+      for(u64 i=first;i<last;i+=ULP_BATCH) {
+        const usize n=(usize)(MIN(last-i,ULP_BATCH));
+        for(usize j=0;j<n;j++) {
+          a[j]=_ulp_input(i+j,sweep->spread);
+          b[j]=0.0F;
+        }
+        _ulp_batch(sweep->c,a,b,n,s);
+      }
+    } else {
+      const f32 row=_ulp_input(k,sweep->spread);
+      for(u64 i=0;i<sweep->len;i+=ULP_BATCH) {
+        const usize n=(usize)(MIN(sweep->len-i,ULP_BATCH));
+        for(usize j=0;j<n;j++) {
+          a[j]=row;
+          b[j]=_ulp_input(i+j,sweep->spread);
+        }
+        _ulp_batch(sweep->c,a,b,n,s);
+      }
+    }
+  }
+}
+
+
+/* one-argument functions, `b` unused */
+
+static void run_sin_batch(const f32* a,const f32* b,f32* out,usize n) { f32_sin_batch(a,out,n); }
+static void run_cos_batch(const f32* a,const f32* b,f32* out,usize n) { f32_cos_batch(a,out,n); }
+static void run_exp_batch(const f32* a,const f32* b,f32* out,usize n) { f32_exp_batch(a,out,n); }
+static void run_log_batch(const f32* a,const f32* b,f32* out,usize n) { f32_log_batch(a,out,n); }
+static void run_atan_batch(const f32* a,const f32* b,f32* out,usize n) { f32_atan_batch(a,out,n); }
+static void run_acos_batch(const f32* a,const f32* b,f32* out,usize n) { f32_acos_batch(a,out,n); }
+static void run_trunc_batch(const f32* a,const f32* b,f32* out,usize n) { f32_trunc_batch(a,out,n); }
+static void run_floor_batch(const f32* a,const f32* b,f32* out,usize n) { f32_floor_batch(a,out,n); }
+static void run_round_batch(const f32* a,const f32* b,f32* out,usize n) { f32_round_batch(a,out,n); }
+
+#define UNARY(name,expr) \
+  static void name(const f32* a,const f32* b,f32* out,usize n) { \
+    for(usize i=0;i<n;i++) { \
+      const f32 x=a[i]; \
+      out[i]=(expr); \
+    } \
+  }
+UNARY(run_sqrt,f32_sqrt(x))
+UNARY(run_rsqrt_fast,f32_rsqrt_fast(x))
+UNARY(run_exp,f32_exp(x))
+UNARY(run_trunc,f32_trunc(x))
+UNARY(run_atanf,_atanf(x))
+UNARY(run_acos_approx,_acos_approx_f32(x))
+#undef UNARY
+
+static const f64 ref_sin(f64 a,f64 b) { return sin(a); }
+static const f64 ref_cos(f64 a,f64 b) { return cos(a); }
+static const f64 ref_exp(f64 a,f64 b) { return exp(a); }
+static const f64 ref_log(f64 a,f64 b) { return log(a); }
+static const f64 ref_atan(f64 a,f64 b) { return atan(a); }
+static const f64 ref_acos(f64 a,f64 b) { return acos(a); }
+static const f64 ref_sqrt(f64 a,f64 b) { return sqrt(a); }
+static const f64 ref_rsqrt(f64 a,f64 b) { return 1.0/sqrt(a); }
+static const f64 ref_trunc(f64 a,f64 b) { return trunc(a); }
+static const f64 ref_floor(f64 a,f64 b) { return floor(a); }
+static const f64 ref_round(f64 a,f64 b) { return round(a); }
+static const f64 ref_acos_clamped(f64 a,f64 b) { return acos(a!=a? a : fmin(fmax(a,-1.0),1.0)); }
+
+static const bool positive_normal(f32 a,f32 b) { return a>=0x1p-126F && a<F32_INFINITY; }
+
+
+/* two-argument functions, `f(a,b)` */
+
+static void run_atan2_batch(const f32* a,const f32* b,f32* out,usize n) { f32_atan2_batch(a,b,out,n); }
+static void run_div_euclid_batch(const f32* a,const f32* b,f32* out,usize n) { f32_div_euclid_batch(a,b,out,n); }
+static void run_rem_euclid_batch(const f32* a,const f32* b,f32* out,usize n) { f32_rem_euclid_batch(a,b,out,n); }
+
+#define BINARY(name,expr) \
+  static void name(const f32* a,const f32* b,f32* out,usize n) { \
+    for(usize i=0;i<n;i++) { \
+      const f32 x=a[i]; \
+      const f32 y=b[i]; \
+      out[i]=(expr); \
+    } \
+  }
+BINARY(run_atan2f,_atan2f(x,y))
+BINARY(run_pow,f32_pow(x,y))
+BINARY(run_div_euclid,f32_div_euclid(x,y))
+BINARY(run_rem_euclid,f32_rem_euclid(x,y))
+#undef BINARY
+
+static const f64 ref_atan2(f64 a,f64 b) { return atan2(a,b); }
+static const f64 ref_pow(f64 a,f64 b) { return pow(a,b); }
+
+/// `fmod` is exact, so only adding `|b|` to a negative remainder rounds.
+static const f64 ref_rem_euclid(f64 a,f64 b) {
+  const f64 r=fmod(a,b);
+  return r<0.0? r+fabs(b) : r;
+}
+
+/// Like Rust's `div_euclid`, the truncated quotient rounded to `f32` first, one off when
+/// the remainder is negative. Past `2^24` that step is not an `f32` and rounds by half an
+/// ulp.
+static const f64 ref_div_euclid(f64 a,f64 b) {
+  const f64 q=trunc((f32)(a/b));
+  if(fmod(a,b)<0.0) {
+    return b>0.0? q-1.0 : q+1.0;
+  }
+  return q;
+}
+
+
+/// Every function the sweep knows, with the bounds it is held to.
+static const UlpCase ULP_CASES[]={
+  {"f32_sin_batch",1,run_sin_batch,ref_sin,NULL,2.5,true},
+  {"f32_cos_batch",1,run_cos_batch,ref_cos,NULL,2.5,true},
+  {"f32_exp_batch",1,run_exp_batch,ref_exp,NULL,1.5,true},
+  {"f32_log_batch",1,run_log_batch,ref_log,NULL,1.5,true},
+  {"f32_atan_batch",1,run_atan_batch,ref_atan,NULL,3.0,true},
+  {"f32_acos_batch",1,run_acos_batch,ref_acos,NULL,1.5,true},
+  {"f32_sqrt",1,run_sqrt,ref_sqrt,NULL,0.5,true},
+  {"f32_rsqrt_fast",1,run_rsqrt_fast,ref_rsqrt,positive_normal,5.0,true},
+  {"f32_exp",1,run_exp,ref_exp,NULL,1.0,true},
+  {"f32_trunc",1,run_trunc,ref_trunc,NULL,0.0,true},
+  {"_atanf",1,run_atanf,ref_atan,NULL,1.0,true},
+  {"f32_trunc_batch",1,run_trunc_batch,ref_trunc,NULL,0.0,true},
+  {"f32_floor_batch",1,run_floor_batch,ref_floor,NULL,0.0,true},
+  {"f32_round_batch",1,run_round_batch,ref_round,NULL,0.0,true},
+  {"_acos_approx_f32",1,run_acos_approx,ref_acos_clamped,NULL,64.0,true},
+  {"_atan2f",2,run_atan2f,ref_atan2,NULL,3.0,true},
+  {"f32_atan2_batch",2,run_atan2_batch,ref_atan2,NULL,3.0,true},
+  {"f32_pow",2,run_pow,ref_pow,NULL,1.0,true},
+  {"f32_div_euclid",2,run_div_euclid,ref_div_euclid,NULL,0.5,true},
+  {"f32_rem_euclid",2,run_rem_euclid,ref_rem_euclid,NULL,0.5,true},
+  {"f32_div_euclid_batch",2,run_div_euclid_batch,ref_div_euclid,NULL,0.5,true},
+  {"f32_rem_euclid_batch",2,run_rem_euclid_batch,ref_rem_euclid,NULL,0.5,true},
+};
+#define ULP_CASE_COUNT (sizeof(ULP_CASES)/sizeof(ULP_CASES[0]))
+
+
+/// Sweeps `c` and prints its line. Returns whether it stayed within its bound.
+static const bool _ulp_sweep(const UlpCase* c,u64 step,u64 grid) {
+  UlpSweep sweep={.c=c,.spread=c->arity==1? ((1ull<<32)+step-1)/step : grid};
+  sweep.len=SPECIAL_COUNT+sweep.spread;
+  const usize chunks=(usize)(c->arity==1? (sweep.len+ULP_CHUNK-1)/ULP_CHUNK : sweep.len);
+  sweep.chunks=calloc(chunks,sizeof(UlpStats));
+  if(sweep.chunks==NULL) {
+    panic("bench_ulp: out of memory\n");
+  }
+  const f64 start=now_ns();
+  cmeth_parallel_for(chunks,1,_ulp_chunks,&sweep);
+  UlpStats total={0};
+  for(usize k=0;k<chunks;k++) {
+    _ulp_merge(&total,&sweep.chunks[k]);
+  }
+  free(sweep.chunks);
+  const f64 seconds=(now_ns()-start)*1e-9;
+
+  const bool pass=total.max<=c->bound && total.mismatches==0;
+  printf("%-20s %10.3f %10.4f %7.2f %10llu %12llu %8.1fs  %s\n",c->name,total.max,
+    total.count? total.sum/(f64)total.count : 0.0,c->bound,(unsigned long long)total.mismatches,
+    (unsigned long long)total.count,seconds,pass? "ok" : "FAIL");
+  if(total.max>0.0) {
+    if(c->arity==1) {
+      printf("  worst: f(%a)=%a, want %a\n",total.worst[0],total.worst_got,total.worst_want);
+    } else {
+      printf("  worst: f(%a,%a)=%a, want %a\n",total.worst[0],total.worst[1],total.worst_got,total.worst_want);
+    }
+  }
+  for(u64 k=0;k<total.mismatches && k<ULP_MISMATCHES_SHOWN;k++) {
+    const f32* m=total.mismatch[k];
+    const f32 want=(f32)_ulp_want(c,m[0],m[1]);
+    if(c->arity==1) {
+      printf("  special: f(%a)=%a, want %a\n",m[0],m[2],want);
+    } else {
+      printf("  special: f(%a,%a)=%a, want %a\n",m[0],m[1],m[2],want);
+    }
+  }
+  fflush(stdout);
+  return pass;
+}
+
+int main(int argc,char** argv) {
+  const char* filter=NULL;
+  u64 step=1;
+  u64 grid=4097;
+  usize threads=0;
+  for(int i=1;i<argc;i++) {
+    const char* arg=argv[i];
+    if(strncmp(arg,"--filter=",9)==0) filter=arg+9;
+    else if(strncmp(arg,"--step=",7)==0) step=strtoull(arg+7,NULL,10);
+    else if(strncmp(arg,"--grid=",7)==0) grid=strtoull(arg+7,NULL,10);
+    else if(strncmp(arg,"--threads=",10)==0) threads=(usize)strtoull(arg+10,NULL,10);
+    else {
+      panic("bench_ulp: unknown option %s\n",arg)
+    }
+  }
+  step=step>0? step : 1;
+  grid=grid>0? grid : 1;
+  grid=grid<(1ull<<32)? grid : 1ull<<32;
+
+  cmeth_thread_pool_configure((ThreadPoolOptions){.threads=threads,.pin=false});
+  printf("tier: %s, %zu threads, every %llu-th input, %llux%llu grid\n",
+    cmeth_cpu_tier_name(cmeth_cpu_tier()),cmeth_thread_pool_threads(),(unsigned long long)step,
+    (unsigned long long)grid,(unsigned long long)grid);
+  printf("%-20s %10s %10s %7s %10s %12s %9s\n","function","max ulp","mean ulp","bound","specials","inputs","time");
+  usize failed=0;
+  for(usize i=0;i<ULP_CASE_COUNT;i++) {
+    if(filter!=NULL && strstr(ULP_CASES[i].name,filter)==NULL) continue;
+    failed+=!_ulp_sweep(&ULP_CASES[i],step,grid);
+  }
+  cmeth_thread_pool_shutdown();
+  if(failed>0) {
+    printf("bench_ulp: %zu function(s) past their bound\n",failed);
+  }
+  return failed>0;
+}
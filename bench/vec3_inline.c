@@ -0,0 +1,45 @@
+// Per-call overhead of the `vec3_*` API in a tight loop.
+//
+// Built twice by `make bench-throughput`: once against `libcmeth.a` and once with
+// `CMETH_HEADER_ONLY`, so the difference between the two ns/op figures is what the call
+// boundary costs.
+#include "../src/f32/vec3.h"
+#include <time.h>
+
+#define LEN 4096
+#define ROUNDS 2000
+
+static Vec3 a[LEN];
+static Vec3 b[LEN];
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+int main() {
+  for(usize i=0;i<LEN;i++) {
+    a[i]=vec3_new((f32)i,(f32)(i%7)+1.0F,0.5F);
+    b[i]=vec3_new(1.0F,(f32)(i%13),(f32)i*0.25F);
+  }
+
+  f32 sink=0.0F;
+  const f64 start=now_ns();
+  for(usize r=0;r<ROUNDS;r++) {
+    for(usize i=0;i<LEN;i++) {
+      Vec3 c=vec3_cross(a[i],b[i]);
+      Vec3 d=vec3_add(vec3_mul_f32(a[i],0.5F),c);
+      sink+=vec3_dot(d,b[i])+vec3_distance_squared(a[i],c);
+    }
+  }
+  const f64 elapsed=now_ns()-start;
+
+#ifdef CMETH_HEADER_ONLY
+  const char* mode="header-only";
+#else
+  const char* mode="archive";
+#endif
+  printf("%-12s %8.3f ns/iter (sink=%g)\n",mode,elapsed/((f64)LEN*ROUNDS),sink);
+  return 0;
+}
@@ -0,0 +1,109 @@
+// Encode/decode throughput of the packed `Vec3` formats, and the end-to-end time of
+// rotating 4M normals stored as `Vec3`, `Vec3F16`, `Vec3Snorm16` and `Vec3Oct32`
+// (`./bench_vec3_packed <normals>` picks another count). The packed paths decode a block
+// into a small `Vec3` buffer, transform it with `affine3a_transform_vectors` and encode it
+// back, so they trade memory traffic for conversion work.
+#include "../src/f32/vec3_packed.h"
+#include "../src/f32/affine3a_batch.h"
+#include "../src/f32/math_impl.h"
+#include "../src/cpu/features.h"
+#include <time.h>
+
+#define ROUNDS 5
+#define BLOCK 1024
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+static u32 rng=12345;
+
+/// Uniform in [-1,1).
+static f32 random_f32() {
+  rng=rng*1664525u+1013904223u;
+  return (f32)(rng>>8)*(2.0F/16777216.0F)-1.0F;
+}
+
+static void report(const char* name,f64 best,usize n,usize bytes) {
+  printf("%-40s %8.2f ms %8.2f GB/s\n",name,best*1e-6,(f64)(n*bytes)/best);
+}
+
+/// Rotates the `n` normals of `packed` in place through a `Vec3` block.
+#define ROTATE_PACKED(type,from,to,tf,packed,n) do { \
+    Vec3 block[BLOCK]; \
+    for(usize i=0;i<(n);i+=BLOCK) { \
+      const usize len=(n)-i<BLOCK? (n)-i : BLOCK; \
+      from((const type*)(packed)+i,block,len); \
+      affine3a_transform_vectors((tf),block,block,len); \
+      to(block,(type*)(packed)+i,len); \
+    } \
+  } while(0)
+
+int main(int argc,char** argv) {
+  const usize n=argc>1? (usize)strtoull(argv[1],NULL,10) : 4u<<20;
+  Vec3* normals=malloc(n*sizeof(Vec3));
+  Vec3* decoded=malloc(n*sizeof(Vec3));
+  Vec3F16* halves=malloc(n*sizeof(Vec3F16));
+  Vec3Snorm16* snorms=malloc(n*sizeof(Vec3Snorm16));
+  Vec3Oct32* octs=malloc(n*sizeof(Vec3Oct32));
+  if(normals==NULL || decoded==NULL || halves==NULL || snorms==NULL || octs==NULL) {
+    panic("bench_vec3_packed: out of memory\n");
+  }
+  for(usize i=0;i<n;i++) {
+    normals[i]=vec3_normalize_or(vec3_new(random_f32(),random_f32(),random_f32()),VEC3_Z);
+  }
+  const Affine3A tf=affine3a_from_mat3(mat3_from_rotation_z(0.001F));
+
+  printf("tier: %s, %zu normals\n",cmeth_cpu_tier_name(cmeth_cpu_tier()),n);
+  f64 best[10];
+  for(usize k=0;k<10;k++) {
+    best[k]=F32_INFINITY;
+  }
+  for(usize r=0;r<ROUNDS;r++) {
+    f64 t[11];
+    t[0]=now_ns();
+    vec3_to_f16_batch(normals,halves,n);
+    t[1]=now_ns();
+    vec3_from_f16_batch(halves,decoded,n);
+    t[2]=now_ns();
+    vec3_to_snorm16_batch(normals,snorms,n);
+    t[3]=now_ns();
+    vec3_from_snorm16_batch(snorms,decoded,n);
+    t[4]=now_ns();
+    vec3_to_oct32_batch(normals,octs,n);
+    t[5]=now_ns();
+    vec3_from_oct32_batch(octs,decoded,n);
+    t[6]=now_ns();
+    affine3a_transform_vectors(&tf,normals,normals,n);
+    t[7]=now_ns();
+    ROTATE_PACKED(Vec3F16,vec3_from_f16_batch,vec3_to_f16_batch,&tf,halves,n);
+    t[8]=now_ns();
+    ROTATE_PACKED(Vec3Oct32,vec3_from_oct32_batch,vec3_to_oct32_batch,&tf,octs,n);
+    t[9]=now_ns();
+    ROTATE_PACKED(Vec3Snorm16,vec3_from_snorm16_batch,vec3_to_snorm16_batch,&tf,snorms,n);
+    t[10]=now_ns();
+    for(usize k=0;k<10;k++) {
+      best[k]=MIN(best[k],t[k+1]-t[k]);
+    }
+  }
+  // Bandwidth counts the bytes read and written per normal.
+  report("vec3_to_f16_batch",best[0],n,12+6);
+  report("vec3_from_f16_batch",best[1],n,6+12);
+  report("vec3_to_snorm16_batch",best[2],n,12+6);
+  report("vec3_from_snorm16_batch",best[3],n,6+12);
+  report("vec3_to_oct32_batch",best[4],n,12+4);
+  report("vec3_from_oct32_batch",best[5],n,4+12);
+  report("rotate Vec3 in place",best[6],n,12+12);
+  report("rotate Vec3F16 in place",best[7],n,6+6);
+  report("rotate Vec3Oct32 in place",best[8],n,4+4);
+  report("rotate Vec3Snorm16 in place",best[9],n,6+6);
+
+  free(octs);
+  free(snorms);
+  free(halves);
+  free(decoded);
+  free(normals);
+  return 0;
+}
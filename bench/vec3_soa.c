@@ -0,0 +1,95 @@
+// Throughput of the `vec3_soa_*` batch kernels against a scalar `vec3_*` loop over the same
+// planes, in GFLOP/s.
+//
+// `make bench-throughput` builds this with `CMETH_HEADER_ONLY`, so the scalar loop is the
+// inlined best case rather than a call per element. Set `CMETH_CPU_TIER` to compare kernel
+// tiers.
+#include "../src/f32/vec3_soa.h"
+#include "../src/cpu/features.h"
+#include <time.h>
+
+#define LEN (1<<16)
+#define ROUNDS 400
+
+static f32 ax[LEN],ay[LEN],az[LEN];
+static f32 bx[LEN],by[LEN],bz[LEN];
+static f32 ox[LEN],oy[LEN],oz[LEN];
+static f32 out[LEN];
+
+#define AT(soa,i) vec3_new((soa).x[i],(soa).y[i],(soa).z[i])
+
+static inline void put(Vec3Soa soa,usize i,Vec3 v) {
+  soa.x[i]=v.x;
+  soa.y[i]=v.y;
+  soa.z[i]=v.z;
+}
+
+static f64 now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (f64)ts.tv_sec*1e9+(f64)ts.tv_nsec;
+}
+
+static void report(const char* name,f64 flops_per_elem,f64 scalar_ns,f64 batch_ns) {
+  const f64 flops=flops_per_elem*(f64)LEN*ROUNDS;
+  printf("%-28s scalar %7.2f GFLOP/s  batch %7.2f GFLOP/s  (%.1fx)\n",
+    name,flops/scalar_ns,flops/batch_ns,scalar_ns/batch_ns);
+}
+
+int main() {
+  for(usize i=0;i<LEN;i++) {
+    ax[i]=(f32)i*0.5F;
+    ay[i]=(f32)(i%17)-8.0F;
+    az[i]=1.0F/(f32)(i+1);
+    bx[i]=(f32)(i%5);
+    by[i]=(f32)i*-0.25F;
+    bz[i]=2.0F;
+  }
+  const Vec3Soa a=vec3_soa(ax,ay,az,LEN);
+  const Vec3Soa b=vec3_soa(bx,by,bz,LEN);
+  const Vec3Soa o=vec3_soa(ox,oy,oz,LEN);
+  f64 t,scalar,batch;
+  printf("tier: %s (detected %s)\n",cmeth_cpu_tier_name(cmeth_cpu_tier()),cmeth_cpu_tier_name(cmeth_cpu_detected_tier()));
+
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) for(usize i=0;i<LEN;i++) out[i]=vec3_dot(AT(a,i),AT(b,i));
+  scalar=now_ns()-t;
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) vec3_soa_dot(a,b,out);
+  batch=now_ns()-t;
+  report("vec3_soa_dot",5,scalar,batch);
+
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) for(usize i=0;i<LEN;i++) put(o,i,vec3_cross(AT(a,i),AT(b,i)));
+  scalar=now_ns()-t;
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) vec3_soa_cross(a,b,o);
+  batch=now_ns()-t;
+  report("vec3_soa_cross",9,scalar,batch);
+
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) for(usize i=0;i<LEN;i++) out[i]=vec3_len(AT(a,i));
+  scalar=now_ns()-t;
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) vec3_soa_len(a,out);
+  batch=now_ns()-t;
+  report("vec3_soa_len",6,scalar,batch);
+
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) for(usize i=0;i<LEN;i++) put(o,i,vec3_normalize_or_zero(AT(a,i)));
+  scalar=now_ns()-t;
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) vec3_soa_normalize_or_zero(a,o);
+  batch=now_ns()-t;
+  report("vec3_soa_normalize_or_zero",10,scalar,batch);
+
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) for(usize i=0;i<LEN;i++) out[i]=vec3_distance_squared(AT(a,i),AT(b,i));
+  scalar=now_ns()-t;
+  t=now_ns();
+  for(usize r=0;r<ROUNDS;r++) vec3_soa_distance_squared(a,b,out);
+  batch=now_ns()-t;
+  report("vec3_soa_distance_squared",8,scalar,batch);
+
+  return 0;
+}
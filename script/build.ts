@@ -2,12 +2,25 @@
 const LIB_NAME="cmeth";
 const ROOT=new URL("../",import.meta.url);
 const INCLUDE_DIR=new URL("./include/",ROOT);
+const PGO_DIR=new URL("./pgo/",ROOT);
+
+type Profile={
+  cflags: string[],
+  pgo?: "generate"|"use",
+};
 
 async function main() {
   const call_stack=new Array<Promise<void>>();
   Deno.chdir(ROOT);
   await Promise.allSettled([ensure_dir("include"),ensure_dir("bin")]);
 
+  const manifest=parse_manifest(await Deno.readTextFile("Ship.toml"));
+  const args=parse_args(Deno.args);
+  const profile_name=args.profile || String(manifest["build"]?.profile ?? "debug");
+  const march=args.march ?? String(manifest["build"]?.march ?? "");
+  const cflags=profile_cflags(manifest,profile_name,march).join(" ");
+  console.log(`lib${LIB_NAME}.a [${profile_name}]: gcc ${cflags}`);
+
   async function walk_dir(path: URL|string) {
     const cwd=Deno.cwd();
     Deno.chdir(path);
@@ -20,7 +33,7 @@ async function main() {
       if(!file.name.endsWith(".c")) continue;
 
       const obj_name=real_path.replace(ROOT.pathname,"").replaceAll("/","_");
-      call_stack.push(run(`gcc -Wall -g -c ${real_path} -o ${INCLUDE_DIR.pathname}/${obj_name}.o`));
+      call_stack.push(run(`gcc ${cflags} -c ${real_path} -o ${INCLUDE_DIR.pathname}/${obj_name}.o`));
     }
     Deno.chdir(cwd);
   }
@@ -28,7 +41,10 @@ async function main() {
     
 
   await walk_dir("src");
-  await Promise.allSettled(call_stack);
+  const failed=(await Promise.allSettled(call_stack)).filter(result=> result.status==="rejected");
+  if(failed.length>0) {
+    throw new Error(`${failed.length} translation unit(s) failed to compile`);
+  }
 
   Deno.chdir(INCLUDE_DIR);
 
@@ -38,8 +54,11 @@ async function main() {
     objects.push(file.name);
   }
 
+  // Start from an empty archive so objects from another profile never linger, and index it
+  // with `gcc-ar` so LTO consumers see the symbol table of the LTO sections.
   const object_paths=objects.join(" ");
-  await run(`ar -rc ./lib${LIB_NAME}.a ${object_paths}`);
+  await run(`rm -f ./lib${LIB_NAME}.a`);
+  await run(`gcc-ar -rc ./lib${LIB_NAME}.a ${object_paths}`);
   await run(`rm -f ${object_paths}`);
 }
 
@@ -48,6 +67,76 @@ async function main() {
 //ar -rc "./lib$1.a" *.o
 
 
+/// Resolves `[profile.<name>]` from Ship.toml into the flags passed to every `gcc -c`.
+function profile_cflags(manifest: Manifest,name: string,march: string): string[] {
+  const profile=manifest[`profile.${name}`] as Profile|undefined;
+  if(!profile) {
+    throw new Error(`Ship.toml has no [profile.${name}]`);
+  }
+
+  const cflags=[...profile.cflags];
+  if(march!=="") {
+    cflags.push(`-march=${march}`);
+  }
+
+  // Both PGO steps must agree on the profile directory, and the object paths they compile to
+  // must match, since gcc names each .gcda after its object file.
+  switch(profile.pgo) {
+    case "generate":
+      cflags.push("-fprofile-generate","-fprofile-update=atomic",`-fprofile-dir=${PGO_DIR.pathname}`);
+    break;
+    case "use":
+      cflags.push("-fprofile-use","-fprofile-partial-training","-Wno-missing-profile",`-fprofile-dir=${PGO_DIR.pathname}`);
+    break;
+  }
+  return cflags;
+}
+
+function parse_args(args: string[]): { profile?: string, march?: string } {
+  const options: { profile?: string, march?: string }={};
+  for(const arg of args) {
+    const [key,value]=arg.split("=",2);
+    switch(key) {
+      case "--profile":
+        options.profile=value;
+      break;
+      case "--march":
+        // `make` always passes `--march=$(MARCH)`; an empty one defers to Ship.toml.
+        if(value) options.march=value;
+      break;
+      default:
+        throw new Error(`unknown argument \`${arg}\``);
+    }
+  }
+  return options;
+}
+
+type Manifest=Record<string,Record<string,unknown>>;
+
+/// Reads the subset of TOML that Ship.toml uses: `[table]` headers, `#` comments and
+/// single-line `key = value` pairs whose value is a string, number, boolean or array of those.
+function parse_manifest(text: string): Manifest {
+  const manifest: Manifest={ "": {} };
+  let table=manifest[""];
+  for(const raw of text.split("\n")) {
+    const line=raw.replace(/^([^"#]*("[^"]*"[^"#]*)*)#.*$/,"$1").trim();
+    if(line==="") continue;
+
+    const header=line.match(/^\[([^\]]+)\]$/);
+    if(header) {
+      table=manifest[header[1].trim()]??={};
+      continue;
+    }
+
+    const eq=line.indexOf("=");
+    if(eq<0) {
+      throw new Error(`Ship.toml: cannot parse \`${raw}\``);
+    }
+    table[line.slice(0,eq).trim()]=JSON.parse(line.slice(eq+1).trim());
+  }
+  return manifest;
+}
+
 async function ensure_dir(path: URL|string) {
   await Deno.mkdir(path,{ recursive: true }).catch(_=> {});
 }
@@ -55,7 +144,10 @@ async function ensure_dir(path: URL|string) {
 async function run(cmd: string) {
   const [command,...args]=cmd.split(" ");
   const process=new Deno.Command(command,{ args }).spawn();
-  await process.status;
+  const status=await process.status;
+  if(!status.success) {
+    throw new Error(`\`${cmd}\` exited with ${status.code}`);
+  }
 }
 
 
@@ -29,6 +29,13 @@ const BVec3 bvec3_from_array(bool a[3]) {
   return bvec3_new(a[0],a[1],a[2]);
 }
 
+/// Creates a vector mask from the lowest 3 bits of `bitmask`, as returned by
+/// `bvec3_bitmask` or `_mm_movemask_ps`. Bit 0 goes into `x`, bit 1 into `y`, etc.
+inline
+const BVec3 bvec3_from_bitmask(u32 bitmask) {
+  return bvec3_new(bitmask & 1,(bitmask>>1) & 1,(bitmask>>2) & 1);
+}
+
 /// Returns a bitmask with the lowest 3 bits set from the elements of `self`.
 ///
 /// A true element results in a `1` bit and a false element in a `0` bit.  Element `x` goes
@@ -41,45 +48,38 @@ const u32 bvec3_bitmask(const BVec3 self) {
 /// Returns true if any of the elements are true, false otherwise.
 inline
 const bool bvec3_any(const BVec3 self) {
-  return self.x || self.y || self.z;
+  return bvec3_bitmask(self)!=0;
 }
 
 /// Returns true if all the elements are true, false otherwise.
 inline
 const bool bvec3_all(const BVec3 self) {
-  return self.x && self.y && self.z;
+  return bvec3_bitmask(self)==0x7;
 }
 
 /// Tests the value at `index`.
-/// 
-/// Panics if `index` is greater than 2.
+///
+/// Panics
+///
+/// Will panic if `index` is greater than 2 when `cmeth_assert` is enabled. Otherwise such
+/// an `index` tests `false`.
 inline
 const bool bvec3_test(const BVec3 self,usize index) {
-  switch(index) {
-    case 0: return self.x;
-    case 1: return self.y;
-    case 2: return self.z;
-    default: panic("index out of bounds")
-  }
+  cmeth_assert(index<=2);
+  return index<=2 && ((bvec3_bitmask(self)>>index) & 1);
 }
 
 /// Sets the element at `index`.
 ///
-/// Panics if `index` is greater than 2.
+/// Panics
+///
+/// Will panic if `index` is greater than 2 when `cmeth_assert` is enabled. Otherwise such
+/// an `index` leaves `self` unchanged.
 inline
 void bvec3_set(BVec3* self,usize index,bool value) {
-  switch(index) {
-    case 0:
-      self->x=value;
-    break;
-    case 1:
-      self->y=value;
-    break;
-    case 2:
-      self->z=value;
-    break;
-    default: panic("index out of bounds")
-  }
+  cmeth_assert(index<=2);
+  const u32 bit=index<=2? 1u<<index : 0;
+  *self=bvec3_from_bitmask((bvec3_bitmask(*self) & ~bit) | (value? bit : 0));
 }
 
 inline_always
@@ -14,54 +14,60 @@ typedef struct {
 extern "C" {
 #endif
 /// Creates a 3-dimensional `bool` vector mask.
-const BVec3 bvec3(bool x, bool y, bool z);
+CMETH_API const BVec3 bvec3(bool x, bool y, bool z);
 
 /// Creates a new vector mask.
-const BVec3 bvec3_new(bool x, bool y, bool z);
+CMETH_API const BVec3 bvec3_new(bool x, bool y, bool z);
 
 /// Creates a vector mask with all elements set to `v`.
-const BVec3 bvec3_splat(bool v);
+CMETH_API const BVec3 bvec3_splat(bool v);
 
 /// Creates a vector mask with all elements set to `v`.
-const BVec3 bvec3_from_array(bool a[3]);
+CMETH_API const BVec3 bvec3_from_array(bool a[3]);
+
+/// Creates a vector mask from the lowest 3 bits of `bitmask`, as returned by
+/// `bvec3_bitmask` or `_mm_movemask_ps`. Bit 0 goes into `x`, bit 1 into `y`, etc.
+CMETH_API const BVec3 bvec3_from_bitmask(u32 bitmask);
 
 /// Returns a bitmask with the lowest 3 bits set from the elements of `self`.
 ///
 /// A true element results in a `1` bit and a false element in a `0` bit.  Element `x` goes
 /// into the first lowest bit, element `y` into the second, etc.
-const u32 bvec3_bitmask(const BVec3 self);
+CMETH_API const u32 bvec3_bitmask(const BVec3 self);
 
 /// Returns true if any of the elements are true, false otherwise.
-const bool bvec3_any(const BVec3 self);
+CMETH_API const bool bvec3_any(const BVec3 self);
 
 /// Returns true if all the elements are true, false otherwise.
-const bool bvec3_all(const BVec3 self);
+CMETH_API const bool bvec3_all(const BVec3 self);
 
 /// Tests the value at `index`.
-/// 
-/// Panics if `index` is greater than 2.
-const bool bvec3_test(const BVec3 self,usize index);
+///
+/// Panics if `index` is greater than 2 when `cmeth_assert` is enabled. Otherwise such
+/// an `index` tests `false`.
+CMETH_API const bool bvec3_test(const BVec3 self,usize index);
 
 /// Sets the element at `index`.
 ///
-/// Panics if `index` is greater than 2.
-void bvec3_set(BVec3* self,usize index,bool value);
+/// Panics if `index` is greater than 2 when `cmeth_assert` is enabled. Otherwise such
+/// an `index` leaves `self` unchanged.
+CMETH_API void bvec3_set(BVec3* self,usize index,bool value);
 
-const BVec3 bvec3_default();
+CMETH_API const BVec3 bvec3_default();
 
-const BVec3 bvec3_bitand(const BVec3 self,const BVec3 rhs);
+CMETH_API const BVec3 bvec3_bitand(const BVec3 self,const BVec3 rhs);
 
-void bvec3_bitand_assign(BVec3* self,const BVec3 rhs);
+CMETH_API void bvec3_bitand_assign(BVec3* self,const BVec3 rhs);
 
-const BVec3 bvec3_bitor(const BVec3 self,const BVec3 rhs);
+CMETH_API const BVec3 bvec3_bitor(const BVec3 self,const BVec3 rhs);
 
-void bvec3_bitor_assign(BVec3* self,const BVec3 rhs);
+CMETH_API void bvec3_bitor_assign(BVec3* self,const BVec3 rhs);
 
-const BVec3 bvec3_bitxor(const BVec3 self,const BVec3 rhs);
+CMETH_API const BVec3 bvec3_bitxor(const BVec3 self,const BVec3 rhs);
 
-void bvec3_bitxor_assign(BVec3* self,const BVec3 rhs);
+CMETH_API void bvec3_bitxor_assign(BVec3* self,const BVec3 rhs);
 
-const BVec3 bvec3_bitnot(const BVec3 self);
+CMETH_API const BVec3 bvec3_bitnot(const BVec3 self);
 
 
 #ifdef _cplusplus
@@ -73,5 +79,10 @@ const BVec3 bvec3_bitnot(const BVec3 self);
 #define BVEC3_TRUE bvec3_splat(true)
 
 
+#ifdef CMETH_HEADER_ONLY
+#include "bvec3.c"
+#endif
+
+
 
 #endif
@@ -0,0 +1,143 @@
+#include "bvec3a.h"
+
+/// Creates a 3-dimensional SIMD vector mask.
+inline_always
+const BVec3A bvec3a(bool x,bool y,bool z) {
+  return bvec3a_new(x,y,z);
+}
+
+/// Creates a new vector mask.
+inline_always
+const BVec3A bvec3a_new(bool x,bool y,bool z) {
+  const BVec3A mask={
+    .inner=_mm_castsi128_ps(_mm_set_epi32(0,-(i32)z,-(i32)y,-(i32)x))
+  };
+  return mask;
+}
+
+/// Creates a vector mask with all elements set to `v`.
+inline
+const BVec3A bvec3a_splat(bool v) {
+  return bvec3a_new(v,v,v);
+}
+
+/// Creates a new vector mask from a bool array.
+inline
+const BVec3A bvec3a_from_array(bool a[3]) {
+  return bvec3a_new(a[0],a[1],a[2]);
+}
+
+/// Wraps the result of a `_mm_cmp*_ps` comparison.
+inline_always
+const BVec3A bvec3a_from_m128(__m128 mask) {
+  const BVec3A vec={ .inner=mask };
+  return vec;
+}
+
+/// Creates a vector mask from the lowest 3 bits of `bitmask`, as returned by
+/// `bvec3a_bitmask` or `_mm_movemask_ps`. Bit 0 goes into `x`, bit 1 into `y`, etc.
+inline
+const BVec3A bvec3a_from_bitmask(u32 bitmask) {
+  const __m128i lane_bits=_mm_set_epi32(0,4,2,1);
+  const __m128i bits=_mm_and_si128(_mm_set1_epi32((i32)bitmask),lane_bits);
+  return bvec3a_from_m128(_mm_castsi128_ps(_mm_cmpeq_epi32(bits,lane_bits)));
+}
+
+/// Converts a `BVec3` into a SIMD vector mask.
+inline
+const BVec3A bvec3a_from_bvec3(BVec3 mask) {
+  return bvec3a_from_bitmask(bvec3_bitmask(mask));
+}
+
+/// Converts a SIMD vector mask into a `BVec3`.
+inline
+const BVec3 bvec3_from_bvec3a(BVec3A mask) {
+  return bvec3_from_bitmask(bvec3a_bitmask(mask));
+}
+
+/// Returns a bitmask with the lowest 3 bits set from the elements of `self`.
+///
+/// A true element results in a `1` bit and a false element in a `0` bit.  Element `x` goes
+/// into the first lowest bit, element `y` into the second, etc.
+inline_always
+const u32 bvec3a_bitmask(const BVec3A self) {
+  return (u32)_mm_movemask_ps(self.inner) & 0x7;
+}
+
+/// Returns true if any of the elements are true, false otherwise.
+inline_always
+const bool bvec3a_any(const BVec3A self) {
+  return bvec3a_bitmask(self)!=0;
+}
+
+/// Returns true if all the elements are true, false otherwise.
+inline_always
+const bool bvec3a_all(const BVec3A self) {
+  return bvec3a_bitmask(self)==0x7;
+}
+
+/// Tests the value at `index`.
+///
+/// Panics
+///
+/// Will panic if `index` is greater than 2 when `cmeth_assert` is enabled. Otherwise such
+/// an `index` tests `false`.
+inline
+const bool bvec3a_test(const BVec3A self,usize index) {
+  cmeth_assert(index<=2);
+  return index<=2 && ((bvec3a_bitmask(self)>>index) & 1);
+}
+
+/// Sets the element at `index`.
+///
+/// Panics
+///
+/// Will panic if `index` is greater than 2 when `cmeth_assert` is enabled. Otherwise such
+/// an `index` leaves `self` unchanged.
+inline
+void bvec3a_set(BVec3A* self,usize index,bool value) {
+  cmeth_assert(index<=2);
+  const u32 bit=index<=2? 1u<<index : 0;
+  *self=bvec3a_from_bitmask((bvec3a_bitmask(*self) & ~bit) | (value? bit : 0));
+}
+
+inline_always
+const BVec3A bvec3a_default() {
+  return BVEC3A_FALSE;
+}
+
+inline_always
+const BVec3A bvec3a_bitand(const BVec3A self,const BVec3A rhs) {
+  return bvec3a_from_m128(_mm_and_ps(self.inner,rhs.inner));
+}
+
+inline_always
+void bvec3a_bitand_assign(BVec3A* self,const BVec3A rhs) {
+  *self=bvec3a_bitand(*self,rhs);
+}
+
+inline_always
+const BVec3A bvec3a_bitor(const BVec3A self,const BVec3A rhs) {
+  return bvec3a_from_m128(_mm_or_ps(self.inner,rhs.inner));
+}
+
+inline_always
+void bvec3a_bitor_assign(BVec3A* self,const BVec3A rhs) {
+  *self=bvec3a_bitor(*self,rhs);
+}
+
+inline_always
+const BVec3A bvec3a_bitxor(const BVec3A self,const BVec3A rhs) {
+  return bvec3a_from_m128(_mm_xor_ps(self.inner,rhs.inner));
+}
+
+inline_always
+void bvec3a_bitxor_assign(BVec3A* self,const BVec3A rhs) {
+  *self=bvec3a_bitxor(*self,rhs);
+}
+
+inline_always
+const BVec3A bvec3a_bitnot(const BVec3A self) {
+  const __m128 ones=_mm_castsi128_ps(_mm_set1_epi32(-1));
+  return bvec3a_from_m128(_mm_xor_ps(self.inner,ones));
+}
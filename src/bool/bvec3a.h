@@ -0,0 +1,61 @@
+#ifndef CMETH_BVEC3A_PRELUDE_H
+#define CMETH_BVEC3A_PRELUDE_H
+#include <emmintrin.h>
+#include "../prelude.h"
+#include "bvec3.h"
+
+/// A 3-dimensional SIMD vector mask.
+///
+/// Every lane is either all ones or all zeros, as produced by `_mm_cmp*_ps`. The fourth lane
+/// is padding and its value is unspecified.
+typedef struct {
+  __m128 inner;
+} BVec3A;
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const BVec3A bvec3a(bool x,bool y,bool z);
+CMETH_API const BVec3A bvec3a_new(bool x,bool y,bool z);
+CMETH_API const BVec3A bvec3a_splat(bool v);
+CMETH_API const BVec3A bvec3a_from_array(bool a[3]);
+CMETH_API const BVec3A bvec3a_from_m128(__m128 mask);
+CMETH_API const BVec3A bvec3a_from_bitmask(u32 bitmask);
+CMETH_API const BVec3A bvec3a_from_bvec3(BVec3 mask);
+CMETH_API const BVec3 bvec3_from_bvec3a(BVec3A mask);
+CMETH_API const u32 bvec3a_bitmask(const BVec3A self);
+CMETH_API const bool bvec3a_any(const BVec3A self);
+CMETH_API const bool bvec3a_all(const BVec3A self);
+/// Tests the value at `index`.
+///
+/// Panics if `index` is greater than 2 when `cmeth_assert` is enabled. Otherwise such
+/// an `index` tests `false`.
+CMETH_API const bool bvec3a_test(const BVec3A self,usize index);
+/// Sets the element at `index`.
+///
+/// Panics if `index` is greater than 2 when `cmeth_assert` is enabled. Otherwise such
+/// an `index` leaves `self` unchanged.
+CMETH_API void bvec3a_set(BVec3A* self,usize index,bool value);
+CMETH_API const BVec3A bvec3a_default();
+CMETH_API const BVec3A bvec3a_bitand(const BVec3A self,const BVec3A rhs);
+CMETH_API void bvec3a_bitand_assign(BVec3A* self,const BVec3A rhs);
+CMETH_API const BVec3A bvec3a_bitor(const BVec3A self,const BVec3A rhs);
+CMETH_API void bvec3a_bitor_assign(BVec3A* self,const BVec3A rhs);
+CMETH_API const BVec3A bvec3a_bitxor(const BVec3A self,const BVec3A rhs);
+CMETH_API void bvec3a_bitxor_assign(BVec3A* self,const BVec3A rhs);
+CMETH_API const BVec3A bvec3a_bitnot(const BVec3A self);
+#ifdef _cplusplus
+}
+#endif
+
+
+#define BVEC3A_FALSE bvec3a_splat(false)
+#define BVEC3A_TRUE bvec3a_splat(true)
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "bvec3a.c"
+#endif
+
+#endif
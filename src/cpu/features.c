@@ -0,0 +1,109 @@
+#include <string.h>
+#include "features.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+// XCR0 bits: SSE and AVX state for YMM, plus opmask/ZMM_Hi256/Hi16_ZMM for AVX-512.
+#define XCR0_YMM 0x06
+#define XCR0_ZMM 0xe6
+
+static CpuTier _detected=-1;
+static CpuTier _selected=-1;
+
+
+static
+const CpuTier _cmeth_cpu_probe() {
+#if defined(__x86_64__) || defined(__i386__)
+  u32 eax,ebx,ecx,edx;
+  if(!__get_cpuid(1,&eax,&ebx,&ecx,&edx)) {
+    return CMETH_CPU_SCALAR;
+  }
+  const bool fma_f16c=(ecx & bit_FMA) && (ecx & bit_F16C);
+  if(!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+    return CMETH_CPU_SCALAR;
+  }
+
+  u32 xcr0_lo,xcr0_hi;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_lo),"=d"(xcr0_hi) : "c"(0));
+  if((xcr0_lo & XCR0_YMM)!=XCR0_YMM) {
+    return CMETH_CPU_SCALAR;
+  }
+
+  if(!__get_cpuid_count(7,0,&eax,&ebx,&ecx,&edx)) {
+    return CMETH_CPU_SCALAR;
+  }
+  if(!(ebx & bit_AVX2) || !fma_f16c) {
+    return CMETH_CPU_SCALAR;
+  }
+
+  const u32 avx512=bit_AVX512F | bit_AVX512VL | bit_AVX512DQ | bit_AVX512BW;
+  if((ebx & avx512)==avx512 && (xcr0_lo & XCR0_ZMM)==XCR0_ZMM) {
+    return CMETH_CPU_AVX512;
+  }
+  return CMETH_CPU_AVX2;
+#else
+  return CMETH_CPU_SCALAR;
+#endif
+}
+
+static
+const CpuTier _cmeth_cpu_tier_from_env(CpuTier detected) {
+  const char* value=getenv(CMETH_CPU_TIER_ENV);
+  if(value==NULL || *value=='\0') {
+    return detected;
+  }
+
+  CpuTier requested;
+  if(strcmp(value,"scalar")==0 || strcmp(value,"sse2")==0) {
+    requested=CMETH_CPU_SCALAR;
+  } else if(strcmp(value,"avx2")==0) {
+    requested=CMETH_CPU_AVX2;
+  } else if(strcmp(value,"avx512")==0) {
+    requested=CMETH_CPU_AVX512;
+  } else {
+    fprintf(stderr,"cmeth: ignoring unknown %s=%s\n",CMETH_CPU_TIER_ENV,value);
+    return detected;
+  }
+
+  if(requested>detected) {
+    fprintf(stderr,"cmeth: %s=%s is not supported by this cpu, using %s\n",
+      CMETH_CPU_TIER_ENV,value,cmeth_cpu_tier_name(detected));
+    return detected;
+  }
+  return requested;
+}
+
+
+/// Returns the highest tier the host CPU and OS support, ignoring `CMETH_CPU_TIER_ENV`.
+///
+/// The CPU is probed once, on first call.
+const CpuTier cmeth_cpu_detected_tier() {
+  if(_detected==(CpuTier)-1) {
+    _detected=_cmeth_cpu_probe();
+  }
+  return _detected;
+}
+
+/// Returns the tier the array kernels are bound to.
+///
+/// This is `cmeth_cpu_detected_tier()` capped by `CMETH_CPU_TIER_ENV`. Modules read it
+/// from load-time constructors, so the environment variable must be set before the
+/// process starts; changing it afterwards has no effect.
+const CpuTier cmeth_cpu_tier() {
+  if(_selected==(CpuTier)-1) {
+    _selected=_cmeth_cpu_tier_from_env(cmeth_cpu_detected_tier());
+  }
+  return _selected;
+}
+
+/// Returns the `CMETH_CPU_TIER_ENV` spelling of `tier`.
+const char* cmeth_cpu_tier_name(CpuTier tier) {
+  switch(tier) {
+    case CMETH_CPU_SCALAR: return "scalar";
+    case CMETH_CPU_AVX2: return "avx2";
+    case CMETH_CPU_AVX512: return "avx512";
+    default: return "unknown";
+  }
+}
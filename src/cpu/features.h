@@ -0,0 +1,39 @@
+#ifndef CMETH_CPU_FEATURES_H
+#define CMETH_CPU_FEATURES_H
+#include "../prelude.h"
+
+
+/// Instruction-set tiers the array kernels are built for, lowest first.
+///
+/// Every tier includes the ones below it, so a kernel table can be filled in by falling
+/// through from the selected tier down to `CMETH_CPU_SCALAR`.
+typedef enum {
+  /// Baseline x86-64 (SSE2) or any non-x86 target.
+  CMETH_CPU_SCALAR=0,
+  /// AVX2, FMA3 and F16C, with the OS saving YMM state.
+  CMETH_CPU_AVX2=1,
+  /// AVX-512 F/VL/DQ/BW on top of `CMETH_CPU_AVX2`, with the OS saving ZMM state.
+  CMETH_CPU_AVX512=2,
+} CpuTier;
+
+/// Name of the environment variable that caps the tier picked at load time.
+///
+/// Accepts `scalar` (or `sse2`), `avx2` and `avx512`. Asking for a tier the host does not
+/// support falls back to the detected one.
+#define CMETH_CPU_TIER_ENV "CMETH_CPU_TIER"
+
+/// Function attributes for kernels compiled for a tier above the build's baseline.
+#define target_avx2 __attribute__((target("avx2,fma,f16c")))
+#define target_avx512 __attribute__((target("avx2,fma,f16c,avx512f,avx512vl,avx512dq,avx512bw")))
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+const CpuTier cmeth_cpu_detected_tier();
+const CpuTier cmeth_cpu_tier();
+const char* cmeth_cpu_tier_name(CpuTier tier);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,145 @@
+#include "aabb.h"
+#include "math_impl.h"
+#include "prelude.h"
+
+
+/// Creates a box from its minimum and maximum corners.
+inline_always
+const Aabb aabb_new(Vec3 min,Vec3 max) {
+  const Aabb aabb={
+    .min=min,
+    .max=max
+  };
+  return aabb;
+}
+
+/// Creates the box containing only `point`.
+inline
+const Aabb aabb_from_point(Vec3 point) {
+  return aabb_new(point,point);
+}
+
+/// Creates the smallest box containing the first `n` elements of `points`, or
+/// `AABB_EMPTY` if `n` is zero.
+inline
+const Aabb aabb_from_points(const Vec3* points,usize n) {
+  Aabb aabb=AABB_EMPTY;
+  for(usize i=0;i<n;i++) {
+    aabb=aabb_expand(aabb,points[i]);
+  }
+  return aabb;
+}
+
+/// Creates a box from its centroid and half of its size.
+inline
+const Aabb aabb_from_center_half_size(Vec3 center,Vec3 half_size) {
+  return aabb_new(vec3_sub(center,half_size),vec3_add(center,half_size));
+}
+
+/// Returns `true` if `self` contains no point, which is when `min` is greater than `max`
+/// on any axis or any corner element is `NaN`.
+inline
+const bool aabb_is_empty(Aabb self) {
+  return !(self.min.x<=self.max.x && self.min.y<=self.max.y && self.min.z<=self.max.z);
+}
+
+/// Returns `true` if, and only if, both corners are finite.
+inline
+const bool aabb_is_finite(Aabb self) {
+  return vec3_is_finite(self.min) && vec3_is_finite(self.max);
+}
+
+/// Returns `true` if any corner element is `NaN`.
+inline
+const bool aabb_is_nan(Aabb self) {
+  return f32_is_nan(self.min.x) || f32_is_nan(self.min.y) || f32_is_nan(self.min.z)
+    || f32_is_nan(self.max.x) || f32_is_nan(self.max.y) || f32_is_nan(self.max.z);
+}
+
+/// Returns the smallest box containing both `self` and `rhs`.
+inline
+const Aabb aabb_union(Aabb self,Aabb rhs) {
+  return aabb_new(vec3_min(self.min,rhs.min),vec3_max(self.max,rhs.max));
+}
+
+/// Returns the box of the points contained in both `self` and `rhs`, which is empty if
+/// they do not overlap.
+inline
+const Aabb aabb_intersection(Aabb self,Aabb rhs) {
+  return aabb_new(vec3_max(self.min,rhs.min),vec3_min(self.max,rhs.max));
+}
+
+/// Returns the smallest box containing both `self` and `point`.
+inline
+const Aabb aabb_expand(Aabb self,Vec3 point) {
+  return aabb_new(vec3_min(self.min,point),vec3_max(self.max,point));
+}
+
+/// Moves every face of `self` outwards by `margin`, or inwards if it is negative.
+inline
+const Aabb aabb_grow(Aabb self,f32 margin) {
+  const Vec3 offset=vec3_splat(margin);
+  return aabb_new(vec3_sub(self.min,offset),vec3_add(self.max,offset));
+}
+
+/// Returns the extent of `self` along each axis, `max-min`.
+inline
+const Vec3 aabb_size(Aabb self) {
+  return vec3_sub(self.max,self.min);
+}
+
+/// Returns the center of `self`.
+inline
+const Vec3 aabb_centroid(Aabb self) {
+  return vec3_midpoint(self.min,self.max);
+}
+
+/// Returns the surface area of `self`, or zero if it is empty.
+inline
+const f32 aabb_surface_area(Aabb self) {
+  if(aabb_is_empty(self)) {
+    return 0.0F;
+  }
+  const Vec3 size=aabb_size(self);
+  return 2.0F*(size.x*size.y+size.y*size.z+size.z*size.x);
+}
+
+/// Returns the volume of `self`, or zero if it is empty.
+inline
+const f32 aabb_volume(Aabb self) {
+  if(aabb_is_empty(self)) {
+    return 0.0F;
+  }
+  const Vec3 size=aabb_size(self);
+  return size.x*size.y*size.z;
+}
+
+/// Returns `true` if `point` lies inside `self` or on its boundary.
+inline
+const bool aabb_contains_point(Aabb self,Vec3 point) {
+  return self.min.x<=point.x && point.x<=self.max.x
+    && self.min.y<=point.y && point.y<=self.max.y
+    && self.min.z<=point.z && point.z<=self.max.z;
+}
+
+/// Returns `true` if every point of `rhs` lies inside `self`. Empty boxes contain nothing
+/// and are contained by nothing.
+inline
+const bool aabb_contains_aabb(Aabb self,Aabb rhs) {
+  return !aabb_is_empty(rhs) && aabb_contains_point(self,rhs.min) && aabb_contains_point(self,rhs.max);
+}
+
+/// Returns `true` if `self` and `rhs` share at least one point, including when they only
+/// touch.
+inline
+const bool aabb_overlaps(Aabb self,Aabb rhs) {
+  return !aabb_is_empty(self) && !aabb_is_empty(rhs) && !aabb_is_empty(aabb_intersection(self,rhs));
+}
+
+/// Returns true if the absolute difference of all corner elements between `self` and `rhs`
+/// is less than or equal to `max_abs_diff`.
+inline
+const bool aabb_abs_diff_eq(Aabb self,Aabb rhs,f32 max_abs_diff) {
+  return vec3_abs_diff_eq(self.min,rhs.min,max_abs_diff)
+    && vec3_abs_diff_eq(self.max,rhs.max,max_abs_diff);
+}
@@ -0,0 +1,52 @@
+#ifndef CMETH_F32_AABB_H
+#define CMETH_F32_AABB_H
+#include "../prelude.h"
+#include "vec3.h"
+
+
+/// An axis-aligned bounding box, stored as its minimum and maximum corners.
+///
+/// A box whose `min` is greater than its `max` on any axis, or that has a `NaN` corner, is
+/// empty: it contains no point and no ray hits it. `AABB_EMPTY` is the identity of
+/// `aabb_union`.
+typedef struct {
+  Vec3 min;
+  Vec3 max;
+} Aabb;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const Aabb aabb_new(Vec3 min,Vec3 max);
+CMETH_API const Aabb aabb_from_point(Vec3 point);
+CMETH_API const Aabb aabb_from_points(const Vec3* points,usize n);
+CMETH_API const Aabb aabb_from_center_half_size(Vec3 center,Vec3 half_size);
+CMETH_API const bool aabb_is_empty(Aabb self);
+CMETH_API const bool aabb_is_finite(Aabb self);
+CMETH_API const bool aabb_is_nan(Aabb self);
+CMETH_API const Aabb aabb_union(Aabb self,Aabb rhs);
+CMETH_API const Aabb aabb_intersection(Aabb self,Aabb rhs);
+CMETH_API const Aabb aabb_expand(Aabb self,Vec3 point);
+CMETH_API const Aabb aabb_grow(Aabb self,f32 margin);
+CMETH_API const Vec3 aabb_size(Aabb self);
+CMETH_API const Vec3 aabb_centroid(Aabb self);
+CMETH_API const f32 aabb_surface_area(Aabb self);
+CMETH_API const f32 aabb_volume(Aabb self);
+CMETH_API const bool aabb_contains_point(Aabb self,Vec3 point);
+CMETH_API const bool aabb_contains_aabb(Aabb self,Aabb rhs);
+CMETH_API const bool aabb_overlaps(Aabb self,Aabb rhs);
+CMETH_API const bool aabb_abs_diff_eq(Aabb self,Aabb rhs,f32 max_abs_diff);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// The empty box, with `min` at positive and `max` at negative infinity.
+#define AABB_EMPTY aabb_new(VEC3_INFINITY,VEC3_NEG_INFINITY)
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "aabb.c"
+#endif
+
+#endif
@@ -0,0 +1,157 @@
+#include "affine3a.h"
+#include "math_impl.h"
+#include "prelude.h"
+
+
+/// Creates an affine transform from three column vectors and a translation.
+inline_always
+const Affine3A affine3a_from_cols(Vec3A x_axis,Vec3A y_axis,Vec3A z_axis,Vec3A w_axis) {
+  const Affine3A affine={
+    .matrix3=mat3_from_cols(x_axis,y_axis,z_axis),
+    .translation=w_axis
+  };
+  return affine;
+}
+
+/// Creates an affine transform from a 3x3 matrix (expressing scale, shear and rotation).
+inline
+const Affine3A affine3a_from_mat3(Mat3 mat3) {
+  return affine3a_from_mat3_translation(mat3,VEC3_ZERO);
+}
+
+/// Creates an affine transform from a 3x3 matrix (expressing scale, shear and rotation)
+/// and a translation vector.
+///
+/// Equivalent to `affine3a_mul_affine3a(affine3a_from_translation(translation),
+/// affine3a_from_mat3(mat3))`.
+inline_always
+const Affine3A affine3a_from_mat3_translation(Mat3 mat3,Vec3 translation) {
+  const Affine3A affine={
+    .matrix3=mat3,
+    .translation=vec3a_from_vec3(translation)
+  };
+  return affine;
+}
+
+/// Creates an affine transformation from the given 3D `translation`.
+inline
+const Affine3A affine3a_from_translation(Vec3 translation) {
+  return affine3a_from_mat3_translation(MAT3_IDENTITY,translation);
+}
+
+/// Creates an affine transform that changes scale.
+///
+/// Panics
+///
+/// Will panic if all elements of `scale` are zero when `cmeth_assert` is enabled.
+inline
+const Affine3A affine3a_from_scale(Vec3 scale) {
+  return affine3a_from_mat3(mat3_from_scale(scale));
+}
+
+/// The given `Mat4` must be an affine transform, i.e. contain no perspective transform.
+/// Its `w` row is dropped.
+inline
+const Affine3A affine3a_from_mat4(Mat4 m) {
+  return affine3a_from_cols(
+    vec3a_from_m128(m.x_axis),
+    vec3a_from_m128(m.y_axis),
+    vec3a_from_m128(m.z_axis),
+    vec3a_from_m128(m.w_axis)
+  );
+}
+
+/// Converts `self` into a `Mat4` with a `w` row of `(0, 0, 0, 1)`.
+inline
+const Mat4 affine3a_to_mat4(Affine3A self) {
+  return mat4_from_mat3_translation(self.matrix3,vec3_from_vec3a(self.translation));
+}
+
+/// Returns `true` if, and only if, all elements are finite.
+/// If any element is either `NaN`, positive or negative infinity, this will return `false`.
+inline
+const bool affine3a_is_finite(Affine3A self) {
+  return mat3_is_finite(self.matrix3)&&vec3a_is_finite(self.translation);
+}
+
+/// Returns `true` if any elements are `NaN`.
+inline
+const bool affine3a_is_nan(Affine3A self) {
+  return mat3_is_nan(self.matrix3)||vec3a_is_nan(self.translation);
+}
+
+/// Returns the determinant of the linear part of `self`.
+inline
+const f32 affine3a_determinant(Affine3A self) {
+  return mat3_determinant(self.matrix3);
+}
+
+/// Return the inverse of this transform.
+///
+/// Note that if the transform is not invertible the result will be invalid.
+///
+/// Panics
+///
+/// Will panic if the determinant of `self.matrix3` is zero when `cmeth_assert` is enabled.
+inline
+const Affine3A affine3a_inverse(Affine3A self) {
+  const Mat3 matrix3=mat3_inverse(self.matrix3);
+  const Vec3A translation=vec3a_neg(mat3_mul_vec3a(matrix3,self.translation));
+  const Affine3A affine={
+    .matrix3=matrix3,
+    .translation=translation
+  };
+  return affine;
+}
+
+/// Composes two transforms: the result applies `rhs` first, then `self`.
+inline
+const Affine3A affine3a_mul_affine3a(Affine3A self,Affine3A rhs) {
+  const Affine3A affine={
+    .matrix3=mat3_mul_mat3(self.matrix3,rhs.matrix3),
+    .translation=affine3a_transform_point3a(self,rhs.translation)
+  };
+  return affine;
+}
+
+/// Transforms the given 3D point, applying shear, scale, rotation and translation.
+inline
+const Vec3 affine3a_transform_point3(Affine3A self,Vec3 rhs) {
+  return vec3_from_vec3a(affine3a_transform_point3a(self,vec3a_from_vec3(rhs)));
+}
+
+/// Transforms the given 3D vector, applying shear, scale and rotation (but NOT
+/// translation).
+///
+/// To also apply translation, use `affine3a_transform_point3` instead.
+inline
+const Vec3 affine3a_transform_vector3(Affine3A self,Vec3 rhs) {
+  return vec3_from_vec3a(affine3a_transform_vector3a(self,vec3a_from_vec3(rhs)));
+}
+
+/// Transforms the given `Vec3A` point, applying shear, scale, rotation and translation.
+inline_always
+const Vec3A affine3a_transform_point3a(Affine3A self,Vec3A rhs) {
+  return vec3a_add(mat3_mul_vec3a(self.matrix3,rhs),self.translation);
+}
+
+/// Transforms the given `Vec3A` vector, applying shear, scale and rotation (but NOT
+/// translation).
+///
+/// To also apply translation, use `affine3a_transform_point3a` instead.
+inline_always
+const Vec3A affine3a_transform_vector3a(Affine3A self,Vec3A rhs) {
+  return mat3_mul_vec3a(self.matrix3,rhs);
+}
+
+/// Returns true if the absolute difference of all elements between `self` and `rhs`
+/// is less than or equal to `max_abs_diff`.
+///
+/// This can be used to compare if two transforms contain similar elements. It works best
+/// when comparing with a known value. The `max_abs_diff` that should be used used depends
+/// on the values being compared against.
+inline
+const bool affine3a_abs_diff_eq(Affine3A self,Affine3A rhs,f32 max_abs_diff) {
+  return mat3_abs_diff_eq(self.matrix3,rhs.matrix3,max_abs_diff)
+    &&vec3a_abs_diff_eq(self.translation,rhs.translation,max_abs_diff);
+}
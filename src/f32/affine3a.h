@@ -0,0 +1,61 @@
+#ifndef CMETH_F32_AFFINE3A_H
+#define CMETH_F32_AFFINE3A_H
+#include <emmintrin.h>
+#include "../prelude.h"
+#include "vec3.h"
+#include "vec3a.h"
+#include "mat3.h"
+#include "mat4.h"
+
+
+/// A 3D affine transform, which can represent translation, rotation, scaling and shear.
+///
+/// Stored as a column-major `Mat3` and a translation, so transforming a point is three
+/// broadcast-multiply-adds plus an add and no `w` row is ever touched.
+typedef struct {
+  Mat3 matrix3;
+  Vec3A translation;
+} Affine3A;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const Affine3A affine3a_from_cols(Vec3A x_axis,Vec3A y_axis,Vec3A z_axis,Vec3A w_axis);
+CMETH_API const Affine3A affine3a_from_mat3(Mat3 mat3);
+CMETH_API const Affine3A affine3a_from_mat3_translation(Mat3 mat3,Vec3 translation);
+CMETH_API const Affine3A affine3a_from_translation(Vec3 translation);
+CMETH_API const Affine3A affine3a_from_scale(Vec3 scale);
+CMETH_API const Affine3A affine3a_from_mat4(Mat4 m);
+CMETH_API const Mat4 affine3a_to_mat4(Affine3A self);
+CMETH_API const bool affine3a_is_finite(Affine3A self);
+CMETH_API const bool affine3a_is_nan(Affine3A self);
+CMETH_API const f32 affine3a_determinant(Affine3A self);
+CMETH_API const Affine3A affine3a_inverse(Affine3A self);
+CMETH_API const Affine3A affine3a_mul_affine3a(Affine3A self,Affine3A rhs);
+CMETH_API const Vec3 affine3a_transform_point3(Affine3A self,Vec3 rhs);
+CMETH_API const Vec3 affine3a_transform_vector3(Affine3A self,Vec3 rhs);
+CMETH_API const Vec3A affine3a_transform_point3a(Affine3A self,Vec3A rhs);
+CMETH_API const Vec3A affine3a_transform_vector3a(Affine3A self,Vec3A rhs);
+CMETH_API const bool affine3a_abs_diff_eq(Affine3A self,Affine3A rhs,f32 max_abs_diff);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// The degenerate zero transform.
+///
+/// This transforms any finite vector and point to zero. The zero transform is
+/// non-invertible.
+#define AFFINE3A_ZERO affine3a_from_mat3_translation(MAT3_ZERO,VEC3_ZERO)
+
+/// The identity transform.
+///
+/// Multiplying a vector with this returns the same vector.
+#define AFFINE3A_IDENTITY affine3a_from_mat3_translation(MAT3_IDENTITY,VEC3_ZERO)
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "affine3a.c"
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+// The scalar bodies inline the value-type API instead of calling back into the archive.
+#define CMETH_HEADER_ONLY
+#include <immintrin.h>
+#include "affine3a_batch.h"
+#include "vec3_aos.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// Every kernel has a scalar body that runs `affine3a_transform_point3a` on one point at a
+// time, an 8-point AVX2+FMA body and a 16-point AVX-512 body, bound once at load time from
+// `cmeth_cpu_tier()`, like the `vec3_soa_*` kernels.
+//
+// The SIMD bodies transpose 8 (16) points into `x`, `y` and `z` registers with the
+// `vec3_aos.h` helpers and do the 9 multiply-adds per point on whole registers.
+//
+// Because the SIMD bodies contract `a*b+c` into FMA, each element can differ from
+// `affine3a_transform_point3` by up to `2^-23 * (|m0*x| + |m1*y| + |m2*z| + |t|)`.
+
+
+/// Broadcast elements of the transform, one register per matrix entry.
+#define _SPLAT_AFFINE(set1,self) \
+  const __typeof__(set1(0.0F)) \
+    m00=set1((self)->matrix3.x_axis.inner[0]),m10=set1((self)->matrix3.x_axis.inner[1]), \
+    m20=set1((self)->matrix3.x_axis.inner[2]),m01=set1((self)->matrix3.y_axis.inner[0]), \
+    m11=set1((self)->matrix3.y_axis.inner[1]),m21=set1((self)->matrix3.y_axis.inner[2]), \
+    m02=set1((self)->matrix3.z_axis.inner[0]),m12=set1((self)->matrix3.z_axis.inner[1]), \
+    m22=set1((self)->matrix3.z_axis.inner[2]),t0=set1((self)->translation.inner[0]), \
+    t1=set1((self)->translation.inner[1]),t2=set1((self)->translation.inner[2])
+
+
+static inline_always
+void _affine3a_transform_scalar(const Affine3A* self,const Vec3* in,Vec3* out,usize n,const bool translate) {
+  for(usize i=0;i<n;++i) {
+    const Vec3A v=vec3a_from_vec3(in[i]);
+    out[i]=vec3_from_vec3a(translate?
+      affine3a_transform_point3a(*self,v):
+      affine3a_transform_vector3a(*self,v));
+  }
+}
+
+static
+void _affine3a_transform_points_scalar(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _affine3a_transform_scalar(self,in,out,n,true);
+}
+
+static
+void _affine3a_transform_vectors_scalar(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _affine3a_transform_scalar(self,in,out,n,false);
+}
+
+
+static inline_always target_avx2
+void _affine3a_transform_avx2(const Affine3A* self,const Vec3* in,Vec3* out,usize n,const bool translate) {
+  _SPLAT_AFFINE(_mm256_set1_ps,self);
+  const f32* src=(const f32*)in;
+  f32* dst=(f32*)out;
+  for(usize i=0;i<n;i+=8) {
+    const usize rem=(n-i)*3;
+    const usize off=i*3;
+    __m256 x,y,z;
+    _vec3_aos_gather8(src+off,rem,&x,&y,&z);
+
+    __m256 ox=_mm256_fmadd_ps(m02,z,_mm256_fmadd_ps(m01,y,_mm256_mul_ps(m00,x)));
+    __m256 oy=_mm256_fmadd_ps(m12,z,_mm256_fmadd_ps(m11,y,_mm256_mul_ps(m10,x)));
+    __m256 oz=_mm256_fmadd_ps(m22,z,_mm256_fmadd_ps(m21,y,_mm256_mul_ps(m20,x)));
+    if(translate) {
+      ox=_mm256_add_ps(ox,t0);
+      oy=_mm256_add_ps(oy,t1);
+      oz=_mm256_add_ps(oz,t2);
+    }
+
+    _vec3_aos_scatter8(dst+off,rem,ox,oy,oz);
+  }
+}
+
+static target_avx2
+void _affine3a_transform_points_avx2(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _affine3a_transform_avx2(self,in,out,n,true);
+}
+
+static target_avx2
+void _affine3a_transform_vectors_avx2(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _affine3a_transform_avx2(self,in,out,n,false);
+}
+
+
+static inline_always target_avx512
+void _affine3a_transform_avx512(const Affine3A* self,const Vec3* in,Vec3* out,usize n,const bool translate) {
+  _SPLAT_AFFINE(_mm512_set1_ps,self);
+  const f32* src=(const f32*)in;
+  f32* dst=(f32*)out;
+  for(usize i=0;i<n;i+=16) {
+    const usize rem=(n-i)*3;
+    const usize off=i*3;
+    __m512 x,y,z;
+    _vec3_aos_gather16(src+off,rem,&x,&y,&z);
+
+    __m512 ox=_mm512_fmadd_ps(m02,z,_mm512_fmadd_ps(m01,y,_mm512_mul_ps(m00,x)));
+    __m512 oy=_mm512_fmadd_ps(m12,z,_mm512_fmadd_ps(m11,y,_mm512_mul_ps(m10,x)));
+    __m512 oz=_mm512_fmadd_ps(m22,z,_mm512_fmadd_ps(m21,y,_mm512_mul_ps(m20,x)));
+    if(translate) {
+      ox=_mm512_add_ps(ox,t0);
+      oy=_mm512_add_ps(oy,t1);
+      oz=_mm512_add_ps(oz,t2);
+    }
+
+    _vec3_aos_scatter16(dst+off,rem,ox,oy,oz);
+  }
+}
+
+static target_avx512
+void _affine3a_transform_points_avx512(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _affine3a_transform_avx512(self,in,out,n,true);
+}
+
+static target_avx512
+void _affine3a_transform_vectors_avx512(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _affine3a_transform_avx512(self,in,out,n,false);
+}
+
+#undef _SPLAT_AFFINE
+
+
+static struct {
+  void (*transform_points)(const Affine3A*,const Vec3*,Vec3*,usize);
+  void (*transform_vectors)(const Affine3A*,const Vec3*,Vec3*,usize);
+} _kernels={
+  .transform_points=_affine3a_transform_points_scalar,
+  .transform_vectors=_affine3a_transform_vectors_scalar,
+};
+
+__attribute__((constructor))
+static void _affine3a_batch_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.transform_points=_affine3a_transform_points_avx512;
+      _kernels.transform_vectors=_affine3a_transform_vectors_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.transform_points=_affine3a_transform_points_avx2;
+      _kernels.transform_vectors=_affine3a_transform_vectors_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Computes `out[i]=affine3a_transform_point3(*self,in[i])` for every `i<n`.
+///
+/// `out` may be the same array as `in`, but the two must not otherwise overlap.
+void affine3a_transform_points(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _kernels.transform_points(self,in,out,n);
+}
+
+/// Computes `out[i]=affine3a_transform_vector3(*self,in[i])` for every `i<n`.
+///
+/// `out` may be the same array as `in`, but the two must not otherwise overlap.
+void affine3a_transform_vectors(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _kernels.transform_vectors(self,in,out,n);
+}
+
+
+typedef struct {
+  void (*transform)(const Affine3A*,const Vec3*,Vec3*,usize);
+  const Affine3A* self;
+  const Vec3* in;
+  Vec3* out;
+} _Affine3aBatchJob;
+
+static void _affine3a_transform_range(void* ctx,usize begin,usize end) {
+  const _Affine3aBatchJob* job=ctx;
+  job->transform(job->self,job->in+begin,job->out+begin,end-begin);
+}
+
+/// Works like `affine3a_transform_points`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void affine3a_transform_points_parallel(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _Affine3aBatchJob job={_kernels.transform_points,self,in,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_affine3a_transform_range,&job);
+}
+
+/// Works like `affine3a_transform_vectors`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void affine3a_transform_vectors_parallel(const Affine3A* self,const Vec3* in,Vec3* out,usize n) {
+  _Affine3aBatchJob job={_kernels.transform_vectors,self,in,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_affine3a_transform_range,&job);
+}
@@ -0,0 +1,19 @@
+#ifndef CMETH_F32_AFFINE3A_BATCH_H
+#define CMETH_F32_AFFINE3A_BATCH_H
+#include "../prelude.h"
+#include "vec3.h"
+#include "affine3a.h"
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+void affine3a_transform_points(const Affine3A* self,const Vec3* in,Vec3* out,usize n);
+void affine3a_transform_vectors(const Affine3A* self,const Vec3* in,Vec3* out,usize n);
+void affine3a_transform_points_parallel(const Affine3A* self,const Vec3* in,Vec3* out,usize n);
+void affine3a_transform_vectors_parallel(const Affine3A* self,const Vec3* in,Vec3* out,usize n);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,854 @@
+// The build and the traversals inline the value-type API instead of calling back into the
+// archive.
+#define CMETH_HEADER_ONLY
+#include <immintrin.h>
+#include <pthread.h>
+#include "bvh.h"
+#include "math_impl.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// `bvh_build` is a top-down binned SAH build (Wald, "On fast Construction of SAH-based
+// Bounding Volume Hierarchies", 2007). Every node bins the centroids of its triangles into
+// `bins` slots along each axis, evaluates the surface area heuristic at the `bins-1` planes
+// between them and partitions its range of `Bvh.triangles` in place at the cheapest one.
+//
+// The build runs on up to `threads` threads, counted by a shared budget so nested work
+// never oversubscribes the machine:
+//
+// - Nodes of at least `BVH_PARALLEL_MIN` triangles hand one child to a new thread when the
+//   budget allows, and keep building the other.
+// - Near the root, where there are too few nodes to go around, nodes of at least
+//   `BVH_PARALLEL_BIN_MIN` triangles split their binning across threads instead.
+//
+// Bins are merged with exact operations (`MIN`/`MAX` and integer counts) and every node
+// partitions its own range, so the tree is the same for any number of threads.
+//
+// The binary tree is first built with child indices, then flattened depth-first into
+// `BvhNode`s or collapsed into `BvhNode8`s by repeatedly opening the child with the largest
+// surface area, as in Embree's wide BVHs.
+//
+// Both traversals keep a stack of nodes still to visit with their entry distances, visit
+// the nearest child first and skip entries behind the closest hit so far. The 8-wide one
+// tests all children of a node with one lane-generic slab test from `bvh_lanes.h`, compiled
+// for SSE2 (two 4-lane halves) and AVX2.
+
+
+/// Cost of traversing a node, relative to intersecting one triangle.
+static const f32 BVH_TRAVERSAL_COST=1.0F;
+
+/// Nodes with fewer triangles are built entirely by the thread that reaches them.
+static const u32 BVH_PARALLEL_MIN=4096;
+
+/// Nodes with fewer triangles bin them on one thread.
+static const u32 BVH_PARALLEL_BIN_MIN=65536;
+
+#define BVH_MAX_BINS 32
+#define BVH_MAX_CHUNKS 16
+#define BVH_MAX_SPAWNS 64
+#define BVH_NONE ((u32)-1)
+
+
+typedef struct {
+  Aabb bounds;
+  u32 left;
+  u32 right;
+  u32 first;
+  /// Zero for interior nodes.
+  u32 count;
+} _BvhBuildNode;
+
+/// A triangle being built. Kept in partition order rather than indexed, so binning and
+/// partitioning stream through memory.
+typedef struct {
+  Aabb bounds;
+  Vec3 centroid;
+  u32 triangle;
+} _BvhPrim;
+
+typedef struct {
+  Aabb bounds;
+  u32 count;
+} _BvhBin;
+
+typedef struct {
+  _BvhBin bin[3][BVH_MAX_BINS];
+} _BvhBins;
+
+typedef struct {
+  const Vec3* vertices;
+  const u32* indices;
+  _BvhPrim* prims;
+  _BvhBuildNode* nodes;
+  u32 node_count;
+  i32 spare_threads;
+  u32 depth;
+  u32 max_leaf_size;
+  u32 bins;
+} _BvhBuilder;
+
+/// A range of `prims` to build into `nodes[node]`.
+typedef struct {
+  _BvhBuilder* builder;
+  u32 node;
+  u32 begin;
+  u32 end;
+  u32 depth;
+  Aabb bounds;
+  Aabb centroids;
+} _BvhTask;
+
+/// Maps a centroid to its bin on each axis: `(c-origin)*scale`, with `scale` zero on axes
+/// where all centroids are equal.
+typedef struct {
+  Vec3 origin;
+  Vec3 scale;
+  /// At most `BvhOptions.bins`, fewer for nodes with fewer triangles.
+  u32 bins;
+} _BvhBinMap;
+
+
+static inline_always
+const f32 _bvh_axis(Vec3 v,usize axis) {
+  return *vec3_index(&v,axis);
+}
+
+static inline_always
+bool _bvh_take_thread(_BvhBuilder* b) {
+  i32 spare=__atomic_load_n(&b->spare_threads,__ATOMIC_RELAXED);
+  while(spare>0) {
+    if(__atomic_compare_exchange_n(&b->spare_threads,&spare,spare-1,true,__ATOMIC_ACQUIRE,__ATOMIC_RELAXED)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline_always
+void _bvh_give_thread(_BvhBuilder* b) {
+  __atomic_fetch_add(&b->spare_threads,1,__ATOMIC_RELEASE);
+}
+
+
+typedef void (*_BvhChunkFn)(_BvhBuilder* b,void* ctx,usize chunk,usize begin,usize end);
+
+typedef struct {
+  _BvhBuilder* builder;
+  _BvhChunkFn fn;
+  void* ctx;
+  usize chunk;
+  usize begin;
+  usize end;
+} _BvhChunk;
+
+static void* _bvh_chunk_main(void* arg) {
+  const _BvhChunk* c=arg;
+  c->fn(c->builder,c->ctx,c->chunk,c->begin,c->end);
+  _bvh_give_thread(c->builder);
+  return NULL;
+}
+
+/// Runs `fn` over `[0,n)` split into one chunk per thread the budget allows, up to
+/// `max_chunks`, and returns how many chunks it used.
+static usize _bvh_for_chunks(_BvhBuilder* b,usize n,usize max_chunks,_BvhChunkFn fn,void* ctx) {
+  usize chunks=1;
+  while(chunks<max_chunks && _bvh_take_thread(b)) {
+    chunks++;
+  }
+  _BvhChunk tasks[BVH_MAX_CHUNKS];
+  pthread_t threads[BVH_MAX_CHUNKS];
+  bool spawned[BVH_MAX_CHUNKS]={false};
+  for(usize k=1;k<chunks;k++) {
+    tasks[k]=(_BvhChunk){b,fn,ctx,k,n*k/chunks,n*(k+1)/chunks};
+    spawned[k]=pthread_create(&threads[k],NULL,_bvh_chunk_main,&tasks[k])==0;
+    if(!spawned[k]) {
+      _bvh_chunk_main(&tasks[k]);
+    }
+  }
+  fn(b,ctx,0,0,n/chunks);
+  for(usize k=1;k<chunks;k++) {
+    if(spawned[k]) {
+      pthread_join(threads[k],NULL);
+    }
+  }
+  return chunks;
+}
+
+
+static void _bvh_prim_bounds(_BvhBuilder* b,void* ctx,usize chunk,usize begin,usize end) {
+  (void)ctx;
+  (void)chunk;
+  for(usize i=begin;i<end;i++) {
+    const u32* index=b->indices+3*i;
+    const Vec3 v0=b->vertices[index[0]];
+    const Vec3 v1=b->vertices[index[1]];
+    const Vec3 v2=b->vertices[index[2]];
+    const Aabb bounds=aabb_new(vec3_min(v0,vec3_min(v1,v2)),vec3_max(v0,vec3_max(v1,v2)));
+    b->prims[i]=(_BvhPrim){bounds,aabb_centroid(bounds),(u32)i};
+  }
+}
+
+
+/// Returns the bin of `centroid` on each axis.
+static inline_always
+void _bvh_bin_index(const _BvhBinMap* map,Vec3 centroid,u32 k[3]) {
+  const Vec3 scaled=vec3_mul(vec3_sub(centroid,map->origin),map->scale);
+  k[0]=(u32)scaled.x;
+  k[1]=(u32)scaled.y;
+  k[2]=(u32)scaled.z;
+  for(usize axis=0;axis<3;axis++) {
+    k[axis]=k[axis]<map->bins? k[axis] : map->bins-1;
+  }
+}
+
+typedef struct {
+  const _BvhBinMap* map;
+  u32 begin;
+  _BvhBins* parts;
+} _BvhBinJob;
+
+static void _bvh_bin_chunk(_BvhBuilder* b,void* ctx,usize chunk,usize begin,usize end) {
+  const _BvhBinJob* job=ctx;
+  _BvhBins* out=job->parts+chunk;
+  for(usize axis=0;axis<3;axis++) {
+    for(u32 k=0;k<job->map->bins;k++) {
+      out->bin[axis][k]=(_BvhBin){AABB_EMPTY,0};
+    }
+  }
+  for(usize i=job->begin+begin;i<job->begin+end;i++) {
+    const _BvhPrim* prim=b->prims+i;
+    u32 k[3];
+    _bvh_bin_index(job->map,prim->centroid,k);
+    for(usize axis=0;axis<3;axis++) {
+      _BvhBin* bin=&out->bin[axis][k[axis]];
+      bin->bounds=aabb_union(bin->bounds,prim->bounds);
+      bin->count++;
+    }
+  }
+}
+
+/// Bins `prims[begin..end]` into `out`.
+static void _bvh_bin(_BvhBuilder* b,const _BvhBinMap* map,u32 begin,u32 end,_BvhBins* out) {
+  if(end-begin<BVH_PARALLEL_BIN_MIN) {
+    const _BvhBinJob job={map,begin,out};
+    _bvh_bin_chunk(b,(void*)&job,0,0,end-begin);
+    return;
+  }
+  _BvhBins* parts=malloc(BVH_MAX_CHUNKS*sizeof(_BvhBins));
+  if(parts==NULL) {
+    panic("bvh_build: out of memory\n");
+  }
+  const _BvhBinJob job={map,begin,parts};
+  const usize chunks=_bvh_for_chunks(b,end-begin,BVH_MAX_CHUNKS,_bvh_bin_chunk,(void*)&job);
+  *out=parts[0];
+  for(usize c=1;c<chunks;c++) {
+    for(usize axis=0;axis<3;axis++) {
+      for(u32 k=0;k<map->bins;k++) {
+        _BvhBin* bin=&out->bin[axis][k];
+        const _BvhBin* part=&parts[c].bin[axis][k];
+        bin->bounds=aabb_union(bin->bounds,part->bounds);
+        bin->count+=part->count;
+      }
+    }
+  }
+  free(parts);
+}
+
+
+typedef struct {
+  usize axis;
+  /// Bins below `split` go to the first child.
+  u32 split;
+  f32 cost;
+} _BvhSplit;
+
+/// Finds the cheapest plane between bins, with cost `A_L*N_L+A_R*N_R`.
+static const _BvhSplit _bvh_best_split(const _BvhBinMap* map,const _BvhBins* bins) {
+  _BvhSplit best={0,0,F32_INFINITY};
+  for(usize axis=0;axis<3;axis++) {
+    if(_bvh_axis(map->scale,axis)==0.0F) {
+      continue;
+    }
+    const _BvhBin* bin=bins->bin[axis];
+    f32 right_cost[BVH_MAX_BINS];
+    Aabb right=AABB_EMPTY;
+    u32 right_count=0;
+    for(u32 k=map->bins-1;k>0;k--) {
+      right=aabb_union(right,bin[k].bounds);
+      right_count+=bin[k].count;
+      right_cost[k]=right_count==0? F32_INFINITY : aabb_surface_area(right)*(f32)right_count;
+    }
+    Aabb left=AABB_EMPTY;
+    u32 left_count=0;
+    for(u32 k=1;k<map->bins;k++) {
+      left=aabb_union(left,bin[k-1].bounds);
+      left_count+=bin[k-1].count;
+      const f32 cost=left_count==0? F32_INFINITY : aabb_surface_area(left)*(f32)left_count+right_cost[k];
+      if(cost<best.cost) {
+        best=(_BvhSplit){axis,k,cost};
+      }
+    }
+  }
+  return best;
+}
+
+
+static void _bvh_build_node(_BvhTask task);
+
+static void* _bvh_build_main(void* arg) {
+  const _BvhTask* task=arg;
+  _bvh_build_node(*task);
+  _bvh_give_thread(task->builder);
+  return NULL;
+}
+
+/// Splits `task` at its cheapest SAH plane, or at the median when all centroids coincide.
+/// Returns `false` if it should become a leaf instead.
+static bool _bvh_split(_BvhTask task,_BvhTask* left,_BvhTask* right) {
+  _BvhBuilder* b=task.builder;
+  const u32 count=task.end-task.begin;
+  if(count<=1) {
+    return false;
+  }
+  const Vec3 extent=aabb_size(task.centroids);
+  // Small nodes use one bin per triangle at most, which keeps their binning and sweep
+  // proportional to their size.
+  const u32 bin_count=count<b->bins? count : b->bins;
+  const f32 bins_per_extent=(f32)bin_count*(1.0F-1e-6F);
+  _BvhBinMap map={
+    .origin=task.centroids.min,
+    .scale=vec3_new(
+      extent.x>0.0F? bins_per_extent/extent.x : 0.0F,
+      extent.y>0.0F? bins_per_extent/extent.y : 0.0F,
+      extent.z>0.0F? bins_per_extent/extent.z : 0.0F),
+    .bins=bin_count
+  };
+  *left=(_BvhTask){b,BVH_NONE,task.begin,task.end,task.depth+1,AABB_EMPTY,AABB_EMPTY};
+  *right=*left;
+
+  _BvhBins bins;
+  _BvhSplit split={0,0,F32_INFINITY};
+  if(!bvec3_all(vec3_cmpeq(map.scale,VEC3_ZERO))) {
+    _bvh_bin(b,&map,task.begin,task.end,&bins);
+    split=_bvh_best_split(&map,&bins);
+  }
+  if(split.cost==F32_INFINITY) {
+    if(count<=b->max_leaf_size) {
+      return false;
+    }
+    // Nothing tells the triangles apart spatially, so halve the range as it is.
+    left->end=right->begin=task.begin+count/2;
+    for(u32 i=task.begin;i<task.end;i++) {
+      _BvhTask* side=i<left->end? left : right;
+      side->bounds=aabb_union(side->bounds,b->prims[i].bounds);
+      side->centroids=aabb_expand(side->centroids,b->prims[i].centroid);
+    }
+    return true;
+  }
+  const f32 area=aabb_surface_area(task.bounds);
+  if(count<=b->max_leaf_size && (f32)count<=BVH_TRAVERSAL_COST+split.cost/area) {
+    return false;
+  }
+
+  // The partition also gathers the centroid bounds of both sides, which the bins don't
+  // keep.
+  u32 i=task.begin;
+  u32 j=task.end;
+  while(i<j) {
+    const _BvhPrim prim=b->prims[i];
+    u32 k[3];
+    _bvh_bin_index(&map,prim.centroid,k);
+    if(k[split.axis]<split.split) {
+      left->centroids=aabb_expand(left->centroids,prim.centroid);
+      i++;
+    } else {
+      right->centroids=aabb_expand(right->centroids,prim.centroid);
+      b->prims[i]=b->prims[--j];
+      b->prims[j]=prim;
+    }
+  }
+  left->end=right->begin=i;
+  for(u32 k=0;k<bin_count;k++) {
+    _BvhTask* side=k<split.split? left : right;
+    side->bounds=aabb_union(side->bounds,bins.bin[split.axis][k].bounds);
+  }
+  return true;
+}
+
+/// Builds the subtree of `task`, recursing into the smaller child and looping on the
+/// larger one so the stack stays logarithmic, or handing the smaller one to a new thread.
+static void _bvh_build_node(_BvhTask task) {
+  _BvhBuilder* b=task.builder;
+  _BvhTask spawned_tasks[BVH_MAX_SPAWNS];
+  pthread_t spawned[BVH_MAX_SPAWNS];
+  usize spawned_count=0;
+  for(;;) {
+    u32 depth=__atomic_load_n(&b->depth,__ATOMIC_RELAXED);
+    while(task.depth>depth
+      && !__atomic_compare_exchange_n(&b->depth,&depth,task.depth,true,__ATOMIC_RELAXED,__ATOMIC_RELAXED)) {
+    }
+    _BvhBuildNode* node=b->nodes+task.node;
+    node->bounds=task.bounds;
+    _BvhTask left,right;
+    if(!_bvh_split(task,&left,&right)) {
+      node->left=BVH_NONE;
+      node->right=BVH_NONE;
+      node->first=task.begin;
+      node->count=task.end-task.begin;
+      break;
+    }
+    left.node=__atomic_fetch_add(&b->node_count,2,__ATOMIC_RELAXED);
+    right.node=left.node+1;
+    node->left=left.node;
+    node->right=right.node;
+    node->first=0;
+    node->count=0;
+
+    const bool left_smaller=left.end-left.begin<right.end-right.begin;
+    const _BvhTask smaller=left_smaller? left : right;
+    task=left_smaller? right : left;
+    if(smaller.end-smaller.begin>=BVH_PARALLEL_MIN && spawned_count<BVH_MAX_SPAWNS && _bvh_take_thread(b)) {
+      spawned_tasks[spawned_count]=smaller;
+      if(pthread_create(&spawned[spawned_count],NULL,_bvh_build_main,&spawned_tasks[spawned_count])==0) {
+        spawned_count++;
+        continue;
+      }
+      _bvh_give_thread(b);
+    }
+    _bvh_build_node(smaller);
+  }
+  if(spawned_count>0) {
+    // This thread only waits from here on, so its share of the budget goes to others.
+    _bvh_give_thread(b);
+    for(usize k=0;k<spawned_count;k++) {
+      pthread_join(spawned[k],NULL);
+    }
+    __atomic_fetch_sub(&b->spare_threads,1,__ATOMIC_RELAXED);
+  }
+}
+
+
+static void* _bvh_alloc(usize size) {
+  void* ptr=aligned_alloc(64,(size+63)/64*64);
+  if(ptr==NULL) {
+    panic("bvh_build: out of memory\n");
+  }
+  return ptr;
+}
+
+/// Writes the subtree at `src[0]` to `dst` depth-first and returns the number of nodes.
+static usize _bvh_flatten2(const _BvhBuildNode* src,BvhNode* dst,u32* stack,u32* patch) {
+  usize count=0;
+  usize sp=0;
+  stack[sp]=0;
+  patch[sp++]=BVH_NONE;
+  while(sp>0) {
+    sp--;
+    const _BvhBuildNode* node=src+stack[sp];
+    const u32 out=(u32)count++;
+    if(patch[sp]!=BVH_NONE) {
+      dst[patch[sp]].offset=out;
+    }
+    dst[out].bounds=node->bounds;
+    dst[out].count=node->count;
+    dst[out].offset=node->first;
+    if(node->count==0) {
+      // The first child is pushed last, so it is written right after its parent.
+      stack[sp]=node->right;
+      patch[sp++]=out;
+      stack[sp]=node->left;
+      patch[sp++]=BVH_NONE;
+    }
+  }
+  return count;
+}
+
+/// Collapses the binary tree at `src[0]` into `dst`, returns the number of nodes and
+/// stores the depth of the wide tree in `depth`.
+static usize _bvh_collapse8(const _BvhBuildNode* src,BvhNode8* dst,u32* stack,u32* stack_dst,u32* stack_depth,usize* depth) {
+  usize count=1;
+  usize sp=0;
+  stack[sp]=0;
+  stack_dst[sp]=0;
+  stack_depth[sp++]=1;
+  *depth=1;
+  while(sp>0) {
+    sp--;
+    const u32 level=stack_depth[sp];
+    BvhNode8* out=dst+stack_dst[sp];
+    u32 slots[8];
+    usize n=0;
+    const _BvhBuildNode* root=src+stack[sp];
+    if(root->count>0) {
+      slots[n++]=stack[sp];
+    } else {
+      slots[n++]=root->left;
+      slots[n++]=root->right;
+    }
+    // Open the interior child with the largest surface area until all eight slots are used.
+    while(n<8) {
+      usize widest=8;
+      f32 widest_area=-1.0F;
+      for(usize k=0;k<n;k++) {
+        const _BvhBuildNode* child=src+slots[k];
+        const f32 area=aabb_surface_area(child->bounds);
+        if(child->count==0 && area>widest_area) {
+          widest=k;
+          widest_area=area;
+        }
+      }
+      if(widest==8) {
+        break;
+      }
+      const _BvhBuildNode* opened=src+slots[widest];
+      slots[widest]=opened->left;
+      slots[n++]=opened->right;
+    }
+    for(usize k=0;k<8;k++) {
+      const _BvhBuildNode* child=k<n? src+slots[k] : NULL;
+      const Aabb bounds=child!=NULL? child->bounds : AABB_EMPTY;
+      out->min_x[k]=bounds.min.x;
+      out->min_y[k]=bounds.min.y;
+      out->min_z[k]=bounds.min.z;
+      out->max_x[k]=bounds.max.x;
+      out->max_y[k]=bounds.max.y;
+      out->max_z[k]=bounds.max.z;
+      out->child[k]=0;
+      out->count[k]=0;
+      if(child==NULL) {
+        continue;
+      }
+      if(child->count>0) {
+        out->child[k]=child->first;
+        out->count[k]=child->count;
+      } else {
+        out->child[k]=(u32)count;
+        stack[sp]=slots[k];
+        stack_dst[sp]=(u32)count++;
+        stack_depth[sp++]=level+1;
+        *depth=MAX(*depth,(usize)level+1);
+      }
+    }
+  }
+  return count;
+}
+
+
+/// Builds a BVH over the `triangle_count` triangles of `indices`.
+///
+/// The result refers to `vertices` and `indices` and must be released with `bvh_free`.
+///
+/// Panics
+///
+/// Will panic if an allocation fails, or if `options` is out of range or there are 2^31
+/// triangles or more when `cmeth_assert` is enabled.
+Bvh bvh_build(const Vec3* vertices,const u32* indices,usize triangle_count,BvhOptions options) {
+  cmeth_assert(options.width==2 || options.width==8);
+  cmeth_assert(options.max_leaf_size>=1 && options.max_leaf_size<=255);
+  cmeth_assert(options.bins>=2 && options.bins<=BVH_MAX_BINS);
+  cmeth_assert(triangle_count<((usize)1<<31));
+  Bvh bvh={
+    .vertices=vertices,
+    .indices=indices,
+    .triangle_count=triangle_count,
+    .triangles=NULL,
+    .width=options.width,
+    .nodes=NULL,
+    .wide_nodes=NULL,
+    .node_count=0,
+    .depth=0
+  };
+  if(triangle_count==0) {
+    return bvh;
+  }
+
+  usize threads=options.threads;
+  if(cmeth_thread_pool_in_job()) {
+    threads=1;
+  } else if(threads==0) {
+    threads=cmeth_thread_pool_threads();
+  }
+  const usize max_nodes=2*triangle_count-1;
+  _BvhBuilder b={
+    .vertices=vertices,
+    .indices=indices,
+    .prims=_bvh_alloc(triangle_count*sizeof(_BvhPrim)),
+    .nodes=_bvh_alloc(max_nodes*sizeof(_BvhBuildNode)),
+    .node_count=1,
+    .spare_threads=threads-1<(usize)INT32_MAX? (i32)(threads-1) : INT32_MAX,
+    .depth=0,
+    .max_leaf_size=options.max_leaf_size,
+    .bins=options.bins
+  };
+  _bvh_for_chunks(&b,triangle_count,triangle_count>=BVH_PARALLEL_BIN_MIN? BVH_MAX_CHUNKS : 1,_bvh_prim_bounds,NULL);
+
+  _BvhTask root={&b,0,0,(u32)triangle_count,1,AABB_EMPTY,AABB_EMPTY};
+  for(usize i=0;i<triangle_count;i++) {
+    root.bounds=aabb_union(root.bounds,b.prims[i].bounds);
+    root.centroids=aabb_expand(root.centroids,b.prims[i].centroid);
+  }
+  _bvh_build_node(root);
+
+  const usize built=b.node_count;
+  u32* stack=_bvh_alloc(3*built*sizeof(u32));
+  if(options.width==2) {
+    bvh.nodes=_bvh_alloc(built*sizeof(BvhNode));
+    bvh.node_count=_bvh_flatten2(b.nodes,bvh.nodes,stack,stack+built);
+    bvh.depth=b.depth;
+  } else {
+    bvh.wide_nodes=_bvh_alloc(built*sizeof(BvhNode8));
+    bvh.node_count=_bvh_collapse8(b.nodes,bvh.wide_nodes,stack,stack+built,stack+2*built,&bvh.depth);
+  }
+  free(stack);
+  free(b.nodes);
+  bvh.triangles=_bvh_alloc(triangle_count*sizeof(u32));
+  for(usize i=0;i<triangle_count;i++) {
+    bvh.triangles[i]=b.prims[i].triangle;
+  }
+  free(b.prims);
+  return bvh;
+}
+
+/// Releases the memory of `self` and leaves it empty.
+void bvh_free(Bvh* self) {
+  free(self->triangles);
+  free(self->nodes);
+  free(self->wide_nodes);
+  self->triangles=NULL;
+  self->nodes=NULL;
+  self->wide_nodes=NULL;
+  self->triangle_count=0;
+  self->node_count=0;
+  self->depth=0;
+}
+
+/// Returns the bounds of every triangle of `self`, or `AABB_EMPTY` if it has none.
+const Aabb bvh_bounds(const Bvh* self) {
+  if(self->node_count==0) {
+    return AABB_EMPTY;
+  }
+  if(self->width==2) {
+    return self->nodes[0].bounds;
+  }
+  // Unused slots hold empty boxes, which leave the union unchanged.
+  const BvhNode8* root=self->wide_nodes;
+  Aabb bounds=AABB_EMPTY;
+  for(usize k=0;k<8;k++) {
+    bounds=aabb_union(bounds,aabb_new(
+      vec3_new(root->min_x[k],root->min_y[k],root->min_z[k]),
+      vec3_new(root->max_x[k],root->max_y[k],root->max_z[k])));
+  }
+  return bounds;
+}
+
+
+/// Möller-Trumbore. The comparisons are written so a `NaN` rejects the triangle, which
+/// also covers rays parallel to its plane, where `inv_det` is infinite.
+static inline_always __attribute__((optimize("fp-contract=off")))
+const bool _bvh_intersect_triangle(const Bvh* self,u32 triangle,const Ray* ray,BvhHit* hit) {
+  const u32* index=self->indices+3*(usize)triangle;
+  const Vec3 v0=self->vertices[index[0]];
+  const Vec3 e1=vec3_sub(self->vertices[index[1]],v0);
+  const Vec3 e2=vec3_sub(self->vertices[index[2]],v0);
+  const Vec3 p=vec3_cross(ray->dir,e2);
+  const f32 inv_det=1.0F/vec3_dot(e1,p);
+  const Vec3 s=vec3_sub(ray->origin,v0);
+  const f32 u=vec3_dot(s,p)*inv_det;
+  if(!(u>=0.0F && u<=1.0F)) {
+    return false;
+  }
+  const Vec3 q=vec3_cross(s,e1);
+  const f32 v=vec3_dot(ray->dir,q)*inv_det;
+  if(!(v>=0.0F && u+v<=1.0F)) {
+    return false;
+  }
+  const f32 t=vec3_dot(e2,q)*inv_det;
+  if(!(t>=ray->t_min && t<=ray->t_max)) {
+    return false;
+  }
+  hit->t=t;
+  hit->u=u;
+  hit->v=v;
+  hit->triangle=triangle;
+  return true;
+}
+
+/// Intersects the `count` triangles from `first` in `Bvh.triangles`, shortening `ray` to
+/// each hit, and returns whether there was one. With `any`, stops at the first.
+///
+/// Kept out of line, so the AVX2 traversal doesn't inline it, and built without FP
+/// contraction, so `-march=native` doesn't fuse the Möller-Trumbore products either. Both
+/// widths then find the same hits bit for bit on every tier and for any `-march`, as plain
+/// unfused `f32` arithmetic would.
+static __attribute__((noinline,optimize("fp-contract=off")))
+bool _bvh_intersect_leaf(const Bvh* self,u32 first,u32 count,Ray* ray,BvhHit* hit,const bool any) {
+  bool found=false;
+  for(u32 i=first;i<first+count;i++) {
+    if(_bvh_intersect_triangle(self,self->triangles[i],ray,hit)) {
+      ray->t_max=hit->t;
+      found=true;
+      if(any) {
+        break;
+      }
+    }
+  }
+  return found;
+}
+
+/// A node still to visit, with the distance at which the ray enters it.
+typedef struct {
+  u32 node;
+  f32 t;
+} _BvhEntry;
+
+/// `ray_intersect_aabb` without its checks, which `bvh_closest_hit` and `bvh_any_hit` make
+/// once per ray: nodes of the binary tree are never empty.
+static inline_always
+const f32 _bvh_enter(const Ray* ray,const Aabb* bounds) {
+  f32 t_min=ray->t_min;
+  f32 t_max=ray->t_max;
+  const bool neg_x=ray->sign&1;
+  const bool neg_y=(ray->sign>>1)&1;
+  const bool neg_z=(ray->sign>>2)&1;
+  _ray_clip_slab(neg_x? bounds->max.x : bounds->min.x,neg_x? bounds->min.x : bounds->max.x,
+    ray->origin.x,ray->inv_dir.x,&t_min,&t_max);
+  _ray_clip_slab(neg_y? bounds->max.y : bounds->min.y,neg_y? bounds->min.y : bounds->max.y,
+    ray->origin.y,ray->inv_dir.y,&t_min,&t_max);
+  _ray_clip_slab(neg_z? bounds->max.z : bounds->min.z,neg_z? bounds->min.z : bounds->max.z,
+    ray->origin.z,ray->inv_dir.z,&t_min,&t_max);
+  return t_min<=t_max? t_min : F32_INFINITY;
+}
+
+static inline_always
+bool _bvh_traverse2(const Bvh* self,Ray ray,BvhHit* hit,const bool any) {
+  const BvhNode* nodes=self->nodes;
+  if(!(_bvh_enter(&ray,&nodes[0].bounds)<F32_INFINITY)) {
+    return false;
+  }
+  _BvhEntry stack[self->depth+1];
+  usize sp=0;
+  u32 current=0;
+  bool found=false;
+  for(;;) {
+    const BvhNode* node=nodes+current;
+    if(node->count==0) {
+      _BvhEntry near={current+1,_bvh_enter(&ray,&nodes[current+1].bounds)};
+      _BvhEntry far={node->offset,_bvh_enter(&ray,&nodes[node->offset].bounds)};
+      if(far.t<near.t) {
+        const _BvhEntry swap=near;
+        near=far;
+        far=swap;
+      }
+      if(near.t<F32_INFINITY) {
+        if(far.t<F32_INFINITY) {
+          stack[sp++]=far;
+        }
+        current=near.node;
+        continue;
+      }
+    } else {
+      if(_bvh_intersect_leaf(self,node->offset,node->count,&ray,hit,any)) {
+        if(any) {
+          return true;
+        }
+        found=true;
+      }
+    }
+    do {
+      if(sp==0) {
+        return found;
+      }
+      sp--;
+    } while(stack[sp].t>ray.t_max);
+    current=stack[sp].node;
+  }
+}
+
+
+#define _PASTE(a,b) a##b
+#define _KERNEL(name,suffix) _PASTE(name,suffix)
+
+typedef f32 f32x4 __attribute__((vector_size(16)));
+typedef i32 i32x4 __attribute__((vector_size(16)));
+
+#define LANES 4
+#define F32V f32x4
+#define I32V i32x4
+#define MOVEMASK(v) _mm_movemask_ps((__m128)(v))
+#define TARGET
+#define SUFFIX _sse2
+#include "bvh_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef MOVEMASK
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x8 __attribute__((vector_size(32)));
+typedef i32 i32x8 __attribute__((vector_size(32)));
+
+#define LANES 8
+#define F32V f32x8
+#define I32V i32x8
+#define MOVEMASK(v) _mm256_movemask_ps((__m256)(v))
+#define TARGET target_avx2
+#define SUFFIX _avx2
+#include "bvh_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef MOVEMASK
+#undef TARGET
+#undef SUFFIX
+
+
+static struct {
+  bool (*closest_hit8)(const Bvh*,Ray,BvhHit*);
+  bool (*any_hit8)(const Bvh*,Ray);
+} _kernels={
+  .closest_hit8=_bvh_closest_hit8_sse2,
+  .any_hit8=_bvh_any_hit8_sse2,
+};
+
+__attribute__((constructor))
+static void _bvh_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    // 8 lanes fill a YMM register, so AVX-512 hosts run the AVX2 traversal.
+    case CMETH_CPU_AVX512:
+    case CMETH_CPU_AVX2:
+      _kernels.closest_hit8=_bvh_closest_hit8_avx2;
+      _kernels.any_hit8=_bvh_any_hit8_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Finds the closest triangle `ray` hits in `[ray.t_min,ray.t_max]`. Returns `false`
+/// and leaves `hit` unchanged if there is none.
+///
+/// Triangles are hit from both sides. Rays for which `ray_is_finite` is `false` never hit.
+bool bvh_closest_hit(const Bvh* self,Ray ray,BvhHit* hit) {
+  if(self->node_count==0 || !ray_is_finite(ray)) {
+    return false;
+  }
+  BvhHit closest;
+  const bool found=self->width==2?
+    _bvh_traverse2(self,ray,&closest,false) :
+    _kernels.closest_hit8(self,ray,&closest);
+  if(found) {
+    *hit=closest;
+  }
+  return found;
+}
+
+/// Returns `true` if `ray` hits any triangle in `[ray.t_min,ray.t_max]`, stopping at the
+/// first one found. This is the cheaper query for shadow and visibility rays.
+bool bvh_any_hit(const Bvh* self,Ray ray) {
+  if(self->node_count==0 || !ray_is_finite(ray)) {
+    return false;
+  }
+  BvhHit hit;
+  return self->width==2? _bvh_traverse2(self,ray,&hit,true) : _kernels.any_hit8(self,ray);
+}
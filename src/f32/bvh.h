@@ -0,0 +1,97 @@
+#ifndef CMETH_F32_BVH_H
+#define CMETH_F32_BVH_H
+#include "../prelude.h"
+#include "vec3.h"
+#include "aabb.h"
+#include "ray.h"
+
+
+/// A node of a binary BVH, 32 bytes.
+///
+/// Nodes are stored depth-first, so the first child of an interior node is the node right
+/// after it and only the second needs an index.
+typedef struct {
+  Aabb bounds;
+  /// Index of the second child for interior nodes, of the first triangle in
+  /// `Bvh.triangles` for leaves.
+  u32 offset;
+  /// Number of triangles of a leaf, zero for interior nodes.
+  u32 count;
+} BvhNode;
+
+/// A node of an 8-wide BVH, 256 bytes.
+///
+/// The bounds of the children are stored as structure-of-arrays, so one ray is tested
+/// against all eight with one slab test per element. Unused slots hold empty boxes.
+typedef struct {
+  f32 min_x[8];
+  f32 min_y[8];
+  f32 min_z[8];
+  f32 max_x[8];
+  f32 max_y[8];
+  f32 max_z[8];
+  /// Index of the child node for interior children, of the first triangle in
+  /// `Bvh.triangles` for leaves.
+  u32 child[8];
+  /// Number of triangles of leaf children, zero for interior children and unused slots.
+  u32 count[8];
+} BvhNode8;
+
+/// Parameters of `bvh_build`.
+typedef struct {
+  /// Children per node: 2 builds `BvhNode`s, 8 collapses the binary tree into `BvhNode8`s.
+  u32 width;
+  /// Triangles per leaf at most, from 1 to 255.
+  u32 max_leaf_size;
+  /// Candidate split planes per axis and node are `bins-1`, for `bins` from 2 to 32.
+  u32 bins;
+  /// Threads used by the build, including the caller; 0 uses `cmeth_thread_pool_threads`.
+  /// A build started while a `cmeth_parallel_for` job runs uses one.
+  usize threads;
+} BvhOptions;
+
+/// Binary tree, at most 4 triangles per leaf, 16 bins, the threads of the pool.
+#define BVH_OPTIONS_DEFAULT ((BvhOptions){.width=2,.max_leaf_size=4,.bins=16,.threads=0})
+
+/// A bounding volume hierarchy over an indexed triangle mesh.
+///
+/// The tree refers to the vertex and index arrays it was built from, which must outlive
+/// it and not change. Triangle `i` has the vertices `vertices[indices[3*i+k]]`.
+typedef struct {
+  const Vec3* vertices;
+  const u32* indices;
+  usize triangle_count;
+  /// Triangle indices in leaf order.
+  u32* triangles;
+  /// 2 or 8; selects which of `nodes` and `wide_nodes` is used.
+  u32 width;
+  BvhNode* nodes;
+  BvhNode8* wide_nodes;
+  usize node_count;
+  /// Levels of the tree, which bounds the traversal stacks.
+  usize depth;
+} Bvh;
+
+/// The closest intersection found by `bvh_closest_hit`.
+typedef struct {
+  /// Distance along the ray, in multiples of `Ray.dir`.
+  f32 t;
+  /// Barycentric coordinates of the hit: `(1-u-v)*v0+u*v1+v*v2`.
+  f32 u;
+  f32 v;
+  u32 triangle;
+} BvhHit;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+Bvh bvh_build(const Vec3* vertices,const u32* indices,usize triangle_count,BvhOptions options);
+void bvh_free(Bvh* self);
+const Aabb bvh_bounds(const Bvh* self);
+bool bvh_closest_hit(const Bvh* self,Ray ray,BvhHit* hit);
+bool bvh_any_hit(const Bvh* self,Ray ray);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
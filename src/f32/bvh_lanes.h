@@ -0,0 +1,106 @@
+// 8-wide traversal bodies of `bvh.c`.
+//
+// Included once per tier, which defines beforehand:
+//
+// - `LANES`: lanes per vector, 4 or 8; the eight children take `8/LANES` vectors.
+// - `F32V`, `I32V`: the `f32` and `i32` vector types of `LANES` lanes.
+// - `MOVEMASK(v)`: the sign bits of the lanes of an `I32V`, as an integer.
+// - `TARGET`: function attributes of the tier (empty for the baseline).
+// - `SUFFIX`: appended to every function name.
+
+#define K(name) _KERNEL(name,SUFFIX)
+
+
+/// Slab test of `ray` against the eight children of `node`, the same arithmetic as
+/// `ray_intersect_aabb`. Returns a bit per child hit and their entry distances in `t`.
+static inline_always TARGET
+const u32 K(_bvh_node8_hits)(const BvhNode8* node,const Ray* ray,f32 t[8]) {
+  const f32 origin[3]={ray->origin.x,ray->origin.y,ray->origin.z};
+  const f32 inv_dir[3]={ray->inv_dir.x,ray->inv_dir.y,ray->inv_dir.z};
+  const f32* lo[3]={node->min_x,node->min_y,node->min_z};
+  const f32* hi[3]={node->max_x,node->max_y,node->max_z};
+  u32 mask=0;
+  for(usize h=0;h<8;h+=LANES) {
+    F32V t_min=(F32V){0}+ray->t_min;
+    F32V t_max=(F32V){0}+ray->t_max;
+    I32V nonempty=(I32V){0}-1;
+    for(usize k=0;k<3;k++) {
+      F32V min,max;
+      __builtin_memcpy(&min,lo[k]+h,sizeof(F32V));
+      __builtin_memcpy(&max,hi[k]+h,sizeof(F32V));
+      nonempty&=min<=max;
+      const bool neg=(ray->sign>>k)&1;
+      const F32V t_near=((neg? max : min)-origin[k])*inv_dir[k];
+      const F32V t_far=((neg? min : max)-origin[k])*inv_dir[k];
+      // Written so a `NaN` keeps the interval, as in `_ray_clip_slab`.
+      const I32V near_in=t_near>t_min;
+      const I32V far_in=t_far<t_max;
+      t_min=(F32V)(((I32V)t_near&near_in) | ((I32V)t_min&~near_in));
+      t_max=(F32V)(((I32V)t_far&far_in) | ((I32V)t_max&~far_in));
+    }
+    const I32V hit=nonempty & (t_min<=t_max) & (t_min<F32_INFINITY);
+    __builtin_memcpy(t+h,&t_min,sizeof(t_min));
+    mask|=(u32)MOVEMASK(hit)<<h;
+  }
+  return mask;
+}
+
+static TARGET
+bool K(_bvh_traverse8)(const Bvh* self,Ray ray,BvhHit* hit,const bool any) {
+  _BvhEntry stack[7*self->depth+1];
+  usize sp=0;
+  u32 current=0;
+  bool found=false;
+  for(;;) {
+    const BvhNode8* node=self->wide_nodes+current;
+    f32 t[8];
+    u32 mask=K(_bvh_node8_hits)(node,&ray,t);
+    // Leaves are intersected right away; interior children are kept sorted farthest first,
+    // so the nearest one ends up on top of the stack.
+    _BvhEntry children[8];
+    usize n=0;
+    while(mask!=0) {
+      const u32 k=(u32)__builtin_ctz(mask);
+      mask&=mask-1;
+      if(node->count[k]>0) {
+        if(_bvh_intersect_leaf(self,node->child[k],node->count[k],&ray,hit,any)) {
+          if(any) {
+            return true;
+          }
+          found=true;
+        }
+      } else {
+        usize j=n++;
+        for(;j>0 && children[j-1].t<t[k];j--) {
+          children[j]=children[j-1];
+        }
+        children[j]=(_BvhEntry){node->child[k],t[k]};
+      }
+    }
+    for(usize j=0;j<n;j++) {
+      if(children[j].t<=ray.t_max) {
+        stack[sp++]=children[j];
+      }
+    }
+    do {
+      if(sp==0) {
+        return found;
+      }
+      sp--;
+    } while(stack[sp].t>ray.t_max);
+    current=stack[sp].node;
+  }
+}
+
+static TARGET
+bool K(_bvh_closest_hit8)(const Bvh* self,Ray ray,BvhHit* hit) {
+  return K(_bvh_traverse8)(self,ray,hit,false);
+}
+
+static TARGET
+bool K(_bvh_any_hit8)(const Bvh* self,Ray ray) {
+  BvhHit hit;
+  return K(_bvh_traverse8)(self,ray,&hit,true);
+}
+
+#undef K
@@ -0,0 +1,371 @@
+// The rebuild and the iterator inline the value-type API instead of calling back into the
+// archive.
+#define CMETH_HEADER_ONLY
+#include "hash_grid.h"
+#include "math_impl.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// `hash_grid_rebuild` is a counting sort of the points by bucket, split into one
+// contiguous chunk of points per thread of the `cmeth_parallel_for` pool:
+//
+// 1. Each chunk hashes the cells of its points and counts them per bucket.
+// 2. The counts become offsets: bucket by bucket, then chunk by chunk within a bucket.
+// 3. Each chunk writes the indices of its points to their offsets.
+// 4. Each chunk of the sorted slots fetches the positions of its points.
+//
+// So the points of a bucket keep the order of the input, whatever the number of threads.
+// Scattering indices and then gathering positions misses the cache about once per point
+// and array instead of four times per point for scattering to the three coordinate arrays
+// and the indices, and the gather's misses are loads, which overlap.
+// Every pass is a linear scan of the input or the table, and the tables are only
+// reallocated when the grid grows.
+//
+// Cells hash as in Teschner et al., "Optimized Spatial Hashing for Collision Detection of
+// Deformable Objects" (2003), into a power-of-two table of at least a quarter as many
+// buckets as points: neighbour queries scan whole buckets, so a few points per bucket cost
+// less than the cache misses of a larger table.
+
+
+/// Points per chunk at least.
+static const usize HASH_GRID_CHUNK_MIN=32768;
+
+#define HASH_GRID_MAX_CHUNKS 64
+
+
+/// Points per block of the counting pass.
+#define HASH_GRID_BLOCK 256
+
+
+/// The cell coordinate of `v`, saturated to the `i32` range. `NaN` gives `INT32_MIN`.
+static inline_always
+const i32 _hash_grid_coord(f32 v,f32 cell_size) {
+  const f32 c=f32_floor(v/cell_size);
+  if(c>=0x1p31F) {
+    return INT32_MAX;
+  }
+  return c>=-0x1p31F? (i32)c : INT32_MIN;
+}
+
+/// Hashes the cell `(x,y,z)` to a bucket. Coordinates wrap around, so neighbours of cells
+/// at the edge of the `i32` range are well defined.
+static inline_always
+const u32 _hash_grid_hash(const HashGrid* self,u32 x,u32 y,u32 z) {
+  const u32 hash=(x*73856093u)^(y*19349663u)^(z*83492791u);
+  return hash&(u32)(self->table_size-1);
+}
+
+
+#define _PASTE(a,b) a##b
+#define _KERNEL(name,suffix) _PASTE(name,suffix)
+
+typedef f32 f32x4 __attribute__((vector_size(16)));
+typedef i32 i32x4 __attribute__((vector_size(16)));
+
+#define LANES 4
+#define F32V f32x4
+#define I32V i32x4
+#define TARGET
+#define SUFFIX _sse2
+#include "hash_grid_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x8 __attribute__((vector_size(32)));
+typedef i32 i32x8 __attribute__((vector_size(32)));
+
+#define LANES 8
+#define F32V f32x8
+#define I32V i32x8
+#define TARGET target_avx2
+#define SUFFIX _avx2
+#include "hash_grid_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x16 __attribute__((vector_size(64)));
+typedef i32 i32x16 __attribute__((vector_size(64)));
+
+#define LANES 16
+#define F32V f32x16
+#define I32V i32x16
+#define TARGET target_avx512
+#define SUFFIX _avx512
+#include "hash_grid_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+static struct {
+  void (*coords)(const f32*,i32*,usize,f32);
+} _kernels={
+  .coords=_hash_grid_coords_sse2,
+};
+
+__attribute__((constructor))
+static void _hash_grid_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512: _kernels.coords=_hash_grid_coords_avx512; break;
+    case CMETH_CPU_AVX2: _kernels.coords=_hash_grid_coords_avx2; break;
+    default: break;
+  }
+}
+
+static usize _hash_grid_threads(usize threads) {
+  if(threads==0) {
+    threads=cmeth_thread_pool_threads();
+  }
+  return threads<HASH_GRID_MAX_CHUNKS? threads : HASH_GRID_MAX_CHUNKS;
+}
+
+
+/// Creates an empty grid of cubic cells of side `cell_size`, rebuilt on up to `threads`
+/// threads of the `cmeth_parallel_for` pool (0 uses all of them).
+///
+/// Panics
+///
+/// Will panic if `cell_size` is not positive and finite when `cmeth_assert` is enabled.
+HashGrid hash_grid_new(f32 cell_size,usize threads) {
+  cmeth_assert(cell_size>0.0F && cell_size<F32_INFINITY);
+  return (HashGrid){
+    .cell_size=cell_size,
+    .threads=threads,
+    .len=0,
+    .table_size=1,
+    .bucket_start=NULL,
+    .xs=NULL,
+    .ys=NULL,
+    .zs=NULL,
+    .indices=NULL,
+    .buckets=NULL,
+    .counts=NULL,
+    .counts_len=0,
+    .capacity=0
+  };
+}
+
+/// Releases the memory of `self` and leaves it empty.
+void hash_grid_free(HashGrid* self) {
+  free(self->bucket_start);
+  free(self->xs);
+  free(self->ys);
+  free(self->zs);
+  free(self->indices);
+  free(self->buckets);
+  free(self->counts);
+  *self=hash_grid_new(self->cell_size,self->threads);
+}
+
+
+typedef struct {
+  HashGrid* grid;
+  const Vec3* points;
+  usize n;
+  usize chunks;
+  usize chunk;
+} _HashGridChunk;
+
+typedef void (*_HashGridPass)(const _HashGridChunk*);
+
+typedef struct {
+  _HashGridPass pass;
+  const _HashGridChunk* tasks;
+} _HashGridRun;
+
+static void _hash_grid_run_chunks(void* ctx,usize begin,usize end) {
+  const _HashGridRun* run=ctx;
+  for(usize c=begin;c<end;c++) {
+    run->pass(&run->tasks[c]);
+  }
+}
+
+/// Runs `pass` on every chunk of `tasks`, one chunk per thread of the pool.
+static void _hash_grid_run(_HashGridPass pass,const _HashGridChunk* tasks,usize chunks) {
+  _HashGridRun run={pass,tasks};
+  cmeth_parallel_for_threads(chunks,1,chunks,_hash_grid_run_chunks,&run);
+}
+
+/// Hashes and counts the points of a chunk, into its own row of `counts`.
+static void _hash_grid_count(const _HashGridChunk* task) {
+  HashGrid* self=task->grid;
+  u32* counts=self->counts+task->chunk*self->table_size;
+  for(usize b=0;b<self->table_size;b++) {
+    counts[b]=0;
+  }
+  const usize end=task->n*(task->chunk+1)/task->chunks;
+  for(usize begin=task->n*task->chunk/task->chunks;begin<end;begin+=HASH_GRID_BLOCK) {
+    const usize len=end-begin<HASH_GRID_BLOCK? end-begin : HASH_GRID_BLOCK;
+    // `Vec3` is three packed `f32`s, so the coordinates of a block are one flat array.
+    i32 cells[3*HASH_GRID_BLOCK];
+    _kernels.coords(&task->points[begin].x,cells,3*len,self->cell_size);
+    for(usize i=0;i<len;i++) {
+      const u32 bucket=_hash_grid_hash(self,(u32)cells[3*i],(u32)cells[3*i+1],(u32)cells[3*i+2]);
+      self->buckets[begin+i]=bucket;
+      counts[bucket]++;
+    }
+  }
+}
+
+/// Writes the indices of the points of a chunk to the offsets in its row of `counts`.
+static void _hash_grid_scatter(const _HashGridChunk* task) {
+  HashGrid* self=task->grid;
+  u32* offsets=self->counts+task->chunk*self->table_size;
+  const usize end=task->n*(task->chunk+1)/task->chunks;
+  for(usize i=task->n*task->chunk/task->chunks;i<end;i++) {
+    self->indices[offsets[self->buckets[i]]++]=(u32)i;
+  }
+}
+
+/// Fetches the positions of a chunk of the sorted slots.
+static void _hash_grid_gather(const _HashGridChunk* task) {
+  HashGrid* self=task->grid;
+  const usize end=task->n*(task->chunk+1)/task->chunks;
+  for(usize slot=task->n*task->chunk/task->chunks;slot<end;slot++) {
+    const Vec3 point=task->points[self->indices[slot]];
+    self->xs[slot]=point.x;
+    self->ys[slot]=point.y;
+    self->zs[slot]=point.z;
+  }
+}
+
+/// Replaces `ptr` with a new block of `size` bytes, without copying.
+static void* _hash_grid_alloc(void* ptr,usize size) {
+  free(ptr);
+  ptr=malloc(size>0? size : 1);
+  if(ptr==NULL) {
+    panic("hash_grid_rebuild: out of memory\n");
+  }
+  return ptr;
+}
+
+/// Replaces the contents of `self` with the `n` points of `points`.
+///
+/// Panics
+///
+/// Will panic if an allocation fails, or if there are 2^32 points or more when
+/// `cmeth_assert` is enabled.
+void hash_grid_rebuild(HashGrid* self,const Vec3* points,usize n) {
+  cmeth_assert(n<((usize)1<<32));
+  usize chunks=n/HASH_GRID_CHUNK_MIN;
+  chunks=chunks<_hash_grid_threads(self->threads)? chunks : _hash_grid_threads(self->threads);
+  chunks=chunks>0? chunks : 1;
+  usize table_size=1;
+  while(table_size<n/4) {
+    table_size*=2;
+  }
+  if(n>self->capacity || self->xs==NULL) {
+    self->xs=_hash_grid_alloc(self->xs,n*sizeof(f32));
+    self->ys=_hash_grid_alloc(self->ys,n*sizeof(f32));
+    self->zs=_hash_grid_alloc(self->zs,n*sizeof(f32));
+    self->indices=_hash_grid_alloc(self->indices,n*sizeof(u32));
+    self->buckets=_hash_grid_alloc(self->buckets,n*sizeof(u32));
+    self->capacity=n;
+  }
+  if(table_size!=self->table_size || self->bucket_start==NULL) {
+    self->bucket_start=_hash_grid_alloc(self->bucket_start,(table_size+1)*sizeof(u32));
+    self->table_size=table_size;
+  }
+  if(chunks*table_size>self->counts_len) {
+    self->counts=_hash_grid_alloc(self->counts,chunks*table_size*sizeof(u32));
+    self->counts_len=chunks*table_size;
+  }
+  self->len=n;
+
+  _HashGridChunk tasks[HASH_GRID_MAX_CHUNKS];
+  for(usize c=0;c<chunks;c++) {
+    tasks[c]=(_HashGridChunk){self,points,n,chunks,c};
+  }
+  _hash_grid_run(_hash_grid_count,tasks,chunks);
+  u32 offset=0;
+  for(usize b=0;b<table_size;b++) {
+    self->bucket_start[b]=offset;
+    for(usize c=0;c<chunks;c++) {
+      const u32 count=self->counts[c*table_size+b];
+      self->counts[c*table_size+b]=offset;
+      offset+=count;
+    }
+  }
+  self->bucket_start[table_size]=offset;
+  _hash_grid_run(_hash_grid_scatter,tasks,chunks);
+  _hash_grid_run(_hash_grid_gather,tasks,chunks);
+}
+
+
+/// Returns an iterator over the points of `self` within `radius` of `center`, for
+/// `hash_grid_next`. It scans the buckets of the 27 cells around the one of `center`.
+///
+/// The iterator refers to `self`, which must not be rebuilt while it is in use.
+///
+/// Panics
+///
+/// Will panic if `radius` is greater than `self->cell_size` when `cmeth_assert` is
+/// enabled.
+HashGridIter hash_grid_neighbours(const HashGrid* self,Vec3 center,f32 radius) {
+  cmeth_assert(radius<=self->cell_size);
+  HashGridIter iter={
+    .grid=self,
+    .center=center,
+    .radius_squared=radius*radius,
+    .bucket_count=0,
+    .bucket=0,
+    .next=0,
+    .end=0
+  };
+  if(self->len==0) {
+    return iter;
+  }
+  const u32 x=(u32)_hash_grid_coord(center.x,self->cell_size);
+  const u32 y=(u32)_hash_grid_coord(center.y,self->cell_size);
+  const u32 z=(u32)_hash_grid_coord(center.z,self->cell_size);
+  for(i32 dz=-1;dz<=1;dz++) {
+    for(i32 dy=-1;dy<=1;dy++) {
+      for(i32 dx=-1;dx<=1;dx++) {
+        const u32 bucket=_hash_grid_hash(self,x+(u32)dx,y+(u32)dy,z+(u32)dz);
+        // Neighbouring cells may share a bucket, which must be scanned once.
+        bool seen=false;
+        for(u32 k=0;k<iter.bucket_count;k++) {
+          seen|=iter.buckets[k]==bucket;
+        }
+        if(!seen) {
+          iter.buckets[iter.bucket_count++]=bucket;
+        }
+      }
+    }
+  }
+  return iter;
+}
+
+/// Advances `iter` to the next point within its radius and returns `true`, storing the
+/// index of the point and its squared distance to the center, or returns `false` when
+/// every point was visited. The center itself is visited too if it is a point of the grid.
+///
+/// Points come bucket by bucket, and in the order they were given to `hash_grid_rebuild`
+/// within a bucket.
+bool hash_grid_next(HashGridIter* iter,u32* index,f32* distance_squared) {
+  const HashGrid* grid=iter->grid;
+  for(;;) {
+    while(iter->next<iter->end) {
+      const u32 i=iter->next++;
+      const f32 d=vec3_distance_squared(iter->center,vec3_new(grid->xs[i],grid->ys[i],grid->zs[i]));
+      if(d<=iter->radius_squared) {
+        *index=grid->indices[i];
+        *distance_squared=d;
+        return true;
+      }
+    }
+    if(iter->bucket==iter->bucket_count) {
+      return false;
+    }
+    const u32 bucket=iter->buckets[iter->bucket++];
+    iter->next=grid->bucket_start[bucket];
+    iter->end=grid->bucket_start[bucket+1];
+  }
+}
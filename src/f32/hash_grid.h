@@ -0,0 +1,62 @@
+#ifndef CMETH_F32_HASH_GRID_H
+#define CMETH_F32_HASH_GRID_H
+#include "../prelude.h"
+#include "vec3.h"
+
+
+/// A uniform grid of cubic cells over moving points, stored as a hash table of cells.
+///
+/// Cell `c` holds the points `p` with `vec3_floor(vec3_div_f32(p,cell_size))==c`. Cells are
+/// hashed to `table_size` buckets, and the points of each bucket are stored contiguously,
+/// in structure-of-arrays form, from `bucket_start[b]` to `bucket_start[b+1]`. A bucket can
+/// hold the points of several cells.
+typedef struct {
+  f32 cell_size;
+  /// Threads used by `hash_grid_rebuild`, including the caller; 0 uses the whole
+  /// `cmeth_parallel_for` pool.
+  usize threads;
+  /// Points in the grid.
+  usize len;
+  /// A power of two.
+  usize table_size;
+  u32* bucket_start;
+  /// Point positions and their indices in the array given to `hash_grid_rebuild`, in
+  /// bucket order.
+  f32* xs;
+  f32* ys;
+  f32* zs;
+  u32* indices;
+  /// Scratch of the rebuilds, kept between them.
+  u32* buckets;
+  u32* counts;
+  usize counts_len;
+  /// Points the arrays have room for.
+  usize capacity;
+} HashGrid;
+
+/// Visits the points within a distance of a center, see `hash_grid_neighbours`.
+typedef struct {
+  const HashGrid* grid;
+  Vec3 center;
+  f32 radius_squared;
+  /// The distinct buckets of the 27 cells around `center`.
+  u32 buckets[27];
+  u32 bucket_count;
+  u32 bucket;
+  u32 next;
+  u32 end;
+} HashGridIter;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+HashGrid hash_grid_new(f32 cell_size,usize threads);
+void hash_grid_free(HashGrid* self);
+void hash_grid_rebuild(HashGrid* self,const Vec3* points,usize n);
+HashGridIter hash_grid_neighbours(const HashGrid* self,Vec3 center,f32 radius);
+bool hash_grid_next(HashGridIter* iter,u32* index,f32* distance_squared);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
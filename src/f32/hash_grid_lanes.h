@@ -0,0 +1,39 @@
+// Cell coordinate kernel of `hash_grid.c`.
+//
+// Included once per tier, which defines beforehand:
+//
+// - `LANES`: lanes per vector.
+// - `F32V`, `I32V`: the `f32` and `i32` vector types of `LANES` lanes.
+// - `TARGET`: function attributes of the tier (empty for the baseline).
+// - `SUFFIX`: appended to every function name.
+
+#define K(name) _KERNEL(name,SUFFIX)
+
+
+/// Computes `out[j]=_hash_grid_coord(in[j],cell_size)` for every `j<n`.
+///
+/// The floor is a truncation corrected by one where it rounded up, which needs no SSE4.1.
+/// `v` is raised to `-2^31` first so the correction cannot wrap a saturated lane, and lanes
+/// at or above `2^31` are set to `INT32_MAX` after it. `NaN` converts to `INT32_MIN`, which
+/// the correction leaves alone.
+static TARGET
+void K(_hash_grid_coords)(const f32* in,i32* out,usize n,f32 cell_size) {
+  const F32V lo=(F32V){0}-0x1p31f;
+  usize j=0;
+  for(;j+LANES<=n;j+=LANES) {
+    F32V v;
+    __builtin_memcpy(&v,in+j,sizeof(v));
+    v=v/cell_size;
+    const I32V below=v<lo,above=v>=-lo;
+    v=(F32V)(((I32V)v & ~below) | ((I32V)lo & below));
+    I32V t=__builtin_convertvector(v,I32V);
+    t+=__builtin_convertvector(t,F32V)>v;
+    t=(t & ~above) | (INT32_MAX & above);
+    __builtin_memcpy(out+j,&t,sizeof(t));
+  }
+  for(;j<n;j++) {
+    out[j]=_hash_grid_coord(in[j],cell_size);
+  }
+}
+
+#undef K
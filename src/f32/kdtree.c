@@ -0,0 +1,425 @@
+// The build and the queries inline the value-type API instead of calling back into the
+// archive.
+#define CMETH_HEADER_ONLY
+#include <pthread.h>
+#include "kdtree.h"
+#include "aabb.h"
+#include "math_impl.h"
+#include "../thread/pool.h"
+
+// `kdtree_build` reorders a copy of the points in place: every range of more than
+// `KDTREE_LEAF_SIZE` points is split along the axis where its bounds are widest, with a
+// quickselect that moves the median to the middle, and its two halves are built the same
+// way. Halves of at least `KDTREE_PARALLEL_MIN` points go to new threads while the thread
+// budget lasts.
+//
+// Points are ordered by their coordinate on the split axis and then by their index, so
+// every key is distinct and the layout doesn't depend on how the build was scheduled.
+// Queries rank results the same way, by distance and then by index, so they return the
+// same points whatever order they are found in.
+//
+// A query descends into the half holding the query point first and keeps the other half on
+// a fixed stack with a lower bound of its squared distance, which it visits only if that
+// can still beat the results so far. The bound sums the squared offsets to the nearest
+// plane crossed on each axis (Arya and Mount, 1993). It is computed like
+// `vec3_distance_squared`, whose rounding is monotonic, so it never exceeds the computed
+// distance of a point in the range and no tie is lost. The results themselves are kept
+// as a max-heap in the caller's output row, so queries need no memory besides that stack,
+// and batches run their queries with `cmeth_parallel_for`, which evens out queries of
+// uneven cost.
+
+
+/// Ranges with fewer points are built by the thread that reaches them.
+static const usize KDTREE_PARALLEL_MIN=16384;
+
+/// Queries per chunk at least in the batched queries.
+static const usize KDTREE_BATCH_GRAIN=64;
+
+/// Enough for the depth of a tree of 2^32 points.
+#define KDTREE_MAX_DEPTH 64
+#define KDTREE_MAX_THREADS 64
+
+
+/// The build threads for `threads`: 0 takes the pool's count, and a build started while
+/// the pool runs a job stays on the calling thread.
+static usize _kdtree_threads(usize threads) {
+  if(cmeth_thread_pool_in_job()) {
+    return 1;
+  }
+  if(threads==0) {
+    threads=cmeth_thread_pool_threads();
+  }
+  return threads<KDTREE_MAX_THREADS? threads : KDTREE_MAX_THREADS;
+}
+
+static inline_always
+const f32 _kdtree_axis(Vec3 v,usize axis) {
+  return axis==0? v.x : axis==1? v.y : v.z;
+}
+
+static inline_always
+const Vec3 _kdtree_with_axis(Vec3 v,usize axis,f32 value) {
+  return vec3_new(axis==0? value : v.x,axis==1? value : v.y,axis==2? value : v.z);
+}
+
+static inline_always
+bool _kdtree_less(const KdTree* self,usize i,usize j,usize axis) {
+  const f32 a=_kdtree_axis(self->points[i],axis);
+  const f32 b=_kdtree_axis(self->points[j],axis);
+  return a<b || (a==b && self->indices[i]<self->indices[j]);
+}
+
+static inline_always
+void _kdtree_swap(KdTree* self,usize i,usize j) {
+  const Vec3 point=self->points[i];
+  const u32 index=self->indices[i];
+  self->points[i]=self->points[j];
+  self->indices[i]=self->indices[j];
+  self->points[j]=point;
+  self->indices[j]=index;
+}
+
+/// Moves the point that sorts `nth` in `[begin,end)` on `axis` to `nth`, with the smaller
+/// ones before it and the greater ones after it.
+static void _kdtree_select(KdTree* self,usize begin,usize end,usize nth,usize axis) {
+  while(end-begin>1) {
+    // Median of three as the pivot, moved to the end of the range.
+    const usize mid=begin+(end-begin)/2;
+    const usize last=end-1;
+    if(_kdtree_less(self,mid,begin,axis)) {
+      _kdtree_swap(self,mid,begin);
+    }
+    if(_kdtree_less(self,last,begin,axis)) {
+      _kdtree_swap(self,last,begin);
+    }
+    if(_kdtree_less(self,mid,last,axis)) {
+      _kdtree_swap(self,mid,last);
+    }
+    usize store=begin;
+    for(usize i=begin;i<last;i++) {
+      if(_kdtree_less(self,i,last,axis)) {
+        _kdtree_swap(self,i,store++);
+      }
+    }
+    _kdtree_swap(self,store,last);
+    if(nth==store) {
+      return;
+    }
+    if(nth<store) {
+      end=store;
+    } else {
+      begin=store+1;
+    }
+  }
+}
+
+
+typedef struct {
+  KdTree* tree;
+  usize begin;
+  usize end;
+  usize threads;
+} _KdBuildTask;
+
+static void _kdtree_build_range(_KdBuildTask task);
+
+static void* _kdtree_build_main(void* arg) {
+  _kdtree_build_range(*(const _KdBuildTask*)arg);
+  return NULL;
+}
+
+/// Builds the subtree of `[task.begin,task.end)` on `task.threads` threads, including
+/// this one, handing half of them to the upper half of each split.
+static void _kdtree_build_range(_KdBuildTask task) {
+  KdTree* self=task.tree;
+  _KdBuildTask spawned_tasks[KDTREE_MAX_DEPTH];
+  pthread_t spawned[KDTREE_MAX_DEPTH];
+  usize spawned_count=0;
+  while(task.end-task.begin>KDTREE_LEAF_SIZE) {
+    const Aabb bounds=aabb_from_points(self->points+task.begin,task.end-task.begin);
+    const Vec3 size=aabb_size(bounds);
+    const usize axis=size.x>=size.y && size.x>=size.z? 0 : size.y>=size.z? 1 : 2;
+    const usize mid=task.begin+(task.end-task.begin)/2;
+    _kdtree_select(self,task.begin,task.end,mid,axis);
+    self->axes[mid]=(u8)axis;
+
+    const _KdBuildTask upper={self,mid+1,task.end,task.threads/2};
+    task.end=mid;
+    if(upper.threads>0 && upper.end-upper.begin>=KDTREE_PARALLEL_MIN) {
+      spawned_tasks[spawned_count]=upper;
+      _KdBuildTask* spawned_task=&spawned_tasks[spawned_count];
+      if(pthread_create(&spawned[spawned_count],NULL,_kdtree_build_main,spawned_task)==0) {
+        spawned_count++;
+        task.threads-=upper.threads;
+        continue;
+      }
+    }
+    _kdtree_build_range((_KdBuildTask){self,upper.begin,upper.end,1});
+  }
+  for(usize k=0;k<spawned_count;k++) {
+    pthread_join(spawned[k],NULL);
+  }
+}
+
+/// Builds a k-d tree over a copy of the `n` points of `points`, on up to `threads` threads
+/// (0 uses `cmeth_thread_pool_threads`, and a build started while a `cmeth_parallel_for`
+/// job runs uses one). The layout is the same for any number of threads.
+///
+/// The result must be released with `kdtree_free`.
+///
+/// Panics
+///
+/// Will panic if an allocation fails, or if there are 2^32 points or more when
+/// `cmeth_assert` is enabled.
+KdTree kdtree_build(const Vec3* points,usize n,usize threads) {
+  cmeth_assert(n<((usize)1<<32));
+  const usize capacity=n>0? n : 1;
+  KdTree tree={
+    .points=malloc(capacity*sizeof(Vec3)),
+    .indices=malloc(capacity*sizeof(u32)),
+    .axes=calloc(capacity,1),
+    .len=n
+  };
+  if(tree.points==NULL || tree.indices==NULL || tree.axes==NULL) {
+    panic("kdtree_build: out of memory\n");
+  }
+  for(usize i=0;i<n;i++) {
+    tree.points[i]=points[i];
+    tree.indices[i]=(u32)i;
+  }
+  _kdtree_build_range((_KdBuildTask){&tree,0,n,_kdtree_threads(threads)});
+  return tree;
+}
+
+/// Releases the memory of `self` and leaves it empty.
+void kdtree_free(KdTree* self) {
+  free(self->points);
+  free(self->indices);
+  free(self->axes);
+  self->points=NULL;
+  self->indices=NULL;
+  self->axes=NULL;
+  self->len=0;
+}
+
+
+/// Whether the result `(d_a,i_a)` ranks after `(d_b,i_b)`.
+static inline_always
+bool _kdtree_after(f32 d_a,u32 i_a,f32 d_b,u32 i_b) {
+  return d_a>d_b || (d_a==d_b && i_a>i_b);
+}
+
+static inline_always
+void _kdtree_sift_down(u32* indices,f32* distances,usize len,usize i) {
+  for(;;) {
+    usize largest=i;
+    for(usize child=2*i+1;child<=2*i+2 && child<len;child++) {
+      if(_kdtree_after(distances[child],indices[child],distances[largest],indices[largest])) {
+        largest=child;
+      }
+    }
+    if(largest==i) {
+      return;
+    }
+    const f32 d=distances[i];
+    const u32 index=indices[i];
+    distances[i]=distances[largest];
+    indices[i]=indices[largest];
+    distances[largest]=d;
+    indices[largest]=index;
+    i=largest;
+  }
+}
+
+/// The `k` results so far, as a max-heap on `(distance,index)` in the caller's arrays.
+typedef struct {
+  u32* indices;
+  f32* distances;
+  usize k;
+  usize len;
+  /// Points within `max_distance` seen so far, kept or not.
+  usize within;
+  f32 max_distance;
+} _KdResults;
+
+static inline_always
+void _kdtree_offer(_KdResults* r,f32 d,u32 index) {
+  if(!(d<=r->max_distance)) {
+    return;
+  }
+  r->within++;
+  if(r->k==0) {
+    return;
+  }
+  if(r->len<r->k) {
+    usize i=r->len++;
+    while(i>0 && _kdtree_after(d,index,r->distances[(i-1)/2],r->indices[(i-1)/2])) {
+      r->distances[i]=r->distances[(i-1)/2];
+      r->indices[i]=r->indices[(i-1)/2];
+      i=(i-1)/2;
+    }
+    r->distances[i]=d;
+    r->indices[i]=index;
+  } else if(_kdtree_after(r->distances[0],r->indices[0],d,index)) {
+    r->distances[0]=d;
+    r->indices[0]=index;
+    _kdtree_sift_down(r->indices,r->distances,r->len,0);
+  }
+}
+
+/// Sorts the heap by distance and then index, and fills the slots past the results with
+/// `KDTREE_NONE` and `F32_INFINITY`.
+static inline_always
+void _kdtree_finish(_KdResults* r) {
+  for(usize len=r->len;len>1;len--) {
+    const f32 d=r->distances[0];
+    const u32 index=r->indices[0];
+    r->distances[0]=r->distances[len-1];
+    r->indices[0]=r->indices[len-1];
+    r->distances[len-1]=d;
+    r->indices[len-1]=index;
+    _kdtree_sift_down(r->indices,r->distances,len-1,0);
+  }
+  for(usize i=r->len;i<r->k;i++) {
+    r->indices[i]=KDTREE_NONE;
+    r->distances[i]=F32_INFINITY;
+  }
+}
+
+typedef struct {
+  u32 begin;
+  u32 end;
+  /// Per axis, the offset of the query from the nearest splitting plane between it and
+  /// the range, or 0.
+  Vec3 offsets;
+  /// `vec3_len_squared(offsets)`, a lower bound of the squared distance to the range.
+  f32 distance;
+} _KdEntry;
+
+/// Collects into `r` the closest points to `query`. With `count_all`, subtrees are only
+/// skipped when they lie beyond `max_distance`, so `r->within` counts every point within
+/// it; otherwise they are also skipped when they can't beat the `k` results so far.
+static inline_always
+void _kdtree_query(const KdTree* self,Vec3 query,_KdResults* r,const bool count_all) {
+  if(!count_all && r->k==0) {
+    return;
+  }
+  _KdEntry stack[KDTREE_MAX_DEPTH];
+  usize sp=0;
+  usize begin=0;
+  usize end=self->len;
+  Vec3 offsets=VEC3_ZERO;
+  for(;;) {
+    if(end-begin<=KDTREE_LEAF_SIZE) {
+      for(usize i=begin;i<end;i++) {
+        _kdtree_offer(r,vec3_distance_squared(query,self->points[i]),self->indices[i]);
+      }
+    } else {
+      const usize mid=begin+(end-begin)/2;
+      const usize axis=self->axes[mid];
+      const f32 diff=_kdtree_axis(query,axis)-_kdtree_axis(self->points[mid],axis);
+      _kdtree_offer(r,vec3_distance_squared(query,self->points[mid]),self->indices[mid]);
+      const Vec3 far_offsets=_kdtree_with_axis(offsets,axis,diff);
+      const f32 far_distance=vec3_len_squared(far_offsets);
+      if(diff<0.0F) {
+        stack[sp++]=(_KdEntry){(u32)mid+1,(u32)end,far_offsets,far_distance};
+        end=mid;
+      } else {
+        stack[sp++]=(_KdEntry){(u32)begin,(u32)mid,far_offsets,far_distance};
+        begin=mid+1;
+      }
+      continue;
+    }
+    for(;;) {
+      if(sp==0) {
+        return;
+      }
+      const _KdEntry next=stack[--sp];
+      const f32 bound=!count_all && r->len==r->k? r->distances[0] : r->max_distance;
+      if(next.distance<=bound) {
+        begin=next.begin;
+        end=next.end;
+        offsets=next.offsets;
+        break;
+      }
+    }
+  }
+}
+
+/// Finds the `k` points of `self` closest to `query` within `sqrt(max_distance_squared)`
+/// of it, and returns how many there are, at most `k`.
+///
+/// Writes their indices in the array the tree was built from to `indices[0..k]` and their
+/// squared distances to `distances_squared[0..k]`, closest first, equal distances by
+/// index. Slots past the results are set to `KDTREE_NONE` and `F32_INFINITY`. Pass
+/// `F32_INFINITY` as `max_distance_squared` for a plain k-nearest query.
+usize kdtree_nearest(
+  const KdTree* self,Vec3 query,usize k,f32 max_distance_squared,
+  u32* indices,f32* distances_squared
+) {
+  _KdResults r={indices,distances_squared,k,0,0,max_distance_squared};
+  _kdtree_query(self,query,&r,false);
+  _kdtree_finish(&r);
+  return r.len;
+}
+
+
+typedef struct {
+  const KdTree* tree;
+  const Vec3* queries;
+  usize k;
+  f32 max_distance;
+  u32* indices;
+  f32* distances;
+  /// Only set by `kdtree_radius_batch`.
+  usize* counts;
+} _KdBatch;
+
+static void _kdtree_batch_range(void* ctx,usize begin,usize end) {
+  const _KdBatch* b=ctx;
+  for(usize i=begin;i<end;i++) {
+    _KdResults r={b->indices+i*b->k,b->distances+i*b->k,b->k,0,0,b->max_distance};
+    _kdtree_query(b->tree,b->queries[i],&r,b->counts!=NULL);
+    _kdtree_finish(&r);
+    if(b->counts!=NULL) {
+      b->counts[i]=r.within;
+    }
+  }
+}
+
+/// Runs the queries of `batch` on up to `threads` threads of the pool.
+static void _kdtree_batch(_KdBatch batch,usize n,usize threads) {
+  cmeth_parallel_for_threads(n,KDTREE_BATCH_GRAIN,threads,_kdtree_batch_range,&batch);
+}
+
+/// Runs `kdtree_nearest(self,queries[i],k,F32_INFINITY,...)` for every `i<n` on up to
+/// `threads` threads of the `cmeth_parallel_for` pool (0 uses all of them), writing the
+/// results of query `i` to `indices[i*k..(i+1)*k]` and
+/// `distances_squared[i*k..(i+1)*k]`.
+///
+/// Queries only use a fixed stack of their own, and the results are the same for any
+/// number of threads.
+void kdtree_nearest_batch(
+  const KdTree* self,const Vec3* queries,usize n,usize k,
+  u32* indices,f32* distances_squared,usize threads
+) {
+  const _KdBatch batch={self,queries,k,F32_INFINITY,indices,distances_squared,NULL};
+  _kdtree_batch(batch,n,threads);
+}
+
+/// Finds, for every `i<n`, the points of `self` within `radius` of `queries[i]` on up to
+/// `threads` threads of the `cmeth_parallel_for` pool (0 uses all of them). The results
+/// are the same for any number of threads.
+///
+/// `counts[i]` is the number of such points. The `max_results` closest of them are
+/// written to `indices[i*max_results..]` and `distances_squared[i*max_results..]` as by
+/// `kdtree_nearest`, so `counts[i]>max_results` means the list was truncated.
+void kdtree_radius_batch(
+  const KdTree* self,const Vec3* queries,usize n,f32 radius,usize max_results,
+  u32* indices,f32* distances_squared,usize* counts,usize threads
+) {
+  const _KdBatch batch={
+    self,queries,max_results,radius*radius,indices,distances_squared,counts
+  };
+  _kdtree_batch(batch,n,threads);
+}
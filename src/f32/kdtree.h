@@ -0,0 +1,41 @@
+#ifndef CMETH_F32_KDTREE_H
+#define CMETH_F32_KDTREE_H
+#include "../prelude.h"
+#include "vec3.h"
+
+
+/// Marks unused result slots of `kdtree_nearest` and the batched queries.
+#define KDTREE_NONE ((u32)-1)
+
+/// A static k-d tree over a point cloud.
+///
+/// The tree is implicit: a range of `points` is a node, split at its middle element along
+/// `axes[middle]` with the lower half before it and the upper half after it. Ranges of at
+/// most `KDTREE_LEAF_SIZE` points are leaves and are scanned linearly. Nothing but the
+/// reordered points, their original indices and one byte per node is stored.
+typedef struct {
+  /// The points, in tree order.
+  Vec3* points;
+  /// Index of `points[i]` in the array the tree was built from.
+  u32* indices;
+  /// Split axis of the node whose middle element is `i`, 0 for `x` to 2 for `z`.
+  u8* axes;
+  usize len;
+} KdTree;
+
+/// Points per leaf at most.
+#define KDTREE_LEAF_SIZE 8
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+KdTree kdtree_build(const Vec3* points,usize n,usize threads);
+void kdtree_free(KdTree* self);
+usize kdtree_nearest(const KdTree* self,Vec3 query,usize k,f32 max_distance_squared,u32* indices,f32* distances_squared);
+void kdtree_nearest_batch(const KdTree* self,const Vec3* queries,usize n,usize k,u32* indices,f32* distances_squared,usize threads);
+void kdtree_radius_batch(const KdTree* self,const Vec3* queries,usize n,f32 radius,usize max_results,u32* indices,f32* distances_squared,usize* counts,usize threads);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
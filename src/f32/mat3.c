@@ -0,0 +1,283 @@
+#include <math.h>
+#include "mat3.h"
+#include "math_impl.h"
+#include "prelude.h"
+
+
+static inline_always
+const __m128 _mat3_splat_lane(__m128 v,const int lane) {
+  switch(lane) {
+    case 0: return _mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,0));
+    case 1: return _mm_shuffle_ps(v,v,_MM_SHUFFLE(1,1,1,1));
+    default: return _mm_shuffle_ps(v,v,_MM_SHUFFLE(2,2,2,2));
+  }
+}
+
+/// `x_axis*v.x + y_axis*v.y + z_axis*v.z`, the core of every product below.
+static inline_always
+const __m128 _mat3_mul_m128(Mat3 self,__m128 v) {
+  __m128 res=_mm_mul_ps(self.x_axis.inner,_mat3_splat_lane(v,0));
+  res=_mm_add_ps(res,_mm_mul_ps(self.y_axis.inner,_mat3_splat_lane(v,1)));
+  return _mm_add_ps(res,_mm_mul_ps(self.z_axis.inner,_mat3_splat_lane(v,2)));
+}
+
+
+/// Creates a 3x3 matrix from three column vectors.
+inline_always
+const Mat3 mat3_from_cols(Vec3A x_axis,Vec3A y_axis,Vec3A z_axis) {
+  const Mat3 mat={
+    .x_axis=x_axis,
+    .y_axis=y_axis,
+    .z_axis=z_axis
+  };
+  return mat;
+}
+
+/// Creates a 3x3 matrix from a `[f32; 9]` array stored in column major order.
+inline
+const Mat3 mat3_from_cols_array(const f32 m[9]) {
+  return mat3_from_cols(
+    vec3a_new(m[0],m[1],m[2]),
+    vec3a_new(m[3],m[4],m[5]),
+    vec3a_new(m[6],m[7],m[8])
+  );
+}
+
+/// Writes the elements of `self` to `out` in column major order.
+inline
+void mat3_to_cols_array(Mat3 self,f32 out[9]) {
+  vec3a_write_to_slice(self.x_axis,out);
+  vec3a_write_to_slice(self.y_axis,out+3);
+  vec3a_write_to_slice(self.z_axis,out+6);
+}
+
+/// Creates a 3x3 matrix with its diagonal set to `diagonal` and all other entries set to 0.
+inline
+const Mat3 mat3_from_diagonal(Vec3 diagonal) {
+  return mat3_from_cols(
+    vec3a_new(diagonal.x,0.0F,0.0F),
+    vec3a_new(0.0F,diagonal.y,0.0F),
+    vec3a_new(0.0F,0.0F,diagonal.z)
+  );
+}
+
+/// Creates a 3x3 matrix that scales each axis by the corresponding element of `scale`.
+///
+/// Panics
+///
+/// Will panic if all elements of `scale` are zero when `cmeth_assert` is enabled.
+inline
+const Mat3 mat3_from_scale(Vec3 scale) {
+  cmeth_assert(bvec3_any(vec3_cmpne(scale,VEC3_ZERO)));
+  return mat3_from_diagonal(scale);
+}
+
+/// Creates a 3x3 matrix containing a rotation of `angle` (in radians) around the normalized
+/// rotation `axis`.
+///
+/// Panics
+///
+/// Will panic if `axis` is not normalized when `cmeth_assert` is enabled.
+inline
+const Mat3 mat3_from_axis_angle(Vec3 axis,f32 angle) {
+  cmeth_assert(vec3_is_normalized(axis));
+  const f32 sin=sinf(angle);
+  const f32 cos=cosf(angle);
+  const Vec3 axis_sin=vec3_mul_f32(axis,sin);
+  const Vec3 axis_sq=vec3_mul(axis,axis);
+  const f32 omc=1.0F-cos;
+  const f32 xyomc=axis.x*axis.y*omc;
+  const f32 xzomc=axis.x*axis.z*omc;
+  const f32 yzomc=axis.y*axis.z*omc;
+  return mat3_from_cols(
+    vec3a_new(axis_sq.x*omc+cos,xyomc+axis_sin.z,xzomc-axis_sin.y),
+    vec3a_new(xyomc-axis_sin.z,axis_sq.y*omc+cos,yzomc+axis_sin.x),
+    vec3a_new(xzomc+axis_sin.y,yzomc-axis_sin.x,axis_sq.z*omc+cos)
+  );
+}
+
+/// Creates a 3x3 matrix containing a rotation of `angle` (in radians) around the x axis.
+inline
+const Mat3 mat3_from_rotation_x(f32 angle) {
+  const f32 sina=sinf(angle);
+  const f32 cosa=cosf(angle);
+  return mat3_from_cols(
+    VEC3A_X,
+    vec3a_new(0.0F,cosa,sina),
+    vec3a_new(0.0F,-sina,cosa)
+  );
+}
+
+/// Creates a 3x3 matrix containing a rotation of `angle` (in radians) around the y axis.
+inline
+const Mat3 mat3_from_rotation_y(f32 angle) {
+  const f32 sina=sinf(angle);
+  const f32 cosa=cosf(angle);
+  return mat3_from_cols(
+    vec3a_new(cosa,0.0F,-sina),
+    VEC3A_Y,
+    vec3a_new(sina,0.0F,cosa)
+  );
+}
+
+/// Creates a 3x3 matrix containing a rotation of `angle` (in radians) around the z axis.
+inline
+const Mat3 mat3_from_rotation_z(f32 angle) {
+  const f32 sina=sinf(angle);
+  const f32 cosa=cosf(angle);
+  return mat3_from_cols(
+    vec3a_new(cosa,sina,0.0F),
+    vec3a_new(-sina,cosa,0.0F),
+    VEC3A_Z
+  );
+}
+
+/// Returns the matrix column for the given `index`.
+///
+/// Panics
+///
+/// Panics if `index` is greater than 2.
+inline
+const Vec3A mat3_col(Mat3 self,usize index) {
+  switch(index) {
+    case 0: return self.x_axis;
+    case 1: return self.y_axis;
+    case 2: return self.z_axis;
+    default: panic("index out of bounds");
+  }
+}
+
+/// Returns the matrix row for the given `index`.
+///
+/// Panics
+///
+/// Panics if `index` is greater than 2.
+inline
+const Vec3A mat3_row(Mat3 self,usize index) {
+  switch(index) {
+    case 0: return vec3a_new(self.x_axis.inner[0],self.y_axis.inner[0],self.z_axis.inner[0]);
+    case 1: return vec3a_new(self.x_axis.inner[1],self.y_axis.inner[1],self.z_axis.inner[1]);
+    case 2: return vec3a_new(self.x_axis.inner[2],self.y_axis.inner[2],self.z_axis.inner[2]);
+    default: panic("index out of bounds");
+  }
+}
+
+/// Returns `true` if, and only if, all elements are finite.
+/// If any element is either `NaN`, positive or negative infinity, this will return `false`.
+inline
+const bool mat3_is_finite(Mat3 self) {
+  return vec3a_is_finite(self.x_axis)&&vec3a_is_finite(self.y_axis)&&vec3a_is_finite(self.z_axis);
+}
+
+/// Returns `true` if any elements are `NaN`.
+inline
+const bool mat3_is_nan(Mat3 self) {
+  return vec3a_is_nan(self.x_axis)||vec3a_is_nan(self.y_axis)||vec3a_is_nan(self.z_axis);
+}
+
+/// Returns the transpose of `self`.
+inline
+const Mat3 mat3_transpose(Mat3 self) {
+  // x0 y0 x1 y1
+  const __m128 tmp0=_mm_unpacklo_ps(self.x_axis.inner,self.y_axis.inner);
+  // x2 y2 x3 y3
+  const __m128 tmp1=_mm_unpackhi_ps(self.x_axis.inner,self.y_axis.inner);
+  return mat3_from_cols(
+    vec3a_from_m128(_mm_shuffle_ps(tmp0,self.z_axis.inner,_MM_SHUFFLE(0,0,1,0))),
+    vec3a_from_m128(_mm_shuffle_ps(tmp0,self.z_axis.inner,_MM_SHUFFLE(1,1,3,2))),
+    vec3a_from_m128(_mm_shuffle_ps(tmp1,self.z_axis.inner,_MM_SHUFFLE(2,2,1,0)))
+  );
+}
+
+/// Returns the determinant of `self`.
+inline
+const f32 mat3_determinant(Mat3 self) {
+  return vec3a_dot(self.z_axis,vec3a_cross(self.x_axis,self.y_axis));
+}
+
+/// Returns the inverse of `self`.
+///
+/// If the matrix is not invertible the returned matrix will be invalid.
+///
+/// Panics
+///
+/// Will panic if the determinant of `self` is zero when `cmeth_assert` is enabled.
+inline
+const Mat3 mat3_inverse(Mat3 self) {
+  const Vec3A tmp0=vec3a_cross(self.y_axis,self.z_axis);
+  const Vec3A tmp1=vec3a_cross(self.z_axis,self.x_axis);
+  const Vec3A tmp2=vec3a_cross(self.x_axis,self.y_axis);
+  const f32 det=vec3a_dot(self.z_axis,tmp2);
+  cmeth_assert(det!=0.0F);
+  const __m128 inv_det=_mm_set1_ps(1.0F/det);
+  return mat3_transpose(mat3_from_cols(
+    vec3a_from_m128(_mm_mul_ps(tmp0.inner,inv_det)),
+    vec3a_from_m128(_mm_mul_ps(tmp1.inner,inv_det)),
+    vec3a_from_m128(_mm_mul_ps(tmp2.inner,inv_det))
+  ));
+}
+
+/// Transforms a 3D vector.
+inline
+const Vec3 mat3_mul_vec3(Mat3 self,Vec3 rhs) {
+  return vec3_from_vec3a(mat3_mul_vec3a(self,vec3a_from_vec3(rhs)));
+}
+
+/// Transforms a `Vec3A`.
+inline_always
+const Vec3A mat3_mul_vec3a(Mat3 self,Vec3A rhs) {
+  return vec3a_from_m128(_mat3_mul_m128(self,rhs.inner));
+}
+
+/// Multiplies two 3x3 matrices.
+inline
+const Mat3 mat3_mul_mat3(Mat3 self,Mat3 rhs) {
+  return mat3_from_cols(
+    mat3_mul_vec3a(self,rhs.x_axis),
+    mat3_mul_vec3a(self,rhs.y_axis),
+    mat3_mul_vec3a(self,rhs.z_axis)
+  );
+}
+
+/// Adds two 3x3 matrices.
+inline
+const Mat3 mat3_add_mat3(Mat3 self,Mat3 rhs) {
+  return mat3_from_cols(
+    vec3a_add(self.x_axis,rhs.x_axis),
+    vec3a_add(self.y_axis,rhs.y_axis),
+    vec3a_add(self.z_axis,rhs.z_axis)
+  );
+}
+
+/// Subtracts two 3x3 matrices.
+inline
+const Mat3 mat3_sub_mat3(Mat3 self,Mat3 rhs) {
+  return mat3_from_cols(
+    vec3a_sub(self.x_axis,rhs.x_axis),
+    vec3a_sub(self.y_axis,rhs.y_axis),
+    vec3a_sub(self.z_axis,rhs.z_axis)
+  );
+}
+
+/// Multiplies a 3x3 matrix by a scalar.
+inline
+const Mat3 mat3_mul_f32(Mat3 self,f32 rhs) {
+  return mat3_from_cols(
+    vec3a_mul_f32(self.x_axis,rhs),
+    vec3a_mul_f32(self.y_axis,rhs),
+    vec3a_mul_f32(self.z_axis,rhs)
+  );
+}
+
+/// Returns true if the absolute difference of all elements between `self` and `rhs`
+/// is less than or equal to `max_abs_diff`.
+///
+/// This can be used to compare if two matrices contain similar elements. It works best
+/// when comparing with a known value. The `max_abs_diff` that should be used used depends
+/// on the values being compared against.
+inline
+const bool mat3_abs_diff_eq(Mat3 self,Mat3 rhs,f32 max_abs_diff) {
+  return vec3a_abs_diff_eq(self.x_axis,rhs.x_axis,max_abs_diff)
+    &&vec3a_abs_diff_eq(self.y_axis,rhs.y_axis,max_abs_diff)
+    &&vec3a_abs_diff_eq(self.z_axis,rhs.z_axis,max_abs_diff);
+}
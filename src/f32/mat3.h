@@ -0,0 +1,61 @@
+#ifndef CMETH_F32_MAT3_H
+#define CMETH_F32_MAT3_H
+#include <emmintrin.h>
+#include "../prelude.h"
+#include "vec3.h"
+#include "vec3a.h"
+
+
+/// A 3x3 column-major matrix.
+///
+/// Each column is a `Vec3A`, so the matrix is 48 bytes with 16-byte alignment and every
+/// product is three broadcast-multiply-adds over SSE registers.
+typedef struct {
+  Vec3A x_axis;
+  Vec3A y_axis;
+  Vec3A z_axis;
+} Mat3;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const Mat3 mat3_from_cols(Vec3A x_axis,Vec3A y_axis,Vec3A z_axis);
+CMETH_API const Mat3 mat3_from_cols_array(const f32 m[9]);
+CMETH_API void mat3_to_cols_array(Mat3 self,f32 out[9]);
+CMETH_API const Mat3 mat3_from_diagonal(Vec3 diagonal);
+CMETH_API const Mat3 mat3_from_scale(Vec3 scale);
+CMETH_API const Mat3 mat3_from_axis_angle(Vec3 axis,f32 angle);
+CMETH_API const Mat3 mat3_from_rotation_x(f32 angle);
+CMETH_API const Mat3 mat3_from_rotation_y(f32 angle);
+CMETH_API const Mat3 mat3_from_rotation_z(f32 angle);
+CMETH_API const Vec3A mat3_col(Mat3 self,usize index);
+CMETH_API const Vec3A mat3_row(Mat3 self,usize index);
+CMETH_API const bool mat3_is_finite(Mat3 self);
+CMETH_API const bool mat3_is_nan(Mat3 self);
+CMETH_API const Mat3 mat3_transpose(Mat3 self);
+CMETH_API const f32 mat3_determinant(Mat3 self);
+CMETH_API const Mat3 mat3_inverse(Mat3 self);
+CMETH_API const Vec3 mat3_mul_vec3(Mat3 self,Vec3 rhs);
+CMETH_API const Vec3A mat3_mul_vec3a(Mat3 self,Vec3A rhs);
+CMETH_API const Mat3 mat3_mul_mat3(Mat3 self,Mat3 rhs);
+CMETH_API const Mat3 mat3_add_mat3(Mat3 self,Mat3 rhs);
+CMETH_API const Mat3 mat3_sub_mat3(Mat3 self,Mat3 rhs);
+CMETH_API const Mat3 mat3_mul_f32(Mat3 self,f32 rhs);
+CMETH_API const bool mat3_abs_diff_eq(Mat3 self,Mat3 rhs,f32 max_abs_diff);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// All zeroes.
+#define MAT3_ZERO mat3_from_cols(VEC3A_ZERO,VEC3A_ZERO,VEC3A_ZERO)
+
+/// The identity matrix, where every diagonal element is `1` and every other element is `0`.
+#define MAT3_IDENTITY mat3_from_cols(VEC3A_X,VEC3A_Y,VEC3A_Z)
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "mat3.c"
+#endif
+
+#endif
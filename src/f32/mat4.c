@@ -0,0 +1,369 @@
+#include "mat4.h"
+#include "math_impl.h"
+#include "prelude.h"
+
+
+static inline_always
+const __m128 _mat4_splat_lane(__m128 v,const int lane) {
+  switch(lane) {
+    case 0: return _mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,0));
+    case 1: return _mm_shuffle_ps(v,v,_MM_SHUFFLE(1,1,1,1));
+    case 2: return _mm_shuffle_ps(v,v,_MM_SHUFFLE(2,2,2,2));
+    default: return _mm_shuffle_ps(v,v,_MM_SHUFFLE(3,3,3,3));
+  }
+}
+
+/// Sum of all four lanes, in every lane.
+static inline_always
+const __m128 _mat4_dot4(__m128 lhs,__m128 rhs) {
+  const __m128 x2_y2_z2_w2=_mm_mul_ps(lhs,rhs);
+  const __m128 z2_w2_0_0=_mm_movehl_ps(x2_y2_z2_w2,x2_y2_z2_w2);
+  const __m128 x2z2_y2w2=_mm_add_ps(x2_y2_z2_w2,z2_w2_0_0);
+  const __m128 y2w2=_mm_shuffle_ps(x2z2_y2w2,x2z2_y2w2,_MM_SHUFFLE(1,1,1,1));
+  const __m128 sum=_mm_add_ss(x2z2_y2w2,y2w2);
+  return _mm_shuffle_ps(sum,sum,_MM_SHUFFLE(0,0,0,0));
+}
+
+/// Builds one set of 2x2 minors of the lower two rows, `a*b-c*d`, for `_mat4_adjugate`.
+#define _MAT4_FAC(self,L0,L1) ({ \
+  const __m128 swp0a=_mm_shuffle_ps((self).w_axis,(self).z_axis,_MM_SHUFFLE(L0,L0,L0,L0)); \
+  const __m128 swp0b=_mm_shuffle_ps((self).w_axis,(self).z_axis,_MM_SHUFFLE(L1,L1,L1,L1)); \
+  const __m128 swp00=_mm_shuffle_ps((self).z_axis,(self).y_axis,_MM_SHUFFLE(L1,L1,L1,L1)); \
+  const __m128 swp01=_mm_shuffle_ps(swp0a,swp0a,_MM_SHUFFLE(2,0,0,0)); \
+  const __m128 swp02=_mm_shuffle_ps(swp0b,swp0b,_MM_SHUFFLE(2,0,0,0)); \
+  const __m128 swp03=_mm_shuffle_ps((self).z_axis,(self).y_axis,_MM_SHUFFLE(L0,L0,L0,L0)); \
+  _mm_sub_ps(_mm_mul_ps(swp00,swp01),_mm_mul_ps(swp02,swp03)); \
+})
+
+/// Computes the columns of the adjugate of `self` (the transposed cofactor matrix, so the
+/// inverse is `adj/det`) and returns the determinant in every lane.
+///
+/// This is the cofactor expansion from GLM's `glm_mat4_inverse`: six vectors of 2x2 minors
+/// of the lower rows are shared by all sixteen cofactors.
+static inline_always
+const __m128 _mat4_adjugate(Mat4 self,Mat4* adj) {
+  const __m128 fac0=_MAT4_FAC(self,3,2);
+  const __m128 fac1=_MAT4_FAC(self,3,1);
+  const __m128 fac2=_MAT4_FAC(self,2,1);
+  const __m128 fac3=_MAT4_FAC(self,3,0);
+  const __m128 fac4=_MAT4_FAC(self,2,0);
+  const __m128 fac5=_MAT4_FAC(self,1,0);
+
+  const __m128 sign_a=_mm_set_ps(1.0F,-1.0F,1.0F,-1.0F);
+  const __m128 sign_b=_mm_set_ps(-1.0F,1.0F,-1.0F,1.0F);
+
+  const __m128 temp0=_mm_shuffle_ps(self.y_axis,self.x_axis,_MM_SHUFFLE(0,0,0,0));
+  const __m128 vec0=_mm_shuffle_ps(temp0,temp0,_MM_SHUFFLE(2,2,2,0));
+  const __m128 temp1=_mm_shuffle_ps(self.y_axis,self.x_axis,_MM_SHUFFLE(1,1,1,1));
+  const __m128 vec1=_mm_shuffle_ps(temp1,temp1,_MM_SHUFFLE(2,2,2,0));
+  const __m128 temp2=_mm_shuffle_ps(self.y_axis,self.x_axis,_MM_SHUFFLE(2,2,2,2));
+  const __m128 vec2=_mm_shuffle_ps(temp2,temp2,_MM_SHUFFLE(2,2,2,0));
+  const __m128 temp3=_mm_shuffle_ps(self.y_axis,self.x_axis,_MM_SHUFFLE(3,3,3,3));
+  const __m128 vec3=_mm_shuffle_ps(temp3,temp3,_MM_SHUFFLE(2,2,2,0));
+
+  const __m128 inv0=_mm_mul_ps(sign_b,_mm_add_ps(
+    _mm_sub_ps(_mm_mul_ps(vec1,fac0),_mm_mul_ps(vec2,fac1)),_mm_mul_ps(vec3,fac2)));
+  const __m128 inv1=_mm_mul_ps(sign_a,_mm_add_ps(
+    _mm_sub_ps(_mm_mul_ps(vec0,fac0),_mm_mul_ps(vec2,fac3)),_mm_mul_ps(vec3,fac4)));
+  const __m128 inv2=_mm_mul_ps(sign_b,_mm_add_ps(
+    _mm_sub_ps(_mm_mul_ps(vec0,fac1),_mm_mul_ps(vec1,fac3)),_mm_mul_ps(vec3,fac5)));
+  const __m128 inv3=_mm_mul_ps(sign_a,_mm_add_ps(
+    _mm_sub_ps(_mm_mul_ps(vec0,fac2),_mm_mul_ps(vec1,fac4)),_mm_mul_ps(vec2,fac5)));
+
+  *adj=mat4_from_cols(inv0,inv1,inv2,inv3);
+
+  const __m128 row0=_mm_shuffle_ps(inv0,inv1,_MM_SHUFFLE(0,0,0,0));
+  const __m128 row1=_mm_shuffle_ps(inv2,inv3,_MM_SHUFFLE(0,0,0,0));
+  const __m128 row2=_mm_shuffle_ps(row0,row1,_MM_SHUFFLE(2,0,2,0));
+  return _mat4_dot4(self.x_axis,row2);
+}
+
+#undef _MAT4_FAC
+
+
+/// Creates a 4x4 matrix from four column vectors.
+inline_always
+const Mat4 mat4_from_cols(__m128 x_axis,__m128 y_axis,__m128 z_axis,__m128 w_axis) {
+  const Mat4 mat={
+    .x_axis=x_axis,
+    .y_axis=y_axis,
+    .z_axis=z_axis,
+    .w_axis=w_axis
+  };
+  return mat;
+}
+
+/// Creates a 4x4 matrix from a `[f32; 16]` array stored in column major order.
+inline
+const Mat4 mat4_from_cols_array(const f32 m[16]) {
+  return mat4_from_cols(_mm_loadu_ps(m),_mm_loadu_ps(m+4),_mm_loadu_ps(m+8),_mm_loadu_ps(m+12));
+}
+
+/// Writes the elements of `self` to `out` in column major order.
+inline
+void mat4_to_cols_array(Mat4 self,f32 out[16]) {
+  _mm_storeu_ps(out,self.x_axis);
+  _mm_storeu_ps(out+4,self.y_axis);
+  _mm_storeu_ps(out+8,self.z_axis);
+  _mm_storeu_ps(out+12,self.w_axis);
+}
+
+/// Creates a 4x4 matrix with its diagonal set to `diagonal` and all other entries set to 0.
+inline
+const Mat4 mat4_from_diagonal(const f32 diagonal[4]) {
+  return mat4_from_cols(
+    _mm_set_ps(0.0F,0.0F,0.0F,diagonal[0]),
+    _mm_set_ps(0.0F,0.0F,diagonal[1],0.0F),
+    _mm_set_ps(0.0F,diagonal[2],0.0F,0.0F),
+    _mm_set_ps(diagonal[3],0.0F,0.0F,0.0F)
+  );
+}
+
+/// Creates an affine transformation matrix from the given 3x3 linear transformation matrix.
+///
+/// The resulting matrix can be used to transform 3D points and vectors.
+inline
+const Mat4 mat4_from_mat3(Mat3 m) {
+  return mat4_from_mat3_translation(m,VEC3_ZERO);
+}
+
+/// Creates an affine transformation matrix from the given 3x3 linear transformation matrix
+/// and 3D `translation`.
+inline
+const Mat4 mat4_from_mat3_translation(Mat3 m,Vec3 translation) {
+  const __m128 w_mask=_mm_castsi128_ps(_mm_set_epi32(0,-1,-1,-1));
+  return mat4_from_cols(
+    _mm_and_ps(m.x_axis.inner,w_mask),
+    _mm_and_ps(m.y_axis.inner,w_mask),
+    _mm_and_ps(m.z_axis.inner,w_mask),
+    _mm_set_ps(1.0F,translation.z,translation.y,translation.x)
+  );
+}
+
+/// Creates an affine transformation matrix from the given 3D `translation`.
+inline
+const Mat4 mat4_from_translation(Vec3 translation) {
+  return mat4_from_mat3_translation(MAT3_IDENTITY,translation);
+}
+
+/// Creates an affine transformation matrix containing the given 3D non-uniform `scale`.
+///
+/// Panics
+///
+/// Will panic if all elements of `scale` are zero when `cmeth_assert` is enabled.
+inline
+const Mat4 mat4_from_scale(Vec3 scale) {
+  return mat4_from_mat3(mat3_from_scale(scale));
+}
+
+/// Returns the matrix column for the given `index`.
+///
+/// Panics
+///
+/// Panics if `index` is greater than 3.
+inline
+const __m128 mat4_col(Mat4 self,usize index) {
+  switch(index) {
+    case 0: return self.x_axis;
+    case 1: return self.y_axis;
+    case 2: return self.z_axis;
+    case 3: return self.w_axis;
+    default: panic("index out of bounds");
+  }
+}
+
+/// Returns the matrix row for the given `index`.
+///
+/// Panics
+///
+/// Panics if `index` is greater than 3.
+inline
+const __m128 mat4_row(Mat4 self,usize index) {
+  if(index>3) {
+    panic("index out of bounds");
+  }
+  return mat4_col(mat4_transpose(self),index);
+}
+
+/// Returns `true` if, and only if, all elements are finite.
+/// If any element is either `NaN`, positive or negative infinity, this will return `false`.
+inline
+const bool mat4_is_finite(Mat4 self) {
+  // `x*0` is 0 for finite `x` and NaN for NaN and infinities.
+  const __m128 zero=_mm_setzero_ps();
+  __m128 acc=_mm_mul_ps(self.x_axis,zero);
+  acc=_mm_add_ps(acc,_mm_mul_ps(self.y_axis,zero));
+  acc=_mm_add_ps(acc,_mm_mul_ps(self.z_axis,zero));
+  acc=_mm_add_ps(acc,_mm_mul_ps(self.w_axis,zero));
+  return _mm_movemask_ps(_mm_cmpunord_ps(acc,acc))==0;
+}
+
+/// Returns `true` if any elements are `NaN`.
+inline
+const bool mat4_is_nan(Mat4 self) {
+  const __m128 nan=_mm_or_ps(
+    _mm_or_ps(_mm_cmpunord_ps(self.x_axis,self.x_axis),_mm_cmpunord_ps(self.y_axis,self.y_axis)),
+    _mm_or_ps(_mm_cmpunord_ps(self.z_axis,self.z_axis),_mm_cmpunord_ps(self.w_axis,self.w_axis))
+  );
+  return _mm_movemask_ps(nan)!=0;
+}
+
+/// Returns the transpose of `self`.
+inline
+const Mat4 mat4_transpose(Mat4 self) {
+  _MM_TRANSPOSE4_PS(self.x_axis,self.y_axis,self.z_axis,self.w_axis);
+  return self;
+}
+
+/// Returns the determinant of `self`.
+inline
+const f32 mat4_determinant(Mat4 self) {
+  Mat4 adj;
+  return _mm_cvtss_f32(_mat4_adjugate(self,&adj));
+}
+
+/// Returns the inverse of `self`.
+///
+/// If the matrix is not invertible the returned matrix will be invalid.
+///
+/// Panics
+///
+/// Will panic if the determinant of `self` is zero when `cmeth_assert` is enabled.
+inline
+const Mat4 mat4_inverse(Mat4 self) {
+  Mat4 adj;
+  const __m128 det=_mat4_adjugate(self,&adj);
+  cmeth_assert(_mm_cvtss_f32(det)!=0.0F);
+  const __m128 inv_det=_mm_div_ps(_mm_set1_ps(1.0F),det);
+  return mat4_from_cols(
+    _mm_mul_ps(adj.x_axis,inv_det),
+    _mm_mul_ps(adj.y_axis,inv_det),
+    _mm_mul_ps(adj.z_axis,inv_det),
+    _mm_mul_ps(adj.w_axis,inv_det)
+  );
+}
+
+/// Transforms a 4D vector held in an SSE register.
+inline_always
+const __m128 mat4_mul_m128(Mat4 self,__m128 rhs) {
+  __m128 res=_mm_mul_ps(self.x_axis,_mat4_splat_lane(rhs,0));
+  res=_mm_add_ps(res,_mm_mul_ps(self.y_axis,_mat4_splat_lane(rhs,1)));
+  res=_mm_add_ps(res,_mm_mul_ps(self.z_axis,_mat4_splat_lane(rhs,2)));
+  return _mm_add_ps(res,_mm_mul_ps(self.w_axis,_mat4_splat_lane(rhs,3)));
+}
+
+/// Multiplies two 4x4 matrices.
+inline
+const Mat4 mat4_mul_mat4(Mat4 self,Mat4 rhs) {
+  return mat4_from_cols(
+    mat4_mul_m128(self,rhs.x_axis),
+    mat4_mul_m128(self,rhs.y_axis),
+    mat4_mul_m128(self,rhs.z_axis),
+    mat4_mul_m128(self,rhs.w_axis)
+  );
+}
+
+/// Adds two 4x4 matrices.
+inline
+const Mat4 mat4_add_mat4(Mat4 self,Mat4 rhs) {
+  return mat4_from_cols(
+    _mm_add_ps(self.x_axis,rhs.x_axis),
+    _mm_add_ps(self.y_axis,rhs.y_axis),
+    _mm_add_ps(self.z_axis,rhs.z_axis),
+    _mm_add_ps(self.w_axis,rhs.w_axis)
+  );
+}
+
+/// Subtracts two 4x4 matrices.
+inline
+const Mat4 mat4_sub_mat4(Mat4 self,Mat4 rhs) {
+  return mat4_from_cols(
+    _mm_sub_ps(self.x_axis,rhs.x_axis),
+    _mm_sub_ps(self.y_axis,rhs.y_axis),
+    _mm_sub_ps(self.z_axis,rhs.z_axis),
+    _mm_sub_ps(self.w_axis,rhs.w_axis)
+  );
+}
+
+/// Multiplies a 4x4 matrix by a scalar.
+inline
+const Mat4 mat4_mul_f32(Mat4 self,f32 rhs) {
+  const __m128 s=_mm_set1_ps(rhs);
+  return mat4_from_cols(
+    _mm_mul_ps(self.x_axis,s),
+    _mm_mul_ps(self.y_axis,s),
+    _mm_mul_ps(self.z_axis,s),
+    _mm_mul_ps(self.w_axis,s)
+  );
+}
+
+/// Transforms the given 3D point, applying the translation.
+///
+/// This assumes that `self` contains a valid affine transform: the `w` row is ignored and
+/// no perspective divide is performed. Use `mat4_project_point3` for projections.
+inline
+const Vec3 mat4_transform_point3(Mat4 self,Vec3 rhs) {
+  return vec3_from_vec3a(mat4_transform_point3a(self,vec3a_from_vec3(rhs)));
+}
+
+/// Transforms the given 3D vector, ignoring the translation.
+///
+/// This assumes that `self` contains a valid affine transform.
+inline
+const Vec3 mat4_transform_vector3(Mat4 self,Vec3 rhs) {
+  return vec3_from_vec3a(mat4_transform_vector3a(self,vec3a_from_vec3(rhs)));
+}
+
+/// Transforms the given 3D point, applying the perspective correction.
+///
+/// This is the equivalent of multiplying `rhs` as a 4D vector where `w` is `1.0`, then
+/// dividing the `xyz` of the result by its `w`.
+inline
+const Vec3 mat4_project_point3(Mat4 self,Vec3 rhs) {
+  const __m128 res=mat4_mul_m128(self,_mm_set_ps(1.0F,rhs.z,rhs.y,rhs.x));
+  return vec3_from_vec3a(vec3a_from_m128(_mm_div_ps(res,_mat4_splat_lane(res,3))));
+}
+
+/// Transforms the given `Vec3A` point, applying the translation.
+///
+/// This assumes that `self` contains a valid affine transform.
+inline_always
+const Vec3A mat4_transform_point3a(Mat4 self,Vec3A rhs) {
+  __m128 res=_mm_mul_ps(self.x_axis,_mat4_splat_lane(rhs.inner,0));
+  res=_mm_add_ps(res,_mm_mul_ps(self.y_axis,_mat4_splat_lane(rhs.inner,1)));
+  res=_mm_add_ps(res,_mm_mul_ps(self.z_axis,_mat4_splat_lane(rhs.inner,2)));
+  return vec3a_from_m128(_mm_add_ps(res,self.w_axis));
+}
+
+/// Transforms the given `Vec3A` vector, ignoring the translation.
+///
+/// This assumes that `self` contains a valid affine transform.
+inline_always
+const Vec3A mat4_transform_vector3a(Mat4 self,Vec3A rhs) {
+  __m128 res=_mm_mul_ps(self.x_axis,_mat4_splat_lane(rhs.inner,0));
+  res=_mm_add_ps(res,_mm_mul_ps(self.y_axis,_mat4_splat_lane(rhs.inner,1)));
+  return vec3a_from_m128(_mm_add_ps(res,_mm_mul_ps(self.z_axis,_mat4_splat_lane(rhs.inner,2))));
+}
+
+/// Returns true if the absolute difference of all elements between `self` and `rhs`
+/// is less than or equal to `max_abs_diff`.
+///
+/// This can be used to compare if two matrices contain similar elements. It works best
+/// when comparing with a known value. The `max_abs_diff` that should be used used depends
+/// on the values being compared against.
+inline
+const bool mat4_abs_diff_eq(Mat4 self,Mat4 rhs,f32 max_abs_diff) {
+  const __m128 sign_mask=_mm_set1_ps(-0.0F);
+  const __m128 max=_mm_set1_ps(max_abs_diff);
+  const __m128 ok=_mm_and_ps(
+    _mm_and_ps(
+      _mm_cmple_ps(_mm_andnot_ps(sign_mask,_mm_sub_ps(self.x_axis,rhs.x_axis)),max),
+      _mm_cmple_ps(_mm_andnot_ps(sign_mask,_mm_sub_ps(self.y_axis,rhs.y_axis)),max)
+    ),
+    _mm_and_ps(
+      _mm_cmple_ps(_mm_andnot_ps(sign_mask,_mm_sub_ps(self.z_axis,rhs.z_axis)),max),
+      _mm_cmple_ps(_mm_andnot_ps(sign_mask,_mm_sub_ps(self.w_axis,rhs.w_axis)),max)
+    )
+  );
+  return _mm_movemask_ps(ok)==0xF;
+}
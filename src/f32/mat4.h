@@ -0,0 +1,70 @@
+#ifndef CMETH_F32_MAT4_H
+#define CMETH_F32_MAT4_H
+#include <emmintrin.h>
+#include "../prelude.h"
+#include "vec3.h"
+#include "vec3a.h"
+#include "mat3.h"
+
+
+/// A 4x4 column-major matrix.
+///
+/// Each column is a raw SSE register holding `x`, `y`, `z` and `w` in lanes 0 to 3. The
+/// matrix is 64 bytes with 16-byte alignment.
+typedef struct {
+  __m128 x_axis;
+  __m128 y_axis;
+  __m128 z_axis;
+  __m128 w_axis;
+} Mat4;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const Mat4 mat4_from_cols(__m128 x_axis,__m128 y_axis,__m128 z_axis,__m128 w_axis);
+CMETH_API const Mat4 mat4_from_cols_array(const f32 m[16]);
+CMETH_API void mat4_to_cols_array(Mat4 self,f32 out[16]);
+CMETH_API const Mat4 mat4_from_diagonal(const f32 diagonal[4]);
+CMETH_API const Mat4 mat4_from_mat3(Mat3 m);
+CMETH_API const Mat4 mat4_from_mat3_translation(Mat3 m,Vec3 translation);
+CMETH_API const Mat4 mat4_from_translation(Vec3 translation);
+CMETH_API const Mat4 mat4_from_scale(Vec3 scale);
+CMETH_API const __m128 mat4_col(Mat4 self,usize index);
+CMETH_API const __m128 mat4_row(Mat4 self,usize index);
+CMETH_API const bool mat4_is_finite(Mat4 self);
+CMETH_API const bool mat4_is_nan(Mat4 self);
+CMETH_API const Mat4 mat4_transpose(Mat4 self);
+CMETH_API const f32 mat4_determinant(Mat4 self);
+CMETH_API const Mat4 mat4_inverse(Mat4 self);
+CMETH_API const __m128 mat4_mul_m128(Mat4 self,__m128 rhs);
+CMETH_API const Mat4 mat4_mul_mat4(Mat4 self,Mat4 rhs);
+CMETH_API const Mat4 mat4_add_mat4(Mat4 self,Mat4 rhs);
+CMETH_API const Mat4 mat4_sub_mat4(Mat4 self,Mat4 rhs);
+CMETH_API const Mat4 mat4_mul_f32(Mat4 self,f32 rhs);
+CMETH_API const Vec3 mat4_transform_point3(Mat4 self,Vec3 rhs);
+CMETH_API const Vec3 mat4_transform_vector3(Mat4 self,Vec3 rhs);
+CMETH_API const Vec3 mat4_project_point3(Mat4 self,Vec3 rhs);
+CMETH_API const Vec3A mat4_transform_point3a(Mat4 self,Vec3A rhs);
+CMETH_API const Vec3A mat4_transform_vector3a(Mat4 self,Vec3A rhs);
+CMETH_API const bool mat4_abs_diff_eq(Mat4 self,Mat4 rhs,f32 max_abs_diff);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// All zeroes.
+#define MAT4_ZERO mat4_from_cols(_mm_setzero_ps(),_mm_setzero_ps(),_mm_setzero_ps(),_mm_setzero_ps())
+
+/// The identity matrix, where every diagonal element is `1` and every other element is `0`.
+#define MAT4_IDENTITY mat4_from_cols( \
+  _mm_set_ps(0.0F,0.0F,0.0F,1.0F), \
+  _mm_set_ps(0.0F,0.0F,1.0F,0.0F), \
+  _mm_set_ps(0.0F,1.0F,0.0F,0.0F), \
+  _mm_set_ps(1.0F,0.0F,0.0F,0.0F))
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "mat4.c"
+#endif
+
+#endif
@@ -0,0 +1,457 @@
+// The libm fix-up of huge `sin`/`cos` arguments inlines `f32_abs` instead of calling back
+// into the archive.
+#define CMETH_HEADER_ONLY
+#include <immintrin.h>
+#include <math.h>
+#include "math_batch.h"
+#include "math_impl.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// Every function has one lane-generic body in `math_batch_lanes.h`, built on GCC vector
+// extensions and instantiated here three times: 4 lanes for the x86-64 baseline (SSE2),
+// 8 lanes for AVX2+FMA and 16 lanes for AVX-512. The table is bound once at load time from
+// `cmeth_cpu_tier()`, like the `vec3_soa_*` kernels.
+//
+// The polynomials are the single-precision minimax fits from Cephes. Range reduction is
+// Cody-Waite with a round-to-nearest done by adding and subtracting `1.5*2^23`, so the
+// quadrant and exponent come out of the float's low mantissa bits without a branch.
+//
+// Maximum error against the correctly rounded result, measured on every 7th `f32` bit
+// pattern (a 4097x4097 grid of pairs for `atan2`), for every tier:
+//
+// | function          | max ulp | notes                                          |
+// |-------------------|---------|------------------------------------------------|
+// | `f32_sin_batch`   | 2.1     | `|x|>2^20` is forwarded to libm `sinf`         |
+// | `f32_cos_batch`   | 1.6     | `|x|>2^20` is forwarded to libm `cosf`         |
+// | `f32_exp_batch`   | 1.1     |                                                |
+// | `f32_log_batch`   | 0.9     |                                                |
+// | `f32_atan_batch`  | 2.9     |                                                |
+// | `f32_atan2_batch` | 1.8     | at most 3 on random pairs                      |
+// | `f32_acos_batch`  | 1.3     |                                                |
+//
+// The AVX2 and AVX-512 bodies contract multiply-adds into FMA, so their results can differ
+// from the baseline's in the last bit.
+//
+// Special values follow C99 Annex F: NaN in gives NaN out, `exp(-inf)=0`, `exp(inf)=inf`,
+// `log(+-0)=-inf`, `log(x<0)=NaN`, `log(inf)=inf`, `sin(+-inf)=cos(+-inf)=NaN`,
+// `acos(|x|>1)=NaN`, `atan(+-inf)=+-pi/2`, and `atan2` gets the signed zeros and infinities
+// of every quadrant right. Signed zeros of `sin`, `atan` and `atan2` are kept.
+//
+// The `_parallel` variants split the arrays with `cmeth_parallel_for` and run the same
+// kernels on each range, so they give the same results bit for bit.
+//
+// `f32_trunc_batch`, `f32_floor_batch`, `f32_round_batch`, `f32_div_euclid_batch` and
+// `f32_rem_euclid_batch` give the same results as `f32_trunc` and friends bit for bit, on
+// every tier. The AVX2 and AVX-512 bodies round with `vroundps` and `vrndscaleps`. The
+// baseline has no `roundps` before SSE4.1 and truncates with `cvttps2dq`, which is exact
+// wherever a float can have a fraction. The Euclidean quotient and remainder come from an
+// exact `x-trunc(x/rhs)*rhs` instead of `fmodf`. Lanes with a quotient of `2^23` or more,
+// or an infinite or NaN divisor, are recomputed with the scalar function.
+
+
+// pi/2 split so that `q*DP1` and `q*DP2` are exact for `q<2^13` (Cephes).
+static const f32 DP1=1.5703125f;
+static const f32 DP2=4.837512969970703125e-4f;
+static const f32 DP3=7.54978995489188216e-8f;
+// The f32 split is used for `|x|<=SINCOS_F32_MAX` and `|r|>=SINCOS_F32_R_MIN`.
+static const f32 SINCOS_F32_MAX=8192.0f;
+static const f32 SINCOS_F32_R_MIN=0x1p-12f;
+// pi/2 split so that `q*PIO2_HI` is exact for `q<2^20` (fdlibm's `pio2_1`/`pio2_1t`).
+static const f32 TWO_OVER_PI=6.36619772367581343076e-1f;
+static const f64 PIO2_HI=1.57079632673412561417e+00;
+static const f64 PIO2_LO_F64=6.07710050650619224932e-11;
+// Past this `q` can reach 2^20 and the reduction stops being exact.
+static const f32 SINCOS_REDUCE_MAX=0x1p20f;
+
+static const f32 SIN_C1=-1.6666654611e-1f;
+static const f32 SIN_C2=8.3321608736e-3f;
+static const f32 SIN_C3=-1.9515295891e-4f;
+static const f32 COS_C1=4.166664568298827e-2f;
+static const f32 COS_C2=-1.388731625493765e-3f;
+static const f32 COS_C3=2.443315711809948e-5f;
+
+// 1.5*2^23: adding it rounds to an integer kept in the low mantissa bits.
+static const f32 ROUND_MAGIC=12582912.0f;
+static const i32 ROUND_MAGIC_BITS=0x4b400000;
+
+static const f32 LOG2_E=1.44269504088896341f;
+// ln(2) split so that `n*LN2_HI` is exact.
+static const f32 LN2_HI=0.693359375f;
+static const f32 LN2_LO=-2.12194440e-4f;
+
+static const f32 EXP_C0=5.0000001201e-1f;
+static const f32 EXP_C1=1.6666665459e-1f;
+static const f32 EXP_C2=4.1665795894e-2f;
+static const f32 EXP_C3=8.3334519073e-3f;
+static const f32 EXP_C4=1.3981999507e-3f;
+static const f32 EXP_C5=1.9875691500e-4f;
+
+static const f32 MIN_NORMAL=1.17549435e-38f;
+static const f32 SQRT_HALF=0.707106781186547524f;
+static const f32 LOG_C0=3.3333331174e-1f;
+static const f32 LOG_C1=-2.4999993993e-1f;
+static const f32 LOG_C2=2.0000714765e-1f;
+static const f32 LOG_C3=-1.6668057665e-1f;
+static const f32 LOG_C4=1.4249322787e-1f;
+static const f32 LOG_C5=-1.2420140846e-1f;
+static const f32 LOG_C6=1.1676998740e-1f;
+static const f32 LOG_C7=-1.1514610310e-1f;
+static const f32 LOG_C8=7.0376836292e-2f;
+
+// `PI`, `PI_LO`, `PIO2`, `PIO2_LO`, `PIO4`, `TAN_PI_8` and the `atan` polynomial come from
+// `trig.c`, which `_atan2f` shares them with.
+static const f32 TAN_3PI_8=2.414213562373095f;
+
+static const f32 ASIN_C0=1.6666752422e-1f;
+static const f32 ASIN_C1=7.4953002686e-2f;
+static const f32 ASIN_C2=4.5470025998e-2f;
+static const f32 ASIN_C3=2.4181311049e-2f;
+static const f32 ASIN_C4=4.2163199048e-2f;
+
+
+#define _PASTE(a,b) a##b
+#define _KERNEL(name,suffix) _PASTE(name,suffix)
+
+typedef f32 f32x4 __attribute__((vector_size(16)));
+typedef i32 i32x4 __attribute__((vector_size(16)));
+typedef f64 f64x4 __attribute__((vector_size(32)));
+
+/// `truncf` on SSE2, like `vec3a_trunc`: `cvttps2dq` is exact below `2^23`, and every
+/// larger float, infinity and NaN passes through.
+static inline_always
+const f32x4 _trunc_sse2(f32x4 v) {
+  const i32x4 sign=(i32x4)v & (i32)0x80000000;
+  const i32x4 truncated=(i32x4)_mm_cvtepi32_ps(_mm_cvttps_epi32((__m128)v)) | sign;
+  const i32x4 in_range=(f32x4)((i32x4)v & 0x7fffffff)<0x1p23f;
+  return (f32x4)((truncated & in_range) | ((i32x4)v & ~in_range));
+}
+
+static inline_always
+const f32x4 _floor_sse2(f32x4 v) {
+  const f32x4 t=_trunc_sse2(v);
+  const i32x4 too_big=t>v;
+  return (f32x4)(((i32x4)(t-1.0f) & too_big) | ((i32x4)t & ~too_big));
+}
+
+#define LANES 4
+#define F32V f32x4
+#define I32V i32x4
+#define F64V f64x4
+#define TARGET
+#define SUFFIX _sse2
+#define SQRT(v) ((f32x4)_mm_sqrt_ps((__m128)(v)))
+#define ANY(m) _mm_movemask_ps((__m128)(m))
+#define TRUNC(v) _trunc_sse2(v)
+#define FLOOR(v) _floor_sse2(v)
+#include "math_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef F64V
+#undef TARGET
+#undef SUFFIX
+#undef SQRT
+#undef ANY
+#undef TRUNC
+#undef FLOOR
+#undef FNMADD
+
+typedef f32 f32x8 __attribute__((vector_size(32)));
+typedef i32 i32x8 __attribute__((vector_size(32)));
+typedef f64 f64x8 __attribute__((vector_size(64)));
+#define LANES 8
+#define F32V f32x8
+#define I32V i32x8
+#define F64V f64x8
+#define TARGET target_avx2
+#define SUFFIX _avx2
+#define SQRT(v) ((f32x8)_mm256_sqrt_ps((__m256)(v)))
+#define ANY(m) _mm256_movemask_ps((__m256)(m))
+#define TRUNC(v) ((f32x8)_mm256_round_ps((__m256)(v),_MM_FROUND_TO_ZERO|_MM_FROUND_NO_EXC))
+#define FLOOR(v) ((f32x8)_mm256_round_ps((__m256)(v),_MM_FROUND_TO_NEG_INF|_MM_FROUND_NO_EXC))
+#define FNMADD(a,b,c) ((f32x8)_mm256_fnmadd_ps((__m256)(a),(__m256)(b),(__m256)(c)))
+#include "math_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef F64V
+#undef TARGET
+#undef SUFFIX
+#undef SQRT
+#undef ANY
+#undef TRUNC
+#undef FLOOR
+#undef FNMADD
+
+typedef f32 f32x16 __attribute__((vector_size(64)));
+typedef i32 i32x16 __attribute__((vector_size(64)));
+typedef f64 f64x16 __attribute__((vector_size(128)));
+#define LANES 16
+#define F32V f32x16
+#define I32V i32x16
+#define F64V f64x16
+#define TARGET target_avx512
+#define SUFFIX _avx512
+#define SQRT(v) ((f32x16)_mm512_sqrt_ps((__m512)(v)))
+#define ANY(m) _mm512_movepi32_mask((__m512i)(m))
+#define TRUNC(v) ((f32x16)_mm512_roundscale_ps((__m512)(v),_MM_FROUND_TO_ZERO|_MM_FROUND_NO_EXC))
+#define FLOOR(v) ((f32x16)_mm512_roundscale_ps((__m512)(v),_MM_FROUND_TO_NEG_INF|_MM_FROUND_NO_EXC))
+#define FNMADD(a,b,c) ((f32x16)_mm512_fnmadd_ps((__m512)(a),(__m512)(b),(__m512)(c)))
+#include "math_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef F64V
+#undef TARGET
+#undef SUFFIX
+#undef SQRT
+#undef ANY
+#undef TRUNC
+#undef FLOOR
+#undef FNMADD
+
+
+static struct {
+  void (*sin)(const f32*,f32*,usize);
+  void (*cos)(const f32*,f32*,usize);
+  void (*sincos)(const f32*,f32*,f32*,usize);
+  void (*exp)(const f32*,f32*,usize);
+  void (*log)(const f32*,f32*,usize);
+  void (*atan)(const f32*,f32*,usize);
+  void (*atan2)(const f32*,const f32*,f32*,usize);
+  void (*acos)(const f32*,f32*,usize);
+  void (*trunc)(const f32*,f32*,usize);
+  void (*floor)(const f32*,f32*,usize);
+  void (*round)(const f32*,f32*,usize);
+  void (*div_euclid)(const f32*,const f32*,f32*,usize);
+  void (*rem_euclid)(const f32*,const f32*,f32*,usize);
+} _kernels={
+  .sin=_f32_sin_batch_sse2,
+  .cos=_f32_cos_batch_sse2,
+  .sincos=_f32_sincos_batch_sse2,
+  .exp=_f32_exp_batch_sse2,
+  .log=_f32_log_batch_sse2,
+  .atan=_f32_atan_batch_sse2,
+  .atan2=_f32_atan2_batch_sse2,
+  .acos=_f32_acos_batch_sse2,
+  .trunc=_f32_trunc_batch_sse2,
+  .floor=_f32_floor_batch_sse2,
+  .round=_f32_round_batch_sse2,
+  .div_euclid=_f32_div_euclid_batch_sse2,
+  .rem_euclid=_f32_rem_euclid_batch_sse2,
+};
+
+__attribute__((constructor))
+static void _math_batch_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.sin=_f32_sin_batch_avx512;
+      _kernels.cos=_f32_cos_batch_avx512;
+      _kernels.sincos=_f32_sincos_batch_avx512;
+      _kernels.exp=_f32_exp_batch_avx512;
+      _kernels.log=_f32_log_batch_avx512;
+      _kernels.atan=_f32_atan_batch_avx512;
+      _kernels.atan2=_f32_atan2_batch_avx512;
+      _kernels.acos=_f32_acos_batch_avx512;
+      _kernels.trunc=_f32_trunc_batch_avx512;
+      _kernels.floor=_f32_floor_batch_avx512;
+      _kernels.round=_f32_round_batch_avx512;
+      _kernels.div_euclid=_f32_div_euclid_batch_avx512;
+      _kernels.rem_euclid=_f32_rem_euclid_batch_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.sin=_f32_sin_batch_avx2;
+      _kernels.cos=_f32_cos_batch_avx2;
+      _kernels.sincos=_f32_sincos_batch_avx2;
+      _kernels.exp=_f32_exp_batch_avx2;
+      _kernels.log=_f32_log_batch_avx2;
+      _kernels.atan=_f32_atan_batch_avx2;
+      _kernels.atan2=_f32_atan2_batch_avx2;
+      _kernels.acos=_f32_acos_batch_avx2;
+      _kernels.trunc=_f32_trunc_batch_avx2;
+      _kernels.floor=_f32_floor_batch_avx2;
+      _kernels.round=_f32_round_batch_avx2;
+      _kernels.div_euclid=_f32_div_euclid_batch_avx2;
+      _kernels.rem_euclid=_f32_rem_euclid_batch_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Computes `out[i]=sin(x[i])` for every `i<len`. `out` may alias `x`.
+void f32_sin_batch(const f32* x,f32* out,usize len) {
+  _kernels.sin(x,out,len);
+}
+
+/// Computes `out[i]=cos(x[i])` for every `i<len`. `out` may alias `x`.
+void f32_cos_batch(const f32* x,f32* out,usize len) {
+  _kernels.cos(x,out,len);
+}
+
+/// Computes `sin_out[i]=sin(x[i])` and `cos_out[i]=cos(x[i])` for every `i<len`, sharing
+/// the range reduction. Either output may alias `x`, but not the other output.
+void f32_sincos_batch(const f32* x,f32* sin_out,f32* cos_out,usize len) {
+  _kernels.sincos(x,sin_out,cos_out,len);
+}
+
+/// Computes `out[i]=e^x[i]` for every `i<len`. `out` may alias `x`.
+void f32_exp_batch(const f32* x,f32* out,usize len) {
+  _kernels.exp(x,out,len);
+}
+
+/// Computes `out[i]=ln(x[i])` for every `i<len`. `out` may alias `x`.
+void f32_log_batch(const f32* x,f32* out,usize len) {
+  _kernels.log(x,out,len);
+}
+
+/// Computes `out[i]=atan(x[i])` for every `i<len`. `out` may alias `x`.
+void f32_atan_batch(const f32* x,f32* out,usize len) {
+  _kernels.atan(x,out,len);
+}
+
+/// Computes `out[i]=atan2(y[i],x[i])` for every `i<len`. `out` may alias `y` or `x`.
+void f32_atan2_batch(const f32* y,const f32* x,f32* out,usize len) {
+  _kernels.atan2(y,x,out,len);
+}
+
+/// Computes `out[i]=acos(x[i])` for every `i<len`. `out` may alias `x`.
+///
+/// Unlike `f32_acos_approx`, inputs outside [-1,1] give NaN instead of being clamped.
+void f32_acos_batch(const f32* x,f32* out,usize len) {
+  _kernels.acos(x,out,len);
+}
+
+/// Computes `out[i]=f32_trunc(x[i])` for every `i<len`. `out` may alias `x`.
+void f32_trunc_batch(const f32* x,f32* out,usize len) {
+  _kernels.trunc(x,out,len);
+}
+
+/// Computes `out[i]=f32_floor(x[i])` for every `i<len`. `out` may alias `x`.
+void f32_floor_batch(const f32* x,f32* out,usize len) {
+  _kernels.floor(x,out,len);
+}
+
+/// Computes `out[i]=f32_round(x[i])` for every `i<len`, half-way cases away from zero.
+/// `out` may alias `x`.
+void f32_round_batch(const f32* x,f32* out,usize len) {
+  _kernels.round(x,out,len);
+}
+
+/// Computes `out[i]=f32_div_euclid(x[i],rhs[i])` for every `i<len`. `out` may alias `x`
+/// or `rhs`.
+void f32_div_euclid_batch(const f32* x,const f32* rhs,f32* out,usize len) {
+  _kernels.div_euclid(x,rhs,out,len);
+}
+
+/// Computes `out[i]=f32_rem_euclid(x[i],rhs[i])` for every `i<len`. `out` may alias `x`
+/// or `rhs`.
+void f32_rem_euclid_batch(const f32* x,const f32* rhs,f32* out,usize len) {
+  _kernels.rem_euclid(x,rhs,out,len);
+}
+
+
+/// The arrays of a `_parallel` call, which every range offsets by its start.
+typedef struct {
+  void (*unary)(const f32*,f32*,usize);
+  void (*binary)(const f32*,const f32*,f32*,usize);
+  const f32* x;
+  const f32* y;
+  f32* out;
+  f32* cos_out;
+} _MathBatchJob;
+
+static void _math_batch_unary_range(void* ctx,usize begin,usize end) {
+  const _MathBatchJob* job=ctx;
+  job->unary(job->x+begin,job->out+begin,end-begin);
+}
+
+static void _math_batch_sincos_range(void* ctx,usize begin,usize end) {
+  const _MathBatchJob* job=ctx;
+  _kernels.sincos(job->x+begin,job->out+begin,job->cos_out+begin,end-begin);
+}
+
+static void _math_batch_binary_range(void* ctx,usize begin,usize end) {
+  const _MathBatchJob* job=ctx;
+  job->binary(job->y+begin,job->x+begin,job->out+begin,end-begin);
+}
+
+static
+void _math_batch_unary_parallel(void (*unary)(const f32*,f32*,usize),const f32* x,f32* out,usize len) {
+  _MathBatchJob job={unary,NULL,x,NULL,out,NULL};
+  cmeth_parallel_for(len,CMETH_PARALLEL_GRAIN,_math_batch_unary_range,&job);
+}
+
+/// Runs `binary(y,x,out)` on the ranges of `cmeth_parallel_for`.
+static
+void _math_batch_binary_parallel(void (*binary)(const f32*,const f32*,f32*,usize),const f32* y,const f32* x,f32* out,usize len) {
+  _MathBatchJob job={NULL,binary,x,y,out,NULL};
+  cmeth_parallel_for(len,CMETH_PARALLEL_GRAIN,_math_batch_binary_range,&job);
+}
+
+/// Works like `f32_sin_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_sin_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.sin,x,out,len);
+}
+
+/// Works like `f32_cos_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_cos_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.cos,x,out,len);
+}
+
+/// Works like `f32_sincos_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_sincos_batch_parallel(const f32* x,f32* sin_out,f32* cos_out,usize len) {
+  _MathBatchJob job={NULL,NULL,x,NULL,sin_out,cos_out};
+  cmeth_parallel_for(len,CMETH_PARALLEL_GRAIN,_math_batch_sincos_range,&job);
+}
+
+/// Works like `f32_exp_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_exp_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.exp,x,out,len);
+}
+
+/// Works like `f32_log_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_log_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.log,x,out,len);
+}
+
+/// Works like `f32_atan_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_atan_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.atan,x,out,len);
+}
+
+/// Works like `f32_atan2_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_atan2_batch_parallel(const f32* y,const f32* x,f32* out,usize len) {
+  _math_batch_binary_parallel(_kernels.atan2,y,x,out,len);
+}
+
+/// Works like `f32_acos_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_acos_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.acos,x,out,len);
+}
+
+/// Works like `f32_trunc_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_trunc_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.trunc,x,out,len);
+}
+
+/// Works like `f32_floor_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_floor_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.floor,x,out,len);
+}
+
+/// Works like `f32_round_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_round_batch_parallel(const f32* x,f32* out,usize len) {
+  _math_batch_unary_parallel(_kernels.round,x,out,len);
+}
+
+/// Works like `f32_div_euclid_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_div_euclid_batch_parallel(const f32* x,const f32* rhs,f32* out,usize len) {
+  _math_batch_binary_parallel(_kernels.div_euclid,x,rhs,out,len);
+}
+
+/// Works like `f32_rem_euclid_batch`, on the threads of the `cmeth_parallel_for` pool.
+void f32_rem_euclid_batch_parallel(const f32* x,const f32* rhs,f32* out,usize len) {
+  _math_batch_binary_parallel(_kernels.rem_euclid,x,rhs,out,len);
+}
@@ -0,0 +1,39 @@
+#ifndef CMETH_F32_MATH_BATCH_H
+#define CMETH_F32_MATH_BATCH_H
+#include "../prelude.h"
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+void f32_sin_batch(const f32* x,f32* out,usize len);
+void f32_cos_batch(const f32* x,f32* out,usize len);
+void f32_sincos_batch(const f32* x,f32* sin_out,f32* cos_out,usize len);
+void f32_exp_batch(const f32* x,f32* out,usize len);
+void f32_log_batch(const f32* x,f32* out,usize len);
+void f32_atan_batch(const f32* x,f32* out,usize len);
+void f32_atan2_batch(const f32* y,const f32* x,f32* out,usize len);
+void f32_acos_batch(const f32* x,f32* out,usize len);
+void f32_trunc_batch(const f32* x,f32* out,usize len);
+void f32_floor_batch(const f32* x,f32* out,usize len);
+void f32_round_batch(const f32* x,f32* out,usize len);
+void f32_div_euclid_batch(const f32* x,const f32* rhs,f32* out,usize len);
+void f32_rem_euclid_batch(const f32* x,const f32* rhs,f32* out,usize len);
+void f32_sin_batch_parallel(const f32* x,f32* out,usize len);
+void f32_cos_batch_parallel(const f32* x,f32* out,usize len);
+void f32_sincos_batch_parallel(const f32* x,f32* sin_out,f32* cos_out,usize len);
+void f32_exp_batch_parallel(const f32* x,f32* out,usize len);
+void f32_log_batch_parallel(const f32* x,f32* out,usize len);
+void f32_atan_batch_parallel(const f32* x,f32* out,usize len);
+void f32_atan2_batch_parallel(const f32* y,const f32* x,f32* out,usize len);
+void f32_acos_batch_parallel(const f32* x,f32* out,usize len);
+void f32_trunc_batch_parallel(const f32* x,f32* out,usize len);
+void f32_floor_batch_parallel(const f32* x,f32* out,usize len);
+void f32_round_batch_parallel(const f32* x,f32* out,usize len);
+void f32_div_euclid_batch_parallel(const f32* x,const f32* rhs,f32* out,usize len);
+void f32_rem_euclid_batch_parallel(const f32* x,const f32* rhs,f32* out,usize len);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
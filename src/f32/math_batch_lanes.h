@@ -0,0 +1,415 @@
+// Lane-generic bodies of the `f32_*_batch` kernels.
+//
+// Included once per tier by `math_batch.c`, which defines beforehand:
+//
+// - `LANES`: elements per vector.
+// - `F32V`, `I32V`, `F64V`: GCC vector types of `LANES` `f32`/`i32`/`f64` elements.
+// - `TARGET`: function attributes of the tier (empty for the baseline).
+// - `SUFFIX`: appended to every kernel name.
+// - `SQRT(v)`: lane-wise square root of an `F32V`.
+// - `ANY(m)`: non-zero if any lane of the `I32V` mask `m` is set.
+// - `TRUNC(v)`, `FLOOR(v)`: lane-wise `truncf` and `floorf` of an `F32V`.
+// - `FNMADD(a,b,c)`: `c-a*b` rounded once, where the tier has FMA. Without it the exact
+//   products of `K(_div_trunc)` are formed in f64.
+//
+// Everything here is branch-free apart from the tail load/store and the rare scalar
+// fix-ups of huge `sin`/`cos` arguments and huge Euclidean quotients; special cases are
+// blended in with lane masks.
+
+#define K(name) _KERNEL(name,SUFFIX)
+
+
+static inline_always TARGET
+const F32V K(_load)(const f32* p,usize rem) {
+  F32V v={0};
+  if(rem>=LANES) {
+    __builtin_memcpy(&v,p,sizeof(v));
+  } else {
+    __builtin_memcpy(&v,p,rem*sizeof(f32));
+  }
+  return v;
+}
+
+static inline_always TARGET
+void K(_store)(f32* p,usize rem,F32V v) {
+  if(rem>=LANES) {
+    __builtin_memcpy(p,&v,sizeof(v));
+  } else {
+    __builtin_memcpy(p,&v,rem*sizeof(f32));
+  }
+}
+
+static inline_always TARGET
+const F32V K(_select)(I32V mask,F32V a,F32V b) {
+  return (F32V)(((I32V)a & mask) | ((I32V)b & ~mask));
+}
+
+static inline_always TARGET
+const F32V K(_abs)(F32V v) {
+  return (F32V)((I32V)v & 0x7fffffff);
+}
+
+static inline_always TARGET
+const I32V K(_sign)(F32V v) {
+  return (I32V)v & (i32)0x80000000;
+}
+
+static inline_always TARGET
+const F32V K(_xorsign)(F32V v,I32V sign) {
+  return (F32V)((I32V)v ^ sign);
+}
+
+/// `2^n` for `-126<=n<=127`.
+static inline_always TARGET
+const F32V K(_exp2i)(I32V n) {
+  return (F32V)((n+127)<<23);
+}
+
+
+/// `sin(r)` and `cos(r)` for `|r|<=pi/4`, written to `s` and `c`.
+static inline_always TARGET
+void K(_sincos_poly)(F32V r,F32V* s,F32V* c) {
+  const F32V z=r*r;
+  const F32V a=K(_abs)(r);
+  // Odd in `r`, evaluated on `|r|` so that `sin(-0)` keeps its sign.
+  *s=K(_xorsign)(((SIN_C3*z+SIN_C2)*z+SIN_C1)*z*a+a,K(_sign)(r));
+  *c=((COS_C3*z+COS_C2)*z+COS_C1)*z*z-0.5f*z+1.0f;
+}
+
+/// Reduces `x` to `r=x-q*pi/2` and returns the quadrant `q` in the low bits.
+///
+/// The f32 Cody-Waite split of pi/2 is good to `SINCOS_F32_MAX`, except when `x` is close
+/// to a non-zero multiple of pi/2: `r` then keeps only the low bits of `x`, which the split
+/// loses. Vectors with such a lane redo the subtraction in f64.
+static inline_always TARGET
+const I32V K(_reduce_pio2)(F32V x,F32V* r) {
+  const F32V t=x*TWO_OVER_PI+ROUND_MAGIC;
+  const F32V q=t-ROUND_MAGIC;
+  *r=((x-q*DP1)-q*DP2)-q*DP3;
+  const I32V exact=(K(_abs)(x)<=SINCOS_F32_MAX) & ((K(_abs)(*r)>=SINCOS_F32_R_MIN) | (q==0.0f));
+  if(ANY(~exact)) {
+    const F64V qd=__builtin_convertvector(q,F64V);
+    const F64V rd=(__builtin_convertvector(x,F64V)-qd*PIO2_HI)-qd*PIO2_LO_F64;
+    *r=__builtin_convertvector(rd,F32V);
+  }
+  return (I32V)t;
+}
+
+static inline_always TARGET
+const F32V K(_sin)(F32V x) {
+  F32V r,s,c;
+  const I32V q=K(_reduce_pio2)(x,&r);
+  K(_sincos_poly)(r,&s,&c);
+  return K(_xorsign)(K(_select)((q & 1)!=0,c,s),(q & 2)<<30);
+}
+
+static inline_always TARGET
+const F32V K(_cos)(F32V x) {
+  F32V r,s,c;
+  const I32V q=K(_reduce_pio2)(x,&r);
+  K(_sincos_poly)(r,&s,&c);
+  return K(_xorsign)(K(_select)((q & 1)!=0,s,c),((q+1) & 2)<<30);
+}
+
+static inline_always TARGET
+const F32V K(_exp)(F32V x) {
+  // Clamping keeps `n` in [-150,128]; both ends still overflow to inf and underflow to 0.
+  F32V xc=K(_select)(x<-104.0f,(F32V){0}-104.0f,x);
+  xc=K(_select)(xc>89.0f,(F32V){0}+89.0f,xc);
+  const F32V t=xc*LOG2_E+ROUND_MAGIC;
+  const F32V n=t-ROUND_MAGIC;
+  const I32V ni=(I32V)t-ROUND_MAGIC_BITS;
+  const F32V r=(xc-n*LN2_HI)-n*LN2_LO;
+  const F32V z=r*r;
+  const F32V p=(((((EXP_C5*r+EXP_C4)*r+EXP_C3)*r+EXP_C2)*r+EXP_C1)*r+EXP_C0)*z+r+1.0f;
+  // Two steps so results in the subnormal range are rounded once.
+  const I32V n1=ni>>1;
+  return p*K(_exp2i)(n1)*K(_exp2i)(ni-n1);
+}
+
+static inline_always TARGET
+const F32V K(_log)(F32V x) {
+  const I32V subnormal=x<MIN_NORMAL;
+  const F32V xs=K(_select)(subnormal,x*0x1p23f,x);
+  const I32V bits=(I32V)xs;
+  // `x=m*2^e` with `m` in [sqrt(1/2),sqrt(2)).
+  const F32V m=(F32V)((bits & 0x007fffff) | 0x3f000000);
+  const I32V small=m<SQRT_HALF;
+  const I32V e=((bits>>23) & 0xff)-126+(subnormal & -23)+small;
+  const F32V f=m+K(_select)(small,m,(F32V){0})-1.0f;
+  const F32V ef=__builtin_convertvector(e,F32V);
+  const F32V z=f*f;
+  const F32V p=((((((((LOG_C8*f+LOG_C7)*f+LOG_C6)*f+LOG_C5)*f+LOG_C4)*f+LOG_C3)*f+LOG_C2)*f+LOG_C1)*f+LOG_C0)*f*z;
+  F32V y=f+((p+ef*LN2_LO)-0.5f*z)+ef*LN2_HI;
+  y=K(_select)(x==F32_INFINITY,x,y);
+  y=K(_select)(x<0.0f,(F32V){0}+F32_NAN,y);
+  y=K(_select)(x==0.0f,(F32V){0}+F32_NEG_INFINITY,y);
+  return K(_select)(x!=x,x,y);
+}
+
+/// `atan(a)` for `a>=0`, inf included.
+static inline_always TARGET
+const F32V K(_atan_pos)(F32V a) {
+  const I32V big=a>TAN_3PI_8;
+  const I32V mid=a>TAN_PI_8;
+  const F32V one=(F32V){0}+1.0f;
+  const F32V num=K(_select)(big,-one,K(_select)(mid,a-1.0f,a));
+  const F32V den=K(_select)(big,a,K(_select)(mid,a+1.0f,one));
+  const F32V y0=K(_select)(big,(F32V){0}+PIO2,K(_select)(mid,(F32V){0}+PIO4,(F32V){0}));
+  const F32V t=num/den;
+  const F32V z=t*t;
+  return (((ATAN_C3*z+ATAN_C2)*z+ATAN_C1)*z+ATAN_C0)*z*t+t+y0;
+}
+
+static inline_always TARGET
+const F32V K(_atan)(F32V x) {
+  return K(_xorsign)(K(_atan_pos)(K(_abs)(x)),K(_sign)(x));
+}
+
+static inline_always TARGET
+const F32V K(_atan2)(F32V y,F32V x) {
+  // Folded to the first octant, the angle is `atan(lo/hi)` with `lo<=hi`, which the
+  // reduction of `K(_atan_pos)` turns into `t=lo/hi` or `t=(lo-hi)/(lo+hi)`: one division
+  // instead of forming `lo/hi` first.
+  const F32V zero=(F32V){0},one=zero+1.0f;
+  const F32V ax=K(_abs)(x),ay=K(_abs)(y);
+  const I32V swap=ay>ax;
+  F32V hi=K(_select)(swap,ay,ax),lo=K(_select)(swap,ax,ay);
+  // 0/0 and inf/inf: atan2(+-0,+-0) and atan2(+-inf,+-inf) are multiples of pi/4.
+  hi=K(_select)(hi==0.0f,one,hi);
+  const I32V infinite=lo==F32_INFINITY;
+  lo=K(_select)(infinite,one,lo);
+  hi=K(_select)(infinite,one,hi);
+  // Keeps `lo+hi` finite.
+  const F32V scale=K(_select)(hi>0x1p126f,zero+0.25f,one);
+  lo*=scale;
+  hi*=scale;
+  const I32V mid=lo>TAN_PI_8*hi;
+  const F32V t=K(_select)(mid,lo-hi,lo)/K(_select)(mid,lo+hi,hi);
+  const F32V z=t*t;
+  const F32V p=(((ATAN_C3*z+ATAN_C2)*z+ATAN_C1)*z+ATAN_C0)*z*t+t+K(_select)(mid,zero+PIO4,zero);
+  // pi/2-p, pi/2+p or pi-p in one step, so `x<0` keeps the low part of pi/2.
+  const I32V negative=K(_sign)(x)!=0;
+  const F32V base=K(_select)(swap,zero+PIO2,K(_select)(negative,zero+PI,zero));
+  const F32V base_lo=K(_select)(swap,zero+PIO2_LO,K(_select)(negative,zero+PI_LO,zero));
+  F32V r=(base+K(_xorsign)(p,(swap^negative) & (i32)0x80000000))+base_lo;
+  r=K(_xorsign)(r,K(_sign)(y));
+  return K(_select)((x!=x) | (y!=y),x+y,r);
+}
+
+static inline_always TARGET
+const F32V K(_acos)(F32V x) {
+  const F32V a=K(_abs)(x);
+  const I32V big=a>0.5f;
+  const F32V z=K(_select)(big,0.5f*(1.0f-a),a*a);
+  const F32V s=K(_select)(big,SQRT(z),a);
+  // asin(s) for s in [0,1/2].
+  const F32V p=((((ASIN_C4*z+ASIN_C3)*z+ASIN_C2)*z+ASIN_C1)*z+ASIN_C0)*z*s+s;
+  const I32V negative=K(_sign)(x)!=0;
+  const F32V large=K(_select)(negative,(PI-(p+p))+PI_LO,p+p);
+  const F32V small=(PIO2-K(_xorsign)(p,K(_sign)(x)))+PIO2_LO;
+  return K(_select)(big,large,small);
+}
+
+/// Rounds half-way cases away from zero, like `roundf`. `x-TRUNC(x)` is exact.
+static inline_always TARGET
+const F32V K(_round)(F32V x) {
+  const F32V t=TRUNC(x);
+  const F32V away=K(_xorsign)((F32V){0}+1.0f,K(_sign)(x));
+  return K(_select)(K(_abs)(x-t)>=0.5f,t+away,t);
+}
+
+/// The quotient `q=trunc(x/rhs)` of `f32_div_euclid` and `r=x-q*rhs`, exactly.
+///
+/// `q` is the truncated true quotient, or one more in magnitude when `x/rhs` rounds up to
+/// an integer. `r` is then `fmodf(x,rhs)` or `fmodf(x,rhs)-copysign(rhs,x)`, smaller than
+/// `rhs` in magnitude and a multiple of the spacing of `min(|x|,|rhs|)`, so it is an `f32`
+/// and the one rounding of `x-q*rhs` is exact. That holds while `|q|<2^23` and `rhs` is
+/// finite, which the returned mask tells per lane.
+static inline_always TARGET
+const I32V K(_div_trunc)(F32V x,F32V rhs,F32V* q,F32V* r) {
+  *q=TRUNC(x/rhs);
+#ifdef FNMADD
+  *r=FNMADD(*q,rhs,x);
+#else
+  // A 24-bit `q` times a 24-bit `rhs` is exact in f64, and so is `x` minus it.
+  const F64V qd=__builtin_convertvector(*q,F64V);
+  *r=__builtin_convertvector(__builtin_convertvector(x,F64V)-qd*__builtin_convertvector(rhs,F64V),F32V);
+#endif
+  return (K(_abs)(*q)<0x1p23f) & (K(_abs)(rhs)<F32_INFINITY);
+}
+
+static inline_always TARGET
+const F32V K(_div_euclid)(F32V x,F32V rhs,I32V* exact) {
+  F32V q,r;
+  *exact=K(_div_trunc)(x,rhs,&q,&r);
+  // `fmodf(x,rhs)<0` exactly when `x<0` and `rhs` does not divide it.
+  const I32V step=(x<0.0f) & (r!=0.0f);
+  return K(_select)(step,q-K(_xorsign)((F32V){0}+1.0f,K(_sign)(rhs)),q);
+}
+
+static inline_always TARGET
+const F32V K(_rem_euclid)(F32V x,F32V rhs,I32V* exact) {
+  F32V q,r;
+  *exact=K(_div_trunc)(x,rhs,&q,&r);
+  const F32V abs_rhs=K(_abs)(rhs);
+  // Back to `fmodf(x,rhs)`, which has the sign of `x` even when it is zero.
+  const I32V past=(r!=0.0f) & ((K(_sign)(r)^K(_sign)(x))!=0);
+  F32V m=K(_select)(past,r+K(_xorsign)(abs_rhs,K(_sign)(x)),r);
+  m=(F32V)((I32V)K(_abs)(m) | K(_sign)(x));
+  return K(_select)(m<0.0f,m+abs_rhs,m);
+}
+
+
+/// Recomputes with `f` the lanes of `x` and `rhs` outside the exact range of
+/// `K(_div_trunc)`. Reads the registers, not the input arrays, like `K(_sincos_fixup)`.
+static inline_always TARGET
+void K(_euclid_fixup)(I32V exact,F32V x,F32V rhs,f32* out,usize rem,const f32 (*f)(f32,f32)) {
+  if(!ANY(~exact)) {
+    return;
+  }
+  for(usize l=0;l<LANES && l<rem;l++) {
+    if(!exact[l]) {
+      out[l]=f(x[l],rhs[l]);
+    }
+  }
+}
+
+/// Recomputes with libm the lanes of `v` beyond the exact range of `K(_reduce_pio2)`.
+///
+/// Reads `v`, not the input array: the input may alias an output.
+static inline_always TARGET
+void K(_sincos_fixup)(F32V v,f32* s,f32* c,usize rem) {
+  if(!ANY(K(_abs)(v)>SINCOS_REDUCE_MAX)) {
+    return;
+  }
+  for(usize l=0;l<LANES && l<rem;l++) {
+    if(f32_abs(v[l])>SINCOS_REDUCE_MAX) {
+      if(s) s[l]=sinf(v[l]);
+      if(c) c[l]=cosf(v[l]);
+    }
+  }
+}
+
+
+static TARGET
+void K(_f32_sin_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    const F32V v=K(_load)(x+i,rem);
+    K(_store)(out+i,rem,K(_sin)(v));
+    K(_sincos_fixup)(v,out+i,NULL,rem);
+  }
+}
+
+static TARGET
+void K(_f32_cos_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    const F32V v=K(_load)(x+i,rem);
+    K(_store)(out+i,rem,K(_cos)(v));
+    K(_sincos_fixup)(v,NULL,out+i,rem);
+  }
+}
+
+static TARGET
+void K(_f32_sincos_batch)(const f32* x,f32* sin_out,f32* cos_out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    const F32V v=K(_load)(x+i,rem);
+    F32V r,s,c;
+    const I32V q=K(_reduce_pio2)(v,&r);
+    K(_sincos_poly)(r,&s,&c);
+    const I32V swap=(q & 1)!=0;
+    K(_store)(sin_out+i,rem,K(_xorsign)(K(_select)(swap,c,s),(q & 2)<<30));
+    K(_store)(cos_out+i,rem,K(_xorsign)(K(_select)(swap,s,c),((q+1) & 2)<<30));
+    K(_sincos_fixup)(v,sin_out+i,cos_out+i,rem);
+  }
+}
+
+static TARGET
+void K(_f32_exp_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    K(_store)(out+i,rem,K(_exp)(K(_load)(x+i,rem)));
+  }
+}
+
+static TARGET
+void K(_f32_log_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    K(_store)(out+i,rem,K(_log)(K(_load)(x+i,rem)));
+  }
+}
+
+static TARGET
+void K(_f32_atan_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    K(_store)(out+i,rem,K(_atan)(K(_load)(x+i,rem)));
+  }
+}
+
+static TARGET
+void K(_f32_atan2_batch)(const f32* y,const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    K(_store)(out+i,rem,K(_atan2)(K(_load)(y+i,rem),K(_load)(x+i,rem)));
+  }
+}
+
+static TARGET
+void K(_f32_acos_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    K(_store)(out+i,rem,K(_acos)(K(_load)(x+i,rem)));
+  }
+}
+static TARGET
+void K(_f32_trunc_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    K(_store)(out+i,rem,TRUNC(K(_load)(x+i,rem)));
+  }
+}
+
+static TARGET
+void K(_f32_floor_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    K(_store)(out+i,rem,FLOOR(K(_load)(x+i,rem)));
+  }
+}
+
+static TARGET
+void K(_f32_round_batch)(const f32* x,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    K(_store)(out+i,rem,K(_round)(K(_load)(x+i,rem)));
+  }
+}
+
+static TARGET
+void K(_f32_div_euclid_batch)(const f32* x,const f32* rhs,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    const F32V a=K(_load)(x+i,rem),b=K(_load)(rhs+i,rem);
+    I32V exact;
+    K(_store)(out+i,rem,K(_div_euclid)(a,b,&exact));
+    K(_euclid_fixup)(exact,a,b,out+i,rem,f32_div_euclid);
+  }
+}
+
+static TARGET
+void K(_f32_rem_euclid_batch)(const f32* x,const f32* rhs,f32* out,usize len) {
+  for(usize i=0;i<len;i+=LANES) {
+    const usize rem=len-i;
+    const F32V a=K(_load)(x+i,rem),b=K(_load)(rhs+i,rem);
+    I32V exact;
+    K(_store)(out+i,rem,K(_rem_euclid)(a,b,&exact));
+    K(_euclid_fixup)(exact,a,b,out+i,rem,f32_rem_euclid);
+  }
+}
+
+#undef K
@@ -1,13 +1,18 @@
 #include <math.h>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 #include "math_impl.h"
 #include "trig.h"
 
 
-inline_always
+static inline_always
 const f32 _f32_abs_private(f32 self) {
   // SAFETY: This transmutation is fine. Probably. For the reasons rust-std is using it.
-  u32 x=*((u32*)&self) & 0x7fffffff;
-  return *((f32*)&x);
+  // Goes through a union rather than a pointer cast so it stays well-defined once inlined.
+  union { f32 f; u32 u; } x={ .f=self };
+  x.u&=0x7fffffff;
+  return x.f;
 }
 
 
@@ -36,8 +41,7 @@ const bool f32_is_sign_negative(f32 self) {
   // IEEE754 says: isSignMinus(x) is true if and only if x has negative sign. isSignMinus
   // applies to zeros and NaNs as well.
   // SAFETY: This is just transmuting to get the sign bit, it's fine.
-  u32 x=*((u32*)&self);
-  return (x & 0x80000000)!=0;
+  return (f32_to_bits(self) & 0x80000000)!=0;
 }
 
 inline_always
@@ -50,6 +54,22 @@ const f32 f32_sqrt(f32 self) {
   return sqrtf(self);
 }
 
+/// Approximates `1.0/f32_sqrt(self)` with the `rsqrtss` estimate refined by one
+/// Newton-Raphson step, instead of a square root and a divide.
+///
+/// For positive normal `self` the relative error is below `3e-7` (about 5 ulp). `0.0`,
+/// subnormals and infinity give NaN, as the estimate is infinite or zero there.
+inline_always
+const f32 f32_rsqrt_fast(f32 self) {
+#ifdef __SSE__
+  const f32 y=_mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(self)));
+  const f32 half_xy=0.5F*self*y;
+  return y+y*(0.5F-half_xy*y);
+#else
+  return 1.0F/f32_sqrt(self);
+#endif
+}
+
 inline_always
 const f32 f32_rem(f32 self,f32 x) {
   return fmodf(self,x);
@@ -57,17 +77,15 @@ const f32 f32_rem(f32 self,f32 x) {
 
 inline_always
 const f32 f32_div_euclid(f32 self,f32 x) {
-  f32 q=f32_trunc(self/x);
-  if(f32_rem(self,x)<0.0) {
-    return x>0.0?q-1.0:q+1.0;
-  }
-
-  return q;
+  const f32 q=f32_trunc(self/x);
+  // One step away from `q`, down for a positive `x` and up for a negative one, when the
+  // remainder is negative.
+  return f32_rem(self,x)<0.0F? q-f32_copysign(1.0F,x) : q;
 }
 
 inline_always
 const f32 f32_trunc(f32 self) {
-  return (f32)((i32)self);
+  return truncf(self);
 }
 
 inline_always
@@ -82,32 +100,32 @@ const f32 f32_neg(f32 self) {
 }
 
 inline_always
-const f32 f32_eq(f32 self,f32 rhs) {
+const bool f32_eq(f32 self,f32 rhs) {
   return self==rhs;
 }
 
 inline_always
-const f32 f32_ne(f32 self,f32 rhs) {
+const bool f32_ne(f32 self,f32 rhs) {
   return !f32_eq(self,rhs);
 }
 
 inline_always
-const f32 f32_ge(f32 self,f32 rhs) {
+const bool f32_ge(f32 self,f32 rhs) {
   return self>=rhs;
 }
 
 inline_always
-const f32 f32_gt(f32 self,f32 rhs) {
+const bool f32_gt(f32 self,f32 rhs) {
   return self>rhs;
 }
 
 inline_always
-const f32 f32_le(f32 self,f32 rhs) {
+const bool f32_le(f32 self,f32 rhs) {
   return self<=rhs;
 }
 
 inline_always
-const f32 f32_lt(f32 self,f32 rhs) {
+const bool f32_lt(f32 self,f32 rhs) {
   return self<rhs;
 }
 
@@ -143,7 +161,14 @@ const f32 f32_mul_add(f32 a,f32 b,f32 c) {
 
 inline_always
 const u32 f32_to_bits(f32 self) {
-  return *((u32*)&self);
+  union { f32 f; u32 u; } x={ .f=self };
+  return x.u;
+}
+
+inline_always
+const f32 f32_from_bits(u32 bits) {
+  union { u32 u; f32 f; } x={ .u=bits };
+  return x.f;
 }
 
 inline_always
@@ -0,0 +1,532 @@
+#include <math.h>
+#include "quat.h"
+#include "math_impl.h"
+#include "trig.h"
+#include "prelude.h"
+
+
+/// Dot product of all four lanes, in every lane.
+static inline_always
+const __m128 _quat_dot4(__m128 lhs,__m128 rhs) {
+  const __m128 x2_y2_z2_w2=_mm_mul_ps(lhs,rhs);
+  const __m128 z2_w2_0_0=_mm_movehl_ps(x2_y2_z2_w2,x2_y2_z2_w2);
+  const __m128 x2z2_y2w2=_mm_add_ps(x2_y2_z2_w2,z2_w2_0_0);
+  const __m128 y2w2=_mm_shuffle_ps(x2z2_y2w2,x2z2_y2w2,_MM_SHUFFLE(1,1,1,1));
+  const __m128 sum=_mm_add_ss(x2z2_y2w2,y2w2);
+  return _mm_shuffle_ps(sum,sum,_MM_SHUFFLE(0,0,0,0));
+}
+
+/// `-0.0` in the lanes whose sign `_mm_xor_ps` should flip.
+static inline_always
+const __m128 _quat_sign_mask(bool x,bool y,bool z,bool w) {
+  return _mm_set_ps(w? -0.0F : 0.0F,z? -0.0F : 0.0F,y? -0.0F : 0.0F,x? -0.0F : 0.0F);
+}
+
+/// A unit vector orthogonal to the unit vector `v`, without branches.
+///
+/// Based on "Building an Orthonormal Basis, Revisited" (Duff et al., 2017).
+static inline_always
+const Vec3 _quat_any_orthonormal(Vec3 v) {
+  const f32 sign=f32_copysign(1.0F,v.z);
+  const f32 a=-1.0F/(sign+v.z);
+  const f32 b=v.x*v.y*a;
+  return vec3_new(1.0F+sign*v.x*v.x*a,sign*b,-sign*v.x);
+}
+
+
+/// Creates a new rotation quaternion.
+///
+/// This should generally not be called manually unless you know what you are doing. Use
+/// one of the other constructors instead such as `quat_from_axis_angle`.
+///
+/// `quat_from_xyzw` is mostly used by unit tests and serialization.
+inline_always
+const Quat quat_from_xyzw(f32 x,f32 y,f32 z,f32 w) {
+  return quat_from_m128(_mm_set_ps(w,z,y,x));
+}
+
+/// Creates a rotation quaternion from an array in `x`, `y`, `z`, `w` order.
+///
+/// The rotation quaternion may be denormalized.
+inline
+const Quat quat_from_array(const f32 a[4]) {
+  return quat_from_m128(_mm_loadu_ps(a));
+}
+
+/// Writes the elements of `self` to the first 4 elements in `slice`.
+inline
+void quat_write_to_slice(Quat self,f32* slice) {
+  _mm_storeu_ps(slice,self.inner);
+}
+
+/// Wraps a raw SSE register holding `x`, `y`, `z`, `w` in lanes 0 to 3.
+inline_always
+const Quat quat_from_m128(__m128 v) {
+  const Quat quat={ .inner=v };
+  return quat;
+}
+
+/// Returns the vector part of the quaternion.
+inline_always
+const Vec3 quat_xyz(Quat self) {
+  return vec3_new(self.inner[0],self.inner[1],self.inner[2]);
+}
+
+/// Returns the scalar part of the quaternion.
+inline_always
+const f32 quat_w(Quat self) {
+  return self.inner[3];
+}
+
+/// Create a quaternion for a normalized rotation `axis` and `angle` (in radians).
+///
+/// The axis must be a unit vector.
+///
+/// Panics
+///
+/// Will panic if `axis` is not normalized when `cmeth_assert` is enabled.
+inline
+const Quat quat_from_axis_angle(Vec3 axis,f32 angle) {
+  cmeth_assert(vec3_is_normalized(axis));
+  const f32 s=sinf(angle*0.5F);
+  const f32 c=cosf(angle*0.5F);
+  const Vec3 v=vec3_mul_f32(axis,s);
+  return quat_from_xyzw(v.x,v.y,v.z,c);
+}
+
+/// Create a quaternion that rotates `vec3_len(v)` radians around `vec3_normalize(v)`.
+///
+/// `quat_from_scaled_axis(VEC3_ZERO)` results in the identity quaternion.
+inline
+const Quat quat_from_scaled_axis(Vec3 v) {
+  const f32 len=vec3_len(v);
+  if(len==0.0F) {
+    return QUAT_IDENTITY;
+  }
+  return quat_from_axis_angle(vec3_div_f32(v,len),len);
+}
+
+/// Creates a quaternion from the `angle` (in radians) around the x axis.
+inline
+const Quat quat_from_rotation_x(f32 angle) {
+  return quat_from_xyzw(sinf(angle*0.5F),0.0F,0.0F,cosf(angle*0.5F));
+}
+
+/// Creates a quaternion from the `angle` (in radians) around the y axis.
+inline
+const Quat quat_from_rotation_y(f32 angle) {
+  return quat_from_xyzw(0.0F,sinf(angle*0.5F),0.0F,cosf(angle*0.5F));
+}
+
+/// Creates a quaternion from the `angle` (in radians) around the z axis.
+inline
+const Quat quat_from_rotation_z(f32 angle) {
+  return quat_from_xyzw(0.0F,0.0F,sinf(angle*0.5F),cosf(angle*0.5F));
+}
+
+/// Creates a quaternion from a 3x3 rotation matrix.
+///
+/// Note if the input matrix contain scales, shears, or other non-rotation transformations
+/// then the resulting quaternion will be ill-defined.
+inline
+const Quat quat_from_mat3(Mat3 mat) {
+  // Based on https://github.com/microsoft/DirectXMath `XMQuaternionRotationMatrix`
+  const f32 m00=mat.x_axis.inner[0],m01=mat.x_axis.inner[1],m02=mat.x_axis.inner[2];
+  const f32 m10=mat.y_axis.inner[0],m11=mat.y_axis.inner[1],m12=mat.y_axis.inner[2];
+  const f32 m20=mat.z_axis.inner[0],m21=mat.z_axis.inner[1],m22=mat.z_axis.inner[2];
+  if(m22<=0.0F) {
+    // x^2 + y^2 >= z^2 + w^2
+    const f32 dif10=m11-m00;
+    const f32 omm22=1.0F-m22;
+    if(dif10<=0.0F) {
+      // x^2 >= y^2
+      const f32 four_xsq=omm22-dif10;
+      const f32 inv4x=0.5F/f32_sqrt(four_xsq);
+      return quat_from_xyzw(four_xsq*inv4x,(m01+m10)*inv4x,(m02+m20)*inv4x,(m12-m21)*inv4x);
+    }
+    // y^2 >= x^2
+    const f32 four_ysq=omm22+dif10;
+    const f32 inv4y=0.5F/f32_sqrt(four_ysq);
+    return quat_from_xyzw((m01+m10)*inv4y,four_ysq*inv4y,(m12+m21)*inv4y,(m20-m02)*inv4y);
+  }
+  // z^2 + w^2 >= x^2 + y^2
+  const f32 sum10=m11+m00;
+  const f32 opm22=1.0F+m22;
+  if(sum10<=0.0F) {
+    // z^2 >= w^2
+    const f32 four_zsq=opm22-sum10;
+    const f32 inv4z=0.5F/f32_sqrt(four_zsq);
+    return quat_from_xyzw((m02+m20)*inv4z,(m12+m21)*inv4z,four_zsq*inv4z,(m01-m10)*inv4z);
+  }
+  // w^2 >= z^2
+  const f32 four_wsq=opm22+sum10;
+  const f32 inv4w=0.5F/f32_sqrt(four_wsq);
+  return quat_from_xyzw((m12-m21)*inv4w,(m20-m02)*inv4w,(m01-m10)*inv4w,four_wsq*inv4w);
+}
+
+/// Creates a 3D rotation matrix from the given quaternion.
+///
+/// Panics
+///
+/// Will panic if `rotation` is not normalized when `cmeth_assert` is enabled.
+inline
+const Mat3 mat3_from_quat(Quat rotation) {
+  cmeth_assert(quat_is_normalized(rotation));
+  const f32 x=rotation.inner[0],y=rotation.inner[1],z=rotation.inner[2],w=rotation.inner[3];
+  const f32 x2=x+x,y2=y+y,z2=z+z;
+  const f32 xx=x*x2,xy=x*y2,xz=x*z2;
+  const f32 yy=y*y2,yz=y*z2,zz=z*z2;
+  const f32 wx=w*x2,wy=w*y2,wz=w*z2;
+  return mat3_from_cols(
+    vec3a_new(1.0F-(yy+zz),xy+wz,xz-wy),
+    vec3a_new(xy-wz,1.0F-(xx+zz),yz+wx),
+    vec3a_new(xz+wy,yz-wx,1.0F-(xx+yy))
+  );
+}
+
+/// Gets the minimal rotation for transforming `from` to `to`. The rotation is in the
+/// plane spanned by the two vectors. Will rotate at most 180 degrees.
+///
+/// The inputs must be unit vectors.
+///
+/// `quat_mul_vec3(quat_from_rotation_arc(from,to),from)` is approximately `to`.
+///
+/// For near-singular cases (from~=to and from~=-to) the current implementation
+/// is only accurate to about 0.001 (for `f32`).
+///
+/// Panics
+///
+/// Will panic if `from` or `to` are not normalized when `cmeth_assert` is enabled.
+inline
+const Quat quat_from_rotation_arc(Vec3 from,Vec3 to) {
+  cmeth_assert(vec3_is_normalized(from));
+  cmeth_assert(vec3_is_normalized(to));
+  const f32 one_minus_eps=1.0F-2.0F*F32_EPSILON;
+  const f32 dot=vec3_dot(from,to);
+  if(dot>one_minus_eps) {
+    // 0 degree singularity: from ~= to
+    return QUAT_IDENTITY;
+  }
+  // `from x to` cancels to zero well before the dot reaches -1 for vectors that are only
+  // normalized to a few ulp, so the 180 degree cut-over is wider than the 0 degree one.
+  if(dot<-(1.0F-1e-6F)) {
+    // 180 degree singularity: from ~= -to
+    return quat_from_axis_angle(_quat_any_orthonormal(from),F32_PI);
+  }
+  const Vec3 c=vec3_cross(from,to);
+  return quat_normalize(quat_from_xyzw(c.x,c.y,c.z,1.0F+dot));
+}
+
+/// Writes the rotation axis (normalized) and angle (in radians) of `self` to `axis` and
+/// `angle`.
+///
+/// The angle comes from `_atan2f`, so it keeps full precision near 0 and pi where an
+/// `acos` of `w` would not.
+inline
+void quat_to_axis_angle(Quat self,Vec3* axis,f32* angle) {
+  const f32 epsilon=1.0e-8F;
+  const Vec3 v=quat_xyz(self);
+  const f32 len=vec3_len(v);
+  if(len>=epsilon) {
+    *angle=2.0F*_atan2f(len,quat_w(self));
+    *axis=vec3_div_f32(v,len);
+  } else {
+    *angle=0.0F;
+    *axis=VEC3_X;
+  }
+}
+
+/// Returns the rotation axis scaled by the rotation in radians.
+inline
+const Vec3 quat_to_scaled_axis(Quat self) {
+  Vec3 axis;
+  f32 angle;
+  quat_to_axis_angle(self,&axis,&angle);
+  return vec3_mul_f32(axis,angle);
+}
+
+/// Returns the quaternion conjugate of `self`. For a unit quaternion the conjugate is also
+/// the inverse.
+inline_always
+const Quat quat_conjugate(Quat self) {
+  return quat_from_m128(_mm_xor_ps(self.inner,_quat_sign_mask(true,true,true,false)));
+}
+
+/// Returns the inverse of a normalized quaternion.
+///
+/// Typically quaternion inverse returns the conjugate of a normalized quaternion. Because
+/// `self` is assumed to already be unit length this method does not normalize before
+/// returning the conjugate.
+///
+/// Panics
+///
+/// Will panic if `self` is not normalized when `cmeth_assert` is enabled.
+inline
+const Quat quat_inverse(Quat self) {
+  cmeth_assert(quat_is_normalized(self));
+  return quat_conjugate(self);
+}
+
+/// Computes the dot product of `self` and `rhs`. The dot product is equal to the cosine of
+/// the angle between two quaternion rotations.
+inline_always
+const f32 quat_dot(Quat self,Quat rhs) {
+  return _mm_cvtss_f32(_quat_dot4(self.inner,rhs.inner));
+}
+
+/// Computes the length of `self`.
+inline
+const f32 quat_len(Quat self) {
+  return f32_sqrt(quat_dot(self,self));
+}
+
+/// Computes the squared length of `self`.
+///
+/// This is generally faster than `quat_len` as it avoids a square root operation.
+inline
+const f32 quat_len_squared(Quat self) {
+  return quat_dot(self,self);
+}
+
+/// Computes `1.0 / quat_len(self)`.
+///
+/// For valid results, `self` must _not_ be of length zero.
+inline
+const f32 quat_len_recip(Quat self) {
+  return 1.0F/quat_len(self);
+}
+
+/// Returns `self` normalized to length 1.0.
+///
+/// For valid results, `self` must _not_ be of length zero.
+///
+/// Panics
+///
+/// Will panic if the result is not finite when `cmeth_assert` is enabled.
+inline
+const Quat quat_normalize(Quat self) {
+  const __m128 len=_mm_sqrt_ps(_quat_dot4(self.inner,self.inner));
+  const Quat normalized=quat_from_m128(_mm_div_ps(self.inner,len));
+  cmeth_assert(quat_is_finite(normalized));
+  return normalized;
+}
+
+/// Returns `true` if, and only if, all elements are finite.
+/// If any element is either `NaN`, positive or negative infinity, this will return `false`.
+inline
+const bool quat_is_finite(Quat self) {
+  const __m128 inf=_mm_set1_ps(F32_INFINITY);
+  const __m128 abs=_mm_andnot_ps(_mm_set1_ps(-0.0F),self.inner);
+  return _mm_movemask_ps(_mm_cmplt_ps(abs,inf))==0xF;
+}
+
+/// Returns `true` if any elements are `NaN`.
+inline
+const bool quat_is_nan(Quat self) {
+  return _mm_movemask_ps(_mm_cmpunord_ps(self.inner,self.inner))!=0;
+}
+
+/// Returns whether `self` is length `1.0` or not.
+///
+/// Uses a precision threshold of approximately `1e-4`, like `vec3_is_normalized`.
+inline
+const bool quat_is_normalized(Quat self) {
+  return f32_abs(quat_len_squared(self)-1.0F)<=2e-4F;
+}
+
+/// Returns `true` if the rotation angle of `self` is below `0.002847` radians, in either
+/// sign convention of `w`.
+inline
+const bool quat_is_near_identity(Quat self) {
+  // Based on https://github.com/nfrechette/rtm `rtm::quat_near_identity`
+  const f32 threshold_angle=0.002847144345F;
+  const f32 positive_w_angle=_acos_approx_f32(f32_abs(quat_w(self)))*2.0F;
+  return positive_w_angle<threshold_angle;
+}
+
+/// Returns the angle (in radians) for the minimal rotation for transforming this
+/// quaternion into another.
+///
+/// Both quaternions must be normalized.
+///
+/// Panics
+///
+/// Will panic if `self` or `rhs` are not normalized when `cmeth_assert` is enabled.
+inline
+const f32 quat_angle_between(Quat self,Quat rhs) {
+  cmeth_assert(quat_is_normalized(self)&&quat_is_normalized(rhs));
+  return _acos_approx_f32(f32_abs(quat_dot(self,rhs)))*2.0F;
+}
+
+/// Returns true if the absolute difference of all elements between `self` and `rhs`
+/// is less than or equal to `max_abs_diff`.
+///
+/// This can be used to compare if two quaternions contain similar elements. It works
+/// best when comparing with a known value. The `max_abs_diff` that should be used used
+/// depends on the values being compared against.
+inline
+const bool quat_abs_diff_eq(Quat self,Quat rhs,f32 max_abs_diff) {
+  const __m128 abs_diff=_mm_andnot_ps(_mm_set1_ps(-0.0F),_mm_sub_ps(self.inner,rhs.inner));
+  return _mm_movemask_ps(_mm_cmple_ps(abs_diff,_mm_set1_ps(max_abs_diff)))==0xF;
+}
+
+/// Performs a normalized linear interpolation between `self` and `end` based on the value
+/// `s`.
+///
+/// When `s` is `0.0`, the result will be equal to `self`. When `s` is `1.0`, the result
+/// will be equal to `end`. `end` is negated first if that makes the path shorter, so the
+/// interpolation always takes the short way around.
+///
+/// Panics
+///
+/// Will panic if `self` or `end` are not normalized when `cmeth_assert` is enabled.
+inline
+const Quat quat_nlerp(Quat self,Quat end,f32 s) {
+  cmeth_assert(quat_is_normalized(self));
+  cmeth_assert(quat_is_normalized(end));
+  const __m128 dot=_quat_dot4(self.inner,end.inner);
+  // Flip the sign of `end` if the dot is negative.
+  const __m128 bias=_mm_and_ps(dot,_mm_set1_ps(-0.0F));
+  const __m128 end_biased=_mm_xor_ps(end.inner,bias);
+  const __m128 interpolated=_mm_add_ps(
+    _mm_mul_ps(_mm_sub_ps(end_biased,self.inner),_mm_set1_ps(s)),self.inner);
+  return quat_normalize(quat_from_m128(interpolated));
+}
+
+/// Performs a spherical linear interpolation between `self` and `end` based on the value
+/// `s`.
+///
+/// When `s` is `0.0`, the result will be equal to `self`. When `s` is `1.0`, the result
+/// will be equal to `end`. The angle comes from `_acos_approx_f32`; nearly parallel
+/// inputs fall back to `quat_nlerp`.
+///
+/// Panics
+///
+/// Will panic if `self` or `end` are not normalized when `cmeth_assert` is enabled.
+inline
+const Quat quat_slerp(Quat self,Quat end,f32 s) {
+  cmeth_assert(quat_is_normalized(self));
+  cmeth_assert(quat_is_normalized(end));
+  // Note that a rotation can be represented by two quaternions: `q` and `-q`. The slerp
+  // path between `q` and `end` will be different from the path between `-q` and `end`.
+  // One path will take the long way around and one will take the short way. In order to
+  // correct for this, the `dot` is negated and `end` flipped.
+  f32 dot=quat_dot(self,end);
+  if(dot<0.0F) {
+    end=quat_neg(end);
+    dot=-dot;
+  }
+  const f32 dot_threshold=1.0F-F32_EPSILON;
+  if(dot>dot_threshold) {
+    // `sin(theta)` is too close to zero to divide by; `self` and `end` are nearly
+    // parallel, so the straight line is as good as the arc.
+    return quat_nlerp(self,end,s);
+  }
+  const f32 theta=_acos_approx_f32(dot);
+  const f32 scale1=sinf(theta*(1.0F-s));
+  const f32 scale2=sinf(theta*s);
+  const f32 theta_sin=sinf(theta);
+  return quat_mul_f32(
+    quat_add_quat(quat_mul_f32(self,scale1),quat_mul_f32(end,scale2)),1.0F/theta_sin);
+}
+
+/// Multiplies a quaternion and a 3D vector, returning the rotated vector.
+///
+/// Panics
+///
+/// Will panic if `self` is not normalized when `cmeth_assert` is enabled.
+inline
+const Vec3 quat_mul_vec3(Quat self,Vec3 rhs) {
+  return vec3_from_vec3a(quat_mul_vec3a(self,vec3a_from_vec3(rhs)));
+}
+
+/// Multiplies a quaternion and a `Vec3A`, returning the rotated vector.
+///
+/// Panics
+///
+/// Will panic if `self` is not normalized when `cmeth_assert` is enabled.
+inline
+const Vec3A quat_mul_vec3a(Quat self,Vec3A rhs) {
+  cmeth_assert(quat_is_normalized(self));
+  // `v + 2w(b x v) + 2(b x (b x v))`, expanded to `v(w^2-b.b) + 2b(v.b) + 2w(b x v)`.
+  const f32 w=quat_w(self);
+  const Vec3A b=vec3a_from_m128(self.inner);
+  const f32 b2=vec3a_len_squared(b);
+  return vec3a_add(
+    vec3a_add(vec3a_mul_f32(rhs,w*w-b2),vec3a_mul_f32(b,vec3a_dot(rhs,b)*2.0F)),
+    vec3a_mul_f32(vec3a_cross(b,rhs),w*2.0F)
+  );
+}
+
+/// Multiplies two quaternions. If they each represent a rotation, the result will
+/// represent the combined rotation.
+///
+/// Note that due to floating point rounding the result may not be perfectly normalized.
+///
+/// Panics
+///
+/// Will panic if `self` or `rhs` are not normalized when `cmeth_assert` is enabled.
+inline
+const Quat quat_mul_quat(Quat self,Quat rhs) {
+  cmeth_assert(quat_is_normalized(self));
+  cmeth_assert(quat_is_normalized(rhs));
+  const __m128 a=self.inner;
+  const __m128 b=rhs.inner;
+  const __m128 ax=_mm_shuffle_ps(a,a,_MM_SHUFFLE(0,0,0,0));
+  const __m128 ay=_mm_shuffle_ps(a,a,_MM_SHUFFLE(1,1,1,1));
+  const __m128 az=_mm_shuffle_ps(a,a,_MM_SHUFFLE(2,2,2,2));
+  const __m128 aw=_mm_shuffle_ps(a,a,_MM_SHUFFLE(3,3,3,3));
+  // [w1x2, w1y2, w1z2, w1w2]
+  const __m128 t0=_mm_mul_ps(aw,b);
+  // [x1w2, -x1z2, x1y2, -x1x2]
+  const __m128 t1=_mm_xor_ps(_mm_mul_ps(ax,_mm_shuffle_ps(b,b,_MM_SHUFFLE(0,1,2,3))),
+    _quat_sign_mask(false,true,false,true));
+  // [y1z2, y1w2, -y1x2, -y1y2]
+  const __m128 t2=_mm_xor_ps(_mm_mul_ps(ay,_mm_shuffle_ps(b,b,_MM_SHUFFLE(1,0,3,2))),
+    _quat_sign_mask(false,false,true,true));
+  // [-z1y2, z1x2, z1w2, -z1z2]
+  const __m128 t3=_mm_xor_ps(_mm_mul_ps(az,_mm_shuffle_ps(b,b,_MM_SHUFFLE(2,3,0,1))),
+    _quat_sign_mask(true,false,false,true));
+  return quat_from_m128(_mm_add_ps(_mm_add_ps(t0,t1),_mm_add_ps(t2,t3)));
+}
+
+/// Adds two quaternions.
+///
+/// The sum is not guaranteed to be normalized.
+///
+/// Note that addition is not the same as combining the rotations represented by the two
+/// quaternions! That corresponds to multiplication.
+inline
+const Quat quat_add_quat(Quat self,Quat rhs) {
+  return quat_from_m128(_mm_add_ps(self.inner,rhs.inner));
+}
+
+/// Subtracts the `rhs` quaternion from `self`.
+///
+/// The difference is not guaranteed to be normalized.
+inline
+const Quat quat_sub_quat(Quat self,Quat rhs) {
+  return quat_from_m128(_mm_sub_ps(self.inner,rhs.inner));
+}
+
+/// Multiplies a quaternion by a scalar value.
+///
+/// The product is not guaranteed to be normalized.
+inline
+const Quat quat_mul_f32(Quat self,f32 rhs) {
+  return quat_from_m128(_mm_mul_ps(self.inner,_mm_set1_ps(rhs)));
+}
+
+/// Divides a quaternion by a scalar value.
+///
+/// The quotient is not guaranteed to be normalized.
+inline
+const Quat quat_div_f32(Quat self,f32 rhs) {
+  return quat_from_m128(_mm_div_ps(self.inner,_mm_set1_ps(rhs)));
+}
+
+/// Negates every element. `-q` represents the same rotation as `q`.
+inline
+const Quat quat_neg(Quat self) {
+  return quat_from_m128(_mm_xor_ps(self.inner,_mm_set1_ps(-0.0F)));
+}
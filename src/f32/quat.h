@@ -0,0 +1,77 @@
+#ifndef CMETH_F32_QUAT_H
+#define CMETH_F32_QUAT_H
+#include <emmintrin.h>
+#include "../prelude.h"
+#include "vec3.h"
+#include "vec3a.h"
+#include "mat3.h"
+
+
+/// A quaternion representing an orientation, stored as `x`, `y`, `z`, `w` in the lanes of
+/// a 16-byte aligned SSE2 register.
+///
+/// This quaternion is intended to be of unit length but may denormalize due to floating
+/// point "error creep" which can occur when successive quaternion operations are applied.
+typedef struct {
+  __m128 inner;
+} Quat;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const Quat quat_from_xyzw(f32 x,f32 y,f32 z,f32 w);
+CMETH_API const Quat quat_from_array(const f32 a[4]);
+CMETH_API void quat_write_to_slice(Quat self,f32* slice);
+CMETH_API const Quat quat_from_m128(__m128 v);
+CMETH_API const Vec3 quat_xyz(Quat self);
+CMETH_API const f32 quat_w(Quat self);
+CMETH_API const Quat quat_from_axis_angle(Vec3 axis,f32 angle);
+CMETH_API const Quat quat_from_scaled_axis(Vec3 v);
+CMETH_API const Quat quat_from_rotation_x(f32 angle);
+CMETH_API const Quat quat_from_rotation_y(f32 angle);
+CMETH_API const Quat quat_from_rotation_z(f32 angle);
+CMETH_API const Quat quat_from_mat3(Mat3 mat);
+CMETH_API const Mat3 mat3_from_quat(Quat rotation);
+CMETH_API const Quat quat_from_rotation_arc(Vec3 from,Vec3 to);
+CMETH_API void quat_to_axis_angle(Quat self,Vec3* axis,f32* angle);
+CMETH_API const Vec3 quat_to_scaled_axis(Quat self);
+CMETH_API const Quat quat_conjugate(Quat self);
+CMETH_API const Quat quat_inverse(Quat self);
+CMETH_API const f32 quat_dot(Quat self,Quat rhs);
+CMETH_API const f32 quat_len(Quat self);
+CMETH_API const f32 quat_len_squared(Quat self);
+CMETH_API const f32 quat_len_recip(Quat self);
+CMETH_API const Quat quat_normalize(Quat self);
+CMETH_API const bool quat_is_finite(Quat self);
+CMETH_API const bool quat_is_nan(Quat self);
+CMETH_API const bool quat_is_normalized(Quat self);
+CMETH_API const bool quat_is_near_identity(Quat self);
+CMETH_API const f32 quat_angle_between(Quat self,Quat rhs);
+CMETH_API const bool quat_abs_diff_eq(Quat self,Quat rhs,f32 max_abs_diff);
+CMETH_API const Quat quat_nlerp(Quat self,Quat end,f32 s);
+CMETH_API const Quat quat_slerp(Quat self,Quat end,f32 s);
+CMETH_API const Vec3 quat_mul_vec3(Quat self,Vec3 rhs);
+CMETH_API const Vec3A quat_mul_vec3a(Quat self,Vec3A rhs);
+CMETH_API const Quat quat_mul_quat(Quat self,Quat rhs);
+CMETH_API const Quat quat_add_quat(Quat self,Quat rhs);
+CMETH_API const Quat quat_sub_quat(Quat self,Quat rhs);
+CMETH_API const Quat quat_mul_f32(Quat self,f32 rhs);
+CMETH_API const Quat quat_div_f32(Quat self,f32 rhs);
+CMETH_API const Quat quat_neg(Quat self);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// The identity quaternion. Corresponds to no rotation.
+#define QUAT_IDENTITY quat_from_xyzw(0.0,0.0,0.0,1.0)
+
+/// All NaNs.
+#define QUAT_NAN quat_from_xyzw(F32_NAN,F32_NAN,F32_NAN,F32_NAN)
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "quat.c"
+#endif
+
+#endif
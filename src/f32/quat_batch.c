@@ -0,0 +1,283 @@
+// The rotation kernel builds its matrix with the inlined value-type API.
+#define CMETH_HEADER_ONLY
+#include <immintrin.h>
+#include "quat_batch.h"
+#include "affine3a_batch.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// `quat_nlerp_batch` and `quat_slerp_batch` have one lane-generic body in
+// `quat_batch_lanes.h`, built on GCC vector extensions and instantiated for 4 quaternions
+// (SSE2), 8 (AVX2+FMA) and 16 (AVX-512) at a time, like the `f32_*_batch` kernels. Each
+// tier transposes its `Quat`s into one register per element, so the dot products, the
+// `acos` and the three sines run on whole registers.
+//
+// The slerp angle uses the same polynomial as `_acos_approx_f32` and the sines an odd
+// Taylor polynomial exact to 6e-8 on `[0,pi/2]`, which covers every angle when `s` is in
+// [0,1]. Against `quat_slerp`, which takes its sines from libm, the results differ by at
+// most 4e-7 per element on normalized inputs.
+//
+// `quat_mul_vec3_batch` converts the rotation to a matrix once and goes through
+// `affine3a_transform_vectors`: 9 multiply-adds per point instead of the 18 of the
+// quaternion sandwich product.
+
+
+// The `acos` polynomial comes from `trig.c`, which `_acos_approx_f32` shares it with.
+
+// Taylor coefficients of `sin(x)/x-1` in `x^2`.
+static const f32 SIN_C1=-1.0f/6.0f;
+static const f32 SIN_C2=1.0f/120.0f;
+static const f32 SIN_C3=-1.0f/5040.0f;
+static const f32 SIN_C4=1.0f/362880.0f;
+static const f32 SIN_C5=-1.0f/39916800.0f;
+
+// Same as the cut-over in `quat_slerp`.
+static const f32 SLERP_DOT_THRESHOLD=1.0f-F32_EPSILON;
+
+
+static inline_always
+void _identity_to(f32* q) {
+  q[0]=0.0f;
+  q[1]=0.0f;
+  q[2]=0.0f;
+  q[3]=1.0f;
+}
+
+
+#define _PASTE(a,b) a##b
+#define _KERNEL(name,suffix) _PASTE(name,suffix)
+
+typedef f32 f32x4 __attribute__((vector_size(16)));
+typedef i32 i32x4 __attribute__((vector_size(16)));
+
+static inline_always
+void _load_quats_sse2(const f32* p,f32x4 v[4]) {
+  __m128 q0=_mm_loadu_ps(p),q1=_mm_loadu_ps(p+4),q2=_mm_loadu_ps(p+8),q3=_mm_loadu_ps(p+12);
+  _MM_TRANSPOSE4_PS(q0,q1,q2,q3);
+  v[0]=(f32x4)q0;
+  v[1]=(f32x4)q1;
+  v[2]=(f32x4)q2;
+  v[3]=(f32x4)q3;
+}
+
+static inline_always
+void _store_quats_sse2(f32* p,const f32x4 v[4]) {
+  __m128 q0=(__m128)v[0],q1=(__m128)v[1],q2=(__m128)v[2],q3=(__m128)v[3];
+  _MM_TRANSPOSE4_PS(q0,q1,q2,q3);
+  _mm_storeu_ps(p,q0);
+  _mm_storeu_ps(p+4,q1);
+  _mm_storeu_ps(p+8,q2);
+  _mm_storeu_ps(p+12,q3);
+}
+
+#define LANES 4
+#define F32V f32x4
+#define I32V i32x4
+#define TARGET
+#define SUFFIX _sse2
+#define SQRT(v) ((f32x4)_mm_sqrt_ps((__m128)(v)))
+#include "quat_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+#undef SQRT
+
+typedef f32 f32x8 __attribute__((vector_size(32)));
+typedef i32 i32x8 __attribute__((vector_size(32)));
+
+/// `_MM_TRANSPOSE4_PS` in both 128-bit halves of four registers.
+static inline_always target_avx2
+void _transpose4_avx2(__m256 r[4]) {
+  const __m256 t0=_mm256_unpacklo_ps(r[0],r[1]);
+  const __m256 t1=_mm256_unpacklo_ps(r[2],r[3]);
+  const __m256 t2=_mm256_unpackhi_ps(r[0],r[1]);
+  const __m256 t3=_mm256_unpackhi_ps(r[2],r[3]);
+  r[0]=_mm256_shuffle_ps(t0,t1,_MM_SHUFFLE(1,0,1,0));
+  r[1]=_mm256_shuffle_ps(t0,t1,_MM_SHUFFLE(3,2,3,2));
+  r[2]=_mm256_shuffle_ps(t2,t3,_MM_SHUFFLE(1,0,1,0));
+  r[3]=_mm256_shuffle_ps(t2,t3,_MM_SHUFFLE(3,2,3,2));
+}
+
+static inline_always target_avx2
+void _load_quats_avx2(const f32* p,f32x8 v[4]) {
+  // Register `k` holds quaternion `k` in its low half and `k+4` in its high half.
+  __m256 r[4];
+  for(usize k=0;k<4;k++) {
+    r[k]=_mm256_loadu2_m128(p+4*(k+4),p+4*k);
+  }
+  _transpose4_avx2(r);
+  for(usize k=0;k<4;k++) {
+    v[k]=(f32x8)r[k];
+  }
+}
+
+static inline_always target_avx2
+void _store_quats_avx2(f32* p,const f32x8 v[4]) {
+  __m256 r[4];
+  for(usize k=0;k<4;k++) {
+    r[k]=(__m256)v[k];
+  }
+  _transpose4_avx2(r);
+  for(usize k=0;k<4;k++) {
+    _mm256_storeu2_m128(p+4*(k+4),p+4*k,r[k]);
+  }
+}
+
+#define LANES 8
+#define F32V f32x8
+#define I32V i32x8
+#define TARGET target_avx2
+#define SUFFIX _avx2
+#define SQRT(v) ((f32x8)_mm256_sqrt_ps((__m256)(v)))
+#include "quat_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+#undef SQRT
+
+typedef f32 f32x16 __attribute__((vector_size(64)));
+typedef i32 i32x16 __attribute__((vector_size(64)));
+
+static inline_always target_avx512
+void _load_quats_avx512(const f32* p,f32x16 v[4]) {
+  const __m512 q0=_mm512_loadu_ps(p),q1=_mm512_loadu_ps(p+16);
+  const __m512 q2=_mm512_loadu_ps(p+32),q3=_mm512_loadu_ps(p+48);
+  // Every 4th element of two registers: `x` in the low 8 lanes and `y` in the high 8.
+  const __m512i xy=_mm512_setr_epi32(0,4,8,12,16,20,24,28,1,5,9,13,17,21,25,29);
+  const __m512i zw=_mm512_setr_epi32(2,6,10,14,18,22,26,30,3,7,11,15,19,23,27,31);
+  const __m512 xy_lo=_mm512_permutex2var_ps(q0,xy,q1),xy_hi=_mm512_permutex2var_ps(q2,xy,q3);
+  const __m512 zw_lo=_mm512_permutex2var_ps(q0,zw,q1),zw_hi=_mm512_permutex2var_ps(q2,zw,q3);
+  const __m512i lo=_mm512_setr_epi32(0,1,2,3,4,5,6,7,16,17,18,19,20,21,22,23);
+  const __m512i hi=_mm512_setr_epi32(8,9,10,11,12,13,14,15,24,25,26,27,28,29,30,31);
+  v[0]=(f32x16)_mm512_permutex2var_ps(xy_lo,lo,xy_hi);
+  v[1]=(f32x16)_mm512_permutex2var_ps(xy_lo,hi,xy_hi);
+  v[2]=(f32x16)_mm512_permutex2var_ps(zw_lo,lo,zw_hi);
+  v[3]=(f32x16)_mm512_permutex2var_ps(zw_lo,hi,zw_hi);
+}
+
+static inline_always target_avx512
+void _store_quats_avx512(f32* p,const f32x16 v[4]) {
+  const __m512i lo=_mm512_setr_epi32(0,1,2,3,4,5,6,7,16,17,18,19,20,21,22,23);
+  const __m512i hi=_mm512_setr_epi32(8,9,10,11,12,13,14,15,24,25,26,27,28,29,30,31);
+  const __m512 xy_lo=_mm512_permutex2var_ps((__m512)v[0],lo,(__m512)v[1]);
+  const __m512 xy_hi=_mm512_permutex2var_ps((__m512)v[0],hi,(__m512)v[1]);
+  const __m512 zw_lo=_mm512_permutex2var_ps((__m512)v[2],lo,(__m512)v[3]);
+  const __m512 zw_hi=_mm512_permutex2var_ps((__m512)v[2],hi,(__m512)v[3]);
+  // Quaternion `j` of a register is `x`, `y` at lanes `j`, `8+j` of the first source and
+  // `z`, `w` at the same lanes of the second.
+  const __m512i q_lo=_mm512_setr_epi32(0,8,16,24,1,9,17,25,2,10,18,26,3,11,19,27);
+  const __m512i q_hi=_mm512_setr_epi32(4,12,20,28,5,13,21,29,6,14,22,30,7,15,23,31);
+  _mm512_storeu_ps(p,_mm512_permutex2var_ps(xy_lo,q_lo,zw_lo));
+  _mm512_storeu_ps(p+16,_mm512_permutex2var_ps(xy_lo,q_hi,zw_lo));
+  _mm512_storeu_ps(p+32,_mm512_permutex2var_ps(xy_hi,q_lo,zw_hi));
+  _mm512_storeu_ps(p+48,_mm512_permutex2var_ps(xy_hi,q_hi,zw_hi));
+}
+
+#define LANES 16
+#define F32V f32x16
+#define I32V i32x16
+#define TARGET target_avx512
+#define SUFFIX _avx512
+#define SQRT(v) ((f32x16)_mm512_sqrt_ps((__m512)(v)))
+#include "quat_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+#undef SQRT
+
+
+static struct {
+  void (*nlerp)(const Quat*,const Quat*,f32,Quat*,usize);
+  void (*slerp)(const Quat*,const Quat*,f32,Quat*,usize);
+} _kernels={
+  .nlerp=_quat_nlerp_batch_sse2,
+  .slerp=_quat_slerp_batch_sse2,
+};
+
+__attribute__((constructor))
+static void _quat_batch_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.nlerp=_quat_nlerp_batch_avx512;
+      _kernels.slerp=_quat_slerp_batch_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.nlerp=_quat_nlerp_batch_avx2;
+      _kernels.slerp=_quat_slerp_batch_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Computes `out[i]=quat_mul_vec3(*self,in[i])` for every `i<n`.
+///
+/// `out` may be the same array as `in`, but the two must not otherwise overlap.
+///
+/// Panics
+///
+/// Will panic if `self` is not normalized when `cmeth_assert` is enabled.
+void quat_mul_vec3_batch(const Quat* self,const Vec3* in,Vec3* out,usize n) {
+  const Affine3A rotation=affine3a_from_mat3(mat3_from_quat(*self));
+  affine3a_transform_vectors(&rotation,in,out,n);
+}
+
+/// Works like `quat_mul_vec3_batch`, on the threads of the `cmeth_parallel_for` pool.
+/// The results are the same bit for bit.
+///
+/// Panics
+///
+/// Will panic if `self` is not normalized when `cmeth_assert` is enabled.
+void quat_mul_vec3_batch_parallel(const Quat* self,const Vec3* in,Vec3* out,usize n) {
+  const Affine3A rotation=affine3a_from_mat3(mat3_from_quat(*self));
+  affine3a_transform_vectors_parallel(&rotation,in,out,n);
+}
+
+/// Computes `out[i]=quat_nlerp(from[i],to[i],s)` for every `i<n`. `out` may alias `from`
+/// or `to`.
+void quat_nlerp_batch(const Quat* from,const Quat* to,f32 s,Quat* out,usize n) {
+  _kernels.nlerp(from,to,s,out,n);
+}
+
+/// Computes `out[i]=quat_slerp(from[i],to[i],s)` for every `i<n`, for `s` in [0,1]. `out`
+/// may alias `from` or `to`.
+///
+/// Unlike `quat_slerp`, inputs are not checked for being normalized.
+void quat_slerp_batch(const Quat* from,const Quat* to,f32 s,Quat* out,usize n) {
+  _kernels.slerp(from,to,s,out,n);
+}
+
+
+/// The arrays of a `_parallel` call, which every range offsets by its start.
+typedef struct {
+  void (*lerp)(const Quat*,const Quat*,f32,Quat*,usize);
+  const Quat* from;
+  const Quat* to;
+  f32 s;
+  Quat* out;
+} _QuatBatchJob;
+
+static void _quat_batch_lerp_range(void* ctx,usize begin,usize end) {
+  const _QuatBatchJob* job=ctx;
+  job->lerp(job->from+begin,job->to+begin,job->s,job->out+begin,end-begin);
+}
+
+/// Works like `quat_nlerp_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void quat_nlerp_batch_parallel(const Quat* from,const Quat* to,f32 s,Quat* out,usize n) {
+  _QuatBatchJob job={_kernels.nlerp,from,to,s,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_quat_batch_lerp_range,&job);
+}
+
+/// Works like `quat_slerp_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void quat_slerp_batch_parallel(const Quat* from,const Quat* to,f32 s,Quat* out,usize n) {
+  _QuatBatchJob job={_kernels.slerp,from,to,s,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_quat_batch_lerp_range,&job);
+}
@@ -0,0 +1,21 @@
+#ifndef CMETH_F32_QUAT_BATCH_H
+#define CMETH_F32_QUAT_BATCH_H
+#include "../prelude.h"
+#include "vec3.h"
+#include "quat.h"
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+void quat_mul_vec3_batch(const Quat* self,const Vec3* in,Vec3* out,usize n);
+void quat_mul_vec3_batch_parallel(const Quat* self,const Vec3* in,Vec3* out,usize n);
+void quat_nlerp_batch(const Quat* from,const Quat* to,f32 s,Quat* out,usize n);
+void quat_slerp_batch(const Quat* from,const Quat* to,f32 s,Quat* out,usize n);
+void quat_nlerp_batch_parallel(const Quat* from,const Quat* to,f32 s,Quat* out,usize n);
+void quat_slerp_batch_parallel(const Quat* from,const Quat* to,f32 s,Quat* out,usize n);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,123 @@
+// Lane-generic bodies of the `quat_*_batch` kernels.
+//
+// Included once per tier by `quat_batch.c`, which defines beforehand:
+//
+// - `LANES`: quaternions per vector.
+// - `F32V`, `I32V`: GCC vector types of `LANES` `f32`/`i32` elements.
+// - `TARGET`: function attributes of the tier (empty for the baseline).
+// - `SUFFIX`: appended to every kernel name.
+// - `SQRT(v)`: lane-wise square root of an `F32V`.
+// - `K(_load_quats)(p,v)` and `K(_store_quats)(p,v)`: transpose `LANES` consecutive
+//   `Quat`s at `p` into `v[4]`, one vector per element, and back.
+//
+// The last `n%LANES` quaternions are copied into an identity-padded buffer, so every
+// quaternion goes through the same arithmetic.
+
+#define K(name) _KERNEL(name,SUFFIX)
+
+
+static inline_always TARGET
+const F32V K(_select)(I32V mask,F32V a,F32V b) {
+  return (F32V)(((I32V)a & mask) | ((I32V)b & ~mask));
+}
+
+/// `acos(x)` for `0<=x<=1`, the same polynomial as `_acos_approx_f32`.
+static inline_always TARGET
+const F32V K(_acos_approx)(F32V x) {
+  const F32V root=SQRT(1.0F-x);
+  const F32V poly=((((((ACOS_C7*x+ACOS_C6)*x+ACOS_C5)*x+ACOS_C4)*x+ACOS_C3)*x+ACOS_C2)*x
+    +ACOS_C1)*x+ACOS_C0;
+  return poly*root;
+}
+
+/// `sin(x)` for `0<=x<=pi/2`, without range reduction.
+static inline_always TARGET
+const F32V K(_sin_quadrant)(F32V x) {
+  const F32V z=x*x;
+  return ((((SIN_C5*z+SIN_C4)*z+SIN_C3)*z+SIN_C2)*z+SIN_C1)*z*x+x;
+}
+
+/// Normalized lerp of `a` towards `b`, where `b` is already on the short path.
+static inline_always TARGET
+void K(_nlerp)(const F32V a[4],const F32V b[4],F32V s,F32V out[4]) {
+  F32V len_sq={0};
+  for(usize k=0;k<4;k++) {
+    out[k]=(b[k]-a[k])*s+a[k];
+    len_sq+=out[k]*out[k];
+  }
+  const F32V len_recip=1.0F/SQRT(len_sq);
+  for(usize k=0;k<4;k++) {
+    out[k]*=len_recip;
+  }
+}
+
+/// Flips `b` onto the short path from `a` and returns `|dot(a,b)|`.
+static inline_always TARGET
+const F32V K(_shortest)(const F32V a[4],F32V b[4]) {
+  const F32V dot=a[0]*b[0]+a[1]*b[1]+a[2]*b[2]+a[3]*b[3];
+  const I32V sign=(I32V)dot & (i32)0x80000000;
+  for(usize k=0;k<4;k++) {
+    b[k]=(F32V)((I32V)b[k] ^ sign);
+  }
+  return (F32V)((I32V)dot & 0x7fffffff);
+}
+
+static inline_always TARGET
+void K(_nlerp_lanes)(const F32V a[4],F32V b[4],F32V s,F32V out[4]) {
+  K(_shortest)(a,b);
+  K(_nlerp)(a,b,s,out);
+}
+
+static inline_always TARGET
+void K(_slerp_lanes)(const F32V a[4],F32V b[4],F32V s,F32V out[4]) {
+  const F32V dot=K(_shortest)(a,b);
+  F32V near[4];
+  K(_nlerp)(a,b,s,near);
+  const F32V theta=K(_acos_approx)(dot);
+  const F32V scale1=K(_sin_quadrant)(theta*(1.0F-s));
+  const F32V scale2=K(_sin_quadrant)(theta*s);
+  const F32V theta_sin_recip=1.0F/K(_sin_quadrant)(theta);
+  // Same cut-over as `quat_slerp`: nearly parallel lanes take the normalized lerp.
+  const I32V parallel=dot>SLERP_DOT_THRESHOLD;
+  for(usize k=0;k<4;k++) {
+    out[k]=K(_select)(parallel,near[k],(a[k]*scale1+b[k]*scale2)*theta_sin_recip);
+  }
+}
+
+#define _QUAT_BATCH_KERNEL(name,lanes_fn) \
+  static TARGET \
+  void K(name)(const Quat* from,const Quat* to,f32 s,Quat* out,usize n) { \
+    const F32V sv=(F32V){0}+s; \
+    for(usize i=0;i<n;i+=LANES) { \
+      const usize rem=n-i; \
+      const f32* pa=(const f32*)(from+i); \
+      const f32* pb=(const f32*)(to+i); \
+      f32* po=(f32*)(out+i); \
+      f32 pad_a[4*LANES],pad_b[4*LANES],pad_o[4*LANES]; \
+      if(rem<LANES) { \
+        for(usize k=0;k<LANES;k++) { \
+          _identity_to(pad_a+4*k); \
+          _identity_to(pad_b+4*k); \
+        } \
+        __builtin_memcpy(pad_a,pa,rem*sizeof(Quat)); \
+        __builtin_memcpy(pad_b,pb,rem*sizeof(Quat)); \
+        pa=pad_a; \
+        pb=pad_b; \
+        po=pad_o; \
+      } \
+      F32V a[4],b[4],o[4]; \
+      K(_load_quats)(pa,a); \
+      K(_load_quats)(pb,b); \
+      lanes_fn(a,b,sv,o); \
+      K(_store_quats)(po,o); \
+      if(rem<LANES) { \
+        __builtin_memcpy(out+i,pad_o,rem*sizeof(Quat)); \
+      } \
+    } \
+  }
+
+_QUAT_BATCH_KERNEL(_quat_nlerp_batch,K(_nlerp_lanes))
+_QUAT_BATCH_KERNEL(_quat_slerp_batch,K(_slerp_lanes))
+
+#undef _QUAT_BATCH_KERNEL
+#undef K
@@ -0,0 +1,85 @@
+#include "ray.h"
+#include "math_impl.h"
+#include "prelude.h"
+
+
+/// Clips `[*t_min,*t_max]` to the slab between the planes at `near` and `far` on one axis.
+///
+/// A zero direction element has an infinite reciprocal, and an origin exactly on one of
+/// the planes then gives `0*inf=NaN`. The comparisons are ordered so a `NaN` leaves the
+/// interval unchanged, which counts the origin as inside that slab.
+static inline_always
+void _ray_clip_slab(f32 near,f32 far,f32 origin,f32 inv_dir,f32* t_min,f32* t_max) {
+  const f32 t_near=(near-origin)*inv_dir;
+  const f32 t_far=(far-origin)*inv_dir;
+  *t_min=t_near>*t_min? t_near : *t_min;
+  *t_max=t_far<*t_max? t_far : *t_max;
+}
+
+
+/// Creates a ray from `origin` along `dir`, for `t` in `[0,F32_INFINITY]`.
+///
+/// `dir` does not need to be normalized; `t` is measured in multiples of it. Zero elements
+/// are allowed and give infinite reciprocals.
+inline
+const Ray ray_new(Vec3 origin,Vec3 dir) {
+  return ray_new_range(origin,dir,0.0F,F32_INFINITY);
+}
+
+/// Creates a ray from `origin` along `dir`, for `t` in `[t_min,t_max]`.
+inline
+const Ray ray_new_range(Vec3 origin,Vec3 dir,f32 t_min,f32 t_max) {
+  const Vec3 inv_dir=vec3_recip(dir);
+  const Ray ray={
+    .origin=origin,
+    .t_min=t_min,
+    .dir=dir,
+    .t_max=t_max,
+    .inv_dir=inv_dir,
+    .sign=vec3_is_negative_bitmask(inv_dir)
+  };
+  return ray;
+}
+
+/// Returns the point `origin+t*dir`.
+inline
+const Vec3 ray_at(Ray self,f32 t) {
+  return vec3_add(self.origin,vec3_mul_f32(self.dir,t));
+}
+
+/// Returns `true` if, and only if, all elements of `origin` and `dir` are finite. Rays
+/// that are not finite never hit anything.
+inline
+const bool ray_is_finite(Ray self) {
+  return vec3_is_finite(self.origin) && vec3_is_finite(self.dir);
+}
+
+/// Returns the `t` at which `self` enters `aabb`, or `F32_INFINITY` if it misses.
+///
+/// The entry point is clamped to `t_min`, so a ray starting inside the box hits it at
+/// `t_min`. Touching an edge or a face counts as a hit. Empty boxes, including those with
+/// a `NaN` corner, and rays for which `ray_is_finite` is `false` never hit. A box first
+/// reached at `t=F32_INFINITY` is reported as missed.
+///
+/// This is the slab test with the `sign` bits picking the near and far corner on each
+/// axis, so an empty box never turns into a hit by swapping its corners. The batched
+/// kernels of `ray_batch.h` do the same arithmetic and return the same values, except that
+/// an entry distance of zero can come back as `-0.0` from one and `0.0` from the other.
+inline
+const f32 ray_intersect_aabb(Ray self,Aabb aabb) {
+  if(!ray_is_finite(self) || aabb_is_empty(aabb)) {
+    return F32_INFINITY;
+  }
+  f32 t_min=self.t_min;
+  f32 t_max=self.t_max;
+  const bool neg_x=self.sign&1;
+  const bool neg_y=(self.sign>>1)&1;
+  const bool neg_z=(self.sign>>2)&1;
+  _ray_clip_slab(neg_x? aabb.max.x : aabb.min.x,neg_x? aabb.min.x : aabb.max.x,
+    self.origin.x,self.inv_dir.x,&t_min,&t_max);
+  _ray_clip_slab(neg_y? aabb.max.y : aabb.min.y,neg_y? aabb.min.y : aabb.max.y,
+    self.origin.y,self.inv_dir.y,&t_min,&t_max);
+  _ray_clip_slab(neg_z? aabb.max.z : aabb.min.z,neg_z? aabb.min.z : aabb.max.z,
+    self.origin.z,self.inv_dir.z,&t_min,&t_max);
+  return t_min<=t_max? t_min : F32_INFINITY;
+}
@@ -0,0 +1,43 @@
+#ifndef CMETH_F32_RAY_H
+#define CMETH_F32_RAY_H
+#include "../prelude.h"
+#include "vec3.h"
+#include "aabb.h"
+
+
+/// A half-line `origin+t*dir` restricted to `t_min<=t<=t_max`, with the reciprocal of its
+/// direction and the sign of each direction element precomputed for slab tests.
+///
+/// `dir`, `inv_dir` and `sign` must stay consistent, so change the direction only through
+/// `ray_new` or `ray_new_range`. `t_min` and `t_max` may be narrowed directly, e.g. to the
+/// closest hit found so far.
+///
+/// The layout is three 16-byte rows, which the packet kernels of `ray_batch.h` transpose
+/// with whole-register loads.
+typedef struct {
+  Vec3 origin;
+  f32 t_min;
+  Vec3 dir;
+  f32 t_max;
+  Vec3 inv_dir;
+  u32 sign;
+} Ray;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const Ray ray_new(Vec3 origin,Vec3 dir);
+CMETH_API const Ray ray_new_range(Vec3 origin,Vec3 dir,f32 t_min,f32 t_max);
+CMETH_API const Vec3 ray_at(Ray self,f32 t);
+CMETH_API const bool ray_is_finite(Ray self);
+CMETH_API const f32 ray_intersect_aabb(Ray self,Aabb aabb);
+#ifdef _cplusplus
+}
+#endif
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "ray.c"
+#endif
+
+#endif
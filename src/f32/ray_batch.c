@@ -0,0 +1,299 @@
+// The kernels inline the value-type API instead of calling back into the archive.
+#define CMETH_HEADER_ONLY
+#include <immintrin.h>
+#include "ray_batch.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// `ray_intersect_aabbs` tests one ray against a packet of boxes and `aabb_intersect_rays`
+// one box against a packet of rays. Both have one lane-generic body in `ray_batch_lanes.h`,
+// instantiated for 4 elements (SSE2), 8 (AVX2) and 16 (AVX-512) at a time, like the
+// `quat_*_batch` kernels.
+//
+// The bodies do the slab test of `ray_intersect_aabb` with the same operations in the same
+// order and no FMA, so every hit and miss and every entry distance matches the scalar
+// function, though an entry distance of zero can differ in sign: the min and max lanes
+// pick between `0.0` and `-0.0` by operand order. The results compare equal either way,
+// which keeps traversal decisions independent of the CPU tier.
+//
+// `Aabb`s are 24-byte AoS and `Ray`s 48-byte AoS. Each tier transposes them with full
+// register loads and in-register shuffles; the AVX2 and AVX-512 box loads reuse the blend
+// and two-source permute schemes of `affine3a_transform_points`, since 4 (8) boxes are 8
+// (16) `Vec3`s.
+
+
+#define _PASTE(a,b) a##b
+#define _KERNEL(name,suffix) _PASTE(name,suffix)
+
+typedef f32 f32x4 __attribute__((vector_size(16)));
+typedef i32 i32x4 __attribute__((vector_size(16)));
+
+static inline_always
+void _load_boxes_sse2(const f32* p,f32x4 lo[3],f32x4 hi[3]) {
+  // Rows from the start of a box hold `min` and `max.x`, rows from its third element
+  // `min.z` and `max`, so the last box is not read past its end.
+  __m128 a0=_mm_loadu_ps(p),a1=_mm_loadu_ps(p+6),a2=_mm_loadu_ps(p+12),a3=_mm_loadu_ps(p+18);
+  __m128 b0=_mm_loadu_ps(p+2),b1=_mm_loadu_ps(p+8),b2=_mm_loadu_ps(p+14),b3=_mm_loadu_ps(p+20);
+  _MM_TRANSPOSE4_PS(a0,a1,a2,a3);
+  _MM_TRANSPOSE4_PS(b0,b1,b2,b3);
+  lo[0]=(f32x4)a0;
+  lo[1]=(f32x4)a1;
+  lo[2]=(f32x4)a2;
+  hi[0]=(f32x4)b1;
+  hi[1]=(f32x4)b2;
+  hi[2]=(f32x4)b3;
+}
+
+static inline_always
+void _load_rays_sse2(const f32* p,f32x4 row[12]) {
+  for(usize g=0;g<3;g++) {
+    __m128 r0=_mm_loadu_ps(p+4*g),r1=_mm_loadu_ps(p+12+4*g);
+    __m128 r2=_mm_loadu_ps(p+24+4*g),r3=_mm_loadu_ps(p+36+4*g);
+    _MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+    row[4*g]=(f32x4)r0;
+    row[4*g+1]=(f32x4)r1;
+    row[4*g+2]=(f32x4)r2;
+    row[4*g+3]=(f32x4)r3;
+  }
+}
+
+#define LANES 4
+#define F32V f32x4
+#define I32V i32x4
+#define TARGET
+#define SUFFIX _sse2
+#include "ray_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x8 __attribute__((vector_size(32)));
+typedef i32 i32x8 __attribute__((vector_size(32)));
+
+static inline_always target_avx2
+void _load_boxes_avx2(const f32* p,f32x8 lo[3],f32x8 hi[3]) {
+  // Each half is 4 boxes, or 8 `Vec3`s in three registers. The blends gather one element
+  // of every `Vec3` and the permutes order it as the four `min`s, then the four `max`s.
+  const __m256i x_order=_mm256_setr_epi32(0,6,4,2,3,1,7,5);
+  const __m256i y_order=_mm256_setr_epi32(1,7,5,3,4,2,0,6);
+  const __m256i z_order=_mm256_setr_epi32(2,0,6,4,5,3,1,7);
+  __m256 x[2],y[2],z[2];
+  for(usize h=0;h<2;h++) {
+    const __m256 v0=_mm256_loadu_ps(p+24*h);
+    const __m256 v1=_mm256_loadu_ps(p+24*h+8);
+    const __m256 v2=_mm256_loadu_ps(p+24*h+16);
+    x[h]=_mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v0,v1,0x92),v2,0x24),x_order);
+    y[h]=_mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v2,v0,0x92),v1,0x24),y_order);
+    z[h]=_mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v1,v2,0x92),v0,0x24),z_order);
+  }
+  lo[0]=(f32x8)_mm256_permute2f128_ps(x[0],x[1],0x20);
+  lo[1]=(f32x8)_mm256_permute2f128_ps(y[0],y[1],0x20);
+  lo[2]=(f32x8)_mm256_permute2f128_ps(z[0],z[1],0x20);
+  hi[0]=(f32x8)_mm256_permute2f128_ps(x[0],x[1],0x31);
+  hi[1]=(f32x8)_mm256_permute2f128_ps(y[0],y[1],0x31);
+  hi[2]=(f32x8)_mm256_permute2f128_ps(z[0],z[1],0x31);
+}
+
+/// `_MM_TRANSPOSE4_PS` in both 128-bit halves of four registers.
+static inline_always target_avx2
+void _transpose4_avx2(__m256 r[4]) {
+  const __m256 t0=_mm256_unpacklo_ps(r[0],r[1]);
+  const __m256 t1=_mm256_unpacklo_ps(r[2],r[3]);
+  const __m256 t2=_mm256_unpackhi_ps(r[0],r[1]);
+  const __m256 t3=_mm256_unpackhi_ps(r[2],r[3]);
+  r[0]=_mm256_shuffle_ps(t0,t1,_MM_SHUFFLE(1,0,1,0));
+  r[1]=_mm256_shuffle_ps(t0,t1,_MM_SHUFFLE(3,2,3,2));
+  r[2]=_mm256_shuffle_ps(t2,t3,_MM_SHUFFLE(1,0,1,0));
+  r[3]=_mm256_shuffle_ps(t2,t3,_MM_SHUFFLE(3,2,3,2));
+}
+
+static inline_always target_avx2
+void _load_rays_avx2(const f32* p,f32x8 row[12]) {
+  // Register `k` holds a row of ray `k` in its low half and of ray `k+4` in its high half.
+  for(usize g=0;g<3;g++) {
+    __m256 r[4];
+    for(usize k=0;k<4;k++) {
+      r[k]=_mm256_loadu2_m128(p+12*(k+4)+4*g,p+12*k+4*g);
+    }
+    _transpose4_avx2(r);
+    for(usize k=0;k<4;k++) {
+      row[4*g+k]=(f32x8)r[k];
+    }
+  }
+}
+
+#define LANES 8
+#define F32V f32x8
+#define I32V i32x8
+#define TARGET target_avx2
+#define SUFFIX _avx2
+#include "ray_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x16 __attribute__((vector_size(64)));
+typedef i32 i32x16 __attribute__((vector_size(64)));
+
+static inline_always target_avx512
+void _load_boxes_avx512(const f32* p,f32x16 lo[3],f32x16 hi[3]) {
+  // Each half is 8 boxes in three registers. The first permute takes what lies in `v0`
+  // and `v1`, the second fills in from `v2`, ordered as the eight `min`s, then the eight
+  // `max`s.
+  const __m512i x_lo=_mm512_setr_epi32(0,6,12,18,24,30,0,0,3,9,15,21,27,0,0,0);
+  const __m512i x_hi=_mm512_setr_epi32(0,1,2,3,4,5,20,26,8,9,10,11,12,17,23,29);
+  const __m512i y_lo=_mm512_setr_epi32(1,7,13,19,25,31,0,0,4,10,16,22,28,0,0,0);
+  const __m512i y_hi=_mm512_setr_epi32(0,1,2,3,4,5,21,27,8,9,10,11,12,18,24,30);
+  const __m512i z_lo=_mm512_setr_epi32(2,8,14,20,26,0,0,0,5,11,17,23,29,0,0,0);
+  const __m512i z_hi=_mm512_setr_epi32(0,1,2,3,4,16,22,28,8,9,10,11,12,19,25,31);
+  __m512 x[2],y[2],z[2];
+  for(usize h=0;h<2;h++) {
+    const __m512 v0=_mm512_loadu_ps(p+48*h);
+    const __m512 v1=_mm512_loadu_ps(p+48*h+16);
+    const __m512 v2=_mm512_loadu_ps(p+48*h+32);
+    x[h]=_mm512_permutex2var_ps(_mm512_permutex2var_ps(v0,x_lo,v1),x_hi,v2);
+    y[h]=_mm512_permutex2var_ps(_mm512_permutex2var_ps(v0,y_lo,v1),y_hi,v2);
+    z[h]=_mm512_permutex2var_ps(_mm512_permutex2var_ps(v0,z_lo,v1),z_hi,v2);
+  }
+  lo[0]=(f32x16)_mm512_shuffle_f32x4(x[0],x[1],_MM_SHUFFLE(1,0,1,0));
+  lo[1]=(f32x16)_mm512_shuffle_f32x4(y[0],y[1],_MM_SHUFFLE(1,0,1,0));
+  lo[2]=(f32x16)_mm512_shuffle_f32x4(z[0],z[1],_MM_SHUFFLE(1,0,1,0));
+  hi[0]=(f32x16)_mm512_shuffle_f32x4(x[0],x[1],_MM_SHUFFLE(3,2,3,2));
+  hi[1]=(f32x16)_mm512_shuffle_f32x4(y[0],y[1],_MM_SHUFFLE(3,2,3,2));
+  hi[2]=(f32x16)_mm512_shuffle_f32x4(z[0],z[1],_MM_SHUFFLE(3,2,3,2));
+}
+
+static inline_always target_avx512
+void _load_rays_avx512(const f32* p,f32x16 row[12]) {
+  // Register `k` holds a row of rays `k`, `k+4`, `k+8` and `k+12` in its four 128-bit
+  // lanes, which the in-lane unpacks and shuffles transpose like `_MM_TRANSPOSE4_PS`.
+  for(usize g=0;g<3;g++) {
+    __m512 r[4];
+    for(usize k=0;k<4;k++) {
+      const f32* q=p+12*k+4*g;
+      const __m256 low=_mm256_loadu2_m128(q+48,q);
+      const __m256 high=_mm256_loadu2_m128(q+144,q+96);
+      r[k]=_mm512_insertf32x8(_mm512_castps256_ps512(low),high,1);
+    }
+    const __m512 t0=_mm512_unpacklo_ps(r[0],r[1]);
+    const __m512 t1=_mm512_unpacklo_ps(r[2],r[3]);
+    const __m512 t2=_mm512_unpackhi_ps(r[0],r[1]);
+    const __m512 t3=_mm512_unpackhi_ps(r[2],r[3]);
+    row[4*g]=(f32x16)_mm512_shuffle_ps(t0,t1,_MM_SHUFFLE(1,0,1,0));
+    row[4*g+1]=(f32x16)_mm512_shuffle_ps(t0,t1,_MM_SHUFFLE(3,2,3,2));
+    row[4*g+2]=(f32x16)_mm512_shuffle_ps(t2,t3,_MM_SHUFFLE(1,0,1,0));
+    row[4*g+3]=(f32x16)_mm512_shuffle_ps(t2,t3,_MM_SHUFFLE(3,2,3,2));
+  }
+}
+
+#define LANES 16
+#define F32V f32x16
+#define I32V i32x16
+#define TARGET target_avx512
+#define SUFFIX _avx512
+#include "ray_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+
+static struct {
+  usize (*ray_intersect_aabbs)(const Ray*,const Aabb*,f32*,usize);
+  usize (*aabb_intersect_rays)(const Aabb*,const Ray*,f32*,usize);
+} _kernels={
+  .ray_intersect_aabbs=_ray_intersect_aabbs_sse2,
+  .aabb_intersect_rays=_aabb_intersect_rays_sse2,
+};
+
+__attribute__((constructor))
+static void _ray_batch_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.ray_intersect_aabbs=_ray_intersect_aabbs_avx512;
+      _kernels.aabb_intersect_rays=_aabb_intersect_rays_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.ray_intersect_aabbs=_ray_intersect_aabbs_avx2;
+      _kernels.aabb_intersect_rays=_aabb_intersect_rays_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+static inline_always
+usize _ray_batch_miss_all(f32* t_hit,usize n) {
+  for(usize i=0;i<n;i++) {
+    t_hit[i]=F32_INFINITY;
+  }
+  return 0;
+}
+
+
+/// Computes `t_hit[i]=ray_intersect_aabb(*self,boxes[i])` for every `i<n` and returns the
+/// number of boxes hit.
+usize ray_intersect_aabbs(const Ray* self,const Aabb* boxes,f32* t_hit,usize n) {
+  if(!ray_is_finite(*self)) {
+    return _ray_batch_miss_all(t_hit,n);
+  }
+  return _kernels.ray_intersect_aabbs(self,boxes,t_hit,n);
+}
+
+/// Computes `t_hit[i]=ray_intersect_aabb(rays[i],*self)` for every `i<n` and returns the
+/// number of rays that hit.
+usize aabb_intersect_rays(const Aabb* self,const Ray* rays,f32* t_hit,usize n) {
+  if(aabb_is_empty(*self)) {
+    return _ray_batch_miss_all(t_hit,n);
+  }
+  return _kernels.aabb_intersect_rays(self,rays,t_hit,n);
+}
+
+
+typedef struct {
+  const Ray* ray;
+  const Aabb* boxes;
+  const Aabb* aabb;
+  const Ray* rays;
+  f32* t_hit;
+  usize hits;
+} _RayBatchJob;
+
+static void _ray_intersect_aabbs_range(void* ctx,usize begin,usize end) {
+  _RayBatchJob* job=ctx;
+  const usize hits=_kernels.ray_intersect_aabbs(job->ray,job->boxes+begin,job->t_hit+begin,end-begin);
+  __atomic_fetch_add(&job->hits,hits,__ATOMIC_RELAXED);
+}
+
+static void _aabb_intersect_rays_range(void* ctx,usize begin,usize end) {
+  _RayBatchJob* job=ctx;
+  const usize hits=_kernels.aabb_intersect_rays(job->aabb,job->rays+begin,job->t_hit+begin,end-begin);
+  __atomic_fetch_add(&job->hits,hits,__ATOMIC_RELAXED);
+}
+
+/// Works like `ray_intersect_aabbs`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+usize ray_intersect_aabbs_parallel(const Ray* self,const Aabb* boxes,f32* t_hit,usize n) {
+  if(!ray_is_finite(*self)) {
+    return _ray_batch_miss_all(t_hit,n);
+  }
+  _RayBatchJob job={.ray=self,.boxes=boxes,.t_hit=t_hit,.hits=0};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_ray_intersect_aabbs_range,&job);
+  return job.hits;
+}
+
+/// Works like `aabb_intersect_rays`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+usize aabb_intersect_rays_parallel(const Aabb* self,const Ray* rays,f32* t_hit,usize n) {
+  if(aabb_is_empty(*self)) {
+    return _ray_batch_miss_all(t_hit,n);
+  }
+  _RayBatchJob job={.aabb=self,.rays=rays,.t_hit=t_hit,.hits=0};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_aabb_intersect_rays_range,&job);
+  return job.hits;
+}
@@ -0,0 +1,19 @@
+#ifndef CMETH_F32_RAY_BATCH_H
+#define CMETH_F32_RAY_BATCH_H
+#include "../prelude.h"
+#include "aabb.h"
+#include "ray.h"
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+usize ray_intersect_aabbs(const Ray* self,const Aabb* boxes,f32* t_hit,usize n);
+usize aabb_intersect_rays(const Aabb* self,const Ray* rays,f32* t_hit,usize n);
+usize ray_intersect_aabbs_parallel(const Ray* self,const Aabb* boxes,f32* t_hit,usize n);
+usize aabb_intersect_rays_parallel(const Aabb* self,const Ray* rays,f32* t_hit,usize n);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,128 @@
+// Lane-generic bodies of the `ray_batch.h` kernels.
+//
+// Included once per tier by `ray_batch.c`, which defines beforehand:
+//
+// - `LANES`: boxes or rays per vector.
+// - `F32V`, `I32V`: GCC vector types of `LANES` `f32`/`i32` elements.
+// - `TARGET`: function attributes of the tier (empty for the baseline).
+// - `SUFFIX`: appended to every kernel name.
+// - `K(_load_boxes)(p,lo,hi)`: transposes `LANES` consecutive `Aabb`s at `p` into
+//   `lo[3]` and `hi[3]`, one vector per corner element.
+// - `K(_load_rays)(p,row)`: transposes `LANES` consecutive `Ray`s at `p` into `row[12]`,
+//   one vector per element of their three 16-byte rows.
+//
+// The last `n%LANES` boxes or rays are copied into a buffer padded with `NaN`s, which never
+// hit, so every element goes through the same arithmetic.
+
+#define K(name) _KERNEL(name,SUFFIX)
+
+
+static inline_always TARGET
+const F32V K(_select)(I32V mask,F32V a,F32V b) {
+  return (F32V)(((I32V)a & mask) | ((I32V)b & ~mask));
+}
+
+/// `_ray_clip_slab` in every lane.
+static inline_always TARGET
+void K(_clip_slab)(F32V near,F32V far,F32V origin,F32V inv_dir,F32V* t_min,F32V* t_max) {
+  const F32V t_near=(near-origin)*inv_dir;
+  const F32V t_far=(far-origin)*inv_dir;
+  *t_min=K(_select)(t_near>*t_min,t_near,*t_min);
+  *t_max=K(_select)(t_far<*t_max,t_far,*t_max);
+}
+
+/// Stores the entry distances of the lanes in `hit` and `F32_INFINITY` elsewhere, and
+/// counts the hits into `hits`.
+static inline_always TARGET
+void K(_store_hits)(f32* t_hit,F32V t_min,F32V t_max,I32V valid,I32V* hits) {
+  const I32V hit=valid & (t_min<=t_max) & (t_min<F32_INFINITY);
+  const F32V out=K(_select)(hit,t_min,(F32V){0}+F32_INFINITY);
+  __builtin_memcpy(t_hit,&out,sizeof(out));
+  *hits-=hit;
+}
+
+static inline_always TARGET
+const usize K(_count)(I32V hits) {
+  usize count=0;
+  for(usize k=0;k<LANES;k++) {
+    count+=(usize)hits[k];
+  }
+  return count;
+}
+
+static TARGET
+usize K(_ray_intersect_aabbs)(const Ray* self,const Aabb* boxes,f32* t_hit,usize n) {
+  const F32V origin[3]={(F32V){0}+self->origin.x,(F32V){0}+self->origin.y,(F32V){0}+self->origin.z};
+  const F32V inv_dir[3]={(F32V){0}+self->inv_dir.x,(F32V){0}+self->inv_dir.y,(F32V){0}+self->inv_dir.z};
+  const F32V t_min0=(F32V){0}+self->t_min;
+  const F32V t_max0=(F32V){0}+self->t_max;
+  I32V hits={0};
+  for(usize i=0;i<n;i+=LANES) {
+    const usize rem=n-i;
+    const Aabb* pb=boxes+i;
+    f32* po=t_hit+i;
+    Aabb pad_b[LANES];
+    f32 pad_o[LANES];
+    if(rem<LANES) {
+      __builtin_memset(pad_b,0xff,sizeof(pad_b));
+      __builtin_memcpy(pad_b,pb,rem*sizeof(Aabb));
+      pb=pad_b;
+      po=pad_o;
+    }
+    F32V lo[3],hi[3];
+    K(_load_boxes)((const f32*)pb,lo,hi);
+    F32V t_min=t_min0,t_max=t_max0;
+    // The ray's signs are the same for every box, so they swap whole vectors.
+    for(usize k=0;k<3;k++) {
+      const bool neg=(self->sign>>k)&1;
+      K(_clip_slab)(neg? hi[k] : lo[k],neg? lo[k] : hi[k],origin[k],inv_dir[k],&t_min,&t_max);
+    }
+    const I32V valid=(lo[0]<=hi[0]) & (lo[1]<=hi[1]) & (lo[2]<=hi[2]);
+    K(_store_hits)(po,t_min,t_max,valid,&hits);
+    if(rem<LANES) {
+      __builtin_memcpy(t_hit+i,pad_o,rem*sizeof(f32));
+    }
+  }
+  return K(_count)(hits);
+}
+
+static TARGET
+usize K(_aabb_intersect_rays)(const Aabb* self,const Ray* rays,f32* t_hit,usize n) {
+  const F32V lo[3]={(F32V){0}+self->min.x,(F32V){0}+self->min.y,(F32V){0}+self->min.z};
+  const F32V hi[3]={(F32V){0}+self->max.x,(F32V){0}+self->max.y,(F32V){0}+self->max.z};
+  I32V hits={0};
+  for(usize i=0;i<n;i+=LANES) {
+    const usize rem=n-i;
+    const Ray* pr=rays+i;
+    f32* po=t_hit+i;
+    Ray pad_r[LANES];
+    f32 pad_o[LANES];
+    if(rem<LANES) {
+      __builtin_memset(pad_r,0xff,sizeof(pad_r));
+      __builtin_memcpy(pad_r,pr,rem*sizeof(Ray));
+      pr=pad_r;
+      po=pad_o;
+    }
+    F32V row[12];
+    K(_load_rays)((const f32*)pr,row);
+    const F32V* origin=row;
+    const F32V* dir=row+4;
+    const F32V* inv_dir=row+8;
+    F32V t_min=row[3],t_max=row[7];
+    for(usize k=0;k<3;k++) {
+      const I32V neg=(I32V)inv_dir[k]<0;
+      K(_clip_slab)(K(_select)(neg,hi[k],lo[k]),K(_select)(neg,lo[k],hi[k]),origin[k],inv_dir[k],
+        &t_min,&t_max);
+    }
+    // `x-x` is zero for finite `x` and `NaN` otherwise, like `ray_is_finite`.
+    const F32V finite=(origin[0]-origin[0])+(origin[1]-origin[1])+(origin[2]-origin[2])
+      +(dir[0]-dir[0])+(dir[1]-dir[1])+(dir[2]-dir[2]);
+    K(_store_hits)(po,t_min,t_max,finite==0.0F,&hits);
+    if(rem<LANES) {
+      __builtin_memcpy(t_hit+i,pad_o,rem*sizeof(f32));
+    }
+  }
+  return K(_count)(hits);
+}
+
+#undef K
@@ -1,3 +1,4 @@
+#include <emmintrin.h>
 #include "trig.h"
 #include "math_impl.h"
 
@@ -5,6 +6,26 @@
 static const f32 PI=3.1415927410e+00;
 // 0xb3bbbd2e
 static const f32 PI_LO=-8.7422776573e-08;
+// pi/2 rounded to f32 plus what rounding dropped, like `PI` and `PI_LO`.
+static const f32 PIO2=1.5707963705e+00f;
+static const f32 PIO2_LO=-4.3711388287e-08f;
+static const f32 PIO4=7.8539818525e-01f;
+static const f32 TAN_PI_8=0.4142135623730950f;
+// atan(t)=t+t*z*P(z) with z=t^2 on |t|<=tan(pi/8) (Cephes `atanf`).
+static const f32 ATAN_C0=-3.33329491539e-1f;
+static const f32 ATAN_C1=1.99777106478e-1f;
+static const f32 ATAN_C2=-1.38776856032e-1f;
+static const f32 ATAN_C3=8.05374449538e-2f;
+// 7-degree minimax polynomial of `_acos_approx_f32`, also used by the slerp kernels in
+// `quat_batch_lanes.h`.
+static const f32 ACOS_C7=-0.0012624911f;
+static const f32 ACOS_C6=0.00667009f;
+static const f32 ACOS_C5=-0.017088126f;
+static const f32 ACOS_C4=0.03089188f;
+static const f32 ACOS_C3=-0.050174303f;
+static const f32 ACOS_C2=0.08897899f;
+static const f32 ACOS_C1=-0.2145988f;
+static const f32 ACOS_C0=1.5707963f;
 
 
 inline
@@ -12,98 +33,65 @@ const f32 _acos_approx_f32(f32 v) {
   // Based on https://github.com/microsoft/DirectXMath `XMScalarAcos`
   // Clamp input to [-1,1].
   const bool nonnegative=!f32_is_sign_negative(v);
-  const f32 x=f32_abs(v);
-  f32 omx=1.0f-x;
-  if(omx<0.0f) {
-    omx=0.0;
-  }
-  f32 root=f32_sqrt(omx);
+  // Clamping `x` rather than `1-x` keeps the polynomial finite, so `|v|>1` does not end
+  // up as `inf*0`. A NaN stays NaN.
+  const f32 x=f32_abs(v)>1.0f? 1.0f : f32_abs(v);
+  f32 root=f32_sqrt(1.0f-x);
   // 7-degree minimax approximation
-  f32 result=((((((-0.0012624911 * x + 0.00667009) * x - 0.017088126) * x + 0.03089188) * x
-    - 0.050174303)
-    * x
-    + 0.08897899)
-    * x
-    - 0.2145988)
-    * x
-    + 1.5707963;
+  f32 result=((((((ACOS_C7*x+ACOS_C6)*x+ACOS_C5)*x+ACOS_C4)*x+ACOS_C3)*x+ACOS_C2)*x+ACOS_C1)*x
+    +ACOS_C0;
   result*=root;
   // acos(x)=pi - acos(-x) when x < 0
   return nonnegative?result:F32_PI-result;
 }
 
+/// `mask? a : b` lane by lane, for masks from the `_mm_cmp*_ss` compares.
+static inline_always
+const __m128 _trig_select(__m128 mask,__m128 a,__m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b));
+}
+
 inline
 const f32 _atan2f(const f32 y,const f32 x) {
-  if(f32_is_nan(x) || f32_is_nan(x)) {
-    return x+y;
-  }
-  u32 ix=f32_to_bits(x);
-  u32 iy=f32_to_bits(y);
-
-  if(ix==0x3f800000) {
-    // x=1.0
-    return _atanf(y);
-  }
-  // 2*sign(x)+signy
-  const u32 m=((iy>>31) & 1) | ((ix>>30) & 2);
-  ix&=0x7fffffff;
-  iy&=0x7fffffff;
-
-  if(iy==0) {
-    switch(m) {
-      case 0: case 1: return y; // atan(+-0,+anything)=+-0
-      case 2: return PI; // atan(+0,-anything)=pi
-      default: return -PI; // atan(-0,-anything)=-pi
-    }
-  }
-
-  if(ix==0) {
-    return m&1? -PI/2.0f : PI/2.0f;
-  }
-
-  // when x is INF
-  if(ix==0x7f800000) {
-    if(iy==0x7f800000) {
-      switch(m) {
-        case 0: return PI/4.0f; // atan(+INF,+INF)
-        case 1: return -PI/4.0f; // atan(-INF,+INF)
-        case 2: return 3.0f * PI / 4.0f; // atan(+INF,-INF)
-        default: return -3.0f * PI / 4.0f; // atan(-INF,-INF)
-      }
-    }
-
-    switch(m) {
-      case 0: return 0.0f; // atan(+...,+INF)
-      case 1: return -0.0f; // atan(-...,+INF)
-      case 2: return PI; // atan(+...,-INF)
-      default: return -PI; // atan(-...,-INF)
-    }
-  }
-
-  // |y/x| > 0x1p26 
-  if(((ix + (22<<23)) < iy) || (ix==0x7f800000)) {
-    return m&1? -PI/2.0f : PI/2.0f;
-  }
-
-  const f32 z=((m&2) && ((iy + (26<<23)) < ix))? 0.0f : atanf(fabsf(y/x));
-
-  switch(m) {
-    case 0: return z;
-    case 1: return -z;
-    case 3: return PI - (z-PI_LO);
-    default: return (z-PI_LO) - PI;
-  }
+  // The same steps as the `f32_atan2_batch` lanes, in the low lane of SSE registers so
+  // the selects stay bit operations rather than jumps or moves to integer registers.
+  // Folded to the first octant, the angle is `atan(lo/hi)` with `lo<=hi`, which Cephes
+  // reduces to `|t|<=tan(pi/8)` with `t=lo/hi` or `t=(lo-hi)/(lo+hi)`, one division
+  // either way. Then the quadrant is unfolded.
+  const __m128 vx=_mm_set_ss(x),vy=_mm_set_ss(y);
+  const __m128 sign=_mm_set_ss(-0.0f),zero=_mm_setzero_ps(),one=_mm_set_ss(1.0f);
+  const __m128 sign_y=_mm_and_ps(vy,sign);
+  const __m128 ax=_mm_andnot_ps(sign,vx),ay=_mm_xor_ps(vy,sign_y);
+  const __m128 swap=_mm_cmpgt_ss(ay,ax);
+  __m128 hi=_trig_select(swap,ay,ax),lo=_trig_select(swap,ax,ay);
+  // 0/0 and inf/inf: atan2(+-0,+-0) and atan2(+-inf,+-inf) are multiples of pi/4.
+  hi=_trig_select(_mm_cmpeq_ss(hi,zero),one,hi);
+  const __m128 infinite=_mm_cmpeq_ss(lo,_mm_set_ss(F32_INFINITY));
+  lo=_trig_select(infinite,one,lo);
+  hi=_trig_select(infinite,one,hi);
+  // Keeps `lo+hi` finite.
+  const __m128 scale=_trig_select(_mm_cmpgt_ss(hi,_mm_set_ss(0x1p126f)),_mm_set_ss(0.25f),one);
+  lo=_mm_mul_ss(lo,scale);
+  hi=_mm_mul_ss(hi,scale);
+  const __m128 mid=_mm_cmpgt_ss(lo,_mm_mul_ss(_mm_set_ss(TAN_PI_8),hi));
+  const __m128 t=_mm_div_ss(_trig_select(mid,_mm_sub_ss(lo,hi),lo),_trig_select(mid,_mm_add_ss(lo,hi),hi));
+  const f32 tt=_mm_cvtss_f32(t);
+  const f32 z=tt*tt;
+  const __m128 p=_mm_add_ss(
+    _mm_set_ss((((ATAN_C3*z+ATAN_C2)*z+ATAN_C1)*z+ATAN_C0)*z*tt+tt),
+    _mm_and_ps(mid,_mm_set_ss(PIO4))
+  );
+  // pi/2-p, pi/2+p or pi-p in one step, so `x<0` keeps the low part of pi/2.
+  const __m128 negative=_mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(vx),31));
+  const __m128 base=_trig_select(swap,_mm_set_ss(PIO2),_mm_and_ps(negative,_mm_set_ss(PI)));
+  const __m128 base_lo=_trig_select(swap,_mm_set_ss(PIO2_LO),_mm_and_ps(negative,_mm_set_ss(PI_LO)));
+  const __m128 flip=_mm_and_ps(_mm_xor_ps(swap,negative),sign);
+  const __m128 r=_mm_xor_ps(_mm_add_ss(_mm_add_ss(base,_mm_xor_ps(p,flip)),base_lo),sign_y);
+  const __m128 nan=_mm_cmpunord_ss(vx,vy);
+  return _mm_cvtss_f32(_trig_select(nan,_mm_add_ss(vx,vy),r));
 }
 
-
-
-
-
-
-
-
-
-
-
-
-
+inline
+const f32 _atanf(const f32 x) {
+  return atanf(x);
+}
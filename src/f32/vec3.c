@@ -31,17 +31,26 @@ const Vec3 vec3_splat(f32 v) {
   return vec;
 }
 
+/// `if_true` if `mask` and `if_false` otherwise, as a bitwise blend: a ternary on floats
+/// compiles to a branch per element.
+static inline_always
+const f32 _vec3_select_element(bool mask,f32 if_true,f32 if_false) {
+  const u32 bits=-(u32)mask;
+  return f32_from_bits((f32_to_bits(if_true) & bits) | (f32_to_bits(if_false) & ~bits));
+}
+
 /// Creates a vector from the elements in `if_true` and `if_false`, selecting which to use
 /// for each element of `self`.
 ///
 /// A true element in the mask uses the corresponding element from `if_true`, and false
-/// uses the element from `if_false`.
+/// uses the element from `if_false`. It does not branch; `Vec3A` keeps the mask in SIMD
+/// lanes, so `vec3a_cmp*` followed by `vec3a_select` is a compare and a blend.
 inline
 const Vec3 vec3_select(BVec3 mask,Vec3 if_true,Vec3 if_false) {
   Vec3 vec={
-    .x=bvec3_test(mask,0)? if_true.x : if_false.x,
-    .y=bvec3_test(mask,1)? if_true.y : if_false.y,
-    .z=bvec3_test(mask,2)? if_true.z : if_false.z,
+    .x=_vec3_select_element(mask.x,if_true.x,if_false.x),
+    .y=_vec3_select_element(mask.y,if_true.y,if_false.y),
+    .z=_vec3_select_element(mask.z,if_true.z,if_false.z),
   };
 
   return vec;
@@ -57,6 +66,8 @@ const Vec3 vec3_map(Vec3 self,f32 (*f)(f32)) {
 }
 
 /// Creates a new vector from an array.
+///
+/// The elements are rounded to `f32`; use `dvec3_from_array` to keep double precision.
 inline
 const Vec3 vec3_from_array(f64 a[3]) {
   Vec3 vec={
@@ -354,6 +365,15 @@ const f32 vec3_len_recip(Vec3 self) {
   return 1.0F/vec3_len(self);
 }
 
+/// Approximates `1.0 / length()` with `f32_rsqrt_fast`.
+///
+/// The relative error is below `3e-7`. For valid results, `self` must _not_ be of length
+/// zero, and its squared length must be finite and not subnormal.
+inline
+const f32 vec3_len_recip_fast(Vec3 self) {
+  return f32_rsqrt_fast(vec3_dot(self,self));
+}
+
 /// Computes the Euclidean distance between two points in space.
 inline
 const f32 vec3_distance(Vec3 self,Vec3 rhs) {
@@ -434,6 +454,45 @@ const Vec3 vec3_normalize_or_zero(Vec3 self) {
   return vec3_normalize_or(self,VEC3_ZERO);
 }
 
+/// Returns `self` normalized to length 1.0, using `vec3_len_recip_fast`.
+///
+/// The length of the result is within `4e-7` of 1.0. For valid results, `self` must be
+/// finite and _not_ of length zero, nor very close to zero.
+///
+/// Panics
+///
+/// Will panic if the resulting normalized vector is not finite when `cmeth_assert` is enabled.
+inline
+const Vec3 vec3_normalize_fast(Vec3 self) {
+  Vec3 normalized=vec3_mul_f32(self,vec3_len_recip_fast(self));
+
+  cmeth_assert(vec3_is_finite(normalized));
+  return normalized;
+}
+
+/// Returns `self` normalized to length 1.0 using `vec3_len_recip_fast` if possible, else
+/// returns a fallback value.
+///
+/// Falls back for the same inputs as `vec3_normalize_or`, and also when the squared length
+/// is subnormal or overflows.
+inline
+const Vec3 vec3_normalize_or_fast(Vec3 self,Vec3 fallback) {
+  const f32 len_sq=vec3_dot(self,self);
+
+  // Tests the input rather than the estimate so the branch does not wait on `rsqrtss`.
+  // 0x1p-126 is the smallest normal f32; NaN fails both comparisons.
+  return len_sq>=0x1p-126F && len_sq<F32_INFINITY?vec3_mul_f32(self,f32_rsqrt_fast(len_sq)):fallback;
+}
+
+/// Returns `self` normalized to length 1.0 using `vec3_len_recip_fast` if possible, else
+/// returns zero.
+///
+/// See also [`vec3_normalize_or_fast()`].
+inline
+const Vec3 vec3_normalize_or_zero_fast(Vec3 self) {
+  return vec3_normalize_or_fast(self,VEC3_ZERO);
+}
+
 /// Returns whether `self` is length `1.0` or not.
 ///
 /// Uses a precision threshold of approximately `1e-4`.
@@ -645,7 +704,7 @@ const Vec3 vec3_move_towards(Vec3* self,Vec3 rhs,f32 d) {
   if(len<=d || len<=1e-4) {
     return rhs;
   }
-  return vec3_div_f32(vec3_add(*self,a),len+d);
+  return vec3_add(*self,vec3_mul_f32(a,d/len));
 }
 
 /// Calculates the midpoint between `self` and `rhs`.
@@ -674,7 +733,7 @@ const bool vec3_abs_diff_eq(Vec3 self,Vec3 rhs,f32 max_abs_diff) {
   return bvec3_all(mask);
 }
 
-inline_always
+static inline_always
 const Vec3 _x_self_over_len(Vec3 self,f32 x,f32 len_sq) {
   f32 len=f32_sqrt(len_sq);
   Vec3 self_over_len=vec3_div_f32(self,len);
@@ -741,3 +800,263 @@ const Vec3 vec3_mul_add(Vec3 self,Vec3 a,Vec3 b) {
   return vec;
 }
 
+/// Computes the dot product of `self` and `rhs` with `f32_mul_add`, so only the first
+/// product and the two fused sums round.
+///
+/// The result is the same bit for bit as the AVX2 and AVX-512 bodies of `vec3_soa_dot`, and
+/// at most `2^-22 * (|self.x*rhs.x| + |self.y*rhs.y| + |self.z*rhs.z|)` away from `vec3_dot`.
+///
+/// `f32_mul_add` is a single instruction only where the caller is built with FMA
+/// (`FP_FAST_FMAF`, e.g. `-mfma`). Elsewhere it is a libm `fmaf` call, and this and the other
+/// `_fma` functions are three to seven times slower than their unfused counterparts: use them
+/// for the accuracy or to match `vec3_soa`, not for speed.
+inline
+const f32 vec3_dot_fma(Vec3 self,Vec3 rhs) {
+  return f32_mul_add(self.z,rhs.z,f32_mul_add(self.y,rhs.y,self.x*rhs.x));
+}
+
+/// Computes the cross product of `self` and `rhs`, fusing the first product of every
+/// element into its difference.
+///
+/// The result is the same bit for bit as the AVX2 and AVX-512 bodies of `vec3_soa_cross`.
+inline
+const Vec3 vec3_cross_fma(Vec3 self,Vec3 rhs) {
+  Vec3 vec={
+    .x=f32_mul_add(self.y,rhs.z,-(rhs.y*self.z)),
+    .y=f32_mul_add(self.z,rhs.x,-(rhs.z*self.x)),
+    .z=f32_mul_add(self.x,rhs.y,-(rhs.x*self.y))
+  };
+  return vec;
+}
+
+/// Computes the squared length of `self` with `vec3_dot_fma`.
+inline
+const f32 vec3_len_squared_fma(Vec3 self) {
+  return vec3_dot_fma(self,self);
+}
+
+/// Works like `vec3_lerp`, as `s*rhs+(self-s*self)` with two `f32_mul_add`s.
+///
+/// With finite endpoints the result is still exactly `self` when `s` is `0.0` and exactly
+/// `rhs` when `s` is `1.0`. An infinite element gives `NaN` at either, as `0*inf` or
+/// `inf-inf` does in one of the two products.
+/// The result is the same bit for bit as the SIMD bodies of `vec3_soa_lerp`.
+inline
+const Vec3 vec3_lerp_fma(Vec3 self,Vec3 rhs,f32 s) {
+  Vec3 vec={
+    .x=f32_mul_add(s,rhs.x,f32_mul_add(-s,self.x,self.x)),
+    .y=f32_mul_add(s,rhs.y,f32_mul_add(-s,self.y,self.y)),
+    .z=f32_mul_add(s,rhs.z,f32_mul_add(-s,self.z,self.z))
+  };
+  return vec;
+}
+
+/// Returns a vector with all elements set to `0.0`.
+inline_always
+const Vec3 vec3_default() {
+  return VEC3_ZERO;
+}
+
+/// Returns the element-wise quotient of `self` and `rhs`.
+inline
+const Vec3 vec3_div(Vec3 self,Vec3 rhs) {
+  Vec3 vec={
+    .x=self.x/rhs.x,
+    .y=self.y/rhs.y,
+    .z=self.z/rhs.z
+  };
+  return vec;
+}
+
+inline
+void vec3_div_assign(Vec3* self,Vec3 rhs) {
+  *self=vec3_div(*self,rhs);
+}
+
+/// Returns `self` with every element divided by `rhs`.
+inline
+const Vec3 vec3_div_f32(Vec3 self,f32 rhs) {
+  Vec3 vec={
+    .x=self.x/rhs,
+    .y=self.y/rhs,
+    .z=self.z/rhs
+  };
+  return vec;
+}
+
+inline
+void vec3_div_assign_f32(Vec3* self,f32 rhs) {
+  *self=vec3_div_f32(*self,rhs);
+}
+
+/// Returns a vector with every element being `self` divided by the element of `rhs`.
+inline
+const Vec3 f32_div_vec3(f32 self,Vec3 rhs) {
+  return vec3_div(vec3_splat(self),rhs);
+}
+
+/// Returns the element-wise product of `self` and `rhs`.
+inline
+const Vec3 vec3_mul(Vec3 self,Vec3 rhs) {
+  Vec3 vec={
+    .x=self.x*rhs.x,
+    .y=self.y*rhs.y,
+    .z=self.z*rhs.z
+  };
+  return vec;
+}
+
+inline
+void vec3_mul_assign(Vec3* self,Vec3 rhs) {
+  *self=vec3_mul(*self,rhs);
+}
+
+/// Returns `self` with every element multiplied by `rhs`.
+inline
+const Vec3 vec3_mul_f32(Vec3 self,f32 rhs) {
+  Vec3 vec={
+    .x=self.x*rhs,
+    .y=self.y*rhs,
+    .z=self.z*rhs
+  };
+  return vec;
+}
+
+inline
+void vec3_mul_assign_f32(Vec3* self,f32 rhs) {
+  *self=vec3_mul_f32(*self,rhs);
+}
+
+inline
+const Vec3 f32_mul_vec3(f32 self,Vec3 rhs) {
+  return vec3_mul_f32(rhs,self);
+}
+
+/// Returns the element-wise sum of `self` and `rhs`.
+inline
+const Vec3 vec3_add(Vec3 self,Vec3 rhs) {
+  Vec3 vec={
+    .x=self.x+rhs.x,
+    .y=self.y+rhs.y,
+    .z=self.z+rhs.z
+  };
+  return vec;
+}
+
+inline
+void vec3_add_assign(Vec3* self,Vec3 rhs) {
+  *self=vec3_add(*self,rhs);
+}
+
+/// Returns `self` with `rhs` added to every element.
+inline
+const Vec3 vec3_add_f32(Vec3 self,f32 rhs) {
+  Vec3 vec={
+    .x=self.x+rhs,
+    .y=self.y+rhs,
+    .z=self.z+rhs
+  };
+  return vec;
+}
+
+inline
+void vec3_add_assign_f32(Vec3* self,f32 rhs) {
+  *self=vec3_add_f32(*self,rhs);
+}
+
+inline
+const Vec3 f32_add_vec3(f32 self,Vec3 rhs) {
+  return vec3_add_f32(rhs,self);
+}
+
+/// Returns the element-wise difference of `self` and `rhs`.
+inline
+const Vec3 vec3_sub(Vec3 self,Vec3 rhs) {
+  Vec3 vec={
+    .x=self.x-rhs.x,
+    .y=self.y-rhs.y,
+    .z=self.z-rhs.z
+  };
+  return vec;
+}
+
+inline
+void vec3_sub_assign(Vec3* self,Vec3 rhs) {
+  *self=vec3_sub(*self,rhs);
+}
+
+/// Returns `self` with `rhs` subtracted from every element.
+inline
+const Vec3 vec3_sub_f32(Vec3 self,f32 rhs) {
+  Vec3 vec={
+    .x=self.x-rhs,
+    .y=self.y-rhs,
+    .z=self.z-rhs
+  };
+  return vec;
+}
+
+inline
+void vec3_sub_assign_f32(Vec3* self,f32 rhs) {
+  *self=vec3_sub_f32(*self,rhs);
+}
+
+/// Returns a vector with every element being `self` minus the element of `rhs`.
+inline
+const Vec3 f32_sub_vec3(f32 self,Vec3 rhs) {
+  return vec3_sub(vec3_splat(self),rhs);
+}
+
+/// Returns the element-wise remainder of `self` and `rhs`, as `f32_rem` does.
+inline
+const Vec3 vec3_rem(Vec3 self,Vec3 rhs) {
+  Vec3 vec={
+    .x=f32_rem(self.x,rhs.x),
+    .y=f32_rem(self.y,rhs.y),
+    .z=f32_rem(self.z,rhs.z)
+  };
+  return vec;
+}
+
+inline
+void vec3_rem_assign(Vec3* self,Vec3 rhs) {
+  *self=vec3_rem(*self,rhs);
+}
+
+inline
+const Vec3 vec3_rem_f32(Vec3 self,f32 rhs) {
+  return vec3_rem(self,vec3_splat(rhs));
+}
+
+inline
+void vec3_rem_assign_f32(Vec3* self,f32 rhs) {
+  *self=vec3_rem_f32(*self,rhs);
+}
+
+inline
+const Vec3 f32_rem_vec3(f32 self,Vec3 rhs) {
+  return vec3_rem(vec3_splat(self),rhs);
+}
+
+inline
+const Vec3 vec3_neg(Vec3 self) {
+  Vec3 vec={
+    .x=-self.x,
+    .y=-self.y,
+    .z=-self.z
+  };
+  return vec;
+}
+
+/// Returns a pointer to the element at `index`.
+///
+/// Panics if `index` is greater than 2.
+inline
+const f32* vec3_index(Vec3* self,usize index) {
+  switch(index) {
+    case 0: return &self->x;
+    case 1: return &self->y;
+    case 2: return &self->z;
+    default: panic("index out of bounds")
+  }
+}
@@ -13,79 +13,107 @@ typedef struct {
 #ifdef _cplusplus
 extern "C" {
 #endif
-const Vec3 vec3(f32 x,f32 y,f32 z);
-const Vec3 vec3_new(f32 x,f32 y,f32 z);
-const Vec3 vec3_splat(f32 v);
-const Vec3 vec3_select(BVec3 mask,Vec3 if_true,Vec3 if_false);
-const Vec3 vec3_map(Vec3 self,f32 (*f)(f32));
-const Vec3 vec3_from_array(f64 a[3]);
-void vec3_write_to_slice(Vec3 self,f32* slice);
-const Vec3 vec3_from_vec4(f32 v[4]);
-const f32 vec3_dot(Vec3 self,Vec3 rhs);
-const Vec3 vec3_dot_into_vec(Vec3 self,Vec3 rhs);
-const Vec3 vec3_cross(Vec3 self,Vec3 rhs);
-const Vec3 vec3_min(Vec3 self,Vec3 rhs);
-const Vec3 vec3_max(Vec3 self,Vec3 rhs);
-const Vec3 vec3_clamp(Vec3 self,Vec3 min,Vec3 max);
-const f32 vec3_min_element(Vec3 self);
-const f32 vec3_max_element(Vec3 self);
-const f32 vec3_element_sum(Vec3 self);
-const f32 vec3_element_product(Vec3 self);
-const BVec3 vec3_cmpeq(Vec3 self,Vec3 rhs);
-const BVec3 vec3_cmpne(Vec3 self,Vec3 rhs);
-const BVec3 vec3_cmpge(Vec3 self,Vec3 rhs);
-const BVec3 vec3_cmpgt(Vec3 self,Vec3 rhs);
-const BVec3 vec3_cmple(Vec3 self,Vec3 rhs);
-const BVec3 vec3_cmplt(Vec3 self,Vec3 rhs);
-const Vec3 vec3_abs(Vec3 self);
-const Vec3 vec3_signum(Vec3 self);
-const Vec3 vec3_copysign(Vec3 self,Vec3 rhs);
-const u32 vec3_is_negative_bitmask(Vec3 self);
-const bool vec3_is_finite(Vec3 self);
-const bool vec3_is_nan(Vec3 self);
-const f32 vec3_len(Vec3 self);
-const f32 vec3_len_squared(Vec3 self);
-const f32 vec3_len_recip(Vec3 self);
-const f32 vec3_distance(Vec3 self,Vec3 rhs);
-const f32 vec3_distance_squared(Vec3 self,Vec3 rhs);
-const Vec3 vec3_div_euclid(Vec3 self,Vec3 rhs);
-const Vec3 vec3_rem_euclid(Vec3 self,Vec3 rhs);
-const Vec3 vec3_normalize(Vec3 self);
-const Vec3 vec3_normalize_or(Vec3 self,Vec3 fallback);
-const Vec3 vec3_normalize_or_zero(Vec3 self);
-const bool vec3_is_normalized(Vec3 self);
-const Vec3 vec3_project_into(Vec3 self,Vec3 rhs);
-const Vec3 vec3_reject_from(Vec3 self,Vec3 rhs);
-const Vec3 vec3_project_onto_normalized(Vec3 self,Vec3 rhs);
-const Vec3 vec3_reject_from_normalized(Vec3 self,Vec3 rhs);
-const Vec3 vec3_default();
-const Vec3 vec3_div(Vec3 self,Vec3 rhs);
-void vec3_dev_assign(Vec3* self,Vec3 rhs);
-const Vec3 vec3_div_f32(Vec3 self,f32 rhs);
-void vec3_div_assign_f32(Vec3* self,f32 rhs);
-const Vec3 f32_div_vec3(f32 self,Vec3 rhs);
-const Vec3 vec3_mul(Vec3 self,Vec3 rhs);
-void vec3_mul_assign(Vec3* self,Vec3 rhs);
-const Vec3 vec3_mul_f32(Vec3 self,f32 rhs);
-void vec3_mul_assign_f32(Vec3* self,f32 rhs);
-const Vec3 f32_mul_vec3(f32 self,Vec3 rhs);
-const Vec3 vec3_add(Vec3 self,Vec3 rhs);
-void vec3_add_assign(Vec3* self,Vec3 rhs);
-const Vec3 vec3_add_f32(Vec3 self,f32 rhs);
-void vec3_add_assign_f32(Vec3* self,f32 rhs);
-const Vec3 f32_add_vec3(f32 self,Vec3 rhs);
-const Vec3 vec3_sub(Vec3 self,Vec3 rhs);
-void vec3_sub_assign(Vec3* self,Vec3 rhs);
-const Vec3 vec3_sub_f32(Vec3 self,f32 rhs);
-void vec3_sub_assign_f32(Vec3* self,f32 rhs);
-const Vec3 f32_sub_vec3(f32 self,Vec3 rhs);
-const Vec3 vec3_rem(Vec3 self,Vec3 rhs);
-void vec3_rem_assign(Vec3* self,Vec3 rhs);
-const Vec3 vec3_rem_f32(Vec3 self,f32 rhs);
-void vec3_rem_assign_f32(Vec3* self,f32 rhs);
-const Vec3 f32_rem_vec3(f32 self,Vec3 rhs);
-const Vec3 vec3_neg(Vec3 self);
-const f32* vec3_index(Vec3* self,usize index);
+CMETH_API const Vec3 vec3(f32 x,f32 y,f32 z);
+CMETH_API const Vec3 vec3_new(f32 x,f32 y,f32 z);
+CMETH_API const Vec3 vec3_splat(f32 v);
+CMETH_API const Vec3 vec3_select(BVec3 mask,Vec3 if_true,Vec3 if_false);
+CMETH_API const Vec3 vec3_map(Vec3 self,f32 (*f)(f32));
+CMETH_API const Vec3 vec3_from_array(f64 a[3]);
+CMETH_API void vec3_write_to_slice(Vec3 self,f32* slice);
+CMETH_API const Vec3 vec3_from_vec4(f32 v[4]);
+CMETH_API const Vec3 vec3_with_x(Vec3 self,f32 x);
+CMETH_API const Vec3 vec3_with_y(Vec3 self,f32 y);
+CMETH_API const Vec3 vec3_with_z(Vec3 self,f32 z);
+CMETH_API const f32 vec3_dot(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_dot_into_vec(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_cross(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_min(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_max(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_clamp(Vec3 self,Vec3 min,Vec3 max);
+CMETH_API const f32 vec3_min_element(Vec3 self);
+CMETH_API const f32 vec3_max_element(Vec3 self);
+CMETH_API const f32 vec3_element_sum(Vec3 self);
+CMETH_API const f32 vec3_element_product(Vec3 self);
+CMETH_API const BVec3 vec3_cmpeq(Vec3 self,Vec3 rhs);
+CMETH_API const BVec3 vec3_cmpne(Vec3 self,Vec3 rhs);
+CMETH_API const BVec3 vec3_cmpge(Vec3 self,Vec3 rhs);
+CMETH_API const BVec3 vec3_cmpgt(Vec3 self,Vec3 rhs);
+CMETH_API const BVec3 vec3_cmple(Vec3 self,Vec3 rhs);
+CMETH_API const BVec3 vec3_cmplt(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_abs(Vec3 self);
+CMETH_API const Vec3 vec3_signum(Vec3 self);
+CMETH_API const Vec3 vec3_copysign(Vec3 self,Vec3 rhs);
+CMETH_API const u32 vec3_is_negative_bitmask(Vec3 self);
+CMETH_API const bool vec3_is_finite(Vec3 self);
+CMETH_API const bool vec3_is_nan(Vec3 self);
+CMETH_API const f32 vec3_len(Vec3 self);
+CMETH_API const f32 vec3_len_squared(Vec3 self);
+CMETH_API const f32 vec3_len_recip(Vec3 self);
+CMETH_API const f32 vec3_len_recip_fast(Vec3 self);
+CMETH_API const f32 vec3_distance(Vec3 self,Vec3 rhs);
+CMETH_API const f32 vec3_distance_squared(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_div_euclid(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_rem_euclid(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_normalize(Vec3 self);
+CMETH_API const Vec3 vec3_normalize_or(Vec3 self,Vec3 fallback);
+CMETH_API const Vec3 vec3_normalize_or_zero(Vec3 self);
+CMETH_API const Vec3 vec3_normalize_fast(Vec3 self);
+CMETH_API const Vec3 vec3_normalize_or_fast(Vec3 self,Vec3 fallback);
+CMETH_API const Vec3 vec3_normalize_or_zero_fast(Vec3 self);
+CMETH_API const bool vec3_is_normalized(Vec3 self);
+CMETH_API const Vec3 vec3_project_into(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_reject_from(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_project_onto_normalized(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_reject_from_normalized(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_round(Vec3 self);
+CMETH_API const Vec3 vec3_floor(Vec3 self);
+CMETH_API const Vec3 vec3_ceil(Vec3 self);
+CMETH_API const Vec3 vec3_trunc(Vec3 self);
+CMETH_API const Vec3 vec3_fract(Vec3 self);
+CMETH_API const Vec3 vec3_fract_gl(Vec3 self);
+CMETH_API const Vec3 vec3_exp(Vec3 self);
+CMETH_API const Vec3 vec3_pow(Vec3 self,f32 n);
+CMETH_API const Vec3 vec3_recip(Vec3 self);
+CMETH_API const Vec3 vec3_lerp(Vec3 self,Vec3 rhs,f32 s);
+CMETH_API const Vec3 vec3_move_towards(Vec3* self,Vec3 rhs,f32 d);
+CMETH_API const Vec3 vec3_midpoint(Vec3 self,Vec3 rhs);
+CMETH_API const bool vec3_abs_diff_eq(Vec3 self,Vec3 rhs,f32 max_abs_diff);
+CMETH_API const Vec3 vec3_clamp_length(Vec3 self,f32 min,f32 max);
+CMETH_API const Vec3 vec3_clamp_length_max(Vec3 self,f32 max);
+CMETH_API const Vec3 vec3_clamp_length_min(Vec3 self,f32 min);
+CMETH_API const Vec3 vec3_mul_add(Vec3 self,Vec3 a,Vec3 b);
+CMETH_API const f32 vec3_dot_fma(Vec3 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_cross_fma(Vec3 self,Vec3 rhs);
+CMETH_API const f32 vec3_len_squared_fma(Vec3 self);
+CMETH_API const Vec3 vec3_lerp_fma(Vec3 self,Vec3 rhs,f32 s);
+CMETH_API const Vec3 vec3_default();
+CMETH_API const Vec3 vec3_div(Vec3 self,Vec3 rhs);
+CMETH_API void vec3_div_assign(Vec3* self,Vec3 rhs);
+CMETH_API const Vec3 vec3_div_f32(Vec3 self,f32 rhs);
+CMETH_API void vec3_div_assign_f32(Vec3* self,f32 rhs);
+CMETH_API const Vec3 f32_div_vec3(f32 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_mul(Vec3 self,Vec3 rhs);
+CMETH_API void vec3_mul_assign(Vec3* self,Vec3 rhs);
+CMETH_API const Vec3 vec3_mul_f32(Vec3 self,f32 rhs);
+CMETH_API void vec3_mul_assign_f32(Vec3* self,f32 rhs);
+CMETH_API const Vec3 f32_mul_vec3(f32 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_add(Vec3 self,Vec3 rhs);
+CMETH_API void vec3_add_assign(Vec3* self,Vec3 rhs);
+CMETH_API const Vec3 vec3_add_f32(Vec3 self,f32 rhs);
+CMETH_API void vec3_add_assign_f32(Vec3* self,f32 rhs);
+CMETH_API const Vec3 f32_add_vec3(f32 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_sub(Vec3 self,Vec3 rhs);
+CMETH_API void vec3_sub_assign(Vec3* self,Vec3 rhs);
+CMETH_API const Vec3 vec3_sub_f32(Vec3 self,f32 rhs);
+CMETH_API void vec3_sub_assign_f32(Vec3* self,f32 rhs);
+CMETH_API const Vec3 f32_sub_vec3(f32 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_rem(Vec3 self,Vec3 rhs);
+CMETH_API void vec3_rem_assign(Vec3* self,Vec3 rhs);
+CMETH_API const Vec3 vec3_rem_f32(Vec3 self,f32 rhs);
+CMETH_API void vec3_rem_assign_f32(Vec3* self,f32 rhs);
+CMETH_API const Vec3 f32_rem_vec3(f32 self,Vec3 rhs);
+CMETH_API const Vec3 vec3_neg(Vec3 self);
+CMETH_API const f32* vec3_index(Vec3* self,usize index);
 #ifdef _cplusplus
 }
 #endif
@@ -136,4 +164,9 @@ const f32* vec3_index(Vec3* self,usize index);
 /// The unit axes.
 #define VEC3_AXES {VEC3_X,VEC3_Y,VEC3_Z}
 
+
+#ifdef CMETH_HEADER_ONLY
+#include "vec3.c"
+#endif
+
 #endif
@@ -0,0 +1,113 @@
+// Transposes between `Vec3` arrays and SIMD registers, shared by the batch kernels that
+// take `Vec3` arrays. Not part of the public headers.
+//
+// `Vec3` arrays are 12-byte AoS, so 8 (16) points are loaded as three full registers and
+// transposed into `x`, `y` and `z` registers with blends and lane permutes, and transposed
+// back before storing. That keeps every load and store a full-width unaligned access, so
+// large arrays run at memory bandwidth. The last points of an array use masked loads and
+// stores: `rem` counts the `f32` elements left from `p`, so it may exceed a register.
+#ifndef CMETH_F32_VEC3_AOS_H
+#define CMETH_F32_VEC3_AOS_H
+#include <immintrin.h>
+#include "../prelude.h"
+#include "../cpu/features.h"
+
+
+static inline_always target_avx2
+const __m256i _vec3_aos_tail_mask8(usize rem) {
+  const __m256i lanes=_mm256_setr_epi32(0,1,2,3,4,5,6,7);
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32((i32)(rem<8? rem : 8)),lanes);
+}
+
+static inline_always target_avx2
+const __m256 _vec3_aos_load8(const f32* p,usize rem) {
+  return rem>=8? _mm256_loadu_ps(p) : _mm256_maskload_ps(p,_vec3_aos_tail_mask8(rem));
+}
+
+static inline_always target_avx2
+void _vec3_aos_store8(f32* p,usize rem,__m256 v) {
+  if(rem>=8) {
+    _mm256_storeu_ps(p,v);
+  } else {
+    _mm256_maskstore_ps(p,_vec3_aos_tail_mask8(rem),v);
+  }
+}
+
+/// Loads the `min(rem/3,8)` points at `p` into `x`, `y` and `z`, in point order. Missing
+/// points are zero.
+static inline_always target_avx2
+void _vec3_aos_gather8(const f32* p,usize rem,__m256* x,__m256* y,__m256* z) {
+  // Lane `i` of a register of 8 points holds element `i%3` of some point, so blending the
+  // three registers by `i%3` gathers all of one element, in a scrambled order that the
+  // permutes sort.
+  const __m256i x_order=_mm256_setr_epi32(0,3,6,1,4,7,2,5);
+  const __m256i y_order=_mm256_setr_epi32(1,4,7,2,5,0,3,6);
+  const __m256i z_order=_mm256_setr_epi32(2,5,0,3,6,1,4,7);
+  const __m256 v0=_vec3_aos_load8(p,rem);
+  const __m256 v1=_vec3_aos_load8(p+8,rem>8? rem-8 : 0);
+  const __m256 v2=_vec3_aos_load8(p+16,rem>16? rem-16 : 0);
+  *x=_mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v0,v1,0x92),v2,0x24),x_order);
+  *y=_mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v2,v0,0x92),v1,0x24),y_order);
+  *z=_mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v1,v2,0x92),v0,0x24),z_order);
+}
+
+/// Stores the `min(rem/3,8)` points of `x`, `y` and `z` at `p`.
+static inline_always target_avx2
+void _vec3_aos_scatter8(f32* p,usize rem,__m256 x,__m256 y,__m256 z) {
+  // Scattering back reuses the `x` and `z` orders; `y` needs the inverse of its order.
+  const __m256i x_order=_mm256_setr_epi32(0,3,6,1,4,7,2,5);
+  const __m256i y_scatter=_mm256_setr_epi32(5,0,3,6,1,4,7,2);
+  const __m256i z_order=_mm256_setr_epi32(2,5,0,3,6,1,4,7);
+  const __m256 xb=_mm256_permutevar8x32_ps(x,x_order);
+  const __m256 yb=_mm256_permutevar8x32_ps(y,y_scatter);
+  const __m256 zb=_mm256_permutevar8x32_ps(z,z_order);
+  _vec3_aos_store8(p,rem,_mm256_blend_ps(_mm256_blend_ps(xb,yb,0x92),zb,0x24));
+  _vec3_aos_store8(p+8,rem>8? rem-8 : 0,_mm256_blend_ps(_mm256_blend_ps(zb,xb,0x92),yb,0x24));
+  _vec3_aos_store8(p+16,rem>16? rem-16 : 0,_mm256_blend_ps(_mm256_blend_ps(yb,zb,0x92),xb,0x24));
+}
+
+
+static inline_always target_avx512
+const __mmask16 _vec3_aos_tail_mask16(usize rem) {
+  return rem>=16? (__mmask16)0xFFFF : (__mmask16)((1U<<rem)-1);
+}
+
+/// Loads the `min(rem/3,16)` points at `p` into `x`, `y` and `z`, in point order. Missing
+/// points are zero.
+static inline_always target_avx512
+void _vec3_aos_gather16(const f32* p,usize rem,__m512* x,__m512* y,__m512* z) {
+  // Each element is gathered from the three registers of 16 points in two two-source
+  // permutes: the first takes what lies in `v0` and `v1`, the second fills in from `v2`.
+  const __m512i x_lo=_mm512_setr_epi32(0,3,6,9,12,15,18,21,24,27,30,1,4,7,10,13);
+  const __m512i x_hi=_mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,17,20,23,26,29);
+  const __m512i y_lo=_mm512_setr_epi32(1,4,7,10,13,16,19,22,25,28,31,2,5,8,11,14);
+  const __m512i y_hi=_mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,18,21,24,27,30);
+  const __m512i z_lo=_mm512_setr_epi32(2,5,8,11,14,17,20,23,26,29,0,3,6,9,12,15);
+  const __m512i z_hi=_mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,16,19,22,25,28,31);
+  const __m512 v0=_mm512_maskz_loadu_ps(_vec3_aos_tail_mask16(rem),p);
+  const __m512 v1=_mm512_maskz_loadu_ps(_vec3_aos_tail_mask16(rem>16? rem-16 : 0),p+16);
+  const __m512 v2=_mm512_maskz_loadu_ps(_vec3_aos_tail_mask16(rem>32? rem-32 : 0),p+32);
+  *x=_mm512_permutex2var_ps(_mm512_permutex2var_ps(v0,x_lo,v1),x_hi,v2);
+  *y=_mm512_permutex2var_ps(_mm512_permutex2var_ps(v0,y_lo,v1),y_hi,v2);
+  *z=_mm512_permutex2var_ps(_mm512_permutex2var_ps(v0,z_lo,v1),z_hi,v2);
+}
+
+/// Stores the `min(rem/3,16)` points of `x`, `y` and `z` at `p`.
+static inline_always target_avx512
+void _vec3_aos_scatter16(f32* p,usize rem,__m512 x,__m512 y,__m512 z) {
+  // The first permute interleaves `x` and `y`, the second slots in `z`.
+  const __m512i o0_xy=_mm512_setr_epi32(0,16,0,1,17,0,2,18,0,3,19,0,4,20,0,5);
+  const __m512i o0_z=_mm512_setr_epi32(0,1,16,3,4,17,6,7,18,9,10,19,12,13,20,15);
+  const __m512i o1_xy=_mm512_setr_epi32(21,0,6,22,0,7,23,0,8,24,0,9,25,0,10,26);
+  const __m512i o1_z=_mm512_setr_epi32(0,21,2,3,22,5,6,23,8,9,24,11,12,25,14,15);
+  const __m512i o2_xy=_mm512_setr_epi32(0,11,27,0,12,28,0,13,29,0,14,30,0,15,31,0);
+  const __m512i o2_z=_mm512_setr_epi32(26,1,2,27,4,5,28,7,8,29,10,11,30,13,14,31);
+  _mm512_mask_storeu_ps(p,_vec3_aos_tail_mask16(rem),
+    _mm512_permutex2var_ps(_mm512_permutex2var_ps(x,o0_xy,y),o0_z,z));
+  _mm512_mask_storeu_ps(p+16,_vec3_aos_tail_mask16(rem>16? rem-16 : 0),
+    _mm512_permutex2var_ps(_mm512_permutex2var_ps(x,o1_xy,y),o1_z,z));
+  _mm512_mask_storeu_ps(p+32,_vec3_aos_tail_mask16(rem>32? rem-32 : 0),
+    _mm512_permutex2var_ps(_mm512_permutex2var_ps(x,o2_xy,y),o2_z,z));
+}
+
+#endif
@@ -0,0 +1,60 @@
+#include "vec3_batch.h"
+#include "math_batch.h"
+
+// These work element by element, and a `Vec3` array is `3*n` packed `f32`s, so each one
+// runs the matching `f32_*_batch` kernel over the whole array without transposing it. The
+// results are those of the `vec3_*` functions bit for bit. A `Vec3Soa` goes through the
+// same kernels one plane at a time.
+
+
+/// Computes `out[i]=vec3_trunc(in[i])` for every `i<n`. `out` may alias `in`.
+void vec3_trunc_batch(const Vec3* in,Vec3* out,usize n) {
+  f32_trunc_batch(&in->x,&out->x,3*n);
+}
+
+/// Computes `out[i]=vec3_floor(in[i])` for every `i<n`. `out` may alias `in`.
+void vec3_floor_batch(const Vec3* in,Vec3* out,usize n) {
+  f32_floor_batch(&in->x,&out->x,3*n);
+}
+
+/// Computes `out[i]=vec3_round(in[i])` for every `i<n`. `out` may alias `in`.
+void vec3_round_batch(const Vec3* in,Vec3* out,usize n) {
+  f32_round_batch(&in->x,&out->x,3*n);
+}
+
+/// Computes `out[i]=vec3_div_euclid(self[i],rhs[i])` for every `i<n`. `out` may alias
+/// `self` or `rhs`.
+void vec3_div_euclid_batch(const Vec3* self,const Vec3* rhs,Vec3* out,usize n) {
+  f32_div_euclid_batch(&self->x,&rhs->x,&out->x,3*n);
+}
+
+/// Computes `out[i]=vec3_rem_euclid(self[i],rhs[i])` for every `i<n`, e.g. to wrap points
+/// into a periodic box. `out` may alias `self` or `rhs`.
+void vec3_rem_euclid_batch(const Vec3* self,const Vec3* rhs,Vec3* out,usize n) {
+  f32_rem_euclid_batch(&self->x,&rhs->x,&out->x,3*n);
+}
+
+/// Works like `vec3_trunc_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_trunc_batch_parallel(const Vec3* in,Vec3* out,usize n) {
+  f32_trunc_batch_parallel(&in->x,&out->x,3*n);
+}
+
+/// Works like `vec3_floor_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_floor_batch_parallel(const Vec3* in,Vec3* out,usize n) {
+  f32_floor_batch_parallel(&in->x,&out->x,3*n);
+}
+
+/// Works like `vec3_round_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_round_batch_parallel(const Vec3* in,Vec3* out,usize n) {
+  f32_round_batch_parallel(&in->x,&out->x,3*n);
+}
+
+/// Works like `vec3_div_euclid_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_div_euclid_batch_parallel(const Vec3* self,const Vec3* rhs,Vec3* out,usize n) {
+  f32_div_euclid_batch_parallel(&self->x,&rhs->x,&out->x,3*n);
+}
+
+/// Works like `vec3_rem_euclid_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_rem_euclid_batch_parallel(const Vec3* self,const Vec3* rhs,Vec3* out,usize n) {
+  f32_rem_euclid_batch_parallel(&self->x,&rhs->x,&out->x,3*n);
+}
@@ -0,0 +1,24 @@
+#ifndef CMETH_F32_VEC3_BATCH_H
+#define CMETH_F32_VEC3_BATCH_H
+#include "../prelude.h"
+#include "vec3.h"
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+void vec3_trunc_batch(const Vec3* in,Vec3* out,usize n);
+void vec3_floor_batch(const Vec3* in,Vec3* out,usize n);
+void vec3_round_batch(const Vec3* in,Vec3* out,usize n);
+void vec3_div_euclid_batch(const Vec3* self,const Vec3* rhs,Vec3* out,usize n);
+void vec3_rem_euclid_batch(const Vec3* self,const Vec3* rhs,Vec3* out,usize n);
+void vec3_trunc_batch_parallel(const Vec3* in,Vec3* out,usize n);
+void vec3_floor_batch_parallel(const Vec3* in,Vec3* out,usize n);
+void vec3_round_batch_parallel(const Vec3* in,Vec3* out,usize n);
+void vec3_div_euclid_batch_parallel(const Vec3* self,const Vec3* rhs,Vec3* out,usize n);
+void vec3_rem_euclid_batch_parallel(const Vec3* self,const Vec3* rhs,Vec3* out,usize n);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,413 @@
+#include <immintrin.h>
+#include <string.h>
+#include "vec3_buffer.h"
+#include "vec3_aos.h"
+#include "../cpu/features.h"
+
+// The out-of-place transposes run the `vec3_aos.h` gathers and scatters on 8 (AVX2) or
+// 16 (AVX-512) points at a time, with masked loads and stores for the last points, and a
+// scalar loop on the baseline. They are bound once at load time from `cmeth_cpu_tier()`.
+//
+// The in-place transposes work on tiles of `VEC3_BUFFER_BLOCK` points, 48 floats or three
+// cache lines:
+//
+// 1. Every tile is transposed on its own, from 16 packed points to 16 `x`s, 16 `y`s and
+//    16 `z`s, in registers.
+// 2. The storage is now a `capacity/16`x3 matrix of 64-byte rows, which is transposed into
+//    the three planes by following the cycles of the permutation, one row in flight and a
+//    bit per row marking the rows already in place.
+//
+// `vec3_buffer_to_aos` runs the inverse permutation and then the tile transposes back.
+// Both only move whole floats, so a round trip gives back the same bits, and both touch
+// the whole capacity, whatever `len` is.
+
+
+#define VEC3_BUFFER_TILE (3*VEC3_BUFFER_BLOCK)
+
+
+static
+void _vec3_aos_to_soa_scalar(const f32* in,f32* x,f32* y,f32* z,usize n) {
+  for(usize i=0;i<n;i++) {
+    x[i]=in[3*i];
+    y[i]=in[3*i+1];
+    z[i]=in[3*i+2];
+  }
+}
+
+static
+void _vec3_soa_to_aos_scalar(const f32* x,const f32* y,const f32* z,f32* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[3*i]=x[i];
+    out[3*i+1]=y[i];
+    out[3*i+2]=z[i];
+  }
+}
+
+static
+void _vec3_buffer_tiles_to_soa_scalar(f32* data,usize tiles) {
+  for(usize t=0;t<tiles;t++) {
+    f32* p=data+t*VEC3_BUFFER_TILE;
+    f32 tile[VEC3_BUFFER_TILE];
+    memcpy(tile,p,sizeof(tile));
+    _vec3_aos_to_soa_scalar(tile,p,p+VEC3_BUFFER_BLOCK,p+2*VEC3_BUFFER_BLOCK,VEC3_BUFFER_BLOCK);
+  }
+}
+
+static
+void _vec3_buffer_tiles_to_aos_scalar(f32* data,usize tiles) {
+  for(usize t=0;t<tiles;t++) {
+    f32* p=data+t*VEC3_BUFFER_TILE;
+    f32 tile[VEC3_BUFFER_TILE];
+    memcpy(tile,p,sizeof(tile));
+    _vec3_soa_to_aos_scalar(tile,tile+VEC3_BUFFER_BLOCK,tile+2*VEC3_BUFFER_BLOCK,p,VEC3_BUFFER_BLOCK);
+  }
+}
+
+
+static target_avx2
+void _vec3_aos_to_soa_avx2(const f32* in,f32* x,f32* y,f32* z,usize n) {
+  for(usize i=0;i<n;i+=8) {
+    __m256 vx,vy,vz;
+    _vec3_aos_gather8(in+3*i,3*(n-i),&vx,&vy,&vz);
+    _vec3_aos_store8(x+i,n-i,vx);
+    _vec3_aos_store8(y+i,n-i,vy);
+    _vec3_aos_store8(z+i,n-i,vz);
+  }
+}
+
+static target_avx2
+void _vec3_soa_to_aos_avx2(const f32* x,const f32* y,const f32* z,f32* out,usize n) {
+  for(usize i=0;i<n;i+=8) {
+    const __m256 vx=_vec3_aos_load8(x+i,n-i);
+    const __m256 vy=_vec3_aos_load8(y+i,n-i);
+    const __m256 vz=_vec3_aos_load8(z+i,n-i);
+    _vec3_aos_scatter8(out+3*i,3*(n-i),vx,vy,vz);
+  }
+}
+
+static target_avx2
+void _vec3_buffer_tiles_to_soa_avx2(f32* data,usize tiles) {
+  for(usize t=0;t<tiles;t++) {
+    f32* p=data+t*VEC3_BUFFER_TILE;
+    __m256 x0,y0,z0,x1,y1,z1;
+    _vec3_aos_gather8(p,24,&x0,&y0,&z0);
+    _vec3_aos_gather8(p+24,24,&x1,&y1,&z1);
+    _mm256_store_ps(p,x0);
+    _mm256_store_ps(p+8,x1);
+    _mm256_store_ps(p+16,y0);
+    _mm256_store_ps(p+24,y1);
+    _mm256_store_ps(p+32,z0);
+    _mm256_store_ps(p+40,z1);
+  }
+}
+
+static target_avx2
+void _vec3_buffer_tiles_to_aos_avx2(f32* data,usize tiles) {
+  for(usize t=0;t<tiles;t++) {
+    f32* p=data+t*VEC3_BUFFER_TILE;
+    const __m256 x0=_mm256_load_ps(p),x1=_mm256_load_ps(p+8);
+    const __m256 y0=_mm256_load_ps(p+16),y1=_mm256_load_ps(p+24);
+    const __m256 z0=_mm256_load_ps(p+32),z1=_mm256_load_ps(p+40);
+    _vec3_aos_scatter8(p,24,x0,y0,z0);
+    _vec3_aos_scatter8(p+24,24,x1,y1,z1);
+  }
+}
+
+
+static target_avx512
+void _vec3_aos_to_soa_avx512(const f32* in,f32* x,f32* y,f32* z,usize n) {
+  for(usize i=0;i<n;i+=16) {
+    __m512 vx,vy,vz;
+    _vec3_aos_gather16(in+3*i,3*(n-i),&vx,&vy,&vz);
+    const __mmask16 mask=_vec3_aos_tail_mask16(n-i);
+    _mm512_mask_storeu_ps(x+i,mask,vx);
+    _mm512_mask_storeu_ps(y+i,mask,vy);
+    _mm512_mask_storeu_ps(z+i,mask,vz);
+  }
+}
+
+static target_avx512
+void _vec3_soa_to_aos_avx512(const f32* x,const f32* y,const f32* z,f32* out,usize n) {
+  for(usize i=0;i<n;i+=16) {
+    const __mmask16 mask=_vec3_aos_tail_mask16(n-i);
+    const __m512 vx=_mm512_maskz_loadu_ps(mask,x+i);
+    const __m512 vy=_mm512_maskz_loadu_ps(mask,y+i);
+    const __m512 vz=_mm512_maskz_loadu_ps(mask,z+i);
+    _vec3_aos_scatter16(out+3*i,3*(n-i),vx,vy,vz);
+  }
+}
+
+static target_avx512
+void _vec3_buffer_tiles_to_soa_avx512(f32* data,usize tiles) {
+  for(usize t=0;t<tiles;t++) {
+    f32* p=data+t*VEC3_BUFFER_TILE;
+    __m512 x,y,z;
+    _vec3_aos_gather16(p,VEC3_BUFFER_TILE,&x,&y,&z);
+    _mm512_store_ps(p,x);
+    _mm512_store_ps(p+16,y);
+    _mm512_store_ps(p+32,z);
+  }
+}
+
+static target_avx512
+void _vec3_buffer_tiles_to_aos_avx512(f32* data,usize tiles) {
+  for(usize t=0;t<tiles;t++) {
+    f32* p=data+t*VEC3_BUFFER_TILE;
+    const __m512 x=_mm512_load_ps(p);
+    const __m512 y=_mm512_load_ps(p+16);
+    const __m512 z=_mm512_load_ps(p+32);
+    _vec3_aos_scatter16(p,VEC3_BUFFER_TILE,x,y,z);
+  }
+}
+
+
+static struct {
+  void (*aos_to_soa)(const f32*,f32*,f32*,f32*,usize);
+  void (*soa_to_aos)(const f32*,const f32*,const f32*,f32*,usize);
+  void (*tiles_to_soa)(f32*,usize);
+  void (*tiles_to_aos)(f32*,usize);
+} _kernels={
+  .aos_to_soa=_vec3_aos_to_soa_scalar,
+  .soa_to_aos=_vec3_soa_to_aos_scalar,
+  .tiles_to_soa=_vec3_buffer_tiles_to_soa_scalar,
+  .tiles_to_aos=_vec3_buffer_tiles_to_aos_scalar,
+};
+
+__attribute__((constructor))
+static void _vec3_buffer_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.aos_to_soa=_vec3_aos_to_soa_avx512;
+      _kernels.soa_to_aos=_vec3_soa_to_aos_avx512;
+      _kernels.tiles_to_soa=_vec3_buffer_tiles_to_soa_avx512;
+      _kernels.tiles_to_aos=_vec3_buffer_tiles_to_aos_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.aos_to_soa=_vec3_aos_to_soa_avx2;
+      _kernels.soa_to_aos=_vec3_soa_to_aos_avx2;
+      _kernels.tiles_to_soa=_vec3_buffer_tiles_to_soa_avx2;
+      _kernels.tiles_to_aos=_vec3_buffer_tiles_to_aos_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Moves the `3*blocks` 64-byte rows at `data` from the tile order to the plane order, or
+/// back when `to_soa` is not set.
+static
+void _vec3_buffer_permute(f32* data,usize blocks,bool to_soa) {
+  const usize rows=3*blocks;
+  u64* placed=calloc((rows+63)/64,sizeof(u64));
+  if(placed==NULL) {
+    panic("vec3_buffer: out of memory\n");
+  }
+  for(usize start=0;start<rows;start++) {
+    if(placed[start/64]>>(start%64)&1) {
+      continue;
+    }
+    f32 carried[VEC3_BUFFER_BLOCK];
+    memcpy(carried,data+start*VEC3_BUFFER_BLOCK,sizeof(carried));
+    usize row=start;
+    do {
+      // Row `3*b+c` of the tiles holds element `c` of block `b`, which goes to row
+      // `c*blocks+b` of the planes.
+      row=to_soa? (row%3)*blocks+row/3 : (row%blocks)*3+row/blocks;
+      f32 swapped[VEC3_BUFFER_BLOCK];
+      f32* dest=data+row*VEC3_BUFFER_BLOCK;
+      memcpy(swapped,dest,sizeof(swapped));
+      memcpy(dest,carried,sizeof(carried));
+      memcpy(carried,swapped,sizeof(carried));
+      placed[row/64]|=(u64)1<<(row%64);
+    } while(row!=start);
+  }
+  free(placed);
+}
+
+static inline_always
+const usize _vec3_buffer_capacity(usize capacity) {
+  return (capacity+VEC3_BUFFER_BLOCK-1)/VEC3_BUFFER_BLOCK*VEC3_BUFFER_BLOCK;
+}
+
+static inline_always
+const usize _vec3_buffer_bytes(usize capacity) {
+  return 3*capacity*sizeof(f32);
+}
+
+static inline_always
+const Vec3Buffer _vec3_buffer(f32* data,usize capacity,Arena* arena,SizePool* pool,bool huge_pages) {
+  return (Vec3Buffer){
+    .data=data,
+    .len=0,
+    .capacity=capacity,
+    .layout=VEC3_LAYOUT_AOS,
+    .arena=arena,
+    .pool=pool,
+    .huge_pages=huge_pages
+  };
+}
+
+
+/// Creates an empty AoS buffer with room for `capacity` points at least, in memory of its
+/// own, from huge pages when `huge_pages` is set and the storage is large enough.
+///
+/// # Panics
+///
+/// Will panic if the allocation fails.
+const Vec3Buffer vec3_buffer_new(usize capacity,bool huge_pages) {
+  capacity=_vec3_buffer_capacity(capacity);
+  return _vec3_buffer(cmeth_alloc_aligned(_vec3_buffer_bytes(capacity),huge_pages),capacity,NULL,NULL,huge_pages);
+}
+
+/// Creates an empty AoS buffer with room for `capacity` points at least, carved from
+/// `arena`. Its storage lives until `arena` is reset or freed.
+///
+/// # Panics
+///
+/// Will panic if the allocation fails.
+const Vec3Buffer vec3_buffer_new_in_arena(Arena* arena,usize capacity) {
+  capacity=_vec3_buffer_capacity(capacity);
+  return _vec3_buffer(arena_alloc(arena,_vec3_buffer_bytes(capacity)),capacity,arena,NULL,false);
+}
+
+/// Creates an empty AoS buffer with room for `capacity` points at least, from `pool`,
+/// which gets the storage back when the buffer is freed. The capacity is grown to fill
+/// the size class.
+///
+/// # Panics
+///
+/// Will panic if the allocation fails, or if the storage is above the largest size class
+/// when `cmeth_assert` is enabled.
+const Vec3Buffer vec3_buffer_new_in_pool(SizePool* pool,usize capacity) {
+  capacity=_vec3_buffer_capacity(capacity);
+  const usize bytes=size_pool_class_size(_vec3_buffer_bytes(capacity));
+  // Whole tiles of the class, which are at least the ones asked for.
+  capacity=bytes/(3*sizeof(f32))/VEC3_BUFFER_BLOCK*VEC3_BUFFER_BLOCK;
+  return _vec3_buffer(size_pool_alloc(pool,bytes),capacity,NULL,pool,false);
+}
+
+/// Gives the storage of `self` back where it came from and leaves it empty. Storage from
+/// an arena stays with the arena.
+void vec3_buffer_free(Vec3Buffer* self) {
+  if(self->pool!=NULL) {
+    size_pool_release(self->pool,self->data,_vec3_buffer_bytes(self->capacity));
+  } else if(self->arena==NULL) {
+    cmeth_free_aligned(self->data,_vec3_buffer_bytes(self->capacity),self->huge_pages);
+  }
+  *self=_vec3_buffer(NULL,0,NULL,NULL,false);
+}
+
+/// Replaces the points of `self` with the `n` points of `points`, in the current layout.
+///
+/// # Panics
+///
+/// Will panic if `n` is greater than `self->capacity` when `cmeth_assert` is enabled.
+void vec3_buffer_assign(Vec3Buffer* self,const Vec3* points,usize n) {
+  cmeth_assert(n<=self->capacity);
+  self->len=n;
+  if(self->layout==VEC3_LAYOUT_AOS) {
+    memcpy(self->data,points,n*sizeof(Vec3));
+  } else {
+    vec3_aos_to_soa(points,vec3_buffer_soa(self));
+  }
+}
+
+/// Writes the `self->len` points of `self` to `out`, whatever the layout.
+void vec3_buffer_copy_to(const Vec3Buffer* self,Vec3* out) {
+  if(self->layout==VEC3_LAYOUT_AOS) {
+    memcpy(out,self->data,self->len*sizeof(Vec3));
+  } else {
+    vec3_soa_to_aos(vec3_buffer_soa(self),out);
+  }
+}
+
+/// Returns the point at `index`, whatever the layout.
+///
+/// # Panics
+///
+/// Will panic if `index` is out of bounds when `cmeth_assert` is enabled.
+const Vec3 vec3_buffer_get(const Vec3Buffer* self,usize index) {
+  cmeth_assert(index<self->len);
+  if(self->layout==VEC3_LAYOUT_AOS) {
+    const f32* p=self->data+3*index;
+    return vec3_new(p[0],p[1],p[2]);
+  }
+  return vec3_new(self->data[index],self->data[self->capacity+index],self->data[2*self->capacity+index]);
+}
+
+/// Replaces the point at `index`, whatever the layout.
+///
+/// # Panics
+///
+/// Will panic if `index` is out of bounds when `cmeth_assert` is enabled.
+void vec3_buffer_set(Vec3Buffer* self,usize index,Vec3 v) {
+  cmeth_assert(index<self->len);
+  if(self->layout==VEC3_LAYOUT_AOS) {
+    vec3_write_to_slice(v,self->data+3*index);
+  } else {
+    self->data[index]=v.x;
+    self->data[self->capacity+index]=v.y;
+    self->data[2*self->capacity+index]=v.z;
+  }
+}
+
+/// Returns the points of `self` as a `Vec3` array of `self->len` elements.
+///
+/// # Panics
+///
+/// Will panic if `self` is not in the AoS layout when `cmeth_assert` is enabled.
+Vec3* vec3_buffer_aos(const Vec3Buffer* self) {
+  cmeth_assert(self->layout==VEC3_LAYOUT_AOS);
+  return (Vec3*)self->data;
+}
+
+/// Returns the points of `self` as a `Vec3Soa` of `self->len` elements, whose planes are
+/// 64-byte aligned.
+///
+/// # Panics
+///
+/// Will panic if `self` is not in the SoA layout when `cmeth_assert` is enabled.
+const Vec3Soa vec3_buffer_soa(const Vec3Buffer* self) {
+  cmeth_assert(self->layout==VEC3_LAYOUT_SOA);
+  return vec3_soa(self->data,self->data+self->capacity,self->data+2*self->capacity,self->len);
+}
+
+/// Switches `self` to the SoA layout in place, keeping its points.
+///
+/// # Panics
+///
+/// Will panic if the bitmap of the permutation can't be allocated.
+void vec3_buffer_to_soa(Vec3Buffer* self) {
+  if(self->layout==VEC3_LAYOUT_SOA) {
+    return;
+  }
+  const usize blocks=self->capacity/VEC3_BUFFER_BLOCK;
+  _kernels.tiles_to_soa(self->data,blocks);
+  _vec3_buffer_permute(self->data,blocks,true);
+  self->layout=VEC3_LAYOUT_SOA;
+}
+
+/// Switches `self` to the AoS layout in place, keeping its points.
+///
+/// # Panics
+///
+/// Will panic if the bitmap of the permutation can't be allocated.
+void vec3_buffer_to_aos(Vec3Buffer* self) {
+  if(self->layout==VEC3_LAYOUT_AOS) {
+    return;
+  }
+  const usize blocks=self->capacity/VEC3_BUFFER_BLOCK;
+  _vec3_buffer_permute(self->data,blocks,false);
+  _kernels.tiles_to_aos(self->data,blocks);
+  self->layout=VEC3_LAYOUT_AOS;
+}
+
+/// Copies the `out.len` points of `in` into the planes of `out`. The two must not overlap.
+void vec3_aos_to_soa(const Vec3* in,Vec3Soa out) {
+  _kernels.aos_to_soa(&in->x,out.x,out.y,out.z,out.len);
+}
+
+/// Copies the `in.len` points of `in` to `out`. The two must not overlap.
+void vec3_soa_to_aos(Vec3Soa in,Vec3* out) {
+  _kernels.soa_to_aos(in.x,in.y,in.z,&out->x,in.len);
+}
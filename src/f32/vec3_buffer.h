@@ -0,0 +1,59 @@
+#ifndef CMETH_F32_VEC3_BUFFER_H
+#define CMETH_F32_VEC3_BUFFER_H
+#include "../prelude.h"
+#include "vec3.h"
+#include "vec3_soa.h"
+#include "../mem/alloc.h"
+
+
+/// Points per tile of the in-place transposes. Capacities are rounded up to a multiple
+/// of it, so every plane of the SoA layout starts on a 64-byte boundary.
+#define VEC3_BUFFER_BLOCK 16
+
+/// How a `Vec3Buffer` lays out its points.
+typedef enum {
+  /// `len` packed `Vec3`s from `data`.
+  VEC3_LAYOUT_AOS=0,
+  /// `len` `x`s from `data`, `y`s from `data+capacity` and `z`s from `data+2*capacity`.
+  VEC3_LAYOUT_SOA=1,
+} Vec3Layout;
+
+/// `capacity` points in 64-byte-aligned storage, which `vec3_buffer_to_soa` and
+/// `vec3_buffer_to_aos` switch between the AoS and SoA layouts in place. So points can be
+/// loaded once and handed to `Vec3*` and `Vec3Soa` kernels alike.
+typedef struct {
+  f32* data;
+  usize len;
+  /// A multiple of `VEC3_BUFFER_BLOCK`.
+  usize capacity;
+  Vec3Layout layout;
+  /// The arena `data` was carved from, which owns it, or NULL.
+  Arena* arena;
+  /// The pool `data` goes back to, or NULL.
+  SizePool* pool;
+  /// Set when `data` is owned by the buffer and was asked for from huge pages.
+  bool huge_pages;
+} Vec3Buffer;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+const Vec3Buffer vec3_buffer_new(usize capacity,bool huge_pages);
+const Vec3Buffer vec3_buffer_new_in_arena(Arena* arena,usize capacity);
+const Vec3Buffer vec3_buffer_new_in_pool(SizePool* pool,usize capacity);
+void vec3_buffer_free(Vec3Buffer* self);
+void vec3_buffer_assign(Vec3Buffer* self,const Vec3* points,usize n);
+void vec3_buffer_copy_to(const Vec3Buffer* self,Vec3* out);
+const Vec3 vec3_buffer_get(const Vec3Buffer* self,usize index);
+void vec3_buffer_set(Vec3Buffer* self,usize index,Vec3 v);
+Vec3* vec3_buffer_aos(const Vec3Buffer* self);
+const Vec3Soa vec3_buffer_soa(const Vec3Buffer* self);
+void vec3_buffer_to_soa(Vec3Buffer* self);
+void vec3_buffer_to_aos(Vec3Buffer* self);
+void vec3_aos_to_soa(const Vec3* in,Vec3Soa out);
+void vec3_soa_to_aos(Vec3Soa in,Vec3* out);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,560 @@
+// The scalar bodies inline the value-type API instead of calling back into the archive.
+#define CMETH_HEADER_ONLY
+#include <immintrin.h>
+#include <math.h>
+#include "vec3_packed.h"
+#include "math_impl.h"
+#include "vec3_aos.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// Every `*_batch` kernel has a scalar body, an AVX2 body and an AVX-512 body, bound once at
+// load time from `cmeth_cpu_tier()`, like the `affine3a_transform_*` kernels.
+//
+// `Vec3F16` and `Vec3Snorm16` convert every element on its own, so their kernels treat the
+// arrays as flat arrays of `3*n` elements and need no transpose: F16C `vcvtps2ph` and
+// `vcvtph2ps` for halves, and clamp, scale and round to nearest even for snorm16. The
+// octahedral kernels work on whole points, transposed with the `vec3_aos.h` helpers.
+//
+// Error bounds, for the value `d` decoded from the encoding of `v`:
+//
+// - `Vec3F16`: round to nearest even, so `|d-v| <= 2^-11*|v|` for `2^-14 <= |v| <= 65504`
+//   and `|d-v| <= 2^-25` below. `|v| >= 65520` becomes an infinity, and NaNs stay NaNs.
+// - `Vec3Snorm16`: `v` is clamped to `[-1,1]`, so `|d-v|` is half a step, `0.5/32767`, plus
+//   the rounding of the decoding product by `1/32767`: below `1.54e-5` within that range.
+//   NaN encodes as `-1`. `-32768` decodes to `-1` like `-32767`.
+// - `Vec3Oct32`: the direction of a non-zero `v` comes back as a unit vector at most
+//   `6.5e-5` radians (0.0037 degrees) away, the worst seen over 20M random directions, and
+//   with a length within `2^-22` of one. The zero vector decodes to some unit vector.
+//
+// Encoding is bit-exact across tiers, and the scalar half conversions match F16C for all
+// 2^32 `f32` and 2^16 binary16 values, NaN payloads included. Octahedral decoding can
+// differ by `2^-22` relative between tiers, where its normalization contracts into FMA.
+
+
+#define SNORM16_MAX 32767.0F
+
+
+/// The binary16 bits nearest to `value`, ties to even, as `vcvtps2ph` rounds.
+static inline_always
+const u16 _vec3_f16_from_f32(f32 value) {
+  const u32 f32_infinity=255u<<23;
+  // The first value that rounds to a binary16 infinity, 65520, is handled by the rounding
+  // below; 65536 and up overflow outright.
+  const u32 f16_overflow=(127u+16u)<<23;
+  const u32 f16_min_normal=(127u-14u)<<23;
+  // Adding 0.5 leaves the binary16 subnormal, rounded by the FPU, in the low mantissa bits.
+  const u32 subnormal_magic=((127u-15u)+(23u-10u)+1u)<<23;
+  u32 bits=f32_to_bits(value);
+  const u32 sign=(bits>>16) & 0x8000;
+  bits&=0x7fffffff;
+  u32 half;
+  if(bits>=f16_overflow) {
+    // NaNs keep the top of their payload and become quiet.
+    half=bits>f32_infinity? 0x7e00 | ((bits>>13) & 0x3ff) : 0x7c00;
+  } else if(bits<f16_min_normal) {
+    half=f32_to_bits(f32_from_bits(bits)+f32_from_bits(subnormal_magic))-subnormal_magic;
+  } else {
+    // Rebias the exponent and round the 13 dropped mantissa bits to nearest even.
+    const u32 odd=(bits>>13) & 1;
+    bits+=((u32)(15-127)<<23)+0xfff+odd;
+    half=bits>>13;
+  }
+  return (u16)(half | sign);
+}
+
+/// The `f32` of the binary16 bits `half`, exact, with signaling NaNs made quiet as
+/// `vcvtph2ps` does.
+static inline_always
+const f32 _vec3_f32_from_f16(u16 half) {
+  const u32 exponent_mask=0x7c00u<<13;
+  u32 bits=((u32)half & 0x7fff)<<13;
+  const u32 exponent=bits & exponent_mask;
+  bits+=(127u-15u)<<23;
+  if(exponent==exponent_mask) {
+    bits+=(128u-16u)<<23;
+    if((bits & 0x7fffff)!=0) {
+      bits|=0x400000;
+    }
+  } else if(exponent==0) {
+    // A subnormal, normalized by the FPU.
+    bits=f32_to_bits(f32_from_bits(bits+(1u<<23))-f32_from_bits(113u<<23));
+  }
+  return f32_from_bits(bits | ((u32)half & 0x8000)<<16);
+}
+
+/// `round(clamp(value,-1,1)*32767)`, with NaN clamped to -1 as `maxps` does.
+static inline_always
+const i16 _vec3_snorm16_from_f32(f32 value) {
+  f32 clamped=value>-1.0F? value : -1.0F;
+  clamped=clamped<1.0F? clamped : 1.0F;
+  return (i16)lrintf(clamped*SNORM16_MAX);
+}
+
+static inline_always
+const f32 _vec3_f32_from_snorm16(i16 value) {
+  const f32 v=(f32)value*(1.0F/SNORM16_MAX);
+  return v>-1.0F? v : -1.0F;
+}
+
+static inline_always
+const Vec3Oct32 _vec3_oct32_encode(f32 x,f32 y,f32 z) {
+  const f32 inv_l1=1.0F/(f32_abs(x)+f32_abs(y)+f32_abs(z));
+  f32 u=x*inv_l1;
+  f32 v=y*inv_l1;
+  if(z<0.0F) {
+    // Fold the lower half over the diagonals of the square.
+    const f32 folded_u=1.0F-f32_abs(v);
+    const f32 folded_v=1.0F-f32_abs(u);
+    u=u>=0.0F? folded_u : -folded_u;
+    v=v>=0.0F? folded_v : -folded_v;
+  }
+  const Vec3Oct32 packed={ .u=_vec3_snorm16_from_f32(u),.v=_vec3_snorm16_from_f32(v) };
+  return packed;
+}
+
+static inline_always
+const Vec3 _vec3_oct32_decode(Vec3Oct32 packed) {
+  f32 u=_vec3_f32_from_snorm16(packed.u);
+  f32 v=_vec3_f32_from_snorm16(packed.v);
+  const f32 z=1.0F-f32_abs(u)-f32_abs(v);
+  // Unfold the lower half: `t` is non-zero only below the equator.
+  const f32 t=-z>0.0F? -z : 0.0F;
+  u=u>=0.0F? u-t : u+t;
+  v=v>=0.0F? v-t : v+t;
+  const f32 inv_len=1.0F/f32_sqrt(u*u+v*v+z*z);
+  return vec3_new(u*inv_len,v*inv_len,z*inv_len);
+}
+
+
+/// Encodes `self` as three half-precision floats, rounding to nearest even.
+const Vec3F16 vec3_to_f16(Vec3 self) {
+  const Vec3F16 packed={
+    .x=_vec3_f16_from_f32(self.x),
+    .y=_vec3_f16_from_f32(self.y),
+    .z=_vec3_f16_from_f32(self.z)
+  };
+  return packed;
+}
+
+/// Decodes three half-precision floats. Every half is exact as an `f32`.
+const Vec3 vec3_from_f16(Vec3F16 packed) {
+  return vec3_new(_vec3_f32_from_f16(packed.x),_vec3_f32_from_f16(packed.y),_vec3_f32_from_f16(packed.z));
+}
+
+/// Encodes `self` as three signed normalized 16-bit integers, clamping every element to
+/// `[-1,1]` first.
+const Vec3Snorm16 vec3_to_snorm16(Vec3 self) {
+  const Vec3Snorm16 packed={
+    .x=_vec3_snorm16_from_f32(self.x),
+    .y=_vec3_snorm16_from_f32(self.y),
+    .z=_vec3_snorm16_from_f32(self.z)
+  };
+  return packed;
+}
+
+/// Decodes three signed normalized 16-bit integers into `[-1,1]`.
+const Vec3 vec3_from_snorm16(Vec3Snorm16 packed) {
+  return vec3_new(_vec3_f32_from_snorm16(packed.x),_vec3_f32_from_snorm16(packed.y),_vec3_f32_from_snorm16(packed.z));
+}
+
+/// Encodes the direction of `self` in 32 bits.
+///
+/// `self` is meant to be normalized, as checked by `vec3_is_normalized`, but any non-zero
+/// vector encodes its direction.
+const Vec3Oct32 vec3_to_oct32(Vec3 self) {
+  return _vec3_oct32_encode(self.x,self.y,self.z);
+}
+
+/// Decodes a direction encoded by `vec3_to_oct32` as a unit vector.
+const Vec3 vec3_from_oct32(Vec3Oct32 packed) {
+  return _vec3_oct32_decode(packed);
+}
+
+
+static
+void _vec3_to_f16_scalar(const f32* in,u16* out,usize len) {
+  for(usize i=0;i<len;i++) {
+    out[i]=_vec3_f16_from_f32(in[i]);
+  }
+}
+
+static
+void _vec3_from_f16_scalar(const u16* in,f32* out,usize len) {
+  for(usize i=0;i<len;i++) {
+    out[i]=_vec3_f32_from_f16(in[i]);
+  }
+}
+
+static
+void _vec3_to_snorm16_scalar(const f32* in,i16* out,usize len) {
+  for(usize i=0;i<len;i++) {
+    out[i]=_vec3_snorm16_from_f32(in[i]);
+  }
+}
+
+static
+void _vec3_from_snorm16_scalar(const i16* in,f32* out,usize len) {
+  for(usize i=0;i<len;i++) {
+    out[i]=_vec3_f32_from_snorm16(in[i]);
+  }
+}
+
+static
+void _vec3_to_oct32_scalar(const Vec3* in,Vec3Oct32* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=_vec3_oct32_encode(in[i].x,in[i].y,in[i].z);
+  }
+}
+
+static
+void _vec3_from_oct32_scalar(const Vec3Oct32* in,Vec3* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=_vec3_oct32_decode(in[i]);
+  }
+}
+
+
+// AVX2 has no 16-bit masked stores, so the flat kernels finish the last elements with the
+// scalar bodies.
+
+static target_avx2
+void _vec3_to_f16_avx2(const f32* in,u16* out,usize len) {
+  usize i=0;
+  for(;i+8<=len;i+=8) {
+    _mm_storeu_si128((__m128i*)(out+i),_mm256_cvtps_ph(_mm256_loadu_ps(in+i),_MM_FROUND_TO_NEAREST_INT));
+  }
+  _vec3_to_f16_scalar(in+i,out+i,len-i);
+}
+
+static target_avx2
+void _vec3_from_f16_avx2(const u16* in,f32* out,usize len) {
+  usize i=0;
+  for(;i+8<=len;i+=8) {
+    _mm256_storeu_ps(out+i,_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in+i))));
+  }
+  _vec3_from_f16_scalar(in+i,out+i,len-i);
+}
+
+static target_avx2
+void _vec3_to_snorm16_avx2(const f32* in,i16* out,usize len) {
+  const __m256 min=_mm256_set1_ps(-1.0F);
+  const __m256 max=_mm256_set1_ps(1.0F);
+  const __m256 scale=_mm256_set1_ps(SNORM16_MAX);
+  usize i=0;
+  for(;i+8<=len;i+=8) {
+    const __m256 clamped=_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in+i),min),max);
+    const __m256i q=_mm256_cvtps_epi32(_mm256_mul_ps(clamped,scale));
+    _mm_storeu_si128((__m128i*)(out+i),_mm_packs_epi32(_mm256_castsi256_si128(q),_mm256_extracti128_si256(q,1)));
+  }
+  _vec3_to_snorm16_scalar(in+i,out+i,len-i);
+}
+
+static target_avx2
+void _vec3_from_snorm16_avx2(const i16* in,f32* out,usize len) {
+  const __m256 min=_mm256_set1_ps(-1.0F);
+  const __m256 inv_scale=_mm256_set1_ps(1.0F/SNORM16_MAX);
+  usize i=0;
+  for(;i+8<=len;i+=8) {
+    const __m256 q=_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in+i))));
+    _mm256_storeu_ps(out+i,_mm256_max_ps(_mm256_mul_ps(q,inv_scale),min));
+  }
+  _vec3_from_snorm16_scalar(in+i,out+i,len-i);
+}
+
+static target_avx2
+void _vec3_to_oct32_avx2(const Vec3* in,Vec3Oct32* out,usize n) {
+  const __m256 sign=_mm256_set1_ps(-0.0F);
+  const __m256 zero=_mm256_setzero_ps();
+  const __m256 one=_mm256_set1_ps(1.0F);
+  const __m256 scale=_mm256_set1_ps(SNORM16_MAX);
+  for(usize i=0;i<n;i+=8) {
+    __m256 x,y,z;
+    _vec3_aos_gather8((const f32*)(in+i),(n-i)*3,&x,&y,&z);
+    const __m256 l1=_mm256_add_ps(_mm256_add_ps(_mm256_andnot_ps(sign,x),_mm256_andnot_ps(sign,y)),_mm256_andnot_ps(sign,z));
+    const __m256 inv_l1=_mm256_div_ps(one,l1);
+    __m256 u=_mm256_mul_ps(x,inv_l1);
+    __m256 v=_mm256_mul_ps(y,inv_l1);
+    const __m256 folded_u=_mm256_sub_ps(one,_mm256_andnot_ps(sign,v));
+    const __m256 folded_v=_mm256_sub_ps(one,_mm256_andnot_ps(sign,u));
+    const __m256 below=_mm256_cmp_ps(z,zero,_CMP_LT_OQ);
+    const __m256 signed_u=_mm256_blendv_ps(_mm256_xor_ps(folded_u,sign),folded_u,_mm256_cmp_ps(u,zero,_CMP_GE_OQ));
+    const __m256 signed_v=_mm256_blendv_ps(_mm256_xor_ps(folded_v,sign),folded_v,_mm256_cmp_ps(v,zero,_CMP_GE_OQ));
+    u=_mm256_blendv_ps(u,signed_u,below);
+    v=_mm256_blendv_ps(v,signed_v,below);
+    const __m256i qu=_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(u,_mm256_xor_ps(one,sign)),one),scale));
+    const __m256i qv=_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(v,_mm256_xor_ps(one,sign)),one),scale));
+    const __m256i packed=_mm256_blend_epi16(qu,_mm256_slli_epi32(qv,16),0xaa);
+    if(n-i>=8) {
+      _mm256_storeu_si256((__m256i*)(out+i),packed);
+    } else {
+      _mm256_maskstore_epi32((i32*)(out+i),_vec3_aos_tail_mask8(n-i),packed);
+    }
+  }
+}
+
+static target_avx2
+void _vec3_from_oct32_avx2(const Vec3Oct32* in,Vec3* out,usize n) {
+  const __m256 sign=_mm256_set1_ps(-0.0F);
+  const __m256 zero=_mm256_setzero_ps();
+  const __m256 one=_mm256_set1_ps(1.0F);
+  const __m256 min=_mm256_set1_ps(-1.0F);
+  const __m256 inv_scale=_mm256_set1_ps(1.0F/SNORM16_MAX);
+  for(usize i=0;i<n;i+=8) {
+    const __m256i packed=n-i>=8?
+      _mm256_loadu_si256((const __m256i*)(in+i)) :
+      _mm256_maskload_epi32((const i32*)(in+i),_vec3_aos_tail_mask8(n-i));
+    const __m256 qu=_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(packed,16),16));
+    const __m256 qv=_mm256_cvtepi32_ps(_mm256_srai_epi32(packed,16));
+    __m256 u=_mm256_max_ps(_mm256_mul_ps(qu,inv_scale),min);
+    __m256 v=_mm256_max_ps(_mm256_mul_ps(qv,inv_scale),min);
+    const __m256 z=_mm256_sub_ps(_mm256_sub_ps(one,_mm256_andnot_ps(sign,u)),_mm256_andnot_ps(sign,v));
+    const __m256 t=_mm256_max_ps(_mm256_xor_ps(z,sign),zero);
+    u=_mm256_blendv_ps(_mm256_add_ps(u,t),_mm256_sub_ps(u,t),_mm256_cmp_ps(u,zero,_CMP_GE_OQ));
+    v=_mm256_blendv_ps(_mm256_add_ps(v,t),_mm256_sub_ps(v,t),_mm256_cmp_ps(v,zero,_CMP_GE_OQ));
+    const __m256 len_sq=_mm256_fmadd_ps(z,z,_mm256_fmadd_ps(v,v,_mm256_mul_ps(u,u)));
+    const __m256 inv_len=_mm256_div_ps(one,_mm256_sqrt_ps(len_sq));
+    _vec3_aos_scatter8((f32*)(out+i),(n-i)*3,_mm256_mul_ps(u,inv_len),_mm256_mul_ps(v,inv_len),_mm256_mul_ps(z,inv_len));
+  }
+}
+
+
+static inline_always target_avx512
+const __mmask16 _vec3_packed_mask16(usize rem) {
+  return rem>=16? (__mmask16)0xFFFF : (__mmask16)((1U<<rem)-1);
+}
+
+static target_avx512
+void _vec3_to_f16_avx512(const f32* in,u16* out,usize len) {
+  for(usize i=0;i<len;i+=16) {
+    const __mmask16 k=_vec3_packed_mask16(len-i);
+    _mm256_mask_storeu_epi16(out+i,k,_mm512_cvtps_ph(_mm512_maskz_loadu_ps(k,in+i),_MM_FROUND_TO_NEAREST_INT));
+  }
+}
+
+static target_avx512
+void _vec3_from_f16_avx512(const u16* in,f32* out,usize len) {
+  for(usize i=0;i<len;i+=16) {
+    const __mmask16 k=_vec3_packed_mask16(len-i);
+    _mm512_mask_storeu_ps(out+i,k,_mm512_cvtph_ps(_mm256_maskz_loadu_epi16(k,in+i)));
+  }
+}
+
+static target_avx512
+void _vec3_to_snorm16_avx512(const f32* in,i16* out,usize len) {
+  const __m512 min=_mm512_set1_ps(-1.0F);
+  const __m512 max=_mm512_set1_ps(1.0F);
+  const __m512 scale=_mm512_set1_ps(SNORM16_MAX);
+  for(usize i=0;i<len;i+=16) {
+    const __mmask16 k=_vec3_packed_mask16(len-i);
+    const __m512 clamped=_mm512_min_ps(_mm512_max_ps(_mm512_maskz_loadu_ps(k,in+i),min),max);
+    _mm512_mask_cvtsepi32_storeu_epi16(out+i,k,_mm512_cvtps_epi32(_mm512_mul_ps(clamped,scale)));
+  }
+}
+
+static target_avx512
+void _vec3_from_snorm16_avx512(const i16* in,f32* out,usize len) {
+  const __m512 min=_mm512_set1_ps(-1.0F);
+  const __m512 inv_scale=_mm512_set1_ps(1.0F/SNORM16_MAX);
+  for(usize i=0;i<len;i+=16) {
+    const __mmask16 k=_vec3_packed_mask16(len-i);
+    const __m512 q=_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm256_maskz_loadu_epi16(k,in+i)));
+    _mm512_mask_storeu_ps(out+i,k,_mm512_max_ps(_mm512_mul_ps(q,inv_scale),min));
+  }
+}
+
+static target_avx512
+void _vec3_to_oct32_avx512(const Vec3* in,Vec3Oct32* out,usize n) {
+  const __m512 sign=_mm512_set1_ps(-0.0F);
+  const __m512 zero=_mm512_setzero_ps();
+  const __m512 one=_mm512_set1_ps(1.0F);
+  const __m512 min=_mm512_set1_ps(-1.0F);
+  const __m512 scale=_mm512_set1_ps(SNORM16_MAX);
+  for(usize i=0;i<n;i+=16) {
+    __m512 x,y,z;
+    _vec3_aos_gather16((const f32*)(in+i),(n-i)*3,&x,&y,&z);
+    const __m512 l1=_mm512_add_ps(_mm512_add_ps(_mm512_abs_ps(x),_mm512_abs_ps(y)),_mm512_abs_ps(z));
+    const __m512 inv_l1=_mm512_div_ps(one,l1);
+    __m512 u=_mm512_mul_ps(x,inv_l1);
+    __m512 v=_mm512_mul_ps(y,inv_l1);
+    const __m512 folded_u=_mm512_sub_ps(one,_mm512_abs_ps(v));
+    const __m512 folded_v=_mm512_sub_ps(one,_mm512_abs_ps(u));
+    const __mmask16 below=_mm512_cmp_ps_mask(z,zero,_CMP_LT_OQ);
+    const __m512 signed_u=_mm512_mask_blend_ps(_mm512_cmp_ps_mask(u,zero,_CMP_GE_OQ),_mm512_xor_ps(folded_u,sign),folded_u);
+    const __m512 signed_v=_mm512_mask_blend_ps(_mm512_cmp_ps_mask(v,zero,_CMP_GE_OQ),_mm512_xor_ps(folded_v,sign),folded_v);
+    u=_mm512_mask_blend_ps(below,u,signed_u);
+    v=_mm512_mask_blend_ps(below,v,signed_v);
+    const __m512i qu=_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_min_ps(_mm512_max_ps(u,min),one),scale));
+    const __m512i qv=_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_min_ps(_mm512_max_ps(v,min),one),scale));
+    const __m512i packed=_mm512_mask_blend_epi16(0xaaaaaaaa,qu,_mm512_slli_epi32(qv,16));
+    _mm512_mask_storeu_epi32(out+i,_vec3_packed_mask16(n-i),packed);
+  }
+}
+
+static target_avx512
+void _vec3_from_oct32_avx512(const Vec3Oct32* in,Vec3* out,usize n) {
+  const __m512 sign=_mm512_set1_ps(-0.0F);
+  const __m512 zero=_mm512_setzero_ps();
+  const __m512 one=_mm512_set1_ps(1.0F);
+  const __m512 min=_mm512_set1_ps(-1.0F);
+  const __m512 inv_scale=_mm512_set1_ps(1.0F/SNORM16_MAX);
+  for(usize i=0;i<n;i+=16) {
+    const __m512i packed=_mm512_maskz_loadu_epi32(_vec3_packed_mask16(n-i),in+i);
+    const __m512 qu=_mm512_cvtepi32_ps(_mm512_srai_epi32(_mm512_slli_epi32(packed,16),16));
+    const __m512 qv=_mm512_cvtepi32_ps(_mm512_srai_epi32(packed,16));
+    __m512 u=_mm512_max_ps(_mm512_mul_ps(qu,inv_scale),min);
+    __m512 v=_mm512_max_ps(_mm512_mul_ps(qv,inv_scale),min);
+    const __m512 z=_mm512_sub_ps(_mm512_sub_ps(one,_mm512_abs_ps(u)),_mm512_abs_ps(v));
+    const __m512 t=_mm512_max_ps(_mm512_xor_ps(z,sign),zero);
+    u=_mm512_mask_blend_ps(_mm512_cmp_ps_mask(u,zero,_CMP_GE_OQ),_mm512_add_ps(u,t),_mm512_sub_ps(u,t));
+    v=_mm512_mask_blend_ps(_mm512_cmp_ps_mask(v,zero,_CMP_GE_OQ),_mm512_add_ps(v,t),_mm512_sub_ps(v,t));
+    const __m512 len_sq=_mm512_fmadd_ps(z,z,_mm512_fmadd_ps(v,v,_mm512_mul_ps(u,u)));
+    const __m512 inv_len=_mm512_div_ps(one,_mm512_sqrt_ps(len_sq));
+    _vec3_aos_scatter16((f32*)(out+i),(n-i)*3,_mm512_mul_ps(u,inv_len),_mm512_mul_ps(v,inv_len),_mm512_mul_ps(z,inv_len));
+  }
+}
+
+
+static struct {
+  void (*to_f16)(const f32*,u16*,usize);
+  void (*from_f16)(const u16*,f32*,usize);
+  void (*to_snorm16)(const f32*,i16*,usize);
+  void (*from_snorm16)(const i16*,f32*,usize);
+  void (*to_oct32)(const Vec3*,Vec3Oct32*,usize);
+  void (*from_oct32)(const Vec3Oct32*,Vec3*,usize);
+} _kernels={
+  .to_f16=_vec3_to_f16_scalar,
+  .from_f16=_vec3_from_f16_scalar,
+  .to_snorm16=_vec3_to_snorm16_scalar,
+  .from_snorm16=_vec3_from_snorm16_scalar,
+  .to_oct32=_vec3_to_oct32_scalar,
+  .from_oct32=_vec3_from_oct32_scalar,
+};
+
+__attribute__((constructor))
+static void _vec3_packed_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.to_f16=_vec3_to_f16_avx512;
+      _kernels.from_f16=_vec3_from_f16_avx512;
+      _kernels.to_snorm16=_vec3_to_snorm16_avx512;
+      _kernels.from_snorm16=_vec3_from_snorm16_avx512;
+      _kernels.to_oct32=_vec3_to_oct32_avx512;
+      _kernels.from_oct32=_vec3_from_oct32_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.to_f16=_vec3_to_f16_avx2;
+      _kernels.from_f16=_vec3_from_f16_avx2;
+      _kernels.to_snorm16=_vec3_to_snorm16_avx2;
+      _kernels.from_snorm16=_vec3_from_snorm16_avx2;
+      _kernels.to_oct32=_vec3_to_oct32_avx2;
+      _kernels.from_oct32=_vec3_from_oct32_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Computes `out[i]=vec3_to_f16(in[i])` for every `i<n`.
+void vec3_to_f16_batch(const Vec3* in,Vec3F16* out,usize n) {
+  _kernels.to_f16((const f32*)in,(u16*)out,n*3);
+}
+
+/// Computes `out[i]=vec3_from_f16(in[i])` for every `i<n`.
+void vec3_from_f16_batch(const Vec3F16* in,Vec3* out,usize n) {
+  _kernels.from_f16((const u16*)in,(f32*)out,n*3);
+}
+
+/// Computes `out[i]=vec3_to_snorm16(in[i])` for every `i<n`.
+void vec3_to_snorm16_batch(const Vec3* in,Vec3Snorm16* out,usize n) {
+  _kernels.to_snorm16((const f32*)in,(i16*)out,n*3);
+}
+
+/// Computes `out[i]=vec3_from_snorm16(in[i])` for every `i<n`.
+void vec3_from_snorm16_batch(const Vec3Snorm16* in,Vec3* out,usize n) {
+  _kernels.from_snorm16((const i16*)in,(f32*)out,n*3);
+}
+
+/// Computes `out[i]=vec3_to_oct32(in[i])` for every `i<n`.
+void vec3_to_oct32_batch(const Vec3* in,Vec3Oct32* out,usize n) {
+  _kernels.to_oct32(in,out,n);
+}
+
+/// Computes `out[i]=vec3_from_oct32(in[i])` for every `i<n`, within `2^-22` relative of
+/// each element, see the top of `vec3_packed.c`.
+void vec3_from_oct32_batch(const Vec3Oct32* in,Vec3* out,usize n) {
+  _kernels.from_oct32(in,out,n);
+}
+
+
+/// The arrays of a `_parallel` call, which every range offsets by its start.
+typedef struct {
+  const void* in;
+  void* out;
+} _Vec3PackedJob;
+
+static void _vec3_to_f16_range(void* ctx,usize begin,usize end) {
+  const _Vec3PackedJob* job=ctx;
+  vec3_to_f16_batch((const Vec3*)job->in+begin,(Vec3F16*)job->out+begin,end-begin);
+}
+
+static void _vec3_from_f16_range(void* ctx,usize begin,usize end) {
+  const _Vec3PackedJob* job=ctx;
+  vec3_from_f16_batch((const Vec3F16*)job->in+begin,(Vec3*)job->out+begin,end-begin);
+}
+
+static void _vec3_to_snorm16_range(void* ctx,usize begin,usize end) {
+  const _Vec3PackedJob* job=ctx;
+  vec3_to_snorm16_batch((const Vec3*)job->in+begin,(Vec3Snorm16*)job->out+begin,end-begin);
+}
+
+static void _vec3_from_snorm16_range(void* ctx,usize begin,usize end) {
+  const _Vec3PackedJob* job=ctx;
+  vec3_from_snorm16_batch((const Vec3Snorm16*)job->in+begin,(Vec3*)job->out+begin,end-begin);
+}
+
+static void _vec3_to_oct32_range(void* ctx,usize begin,usize end) {
+  const _Vec3PackedJob* job=ctx;
+  vec3_to_oct32_batch((const Vec3*)job->in+begin,(Vec3Oct32*)job->out+begin,end-begin);
+}
+
+static void _vec3_from_oct32_range(void* ctx,usize begin,usize end) {
+  const _Vec3PackedJob* job=ctx;
+  vec3_from_oct32_batch((const Vec3Oct32*)job->in+begin,(Vec3*)job->out+begin,end-begin);
+}
+
+/// Works like `vec3_to_f16_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_to_f16_batch_parallel(const Vec3* in,Vec3F16* out,usize n) {
+  _Vec3PackedJob job={in,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_to_f16_range,&job);
+}
+
+/// Works like `vec3_from_f16_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_from_f16_batch_parallel(const Vec3F16* in,Vec3* out,usize n) {
+  _Vec3PackedJob job={in,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_from_f16_range,&job);
+}
+
+/// Works like `vec3_to_snorm16_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_to_snorm16_batch_parallel(const Vec3* in,Vec3Snorm16* out,usize n) {
+  _Vec3PackedJob job={in,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_to_snorm16_range,&job);
+}
+
+/// Works like `vec3_from_snorm16_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_from_snorm16_batch_parallel(const Vec3Snorm16* in,Vec3* out,usize n) {
+  _Vec3PackedJob job={in,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_from_snorm16_range,&job);
+}
+
+/// Works like `vec3_to_oct32_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_to_oct32_batch_parallel(const Vec3* in,Vec3Oct32* out,usize n) {
+  _Vec3PackedJob job={in,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_to_oct32_range,&job);
+}
+
+/// Works like `vec3_from_oct32_batch`, on the threads of the `cmeth_parallel_for` pool.
+void vec3_from_oct32_batch_parallel(const Vec3Oct32* in,Vec3* out,usize n) {
+  _Vec3PackedJob job={in,out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_from_oct32_range,&job);
+}
@@ -0,0 +1,55 @@
+#ifndef CMETH_F32_VEC3_PACKED_H
+#define CMETH_F32_VEC3_PACKED_H
+#include "../prelude.h"
+#include "vec3.h"
+
+
+/// A `Vec3` stored as three IEEE 754 half-precision floats (binary16), in 6 bytes.
+typedef struct {
+  u16 x;
+  u16 y;
+  u16 z;
+} Vec3F16;
+
+/// A `Vec3` with elements in `[-1,1]` stored as three signed normalized 16-bit integers,
+/// `round(v*32767)`, in 6 bytes.
+typedef struct {
+  i16 x;
+  i16 y;
+  i16 z;
+} Vec3Snorm16;
+
+/// A unit `Vec3` stored in 4 bytes as a point of the octahedron `|x|+|y|+|z|=1`, with the
+/// lower half folded over the upper one so that `u` and `v` cover the square `[-1,1]^2`.
+/// `u` and `v` are signed normalized like the elements of `Vec3Snorm16`.
+typedef struct {
+  i16 u;
+  i16 v;
+} Vec3Oct32;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+const Vec3F16 vec3_to_f16(Vec3 self);
+const Vec3 vec3_from_f16(Vec3F16 packed);
+const Vec3Snorm16 vec3_to_snorm16(Vec3 self);
+const Vec3 vec3_from_snorm16(Vec3Snorm16 packed);
+const Vec3Oct32 vec3_to_oct32(Vec3 self);
+const Vec3 vec3_from_oct32(Vec3Oct32 packed);
+void vec3_to_f16_batch(const Vec3* in,Vec3F16* out,usize n);
+void vec3_from_f16_batch(const Vec3F16* in,Vec3* out,usize n);
+void vec3_to_snorm16_batch(const Vec3* in,Vec3Snorm16* out,usize n);
+void vec3_from_snorm16_batch(const Vec3Snorm16* in,Vec3* out,usize n);
+void vec3_to_oct32_batch(const Vec3* in,Vec3Oct32* out,usize n);
+void vec3_from_oct32_batch(const Vec3Oct32* in,Vec3* out,usize n);
+void vec3_to_f16_batch_parallel(const Vec3* in,Vec3F16* out,usize n);
+void vec3_from_f16_batch_parallel(const Vec3F16* in,Vec3* out,usize n);
+void vec3_to_snorm16_batch_parallel(const Vec3* in,Vec3Snorm16* out,usize n);
+void vec3_from_snorm16_batch_parallel(const Vec3Snorm16* in,Vec3* out,usize n);
+void vec3_to_oct32_batch_parallel(const Vec3* in,Vec3Oct32* out,usize n);
+void vec3_from_oct32_batch_parallel(const Vec3Oct32* in,Vec3* out,usize n);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,387 @@
+// The reductions inline the value-type API instead of calling back into the archive.
+#define CMETH_HEADER_ONLY
+#include "vec3_reduce.h"
+#include "vec3_aos.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// The points are reduced in blocks of `VEC3_REDUCE_BLOCK`. Each block is transposed into
+// `x`, `y` and `z` registers by `vec3_aos.h` and reduced lane by lane, then the lanes are
+// folded as a tree; the block totals are combined in order, as the leaves of a balanced
+// tree in pairwise mode and by compensated additions in Kahan mode. The `_parallel`
+// functions hand the blocks to the threads of the `cmeth_parallel_for` pool and combine the
+// totals the same way afterwards, so they return the same bits as the sequential ones
+// whatever the number of threads.
+//
+// The lanes differ between tiers, so results can differ between tiers by rounding errors.
+// Bounds are exact on every tier.
+//
+// `vec3_covariance` takes two passes: the mean, then the products of the offsets from it,
+// which does not cancel catastrophically the way `E[xy]-E[x]E[y]` does for points far from
+// the origin.
+
+
+/// Points per leaf of the pairwise tree within a block.
+#define VEC3_REDUCE_LEAF 64
+
+/// Depth of the pairwise stack within a block, `log2(VEC3_REDUCE_BLOCK/VEC3_REDUCE_LEAF)+1`.
+#define VEC3_REDUCE_DEPTH 7
+
+/// Totals of up to 6 terms, which are `sum[k]-comp[k]`.
+typedef struct {
+  f32 sum[6];
+  f32 comp[6];
+} _Vec3ReducePartial;
+
+/// Adds `rhs_sum-rhs_comp` to `*sum-*comp`, keeping the rounding error of the addition.
+static inline_always
+void _vec3_reduce_merge(f32* sum,f32* comp,f32 rhs_sum,f32 rhs_comp) {
+  const f32 s=*sum+rhs_sum;
+  const f32 rhs_part=s-*sum;
+  const f32 err=(*sum-(s-rhs_part))+(rhs_sum-rhs_part);
+  *sum=s;
+  *comp=(*comp+rhs_comp)-err;
+}
+
+
+#define _PASTE(a,b) a##b
+#define _KERNEL(name,suffix) _PASTE(name,suffix)
+
+typedef f32 f32x4 __attribute__((vector_size(16)));
+typedef i32 i32x4 __attribute__((vector_size(16)));
+
+static inline_always
+void _vec3_reduce_gather4(const f32* p,usize rem,f32x4* x,f32x4* y,f32x4* z) {
+  f32 v[12]={0};
+  __builtin_memcpy(v,p,(rem<12? rem : 12)*sizeof(f32));
+  *x=(f32x4){v[0],v[3],v[6],v[9]};
+  *y=(f32x4){v[1],v[4],v[7],v[10]};
+  *z=(f32x4){v[2],v[5],v[8],v[11]};
+}
+
+#define LANES 4
+#define F32V f32x4
+#define I32V i32x4
+#define GATHER _vec3_reduce_gather4
+#define TARGET
+#define SUFFIX _sse2
+#include "vec3_reduce_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef GATHER
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x8 __attribute__((vector_size(32)));
+typedef i32 i32x8 __attribute__((vector_size(32)));
+
+static inline_always target_avx2
+void _vec3_reduce_gather8(const f32* p,usize rem,f32x8* x,f32x8* y,f32x8* z) {
+  __m256 vx,vy,vz;
+  _vec3_aos_gather8(p,rem,&vx,&vy,&vz);
+  *x=vx;
+  *y=vy;
+  *z=vz;
+}
+
+#define LANES 8
+#define F32V f32x8
+#define I32V i32x8
+#define GATHER _vec3_reduce_gather8
+#define TARGET target_avx2
+#define SUFFIX _avx2
+#include "vec3_reduce_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef GATHER
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x16 __attribute__((vector_size(64)));
+typedef i32 i32x16 __attribute__((vector_size(64)));
+
+static inline_always target_avx512
+void _vec3_reduce_gather16(const f32* p,usize rem,f32x16* x,f32x16* y,f32x16* z) {
+  __m512 vx,vy,vz;
+  _vec3_aos_gather16(p,rem,&vx,&vy,&vz);
+  *x=vx;
+  *y=vy;
+  *z=vz;
+}
+
+#define LANES 16
+#define F32V f32x16
+#define I32V i32x16
+#define GATHER _vec3_reduce_gather16
+#define TARGET target_avx512
+#define SUFFIX _avx512
+#include "vec3_reduce_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef GATHER
+#undef TARGET
+#undef SUFFIX
+
+static struct {
+  const Aabb (*bounds)(const f32*,usize);
+  void (*sum)(const f32*,usize,Vec3,Vec3Summation,_Vec3ReducePartial*);
+  void (*moments)(const f32*,usize,Vec3,Vec3Summation,_Vec3ReducePartial*);
+} _kernels={
+  .bounds=_vec3_reduce_bounds_sse2,
+  .sum=_vec3_reduce_sum_sse2,
+  .moments=_vec3_reduce_moments_sse2,
+};
+
+__attribute__((constructor))
+static void _vec3_reduce_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.bounds=_vec3_reduce_bounds_avx512;
+      _kernels.sum=_vec3_reduce_sum_avx512;
+      _kernels.moments=_vec3_reduce_moments_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.bounds=_vec3_reduce_bounds_avx2;
+      _kernels.sum=_vec3_reduce_sum_avx2;
+      _kernels.moments=_vec3_reduce_moments_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Block totals combined in order: a binary counter of subtrees in pairwise mode, one
+/// compensated total in Kahan mode.
+typedef struct {
+  _Vec3ReducePartial stack[64];
+  usize depth;
+  usize count;
+  usize terms;
+  Vec3Summation summation;
+} _Vec3ReduceTotal;
+
+static
+const _Vec3ReduceTotal _vec3_reduce_total(usize terms,Vec3Summation summation) {
+  _Vec3ReduceTotal total;
+  total.depth=0;
+  total.count=0;
+  total.terms=terms;
+  total.summation=summation;
+  return total;
+}
+
+static
+void _vec3_reduce_push(_Vec3ReduceTotal* self,_Vec3ReducePartial partial) {
+  if(self->summation==VEC3_SUMMATION_KAHAN) {
+    if(self->count++==0) {
+      self->stack[0]=partial;
+      self->depth=1;
+      return;
+    }
+    for(usize k=0;k<self->terms;k++) {
+      _vec3_reduce_merge(&self->stack[0].sum[k],&self->stack[0].comp[k],partial.sum[k],partial.comp[k]);
+    }
+    return;
+  }
+  for(usize c=self->count++;c&1;c>>=1) {
+    self->depth--;
+    for(usize k=0;k<self->terms;k++) {
+      partial.sum[k]=self->stack[self->depth].sum[k]+partial.sum[k];
+    }
+  }
+  self->stack[self->depth++]=partial;
+}
+
+/// Writes the `terms` totals to `out`, zero when nothing was pushed.
+static
+void _vec3_reduce_finish(const _Vec3ReduceTotal* self,f32 out[6]) {
+  for(usize k=0;k<self->terms;k++) {
+    f32 sum=0.0F;
+    for(usize d=self->depth;d-->0;) {
+      sum=self->stack[d].sum[k]-self->stack[d].comp[k]+sum;
+    }
+    out[k]=sum;
+  }
+}
+
+static inline_always
+const usize _vec3_reduce_blocks(usize n) {
+  return (n+VEC3_REDUCE_BLOCK-1)/VEC3_REDUCE_BLOCK;
+}
+
+static inline_always
+const usize _vec3_reduce_block_len(usize n,usize block) {
+  const usize begin=block*VEC3_REDUCE_BLOCK;
+  return n-begin<VEC3_REDUCE_BLOCK? n-begin : VEC3_REDUCE_BLOCK;
+}
+
+static
+const Vec3 _vec3_reduce_mean(const f32 sum[3],usize n) {
+  if(n==0) {
+    return VEC3_ZERO;
+  }
+  return vec3_div_f32(vec3_new(sum[0],sum[1],sum[2]),(f32)n);
+}
+
+static
+const Mat3 _vec3_reduce_covariance(const f32 moments[6],usize n) {
+  if(n==0) {
+    return MAT3_ZERO;
+  }
+  const f32 scale=(f32)n;
+  const f32 cols[9]={
+    moments[0]/scale,moments[1]/scale,moments[2]/scale,
+    moments[1]/scale,moments[3]/scale,moments[4]/scale,
+    moments[2]/scale,moments[4]/scale,moments[5]/scale
+  };
+  return mat3_from_cols_array(cols);
+}
+
+/// Reduces the points block by block to the totals of their `terms` terms.
+static
+void _vec3_reduce(const Vec3* points,usize n,Vec3 center,usize terms,Vec3Summation summation,f32 out[6]) {
+  _Vec3ReduceTotal total=_vec3_reduce_total(terms,summation);
+  const usize blocks=_vec3_reduce_blocks(n);
+  for(usize b=0;b<blocks;b++) {
+    _Vec3ReducePartial partial;
+    const f32* p=&points[b*VEC3_REDUCE_BLOCK].x;
+    if(terms==3) {
+      _kernels.sum(p,_vec3_reduce_block_len(n,b),center,summation,&partial);
+    } else {
+      _kernels.moments(p,_vec3_reduce_block_len(n,b),center,summation,&partial);
+    }
+    _vec3_reduce_push(&total,partial);
+  }
+  _vec3_reduce_finish(&total,out);
+}
+
+
+typedef struct {
+  const Vec3* points;
+  usize n;
+  Vec3 center;
+  usize terms;
+  Vec3Summation summation;
+  _Vec3ReducePartial* partials;
+  Aabb* bounds;
+} _Vec3ReduceJob;
+
+static void _vec3_reduce_range(void* ctx,usize begin,usize end) {
+  const _Vec3ReduceJob* job=ctx;
+  for(usize b=begin;b<end;b++) {
+    const f32* p=&job->points[b*VEC3_REDUCE_BLOCK].x;
+    const usize len=_vec3_reduce_block_len(job->n,b);
+    if(job->bounds!=NULL) {
+      job->bounds[b]=_kernels.bounds(p,len);
+    } else if(job->terms==3) {
+      _kernels.sum(p,len,job->center,job->summation,&job->partials[b]);
+    } else {
+      _kernels.moments(p,len,job->center,job->summation,&job->partials[b]);
+    }
+  }
+}
+
+static
+void _vec3_reduce_parallel(const Vec3* points,usize n,Vec3 center,usize terms,Vec3Summation summation,f32 out[6]) {
+  const usize blocks=_vec3_reduce_blocks(n);
+  _Vec3ReducePartial* partials=malloc((blocks>0? blocks : 1)*sizeof(_Vec3ReducePartial));
+  if(partials==NULL) {
+    panic("vec3_reduce: out of memory\n");
+  }
+  _Vec3ReduceJob job={
+    .points=points,
+    .n=n,
+    .center=center,
+    .terms=terms,
+    .summation=summation,
+    .partials=partials,
+    .bounds=NULL
+  };
+  cmeth_parallel_for(blocks,1,_vec3_reduce_range,&job);
+  _Vec3ReduceTotal total=_vec3_reduce_total(terms,summation);
+  for(usize b=0;b<blocks;b++) {
+    _vec3_reduce_push(&total,partials[b]);
+  }
+  _vec3_reduce_finish(&total,out);
+  free(partials);
+}
+
+
+/// Returns the smallest box containing the `n` points of `points`, `AABB_EMPTY` if `n` is
+/// zero. Unlike `aabb_from_points`, every element skips its `NaN`s.
+const Aabb vec3_bounds(const Vec3* points,usize n) {
+  Aabb bounds=AABB_EMPTY;
+  const usize blocks=_vec3_reduce_blocks(n);
+  for(usize b=0;b<blocks;b++) {
+    bounds=aabb_union(bounds,_kernels.bounds(&points[b*VEC3_REDUCE_BLOCK].x,_vec3_reduce_block_len(n,b)));
+  }
+  return bounds;
+}
+
+/// Returns the sum of the `n` points of `points`, accumulated as `summation` says. The
+/// result only depends on the points and the CPU tier.
+const Vec3 vec3_sum(const Vec3* points,usize n,Vec3Summation summation) {
+  f32 sum[6];
+  _vec3_reduce(points,n,VEC3_ZERO,3,summation,sum);
+  return vec3_new(sum[0],sum[1],sum[2]);
+}
+
+/// Returns the mean, or centroid, of the `n` points of `points`, zero if `n` is zero.
+const Vec3 vec3_mean(const Vec3* points,usize n,Vec3Summation summation) {
+  f32 sum[6];
+  _vec3_reduce(points,n,VEC3_ZERO,3,summation,sum);
+  return _vec3_reduce_mean(sum,n);
+}
+
+/// Returns the covariance matrix of the `n` points of `points`, normalized by `n`, zero
+/// if `n` is zero. Element `(i,j)` is the mean of `(p[i]-m[i])*(p[j]-m[j])`, where `m` is
+/// `vec3_mean(points,n,summation)`.
+const Mat3 vec3_covariance(const Vec3* points,usize n,Vec3Summation summation) {
+  f32 moments[6];
+  _vec3_reduce(points,n,vec3_mean(points,n,summation),6,summation,moments);
+  return _vec3_reduce_covariance(moments,n);
+}
+
+/// Works like `vec3_bounds`, on the threads of the `cmeth_parallel_for` pool.
+const Aabb vec3_bounds_parallel(const Vec3* points,usize n) {
+  const usize blocks=_vec3_reduce_blocks(n);
+  Aabb* bounds=malloc((blocks>0? blocks : 1)*sizeof(Aabb));
+  if(bounds==NULL) {
+    panic("vec3_bounds_parallel: out of memory\n");
+  }
+  _Vec3ReduceJob job={.points=points,.n=n,.bounds=bounds};
+  cmeth_parallel_for(blocks,1,_vec3_reduce_range,&job);
+  Aabb result=AABB_EMPTY;
+  for(usize b=0;b<blocks;b++) {
+    result=aabb_union(result,bounds[b]);
+  }
+  free(bounds);
+  return result;
+}
+
+/// Works like `vec3_sum`, on the threads of the `cmeth_parallel_for` pool. The result is
+/// the same bit for bit.
+const Vec3 vec3_sum_parallel(const Vec3* points,usize n,Vec3Summation summation) {
+  f32 sum[6];
+  _vec3_reduce_parallel(points,n,VEC3_ZERO,3,summation,sum);
+  return vec3_new(sum[0],sum[1],sum[2]);
+}
+
+/// Works like `vec3_mean`, on the threads of the `cmeth_parallel_for` pool. The result is
+/// the same bit for bit.
+const Vec3 vec3_mean_parallel(const Vec3* points,usize n,Vec3Summation summation) {
+  f32 sum[6];
+  _vec3_reduce_parallel(points,n,VEC3_ZERO,3,summation,sum);
+  return _vec3_reduce_mean(sum,n);
+}
+
+/// Works like `vec3_covariance`, on the threads of the `cmeth_parallel_for` pool. The
+/// result is the same bit for bit.
+const Mat3 vec3_covariance_parallel(const Vec3* points,usize n,Vec3Summation summation) {
+  f32 moments[6];
+  _vec3_reduce_parallel(points,n,vec3_mean_parallel(points,n,summation),6,summation,moments);
+  return _vec3_reduce_covariance(moments,n);
+}
@@ -0,0 +1,39 @@
+#ifndef CMETH_F32_VEC3_REDUCE_H
+#define CMETH_F32_VEC3_REDUCE_H
+#include "../prelude.h"
+#include "vec3.h"
+#include "aabb.h"
+#include "mat3.h"
+
+
+/// Points per block of the reductions. The blocks are reduced on their own and their
+/// results combined in order, so a result does not depend on how the blocks were shared
+/// between threads.
+#define VEC3_REDUCE_BLOCK 4096
+
+/// How `vec3_sum`, `vec3_mean` and `vec3_covariance` accumulate.
+typedef enum {
+  /// Runs of 64 points are added up in SIMD lanes and the runs as a balanced tree, so the
+  /// error grows with `log(n)` rather than `n`.
+  VEC3_SUMMATION_PAIRWISE=0,
+  /// Every lane carries the rounding error of its sum and adds it back (Kahan), so the
+  /// error does not grow with `n`, for about twice the additions.
+  VEC3_SUMMATION_KAHAN=1,
+} Vec3Summation;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+const Aabb vec3_bounds(const Vec3* points,usize n);
+const Vec3 vec3_sum(const Vec3* points,usize n,Vec3Summation summation);
+const Vec3 vec3_mean(const Vec3* points,usize n,Vec3Summation summation);
+const Mat3 vec3_covariance(const Vec3* points,usize n,Vec3Summation summation);
+const Aabb vec3_bounds_parallel(const Vec3* points,usize n);
+const Vec3 vec3_sum_parallel(const Vec3* points,usize n,Vec3Summation summation);
+const Vec3 vec3_mean_parallel(const Vec3* points,usize n,Vec3Summation summation);
+const Mat3 vec3_covariance_parallel(const Vec3* points,usize n,Vec3Summation summation);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,183 @@
+// Block kernels of `vec3_reduce.c`.
+//
+// Included once per tier, which defines beforehand:
+//
+// - `LANES`: lanes per vector.
+// - `F32V`, `I32V`: the `f32` and `i32` vector types of `LANES` lanes.
+// - `GATHER(p,rem,x,y,z)`: loads the `min(rem/3,LANES)` points at `p` into `*x`, `*y`
+//   and `*z`, missing points as zero.
+// - `TARGET`: function attributes of the tier (empty for the baseline).
+// - `SUFFIX`: appended to every function name.
+
+#define K(name) _KERNEL(name,SUFFIX)
+
+
+/// The terms of the `min(rem/3,LANES)` points at `p`: their elements, or with `terms==6`
+/// the distinct products of their offsets from `center`. Missing points add nothing.
+static inline_always TARGET
+void K(_vec3_reduce_group)(const f32* p,usize rem,Vec3 center,usize terms,F32V t[6]) {
+  F32V x,y,z;
+  GATHER(p,rem,&x,&y,&z);
+  if(terms==3) {
+    t[0]=x;
+    t[1]=y;
+    t[2]=z;
+    return;
+  }
+  x-=center.x;
+  y-=center.y;
+  z-=center.z;
+  if(rem<3*LANES) {
+    I32V lane;
+    for(usize j=0;j<LANES;j++) {
+      lane[j]=(i32)j;
+    }
+    const I32V valid=lane<(i32)(rem/3);
+    x=(F32V)((I32V)x&valid);
+    y=(F32V)((I32V)y&valid);
+    z=(F32V)((I32V)z&valid);
+  }
+  t[0]=x*x;
+  t[1]=x*y;
+  t[2]=x*z;
+  t[3]=y*y;
+  t[4]=y*z;
+  t[5]=z*z;
+}
+
+/// Sum of the lanes of `v`, as a tree of halves.
+static inline_always TARGET
+const f32 K(_vec3_reduce_hsum)(F32V v) {
+  f32 lanes[LANES];
+  __builtin_memcpy(lanes,&v,sizeof(lanes));
+  for(usize w=LANES/2;w>0;w/=2) {
+    for(usize j=0;j<w;j++) {
+      lanes[j]+=lanes[j+w];
+    }
+  }
+  return lanes[0];
+}
+
+/// Reduces the `n` points at `p`, at most `VEC3_REDUCE_BLOCK`, to the totals of their
+/// `terms` terms.
+static inline_always TARGET
+void K(_vec3_reduce_terms)(const f32* p,usize n,Vec3 center,usize terms,Vec3Summation summation,_Vec3ReducePartial* out) {
+  F32V t[6];
+  if(summation==VEC3_SUMMATION_KAHAN) {
+    F32V sum[6],comp[6];
+    for(usize k=0;k<terms;k++) {
+      sum[k]=(F32V){0};
+      comp[k]=(F32V){0};
+    }
+    for(usize i=0;i<n;i+=LANES) {
+      K(_vec3_reduce_group)(p+3*i,3*(n-i),center,terms,t);
+      for(usize k=0;k<terms;k++) {
+        const F32V y=t[k]-comp[k];
+        const F32V s=sum[k]+y;
+        comp[k]=(s-sum[k])-y;
+        sum[k]=s;
+      }
+    }
+    for(usize k=0;k<terms;k++) {
+      f32 s[LANES],c[LANES];
+      __builtin_memcpy(s,&sum[k],sizeof(s));
+      __builtin_memcpy(c,&comp[k],sizeof(c));
+      for(usize w=LANES/2;w>0;w/=2) {
+        for(usize j=0;j<w;j++) {
+          _vec3_reduce_merge(&s[j],&c[j],s[j+w],c[j+w]);
+        }
+      }
+      out->sum[k]=s[0];
+      out->comp[k]=c[0];
+    }
+    return;
+  }
+
+  // Leaves of `VEC3_REDUCE_LEAF` points, each summed lane by lane, merge as a binary
+  // counter: the leaf `l` merges with as many leaves on the stack as `l` has trailing ones.
+  F32V stack[VEC3_REDUCE_DEPTH][6];
+  usize depth=0;
+  for(usize leaf=0;leaf*VEC3_REDUCE_LEAF<n;leaf++) {
+    const usize begin=leaf*VEC3_REDUCE_LEAF;
+    const usize end=begin+VEC3_REDUCE_LEAF<n? begin+VEC3_REDUCE_LEAF : n;
+    F32V acc[6];
+    for(usize k=0;k<terms;k++) {
+      acc[k]=(F32V){0};
+    }
+    for(usize i=begin;i<end;i+=LANES) {
+      K(_vec3_reduce_group)(p+3*i,3*(end-i),center,terms,t);
+      for(usize k=0;k<terms;k++) {
+        acc[k]+=t[k];
+      }
+    }
+    for(usize l=leaf;l&1;l>>=1) {
+      depth--;
+      for(usize k=0;k<terms;k++) {
+        acc[k]=stack[depth][k]+acc[k];
+      }
+    }
+    for(usize k=0;k<terms;k++) {
+      stack[depth][k]=acc[k];
+    }
+    depth++;
+  }
+  for(usize k=0;k<terms;k++) {
+    F32V acc=(F32V){0};
+    for(usize d=depth;d-->0;) {
+      acc=stack[d][k]+acc;
+    }
+    out->sum[k]=K(_vec3_reduce_hsum)(acc);
+    out->comp[k]=0.0F;
+  }
+}
+
+static TARGET
+void K(_vec3_reduce_sum)(const f32* p,usize n,Vec3 center,Vec3Summation summation,_Vec3ReducePartial* out) {
+  K(_vec3_reduce_terms)(p,n,center,3,summation,out);
+}
+
+static TARGET
+void K(_vec3_reduce_moments)(const f32* p,usize n,Vec3 center,Vec3Summation summation,_Vec3ReducePartial* out) {
+  K(_vec3_reduce_terms)(p,n,center,6,summation,out);
+}
+
+/// Bounds of the `n` points at `p`, each element skipping its `NaN`s.
+static TARGET
+const Aabb K(_vec3_reduce_bounds)(const f32* p,usize n) {
+  F32V lo[3],hi[3];
+  for(usize k=0;k<3;k++) {
+    lo[k]=(F32V){0}+F32_INFINITY;
+    hi[k]=(F32V){0}-F32_INFINITY;
+  }
+  usize i=0;
+  for(;i+LANES<=n;i+=LANES) {
+    F32V v[3];
+    GATHER(p+3*i,3*LANES,&v[0],&v[1],&v[2]);
+    for(usize k=0;k<3;k++) {
+      const I32V below=v[k]<lo[k];
+      const I32V above=v[k]>hi[k];
+      lo[k]=(F32V)(((I32V)v[k]&below)|((I32V)lo[k]&~below));
+      hi[k]=(F32V)(((I32V)v[k]&above)|((I32V)hi[k]&~above));
+    }
+  }
+  f32 min[3],max[3];
+  for(usize k=0;k<3;k++) {
+    f32 l[LANES],h[LANES];
+    __builtin_memcpy(l,&lo[k],sizeof(l));
+    __builtin_memcpy(h,&hi[k],sizeof(h));
+    min[k]=l[0];
+    max[k]=h[0];
+    for(usize j=1;j<LANES;j++) {
+      min[k]=l[j]<min[k]? l[j] : min[k];
+      max[k]=h[j]>max[k]? h[j] : max[k];
+    }
+    for(usize r=i;r<n;r++) {
+      const f32 v=p[3*r+k];
+      min[k]=v<min[k]? v : min[k];
+      max[k]=v>max[k]? v : max[k];
+    }
+  }
+  return aabb_new(vec3_new(min[0],min[1],min[2]),vec3_new(max[0],max[1],max[2]));
+}
+
+#undef K
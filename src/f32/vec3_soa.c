@@ -0,0 +1,778 @@
+// The scalar bodies inline the value-type API instead of calling back into the archive.
+#define CMETH_HEADER_ONLY
+#include <immintrin.h>
+#include "vec3_soa.h"
+#include "math_impl.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// Every kernel has a scalar body built on the `vec3_*` functions, an 8-lane AVX2+FMA body
+// and a 16-lane AVX-512 body, bound once at load time from `cmeth_cpu_tier()`. The SIMD
+// bodies handle the last `len%8` (`len%16`) elements with masked loads and stores, so every
+// element of an array goes through the same arithmetic.
+//
+// Because the SIMD bodies contract `a*b+c` into FMA, results can differ from the scalar
+// functions by a few rounding errors:
+//
+// - `vec3_soa_dot`, `vec3_soa_distance_squared`, `vec3_soa_len_squared`: at most
+//   `2^-22 * (|a.x*b.x| + |a.y*b.y| + |a.z*b.z|)` away from `vec3_dot` and friends.
+// - `vec3_soa_cross`: each element at most `2^-22 * (|p| + |q|)` away, where `p` and `q`
+//   are the two products being subtracted.
+// - `vec3_soa_len`: at most 2 ulp.
+// - `vec3_soa_normalize_or_zero`: at most 3 ulp per element. The result is zero for the
+//   same inputs as `vec3_normalize_or_zero`, except squared lengths within a rounding error
+//   of underflow, where FMA can keep a product the scalar path flushed.
+// - `vec3_soa_len_recip_fast`, `vec3_soa_normalize_or_zero_fast`: the same `3e-7` and `4e-7`
+//   bounds as `vec3_len_recip_fast` and `vec3_normalize_fast`. The AVX-512 body starts from
+//   the more precise `vrsqrt14ps` estimate and stays within `2e-7` and `3e-7`.
+//
+// `vec3_soa_mul_add`, `vec3_soa_axpy` and `vec3_soa_lerp` are built on `f32_mul_add` in the
+// scalar body too, so they give the same results bit for bit on every tier.
+// The price is speed on the scalar tier: this file is built without `-mfma`, so every
+// element costs three libm `fmaf` calls, which CPUs without FMA emulate in software. Those
+// three kernels are for callers who need the single rounding; `vec3_soa_lerp` is several
+// times slower than a `vec3_lerp` loop there.
+
+
+static inline_always target_avx2
+const __m256i _tail_mask(usize rem) {
+  const __m256i lanes=_mm256_setr_epi32(0,1,2,3,4,5,6,7);
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32((i32)rem),lanes);
+}
+
+static inline_always target_avx2
+const __m256 _load8(const f32* p,usize rem) {
+  return rem>=8? _mm256_loadu_ps(p) : _mm256_maskload_ps(p,_tail_mask(rem));
+}
+
+static inline_always target_avx2
+void _store8(f32* p,usize rem,__m256 v) {
+  if(rem>=8) {
+    _mm256_storeu_ps(p,v);
+  } else {
+    _mm256_maskstore_ps(p,_tail_mask(rem),v);
+  }
+}
+
+static inline_always target_avx2
+const __m256 _dot8(__m256 ax,__m256 ay,__m256 az,__m256 bx,__m256 by,__m256 bz) {
+  return _mm256_fmadd_ps(az,bz,_mm256_fmadd_ps(ay,by,_mm256_mul_ps(ax,bx)));
+}
+
+
+static target_avx2
+void _vec3_soa_dot_avx2(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  for(usize i=0;i<self.len;i+=8) {
+    const usize rem=self.len-i;
+    const __m256 dot=_dot8(
+      _load8(self.x+i,rem),_load8(self.y+i,rem),_load8(self.z+i,rem),
+      _load8(rhs.x+i,rem),_load8(rhs.y+i,rem),_load8(rhs.z+i,rem)
+    );
+    _store8(out+i,rem,dot);
+  }
+}
+
+static target_avx2
+void _vec3_soa_cross_avx2(Vec3Soa self,Vec3Soa rhs,Vec3Soa out) {
+  for(usize i=0;i<self.len;i+=8) {
+    const usize rem=self.len-i;
+    const __m256 ax=_load8(self.x+i,rem),ay=_load8(self.y+i,rem),az=_load8(self.z+i,rem);
+    const __m256 bx=_load8(rhs.x+i,rem),by=_load8(rhs.y+i,rem),bz=_load8(rhs.z+i,rem);
+    _store8(out.x+i,rem,_mm256_fmsub_ps(ay,bz,_mm256_mul_ps(by,az)));
+    _store8(out.y+i,rem,_mm256_fmsub_ps(az,bx,_mm256_mul_ps(bz,ax)));
+    _store8(out.z+i,rem,_mm256_fmsub_ps(ax,by,_mm256_mul_ps(bx,ay)));
+  }
+}
+
+static target_avx2
+void _vec3_soa_len_squared_avx2(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i+=8) {
+    const usize rem=self.len-i;
+    const __m256 x=_load8(self.x+i,rem),y=_load8(self.y+i,rem),z=_load8(self.z+i,rem);
+    _store8(out+i,rem,_dot8(x,y,z,x,y,z));
+  }
+}
+
+static target_avx2
+void _vec3_soa_len_avx2(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i+=8) {
+    const usize rem=self.len-i;
+    const __m256 x=_load8(self.x+i,rem),y=_load8(self.y+i,rem),z=_load8(self.z+i,rem);
+    _store8(out+i,rem,_mm256_sqrt_ps(_dot8(x,y,z,x,y,z)));
+  }
+}
+
+static target_avx2
+void _vec3_soa_normalize_or_zero_avx2(Vec3Soa self,Vec3Soa out) {
+  const __m256 zero=_mm256_setzero_ps();
+  const __m256 inf=_mm256_set1_ps(F32_INFINITY);
+  for(usize i=0;i<self.len;i+=8) {
+    const usize rem=self.len-i;
+    const __m256 x=_load8(self.x+i,rem),y=_load8(self.y+i,rem),z=_load8(self.z+i,rem);
+    const __m256 rcp=_mm256_div_ps(_mm256_set1_ps(1.0f),_mm256_sqrt_ps(_dot8(x,y,z,x,y,z)));
+    // Same test as `vec3_normalize_or`: `f32_is_finite(rcp) && rcp>0.0`. NaN fails both.
+    const __m256 ok=_mm256_and_ps(_mm256_cmp_ps(rcp,inf,_CMP_LT_OQ),_mm256_cmp_ps(rcp,zero,_CMP_GT_OQ));
+    _store8(out.x+i,rem,_mm256_and_ps(ok,_mm256_mul_ps(x,rcp)));
+    _store8(out.y+i,rem,_mm256_and_ps(ok,_mm256_mul_ps(y,rcp)));
+    _store8(out.z+i,rem,_mm256_and_ps(ok,_mm256_mul_ps(z,rcp)));
+  }
+}
+
+static target_avx2
+void _vec3_soa_distance_squared_avx2(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  for(usize i=0;i<self.len;i+=8) {
+    const usize rem=self.len-i;
+    const __m256 dx=_mm256_sub_ps(_load8(self.x+i,rem),_load8(rhs.x+i,rem));
+    const __m256 dy=_mm256_sub_ps(_load8(self.y+i,rem),_load8(rhs.y+i,rem));
+    const __m256 dz=_mm256_sub_ps(_load8(self.z+i,rem),_load8(rhs.z+i,rem));
+    _store8(out+i,rem,_dot8(dx,dy,dz,dx,dy,dz));
+  }
+}
+
+/// `rsqrtps` refined by one Newton-Raphson step, as in `f32_rsqrt_fast`.
+static inline_always target_avx2
+const __m256 _rsqrt_fast8(__m256 x) {
+  const __m256 y=_mm256_rsqrt_ps(x);
+  const __m256 half_xy=_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5F),x),y);
+  return _mm256_fmadd_ps(y,_mm256_fnmadd_ps(half_xy,y,_mm256_set1_ps(0.5F)),y);
+}
+
+static target_avx2
+void _vec3_soa_len_recip_fast_avx2(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i+=8) {
+    const usize rem=self.len-i;
+    const __m256 x=_load8(self.x+i,rem),y=_load8(self.y+i,rem),z=_load8(self.z+i,rem);
+    _store8(out+i,rem,_rsqrt_fast8(_dot8(x,y,z,x,y,z)));
+  }
+}
+
+static target_avx2
+void _vec3_soa_normalize_or_zero_fast_avx2(Vec3Soa self,Vec3Soa out) {
+  const __m256 min_normal=_mm256_set1_ps(0x1p-126F);
+  const __m256 inf=_mm256_set1_ps(F32_INFINITY);
+  for(usize i=0;i<self.len;i+=8) {
+    const usize rem=self.len-i;
+    const __m256 x=_load8(self.x+i,rem),y=_load8(self.y+i,rem),z=_load8(self.z+i,rem);
+    const __m256 len_sq=_dot8(x,y,z,x,y,z);
+    const __m256 rcp=_rsqrt_fast8(len_sq);
+    // Same test as `vec3_normalize_or_fast`: normal, finite squared length.
+    const __m256 ok=_mm256_and_ps(_mm256_cmp_ps(len_sq,inf,_CMP_LT_OQ),_mm256_cmp_ps(len_sq,min_normal,_CMP_GE_OQ));
+    _store8(out.x+i,rem,_mm256_and_ps(ok,_mm256_mul_ps(x,rcp)));
+    _store8(out.y+i,rem,_mm256_and_ps(ok,_mm256_mul_ps(y,rcp)));
+    _store8(out.z+i,rem,_mm256_and_ps(ok,_mm256_mul_ps(z,rcp)));
+  }
+}
+
+/// `out[i]=a[i]*b[i]+c[i]` over one plane.
+static inline_always target_avx2
+void _mul_add_plane8(const f32* a,const f32* b,const f32* c,f32* out,usize len) {
+  for(usize i=0;i<len;i+=8) {
+    const usize rem=len-i;
+    _store8(out+i,rem,_mm256_fmadd_ps(_load8(a+i,rem),_load8(b+i,rem),_load8(c+i,rem)));
+  }
+}
+
+/// `out[i]=s*b[i]+(a[i]-s*a[i])` over one plane, as in `vec3_lerp_fma`.
+static inline_always target_avx2
+void _lerp_plane8(const f32* a,const f32* b,__m256 s,f32* out,usize len) {
+  for(usize i=0;i<len;i+=8) {
+    const usize rem=len-i;
+    const __m256 va=_load8(a+i,rem);
+    _store8(out+i,rem,_mm256_fmadd_ps(s,_load8(b+i,rem),_mm256_fnmadd_ps(s,va,va)));
+  }
+}
+
+static target_avx2
+void _vec3_soa_mul_add_avx2(Vec3Soa self,Vec3Soa a,Vec3Soa b,Vec3Soa out) {
+  _mul_add_plane8(self.x,a.x,b.x,out.x,self.len);
+  _mul_add_plane8(self.y,a.y,b.y,out.y,self.len);
+  _mul_add_plane8(self.z,a.z,b.z,out.z,self.len);
+}
+
+static target_avx2
+void _vec3_soa_axpy_avx2(f32 a,Vec3Soa x,Vec3Soa y) {
+  const __m256 va=_mm256_set1_ps(a);
+  for(usize i=0;i<x.len;i+=8) {
+    const usize rem=x.len-i;
+    _store8(y.x+i,rem,_mm256_fmadd_ps(va,_load8(x.x+i,rem),_load8(y.x+i,rem)));
+    _store8(y.y+i,rem,_mm256_fmadd_ps(va,_load8(x.y+i,rem),_load8(y.y+i,rem)));
+    _store8(y.z+i,rem,_mm256_fmadd_ps(va,_load8(x.z+i,rem),_load8(y.z+i,rem)));
+  }
+}
+
+static target_avx2
+void _vec3_soa_lerp_avx2(Vec3Soa self,Vec3Soa rhs,f32 s,Vec3Soa out) {
+  const __m256 vs=_mm256_set1_ps(s);
+  _lerp_plane8(self.x,rhs.x,vs,out.x,self.len);
+  _lerp_plane8(self.y,rhs.y,vs,out.y,self.len);
+  _lerp_plane8(self.z,rhs.z,vs,out.z,self.len);
+}
+
+static inline_always target_avx512
+const __mmask16 _tail_mask16(usize rem) {
+  return rem>=16? (__mmask16)0xffff : (__mmask16)((1u<<rem)-1);
+}
+
+static inline_always target_avx512
+const __m512 _dot16(__m512 ax,__m512 ay,__m512 az,__m512 bx,__m512 by,__m512 bz) {
+  return _mm512_fmadd_ps(az,bz,_mm512_fmadd_ps(ay,by,_mm512_mul_ps(ax,bx)));
+}
+
+
+static target_avx512
+void _vec3_soa_dot_avx512(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  for(usize i=0;i<self.len;i+=16) {
+    const __mmask16 m=_tail_mask16(self.len-i);
+    const __m512 dot=_dot16(
+      _mm512_maskz_loadu_ps(m,self.x+i),_mm512_maskz_loadu_ps(m,self.y+i),_mm512_maskz_loadu_ps(m,self.z+i),
+      _mm512_maskz_loadu_ps(m,rhs.x+i),_mm512_maskz_loadu_ps(m,rhs.y+i),_mm512_maskz_loadu_ps(m,rhs.z+i)
+    );
+    _mm512_mask_storeu_ps(out+i,m,dot);
+  }
+}
+
+static target_avx512
+void _vec3_soa_cross_avx512(Vec3Soa self,Vec3Soa rhs,Vec3Soa out) {
+  for(usize i=0;i<self.len;i+=16) {
+    const __mmask16 m=_tail_mask16(self.len-i);
+    const __m512 ax=_mm512_maskz_loadu_ps(m,self.x+i),ay=_mm512_maskz_loadu_ps(m,self.y+i),az=_mm512_maskz_loadu_ps(m,self.z+i);
+    const __m512 bx=_mm512_maskz_loadu_ps(m,rhs.x+i),by=_mm512_maskz_loadu_ps(m,rhs.y+i),bz=_mm512_maskz_loadu_ps(m,rhs.z+i);
+    _mm512_mask_storeu_ps(out.x+i,m,_mm512_fmsub_ps(ay,bz,_mm512_mul_ps(by,az)));
+    _mm512_mask_storeu_ps(out.y+i,m,_mm512_fmsub_ps(az,bx,_mm512_mul_ps(bz,ax)));
+    _mm512_mask_storeu_ps(out.z+i,m,_mm512_fmsub_ps(ax,by,_mm512_mul_ps(bx,ay)));
+  }
+}
+
+static target_avx512
+void _vec3_soa_len_squared_avx512(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i+=16) {
+    const __mmask16 m=_tail_mask16(self.len-i);
+    const __m512 x=_mm512_maskz_loadu_ps(m,self.x+i),y=_mm512_maskz_loadu_ps(m,self.y+i),z=_mm512_maskz_loadu_ps(m,self.z+i);
+    _mm512_mask_storeu_ps(out+i,m,_dot16(x,y,z,x,y,z));
+  }
+}
+
+static target_avx512
+void _vec3_soa_len_avx512(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i+=16) {
+    const __mmask16 m=_tail_mask16(self.len-i);
+    const __m512 x=_mm512_maskz_loadu_ps(m,self.x+i),y=_mm512_maskz_loadu_ps(m,self.y+i),z=_mm512_maskz_loadu_ps(m,self.z+i);
+    _mm512_mask_storeu_ps(out+i,m,_mm512_sqrt_ps(_dot16(x,y,z,x,y,z)));
+  }
+}
+
+static target_avx512
+void _vec3_soa_normalize_or_zero_avx512(Vec3Soa self,Vec3Soa out) {
+  const __m512 zero=_mm512_setzero_ps();
+  const __m512 inf=_mm512_set1_ps(F32_INFINITY);
+  for(usize i=0;i<self.len;i+=16) {
+    const __mmask16 m=_tail_mask16(self.len-i);
+    const __m512 x=_mm512_maskz_loadu_ps(m,self.x+i),y=_mm512_maskz_loadu_ps(m,self.y+i),z=_mm512_maskz_loadu_ps(m,self.z+i);
+    const __m512 rcp=_mm512_div_ps(_mm512_set1_ps(1.0f),_mm512_sqrt_ps(_dot16(x,y,z,x,y,z)));
+    const __mmask16 ok=_mm512_cmp_ps_mask(rcp,inf,_CMP_LT_OQ) & _mm512_cmp_ps_mask(rcp,zero,_CMP_GT_OQ);
+    _mm512_mask_storeu_ps(out.x+i,m,_mm512_maskz_mul_ps(ok,x,rcp));
+    _mm512_mask_storeu_ps(out.y+i,m,_mm512_maskz_mul_ps(ok,y,rcp));
+    _mm512_mask_storeu_ps(out.z+i,m,_mm512_maskz_mul_ps(ok,z,rcp));
+  }
+}
+
+static target_avx512
+void _vec3_soa_distance_squared_avx512(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  for(usize i=0;i<self.len;i+=16) {
+    const __mmask16 m=_tail_mask16(self.len-i);
+    const __m512 dx=_mm512_sub_ps(_mm512_maskz_loadu_ps(m,self.x+i),_mm512_maskz_loadu_ps(m,rhs.x+i));
+    const __m512 dy=_mm512_sub_ps(_mm512_maskz_loadu_ps(m,self.y+i),_mm512_maskz_loadu_ps(m,rhs.y+i));
+    const __m512 dz=_mm512_sub_ps(_mm512_maskz_loadu_ps(m,self.z+i),_mm512_maskz_loadu_ps(m,rhs.z+i));
+    _mm512_mask_storeu_ps(out+i,m,_dot16(dx,dy,dz,dx,dy,dz));
+  }
+}
+
+
+/// `vrsqrt14ps` refined by one Newton-Raphson step.
+static inline_always target_avx512
+const __m512 _rsqrt_fast16(__m512 x) {
+  const __m512 y=_mm512_rsqrt14_ps(x);
+  const __m512 half_xy=_mm512_mul_ps(_mm512_mul_ps(_mm512_set1_ps(0.5F),x),y);
+  return _mm512_fmadd_ps(y,_mm512_fnmadd_ps(half_xy,y,_mm512_set1_ps(0.5F)),y);
+}
+
+static target_avx512
+void _vec3_soa_len_recip_fast_avx512(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i+=16) {
+    const __mmask16 m=_tail_mask16(self.len-i);
+    const __m512 x=_mm512_maskz_loadu_ps(m,self.x+i),y=_mm512_maskz_loadu_ps(m,self.y+i),z=_mm512_maskz_loadu_ps(m,self.z+i);
+    _mm512_mask_storeu_ps(out+i,m,_rsqrt_fast16(_dot16(x,y,z,x,y,z)));
+  }
+}
+
+static target_avx512
+void _vec3_soa_normalize_or_zero_fast_avx512(Vec3Soa self,Vec3Soa out) {
+  const __m512 min_normal=_mm512_set1_ps(0x1p-126F);
+  const __m512 inf=_mm512_set1_ps(F32_INFINITY);
+  for(usize i=0;i<self.len;i+=16) {
+    const __mmask16 m=_tail_mask16(self.len-i);
+    const __m512 x=_mm512_maskz_loadu_ps(m,self.x+i),y=_mm512_maskz_loadu_ps(m,self.y+i),z=_mm512_maskz_loadu_ps(m,self.z+i);
+    const __m512 len_sq=_dot16(x,y,z,x,y,z);
+    const __m512 rcp=_rsqrt_fast16(len_sq);
+    const __mmask16 ok=_mm512_cmp_ps_mask(len_sq,inf,_CMP_LT_OQ) & _mm512_cmp_ps_mask(len_sq,min_normal,_CMP_GE_OQ);
+    _mm512_mask_storeu_ps(out.x+i,m,_mm512_maskz_mul_ps(ok,x,rcp));
+    _mm512_mask_storeu_ps(out.y+i,m,_mm512_maskz_mul_ps(ok,y,rcp));
+    _mm512_mask_storeu_ps(out.z+i,m,_mm512_maskz_mul_ps(ok,z,rcp));
+  }
+}
+
+static inline_always target_avx512
+void _mul_add_plane16(const f32* a,const f32* b,const f32* c,f32* out,usize len) {
+  for(usize i=0;i<len;i+=16) {
+    const __mmask16 m=_tail_mask16(len-i);
+    const __m512 r=_mm512_fmadd_ps(_mm512_maskz_loadu_ps(m,a+i),_mm512_maskz_loadu_ps(m,b+i),_mm512_maskz_loadu_ps(m,c+i));
+    _mm512_mask_storeu_ps(out+i,m,r);
+  }
+}
+
+static inline_always target_avx512
+void _lerp_plane16(const f32* a,const f32* b,__m512 s,f32* out,usize len) {
+  for(usize i=0;i<len;i+=16) {
+    const __mmask16 m=_tail_mask16(len-i);
+    const __m512 va=_mm512_maskz_loadu_ps(m,a+i);
+    _mm512_mask_storeu_ps(out+i,m,_mm512_fmadd_ps(s,_mm512_maskz_loadu_ps(m,b+i),_mm512_fnmadd_ps(s,va,va)));
+  }
+}
+
+static target_avx512
+void _vec3_soa_mul_add_avx512(Vec3Soa self,Vec3Soa a,Vec3Soa b,Vec3Soa out) {
+  _mul_add_plane16(self.x,a.x,b.x,out.x,self.len);
+  _mul_add_plane16(self.y,a.y,b.y,out.y,self.len);
+  _mul_add_plane16(self.z,a.z,b.z,out.z,self.len);
+}
+
+static target_avx512
+void _vec3_soa_axpy_avx512(f32 a,Vec3Soa x,Vec3Soa y) {
+  const __m512 va=_mm512_set1_ps(a);
+  for(usize i=0;i<x.len;i+=16) {
+    const __mmask16 m=_tail_mask16(x.len-i);
+    _mm512_mask_storeu_ps(y.x+i,m,_mm512_fmadd_ps(va,_mm512_maskz_loadu_ps(m,x.x+i),_mm512_maskz_loadu_ps(m,y.x+i)));
+    _mm512_mask_storeu_ps(y.y+i,m,_mm512_fmadd_ps(va,_mm512_maskz_loadu_ps(m,x.y+i),_mm512_maskz_loadu_ps(m,y.y+i)));
+    _mm512_mask_storeu_ps(y.z+i,m,_mm512_fmadd_ps(va,_mm512_maskz_loadu_ps(m,x.z+i),_mm512_maskz_loadu_ps(m,y.z+i)));
+  }
+}
+
+static target_avx512
+void _vec3_soa_lerp_avx512(Vec3Soa self,Vec3Soa rhs,f32 s,Vec3Soa out) {
+  const __m512 vs=_mm512_set1_ps(s);
+  _lerp_plane16(self.x,rhs.x,vs,out.x,self.len);
+  _lerp_plane16(self.y,rhs.y,vs,out.y,self.len);
+  _lerp_plane16(self.z,rhs.z,vs,out.z,self.len);
+}
+
+
+static
+void _vec3_soa_dot_scalar(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  for(usize i=0;i<self.len;i++) {
+    out[i]=vec3_dot(vec3_soa_get(self,i),vec3_soa_get(rhs,i));
+  }
+}
+
+static
+void _vec3_soa_cross_scalar(Vec3Soa self,Vec3Soa rhs,Vec3Soa out) {
+  for(usize i=0;i<self.len;i++) {
+    vec3_soa_set(out,i,vec3_cross(vec3_soa_get(self,i),vec3_soa_get(rhs,i)));
+  }
+}
+
+static
+void _vec3_soa_len_scalar(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i++) {
+    out[i]=vec3_len(vec3_soa_get(self,i));
+  }
+}
+
+static
+void _vec3_soa_len_squared_scalar(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i++) {
+    out[i]=vec3_len_squared(vec3_soa_get(self,i));
+  }
+}
+
+static
+void _vec3_soa_normalize_or_zero_scalar(Vec3Soa self,Vec3Soa out) {
+  for(usize i=0;i<self.len;i++) {
+    vec3_soa_set(out,i,vec3_normalize_or_zero(vec3_soa_get(self,i)));
+  }
+}
+
+static
+void _vec3_soa_len_recip_fast_scalar(Vec3Soa self,f32* out) {
+  for(usize i=0;i<self.len;i++) {
+    out[i]=vec3_len_recip_fast(vec3_soa_get(self,i));
+  }
+}
+
+static
+void _vec3_soa_normalize_or_zero_fast_scalar(Vec3Soa self,Vec3Soa out) {
+  for(usize i=0;i<self.len;i++) {
+    vec3_soa_set(out,i,vec3_normalize_or_zero_fast(vec3_soa_get(self,i)));
+  }
+}
+
+static
+void _vec3_soa_distance_squared_scalar(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  for(usize i=0;i<self.len;i++) {
+    out[i]=vec3_distance_squared(vec3_soa_get(self,i),vec3_soa_get(rhs,i));
+  }
+}
+
+static
+void _vec3_soa_mul_add_scalar(Vec3Soa self,Vec3Soa a,Vec3Soa b,Vec3Soa out) {
+  for(usize i=0;i<self.len;i++) {
+    vec3_soa_set(out,i,vec3_mul_add(vec3_soa_get(self,i),vec3_soa_get(a,i),vec3_soa_get(b,i)));
+  }
+}
+
+static
+void _vec3_soa_axpy_scalar(f32 a,Vec3Soa x,Vec3Soa y) {
+  for(usize i=0;i<x.len;i++) {
+    vec3_soa_set(y,i,vec3_mul_add(vec3_splat(a),vec3_soa_get(x,i),vec3_soa_get(y,i)));
+  }
+}
+
+static
+void _vec3_soa_lerp_scalar(Vec3Soa self,Vec3Soa rhs,f32 s,Vec3Soa out) {
+  for(usize i=0;i<self.len;i++) {
+    vec3_soa_set(out,i,vec3_lerp_fma(vec3_soa_get(self,i),vec3_soa_get(rhs,i),s));
+  }
+}
+
+
+static struct {
+  void (*dot)(Vec3Soa,Vec3Soa,f32*);
+  void (*cross)(Vec3Soa,Vec3Soa,Vec3Soa);
+  void (*len)(Vec3Soa,f32*);
+  void (*len_squared)(Vec3Soa,f32*);
+  void (*normalize_or_zero)(Vec3Soa,Vec3Soa);
+  void (*distance_squared)(Vec3Soa,Vec3Soa,f32*);
+  void (*len_recip_fast)(Vec3Soa,f32*);
+  void (*normalize_or_zero_fast)(Vec3Soa,Vec3Soa);
+  void (*mul_add)(Vec3Soa,Vec3Soa,Vec3Soa,Vec3Soa);
+  void (*axpy)(f32,Vec3Soa,Vec3Soa);
+  void (*lerp)(Vec3Soa,Vec3Soa,f32,Vec3Soa);
+} _kernels={
+  .dot=_vec3_soa_dot_scalar,
+  .cross=_vec3_soa_cross_scalar,
+  .len=_vec3_soa_len_scalar,
+  .len_squared=_vec3_soa_len_squared_scalar,
+  .normalize_or_zero=_vec3_soa_normalize_or_zero_scalar,
+  .distance_squared=_vec3_soa_distance_squared_scalar,
+  .len_recip_fast=_vec3_soa_len_recip_fast_scalar,
+  .normalize_or_zero_fast=_vec3_soa_normalize_or_zero_fast_scalar,
+  .mul_add=_vec3_soa_mul_add_scalar,
+  .axpy=_vec3_soa_axpy_scalar,
+  .lerp=_vec3_soa_lerp_scalar,
+};
+
+__attribute__((constructor))
+static void _vec3_soa_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.dot=_vec3_soa_dot_avx512;
+      _kernels.cross=_vec3_soa_cross_avx512;
+      _kernels.len=_vec3_soa_len_avx512;
+      _kernels.len_squared=_vec3_soa_len_squared_avx512;
+      _kernels.normalize_or_zero=_vec3_soa_normalize_or_zero_avx512;
+      _kernels.distance_squared=_vec3_soa_distance_squared_avx512;
+      _kernels.len_recip_fast=_vec3_soa_len_recip_fast_avx512;
+      _kernels.normalize_or_zero_fast=_vec3_soa_normalize_or_zero_fast_avx512;
+      _kernels.mul_add=_vec3_soa_mul_add_avx512;
+      _kernels.axpy=_vec3_soa_axpy_avx512;
+      _kernels.lerp=_vec3_soa_lerp_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.dot=_vec3_soa_dot_avx2;
+      _kernels.cross=_vec3_soa_cross_avx2;
+      _kernels.len=_vec3_soa_len_avx2;
+      _kernels.len_squared=_vec3_soa_len_squared_avx2;
+      _kernels.normalize_or_zero=_vec3_soa_normalize_or_zero_avx2;
+      _kernels.distance_squared=_vec3_soa_distance_squared_avx2;
+      _kernels.len_recip_fast=_vec3_soa_len_recip_fast_avx2;
+      _kernels.normalize_or_zero_fast=_vec3_soa_normalize_or_zero_fast_avx2;
+      _kernels.mul_add=_vec3_soa_mul_add_avx2;
+      _kernels.axpy=_vec3_soa_axpy_avx2;
+      _kernels.lerp=_vec3_soa_lerp_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Creates a view over the `x`, `y` and `z` planes, each `len` elements long.
+inline
+const Vec3Soa vec3_soa(f32* x,f32* y,f32* z,usize len) {
+  const Vec3Soa soa={
+    .x=x,
+    .y=y,
+    .z=z,
+    .len=len
+  };
+  return soa;
+}
+
+/// Gathers the vector at `index`.
+///
+/// # Panics
+///
+/// Will panic if `index` is out of bounds when `cmeth_assert` is enabled.
+inline
+const Vec3 vec3_soa_get(Vec3Soa self,usize index) {
+  cmeth_assert(index<self.len);
+  return vec3_new(self.x[index],self.y[index],self.z[index]);
+}
+
+/// Scatters `v` into the planes at `index`.
+///
+/// # Panics
+///
+/// Will panic if `index` is out of bounds when `cmeth_assert` is enabled.
+inline
+void vec3_soa_set(Vec3Soa self,usize index,Vec3 v) {
+  cmeth_assert(index<self.len);
+  self.x[index]=v.x;
+  self.y[index]=v.y;
+  self.z[index]=v.z;
+}
+
+/// Computes `out[i]=vec3_dot(self[i],rhs[i])` for every `i<self.len`.
+///
+/// `rhs` must be at least as long as `self`, and `out` must hold `self.len` elements.
+void vec3_soa_dot(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  cmeth_assert(rhs.len>=self.len);
+  _kernels.dot(self,rhs,out);
+}
+
+/// Computes `out[i]=vec3_cross(self[i],rhs[i])` for every `i<self.len`.
+///
+/// `out` may alias `self` or `rhs`.
+void vec3_soa_cross(Vec3Soa self,Vec3Soa rhs,Vec3Soa out) {
+  cmeth_assert(rhs.len>=self.len && out.len>=self.len);
+  _kernels.cross(self,rhs,out);
+}
+
+/// Computes `out[i]=vec3_len(self[i])` for every `i<self.len`.
+void vec3_soa_len(Vec3Soa self,f32* out) {
+  _kernels.len(self,out);
+}
+
+/// Computes `out[i]=vec3_len_squared(self[i])` for every `i<self.len`.
+void vec3_soa_len_squared(Vec3Soa self,f32* out) {
+  _kernels.len_squared(self,out);
+}
+
+/// Computes `out[i]=vec3_normalize_or_zero(self[i])` for every `i<self.len`.
+///
+/// `out` may alias `self`.
+void vec3_soa_normalize_or_zero(Vec3Soa self,Vec3Soa out) {
+  cmeth_assert(out.len>=self.len);
+  _kernels.normalize_or_zero(self,out);
+}
+
+/// Computes `out[i]=vec3_distance_squared(self[i],rhs[i])` for every `i<self.len`.
+void vec3_soa_distance_squared(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  cmeth_assert(rhs.len>=self.len);
+  _kernels.distance_squared(self,rhs,out);
+}
+
+/// Computes `out[i]=vec3_len_recip_fast(self[i])` for every `i<self.len`.
+void vec3_soa_len_recip_fast(Vec3Soa self,f32* out) {
+  _kernels.len_recip_fast(self,out);
+}
+
+/// Computes `out[i]=vec3_normalize_or_zero_fast(self[i])` for every `i<self.len`.
+///
+/// `out` may alias `self`.
+void vec3_soa_normalize_or_zero_fast(Vec3Soa self,Vec3Soa out) {
+  cmeth_assert(out.len>=self.len);
+  _kernels.normalize_or_zero_fast(self,out);
+}
+
+/// Computes `out[i]=vec3_mul_add(self[i],a[i],b[i])` for every `i<self.len`.
+///
+/// `out` may alias `self`, `a` or `b`.
+void vec3_soa_mul_add(Vec3Soa self,Vec3Soa a,Vec3Soa b,Vec3Soa out) {
+  cmeth_assert(a.len>=self.len && b.len>=self.len && out.len>=self.len);
+  _kernels.mul_add(self,a,b,out);
+}
+
+/// Computes `y[i]=vec3_mul_add(vec3_splat(a),x[i],y[i])`, i.e. `y+=a*x`, for every
+/// `i<x.len`.
+void vec3_soa_axpy(f32 a,Vec3Soa x,Vec3Soa y) {
+  cmeth_assert(y.len>=x.len);
+  _kernels.axpy(a,x,y);
+}
+
+/// Computes `out[i]=vec3_lerp_fma(self[i],rhs[i],s)` for every `i<self.len`.
+///
+/// `out` may alias `self` or `rhs`.
+void vec3_soa_lerp(Vec3Soa self,Vec3Soa rhs,f32 s,Vec3Soa out) {
+  cmeth_assert(rhs.len>=self.len && out.len>=self.len);
+  _kernels.lerp(self,rhs,s,out);
+}
+
+
+/// The elements `[begin,end)` of `self`.
+static inline_always
+const Vec3Soa _vec3_soa_range(Vec3Soa self,usize begin,usize end) {
+  return vec3_soa(self.x+begin,self.y+begin,self.z+begin,end-begin);
+}
+
+/// The arguments of a `_parallel` call. `rhs` is also the `a` of `vec3_soa_mul_add` and
+/// `out` the `y` of `vec3_soa_axpy`, whose `x` is `self`.
+typedef struct {
+  Vec3Soa self;
+  Vec3Soa rhs;
+  Vec3Soa b;
+  Vec3Soa out;
+  f32* out_len;
+  f32 s;
+} _Vec3SoaJob;
+
+static void _vec3_soa_dot_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.dot(_vec3_soa_range(job->self,begin,end),_vec3_soa_range(job->rhs,begin,end),job->out_len+begin);
+}
+
+static void _vec3_soa_cross_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.cross(_vec3_soa_range(job->self,begin,end),_vec3_soa_range(job->rhs,begin,end),_vec3_soa_range(job->out,begin,end));
+}
+
+static void _vec3_soa_len_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.len(_vec3_soa_range(job->self,begin,end),job->out_len+begin);
+}
+
+static void _vec3_soa_len_squared_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.len_squared(_vec3_soa_range(job->self,begin,end),job->out_len+begin);
+}
+
+static void _vec3_soa_normalize_or_zero_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.normalize_or_zero(_vec3_soa_range(job->self,begin,end),_vec3_soa_range(job->out,begin,end));
+}
+
+static void _vec3_soa_distance_squared_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.distance_squared(_vec3_soa_range(job->self,begin,end),_vec3_soa_range(job->rhs,begin,end),job->out_len+begin);
+}
+
+static void _vec3_soa_len_recip_fast_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.len_recip_fast(_vec3_soa_range(job->self,begin,end),job->out_len+begin);
+}
+
+static void _vec3_soa_normalize_or_zero_fast_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.normalize_or_zero_fast(_vec3_soa_range(job->self,begin,end),_vec3_soa_range(job->out,begin,end));
+}
+
+static void _vec3_soa_mul_add_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.mul_add(
+    _vec3_soa_range(job->self,begin,end),_vec3_soa_range(job->rhs,begin,end),
+    _vec3_soa_range(job->b,begin,end),_vec3_soa_range(job->out,begin,end)
+  );
+}
+
+static void _vec3_soa_axpy_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.axpy(job->s,_vec3_soa_range(job->self,begin,end),_vec3_soa_range(job->out,begin,end));
+}
+
+static void _vec3_soa_lerp_range(void* ctx,usize begin,usize end) {
+  const _Vec3SoaJob* job=ctx;
+  _kernels.lerp(_vec3_soa_range(job->self,begin,end),_vec3_soa_range(job->rhs,begin,end),job->s,_vec3_soa_range(job->out,begin,end));
+}
+
+/// Works like `vec3_soa_dot`, on the threads of the `cmeth_parallel_for` pool. The results
+/// are the same bit for bit.
+void vec3_soa_dot_parallel(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  cmeth_assert(rhs.len>=self.len);
+  _Vec3SoaJob job={.self=self,.rhs=rhs,.out_len=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_dot_range,&job);
+}
+
+/// Works like `vec3_soa_cross`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void vec3_soa_cross_parallel(Vec3Soa self,Vec3Soa rhs,Vec3Soa out) {
+  cmeth_assert(rhs.len>=self.len && out.len>=self.len);
+  _Vec3SoaJob job={.self=self,.rhs=rhs,.out=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_cross_range,&job);
+}
+
+/// Works like `vec3_soa_len`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void vec3_soa_len_parallel(Vec3Soa self,f32* out) {
+  _Vec3SoaJob job={.self=self,.out_len=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_len_range,&job);
+}
+
+/// Works like `vec3_soa_normalize_or_zero`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void vec3_soa_normalize_or_zero_parallel(Vec3Soa self,Vec3Soa out) {
+  cmeth_assert(out.len>=self.len);
+  _Vec3SoaJob job={.self=self,.out=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_normalize_or_zero_range,&job);
+}
+
+/// Works like `vec3_soa_len_squared`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void vec3_soa_len_squared_parallel(Vec3Soa self,f32* out) {
+  _Vec3SoaJob job={.self=self,.out_len=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_len_squared_range,&job);
+}
+
+/// Works like `vec3_soa_distance_squared`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void vec3_soa_distance_squared_parallel(Vec3Soa self,Vec3Soa rhs,f32* out) {
+  cmeth_assert(rhs.len>=self.len);
+  _Vec3SoaJob job={.self=self,.rhs=rhs,.out_len=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_distance_squared_range,&job);
+}
+
+/// Works like `vec3_soa_len_recip_fast`, on the threads of the `cmeth_parallel_for` pool.
+/// The results are the same bit for bit.
+void vec3_soa_len_recip_fast_parallel(Vec3Soa self,f32* out) {
+  _Vec3SoaJob job={.self=self,.out_len=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_len_recip_fast_range,&job);
+}
+
+/// Works like `vec3_soa_normalize_or_zero_fast`, on the threads of the
+/// `cmeth_parallel_for` pool. The results are the same bit for bit.
+void vec3_soa_normalize_or_zero_fast_parallel(Vec3Soa self,Vec3Soa out) {
+  cmeth_assert(out.len>=self.len);
+  _Vec3SoaJob job={.self=self,.out=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_normalize_or_zero_fast_range,&job);
+}
+
+/// Works like `vec3_soa_mul_add`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void vec3_soa_mul_add_parallel(Vec3Soa self,Vec3Soa a,Vec3Soa b,Vec3Soa out) {
+  cmeth_assert(a.len>=self.len && b.len>=self.len && out.len>=self.len);
+  _Vec3SoaJob job={.self=self,.rhs=a,.b=b,.out=out};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_mul_add_range,&job);
+}
+
+/// Works like `vec3_soa_axpy`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void vec3_soa_axpy_parallel(f32 a,Vec3Soa x,Vec3Soa y) {
+  cmeth_assert(y.len>=x.len);
+  _Vec3SoaJob job={.self=x,.out=y,.s=a};
+  cmeth_parallel_for(x.len,CMETH_PARALLEL_GRAIN,_vec3_soa_axpy_range,&job);
+}
+
+/// Works like `vec3_soa_lerp`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void vec3_soa_lerp_parallel(Vec3Soa self,Vec3Soa rhs,f32 s,Vec3Soa out) {
+  cmeth_assert(rhs.len>=self.len && out.len>=self.len);
+  _Vec3SoaJob job={.self=self,.rhs=rhs,.out=out,.s=s};
+  cmeth_parallel_for(self.len,CMETH_PARALLEL_GRAIN,_vec3_soa_lerp_range,&job);
+}
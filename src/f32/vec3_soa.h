@@ -0,0 +1,50 @@
+#ifndef CMETH_F32_VEC3_SOA_H
+#define CMETH_F32_VEC3_SOA_H
+#include "../prelude.h"
+#include "vec3.h"
+
+
+/// A structure-of-arrays view over `len` 3-dimensional vectors.
+///
+/// `x`, `y` and `z` each point at `len` elements. The view does not own its planes and
+/// they need no particular alignment.
+typedef struct {
+  f32* x;
+  f32* y;
+  f32* z;
+  usize len;
+} Vec3Soa;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+const Vec3Soa vec3_soa(f32* x,f32* y,f32* z,usize len);
+const Vec3 vec3_soa_get(Vec3Soa self,usize index);
+void vec3_soa_set(Vec3Soa self,usize index,Vec3 v);
+void vec3_soa_dot(Vec3Soa self,Vec3Soa rhs,f32* out);
+void vec3_soa_cross(Vec3Soa self,Vec3Soa rhs,Vec3Soa out);
+void vec3_soa_len(Vec3Soa self,f32* out);
+void vec3_soa_len_squared(Vec3Soa self,f32* out);
+void vec3_soa_normalize_or_zero(Vec3Soa self,Vec3Soa out);
+void vec3_soa_distance_squared(Vec3Soa self,Vec3Soa rhs,f32* out);
+void vec3_soa_len_recip_fast(Vec3Soa self,f32* out);
+void vec3_soa_normalize_or_zero_fast(Vec3Soa self,Vec3Soa out);
+void vec3_soa_mul_add(Vec3Soa self,Vec3Soa a,Vec3Soa b,Vec3Soa out);
+void vec3_soa_axpy(f32 a,Vec3Soa x,Vec3Soa y);
+void vec3_soa_lerp(Vec3Soa self,Vec3Soa rhs,f32 s,Vec3Soa out);
+void vec3_soa_dot_parallel(Vec3Soa self,Vec3Soa rhs,f32* out);
+void vec3_soa_cross_parallel(Vec3Soa self,Vec3Soa rhs,Vec3Soa out);
+void vec3_soa_len_parallel(Vec3Soa self,f32* out);
+void vec3_soa_len_squared_parallel(Vec3Soa self,f32* out);
+void vec3_soa_normalize_or_zero_parallel(Vec3Soa self,Vec3Soa out);
+void vec3_soa_distance_squared_parallel(Vec3Soa self,Vec3Soa rhs,f32* out);
+void vec3_soa_len_recip_fast_parallel(Vec3Soa self,f32* out);
+void vec3_soa_normalize_or_zero_fast_parallel(Vec3Soa self,Vec3Soa out);
+void vec3_soa_mul_add_parallel(Vec3Soa self,Vec3Soa a,Vec3Soa b,Vec3Soa out);
+void vec3_soa_axpy_parallel(f32 a,Vec3Soa x,Vec3Soa y);
+void vec3_soa_lerp_parallel(Vec3Soa self,Vec3Soa rhs,f32 s,Vec3Soa out);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
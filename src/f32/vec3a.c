@@ -0,0 +1,884 @@
+#include "vec3a.h"
+#include "math_impl.h"
+#include "prelude.h"
+#include <immintrin.h>
+
+// Lane helpers shared by the functions below. SSE2 has no `roundps`, so the rounding family
+// is built on `cvttps2dq`, which is exact for every `|x| < 2^23` (larger values have no
+// fractional part and pass through unchanged).
+
+static inline_always
+const __m128 _m128_sign_mask() {
+  return _mm_set1_ps(-0.0f);
+}
+
+static inline_always
+const __m128 _m128_abs(__m128 v) {
+  return _mm_andnot_ps(_m128_sign_mask(),v);
+}
+
+static inline_always
+const __m128 _m128_select(__m128 mask,__m128 if_true,__m128 if_false) {
+#ifdef __SSE4_1__
+  // Every lane of the masks is all ones or all zeros, so the sign bit decides alone.
+  return _mm_blendv_ps(if_false,if_true,mask);
+#else
+  return _mm_or_ps(_mm_and_ps(mask,if_true),_mm_andnot_ps(mask,if_false));
+#endif
+}
+
+/// Dot product of the `xyz` lanes, in lane 0.
+static inline_always
+const __m128 _m128_dot3(__m128 lhs,__m128 rhs) {
+  const __m128 x2_y2_z2_w2=_mm_mul_ps(lhs,rhs);
+  const __m128 y2_0_0_0=_mm_shuffle_ps(x2_y2_z2_w2,x2_y2_z2_w2,_MM_SHUFFLE(0,0,0,1));
+  const __m128 z2_0_0_0=_mm_shuffle_ps(x2_y2_z2_w2,x2_y2_z2_w2,_MM_SHUFFLE(0,0,0,2));
+  const __m128 x2y2_0_0_0=_mm_add_ss(x2_y2_z2_w2,y2_0_0_0);
+  return _mm_add_ss(x2y2_0_0_0,z2_0_0_0);
+}
+
+static inline_always
+const __m128 _m128_trunc(__m128 v) {
+  const __m128 no_fraction=_mm_set1_ps(8388608.0f);
+  const __m128 in_range=_mm_cmplt_ps(_m128_abs(v),no_fraction);
+  const __m128 truncated=_mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+  // Put the sign back so `-0.5` truncates to `-0.0` like `truncf`.
+  const __m128 signed_truncated=_mm_or_ps(truncated,_mm_and_ps(v,_m128_sign_mask()));
+  return _m128_select(in_range,signed_truncated,v);
+}
+
+static inline_always
+const __m128 _m128_floor(__m128 v) {
+  const __m128 t=_m128_trunc(v);
+  const __m128 too_big=_mm_cmpgt_ps(t,v);
+  return _m128_select(too_big,_mm_sub_ps(t,_mm_set1_ps(1.0f)),t);
+}
+
+static inline_always
+const __m128 _m128_ceil(__m128 v) {
+  const __m128 t=_m128_trunc(v);
+  const __m128 too_small=_mm_cmplt_ps(t,v);
+  return _m128_select(too_small,_mm_add_ps(t,_mm_set1_ps(1.0f)),t);
+}
+
+/// Rounds half-way cases away from zero, like `roundf`.
+static inline_always
+const __m128 _m128_round(__m128 v) {
+  const __m128 t=_m128_trunc(v);
+  const __m128 half_or_more=_mm_cmpge_ps(_m128_abs(_mm_sub_ps(v,t)),_mm_set1_ps(0.5f));
+  const __m128 one=_mm_or_ps(_mm_set1_ps(1.0f),_mm_and_ps(v,_m128_sign_mask()));
+  return _m128_select(half_or_more,_mm_add_ps(t,one),t);
+}
+
+
+/// Creates a 3-dimensional vector.
+inline_always
+const Vec3A vec3a(f32 x,f32 y,f32 z) {
+  return vec3a_new(x,y,z);
+}
+
+/// Creates a new vector.
+inline_always
+const Vec3A vec3a_new(f32 x,f32 y,f32 z) {
+  return vec3a_from_m128(_mm_set_ps(z,z,y,x));
+}
+
+/// Creates a vector with all elements set to `v`.
+inline_always
+const Vec3A vec3a_splat(f32 v) {
+  return vec3a_from_m128(_mm_set1_ps(v));
+}
+
+/// Wraps a raw SSE register. The `w` lane is ignored.
+inline_always
+const Vec3A vec3a_from_m128(__m128 v) {
+  const Vec3A vec={ .inner=v };
+  return vec;
+}
+
+/// Converts a `Vec3` into a `Vec3A`. This is lossless.
+inline_always
+const Vec3A vec3a_from_vec3(Vec3 v) {
+  return vec3a_new(v.x,v.y,v.z);
+}
+
+/// Converts a `Vec3A` into a `Vec3`, dropping the padding lane. This is lossless.
+inline_always
+const Vec3 vec3_from_vec3a(Vec3A v) {
+  return vec3_new(v.inner[0],v.inner[1],v.inner[2]);
+}
+
+/// Returns the `x` element of `self`.
+inline_always
+const f32 vec3a_x(Vec3A self) {
+  return self.inner[0];
+}
+
+/// Returns the `y` element of `self`.
+inline_always
+const f32 vec3a_y(Vec3A self) {
+  return self.inner[1];
+}
+
+/// Returns the `z` element of `self`.
+inline_always
+const f32 vec3a_z(Vec3A self) {
+  return self.inner[2];
+}
+
+/// Creates a vector from the elements in `if_true` and `if_false`, selecting which to use
+/// for each element of `self`.
+///
+/// A true element in the mask uses the corresponding element from `if_true`, and false
+/// uses the element from `if_false`.
+inline_always
+const Vec3A vec3a_select(BVec3A mask,Vec3A if_true,Vec3A if_false) {
+  return vec3a_from_m128(_m128_select(mask.inner,if_true.inner,if_false.inner));
+}
+
+/// Returns a vector containing each element of `self` modified by a mapping function `f`.
+inline
+const Vec3A vec3a_map(Vec3A self,f32 (*f)(f32)) {
+  return vec3a_new(f(self.inner[0]),f(self.inner[1]),f(self.inner[2]));
+}
+
+/// Creates a new vector from an array.
+inline
+const Vec3A vec3a_from_array(f32 a[3]) {
+  return vec3a_new(a[0],a[1],a[2]);
+}
+
+/// writes the elements of `self` to the first 3 elements in `slice`.
+///
+/// # panics
+///
+///panics if `slice` is less than 3 elements long.
+inline
+void vec3a_write_to_slice(Vec3A self,f32* slice) {
+  slice[0]=self.inner[0];
+  slice[1]=self.inner[1];
+  slice[2]=self.inner[2];
+}
+
+/// Creates a 3D vector from a 4D vector, discarding `w`.
+inline
+const Vec3A vec3a_from_vec4(f32 v[4]) {
+  return vec3a_from_m128(_mm_loadu_ps(v));
+}
+
+/// Creates a 3D vector from `self` with the given value of `x`.
+inline
+const Vec3A vec3a_with_x(Vec3A self,f32 x) {
+  self.inner[0]=x;
+  return self;
+}
+
+/// Creates a 3D vector from `self` with the given value of `y`.
+inline
+const Vec3A vec3a_with_y(Vec3A self,f32 y) {
+  self.inner[1]=y;
+  return self;
+}
+
+/// Creates a 3D vector from `self` with the given value of `z`.
+inline
+const Vec3A vec3a_with_z(Vec3A self,f32 z) {
+  self.inner[2]=z;
+  return self;
+}
+
+/// Computes the dot product of `self` and `rhs`.
+inline_always
+const f32 vec3a_dot(Vec3A self,Vec3A rhs) {
+  return _mm_cvtss_f32(_m128_dot3(self.inner,rhs.inner));
+}
+
+/// Returns a vector where every component is the dot product of `self` and `rhs`.
+inline_always
+const Vec3A vec3a_dot_into_vec(Vec3A self,Vec3A rhs) {
+  const __m128 dot=_m128_dot3(self.inner,rhs.inner);
+  return vec3a_from_m128(_mm_shuffle_ps(dot,dot,_MM_SHUFFLE(0,0,0,0)));
+}
+
+/// Computes the cross product of `self` and `rhs`.
+inline_always
+const Vec3A vec3a_cross(Vec3A self,Vec3A rhs) {
+  // (self.zxy * rhs - rhs.zxy * self).zxy
+  const __m128 lhszxy=_mm_shuffle_ps(self.inner,self.inner,_MM_SHUFFLE(1,1,0,2));
+  const __m128 rhszxy=_mm_shuffle_ps(rhs.inner,rhs.inner,_MM_SHUFFLE(1,1,0,2));
+  const __m128 sub=_mm_sub_ps(_mm_mul_ps(lhszxy,rhs.inner),_mm_mul_ps(rhszxy,self.inner));
+  return vec3a_from_m128(_mm_shuffle_ps(sub,sub,_MM_SHUFFLE(1,1,0,2)));
+}
+
+/// Returns a vector containing the minimum values for each element of `self` and `rhs`.
+///
+/// In other words this computes `[MIN(self.x,rhs.x), MIN(self.y,rhs.y), ..]`.
+inline_always
+const Vec3A vec3a_min(Vec3A self,Vec3A rhs) {
+  return vec3a_from_m128(_mm_min_ps(self.inner,rhs.inner));
+}
+
+/// Returns a vector containing the maximum values for each element of `self` and `rhs`.
+///
+/// In other words this computes `[MAX(self.x,rhs.x), MAX(self.y,rhs.y), ..]`.
+inline_always
+const Vec3A vec3a_max(Vec3A self,Vec3A rhs) {
+  return vec3a_from_m128(_mm_max_ps(self.inner,rhs.inner));
+}
+
+/// Component-wise clamping of values, similar to `f32_clamp`.
+///
+/// Each element in `min` must be less-or-equal to the corresponding element in `max`.
+///
+/// # Panics
+///
+/// Will panic if `min` is greater than `max` when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_clamp(Vec3A self,Vec3A min,Vec3A max) {
+  cmeth_assert(bvec3a_all(vec3a_cmple(min,max)));
+  return vec3a_min(vec3a_max(self,min),max);
+}
+
+/// Returns the horizontal minimum of `self`.
+///
+/// In other words this computes `MIN(x, y, ..)`.
+inline
+const f32 vec3a_min_element(Vec3A self) {
+  const __m128 v=self.inner;
+  const __m128 m=_mm_min_ps(v,_mm_shuffle_ps(v,v,_MM_SHUFFLE(1,1,2,2)));
+  return _mm_cvtss_f32(_mm_min_ps(m,_mm_shuffle_ps(m,m,_MM_SHUFFLE(0,0,0,1))));
+}
+
+/// Returns the horizontal maximum of `self`.
+///
+/// In other words this computes `MAX(x, y, ..)`.
+inline
+const f32 vec3a_max_element(Vec3A self) {
+  const __m128 v=self.inner;
+  const __m128 m=_mm_max_ps(v,_mm_shuffle_ps(v,v,_MM_SHUFFLE(1,1,2,2)));
+  return _mm_cvtss_f32(_mm_max_ps(m,_mm_shuffle_ps(m,m,_MM_SHUFFLE(0,0,0,1))));
+}
+
+/// Returns the sum of all elements of `self`.
+///
+/// In other words, this computes `self.x + self.y + ..`.
+inline
+const f32 vec3a_element_sum(Vec3A self) {
+  const __m128 v=self.inner;
+  const __m128 xy=_mm_add_ss(v,_mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,1)));
+  return _mm_cvtss_f32(_mm_add_ss(xy,_mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,2))));
+}
+
+/// Returns the product of all elements of `self`.
+///
+/// In other words, this computes `self.x * self.y * ..`.
+inline
+const f32 vec3a_element_product(Vec3A self) {
+  const __m128 v=self.inner;
+  const __m128 xy=_mm_mul_ss(v,_mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,1)));
+  return _mm_cvtss_f32(_mm_mul_ss(xy,_mm_shuffle_ps(v,v,_MM_SHUFFLE(0,0,0,2))));
+}
+
+/// Returns a vector mask containing the result of a `==` comparison for each element of
+/// `self` and `rhs`.
+inline_always
+const BVec3A vec3a_cmpeq(Vec3A self,Vec3A rhs) {
+  return bvec3a_from_m128(_mm_cmpeq_ps(self.inner,rhs.inner));
+}
+
+/// Returns a vector mask containing the result of a `!=` comparison for each element of
+/// `self` and `rhs`.
+inline_always
+const BVec3A vec3a_cmpne(Vec3A self,Vec3A rhs) {
+  return bvec3a_from_m128(_mm_cmpneq_ps(self.inner,rhs.inner));
+}
+
+/// Returns a vector mask containing the result of a `>=` comparison for each element of
+/// `self` and `rhs`.
+inline_always
+const BVec3A vec3a_cmpge(Vec3A self,Vec3A rhs) {
+  return bvec3a_from_m128(_mm_cmpge_ps(self.inner,rhs.inner));
+}
+
+/// Returns a vector mask containing the result of a `>` comparison for each element of
+/// `self` and `rhs`.
+inline_always
+const BVec3A vec3a_cmpgt(Vec3A self,Vec3A rhs) {
+  return bvec3a_from_m128(_mm_cmpgt_ps(self.inner,rhs.inner));
+}
+
+/// Returns a vector mask containing the result of a `<=` comparison for each element of
+/// `self` and `rhs`.
+inline_always
+const BVec3A vec3a_cmple(Vec3A self,Vec3A rhs) {
+  return bvec3a_from_m128(_mm_cmple_ps(self.inner,rhs.inner));
+}
+
+/// Returns a vector mask containing the result of a `<` comparison for each element of
+/// `self` and `rhs`.
+inline_always
+const BVec3A vec3a_cmplt(Vec3A self,Vec3A rhs) {
+  return bvec3a_from_m128(_mm_cmplt_ps(self.inner,rhs.inner));
+}
+
+/// Returns a vector containing the absolute value of each element of `self`.
+inline_always
+const Vec3A vec3a_abs(Vec3A self) {
+  return vec3a_from_m128(_m128_abs(self.inner));
+}
+
+/// Returns a vector with elements representing the sign of `self`.
+///
+/// - `1.0` if the number is positive, `+0.0` or `INFINITY`
+/// - `-1.0` if the number is negative, `-0.0` or `NEG_INFINITY`
+/// - `NAN` if the number is `NAN`
+inline
+const Vec3A vec3a_signum(Vec3A self) {
+  const __m128 v=self.inner;
+  const __m128 one=_mm_or_ps(_mm_set1_ps(1.0f),_mm_and_ps(v,_m128_sign_mask()));
+  return vec3a_from_m128(_m128_select(_mm_cmpunord_ps(v,v),v,one));
+}
+
+/// Returns a vector with signs of `rhs` and the magnitudes of `self`.
+inline_always
+const Vec3A vec3a_copysign(Vec3A self,Vec3A rhs) {
+  const __m128 mask=_m128_sign_mask();
+  return vec3a_from_m128(_mm_or_ps(_mm_and_ps(rhs.inner,mask),_mm_andnot_ps(mask,self.inner)));
+}
+
+/// Returns a bitmask with the lowest 3 bits set to the sign bits from the elements of `self`.
+///
+/// A negative element results in a `1` bit and a positive element in a `0` bit.  Element `x` goes
+/// into the first lowest bit, element `y` into the second, etc.
+inline_always
+const u32 vec3a_is_negative_bitmask(Vec3A self) {
+  return (u32)_mm_movemask_ps(self.inner) & 0x7;
+}
+
+/// Returns `true` if, and only if, all elements are finite.  If any element is either
+/// `NaN`, positive or negative infinity, this will return `false`.
+inline
+const bool vec3a_is_finite(Vec3A self) {
+  const __m128 finite=_mm_cmplt_ps(_m128_abs(self.inner),_mm_set1_ps(F32_INFINITY));
+  return bvec3a_all(bvec3a_from_m128(finite));
+}
+
+/// Returns `true` if any elements are `NaN`.
+inline
+const bool vec3a_is_nan(Vec3A self) {
+  return bvec3a_any(bvec3a_from_m128(_mm_cmpunord_ps(self.inner,self.inner)));
+}
+
+/// Computes the length of `self`.
+inline
+const f32 vec3a_len(Vec3A self) {
+  return _mm_cvtss_f32(_mm_sqrt_ss(_m128_dot3(self.inner,self.inner)));
+}
+
+/// Computes the squared length of `self`.
+///
+/// This is faster than `vec3a_len` as it avoids a square root operation.
+inline
+const f32 vec3a_len_squared(Vec3A self) {
+  return vec3a_dot(self,self);
+}
+
+/// Computes `1.0 / length()`.
+///
+/// For valid results, `self` must _not_ be of length zero.
+inline
+const f32 vec3a_len_recip(Vec3A self) {
+  return 1.0F/vec3a_len(self);
+}
+
+/// Approximates `1.0 / length()` with `rsqrtss` and one Newton-Raphson step, like
+/// `f32_rsqrt_fast`.
+///
+/// The relative error is below `3e-7`. For valid results, `self` must _not_ be of length
+/// zero, and its squared length must be finite and not subnormal.
+inline
+const f32 vec3a_len_recip_fast(Vec3A self) {
+  const __m128 x=_m128_dot3(self.inner,self.inner);
+  const __m128 y=_mm_rsqrt_ss(x);
+  const __m128 half_xy=_mm_mul_ss(_mm_mul_ss(_mm_set_ss(0.5F),x),y);
+  return _mm_cvtss_f32(_mm_add_ss(y,_mm_mul_ss(y,_mm_sub_ss(_mm_set_ss(0.5F),_mm_mul_ss(half_xy,y)))));
+}
+
+/// Computes the Euclidean distance between two points in space.
+inline
+const f32 vec3a_distance(Vec3A self,Vec3A rhs) {
+  return vec3a_len(vec3a_sub(self,rhs));
+}
+
+/// Compute the squared euclidean distance between two points in space.
+inline
+const f32 vec3a_distance_squared(Vec3A self,Vec3A rhs) {
+  return vec3a_len_squared(vec3a_sub(self,rhs));
+}
+
+/// Returns the element-wise quotient of [Euclidean division] of `self` by `rhs`.
+///
+/// [Euclidean division]: f32_div_euclid
+inline
+const Vec3A vec3a_div_euclid(Vec3A self,Vec3A rhs) {
+  return vec3a_from_vec3(vec3_div_euclid(vec3_from_vec3a(self),vec3_from_vec3a(rhs)));
+}
+
+/// Returns the element-wise remainder of [Euclidean division] of `self` by `rhs`.
+///
+/// [Euclidean division]: f32_rem_euclid
+inline
+const Vec3A vec3a_rem_euclid(Vec3A self,Vec3A rhs) {
+  return vec3a_from_vec3(vec3_rem_euclid(vec3_from_vec3a(self),vec3_from_vec3a(rhs)));
+}
+
+/// Returns `self` normalized to length 1.0.
+///
+/// For valid results, `self` must be finite and _not_ of length zero, nor very close to zero.
+///
+/// Panics
+///
+/// Will panic if the resulting normalized vector is not finite when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_normalize(Vec3A self) {
+  Vec3A normalized=vec3a_mul_f32(self,vec3a_len_recip(self));
+
+  cmeth_assert(vec3a_is_finite(normalized));
+  return normalized;
+}
+
+/// Returns `self` normalized to length 1.0 if possible, else returns a
+/// fallback value.
+///
+/// In particular, if the input is zero (or very close to zero), or non-finite,
+/// the result of this operation will be the fallback value.
+inline
+const Vec3A vec3a_normalize_or(Vec3A self,Vec3A fallback) {
+  f32 rcp=vec3a_len_recip(self);
+
+  return f32_is_finite(rcp) && rcp>0.0?vec3a_mul_f32(self,rcp):fallback;
+}
+
+/// Returns `self` normalized to length 1.0 if possible, else returns zero.
+///
+/// In particular, if the input is zero (or very close to zero), or non-finite,
+/// the result of this operation will be zero.
+inline
+const Vec3A vec3a_normalize_or_zero(Vec3A self) {
+  return vec3a_normalize_or(self,VEC3A_ZERO);
+}
+
+/// Returns `self` normalized to length 1.0, using `vec3a_len_recip_fast`.
+///
+/// The length of the result is within `4e-7` of 1.0. For valid results, `self` must be
+/// finite and _not_ of length zero, nor very close to zero.
+///
+/// Panics
+///
+/// Will panic if the resulting normalized vector is not finite when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_normalize_fast(Vec3A self) {
+  Vec3A normalized=vec3a_mul_f32(self,vec3a_len_recip_fast(self));
+
+  cmeth_assert(vec3a_is_finite(normalized));
+  return normalized;
+}
+
+/// Returns `self` normalized to length 1.0 using `vec3a_len_recip_fast` if possible, else
+/// returns a fallback value.
+///
+/// Falls back for the same inputs as `vec3a_normalize_or`, and also when the squared
+/// length is subnormal or overflows.
+inline
+const Vec3A vec3a_normalize_or_fast(Vec3A self,Vec3A fallback) {
+  const f32 len_sq=vec3a_dot(self,self);
+
+  // Same test as `vec3_normalize_or_fast`, on the input rather than the estimate.
+  return len_sq>=0x1p-126F && len_sq<F32_INFINITY?vec3a_mul_f32(self,vec3a_len_recip_fast(self)):fallback;
+}
+
+/// Returns `self` normalized to length 1.0 using `vec3a_len_recip_fast` if possible, else
+/// returns zero.
+inline
+const Vec3A vec3a_normalize_or_zero_fast(Vec3A self) {
+  return vec3a_normalize_or_fast(self,VEC3A_ZERO);
+}
+
+/// Returns whether `self` is length `1.0` or not.
+///
+/// Uses a precision threshold of approximately `1e-4`.
+inline
+const bool vec3a_is_normalized(Vec3A self) {
+  return f32_abs(vec3a_len_squared(self) - 1.0) <= 2e-4;
+}
+
+/// Returns the vector projection of `self` onto `rhs`.
+///
+/// `rhs` must be of non-zero length.
+///
+/// # Panics
+///
+/// Will panic if `rhs` is zero length when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_project_into(Vec3A self,Vec3A rhs) {
+  f32 other_len_sq_rcp=1/vec3a_dot(rhs,rhs);
+  cmeth_assert(f32_is_finite(other_len_sq_rcp));
+
+  f32 x=vec3a_dot(self,rhs)*other_len_sq_rcp;
+
+  return vec3a_mul_f32(rhs,x);
+}
+
+/// Returns the vector rejection of `self` from `rhs`.
+///
+/// `rhs` must be of non-zero length.
+///
+/// # Panics
+///
+/// Will panic if `rhs` has a length of zero when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_reject_from(Vec3A self,Vec3A rhs) {
+  return vec3a_sub(self,vec3a_project_into(self,rhs));
+}
+
+/// Returns the vector projection of `self` onto `rhs`.
+///
+/// `rhs` must be normalized.
+///
+/// # Panics
+///
+/// Will panic if `rhs` is not normalized when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_project_onto_normalized(Vec3A self,Vec3A rhs) {
+  cmeth_assert(vec3a_is_normalized(rhs));
+  return vec3a_mul_f32(rhs,vec3a_dot(self,rhs));
+}
+
+/// Returns the vector rejection of `self` from `rhs`.
+///
+/// `rhs` must be normalized.
+///
+/// # Panics
+///
+/// Will panic if `rhs` is not normalized when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_reject_from_normalized(Vec3A self,Vec3A rhs) {
+  return vec3a_sub(self,vec3a_project_onto_normalized(self,rhs));
+}
+
+/// Returns a vector containing the nearest integer to a number for each element of `self`.
+/// Round half-way cases away from 0.0.
+inline
+const Vec3A vec3a_round(Vec3A self) {
+  return vec3a_from_m128(_m128_round(self.inner));
+}
+
+/// Returns a vector containing the largest integer less than or equal to a number for each
+/// element of `self`.
+inline
+const Vec3A vec3a_floor(Vec3A self) {
+  return vec3a_from_m128(_m128_floor(self.inner));
+}
+
+/// Returns a vector containing the smallest integer greater than or equal to a number for
+/// each element of `self`.
+inline
+const Vec3A vec3a_ceil(Vec3A self) {
+  return vec3a_from_m128(_m128_ceil(self.inner));
+}
+
+/// Returns a vector containing the integer part each element of `self`. This means numbers are
+/// always truncated towards zero.
+inline
+const Vec3A vec3a_trunc(Vec3A self) {
+  return vec3a_from_m128(_m128_trunc(self.inner));
+}
+
+/// Returns a vector containing the fractional part of the vector as `vec3a_sub(self,vec3a_trunc(self))`.
+inline
+const Vec3A vec3a_fract(Vec3A self) {
+  return vec3a_sub(self,vec3a_trunc(self));
+}
+
+/// Returns a vector containing the fractional part of the vector as `vec3a_sub(self,vec3a_floor(self))`.
+inline
+const Vec3A vec3a_fract_gl(Vec3A self) {
+  return vec3a_sub(self,vec3a_floor(self));
+}
+
+/// Returns a vector containing `e^self` (the exponential function) for each element of
+/// `self`.
+inline
+const Vec3A vec3a_exp(Vec3A self) {
+  return vec3a_from_vec3(vec3_exp(vec3_from_vec3a(self)));
+}
+
+/// Returns a vector containing each element of `self` raised to the power of `n`.
+inline
+const Vec3A vec3a_pow(Vec3A self,f32 n) {
+  return vec3a_from_vec3(vec3_pow(vec3_from_vec3a(self),n));
+}
+
+/// Returns a vector containing the reciprocal `1.0/n` of each element of `self`.
+inline
+const Vec3A vec3a_recip(Vec3A self) {
+  return vec3a_from_m128(_mm_div_ps(_mm_set1_ps(1.0f),self.inner));
+}
+
+/// Performs a linear interpolation between `self` and `rhs` based on the value `s`.
+///
+/// When `s` is `0.0`, the result will be equal to `self`.  When `s` is `1.0`, the result
+/// will be equal to `rhs`. When `s` is outside of range `[0, 1]`, the result is linearly
+/// extrapolated.
+inline
+const Vec3A vec3a_lerp(Vec3A self,Vec3A rhs,f32 s) {
+  return vec3a_add(vec3a_mul_f32(self,1.0f - s),vec3a_mul_f32(rhs,s));
+}
+
+/// Moves towards `rhs` based on the value `d`.
+///
+/// When `d` is `0.0`, the result will be equal to `self`. When `d` is equal to
+/// `vec3a_distance(self,rhs)`, the result will be equal to `rhs`. Will not go past `rhs`.
+inline
+const Vec3A vec3a_move_towards(Vec3A self,Vec3A rhs,f32 d) {
+  Vec3A a=vec3a_sub(rhs,self);
+  f32 len=vec3a_len(a);
+  if(len<=d || len<=1e-4) {
+    return rhs;
+  }
+  return vec3a_add(self,vec3a_mul_f32(a,d/len));
+}
+
+/// Calculates the midpoint between `self` and `rhs`.
+inline
+const Vec3A vec3a_midpoint(Vec3A self,Vec3A rhs) {
+  return vec3a_mul_f32(vec3a_add(self,rhs),0.5);
+}
+
+/// Returns true if the absolute difference of all elements between `self` and `rhs` is
+/// less than or equal to `max_abs_diff`.
+inline
+const bool vec3a_abs_diff_eq(Vec3A self,Vec3A rhs,f32 max_abs_diff) {
+  Vec3A abs_diff=vec3a_abs(vec3a_sub(self,rhs));
+  return bvec3a_all(vec3a_cmple(abs_diff,vec3a_splat(max_abs_diff)));
+}
+
+static inline_always
+const Vec3A _vec3a_x_self_over_len(Vec3A self,f32 x,f32 len_sq) {
+  return vec3a_mul_f32(vec3a_div_f32(self,f32_sqrt(len_sq)),x);
+}
+
+/// Returns a vector with a length no less than `min` and no more than `max`.
+///
+/// # Panics
+///
+/// Will panic if `min` is greater than `max`, or if either `min` or `max` is negative, when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_clamp_length(Vec3A self,f32 min,f32 max) {
+  cmeth_assert(0.0 <= min);
+  cmeth_assert(min <= max);
+  f32 length_sq=vec3a_len_squared(self);
+  if(length_sq < min * min) {
+    return _vec3a_x_self_over_len(self,min,length_sq);
+  } else if(length_sq > max * max) {
+    return _vec3a_x_self_over_len(self,max,length_sq);
+  } else {
+    return self;
+  }
+}
+
+/// Returns a vector with a length no more than `max`.
+///
+/// # Panics
+///
+/// Will panic if `max` is negative when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_clamp_length_max(Vec3A self,f32 max) {
+  cmeth_assert(0.0 <= max);
+  f32 length_sq=vec3a_len_squared(self);
+  return (length_sq > max * max)? _vec3a_x_self_over_len(self,max,length_sq) : self;
+}
+
+/// Returns a vector with a length no less than `min`.
+///
+/// # Panics
+///
+/// Will panic if `min` is negative when `cmeth_assert` is enabled.
+inline
+const Vec3A vec3a_clamp_length_min(Vec3A self,f32 min) {
+  cmeth_assert(0.0 <= min);
+  f32 length_sq=vec3a_len_squared(self);
+  return (length_sq < min * min)? _vec3a_x_self_over_len(self,min,length_sq) : self;
+}
+
+/// Fused multiply-add. Computes `vec3a_add(vec3a_mul(self,a),b)` element-wise with only one
+/// rounding error.
+///
+/// Uses `vfmadd` when the translation unit is built with FMA enabled and falls back to
+/// `f32_mul_add` per element otherwise, so the result is the same either way.
+inline
+const Vec3A vec3a_mul_add(Vec3A self,Vec3A a,Vec3A b) {
+#ifdef __FMA__
+  return vec3a_from_m128(_mm_fmadd_ps(self.inner,a.inner,b.inner));
+#else
+  return vec3a_from_vec3(vec3_mul_add(vec3_from_vec3a(self),vec3_from_vec3a(a),vec3_from_vec3a(b)));
+#endif
+}
+
+/// Returns a vector with all elements set to `0.0`.
+inline_always
+const Vec3A vec3a_default() {
+  return VEC3A_ZERO;
+}
+
+/// Returns the element-wise quotient of `self` and `rhs`.
+inline_always
+const Vec3A vec3a_div(Vec3A self,Vec3A rhs) {
+  return vec3a_from_m128(_mm_div_ps(self.inner,rhs.inner));
+}
+
+inline_always
+void vec3a_div_assign(Vec3A* self,Vec3A rhs) {
+  *self=vec3a_div(*self,rhs);
+}
+
+/// Returns `self` with every element divided by `rhs`.
+inline_always
+const Vec3A vec3a_div_f32(Vec3A self,f32 rhs) {
+  return vec3a_from_m128(_mm_div_ps(self.inner,_mm_set1_ps(rhs)));
+}
+
+inline_always
+void vec3a_div_assign_f32(Vec3A* self,f32 rhs) {
+  *self=vec3a_div_f32(*self,rhs);
+}
+
+/// Returns a vector with every element being `self` divided by the element of `rhs`.
+inline_always
+const Vec3A f32_div_vec3a(f32 self,Vec3A rhs) {
+  return vec3a_from_m128(_mm_div_ps(_mm_set1_ps(self),rhs.inner));
+}
+
+/// Returns the element-wise product of `self` and `rhs`.
+inline_always
+const Vec3A vec3a_mul(Vec3A self,Vec3A rhs) {
+  return vec3a_from_m128(_mm_mul_ps(self.inner,rhs.inner));
+}
+
+inline_always
+void vec3a_mul_assign(Vec3A* self,Vec3A rhs) {
+  *self=vec3a_mul(*self,rhs);
+}
+
+/// Returns `self` with every element multiplied by `rhs`.
+inline_always
+const Vec3A vec3a_mul_f32(Vec3A self,f32 rhs) {
+  return vec3a_from_m128(_mm_mul_ps(self.inner,_mm_set1_ps(rhs)));
+}
+
+inline_always
+void vec3a_mul_assign_f32(Vec3A* self,f32 rhs) {
+  *self=vec3a_mul_f32(*self,rhs);
+}
+
+inline_always
+const Vec3A f32_mul_vec3a(f32 self,Vec3A rhs) {
+  return vec3a_mul_f32(rhs,self);
+}
+
+/// Returns the element-wise sum of `self` and `rhs`.
+inline_always
+const Vec3A vec3a_add(Vec3A self,Vec3A rhs) {
+  return vec3a_from_m128(_mm_add_ps(self.inner,rhs.inner));
+}
+
+inline_always
+void vec3a_add_assign(Vec3A* self,Vec3A rhs) {
+  *self=vec3a_add(*self,rhs);
+}
+
+/// Returns `self` with `rhs` added to every element.
+inline_always
+const Vec3A vec3a_add_f32(Vec3A self,f32 rhs) {
+  return vec3a_from_m128(_mm_add_ps(self.inner,_mm_set1_ps(rhs)));
+}
+
+inline_always
+void vec3a_add_assign_f32(Vec3A* self,f32 rhs) {
+  *self=vec3a_add_f32(*self,rhs);
+}
+
+inline_always
+const Vec3A f32_add_vec3a(f32 self,Vec3A rhs) {
+  return vec3a_add_f32(rhs,self);
+}
+
+/// Returns the element-wise difference of `self` and `rhs`.
+inline_always
+const Vec3A vec3a_sub(Vec3A self,Vec3A rhs) {
+  return vec3a_from_m128(_mm_sub_ps(self.inner,rhs.inner));
+}
+
+inline_always
+void vec3a_sub_assign(Vec3A* self,Vec3A rhs) {
+  *self=vec3a_sub(*self,rhs);
+}
+
+/// Returns `self` with `rhs` subtracted from every element.
+inline_always
+const Vec3A vec3a_sub_f32(Vec3A self,f32 rhs) {
+  return vec3a_from_m128(_mm_sub_ps(self.inner,_mm_set1_ps(rhs)));
+}
+
+inline_always
+void vec3a_sub_assign_f32(Vec3A* self,f32 rhs) {
+  *self=vec3a_sub_f32(*self,rhs);
+}
+
+/// Returns a vector with every element being `self` minus the element of `rhs`.
+inline_always
+const Vec3A f32_sub_vec3a(f32 self,Vec3A rhs) {
+  return vec3a_from_m128(_mm_sub_ps(_mm_set1_ps(self),rhs.inner));
+}
+
+/// Returns the element-wise remainder of `self` and `rhs`, as `f32_rem` does.
+inline
+const Vec3A vec3a_rem(Vec3A self,Vec3A rhs) {
+  return vec3a_from_vec3(vec3_rem(vec3_from_vec3a(self),vec3_from_vec3a(rhs)));
+}
+
+inline
+void vec3a_rem_assign(Vec3A* self,Vec3A rhs) {
+  *self=vec3a_rem(*self,rhs);
+}
+
+inline
+const Vec3A vec3a_rem_f32(Vec3A self,f32 rhs) {
+  return vec3a_rem(self,vec3a_splat(rhs));
+}
+
+inline
+void vec3a_rem_assign_f32(Vec3A* self,f32 rhs) {
+  *self=vec3a_rem_f32(*self,rhs);
+}
+
+inline
+const Vec3A f32_rem_vec3a(f32 self,Vec3A rhs) {
+  return vec3a_rem(vec3a_splat(self),rhs);
+}
+
+inline_always
+const Vec3A vec3a_neg(Vec3A self) {
+  return vec3a_from_m128(_mm_xor_ps(self.inner,_m128_sign_mask()));
+}
+
+/// Returns a pointer to the element at `index`.
+///
+/// Panics if `index` is greater than 2.
+inline
+const f32* vec3a_index(Vec3A* self,usize index) {
+  if(index>2) {
+    panic("index out of bounds")
+  }
+  return ((const f32*)&self->inner)+index;
+}
@@ -0,0 +1,177 @@
+#ifndef CMETH_F32_VEC3A_H
+#define CMETH_F32_VEC3A_H
+#include <emmintrin.h>
+#include "../prelude.h"
+#include "../bool/bvec3a.h"
+#include "vec3.h"
+
+
+/// A 3-dimensional vector stored in a 16-byte aligned SSE2 register.
+///
+/// The fourth lane is padding: its value is unspecified and every function ignores it.
+typedef struct {
+  __m128 inner;
+} Vec3A;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const Vec3A vec3a(f32 x,f32 y,f32 z);
+CMETH_API const Vec3A vec3a_new(f32 x,f32 y,f32 z);
+CMETH_API const Vec3A vec3a_splat(f32 v);
+CMETH_API const Vec3A vec3a_from_m128(__m128 v);
+CMETH_API const Vec3A vec3a_from_vec3(Vec3 v);
+CMETH_API const Vec3 vec3_from_vec3a(Vec3A v);
+CMETH_API const f32 vec3a_x(Vec3A self);
+CMETH_API const f32 vec3a_y(Vec3A self);
+CMETH_API const f32 vec3a_z(Vec3A self);
+CMETH_API const Vec3A vec3a_select(BVec3A mask,Vec3A if_true,Vec3A if_false);
+CMETH_API const Vec3A vec3a_map(Vec3A self,f32 (*f)(f32));
+CMETH_API const Vec3A vec3a_from_array(f32 a[3]);
+CMETH_API void vec3a_write_to_slice(Vec3A self,f32* slice);
+CMETH_API const Vec3A vec3a_from_vec4(f32 v[4]);
+CMETH_API const Vec3A vec3a_with_x(Vec3A self,f32 x);
+CMETH_API const Vec3A vec3a_with_y(Vec3A self,f32 y);
+CMETH_API const Vec3A vec3a_with_z(Vec3A self,f32 z);
+CMETH_API const f32 vec3a_dot(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_dot_into_vec(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_cross(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_min(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_max(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_clamp(Vec3A self,Vec3A min,Vec3A max);
+CMETH_API const f32 vec3a_min_element(Vec3A self);
+CMETH_API const f32 vec3a_max_element(Vec3A self);
+CMETH_API const f32 vec3a_element_sum(Vec3A self);
+CMETH_API const f32 vec3a_element_product(Vec3A self);
+CMETH_API const BVec3A vec3a_cmpeq(Vec3A self,Vec3A rhs);
+CMETH_API const BVec3A vec3a_cmpne(Vec3A self,Vec3A rhs);
+CMETH_API const BVec3A vec3a_cmpge(Vec3A self,Vec3A rhs);
+CMETH_API const BVec3A vec3a_cmpgt(Vec3A self,Vec3A rhs);
+CMETH_API const BVec3A vec3a_cmple(Vec3A self,Vec3A rhs);
+CMETH_API const BVec3A vec3a_cmplt(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_abs(Vec3A self);
+CMETH_API const Vec3A vec3a_signum(Vec3A self);
+CMETH_API const Vec3A vec3a_copysign(Vec3A self,Vec3A rhs);
+CMETH_API const u32 vec3a_is_negative_bitmask(Vec3A self);
+CMETH_API const bool vec3a_is_finite(Vec3A self);
+CMETH_API const bool vec3a_is_nan(Vec3A self);
+CMETH_API const f32 vec3a_len(Vec3A self);
+CMETH_API const f32 vec3a_len_squared(Vec3A self);
+CMETH_API const f32 vec3a_len_recip(Vec3A self);
+CMETH_API const f32 vec3a_len_recip_fast(Vec3A self);
+CMETH_API const f32 vec3a_distance(Vec3A self,Vec3A rhs);
+CMETH_API const f32 vec3a_distance_squared(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_div_euclid(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_rem_euclid(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_normalize(Vec3A self);
+CMETH_API const Vec3A vec3a_normalize_or(Vec3A self,Vec3A fallback);
+CMETH_API const Vec3A vec3a_normalize_or_zero(Vec3A self);
+CMETH_API const Vec3A vec3a_normalize_fast(Vec3A self);
+CMETH_API const Vec3A vec3a_normalize_or_fast(Vec3A self,Vec3A fallback);
+CMETH_API const Vec3A vec3a_normalize_or_zero_fast(Vec3A self);
+CMETH_API const bool vec3a_is_normalized(Vec3A self);
+CMETH_API const Vec3A vec3a_project_into(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_reject_from(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_project_onto_normalized(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_reject_from_normalized(Vec3A self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_round(Vec3A self);
+CMETH_API const Vec3A vec3a_floor(Vec3A self);
+CMETH_API const Vec3A vec3a_ceil(Vec3A self);
+CMETH_API const Vec3A vec3a_trunc(Vec3A self);
+CMETH_API const Vec3A vec3a_fract(Vec3A self);
+CMETH_API const Vec3A vec3a_fract_gl(Vec3A self);
+CMETH_API const Vec3A vec3a_exp(Vec3A self);
+CMETH_API const Vec3A vec3a_pow(Vec3A self,f32 n);
+CMETH_API const Vec3A vec3a_recip(Vec3A self);
+CMETH_API const Vec3A vec3a_lerp(Vec3A self,Vec3A rhs,f32 s);
+CMETH_API const Vec3A vec3a_move_towards(Vec3A self,Vec3A rhs,f32 d);
+CMETH_API const Vec3A vec3a_midpoint(Vec3A self,Vec3A rhs);
+CMETH_API const bool vec3a_abs_diff_eq(Vec3A self,Vec3A rhs,f32 max_abs_diff);
+CMETH_API const Vec3A vec3a_clamp_length(Vec3A self,f32 min,f32 max);
+CMETH_API const Vec3A vec3a_clamp_length_max(Vec3A self,f32 max);
+CMETH_API const Vec3A vec3a_clamp_length_min(Vec3A self,f32 min);
+CMETH_API const Vec3A vec3a_mul_add(Vec3A self,Vec3A a,Vec3A b);
+CMETH_API const Vec3A vec3a_default();
+CMETH_API const Vec3A vec3a_div(Vec3A self,Vec3A rhs);
+CMETH_API void vec3a_div_assign(Vec3A* self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_div_f32(Vec3A self,f32 rhs);
+CMETH_API void vec3a_div_assign_f32(Vec3A* self,f32 rhs);
+CMETH_API const Vec3A f32_div_vec3a(f32 self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_mul(Vec3A self,Vec3A rhs);
+CMETH_API void vec3a_mul_assign(Vec3A* self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_mul_f32(Vec3A self,f32 rhs);
+CMETH_API void vec3a_mul_assign_f32(Vec3A* self,f32 rhs);
+CMETH_API const Vec3A f32_mul_vec3a(f32 self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_add(Vec3A self,Vec3A rhs);
+CMETH_API void vec3a_add_assign(Vec3A* self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_add_f32(Vec3A self,f32 rhs);
+CMETH_API void vec3a_add_assign_f32(Vec3A* self,f32 rhs);
+CMETH_API const Vec3A f32_add_vec3a(f32 self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_sub(Vec3A self,Vec3A rhs);
+CMETH_API void vec3a_sub_assign(Vec3A* self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_sub_f32(Vec3A self,f32 rhs);
+CMETH_API void vec3a_sub_assign_f32(Vec3A* self,f32 rhs);
+CMETH_API const Vec3A f32_sub_vec3a(f32 self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_rem(Vec3A self,Vec3A rhs);
+CMETH_API void vec3a_rem_assign(Vec3A* self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_rem_f32(Vec3A self,f32 rhs);
+CMETH_API void vec3a_rem_assign_f32(Vec3A* self,f32 rhs);
+CMETH_API const Vec3A f32_rem_vec3a(f32 self,Vec3A rhs);
+CMETH_API const Vec3A vec3a_neg(Vec3A self);
+CMETH_API const f32* vec3a_index(Vec3A* self,usize index);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// All zeroes.
+#define VEC3A_ZERO vec3a_splat(0.0)
+
+/// All ones.
+#define VEC3A_ONE vec3a_splat(1.0)
+
+/// All negative ones.
+#define VEC3A_NEG_ONE vec3a_splat(-1.0)
+
+/// All `F32_MIN`.
+#define VEC3A_MIN vec3a_splat(F32_MIN)
+
+/// All `F32_MAX`.
+#define VEC3A_MAX vec3a_splat(F32_MAX)
+
+/// All `F32_NAN`.
+#define VEC3A_NAN vec3a_splat(F32_NAN)
+
+/// All `F32_INFINITY`.
+#define VEC3A_INFINITY vec3a_splat(F32_INFINITY)
+
+/// All `F32_NEG_INFINITY`.
+#define VEC3A_NEG_INFINITY vec3a_splat(F32_NEG_INFINITY)
+
+/// A unit vector pointing along the positive X axis.
+#define VEC3A_X vec3a_new(1.0,0.0,0.0)
+
+/// A unit vector pointing along the positive Y axis.
+#define VEC3A_Y vec3a_new(0.0,1.0,0.0)
+
+/// A unit vector pointing along the positive Z axis.
+#define VEC3A_Z vec3a_new(0.0,0.0,1.0)
+
+/// A unit vector pointing along the negative X axis.
+#define VEC3A_NEG_X vec3a_new(-1.0,0.0,0.0)
+
+/// A unit vector pointing along the negative Y axis.
+#define VEC3A_NEG_Y vec3a_new(0.0,-1.0,0.0)
+
+/// A unit vector pointing along the negative Z axis.
+#define VEC3A_NEG_Z vec3a_new(0.0,0.0,-1.0)
+
+/// The unit axes.
+#define VEC3A_AXES {VEC3A_X,VEC3A_Y,VEC3A_Z}
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "vec3a.c"
+#endif
+
+#endif
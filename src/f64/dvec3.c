@@ -0,0 +1,976 @@
+#include "dvec3.h"
+#include "math_impl.h"
+#include "prelude.h"
+
+
+/// Creates a 3-dimensional vector.
+inline_always
+const DVec3 dvec3(f64 x,f64 y,f64 z) {
+  return dvec3_new(x,y,z);
+}
+
+/// Creates a new vector.
+inline_always
+const DVec3 dvec3_new(f64 x,f64 y,f64 z) {
+  DVec3 vec={
+    .x=x,
+    .y=y,
+    .z=z
+  };
+  return vec;
+}
+
+/// Creates a vector with all elements set to `v`.
+inline
+const DVec3 dvec3_splat(f64 v) {
+  DVec3 vec={
+    .x=v,
+    .y=v,
+    .z=v
+  };
+  return vec;
+}
+
+/// `if_true` if `mask` and `if_false` otherwise, as a bitwise blend: a ternary on floats
+/// compiles to a branch per element.
+static inline_always
+const f64 _dvec3_select_element(bool mask,f64 if_true,f64 if_false) {
+  const u64 bits=-(u64)mask;
+  return f64_from_bits((f64_to_bits(if_true) & bits) | (f64_to_bits(if_false) & ~bits));
+}
+
+/// Creates a vector from the elements in `if_true` and `if_false`, selecting which to use
+/// for each element of `self`.
+///
+/// A true element in the mask uses the corresponding element from `if_true`, and false
+/// uses the element from `if_false`. It does not branch; `Vec3A` keeps the mask in SIMD
+/// lanes, so `vec3a_cmp*` followed by `vec3a_select` is a compare and a blend.
+inline
+const DVec3 dvec3_select(BVec3 mask,DVec3 if_true,DVec3 if_false) {
+  DVec3 vec={
+    .x=_dvec3_select_element(mask.x,if_true.x,if_false.x),
+    .y=_dvec3_select_element(mask.y,if_true.y,if_false.y),
+    .z=_dvec3_select_element(mask.z,if_true.z,if_false.z),
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing each element of `self` modified by a mapping function `f`.
+inline
+const DVec3 dvec3_map(DVec3 self,f64 (*f)(f64)) {
+  self.x=f(self.x);
+  self.y=f(self.y);
+  self.z=f(self.z);
+  return self;
+}
+
+/// Creates a new vector from an array.
+inline
+const DVec3 dvec3_from_array(f64 a[3]) {
+  DVec3 vec={
+    .x=a[0],
+    .y=a[1],
+    .z=a[2]
+  };
+  return vec;
+}
+
+/// writes the elements of `self` to the first 3 elements in `slice`.
+///
+/// # panics
+///
+///panics if `slice` is less than 3 elements long.
+inline
+void dvec3_write_to_slice(DVec3 self,f64* slice) {
+  slice[0]=self.x;
+  slice[1]=self.y;
+  slice[2]=self.z;
+}
+
+/// Internal method for creating a 3D vector from a 4D vector, discarding `w`.
+inline
+const DVec3 dvec3_from_vec4(f64 v[4]) {
+  DVec3 vec={
+    .x=v[0],
+    .y=v[1],
+    .z=v[2]
+  };
+  return vec;
+}
+
+/// Creates a 3D vector from `self` with the given value of `x`.
+inline
+const DVec3 dvec3_with_x(DVec3 self,f64 x) {
+  self.x=x;
+  return self;
+}
+
+/// Creates a 3D vector from `self` with the given value of `y`.
+inline
+const DVec3 dvec3_with_y(DVec3 self,f64 y) {
+  self.y=y;
+  return self;
+}
+
+/// Creates a 3D vector from `self` with the given value of `z`.
+inline
+const DVec3 dvec3_with_z(DVec3 self,f64 z) {
+  self.z=z;
+  return self;
+}
+
+/// Creates a `DVec3` from the elements of `v`. Every `f32` is exactly representable, so this
+/// does not round.
+inline
+const DVec3 vec3_as_dvec3(Vec3 v) {
+  return dvec3_new(v.x,v.y,v.z);
+}
+
+/// Rounds the elements of `self` to the nearest `f32`.
+///
+/// Coordinates far from the origin lose their low bits here; subtract a nearby origin in
+/// `f64` first, as `dvec3_to_vec3_relative_batch` does for arrays.
+inline
+const Vec3 dvec3_as_vec3(DVec3 self) {
+  return vec3_new((f32)self.x,(f32)self.y,(f32)self.z);
+}
+
+/// Computes the dot product of `self` and `rhs`.
+inline
+const f64 dvec3_dot(DVec3 self,DVec3 rhs) {
+  return (self.x*rhs.x)+(self.y*rhs.y)+(self.z*rhs.z);
+}
+
+/// Returns a vector where every component is the dot product of `self` and `rhs`.
+inline
+const DVec3 dvec3_dot_into_vec(DVec3 self,DVec3 rhs) {
+  return dvec3_splat(dvec3_dot(self,rhs));
+}
+
+/// Computes the cross product of `self` and `rhs`.
+inline
+const DVec3 dvec3_cross(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=self.y * rhs.z - rhs.y * self.z,
+    .y=self.z * rhs.x - rhs.z * self.x,
+    .z=self.x * rhs.y - rhs.x * self.y,
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing the minimum values for each element of `self` and `rhs`.
+///
+/// In other words this computes `[MIN(self.x,rhs.x), MIN(self.y,rhs.y), ..]`.
+inline
+const DVec3 dvec3_min(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=MIN(self.x,rhs.x),
+    .y=MIN(self.y,rhs.y),
+    .z=MIN(self.z,rhs.z)
+  };
+  return vec;
+}
+
+/// Returns a vector containing the maximum values for each element of `self` and `rhs`.
+///
+/// In other words this computes `[MAX(self.x,rhs.x), MAX(self.y,rhs.y), ..]`.
+inline
+const DVec3 dvec3_max(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=MAX(self.x,rhs.x),
+    .y=MAX(self.y,rhs.y),
+    .z=MAX(self.z,rhs.z)
+  };
+  return vec;
+}
+
+/// Component-wise clamping of values, similar to `f64_clamp`.
+///
+/// Each element in `min` must be less-or-equal to the corresponding element in `max`.
+///
+/// # Panics
+ ///
+/// Will panic if `min` is greater than `max` when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_clamp(DVec3 self,DVec3 min,DVec3 max) {
+  cmeth_assert(bvec3_all(dvec3_cmple(min,max)));
+  return dvec3_min(dvec3_max(self,min),max);
+}
+
+/// Returns the horizontal minimum of `self`.
+///
+/// In other words this computes `MIN(x, y, ..)`.
+inline
+const f64 dvec3_min_element(DVec3 self) {
+  return MIN(self.x,MIN(self.y,self.z));
+}
+
+/// Returns the horizontal maximum of `self`.
+///
+/// In other words this computes `MAX(x, y, ..)`.
+inline
+const f64 dvec3_max_element(DVec3 self) {
+  return MAX(self.x,MAX(self.y,self.z));
+}
+
+/// Returns the sum of all elements of `self`.
+///
+/// In other words, this computes `self.x + self.y + ..`.
+inline
+const f64 dvec3_element_sum(DVec3 self) {
+  return self.x+self.y+self.z;
+}
+
+/// Returns the product of all elements of `self`.
+///
+/// In other words, this computes `self.x * self.y * ..`.
+inline
+const f64 dvec3_element_product(DVec3 self) {
+  return self.x*self.y*self.z;
+}
+
+/// Returns a vector mask containing the result of a `==` comparison for each element of
+/// `self` and `rhs`.
+///
+/// In other words, this computes `[self.x == rhs.x, self.y == rhs.y, ..]` for all
+/// elements.
+inline
+const BVec3 dvec3_cmpeq(DVec3 self,DVec3 rhs) {
+  return bvec3_new(f64_eq(self.x,rhs.x),f64_eq(self.y,rhs.y),f64_eq(self.z,rhs.z));
+}
+
+/// Returns a vector mask containing the result of a `!=` comparison for each element of
+/// `self` and `rhs`.
+///
+/// In other words this computes `[self.x != rhs.x, self.y != rhs.y, ..]` for all
+/// elements.
+inline
+const BVec3 dvec3_cmpne(DVec3 self,DVec3 rhs) {
+  return bvec3_new(f64_ne(self.x,rhs.x),f64_ne(self.y,rhs.y),f64_ne(self.z,rhs.z));
+}
+
+/// Returns a vector mask containing the result of a `>=` comparison for each element of
+/// `self` and `rhs`.
+///
+/// In other words this computes `[self.x >= rhs.x, self.y >= rhs.y, ..]` for all
+/// elements.
+inline
+const BVec3 dvec3_cmpge(DVec3 self,DVec3 rhs) {
+  return bvec3_new(f64_ge(self.x,rhs.x),f64_ge(self.y,rhs.y),f64_ge(self.z,rhs.z));
+}
+
+/// Returns a vector mask containing the result of a `>` comparison for each element of
+/// `self` and `rhs`.
+///
+/// In other words this computes `[self.x > rhs.x, self.y > rhs.y, ..]` for all
+/// elements.
+inline
+const BVec3 dvec3_cmpgt(DVec3 self,DVec3 rhs) {
+  return bvec3_new(f64_gt(self.x,rhs.x),f64_gt(self.y,rhs.y),f64_gt(self.z,rhs.z));
+}
+
+/// Returns a vector mask containing the result of a `<=` comparison for each element of
+/// `self` and `rhs`.
+///
+/// In other words this computes `[self.x <= rhs.x, self.y <= rhs.y, ..]` for all
+/// elements.
+inline
+const BVec3 dvec3_cmple(DVec3 self,DVec3 rhs) {
+  return bvec3_new(f64_le(self.x,rhs.x),f64_le(self.y,rhs.y),f64_le(self.z,rhs.z));
+}
+
+
+/// Returns a vector mask containing the result of a `<` comparison for each element of
+/// `self` and `rhs`.
+///
+/// In other words this computes `[self.x < rhs.x, self.y < rhs.y, ..]` for all
+/// elements.
+inline
+const BVec3 dvec3_cmplt(DVec3 self,DVec3 rhs) {
+  return bvec3_new(f64_lt(self.x,rhs.x),f64_lt(self.y,rhs.y),f64_lt(self.z,rhs.z));
+}
+
+/// Returns a vector containing the absolute value of each element of `self`.
+inline
+const DVec3 dvec3_abs(DVec3 self) {
+  DVec3 vec={
+    .x=f64_abs(self.x),
+    .y=f64_abs(self.y),
+    .z=f64_abs(self.z)
+  };
+
+  return vec;
+}
+
+/// Returns a vector with elements representing the sign of `self`.
+///
+/// - `1.0` if the number is positive, `+0.0` or `INFINITY`
+/// - `-1.0` if the number is negative, `-0.0` or `NEG_INFINITY`
+/// - `NAN` if the number is `NAN`
+inline
+const DVec3 dvec3_signum(DVec3 self) {
+  DVec3 vec={
+    .x=f64_signum(self.x),
+    .y=f64_signum(self.y),
+    .z=f64_signum(self.z)
+  };
+
+  return vec;
+}
+
+/// Returns a vector with signs of `rhs` and the magnitudes of `self`.
+inline
+const DVec3 dvec3_copysign(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=f64_copysign(self.x,rhs.x),
+    .y=f64_copysign(self.y,rhs.y),
+    .z=f64_copysign(self.z,rhs.z)
+  };
+
+  return vec;
+}
+
+/// Returns a bitmask with the lowest 3 bits set to the sign bits from the elements of `self`.
+///
+/// A negative element results in a `1` bit and a positive element in a `0` bit.  Element `x` goes
+/// into the first lowest bit, element `y` into the second, etc.
+inline
+const u32 dvec3_is_negative_bitmask(DVec3 self) {
+  return ((u32)f64_is_sign_negative(self.x))
+  | ((u32)f64_is_sign_negative(self.y)) << 1
+  | ((u32)f64_is_sign_negative(self.z)) << 2;
+}
+
+/// Returns `true` if, and only if, all elements are finite.  If any element is either
+/// `NaN`, positive or negative infinity, this will return `false`.
+inline
+const bool dvec3_is_finite(DVec3 self) {
+  return f64_is_finite(self.x) && f64_is_finite(self.y) && f64_is_finite(self.z);
+}
+
+/// Returns `true` if any elements are `NaN`.
+inline
+const bool dvec3_is_nan(DVec3 self) {
+  return f64_is_nan(self.x) || f64_is_nan(self.y) || f64_is_nan(self.z);
+}
+
+/// Computes the length of `self`.
+inline
+const f64 dvec3_len(DVec3 self) {
+  return f64_sqrt(dvec3_dot(self,self));
+}
+
+/// Computes the squared length of `self`.
+///
+/// This is faster than `dvec3_len` as it avoids a square root operation.
+inline
+const f64 dvec3_len_squared(DVec3 self) {
+  return dvec3_dot(self,self);
+}
+
+/// Computes `1.0 / length()`.
+///
+/// For valid results, `self` must _not_ be of length zero.
+inline
+const f64 dvec3_len_recip(DVec3 self) {
+  return 1.0/dvec3_len(self);
+}
+
+/// Computes the Euclidean distance between two points in space.
+inline
+const f64 dvec3_distance(DVec3 self,DVec3 rhs) {
+  return dvec3_len(dvec3_sub(self,rhs));
+}
+
+/// Compute the squared euclidean distance between two points in space.
+inline
+const f64 dvec3_distance_squared(DVec3 self,DVec3 rhs) {
+  return dvec3_len_squared(dvec3_sub(self,rhs));
+}
+
+/// Returns the element-wise quotient of [Euclidean division] of `self` by `rhs`.
+inline
+const DVec3 dvec3_div_euclid(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=f64_div_euclid(self.x,rhs.x),
+    .y=f64_div_euclid(self.y,rhs.y),
+    .z=f64_div_euclid(self.z,rhs.z)
+  };
+
+  return vec;
+}
+
+/// Returns the element-wise remainder of [Euclidean division] of `self` by `rhs`.
+///
+/// [Euclidean division]: f64_rem_euclid
+inline
+const DVec3 dvec3_rem_euclid(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=f64_rem_euclid(self.x,rhs.x),
+    .y=f64_rem_euclid(self.y,rhs.y),
+    .z=f64_rem_euclid(self.z,rhs.z)
+  };
+
+  return vec;
+}
+
+/// Returns `self` normalized to length 1.0.
+///
+/// For valid results, `self` must be finite and _not_ of length zero, nor very close to zero.
+///
+/// See also [`Self::try_normalize()`] and [`Self::normalize_or_zero()`].
+///
+/// Panics
+///
+/// Will panic if the resulting normalized vector is not finite when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_normalize(DVec3 self) {
+  DVec3 normalized=dvec3_mul_f64(self,dvec3_len_recip(self));
+
+  cmeth_assert(dvec3_is_finite(normalized));
+  return normalized;
+}
+
+/// Returns `self` normalized to length 1.0 if possible, else returns a
+/// fallback value.
+///
+/// In particular, if the input is zero (or very close to zero), or non-finite,
+/// the result of this operation will be the fallback value.
+///
+/// See also [`dvec3_try_normalize()`].
+inline
+const DVec3 dvec3_normalize_or(DVec3 self,DVec3 fallback) {
+  f64 rcp=dvec3_len_recip(self);
+
+  return f64_is_finite(rcp) && rcp>0.0?dvec3_mul_f64(self,rcp):fallback;
+}
+
+/// Returns `self` normalized to length 1.0 if possible, else returns zero.
+///
+/// In particular, if the input is zero (or very close to zero), or non-finite,
+/// the result of this operation will be zero.
+///
+/// See also [`dvec3_try_normalize()`].
+inline
+const DVec3 dvec3_normalize_or_zero(DVec3 self) {
+  return dvec3_normalize_or(self,DVEC3_ZERO);
+}
+
+/// Returns whether `self` is length `1.0` or not.
+///
+/// Uses a precision threshold of approximately `1e-4`.
+inline
+const bool dvec3_is_normalized(DVec3 self) {
+  return f64_abs(dvec3_len_squared(self) - 1.0) <= 2e-4;
+}
+
+/// Returns the vector projection of `self` onto `rhs`.
+///
+/// `rhs` must be of non-zero length.
+///
+/// # Panics
+///
+/// Will panic if `rhs` is zero length when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_project_into(DVec3 self,DVec3 rhs) {
+  f64 other_len_sq_rcp=1/dvec3_dot(rhs,rhs);
+  cmeth_assert(f64_is_finite(other_len_sq_rcp));
+
+  f64 x=dvec3_dot(self,rhs)*other_len_sq_rcp;
+
+  return dvec3_mul_f64(self,x);
+}
+
+/// Returns the vector rejection of `self` from `rhs`.
+///
+/// The vector rejection is the vector perpendicular to the projection of `self` onto
+/// `rhs`, in rhs words the result of `self - self.project_onto(rhs)`.
+///
+/// `rhs` must be of non-zero length.
+///
+/// # Panics
+///
+/// Will panic if `rhs` has a length of zero when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_reject_from(DVec3 self,DVec3 rhs) {
+  DVec3 projection=dvec3_project_into(self,rhs);
+  return dvec3_sub(self,projection);
+}
+
+
+/// Returns the vector projection of `self` onto `rhs`.
+///
+/// `rhs` must be normalized.
+///
+/// # Panics
+///
+/// Will panic if `rhs` is not normalized when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_project_onto_normalized(DVec3 self,DVec3 rhs) {
+  cmeth_assert(dvec3_is_normalized(rhs));
+  f64 x=dvec3_dot(self,rhs);
+
+  return dvec3_mul_f64(self,x);
+}
+
+
+/// Returns the vector rejection of `self` from `rhs`.
+///
+ /// The vector rejection is the vector perpendicular to the projection of `self` onto
+/// `rhs`, in rhs words the result of `self - self.project_onto(rhs)`.
+///
+/// `rhs` must be normalized.
+///
+/// # Panics
+///
+/// Will panic if `rhs` is not normalized when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_reject_from_normalized(DVec3 self,DVec3 rhs) {
+  DVec3 projection=dvec3_project_onto_normalized(self,rhs);
+
+  return dvec3_sub(self,projection);
+}
+
+/// Returns a vector containing the nearest integer to a number for each element of `self`.
+/// Round half-way cases away from 0.0.
+inline
+const DVec3 dvec3_round(DVec3 self) {
+  DVec3 vec={
+    .x=f64_round(self.x),
+    .y=f64_round(self.y),
+    .z=f64_round(self.z)
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing the largest integer less than or equal to a number for each
+/// element of `self`.
+inline
+const DVec3 dvec3_floor(DVec3 self) {
+  DVec3 vec={
+    .x=f64_floor(self.x),
+    .y=f64_floor(self.y),
+    .z=f64_floor(self.z)
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing the smallest integer greater than or equal to a number for
+/// each element of `self`.
+inline
+const DVec3 dvec3_ceil(DVec3 self) {
+  DVec3 vec={
+    .x=f64_ceil(self.x),
+    .y=f64_ceil(self.y),
+    .z=f64_ceil(self.z)
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing the integer part each element of `self`. This means numbers are
+/// always truncated towards zero.
+inline
+const DVec3 dvec3_trunc(DVec3 self) {
+  DVec3 vec={
+    .x=f64_trunc(self.x),
+    .y=f64_trunc(self.y),
+    .z=f64_trunc(self.z)
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing the fractional part of the vector as `dvec3_sub(self,dvec3_trunc(self))`.
+///
+/// Note that this differs from the GLSL implementation of `fract` which returns
+/// `dvec3_sub(self,dvec3_floor(self))`.
+///
+/// Note that this is fast but not precise for large numbers.
+inline
+const DVec3 dvec3_fract(DVec3 self) {
+  DVec3 truncated=dvec3_trunc(self);
+  return dvec3_sub(self,truncated);
+}
+
+/// Returns a vector containing the fractional part of the vector as `dvec3_sub(self,dvec3_floor(self))`.
+///
+/// Note that this differs from the Rust implementation of `fract` which returns
+/// `dvec3_sub(self,dvec3_trunc(self))`.
+///
+/// Note that this is fast but not precise for large numbers.
+inline
+const DVec3 dvec3_fract_gl(DVec3 self) {
+  DVec3 floored=dvec3_floor(self);
+  return dvec3_sub(self,floored);
+}
+
+/// Returns a vector containing `e^self` (the exponential function) for each element of
+/// `self`.
+inline
+const DVec3 dvec3_exp(DVec3 self) {
+  DVec3 vec={
+    .x=f64_exp(self.x),
+    .y=f64_exp(self.y),
+    .z=f64_exp(self.z)
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing each element of `self` raised to the power of `n`.
+inline
+const DVec3 dvec3_pow(DVec3 self,f64 n) {
+  DVec3 vec={
+    .x=f64_pow(self.x,n),
+    .y=f64_pow(self.y,n),
+    .z=f64_pow(self.z,n)
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing the reciprocal `1.0/n` of each element of `self`.
+inline
+const DVec3 dvec3_recip(DVec3 self) {
+  DVec3 vec={
+    .x=1.0/self.x,
+    .y=1.0/self.y,
+    .z=1.0/self.z
+  };
+
+  return vec;
+}
+
+/// Performs a linear interpolation between `self` and `rhs` based on the value `s`.
+///
+/// When `s` is `0.0`, the result will be equal to `self`.  When `s` is `1.0`, the result
+/// will be equal to `rhs`. When `s` is outside of range `[0, 1]`, the result is linearly
+/// extrapolated.
+inline
+const DVec3 dvec3_lerp(DVec3 self,DVec3 rhs,f64 s) {
+  DVec3 srhs=dvec3_mul_f64(rhs,s);
+  DVec3 s_1_self=dvec3_mul_f64(self,(1.0 - s));
+  return dvec3_add(s_1_self,srhs);
+}
+
+/// Moves towards `rhs` based on the value `d`.
+///
+/// When `d` is `0.0`, the result will be equal to `self`. When `d` is equal to
+/// `dvec3_distance(self,rhs)`, the result will be equal to `rhs`. Will not go past `rhs`.
+inline
+const DVec3 dvec3_move_towards(DVec3* self,DVec3 rhs,f64 d) {
+  DVec3 a=dvec3_sub(rhs,*self);
+  f64 len=dvec3_len(a);
+  if(len<=d || len<=1e-4) {
+    return rhs;
+  }
+  return dvec3_add(*self,dvec3_mul_f64(a,d/len));
+}
+
+/// Calculates the midpoint between `self` and `rhs`.
+///
+/// The midpoint is the average of, or halfway point between, two vectors.
+/// `dvec3_midpoint(a,b)` should yield the same result as `dvec3_lerp(a, b, 0.5)`
+/// while being slightly cheaper to compute.
+inline
+const DVec3 dvec3_midpoint(DVec3 self,DVec3 rhs) {
+  return dvec3_mul_f64(dvec3_add(self,rhs),0.5);
+}
+
+/// Returns true if the absolute difference of all elements between `self` and `rhs` is
+/// less than or equal to `max_abs_diff`.
+///
+/// This can be used to compare if two vectors contain similar elements. It works best when
+/// comparing with a known value. The `max_abs_diff` that should be used used depends on
+/// the values being compared against.
+///
+/// For more see
+/// [comparing floating point numbers](https://randomascii.wordpress.com/2012/02/25/comparing-floating-point-numbers-2012-edition/).
+inline
+const bool dvec3_abs_diff_eq(DVec3 self,DVec3 rhs,f64 max_abs_diff) {
+  DVec3 abs_diff=dvec3_abs(dvec3_sub(self,rhs));
+  BVec3 mask=dvec3_cmple(abs_diff,dvec3_splat(max_abs_diff));
+  return bvec3_all(mask);
+}
+
+static inline_always
+const DVec3 _dvec3_x_self_over_len(DVec3 self,f64 x,f64 len_sq) {
+  f64 len=f64_sqrt(len_sq);
+  DVec3 self_over_len=dvec3_div_f64(self,len);
+  return dvec3_mul_f64(self_over_len,x);
+}
+
+/// Returns a vector with a length no less than `min` and no more than `max`.
+///
+/// # Panics
+///
+/// Will panic if `min` is greater than `max`, or if either `min` or `max` is negative, when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_clamp_length(DVec3 self,f64 min,f64 max) {
+  cmeth_assert(0.0 <= min);
+  cmeth_assert(min <= max);
+  f64 length_sq=dvec3_len_squared(self);
+  if(length_sq < min * min) {
+    return _dvec3_x_self_over_len(self,min,length_sq);
+  } else if(length_sq > max * max) {
+    return _dvec3_x_self_over_len(self,max,length_sq);
+  } else {
+    return self;
+  }
+}
+
+/// Returns a vector with a length no more than `max`.
+///
+/// # Panics
+///
+/// Will panic if `max` is negative when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_clamp_length_max(DVec3 self,f64 max) {
+  cmeth_assert(0.0 <= max);
+  f64 length_sq=dvec3_len_squared(self);
+  return (length_sq > max * max)? _dvec3_x_self_over_len(self,max,length_sq) : self;
+}
+
+/// Returns a vector with a length no less than `min`.
+///
+/// # Panics
+///
+/// Will panic if `min` is negative when `cmeth_assert` is enabled.
+inline
+const DVec3 dvec3_clamp_length_min(DVec3 self, f64 min) {
+  cmeth_assert(0.0 <= min);
+  f64 length_sq=dvec3_len_squared(self);
+  return (length_sq < min * min)? _dvec3_x_self_over_len(self,min,length_sq) : self;
+}
+
+/// Fused multiply-add. Computes `dvec3_add(dvec3_mul(self,a),b)` element-wise with only one rounding
+/// error, yielding a more accurate result than an unfused multiply-add.
+///
+/// Using `dvec3_mul_add` *may* be more performant than an unfused multiply-add if the target
+/// architecture has a dedicated fma CPU instruction. However, this is not always true,
+/// and will be heavily dependant on designing algorithms with specific target hardware in
+/// mind.
+inline
+const DVec3 dvec3_mul_add(DVec3 self,DVec3 a,DVec3 b) {
+  DVec3 vec={
+    .x=f64_mul_add(self.x, a.x, b.x),
+    .y=f64_mul_add(self.y, a.y, b.y),
+    .z=f64_mul_add(self.z, a.z, b.z)
+  };
+  return vec;
+}
+
+/// Returns a vector with all elements set to `0.0`.
+inline_always
+const DVec3 dvec3_default() {
+  return DVEC3_ZERO;
+}
+
+/// Returns the element-wise quotient of `self` and `rhs`.
+inline
+const DVec3 dvec3_div(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=self.x/rhs.x,
+    .y=self.y/rhs.y,
+    .z=self.z/rhs.z
+  };
+  return vec;
+}
+
+inline
+void dvec3_div_assign(DVec3* self,DVec3 rhs) {
+  *self=dvec3_div(*self,rhs);
+}
+
+/// Returns `self` with every element divided by `rhs`.
+inline
+const DVec3 dvec3_div_f64(DVec3 self,f64 rhs) {
+  DVec3 vec={
+    .x=self.x/rhs,
+    .y=self.y/rhs,
+    .z=self.z/rhs
+  };
+  return vec;
+}
+
+inline
+void dvec3_div_assign_f64(DVec3* self,f64 rhs) {
+  *self=dvec3_div_f64(*self,rhs);
+}
+
+/// Returns a vector with every element being `self` divided by the element of `rhs`.
+inline
+const DVec3 f64_div_dvec3(f64 self,DVec3 rhs) {
+  return dvec3_div(dvec3_splat(self),rhs);
+}
+
+/// Returns the element-wise product of `self` and `rhs`.
+inline
+const DVec3 dvec3_mul(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=self.x*rhs.x,
+    .y=self.y*rhs.y,
+    .z=self.z*rhs.z
+  };
+  return vec;
+}
+
+inline
+void dvec3_mul_assign(DVec3* self,DVec3 rhs) {
+  *self=dvec3_mul(*self,rhs);
+}
+
+/// Returns `self` with every element multiplied by `rhs`.
+inline
+const DVec3 dvec3_mul_f64(DVec3 self,f64 rhs) {
+  DVec3 vec={
+    .x=self.x*rhs,
+    .y=self.y*rhs,
+    .z=self.z*rhs
+  };
+  return vec;
+}
+
+inline
+void dvec3_mul_assign_f64(DVec3* self,f64 rhs) {
+  *self=dvec3_mul_f64(*self,rhs);
+}
+
+inline
+const DVec3 f64_mul_dvec3(f64 self,DVec3 rhs) {
+  return dvec3_mul_f64(rhs,self);
+}
+
+/// Returns the element-wise sum of `self` and `rhs`.
+inline
+const DVec3 dvec3_add(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=self.x+rhs.x,
+    .y=self.y+rhs.y,
+    .z=self.z+rhs.z
+  };
+  return vec;
+}
+
+inline
+void dvec3_add_assign(DVec3* self,DVec3 rhs) {
+  *self=dvec3_add(*self,rhs);
+}
+
+/// Returns `self` with `rhs` added to every element.
+inline
+const DVec3 dvec3_add_f64(DVec3 self,f64 rhs) {
+  DVec3 vec={
+    .x=self.x+rhs,
+    .y=self.y+rhs,
+    .z=self.z+rhs
+  };
+  return vec;
+}
+
+inline
+void dvec3_add_assign_f64(DVec3* self,f64 rhs) {
+  *self=dvec3_add_f64(*self,rhs);
+}
+
+inline
+const DVec3 f64_add_dvec3(f64 self,DVec3 rhs) {
+  return dvec3_add_f64(rhs,self);
+}
+
+/// Returns the element-wise difference of `self` and `rhs`.
+inline
+const DVec3 dvec3_sub(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=self.x-rhs.x,
+    .y=self.y-rhs.y,
+    .z=self.z-rhs.z
+  };
+  return vec;
+}
+
+inline
+void dvec3_sub_assign(DVec3* self,DVec3 rhs) {
+  *self=dvec3_sub(*self,rhs);
+}
+
+/// Returns `self` with `rhs` subtracted from every element.
+inline
+const DVec3 dvec3_sub_f64(DVec3 self,f64 rhs) {
+  DVec3 vec={
+    .x=self.x-rhs,
+    .y=self.y-rhs,
+    .z=self.z-rhs
+  };
+  return vec;
+}
+
+inline
+void dvec3_sub_assign_f64(DVec3* self,f64 rhs) {
+  *self=dvec3_sub_f64(*self,rhs);
+}
+
+/// Returns a vector with every element being `self` minus the element of `rhs`.
+inline
+const DVec3 f64_sub_dvec3(f64 self,DVec3 rhs) {
+  return dvec3_sub(dvec3_splat(self),rhs);
+}
+
+/// Returns the element-wise remainder of `self` and `rhs`, as `f64_rem` does.
+inline
+const DVec3 dvec3_rem(DVec3 self,DVec3 rhs) {
+  DVec3 vec={
+    .x=f64_rem(self.x,rhs.x),
+    .y=f64_rem(self.y,rhs.y),
+    .z=f64_rem(self.z,rhs.z)
+  };
+  return vec;
+}
+
+inline
+void dvec3_rem_assign(DVec3* self,DVec3 rhs) {
+  *self=dvec3_rem(*self,rhs);
+}
+
+inline
+const DVec3 dvec3_rem_f64(DVec3 self,f64 rhs) {
+  return dvec3_rem(self,dvec3_splat(rhs));
+}
+
+inline
+void dvec3_rem_assign_f64(DVec3* self,f64 rhs) {
+  *self=dvec3_rem_f64(*self,rhs);
+}
+
+inline
+const DVec3 f64_rem_dvec3(f64 self,DVec3 rhs) {
+  return dvec3_rem(dvec3_splat(self),rhs);
+}
+
+inline
+const DVec3 dvec3_neg(DVec3 self) {
+  DVec3 vec={
+    .x=-self.x,
+    .y=-self.y,
+    .z=-self.z
+  };
+  return vec;
+}
+
+/// Returns a pointer to the element at `index`.
+///
+/// Panics if `index` is greater than 2.
+inline
+const f64* dvec3_index(DVec3* self,usize index) {
+  switch(index) {
+    case 0: return &self->x;
+    case 1: return &self->y;
+    case 2: return &self->z;
+    default: panic("index out of bounds")
+  }
+}
@@ -0,0 +1,167 @@
+#ifndef CMETH_F64_DVEC3_H
+#define CMETH_F64_DVEC3_H
+#include "../prelude.h"
+#include "../bool/bvec3.h"
+#include "../f32/vec3.h"
+
+
+typedef struct {
+  f64 x;
+  f64 y;
+  f64 z;
+} DVec3;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const DVec3 dvec3(f64 x,f64 y,f64 z);
+CMETH_API const DVec3 dvec3_new(f64 x,f64 y,f64 z);
+CMETH_API const DVec3 dvec3_splat(f64 v);
+CMETH_API const DVec3 dvec3_select(BVec3 mask,DVec3 if_true,DVec3 if_false);
+CMETH_API const DVec3 dvec3_map(DVec3 self,f64 (*f)(f64));
+CMETH_API const DVec3 dvec3_from_array(f64 a[3]);
+CMETH_API void dvec3_write_to_slice(DVec3 self,f64* slice);
+CMETH_API const DVec3 dvec3_from_vec4(f64 v[4]);
+CMETH_API const DVec3 dvec3_with_x(DVec3 self,f64 x);
+CMETH_API const DVec3 dvec3_with_y(DVec3 self,f64 y);
+CMETH_API const DVec3 dvec3_with_z(DVec3 self,f64 z);
+CMETH_API const DVec3 vec3_as_dvec3(Vec3 v);
+CMETH_API const Vec3 dvec3_as_vec3(DVec3 self);
+CMETH_API const f64 dvec3_dot(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_dot_into_vec(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_cross(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_min(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_max(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_clamp(DVec3 self,DVec3 min,DVec3 max);
+CMETH_API const f64 dvec3_min_element(DVec3 self);
+CMETH_API const f64 dvec3_max_element(DVec3 self);
+CMETH_API const f64 dvec3_element_sum(DVec3 self);
+CMETH_API const f64 dvec3_element_product(DVec3 self);
+CMETH_API const BVec3 dvec3_cmpeq(DVec3 self,DVec3 rhs);
+CMETH_API const BVec3 dvec3_cmpne(DVec3 self,DVec3 rhs);
+CMETH_API const BVec3 dvec3_cmpge(DVec3 self,DVec3 rhs);
+CMETH_API const BVec3 dvec3_cmpgt(DVec3 self,DVec3 rhs);
+CMETH_API const BVec3 dvec3_cmple(DVec3 self,DVec3 rhs);
+CMETH_API const BVec3 dvec3_cmplt(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_abs(DVec3 self);
+CMETH_API const DVec3 dvec3_signum(DVec3 self);
+CMETH_API const DVec3 dvec3_copysign(DVec3 self,DVec3 rhs);
+CMETH_API const u32 dvec3_is_negative_bitmask(DVec3 self);
+CMETH_API const bool dvec3_is_finite(DVec3 self);
+CMETH_API const bool dvec3_is_nan(DVec3 self);
+CMETH_API const f64 dvec3_len(DVec3 self);
+CMETH_API const f64 dvec3_len_squared(DVec3 self);
+CMETH_API const f64 dvec3_len_recip(DVec3 self);
+CMETH_API const f64 dvec3_distance(DVec3 self,DVec3 rhs);
+CMETH_API const f64 dvec3_distance_squared(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_div_euclid(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_rem_euclid(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_normalize(DVec3 self);
+CMETH_API const DVec3 dvec3_normalize_or(DVec3 self,DVec3 fallback);
+CMETH_API const DVec3 dvec3_normalize_or_zero(DVec3 self);
+CMETH_API const bool dvec3_is_normalized(DVec3 self);
+CMETH_API const DVec3 dvec3_project_into(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_reject_from(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_project_onto_normalized(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_reject_from_normalized(DVec3 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_round(DVec3 self);
+CMETH_API const DVec3 dvec3_floor(DVec3 self);
+CMETH_API const DVec3 dvec3_ceil(DVec3 self);
+CMETH_API const DVec3 dvec3_trunc(DVec3 self);
+CMETH_API const DVec3 dvec3_fract(DVec3 self);
+CMETH_API const DVec3 dvec3_fract_gl(DVec3 self);
+CMETH_API const DVec3 dvec3_exp(DVec3 self);
+CMETH_API const DVec3 dvec3_pow(DVec3 self,f64 n);
+CMETH_API const DVec3 dvec3_recip(DVec3 self);
+CMETH_API const DVec3 dvec3_lerp(DVec3 self,DVec3 rhs,f64 s);
+CMETH_API const DVec3 dvec3_move_towards(DVec3* self,DVec3 rhs,f64 d);
+CMETH_API const DVec3 dvec3_midpoint(DVec3 self,DVec3 rhs);
+CMETH_API const bool dvec3_abs_diff_eq(DVec3 self,DVec3 rhs,f64 max_abs_diff);
+CMETH_API const DVec3 dvec3_clamp_length(DVec3 self,f64 min,f64 max);
+CMETH_API const DVec3 dvec3_clamp_length_max(DVec3 self,f64 max);
+CMETH_API const DVec3 dvec3_clamp_length_min(DVec3 self,f64 min);
+CMETH_API const DVec3 dvec3_mul_add(DVec3 self,DVec3 a,DVec3 b);
+CMETH_API const DVec3 dvec3_default();
+CMETH_API const DVec3 dvec3_div(DVec3 self,DVec3 rhs);
+CMETH_API void dvec3_div_assign(DVec3* self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_div_f64(DVec3 self,f64 rhs);
+CMETH_API void dvec3_div_assign_f64(DVec3* self,f64 rhs);
+CMETH_API const DVec3 f64_div_dvec3(f64 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_mul(DVec3 self,DVec3 rhs);
+CMETH_API void dvec3_mul_assign(DVec3* self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_mul_f64(DVec3 self,f64 rhs);
+CMETH_API void dvec3_mul_assign_f64(DVec3* self,f64 rhs);
+CMETH_API const DVec3 f64_mul_dvec3(f64 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_add(DVec3 self,DVec3 rhs);
+CMETH_API void dvec3_add_assign(DVec3* self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_add_f64(DVec3 self,f64 rhs);
+CMETH_API void dvec3_add_assign_f64(DVec3* self,f64 rhs);
+CMETH_API const DVec3 f64_add_dvec3(f64 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_sub(DVec3 self,DVec3 rhs);
+CMETH_API void dvec3_sub_assign(DVec3* self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_sub_f64(DVec3 self,f64 rhs);
+CMETH_API void dvec3_sub_assign_f64(DVec3* self,f64 rhs);
+CMETH_API const DVec3 f64_sub_dvec3(f64 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_rem(DVec3 self,DVec3 rhs);
+CMETH_API void dvec3_rem_assign(DVec3* self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_rem_f64(DVec3 self,f64 rhs);
+CMETH_API void dvec3_rem_assign_f64(DVec3* self,f64 rhs);
+CMETH_API const DVec3 f64_rem_dvec3(f64 self,DVec3 rhs);
+CMETH_API const DVec3 dvec3_neg(DVec3 self);
+CMETH_API const f64* dvec3_index(DVec3* self,usize index);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// All zeroes.
+#define DVEC3_ZERO dvec3_splat(0.0)
+
+/// All ones.
+#define DVEC3_ONE dvec3_splat(1.0)
+
+/// All negative ones.
+#define DVEC3_NEG_ONE dvec3_splat(-1.0)
+
+/// All `F64_MIN`.
+#define DVEC3_MIN dvec3_splat(F64_MIN)
+
+/// All `F64_MAX`.
+#define DVEC3_MAX dvec3_splat(F64_MAX)
+
+/// All `F64_NAN`.
+#define DVEC3_NAN dvec3_splat(F64_NAN)
+
+/// All `F64_INFINITY`.
+#define DVEC3_INFINITY dvec3_splat(F64_INFINITY)
+
+/// All `F64_NEG_INFINITY`.
+#define DVEC3_NEG_INFINITY dvec3_splat(F64_NEG_INFINITY)
+
+/// A unit vector pointing along the positive X axis.
+#define DVEC3_X dvec3_new(1.0,0.0,0.0)
+
+/// A unit vector pointing along the positive Y axis.
+#define DVEC3_Y dvec3_new(0.0,1.0,0.0)
+
+/// A unit vector pointing along the positive Z axis.
+#define DVEC3_Z dvec3_new(0.0,0.0,1.0)
+
+/// A unit vector pointing along the negative X axis.
+#define DVEC3_NEG_X dvec3_new(-1.0,0.0,0.0)
+
+/// A unit vector pointing along the negative Y axis.
+#define DVEC3_NEG_Y dvec3_new(0.0,-1.0,0.0)
+
+/// A unit vector pointing along the negative Z axis.
+#define DVEC3_NEG_Z dvec3_new(0.0,0.0,-1.0)
+
+/// The unit axes.
+#define DVEC3_AXES {DVEC3_X,DVEC3_Y,DVEC3_Z}
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "dvec3.c"
+#endif
+
+#endif
@@ -0,0 +1,692 @@
+// The scalar bodies inline the value-type API instead of calling back into the archive.
+#define CMETH_HEADER_ONLY
+#include <immintrin.h>
+#include "dvec3_batch.h"
+#include "math_impl.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// Every `*_batch` kernel has a scalar body, an AVX2 body on 4 `f64` lanes and an AVX-512
+// body on 8, bound once at load time from `cmeth_cpu_tier()`, like the
+// `affine3a_transform_*` kernels.
+//
+// `DVec3` arrays are 24-byte AoS. The element-wise kernels (the conversions, add and sub)
+// treat them as flat arrays of `3*n` elements; the origin of a conversion is held in three
+// registers, each rotated by one element, so that lane `i` of every register meets the
+// element `i%3` of the origin without a transpose. The other kernels load 4 (8) points as
+// three registers and transpose them into `x`, `y` and `z` registers, as `vec3_aos.h` does
+// for `Vec3`, and back before storing.
+//
+// The conversions, add and sub are bit-exact across tiers. The AVX bodies compute dot
+// products and cross products with FMA, so dot, cross, len, distance_squared and
+// normalize_or_zero can differ from the scalar body in the last bit or two.
+
+
+static inline_always target_avx2
+const __m256i _dvec3_tail_mask4(usize rem) {
+  const __m256i lanes=_mm256_setr_epi64x(0,1,2,3);
+  return _mm256_cmpgt_epi64(_mm256_set1_epi64x((i64)(rem<4? rem : 4)),lanes);
+}
+
+static inline_always target_avx2
+const __m128i _dvec3_tail_mask4_ps(usize rem) {
+  const __m128i lanes=_mm_setr_epi32(0,1,2,3);
+  return _mm_cmpgt_epi32(_mm_set1_epi32((i32)(rem<4? rem : 4)),lanes);
+}
+
+static inline_always target_avx2
+const __m256d _dvec3_load4(const f64* p,usize rem) {
+  return rem>=4? _mm256_loadu_pd(p) : _mm256_maskload_pd(p,_dvec3_tail_mask4(rem));
+}
+
+static inline_always target_avx2
+void _dvec3_store4(f64* p,usize rem,__m256d v) {
+  if(rem>=4) {
+    _mm256_storeu_pd(p,v);
+  } else {
+    _mm256_maskstore_pd(p,_dvec3_tail_mask4(rem),v);
+  }
+}
+
+/// Loads the `min(rem/3,4)` points at `p` into `x`, `y` and `z`, in point order. Missing
+/// points are zero.
+static inline_always target_avx2
+void _dvec3_gather4(const f64* p,usize rem,__m256d* x,__m256d* y,__m256d* z) {
+  // `v0=(x0,y0,z0,x1)`, `v1=(y1,z1,x2,y2)` and `v2=(z2,x3,y3,z3)`: two blends gather one
+  // element of every point, and a lane permute puts the points in order.
+  const __m256d v0=_dvec3_load4(p,rem);
+  const __m256d v1=_dvec3_load4(p+4,rem>4? rem-4 : 0);
+  const __m256d v2=_dvec3_load4(p+8,rem>8? rem-8 : 0);
+  *x=_mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(v0,v1,0x4),v2,0x2),_MM_SHUFFLE(1,2,3,0));
+  *y=_mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(v1,v0,0x2),v2,0x4),_MM_SHUFFLE(2,3,0,1));
+  *z=_mm256_permute4x64_pd(_mm256_blend_pd(_mm256_blend_pd(v2,v0,0x4),v1,0x2),_MM_SHUFFLE(3,0,1,2));
+}
+
+/// Stores the `min(rem/3,4)` points of `x`, `y` and `z` at `p`.
+static inline_always target_avx2
+void _dvec3_scatter4(f64* p,usize rem,__m256d x,__m256d y,__m256d z) {
+  // The permutes of `_dvec3_gather4` are their own inverses.
+  const __m256d xb=_mm256_permute4x64_pd(x,_MM_SHUFFLE(1,2,3,0));
+  const __m256d yb=_mm256_permute4x64_pd(y,_MM_SHUFFLE(2,3,0,1));
+  const __m256d zb=_mm256_permute4x64_pd(z,_MM_SHUFFLE(3,0,1,2));
+  _dvec3_store4(p,rem,_mm256_blend_pd(_mm256_blend_pd(xb,yb,0x2),zb,0x4));
+  _dvec3_store4(p+4,rem>4? rem-4 : 0,_mm256_blend_pd(_mm256_blend_pd(yb,zb,0x2),xb,0x4));
+  _dvec3_store4(p+8,rem>8? rem-8 : 0,_mm256_blend_pd(_mm256_blend_pd(zb,xb,0x2),yb,0x4));
+}
+
+static inline_always target_avx2
+const __m256d _dvec3_dot4(__m256d ax,__m256d ay,__m256d az,__m256d bx,__m256d by,__m256d bz) {
+  return _mm256_fmadd_pd(az,bz,_mm256_fmadd_pd(ay,by,_mm256_mul_pd(ax,bx)));
+}
+
+
+static inline_always target_avx512
+const __mmask8 _dvec3_tail_mask8(usize rem) {
+  return rem>=8? (__mmask8)0xFF : (__mmask8)((1U<<rem)-1);
+}
+
+/// Loads the `min(rem/3,8)` points at `p` into `x`, `y` and `z`, in point order. Missing
+/// points are zero.
+static inline_always target_avx512
+void _dvec3_gather8(const f64* p,usize rem,__m512d* x,__m512d* y,__m512d* z) {
+  // The first two-source permute takes what lies in `v0` and `v1`, the second fills in
+  // from `v2`.
+  const __m512i x_lo=_mm512_setr_epi64(0,3,6,9,12,15,0,0);
+  const __m512i x_hi=_mm512_setr_epi64(0,1,2,3,4,5,10,13);
+  const __m512i y_lo=_mm512_setr_epi64(1,4,7,10,13,0,0,0);
+  const __m512i y_hi=_mm512_setr_epi64(0,1,2,3,4,8,11,14);
+  const __m512i z_lo=_mm512_setr_epi64(2,5,8,11,14,0,0,0);
+  const __m512i z_hi=_mm512_setr_epi64(0,1,2,3,4,9,12,15);
+  const __m512d v0=_mm512_maskz_loadu_pd(_dvec3_tail_mask8(rem),p);
+  const __m512d v1=_mm512_maskz_loadu_pd(_dvec3_tail_mask8(rem>8? rem-8 : 0),p+8);
+  const __m512d v2=_mm512_maskz_loadu_pd(_dvec3_tail_mask8(rem>16? rem-16 : 0),p+16);
+  *x=_mm512_permutex2var_pd(_mm512_permutex2var_pd(v0,x_lo,v1),x_hi,v2);
+  *y=_mm512_permutex2var_pd(_mm512_permutex2var_pd(v0,y_lo,v1),y_hi,v2);
+  *z=_mm512_permutex2var_pd(_mm512_permutex2var_pd(v0,z_lo,v1),z_hi,v2);
+}
+
+/// Stores the `min(rem/3,8)` points of `x`, `y` and `z` at `p`.
+static inline_always target_avx512
+void _dvec3_scatter8(f64* p,usize rem,__m512d x,__m512d y,__m512d z) {
+  // The first permute interleaves `x` and `y`, the second slots in `z`.
+  const __m512i o0_xy=_mm512_setr_epi64(0,8,0,1,9,0,2,10);
+  const __m512i o0_z=_mm512_setr_epi64(0,1,8,3,4,9,6,7);
+  const __m512i o1_xy=_mm512_setr_epi64(0,3,11,0,4,12,0,5);
+  const __m512i o1_z=_mm512_setr_epi64(10,1,2,11,4,5,12,7);
+  const __m512i o2_xy=_mm512_setr_epi64(13,0,6,14,0,7,15,0);
+  const __m512i o2_z=_mm512_setr_epi64(0,13,2,3,14,5,6,15);
+  _mm512_mask_storeu_pd(p,_dvec3_tail_mask8(rem),
+    _mm512_permutex2var_pd(_mm512_permutex2var_pd(x,o0_xy,y),o0_z,z));
+  _mm512_mask_storeu_pd(p+8,_dvec3_tail_mask8(rem>8? rem-8 : 0),
+    _mm512_permutex2var_pd(_mm512_permutex2var_pd(x,o1_xy,y),o1_z,z));
+  _mm512_mask_storeu_pd(p+16,_dvec3_tail_mask8(rem>16? rem-16 : 0),
+    _mm512_permutex2var_pd(_mm512_permutex2var_pd(x,o2_xy,y),o2_z,z));
+}
+
+static inline_always target_avx512
+const __m512d _dvec3_dot8(__m512d ax,__m512d ay,__m512d az,__m512d bx,__m512d by,__m512d bz) {
+  return _mm512_fmadd_pd(az,bz,_mm512_fmadd_pd(ay,by,_mm512_mul_pd(ax,bx)));
+}
+
+
+static
+void _dvec3_to_vec3_relative_scalar(const DVec3* in,DVec3 origin,Vec3* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_as_vec3(dvec3_sub(in[i],origin));
+  }
+}
+
+static
+void _vec3_to_dvec3_relative_scalar(const Vec3* in,DVec3 origin,DVec3* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_add(vec3_as_dvec3(in[i]),origin);
+  }
+}
+
+static
+void _dvec3_add_scalar(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_add(a[i],b[i]);
+  }
+}
+
+static
+void _dvec3_sub_scalar(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_sub(a[i],b[i]);
+  }
+}
+
+static
+void _dvec3_dot_scalar(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_dot(a[i],b[i]);
+  }
+}
+
+static
+void _dvec3_cross_scalar(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_cross(a[i],b[i]);
+  }
+}
+
+static
+void _dvec3_len_scalar(const DVec3* in,f64* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_len(in[i]);
+  }
+}
+
+static
+void _dvec3_distance_squared_scalar(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_distance_squared(a[i],b[i]);
+  }
+}
+
+static
+void _dvec3_normalize_or_zero_scalar(const DVec3* in,DVec3* out,usize n) {
+  for(usize i=0;i<n;i++) {
+    out[i]=dvec3_normalize_or_zero(in[i]);
+  }
+}
+
+
+static target_avx2
+void _dvec3_to_vec3_relative_avx2(const DVec3* in,DVec3 origin,Vec3* out,usize n) {
+  const __m256d o0=_mm256_setr_pd(origin.x,origin.y,origin.z,origin.x);
+  const __m256d o1=_mm256_setr_pd(origin.y,origin.z,origin.x,origin.y);
+  const __m256d o2=_mm256_setr_pd(origin.z,origin.x,origin.y,origin.z);
+  const f64* src=(const f64*)in;
+  f32* dst=(f32*)out;
+  const usize len=n*3;
+  for(usize i=0;i<len;i+=12) {
+    const usize rem=len-i;
+    const usize rem1=rem>4? rem-4 : 0;
+    const usize rem2=rem>8? rem-8 : 0;
+    const __m128 d0=_mm256_cvtpd_ps(_mm256_sub_pd(_dvec3_load4(src+i,rem),o0));
+    const __m128 d1=_mm256_cvtpd_ps(_mm256_sub_pd(_dvec3_load4(src+i+4,rem1),o1));
+    const __m128 d2=_mm256_cvtpd_ps(_mm256_sub_pd(_dvec3_load4(src+i+8,rem2),o2));
+    if(rem>=12) {
+      _mm_storeu_ps(dst+i,d0);
+      _mm_storeu_ps(dst+i+4,d1);
+      _mm_storeu_ps(dst+i+8,d2);
+    } else {
+      _mm_maskstore_ps(dst+i,_dvec3_tail_mask4_ps(rem),d0);
+      _mm_maskstore_ps(dst+i+4,_dvec3_tail_mask4_ps(rem1),d1);
+      _mm_maskstore_ps(dst+i+8,_dvec3_tail_mask4_ps(rem2),d2);
+    }
+  }
+}
+
+static target_avx2
+void _vec3_to_dvec3_relative_avx2(const Vec3* in,DVec3 origin,DVec3* out,usize n) {
+  const __m256d o0=_mm256_setr_pd(origin.x,origin.y,origin.z,origin.x);
+  const __m256d o1=_mm256_setr_pd(origin.y,origin.z,origin.x,origin.y);
+  const __m256d o2=_mm256_setr_pd(origin.z,origin.x,origin.y,origin.z);
+  const f32* src=(const f32*)in;
+  f64* dst=(f64*)out;
+  const usize len=n*3;
+  for(usize i=0;i<len;i+=12) {
+    const usize rem=len-i;
+    const usize rem1=rem>4? rem-4 : 0;
+    const usize rem2=rem>8? rem-8 : 0;
+    __m128 s0,s1,s2;
+    if(rem>=12) {
+      s0=_mm_loadu_ps(src+i);
+      s1=_mm_loadu_ps(src+i+4);
+      s2=_mm_loadu_ps(src+i+8);
+    } else {
+      s0=_mm_maskload_ps(src+i,_dvec3_tail_mask4_ps(rem));
+      s1=_mm_maskload_ps(src+i+4,_dvec3_tail_mask4_ps(rem1));
+      s2=_mm_maskload_ps(src+i+8,_dvec3_tail_mask4_ps(rem2));
+    }
+    _dvec3_store4(dst+i,rem,_mm256_add_pd(_mm256_cvtps_pd(s0),o0));
+    _dvec3_store4(dst+i+4,rem1,_mm256_add_pd(_mm256_cvtps_pd(s1),o1));
+    _dvec3_store4(dst+i+8,rem2,_mm256_add_pd(_mm256_cvtps_pd(s2),o2));
+  }
+}
+
+static target_avx2
+void _dvec3_add_avx2(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  const f64* pa=(const f64*)a;
+  const f64* pb=(const f64*)b;
+  f64* dst=(f64*)out;
+  const usize len=n*3;
+  for(usize i=0;i<len;i+=4) {
+    const usize rem=len-i;
+    _dvec3_store4(dst+i,rem,_mm256_add_pd(_dvec3_load4(pa+i,rem),_dvec3_load4(pb+i,rem)));
+  }
+}
+
+static target_avx2
+void _dvec3_sub_avx2(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  const f64* pa=(const f64*)a;
+  const f64* pb=(const f64*)b;
+  f64* dst=(f64*)out;
+  const usize len=n*3;
+  for(usize i=0;i<len;i+=4) {
+    const usize rem=len-i;
+    _dvec3_store4(dst+i,rem,_mm256_sub_pd(_dvec3_load4(pa+i,rem),_dvec3_load4(pb+i,rem)));
+  }
+}
+
+static target_avx2
+void _dvec3_dot_avx2(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  for(usize i=0;i<n;i+=4) {
+    const usize rem=n-i;
+    __m256d ax,ay,az,bx,by,bz;
+    _dvec3_gather4((const f64*)(a+i),rem*3,&ax,&ay,&az);
+    _dvec3_gather4((const f64*)(b+i),rem*3,&bx,&by,&bz);
+    _dvec3_store4(out+i,rem,_dvec3_dot4(ax,ay,az,bx,by,bz));
+  }
+}
+
+static target_avx2
+void _dvec3_cross_avx2(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  for(usize i=0;i<n;i+=4) {
+    const usize rem=n-i;
+    __m256d ax,ay,az,bx,by,bz;
+    _dvec3_gather4((const f64*)(a+i),rem*3,&ax,&ay,&az);
+    _dvec3_gather4((const f64*)(b+i),rem*3,&bx,&by,&bz);
+    const __m256d x=_mm256_fmsub_pd(ay,bz,_mm256_mul_pd(by,az));
+    const __m256d y=_mm256_fmsub_pd(az,bx,_mm256_mul_pd(bz,ax));
+    const __m256d z=_mm256_fmsub_pd(ax,by,_mm256_mul_pd(bx,ay));
+    _dvec3_scatter4((f64*)(out+i),rem*3,x,y,z);
+  }
+}
+
+static target_avx2
+void _dvec3_len_avx2(const DVec3* in,f64* out,usize n) {
+  for(usize i=0;i<n;i+=4) {
+    const usize rem=n-i;
+    __m256d x,y,z;
+    _dvec3_gather4((const f64*)(in+i),rem*3,&x,&y,&z);
+    _dvec3_store4(out+i,rem,_mm256_sqrt_pd(_dvec3_dot4(x,y,z,x,y,z)));
+  }
+}
+
+static target_avx2
+void _dvec3_distance_squared_avx2(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  for(usize i=0;i<n;i+=4) {
+    const usize rem=n-i;
+    __m256d ax,ay,az,bx,by,bz;
+    _dvec3_gather4((const f64*)(a+i),rem*3,&ax,&ay,&az);
+    _dvec3_gather4((const f64*)(b+i),rem*3,&bx,&by,&bz);
+    const __m256d dx=_mm256_sub_pd(ax,bx);
+    const __m256d dy=_mm256_sub_pd(ay,by);
+    const __m256d dz=_mm256_sub_pd(az,bz);
+    _dvec3_store4(out+i,rem,_dvec3_dot4(dx,dy,dz,dx,dy,dz));
+  }
+}
+
+static target_avx2
+void _dvec3_normalize_or_zero_avx2(const DVec3* in,DVec3* out,usize n) {
+  const __m256d one=_mm256_set1_pd(1.0);
+  const __m256d zero=_mm256_setzero_pd();
+  const __m256d infinity=_mm256_set1_pd(F64_INFINITY);
+  for(usize i=0;i<n;i+=4) {
+    const usize rem=n-i;
+    __m256d x,y,z;
+    _dvec3_gather4((const f64*)(in+i),rem*3,&x,&y,&z);
+    const __m256d rcp=_mm256_div_pd(one,_mm256_sqrt_pd(_dvec3_dot4(x,y,z,x,y,z)));
+    // As `dvec3_normalize_or`: the reciprocal must be finite and positive, which NaN is not.
+    const __m256d keep=_mm256_and_pd(_mm256_cmp_pd(rcp,zero,_CMP_GT_OQ),_mm256_cmp_pd(rcp,infinity,_CMP_LT_OQ));
+    _dvec3_scatter4((f64*)(out+i),rem*3,
+      _mm256_and_pd(_mm256_mul_pd(x,rcp),keep),
+      _mm256_and_pd(_mm256_mul_pd(y,rcp),keep),
+      _mm256_and_pd(_mm256_mul_pd(z,rcp),keep));
+  }
+}
+
+
+static target_avx512
+void _dvec3_to_vec3_relative_avx512(const DVec3* in,DVec3 origin,Vec3* out,usize n) {
+  const __m512d o0=_mm512_setr_pd(origin.x,origin.y,origin.z,origin.x,origin.y,origin.z,origin.x,origin.y);
+  const __m512d o1=_mm512_setr_pd(origin.z,origin.x,origin.y,origin.z,origin.x,origin.y,origin.z,origin.x);
+  const __m512d o2=_mm512_setr_pd(origin.y,origin.z,origin.x,origin.y,origin.z,origin.x,origin.y,origin.z);
+  const f64* src=(const f64*)in;
+  f32* dst=(f32*)out;
+  const usize len=n*3;
+  for(usize i=0;i<len;i+=24) {
+    const usize rem=len-i;
+    const __mmask8 m0=_dvec3_tail_mask8(rem);
+    const __mmask8 m1=_dvec3_tail_mask8(rem>8? rem-8 : 0);
+    const __mmask8 m2=_dvec3_tail_mask8(rem>16? rem-16 : 0);
+    _mm256_mask_storeu_ps(dst+i,m0,_mm512_cvtpd_ps(_mm512_sub_pd(_mm512_maskz_loadu_pd(m0,src+i),o0)));
+    _mm256_mask_storeu_ps(dst+i+8,m1,_mm512_cvtpd_ps(_mm512_sub_pd(_mm512_maskz_loadu_pd(m1,src+i+8),o1)));
+    _mm256_mask_storeu_ps(dst+i+16,m2,_mm512_cvtpd_ps(_mm512_sub_pd(_mm512_maskz_loadu_pd(m2,src+i+16),o2)));
+  }
+}
+
+static target_avx512
+void _vec3_to_dvec3_relative_avx512(const Vec3* in,DVec3 origin,DVec3* out,usize n) {
+  const __m512d o0=_mm512_setr_pd(origin.x,origin.y,origin.z,origin.x,origin.y,origin.z,origin.x,origin.y);
+  const __m512d o1=_mm512_setr_pd(origin.z,origin.x,origin.y,origin.z,origin.x,origin.y,origin.z,origin.x);
+  const __m512d o2=_mm512_setr_pd(origin.y,origin.z,origin.x,origin.y,origin.z,origin.x,origin.y,origin.z);
+  const f32* src=(const f32*)in;
+  f64* dst=(f64*)out;
+  const usize len=n*3;
+  for(usize i=0;i<len;i+=24) {
+    const usize rem=len-i;
+    const __mmask8 m0=_dvec3_tail_mask8(rem);
+    const __mmask8 m1=_dvec3_tail_mask8(rem>8? rem-8 : 0);
+    const __mmask8 m2=_dvec3_tail_mask8(rem>16? rem-16 : 0);
+    _mm512_mask_storeu_pd(dst+i,m0,_mm512_add_pd(_mm512_cvtps_pd(_mm256_maskz_loadu_ps(m0,src+i)),o0));
+    _mm512_mask_storeu_pd(dst+i+8,m1,_mm512_add_pd(_mm512_cvtps_pd(_mm256_maskz_loadu_ps(m1,src+i+8)),o1));
+    _mm512_mask_storeu_pd(dst+i+16,m2,_mm512_add_pd(_mm512_cvtps_pd(_mm256_maskz_loadu_ps(m2,src+i+16)),o2));
+  }
+}
+
+static target_avx512
+void _dvec3_add_avx512(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  const f64* pa=(const f64*)a;
+  const f64* pb=(const f64*)b;
+  f64* dst=(f64*)out;
+  const usize len=n*3;
+  for(usize i=0;i<len;i+=8) {
+    const __mmask8 m=_dvec3_tail_mask8(len-i);
+    _mm512_mask_storeu_pd(dst+i,m,_mm512_add_pd(_mm512_maskz_loadu_pd(m,pa+i),_mm512_maskz_loadu_pd(m,pb+i)));
+  }
+}
+
+static target_avx512
+void _dvec3_sub_avx512(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  const f64* pa=(const f64*)a;
+  const f64* pb=(const f64*)b;
+  f64* dst=(f64*)out;
+  const usize len=n*3;
+  for(usize i=0;i<len;i+=8) {
+    const __mmask8 m=_dvec3_tail_mask8(len-i);
+    _mm512_mask_storeu_pd(dst+i,m,_mm512_sub_pd(_mm512_maskz_loadu_pd(m,pa+i),_mm512_maskz_loadu_pd(m,pb+i)));
+  }
+}
+
+static target_avx512
+void _dvec3_dot_avx512(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  for(usize i=0;i<n;i+=8) {
+    const usize rem=n-i;
+    __m512d ax,ay,az,bx,by,bz;
+    _dvec3_gather8((const f64*)(a+i),rem*3,&ax,&ay,&az);
+    _dvec3_gather8((const f64*)(b+i),rem*3,&bx,&by,&bz);
+    _mm512_mask_storeu_pd(out+i,_dvec3_tail_mask8(rem),_dvec3_dot8(ax,ay,az,bx,by,bz));
+  }
+}
+
+static target_avx512
+void _dvec3_cross_avx512(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  for(usize i=0;i<n;i+=8) {
+    const usize rem=n-i;
+    __m512d ax,ay,az,bx,by,bz;
+    _dvec3_gather8((const f64*)(a+i),rem*3,&ax,&ay,&az);
+    _dvec3_gather8((const f64*)(b+i),rem*3,&bx,&by,&bz);
+    const __m512d x=_mm512_fmsub_pd(ay,bz,_mm512_mul_pd(by,az));
+    const __m512d y=_mm512_fmsub_pd(az,bx,_mm512_mul_pd(bz,ax));
+    const __m512d z=_mm512_fmsub_pd(ax,by,_mm512_mul_pd(bx,ay));
+    _dvec3_scatter8((f64*)(out+i),rem*3,x,y,z);
+  }
+}
+
+static target_avx512
+void _dvec3_len_avx512(const DVec3* in,f64* out,usize n) {
+  for(usize i=0;i<n;i+=8) {
+    const usize rem=n-i;
+    __m512d x,y,z;
+    _dvec3_gather8((const f64*)(in+i),rem*3,&x,&y,&z);
+    _mm512_mask_storeu_pd(out+i,_dvec3_tail_mask8(rem),_mm512_sqrt_pd(_dvec3_dot8(x,y,z,x,y,z)));
+  }
+}
+
+static target_avx512
+void _dvec3_distance_squared_avx512(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  for(usize i=0;i<n;i+=8) {
+    const usize rem=n-i;
+    __m512d ax,ay,az,bx,by,bz;
+    _dvec3_gather8((const f64*)(a+i),rem*3,&ax,&ay,&az);
+    _dvec3_gather8((const f64*)(b+i),rem*3,&bx,&by,&bz);
+    const __m512d dx=_mm512_sub_pd(ax,bx);
+    const __m512d dy=_mm512_sub_pd(ay,by);
+    const __m512d dz=_mm512_sub_pd(az,bz);
+    _mm512_mask_storeu_pd(out+i,_dvec3_tail_mask8(rem),_dvec3_dot8(dx,dy,dz,dx,dy,dz));
+  }
+}
+
+static target_avx512
+void _dvec3_normalize_or_zero_avx512(const DVec3* in,DVec3* out,usize n) {
+  const __m512d one=_mm512_set1_pd(1.0);
+  const __m512d zero=_mm512_setzero_pd();
+  const __m512d infinity=_mm512_set1_pd(F64_INFINITY);
+  for(usize i=0;i<n;i+=8) {
+    const usize rem=n-i;
+    __m512d x,y,z;
+    _dvec3_gather8((const f64*)(in+i),rem*3,&x,&y,&z);
+    const __m512d rcp=_mm512_div_pd(one,_mm512_sqrt_pd(_dvec3_dot8(x,y,z,x,y,z)));
+    const __mmask8 keep=_mm512_cmp_pd_mask(rcp,zero,_CMP_GT_OQ) & _mm512_cmp_pd_mask(rcp,infinity,_CMP_LT_OQ);
+    _dvec3_scatter8((f64*)(out+i),rem*3,
+      _mm512_maskz_mul_pd(keep,x,rcp),
+      _mm512_maskz_mul_pd(keep,y,rcp),
+      _mm512_maskz_mul_pd(keep,z,rcp));
+  }
+}
+
+
+static struct {
+  void (*to_vec3_relative)(const DVec3*,DVec3,Vec3*,usize);
+  void (*from_vec3_relative)(const Vec3*,DVec3,DVec3*,usize);
+  void (*add)(const DVec3*,const DVec3*,DVec3*,usize);
+  void (*sub)(const DVec3*,const DVec3*,DVec3*,usize);
+  void (*dot)(const DVec3*,const DVec3*,f64*,usize);
+  void (*cross)(const DVec3*,const DVec3*,DVec3*,usize);
+  void (*len)(const DVec3*,f64*,usize);
+  void (*distance_squared)(const DVec3*,const DVec3*,f64*,usize);
+  void (*normalize_or_zero)(const DVec3*,DVec3*,usize);
+} _kernels={
+  .to_vec3_relative=_dvec3_to_vec3_relative_scalar,
+  .from_vec3_relative=_vec3_to_dvec3_relative_scalar,
+  .add=_dvec3_add_scalar,
+  .sub=_dvec3_sub_scalar,
+  .dot=_dvec3_dot_scalar,
+  .cross=_dvec3_cross_scalar,
+  .len=_dvec3_len_scalar,
+  .distance_squared=_dvec3_distance_squared_scalar,
+  .normalize_or_zero=_dvec3_normalize_or_zero_scalar,
+};
+
+__attribute__((constructor))
+static void _dvec3_batch_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.to_vec3_relative=_dvec3_to_vec3_relative_avx512;
+      _kernels.from_vec3_relative=_vec3_to_dvec3_relative_avx512;
+      _kernels.add=_dvec3_add_avx512;
+      _kernels.sub=_dvec3_sub_avx512;
+      _kernels.dot=_dvec3_dot_avx512;
+      _kernels.cross=_dvec3_cross_avx512;
+      _kernels.len=_dvec3_len_avx512;
+      _kernels.distance_squared=_dvec3_distance_squared_avx512;
+      _kernels.normalize_or_zero=_dvec3_normalize_or_zero_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.to_vec3_relative=_dvec3_to_vec3_relative_avx2;
+      _kernels.from_vec3_relative=_vec3_to_dvec3_relative_avx2;
+      _kernels.add=_dvec3_add_avx2;
+      _kernels.sub=_dvec3_sub_avx2;
+      _kernels.dot=_dvec3_dot_avx2;
+      _kernels.cross=_dvec3_cross_avx2;
+      _kernels.len=_dvec3_len_avx2;
+      _kernels.distance_squared=_dvec3_distance_squared_avx2;
+      _kernels.normalize_or_zero=_dvec3_normalize_or_zero_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Computes `out[i]=dvec3_as_vec3(dvec3_sub(in[i],origin))` for every `i<n`.
+///
+/// The offset from `origin` is taken in `f64` before it is rounded to `f32`, so every
+/// element keeps a relative precision of `2^-24` of its offset however far `origin` is from
+/// zero: a point 10 km from an origin 6371 km out is still placed within a millimetre.
+void dvec3_to_vec3_relative_batch(const DVec3* in,DVec3 origin,Vec3* out,usize n) {
+  _kernels.to_vec3_relative(in,origin,out,n);
+}
+
+/// Computes `out[i]=dvec3_add(vec3_as_dvec3(in[i]),origin)` for every `i<n`, the inverse of
+/// `dvec3_to_vec3_relative_batch` up to the rounding to `f32`.
+void vec3_to_dvec3_relative_batch(const Vec3* in,DVec3 origin,DVec3* out,usize n) {
+  _kernels.from_vec3_relative(in,origin,out,n);
+}
+
+/// Computes `out[i]=dvec3_add(a[i],b[i])` for every `i<n`.
+void dvec3_add_batch(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  _kernels.add(a,b,out,n);
+}
+
+/// Computes `out[i]=dvec3_sub(a[i],b[i])` for every `i<n`.
+void dvec3_sub_batch(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  _kernels.sub(a,b,out,n);
+}
+
+/// Computes `out[i]=dvec3_dot(a[i],b[i])` for every `i<n`.
+void dvec3_dot_batch(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  _kernels.dot(a,b,out,n);
+}
+
+/// Computes `out[i]=dvec3_cross(a[i],b[i])` for every `i<n`.
+void dvec3_cross_batch(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  _kernels.cross(a,b,out,n);
+}
+
+/// Computes `out[i]=dvec3_len(in[i])` for every `i<n`.
+void dvec3_len_batch(const DVec3* in,f64* out,usize n) {
+  _kernels.len(in,out,n);
+}
+
+/// Computes `out[i]=dvec3_distance_squared(a[i],b[i])` for every `i<n`.
+void dvec3_distance_squared_batch(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  _kernels.distance_squared(a,b,out,n);
+}
+
+/// Computes `out[i]=dvec3_normalize_or_zero(in[i])` for every `i<n`.
+void dvec3_normalize_or_zero_batch(const DVec3* in,DVec3* out,usize n) {
+  _kernels.normalize_or_zero(in,out,n);
+}
+
+
+/// The arguments of a `_parallel` call. The arrays are offset by the start of every range,
+/// in points, so the origin of a conversion stays in phase with the flat kernels.
+typedef struct {
+  const void* a;
+  const void* b;
+  DVec3 origin;
+  void* out;
+} _DVec3BatchJob;
+
+static void _dvec3_to_vec3_relative_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  dvec3_to_vec3_relative_batch((const DVec3*)job->a+begin,job->origin,(Vec3*)job->out+begin,end-begin);
+}
+
+static void _vec3_to_dvec3_relative_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  vec3_to_dvec3_relative_batch((const Vec3*)job->a+begin,job->origin,(DVec3*)job->out+begin,end-begin);
+}
+
+static void _dvec3_add_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  dvec3_add_batch((const DVec3*)job->a+begin,(const DVec3*)job->b+begin,(DVec3*)job->out+begin,end-begin);
+}
+
+static void _dvec3_sub_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  dvec3_sub_batch((const DVec3*)job->a+begin,(const DVec3*)job->b+begin,(DVec3*)job->out+begin,end-begin);
+}
+
+static void _dvec3_dot_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  dvec3_dot_batch((const DVec3*)job->a+begin,(const DVec3*)job->b+begin,(f64*)job->out+begin,end-begin);
+}
+
+static void _dvec3_cross_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  dvec3_cross_batch((const DVec3*)job->a+begin,(const DVec3*)job->b+begin,(DVec3*)job->out+begin,end-begin);
+}
+
+static void _dvec3_len_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  dvec3_len_batch((const DVec3*)job->a+begin,(f64*)job->out+begin,end-begin);
+}
+
+static void _dvec3_distance_squared_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  dvec3_distance_squared_batch((const DVec3*)job->a+begin,(const DVec3*)job->b+begin,(f64*)job->out+begin,end-begin);
+}
+
+static void _dvec3_normalize_or_zero_range(void* ctx,usize begin,usize end) {
+  const _DVec3BatchJob* job=ctx;
+  dvec3_normalize_or_zero_batch((const DVec3*)job->a+begin,(DVec3*)job->out+begin,end-begin);
+}
+
+/// Works like `dvec3_to_vec3_relative_batch`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void dvec3_to_vec3_relative_batch_parallel(const DVec3* in,DVec3 origin,Vec3* out,usize n) {
+  _DVec3BatchJob job={.a=in,.origin=origin,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_dvec3_to_vec3_relative_range,&job);
+}
+
+/// Works like `vec3_to_dvec3_relative_batch`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void vec3_to_dvec3_relative_batch_parallel(const Vec3* in,DVec3 origin,DVec3* out,usize n) {
+  _DVec3BatchJob job={.a=in,.origin=origin,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_to_dvec3_relative_range,&job);
+}
+
+/// Works like `dvec3_add_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void dvec3_add_batch_parallel(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  _DVec3BatchJob job={.a=a,.b=b,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_dvec3_add_range,&job);
+}
+
+/// Works like `dvec3_sub_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void dvec3_sub_batch_parallel(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  _DVec3BatchJob job={.a=a,.b=b,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_dvec3_sub_range,&job);
+}
+
+/// Works like `dvec3_dot_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void dvec3_dot_batch_parallel(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  _DVec3BatchJob job={.a=a,.b=b,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_dvec3_dot_range,&job);
+}
+
+/// Works like `dvec3_cross_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void dvec3_cross_batch_parallel(const DVec3* a,const DVec3* b,DVec3* out,usize n) {
+  _DVec3BatchJob job={.a=a,.b=b,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_dvec3_cross_range,&job);
+}
+
+/// Works like `dvec3_len_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void dvec3_len_batch_parallel(const DVec3* in,f64* out,usize n) {
+  _DVec3BatchJob job={.a=in,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_dvec3_len_range,&job);
+}
+
+/// Works like `dvec3_distance_squared_batch`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void dvec3_distance_squared_batch_parallel(const DVec3* a,const DVec3* b,f64* out,usize n) {
+  _DVec3BatchJob job={.a=a,.b=b,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_dvec3_distance_squared_range,&job);
+}
+
+/// Works like `dvec3_normalize_or_zero_batch`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void dvec3_normalize_or_zero_batch_parallel(const DVec3* in,DVec3* out,usize n) {
+  _DVec3BatchJob job={.a=in,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_dvec3_normalize_or_zero_range,&job);
+}
@@ -0,0 +1,33 @@
+#ifndef CMETH_F64_DVEC3_BATCH_H
+#define CMETH_F64_DVEC3_BATCH_H
+#include "../prelude.h"
+#include "../f32/vec3.h"
+#include "dvec3.h"
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+void dvec3_to_vec3_relative_batch(const DVec3* in,DVec3 origin,Vec3* out,usize n);
+void vec3_to_dvec3_relative_batch(const Vec3* in,DVec3 origin,DVec3* out,usize n);
+void dvec3_add_batch(const DVec3* a,const DVec3* b,DVec3* out,usize n);
+void dvec3_sub_batch(const DVec3* a,const DVec3* b,DVec3* out,usize n);
+void dvec3_dot_batch(const DVec3* a,const DVec3* b,f64* out,usize n);
+void dvec3_cross_batch(const DVec3* a,const DVec3* b,DVec3* out,usize n);
+void dvec3_len_batch(const DVec3* in,f64* out,usize n);
+void dvec3_distance_squared_batch(const DVec3* a,const DVec3* b,f64* out,usize n);
+void dvec3_normalize_or_zero_batch(const DVec3* in,DVec3* out,usize n);
+void dvec3_to_vec3_relative_batch_parallel(const DVec3* in,DVec3 origin,Vec3* out,usize n);
+void vec3_to_dvec3_relative_batch_parallel(const Vec3* in,DVec3 origin,DVec3* out,usize n);
+void dvec3_add_batch_parallel(const DVec3* a,const DVec3* b,DVec3* out,usize n);
+void dvec3_sub_batch_parallel(const DVec3* a,const DVec3* b,DVec3* out,usize n);
+void dvec3_dot_batch_parallel(const DVec3* a,const DVec3* b,f64* out,usize n);
+void dvec3_cross_batch_parallel(const DVec3* a,const DVec3* b,DVec3* out,usize n);
+void dvec3_len_batch_parallel(const DVec3* in,f64* out,usize n);
+void dvec3_distance_squared_batch_parallel(const DVec3* a,const DVec3* b,f64* out,usize n);
+void dvec3_normalize_or_zero_batch_parallel(const DVec3* in,DVec3* out,usize n);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,154 @@
+#include <math.h>
+#include "math_impl.h"
+
+
+static inline_always
+const f64 _f64_abs_private(f64 self) {
+  // SAFETY: This transmutation is fine. Probably. For the reasons rust-std is using it.
+  // Goes through a union rather than a pointer cast so it stays well-defined once inlined.
+  union { f64 f; u64 u; } x={ .f=self };
+  x.u&=0x7fffffffffffffff;
+  return x.f;
+}
+
+
+inline_always
+const f64 f64_abs(f64 self) {
+  return fabs(self);
+}
+
+inline_always
+const f64 f64_signum(f64 self) {
+  return f64_is_nan(self)?F64_NAN:f64_copysign(1.0,self);
+}
+
+inline_always
+const bool f64_is_nan(f64 self) {
+  return self!=self;
+}
+
+inline_always
+const f64 f64_copysign(f64 self,f64 sign) {
+  return copysign(self,sign);
+}
+
+inline_always
+const bool f64_is_sign_negative(f64 self) {
+  // IEEE754 says: isSignMinus(x) is true if and only if x has negative sign. isSignMinus
+  // applies to zeros and NaNs as well.
+  // SAFETY: This is just transmuting to get the sign bit, it's fine.
+  return (f64_to_bits(self) & 0x8000000000000000)!=0;
+}
+
+inline_always
+const bool f64_is_finite(f64 self) {
+  return _f64_abs_private(self)<F64_INFINITY;
+}
+
+inline_always
+const f64 f64_sqrt(f64 self) {
+  return sqrt(self);
+}
+
+inline_always
+const f64 f64_rem(f64 self,f64 x) {
+  return fmod(self,x);
+}
+
+inline_always
+const f64 f64_div_euclid(f64 self,f64 x) {
+  f64 q=f64_trunc(self/x);
+  if(f64_rem(self,x)<0.0) {
+    return x>0.0?q-1.0:q+1.0;
+  }
+
+  return q;
+}
+
+inline_always
+const f64 f64_trunc(f64 self) {
+  return trunc(self);
+}
+
+inline_always
+const f64 f64_rem_euclid(f64 self,f64 rhs) {
+  f64 r=f64_rem(self,rhs);
+  return r<0.0?r+f64_abs(rhs):r;
+}
+
+inline_always
+const f64 f64_neg(f64 self) {
+  return -self;
+}
+
+inline_always
+const bool f64_eq(f64 self,f64 rhs) {
+  return self==rhs;
+}
+
+inline_always
+const bool f64_ne(f64 self,f64 rhs) {
+  return !f64_eq(self,rhs);
+}
+
+inline_always
+const bool f64_ge(f64 self,f64 rhs) {
+  return self>=rhs;
+}
+
+inline_always
+const bool f64_gt(f64 self,f64 rhs) {
+  return self>rhs;
+}
+
+inline_always
+const bool f64_le(f64 self,f64 rhs) {
+  return self<=rhs;
+}
+
+inline_always
+const bool f64_lt(f64 self,f64 rhs) {
+  return self<rhs;
+}
+
+inline_always
+const f64 f64_round(f64 self) {
+  return round(self);
+}
+
+inline_always
+const f64 f64_floor(f64 self) {
+  return floor(self);
+}
+
+inline_always
+const f64 f64_ceil(f64 self) {
+  return ceil(self);
+}
+
+inline_always
+const f64 f64_exp(f64 self) {
+  return exp(self);
+}
+
+inline_always
+const f64 f64_pow(f64 self,f64 x) {
+  return pow(self,x);
+}
+
+inline_always
+const f64 f64_mul_add(f64 a,f64 b,f64 c) {
+  return fma(a,b,c);
+}
+
+inline_always
+const u64 f64_to_bits(f64 self) {
+  union { f64 f; u64 u; } x={ .f=self };
+  return x.u;
+}
+
+inline_always
+const f64 f64_from_bits(u64 bits) {
+  union { u64 u; f64 f; } x={ .u=bits };
+  return x.f;
+}
@@ -0,0 +1,49 @@
+#ifndef CMETH_F64_MATH_IMPL_H
+#define CMETH_F64_MATH_IMPL_H
+
+#include <math.h>
+#include "../prelude.h"
+#include "../../include/cprimitives/src/consts/f64.h"
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const f64 f64_abs(f64 self);
+CMETH_API const f64 f64_signum(f64 self);
+CMETH_API const bool f64_is_nan(f64 self);
+CMETH_API const f64 f64_copysign(f64 self,f64 sign);
+CMETH_API const bool f64_is_sign_negative(f64 self);
+CMETH_API const bool f64_is_finite(f64 self);
+CMETH_API const f64 f64_sqrt(f64 self);
+CMETH_API const f64 f64_div_euclid(f64 self,f64 x);
+CMETH_API const f64 f64_trunc(f64 self);
+CMETH_API const f64 f64_rem(f64 self,f64 x);
+CMETH_API const f64 f64_rem_euclid(f64 self,f64 rhs);
+CMETH_API const f64 f64_neg(f64 self);
+CMETH_API const bool f64_eq(f64 self,f64 rhs);
+CMETH_API const bool f64_ne(f64 self,f64 rhs);
+CMETH_API const bool f64_ge(f64 self,f64 rhs);
+CMETH_API const bool f64_gt(f64 self,f64 rhs);
+CMETH_API const bool f64_le(f64 self,f64 rhs);
+CMETH_API const bool f64_lt(f64 self,f64 rhs);
+CMETH_API const f64 f64_round(f64 self);
+CMETH_API const f64 f64_floor(f64 self);
+CMETH_API const f64 f64_ceil(f64 self);
+CMETH_API const f64 f64_exp(f64 self);
+CMETH_API const f64 f64_pow(f64 self,f64 x);
+CMETH_API const f64 f64_mul_add(f64 a,f64 b,f64 c);
+CMETH_API const u64 f64_to_bits(f64 self);
+CMETH_API const f64 f64_from_bits(u64 bits);
+
+
+
+#ifdef _cplusplus
+}
+#endif
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "math_impl.c"
+#endif
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef CMETH_F64_H
+#define CMETH_F64_H
+
+#include "dvec3.h"
+
+#endif
\ No newline at end of file
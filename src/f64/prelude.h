@@ -0,0 +1,7 @@
+#ifndef CMETH_F64_PRELUDE_H
+#define CMETH_F64_PRELUDE_H
+
+#include "../prelude.h"
+#include "math_impl.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,601 @@
+#include "ivec3.h"
+#include "../f32/math_impl.h"
+#include "prelude.h"
+
+
+/// `a+b` wrapping on overflow, through `u32` where it is defined.
+static inline_always
+const i32 _ivec3_wrapping_add(i32 a,i32 b) {
+  return (i32)((u32)a+(u32)b);
+}
+
+/// `a-b` wrapping on overflow.
+static inline_always
+const i32 _ivec3_wrapping_sub(i32 a,i32 b) {
+  return (i32)((u32)a-(u32)b);
+}
+
+/// `a*b` wrapping on overflow.
+static inline_always
+const i32 _ivec3_wrapping_mul(i32 a,i32 b) {
+  return (i32)((u32)a*(u32)b);
+}
+
+/// Creates a 3-dimensional vector.
+inline_always
+const IVec3 ivec3(i32 x,i32 y,i32 z) {
+  return ivec3_new(x,y,z);
+}
+
+/// Creates a new vector.
+inline_always
+const IVec3 ivec3_new(i32 x,i32 y,i32 z) {
+  IVec3 vec={
+    .x=x,
+    .y=y,
+    .z=z
+  };
+  return vec;
+}
+
+/// Creates a vector with all elements set to `v`.
+inline
+const IVec3 ivec3_splat(i32 v) {
+  IVec3 vec={
+    .x=v,
+    .y=v,
+    .z=v
+  };
+  return vec;
+}
+
+/// Creates a vector from the elements in `if_true` and `if_false`, selecting which to use
+/// for each element of `self`.
+///
+/// A true element in the mask uses the corresponding element from `if_true`, and false
+/// uses the element from `if_false`. It does not branch.
+inline
+const IVec3 ivec3_select(BVec3 mask,IVec3 if_true,IVec3 if_false) {
+  return uvec3_as_ivec3(uvec3_select(mask,ivec3_as_uvec3(if_true),ivec3_as_uvec3(if_false)));
+}
+
+/// Creates a new vector from an array.
+inline
+const IVec3 ivec3_from_array(i32 a[3]) {
+  IVec3 vec={
+    .x=a[0],
+    .y=a[1],
+    .z=a[2]
+  };
+  return vec;
+}
+
+/// Writes the elements of `self` to the first 3 elements in `slice`.
+inline
+void ivec3_write_to_slice(IVec3 self,i32* slice) {
+  slice[0]=self.x;
+  slice[1]=self.y;
+  slice[2]=self.z;
+}
+
+/// Creates a 3D vector from `self` with the given value of `x`.
+inline
+const IVec3 ivec3_with_x(IVec3 self,i32 x) {
+  self.x=x;
+  return self;
+}
+
+/// Creates a 3D vector from `self` with the given value of `y`.
+inline
+const IVec3 ivec3_with_y(IVec3 self,i32 y) {
+  self.y=y;
+  return self;
+}
+
+/// Creates a 3D vector from `self` with the given value of `z`.
+inline
+const IVec3 ivec3_with_z(IVec3 self,i32 z) {
+  self.z=z;
+  return self;
+}
+
+/// Computes the dot product of `self` and `rhs`, wrapping on overflow.
+inline
+const i32 ivec3_dot(IVec3 self,IVec3 rhs) {
+  const i32 xx=_ivec3_wrapping_mul(self.x,rhs.x);
+  const i32 yy=_ivec3_wrapping_mul(self.y,rhs.y);
+  const i32 zz=_ivec3_wrapping_mul(self.z,rhs.z);
+  return _ivec3_wrapping_add(_ivec3_wrapping_add(xx,yy),zz);
+}
+
+/// Computes the cross product of `self` and `rhs`, wrapping on overflow.
+inline
+const IVec3 ivec3_cross(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_wrapping_sub(_ivec3_wrapping_mul(self.y,rhs.z),_ivec3_wrapping_mul(self.z,rhs.y)),
+    .y=_ivec3_wrapping_sub(_ivec3_wrapping_mul(self.z,rhs.x),_ivec3_wrapping_mul(self.x,rhs.z)),
+    .z=_ivec3_wrapping_sub(_ivec3_wrapping_mul(self.x,rhs.y),_ivec3_wrapping_mul(self.y,rhs.x))
+  };
+  return vec;
+}
+
+/// Returns a vector containing the minimum values for each element of `self` and `rhs`.
+inline
+const IVec3 ivec3_min(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=self.x<rhs.x? self.x : rhs.x,
+    .y=self.y<rhs.y? self.y : rhs.y,
+    .z=self.z<rhs.z? self.z : rhs.z
+  };
+  return vec;
+}
+
+/// Returns a vector containing the maximum values for each element of `self` and `rhs`.
+inline
+const IVec3 ivec3_max(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=self.x>rhs.x? self.x : rhs.x,
+    .y=self.y>rhs.y? self.y : rhs.y,
+    .z=self.z>rhs.z? self.z : rhs.z
+  };
+  return vec;
+}
+
+/// Component-wise clamping of values.
+///
+/// Each element in `min` must be less-or-equal to the corresponding element in `max`.
+///
+/// # Panics
+///
+/// Will panic if `min` is greater than `max` when `cmeth_assert` is enabled.
+inline
+const IVec3 ivec3_clamp(IVec3 self,IVec3 min,IVec3 max) {
+  cmeth_assert(bvec3_all(ivec3_cmple(min,max)));
+  return ivec3_min(ivec3_max(self,min),max);
+}
+
+/// Returns the horizontal minimum of `self`.
+inline
+const i32 ivec3_min_element(IVec3 self) {
+  const i32 yz=self.y<self.z? self.y : self.z;
+  return self.x<yz? self.x : yz;
+}
+
+/// Returns the horizontal maximum of `self`.
+inline
+const i32 ivec3_max_element(IVec3 self) {
+  const i32 yz=self.y>self.z? self.y : self.z;
+  return self.x>yz? self.x : yz;
+}
+
+/// Returns the sum of all elements of `self`, wrapping on overflow.
+inline
+const i32 ivec3_element_sum(IVec3 self) {
+  return _ivec3_wrapping_add(_ivec3_wrapping_add(self.x,self.y),self.z);
+}
+
+/// Returns the product of all elements of `self`, wrapping on overflow.
+inline
+const i32 ivec3_element_product(IVec3 self) {
+  return _ivec3_wrapping_mul(_ivec3_wrapping_mul(self.x,self.y),self.z);
+}
+
+/// Returns a vector mask containing the result of a `==` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 ivec3_cmpeq(IVec3 self,IVec3 rhs) {
+  return bvec3_new(self.x==rhs.x,self.y==rhs.y,self.z==rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `!=` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 ivec3_cmpne(IVec3 self,IVec3 rhs) {
+  return bvec3_new(self.x!=rhs.x,self.y!=rhs.y,self.z!=rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `>=` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 ivec3_cmpge(IVec3 self,IVec3 rhs) {
+  return bvec3_new(self.x>=rhs.x,self.y>=rhs.y,self.z>=rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `>` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 ivec3_cmpgt(IVec3 self,IVec3 rhs) {
+  return bvec3_new(self.x>rhs.x,self.y>rhs.y,self.z>rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `<=` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 ivec3_cmple(IVec3 self,IVec3 rhs) {
+  return bvec3_new(self.x<=rhs.x,self.y<=rhs.y,self.z<=rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `<` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 ivec3_cmplt(IVec3 self,IVec3 rhs) {
+  return bvec3_new(self.x<rhs.x,self.y<rhs.y,self.z<rhs.z);
+}
+
+/// Returns `true` if all elements of `self` and `rhs` are equal.
+inline
+const bool ivec3_eq(IVec3 self,IVec3 rhs) {
+  return self.x==rhs.x && self.y==rhs.y && self.z==rhs.z;
+}
+
+/// Hashes `self` to 64 well-mixed bits, as `uvec3_hash` hashes the same bits.
+inline
+const u64 ivec3_hash(IVec3 self) {
+  return uvec3_hash(ivec3_as_uvec3(self));
+}
+
+/// Returns a vector containing the absolute value of each element of `self`.
+///
+/// `INT32_MIN` has no positive counterpart and stays `INT32_MIN`.
+inline
+const IVec3 ivec3_abs(IVec3 self) {
+  IVec3 vec={
+    .x=self.x<0? (i32)(0u-(u32)self.x) : self.x,
+    .y=self.y<0? (i32)(0u-(u32)self.y) : self.y,
+    .z=self.z<0? (i32)(0u-(u32)self.z) : self.z
+  };
+
+  return vec;
+}
+
+/// Returns a vector with elements representing the sign of `self`.
+///
+/// - `0` if the number is zero
+/// - `1` if the number is positive
+/// - `-1` if the number is negative
+inline
+const IVec3 ivec3_signum(IVec3 self) {
+  IVec3 vec={
+    .x=(self.x>0)-(self.x<0),
+    .y=(self.y>0)-(self.y<0),
+    .z=(self.z>0)-(self.z<0)
+  };
+
+  return vec;
+}
+
+/// Returns a bitmask with the lowest 3 bits set to the sign bits from the elements of `self`.
+///
+/// A negative element results in a `1` bit and a positive element in a `0` bit.  Element `x` goes
+/// into the first lowest bit, element `y` into the second, etc.
+inline
+const u32 ivec3_is_negative_bitmask(IVec3 self) {
+  return ((u32)self.x>>31) | ((u32)self.y>>31)<<1 | ((u32)self.z>>31)<<2;
+}
+
+/// Computes the squared length of `self`, wrapping on overflow.
+inline
+const i32 ivec3_len_squared(IVec3 self) {
+  return ivec3_dot(self,self);
+}
+
+/// Compute the squared euclidean distance between two points in space, wrapping on
+/// overflow.
+inline
+const i32 ivec3_distance_squared(IVec3 self,IVec3 rhs) {
+  return ivec3_len_squared(ivec3_sub(self,rhs));
+}
+
+/// `a/b` with the checks of `ivec3_div`.
+static inline_always
+const i32 _ivec3_div_element(i32 a,i32 b) {
+  cmeth_assert(b!=0 && !(a==INT32_MIN && b==-1));
+  return a/b;
+}
+
+/// `a%b` with the checks of `ivec3_div`.
+static inline_always
+const i32 _ivec3_rem_element(i32 a,i32 b) {
+  cmeth_assert(b!=0 && !(a==INT32_MIN && b==-1));
+  return a%b;
+}
+
+static inline_always
+const i32 _ivec3_div_euclid(i32 a,i32 b) {
+  const i32 q=_ivec3_div_element(a,b);
+  if(a%b<0) {
+    return b>0? q-1 : q+1;
+  }
+  return q;
+}
+
+static inline_always
+const i32 _ivec3_rem_euclid(i32 a,i32 b) {
+  const i32 r=_ivec3_rem_element(a,b);
+  // Wraps like Rust's `wrapping_abs`, so `b==INT32_MIN` is well defined.
+  return r<0? (i32)((u32)r+(b<0? 0u-(u32)b : (u32)b)) : r;
+}
+
+/// Returns the element-wise quotient of [Euclidean division] of `self` by `rhs`.
+///
+/// # Panics
+///
+/// Will panic if any element of `rhs` is zero, or divides `INT32_MIN` by `-1`, when
+/// `cmeth_assert` is enabled.
+inline
+const IVec3 ivec3_div_euclid(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_div_euclid(self.x,rhs.x),
+    .y=_ivec3_div_euclid(self.y,rhs.y),
+    .z=_ivec3_div_euclid(self.z,rhs.z)
+  };
+
+  return vec;
+}
+
+/// Returns the element-wise remainder of [Euclidean division] of `self` by `rhs`, which
+/// is never negative.
+///
+/// # Panics
+///
+/// Will panic if any element of `rhs` is zero, or divides `INT32_MIN` by `-1`, when
+/// `cmeth_assert` is enabled.
+inline
+const IVec3 ivec3_rem_euclid(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_rem_euclid(self.x,rhs.x),
+    .y=_ivec3_rem_euclid(self.y,rhs.y),
+    .z=_ivec3_rem_euclid(self.z,rhs.z)
+  };
+
+  return vec;
+}
+
+static inline_always
+const i32 _ivec3_saturate_i64(i64 v) {
+  return v>INT32_MAX? INT32_MAX : v<INT32_MIN? INT32_MIN : (i32)v;
+}
+
+/// Returns the element-wise sum of `self` and `rhs`, saturating at `INT32_MIN` and
+/// `INT32_MAX`.
+inline
+const IVec3 ivec3_saturating_add(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_saturate_i64((i64)self.x+rhs.x),
+    .y=_ivec3_saturate_i64((i64)self.y+rhs.y),
+    .z=_ivec3_saturate_i64((i64)self.z+rhs.z)
+  };
+  return vec;
+}
+
+/// Returns the element-wise difference of `self` and `rhs`, saturating at `INT32_MIN` and
+/// `INT32_MAX`.
+inline
+const IVec3 ivec3_saturating_sub(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_saturate_i64((i64)self.x-rhs.x),
+    .y=_ivec3_saturate_i64((i64)self.y-rhs.y),
+    .z=_ivec3_saturate_i64((i64)self.z-rhs.z)
+  };
+  return vec;
+}
+
+/// Converts `self` to a `Vec3`, rounding elements beyond `2^24` in magnitude to the
+/// nearest `f32`.
+inline
+const Vec3 ivec3_as_vec3(IVec3 self) {
+  return vec3_new((f32)self.x,(f32)self.y,(f32)self.z);
+}
+
+/// Reinterprets the elements of `self` as unsigned, so `-1` becomes `UINT32_MAX`.
+inline
+const UVec3 ivec3_as_uvec3(IVec3 self) {
+  return uvec3_new((u32)self.x,(u32)self.y,(u32)self.z);
+}
+
+/// Reinterprets the elements of `self` as signed, so `UINT32_MAX` becomes `-1`.
+inline
+const IVec3 uvec3_as_ivec3(UVec3 self) {
+  return ivec3_new((i32)self.x,(i32)self.y,(i32)self.z);
+}
+
+/// The integer part of `v`, saturated to `[INT32_MIN,INT32_MAX]`. `NaN` is `0`.
+static inline_always
+const i32 _ivec3_saturate(f32 v) {
+  if(v>=0x1p31F) {
+    return INT32_MAX;
+  }
+  return v>=-0x1p31F? (i32)v : v<0.0F? INT32_MIN : 0;
+}
+
+/// Converts `v` to an `IVec3`, truncating each element towards zero.
+///
+/// Elements beyond the `i32` range saturate to `INT32_MIN` or `INT32_MAX` and `NaN`
+/// becomes `0`, rather than the undefined behaviour of an `(i32)` cast.
+inline
+const IVec3 vec3_as_ivec3(Vec3 v) {
+  return ivec3_new(_ivec3_saturate(v.x),_ivec3_saturate(v.y),_ivec3_saturate(v.z));
+}
+
+/// Converts `v` to an `IVec3` of the largest integers less than or equal to each element,
+/// the cell coordinates of `v` in a grid of unit cells. Saturates as `vec3_as_ivec3` does.
+inline
+const IVec3 vec3_floor_as_ivec3(Vec3 v) {
+  return vec3_as_ivec3(vec3_floor(v));
+}
+
+/// Converts `v` to an `IVec3` of the nearest integers to each element, with half-way
+/// cases rounded away from zero as `vec3_round` does. Saturates as `vec3_as_ivec3` does.
+inline
+const IVec3 vec3_round_as_ivec3(Vec3 v) {
+  return vec3_as_ivec3(vec3_round(v));
+}
+
+/// Returns a vector with all elements set to `0`.
+inline_always
+const IVec3 ivec3_default() {
+  return IVEC3_ZERO;
+}
+
+/// Returns the element-wise quotient of `self` and `rhs`, rounded towards zero.
+///
+/// # Panics
+///
+/// Will panic if any element of `rhs` is zero, or divides `INT32_MIN` by `-1`, when
+/// `cmeth_assert` is enabled.
+inline
+const IVec3 ivec3_div(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_div_element(self.x,rhs.x),
+    .y=_ivec3_div_element(self.y,rhs.y),
+    .z=_ivec3_div_element(self.z,rhs.z)
+  };
+  return vec;
+}
+
+inline
+void ivec3_div_assign(IVec3* self,IVec3 rhs) {
+  *self=ivec3_div(*self,rhs);
+}
+
+/// Returns `self` with every element divided by `rhs`.
+inline
+const IVec3 ivec3_div_i32(IVec3 self,i32 rhs) {
+  return ivec3_div(self,ivec3_splat(rhs));
+}
+
+inline
+void ivec3_div_assign_i32(IVec3* self,i32 rhs) {
+  *self=ivec3_div_i32(*self,rhs);
+}
+
+/// Returns the element-wise product of `self` and `rhs`, wrapping on overflow.
+inline
+const IVec3 ivec3_mul(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_wrapping_mul(self.x,rhs.x),
+    .y=_ivec3_wrapping_mul(self.y,rhs.y),
+    .z=_ivec3_wrapping_mul(self.z,rhs.z)
+  };
+  return vec;
+}
+
+inline
+void ivec3_mul_assign(IVec3* self,IVec3 rhs) {
+  *self=ivec3_mul(*self,rhs);
+}
+
+/// Returns `self` with every element multiplied by `rhs`, wrapping on overflow.
+inline
+const IVec3 ivec3_mul_i32(IVec3 self,i32 rhs) {
+  return ivec3_mul(self,ivec3_splat(rhs));
+}
+
+inline
+void ivec3_mul_assign_i32(IVec3* self,i32 rhs) {
+  *self=ivec3_mul_i32(*self,rhs);
+}
+
+/// Returns the element-wise sum of `self` and `rhs`, wrapping on overflow.
+inline
+const IVec3 ivec3_add(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_wrapping_add(self.x,rhs.x),
+    .y=_ivec3_wrapping_add(self.y,rhs.y),
+    .z=_ivec3_wrapping_add(self.z,rhs.z)
+  };
+  return vec;
+}
+
+inline
+void ivec3_add_assign(IVec3* self,IVec3 rhs) {
+  *self=ivec3_add(*self,rhs);
+}
+
+/// Returns `self` with `rhs` added to every element, wrapping on overflow.
+inline
+const IVec3 ivec3_add_i32(IVec3 self,i32 rhs) {
+  return ivec3_add(self,ivec3_splat(rhs));
+}
+
+inline
+void ivec3_add_assign_i32(IVec3* self,i32 rhs) {
+  *self=ivec3_add_i32(*self,rhs);
+}
+
+/// Returns the element-wise difference of `self` and `rhs`, wrapping on overflow.
+inline
+const IVec3 ivec3_sub(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_wrapping_sub(self.x,rhs.x),
+    .y=_ivec3_wrapping_sub(self.y,rhs.y),
+    .z=_ivec3_wrapping_sub(self.z,rhs.z)
+  };
+  return vec;
+}
+
+inline
+void ivec3_sub_assign(IVec3* self,IVec3 rhs) {
+  *self=ivec3_sub(*self,rhs);
+}
+
+/// Returns `self` with `rhs` subtracted from every element, wrapping on overflow.
+inline
+const IVec3 ivec3_sub_i32(IVec3 self,i32 rhs) {
+  return ivec3_sub(self,ivec3_splat(rhs));
+}
+
+inline
+void ivec3_sub_assign_i32(IVec3* self,i32 rhs) {
+  *self=ivec3_sub_i32(*self,rhs);
+}
+
+/// Returns the element-wise remainder of `self` and `rhs`, with the sign of `self`.
+///
+/// # Panics
+///
+/// Will panic if any element of `rhs` is zero, or divides `INT32_MIN` by `-1`, when
+/// `cmeth_assert` is enabled.
+inline
+const IVec3 ivec3_rem(IVec3 self,IVec3 rhs) {
+  IVec3 vec={
+    .x=_ivec3_rem_element(self.x,rhs.x),
+    .y=_ivec3_rem_element(self.y,rhs.y),
+    .z=_ivec3_rem_element(self.z,rhs.z)
+  };
+  return vec;
+}
+
+inline
+void ivec3_rem_assign(IVec3* self,IVec3 rhs) {
+  *self=ivec3_rem(*self,rhs);
+}
+
+inline
+const IVec3 ivec3_rem_i32(IVec3 self,i32 rhs) {
+  return ivec3_rem(self,ivec3_splat(rhs));
+}
+
+inline
+void ivec3_rem_assign_i32(IVec3* self,i32 rhs) {
+  *self=ivec3_rem_i32(*self,rhs);
+}
+
+/// Returns the element-wise negation of `self`, wrapping `INT32_MIN` to itself.
+inline
+const IVec3 ivec3_neg(IVec3 self) {
+  return ivec3_sub(IVEC3_ZERO,self);
+}
+
+/// Returns a pointer to the element at `index`.
+///
+/// Panics if `index` is greater than 2.
+inline
+const i32* ivec3_index(IVec3* self,usize index) {
+  switch(index) {
+    case 0: return &self->x;
+    case 1: return &self->y;
+    case 2: return &self->z;
+    default: panic("index out of bounds")
+  }
+}
@@ -0,0 +1,128 @@
+#ifndef CMETH_I32_IVEC3_H
+#define CMETH_I32_IVEC3_H
+#include "../prelude.h"
+#include "../bool/bvec3.h"
+#include "../f32/vec3.h"
+#include "../u32/uvec3.h"
+
+
+typedef struct {
+  i32 x;
+  i32 y;
+  i32 z;
+} IVec3;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const IVec3 ivec3(i32 x,i32 y,i32 z);
+CMETH_API const IVec3 ivec3_new(i32 x,i32 y,i32 z);
+CMETH_API const IVec3 ivec3_splat(i32 v);
+CMETH_API const IVec3 ivec3_select(BVec3 mask,IVec3 if_true,IVec3 if_false);
+CMETH_API const IVec3 ivec3_from_array(i32 a[3]);
+CMETH_API void ivec3_write_to_slice(IVec3 self,i32* slice);
+CMETH_API const IVec3 ivec3_with_x(IVec3 self,i32 x);
+CMETH_API const IVec3 ivec3_with_y(IVec3 self,i32 y);
+CMETH_API const IVec3 ivec3_with_z(IVec3 self,i32 z);
+CMETH_API const i32 ivec3_dot(IVec3 self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_cross(IVec3 self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_min(IVec3 self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_max(IVec3 self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_clamp(IVec3 self,IVec3 min,IVec3 max);
+CMETH_API const i32 ivec3_min_element(IVec3 self);
+CMETH_API const i32 ivec3_max_element(IVec3 self);
+CMETH_API const i32 ivec3_element_sum(IVec3 self);
+CMETH_API const i32 ivec3_element_product(IVec3 self);
+CMETH_API const BVec3 ivec3_cmpeq(IVec3 self,IVec3 rhs);
+CMETH_API const BVec3 ivec3_cmpne(IVec3 self,IVec3 rhs);
+CMETH_API const BVec3 ivec3_cmpge(IVec3 self,IVec3 rhs);
+CMETH_API const BVec3 ivec3_cmpgt(IVec3 self,IVec3 rhs);
+CMETH_API const BVec3 ivec3_cmple(IVec3 self,IVec3 rhs);
+CMETH_API const BVec3 ivec3_cmplt(IVec3 self,IVec3 rhs);
+CMETH_API const bool ivec3_eq(IVec3 self,IVec3 rhs);
+CMETH_API const u64 ivec3_hash(IVec3 self);
+CMETH_API const IVec3 ivec3_abs(IVec3 self);
+CMETH_API const IVec3 ivec3_signum(IVec3 self);
+CMETH_API const u32 ivec3_is_negative_bitmask(IVec3 self);
+CMETH_API const i32 ivec3_len_squared(IVec3 self);
+CMETH_API const i32 ivec3_distance_squared(IVec3 self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_div_euclid(IVec3 self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_rem_euclid(IVec3 self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_saturating_add(IVec3 self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_saturating_sub(IVec3 self,IVec3 rhs);
+CMETH_API const Vec3 ivec3_as_vec3(IVec3 self);
+CMETH_API const UVec3 ivec3_as_uvec3(IVec3 self);
+CMETH_API const IVec3 uvec3_as_ivec3(UVec3 self);
+CMETH_API const IVec3 vec3_as_ivec3(Vec3 v);
+CMETH_API const IVec3 vec3_floor_as_ivec3(Vec3 v);
+CMETH_API const IVec3 vec3_round_as_ivec3(Vec3 v);
+CMETH_API const IVec3 ivec3_default();
+CMETH_API const IVec3 ivec3_div(IVec3 self,IVec3 rhs);
+CMETH_API void ivec3_div_assign(IVec3* self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_div_i32(IVec3 self,i32 rhs);
+CMETH_API void ivec3_div_assign_i32(IVec3* self,i32 rhs);
+CMETH_API const IVec3 ivec3_mul(IVec3 self,IVec3 rhs);
+CMETH_API void ivec3_mul_assign(IVec3* self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_mul_i32(IVec3 self,i32 rhs);
+CMETH_API void ivec3_mul_assign_i32(IVec3* self,i32 rhs);
+CMETH_API const IVec3 ivec3_add(IVec3 self,IVec3 rhs);
+CMETH_API void ivec3_add_assign(IVec3* self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_add_i32(IVec3 self,i32 rhs);
+CMETH_API void ivec3_add_assign_i32(IVec3* self,i32 rhs);
+CMETH_API const IVec3 ivec3_sub(IVec3 self,IVec3 rhs);
+CMETH_API void ivec3_sub_assign(IVec3* self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_sub_i32(IVec3 self,i32 rhs);
+CMETH_API void ivec3_sub_assign_i32(IVec3* self,i32 rhs);
+CMETH_API const IVec3 ivec3_rem(IVec3 self,IVec3 rhs);
+CMETH_API void ivec3_rem_assign(IVec3* self,IVec3 rhs);
+CMETH_API const IVec3 ivec3_rem_i32(IVec3 self,i32 rhs);
+CMETH_API void ivec3_rem_assign_i32(IVec3* self,i32 rhs);
+CMETH_API const IVec3 ivec3_neg(IVec3 self);
+CMETH_API const i32* ivec3_index(IVec3* self,usize index);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// All zeroes.
+#define IVEC3_ZERO ivec3_splat(0)
+
+/// All ones.
+#define IVEC3_ONE ivec3_splat(1)
+
+/// All negative ones.
+#define IVEC3_NEG_ONE ivec3_splat(-1)
+
+/// All `INT32_MIN`.
+#define IVEC3_MIN ivec3_splat(INT32_MIN)
+
+/// All `INT32_MAX`.
+#define IVEC3_MAX ivec3_splat(INT32_MAX)
+
+/// A unit vector pointing along the positive X axis.
+#define IVEC3_X ivec3_new(1,0,0)
+
+/// A unit vector pointing along the positive Y axis.
+#define IVEC3_Y ivec3_new(0,1,0)
+
+/// A unit vector pointing along the positive Z axis.
+#define IVEC3_Z ivec3_new(0,0,1)
+
+/// A unit vector pointing along the negative X axis.
+#define IVEC3_NEG_X ivec3_new(-1,0,0)
+
+/// A unit vector pointing along the negative Y axis.
+#define IVEC3_NEG_Y ivec3_new(0,-1,0)
+
+/// A unit vector pointing along the negative Z axis.
+#define IVEC3_NEG_Z ivec3_new(0,0,-1)
+
+/// The unit axes.
+#define IVEC3_AXES {IVEC3_X,IVEC3_Y,IVEC3_Z}
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "ivec3.c"
+#endif
+
+#endif
@@ -0,0 +1,212 @@
+#include <immintrin.h>
+#include "ivec3_batch.h"
+#include "../f32/math_impl.h"
+#include "../cpu/features.h"
+#include "../thread/pool.h"
+
+// Every kernel has one lane-generic body in `ivec3_batch_lanes.h`, built on GCC vector
+// extensions and instantiated three times: 4 lanes for the x86-64 baseline (SSE2), 8 for
+// AVX2 and 16 for AVX-512, bound once at load time from `cmeth_cpu_tier()` like the
+// `f32_*_batch` kernels. `Vec3` and `IVec3` arrays are converted as flat arrays of `3*n`
+// elements, so they need no transpose.
+//
+// The results equal the value-type conversions bit for bit on every tier, saturation
+// included: the baseline has no `roundps`, so floor and round are a truncation corrected
+// by one, which is exact.
+
+
+#define IVEC3_TRUNC 0
+#define IVEC3_FLOOR 1
+#define IVEC3_ROUND 2
+
+#define _PASTE(a,b) a##b
+#define _KERNEL(name,suffix) _PASTE(name,suffix)
+
+typedef f32 f32x4 __attribute__((vector_size(16)));
+typedef i32 i32x4 __attribute__((vector_size(16)));
+
+#define LANES 4
+#define F32V f32x4
+#define I32V i32x4
+#define TARGET
+#define SUFFIX _sse2
+#include "ivec3_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x8 __attribute__((vector_size(32)));
+typedef i32 i32x8 __attribute__((vector_size(32)));
+
+#define LANES 8
+#define F32V f32x8
+#define I32V i32x8
+#define TARGET target_avx2
+#define SUFFIX _avx2
+#include "ivec3_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+typedef f32 f32x16 __attribute__((vector_size(64)));
+typedef i32 i32x16 __attribute__((vector_size(64)));
+
+#define LANES 16
+#define F32V f32x16
+#define I32V i32x16
+#define TARGET target_avx512
+#define SUFFIX _avx512
+#include "ivec3_batch_lanes.h"
+#undef LANES
+#undef F32V
+#undef I32V
+#undef TARGET
+#undef SUFFIX
+
+static struct {
+  void (*as_ivec3)(const f32*,i32*,usize);
+  void (*floor_as_ivec3)(const f32*,i32*,usize);
+  void (*round_as_ivec3)(const f32*,i32*,usize);
+  void (*grid_cells)(const f32*,const f32*,f32,i32*,usize);
+  void (*as_vec3)(const i32*,f32*,usize);
+} _kernels={
+  .as_ivec3=_vec3_as_ivec3_sse2,
+  .floor_as_ivec3=_vec3_floor_as_ivec3_sse2,
+  .round_as_ivec3=_vec3_round_as_ivec3_sse2,
+  .grid_cells=_vec3_grid_cells_sse2,
+  .as_vec3=_ivec3_as_vec3_sse2,
+};
+
+__attribute__((constructor))
+static void _ivec3_batch_dispatch() {
+  switch(cmeth_cpu_tier()) {
+    case CMETH_CPU_AVX512:
+      _kernels.as_ivec3=_vec3_as_ivec3_avx512;
+      _kernels.floor_as_ivec3=_vec3_floor_as_ivec3_avx512;
+      _kernels.round_as_ivec3=_vec3_round_as_ivec3_avx512;
+      _kernels.grid_cells=_vec3_grid_cells_avx512;
+      _kernels.as_vec3=_ivec3_as_vec3_avx512;
+    break;
+    case CMETH_CPU_AVX2:
+      _kernels.as_ivec3=_vec3_as_ivec3_avx2;
+      _kernels.floor_as_ivec3=_vec3_floor_as_ivec3_avx2;
+      _kernels.round_as_ivec3=_vec3_round_as_ivec3_avx2;
+      _kernels.grid_cells=_vec3_grid_cells_avx2;
+      _kernels.as_vec3=_ivec3_as_vec3_avx2;
+    break;
+    default: break;
+  }
+}
+
+
+/// Computes `out[i]=vec3_as_ivec3(in[i])` for every `i<n`.
+void vec3_as_ivec3_batch(const Vec3* in,IVec3* out,usize n) {
+  _kernels.as_ivec3((const f32*)in,(i32*)out,n*3);
+}
+
+/// Computes `out[i]=vec3_floor_as_ivec3(in[i])` for every `i<n`.
+void vec3_floor_as_ivec3_batch(const Vec3* in,IVec3* out,usize n) {
+  _kernels.floor_as_ivec3((const f32*)in,(i32*)out,n*3);
+}
+
+/// Computes `out[i]=vec3_round_as_ivec3(in[i])` for every `i<n`.
+void vec3_round_as_ivec3_batch(const Vec3* in,IVec3* out,usize n) {
+  _kernels.round_as_ivec3((const f32*)in,(i32*)out,n*3);
+}
+
+/// Computes the cell of every point of `in` in a grid of cubic cells of side `cell_size`
+/// with a corner at `origin`:
+/// `out[i]=vec3_floor_as_ivec3(vec3_div_f32(vec3_sub(in[i],origin),cell_size))`.
+///
+/// # Panics
+///
+/// Will panic if `cell_size` is not positive and finite when `cmeth_assert` is enabled.
+void vec3_grid_cells_batch(const Vec3* in,Vec3 origin,f32 cell_size,IVec3* out,usize n) {
+  cmeth_assert(cell_size>0.0F && cell_size<F32_INFINITY);
+  const f32 o[3]={origin.x,origin.y,origin.z};
+  _kernels.grid_cells((const f32*)in,o,cell_size,(i32*)out,n*3);
+}
+
+/// Computes `out[i]=ivec3_as_vec3(in[i])` for every `i<n`.
+void ivec3_as_vec3_batch(const IVec3* in,Vec3* out,usize n) {
+  _kernels.as_vec3((const i32*)in,(f32*)out,n*3);
+}
+
+
+/// The arguments of a `_parallel` call. The arrays are offset by the start of every range,
+/// in points, so the origin of `vec3_grid_cells_batch` stays in phase with the flat kernel.
+typedef struct {
+  const void* in;
+  Vec3 origin;
+  f32 cell_size;
+  void* out;
+} _IVec3BatchJob;
+
+static void _vec3_as_ivec3_range(void* ctx,usize begin,usize end) {
+  const _IVec3BatchJob* job=ctx;
+  vec3_as_ivec3_batch((const Vec3*)job->in+begin,(IVec3*)job->out+begin,end-begin);
+}
+
+static void _vec3_floor_as_ivec3_range(void* ctx,usize begin,usize end) {
+  const _IVec3BatchJob* job=ctx;
+  vec3_floor_as_ivec3_batch((const Vec3*)job->in+begin,(IVec3*)job->out+begin,end-begin);
+}
+
+static void _vec3_round_as_ivec3_range(void* ctx,usize begin,usize end) {
+  const _IVec3BatchJob* job=ctx;
+  vec3_round_as_ivec3_batch((const Vec3*)job->in+begin,(IVec3*)job->out+begin,end-begin);
+}
+
+static void _vec3_grid_cells_range(void* ctx,usize begin,usize end) {
+  const _IVec3BatchJob* job=ctx;
+  vec3_grid_cells_batch((const Vec3*)job->in+begin,job->origin,job->cell_size,(IVec3*)job->out+begin,end-begin);
+}
+
+static void _ivec3_as_vec3_range(void* ctx,usize begin,usize end) {
+  const _IVec3BatchJob* job=ctx;
+  ivec3_as_vec3_batch((const IVec3*)job->in+begin,(Vec3*)job->out+begin,end-begin);
+}
+
+/// Works like `vec3_as_ivec3_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void vec3_as_ivec3_batch_parallel(const Vec3* in,IVec3* out,usize n) {
+  _IVec3BatchJob job={.in=in,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_as_ivec3_range,&job);
+}
+
+/// Works like `vec3_floor_as_ivec3_batch`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void vec3_floor_as_ivec3_batch_parallel(const Vec3* in,IVec3* out,usize n) {
+  _IVec3BatchJob job={.in=in,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_floor_as_ivec3_range,&job);
+}
+
+/// Works like `vec3_round_as_ivec3_batch`, on the threads of the `cmeth_parallel_for`
+/// pool. The results are the same bit for bit.
+void vec3_round_as_ivec3_batch_parallel(const Vec3* in,IVec3* out,usize n) {
+  _IVec3BatchJob job={.in=in,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_round_as_ivec3_range,&job);
+}
+
+/// Works like `vec3_grid_cells_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+///
+/// # Panics
+///
+/// Will panic if `cell_size` is not positive and finite when `cmeth_assert` is enabled.
+void vec3_grid_cells_batch_parallel(const Vec3* in,Vec3 origin,f32 cell_size,IVec3* out,usize n) {
+  cmeth_assert(cell_size>0.0F && cell_size<F32_INFINITY);
+  _IVec3BatchJob job={.in=in,.origin=origin,.cell_size=cell_size,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_vec3_grid_cells_range,&job);
+}
+
+/// Works like `ivec3_as_vec3_batch`, on the threads of the `cmeth_parallel_for` pool. The
+/// results are the same bit for bit.
+void ivec3_as_vec3_batch_parallel(const IVec3* in,Vec3* out,usize n) {
+  _IVec3BatchJob job={.in=in,.out=out};
+  cmeth_parallel_for(n,CMETH_PARALLEL_GRAIN,_ivec3_as_vec3_range,&job);
+}
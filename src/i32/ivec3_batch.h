@@ -0,0 +1,25 @@
+#ifndef CMETH_I32_IVEC3_BATCH_H
+#define CMETH_I32_IVEC3_BATCH_H
+#include "../prelude.h"
+#include "../f32/vec3.h"
+#include "ivec3.h"
+
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+void vec3_as_ivec3_batch(const Vec3* in,IVec3* out,usize n);
+void vec3_floor_as_ivec3_batch(const Vec3* in,IVec3* out,usize n);
+void vec3_round_as_ivec3_batch(const Vec3* in,IVec3* out,usize n);
+void vec3_grid_cells_batch(const Vec3* in,Vec3 origin,f32 cell_size,IVec3* out,usize n);
+void ivec3_as_vec3_batch(const IVec3* in,Vec3* out,usize n);
+void vec3_as_ivec3_batch_parallel(const Vec3* in,IVec3* out,usize n);
+void vec3_floor_as_ivec3_batch_parallel(const Vec3* in,IVec3* out,usize n);
+void vec3_round_as_ivec3_batch_parallel(const Vec3* in,IVec3* out,usize n);
+void vec3_grid_cells_batch_parallel(const Vec3* in,Vec3 origin,f32 cell_size,IVec3* out,usize n);
+void ivec3_as_vec3_batch_parallel(const IVec3* in,Vec3* out,usize n);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+// Lane-generic bodies of the `ivec3_batch.c` kernels.
+//
+// Included once per tier by `ivec3_batch.c`, which defines beforehand:
+//
+// - `LANES`: elements per vector.
+// - `F32V`, `I32V`: GCC vector types of `LANES` `f32`/`i32` elements.
+// - `TARGET`: function attributes of the tier (empty for the baseline).
+// - `SUFFIX`: appended to every kernel name.
+
+#define K(name) _KERNEL(name,SUFFIX)
+
+
+static inline_always TARGET
+const F32V K(_load)(const f32* p,usize rem) {
+  F32V v={0};
+  __builtin_memcpy(&v,p,(rem>=LANES? LANES : rem)*sizeof(f32));
+  return v;
+}
+
+static inline_always TARGET
+void K(_store)(i32* p,usize rem,I32V v) {
+  __builtin_memcpy(p,&v,(rem>=LANES? LANES : rem)*sizeof(i32));
+}
+
+/// Converts every lane of `v` as `_ivec3_saturate(f32_floor(v))` (`IVEC3_FLOOR`),
+/// `_ivec3_saturate(f32_round(v))` (`IVEC3_ROUND`) or `_ivec3_saturate(v)`
+/// (`IVEC3_TRUNC`).
+///
+/// Lanes out of the `i32` range and `NaN`s are zeroed before the truncating conversion,
+/// whose result is undefined for them, and blended back in saturated. Floor and round
+/// correct the truncation by one: the difference between a lane and its truncation is
+/// exact, as lanes of `2^23` and up are integers.
+static inline_always TARGET
+const I32V K(_convert)(F32V v,i32 mode) {
+  const I32V above=(I32V)(v>=0x1p31F);
+  const I32V below=(I32V)(v<-0x1p31F);
+  const I32V in_range=(I32V)(v==v) & ~(above | below);
+  const F32V safe=(F32V)((I32V)v & in_range);
+  I32V t=__builtin_convertvector(safe,I32V);
+  if(mode==IVEC3_FLOOR) {
+    t+=(I32V)(__builtin_convertvector(t,F32V)>safe);
+  } else if(mode==IVEC3_ROUND) {
+    const F32V frac=safe-__builtin_convertvector(t,F32V);
+    t-=(I32V)(frac>=0.5F);
+    t+=(I32V)(frac<=-0.5F);
+  }
+  return (t & in_range) | (above & INT32_MAX) | (below & INT32_MIN);
+}
+
+/// Converts the `len` elements of `in` to `out` in the given mode.
+static TARGET
+void K(_ivec3_convert)(const f32* in,i32* out,usize len,i32 mode) {
+  for(usize j=0;j<len;j+=LANES) {
+    K(_store)(out+j,len-j,K(_convert)(K(_load)(in+j,len-j),mode));
+  }
+}
+
+static TARGET
+void K(_vec3_as_ivec3)(const f32* in,i32* out,usize len) {
+  K(_ivec3_convert)(in,out,len,IVEC3_TRUNC);
+}
+
+static TARGET
+void K(_vec3_floor_as_ivec3)(const f32* in,i32* out,usize len) {
+  K(_ivec3_convert)(in,out,len,IVEC3_FLOOR);
+}
+
+static TARGET
+void K(_vec3_round_as_ivec3)(const f32* in,i32* out,usize len) {
+  K(_ivec3_convert)(in,out,len,IVEC3_ROUND);
+}
+
+/// Computes the floor of `(in[j]-origin[j%3])/cell_size` for the `len` elements of `in`.
+/// `LANES` is not a multiple of 3, so three vectors of the origin, each starting one
+/// element further, line up with the three vectors of `LANES` points.
+static TARGET
+void K(_vec3_grid_cells)(const f32* in,const f32* origin,f32 cell_size,i32* out,usize len) {
+  F32V o[3];
+  for(usize k=0;k<3;k++) {
+    for(usize l=0;l<LANES;l++) {
+      o[k][l]=origin[(k*LANES+l)%3];
+    }
+  }
+  for(usize j=0;j<len;j+=3*LANES) {
+    for(usize k=0;k<3;k++) {
+      const usize at=j+k*LANES;
+      if(at>=len) {
+        break;
+      }
+      const usize rem=len-at;
+      K(_store)(out+at,rem,K(_convert)((K(_load)(in+at,rem)-o[k])/cell_size,IVEC3_FLOOR));
+    }
+  }
+}
+
+static TARGET
+void K(_ivec3_as_vec3)(const i32* in,f32* out,usize len) {
+  for(usize j=0;j<len;j+=LANES) {
+    const usize n=(len-j>=LANES? LANES : len-j)*sizeof(f32);
+    I32V v={0};
+    __builtin_memcpy(&v,in+j,n);
+    const F32V f=__builtin_convertvector(v,F32V);
+    __builtin_memcpy(out+j,&f,n);
+  }
+}
+
+#undef K
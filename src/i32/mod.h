@@ -0,0 +1,6 @@
+#ifndef CMETH_I32_H
+#define CMETH_I32_H
+
+#include "ivec3.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include <string.h>
+#include <sys/mman.h>
+#include "alloc.h"
+
+// Small blocks come from `aligned_alloc`. Huge-page blocks are anonymous mappings rounded
+// up to `CMETH_HUGE_PAGE_SIZE`, over-mapped by one huge page and trimmed so they start on a
+// huge-page boundary, then advised with `MADV_HUGEPAGE`. The advice is only a hint: without
+// transparent huge pages the mapping stays on small pages and works the same.
+//
+// An `Arena` chunk starts with a 64-byte header linking it to the previous chunk and
+// recording its size, so blocks stay aligned and the chunks can be walked to free them.
+
+
+typedef struct {
+  void* prev;
+  usize size;
+} _ArenaHeader;
+
+static inline_always
+const usize _alloc_round_up(usize size,usize align) {
+  return (size+align-1)&~(align-1);
+}
+
+static inline_always
+bool _alloc_is_huge(usize size,bool huge_pages) {
+  return huge_pages && size>=CMETH_HUGE_PAGE_SIZE;
+}
+
+
+/// Allocates `size` bytes aligned to `CMETH_ALIGN`, from huge pages when `huge_pages` is
+/// set and the block is at least `CMETH_HUGE_PAGE_SIZE` bytes. Free it with
+/// `cmeth_free_aligned` and the same `size` and `huge_pages`.
+///
+/// # Panics
+///
+/// Will panic if the allocation fails.
+void* cmeth_alloc_aligned(usize size,bool huge_pages) {
+  if(!_alloc_is_huge(size,huge_pages)) {
+    void* ptr=aligned_alloc(CMETH_ALIGN,_alloc_round_up(size>0? size : 1,CMETH_ALIGN));
+    if(ptr==NULL) {
+      panic("cmeth_alloc_aligned: out of memory\n");
+    }
+    return ptr;
+  }
+
+  const usize len=_alloc_round_up(size,CMETH_HUGE_PAGE_SIZE);
+  u8* map=mmap(NULL,len+CMETH_HUGE_PAGE_SIZE,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if(map==MAP_FAILED) {
+    panic("cmeth_alloc_aligned: out of memory\n");
+  }
+  u8* ptr=(u8*)_alloc_round_up((usize)map,CMETH_HUGE_PAGE_SIZE);
+  if(ptr>map) {
+    munmap(map,(usize)(ptr-map));
+  }
+  const usize tail=(usize)(map+len+CMETH_HUGE_PAGE_SIZE-(ptr+len));
+  if(tail>0) {
+    munmap(ptr+len,tail);
+  }
+#ifdef MADV_HUGEPAGE
+  madvise(ptr,len,MADV_HUGEPAGE);
+#endif
+  return ptr;
+}
+
+/// Frees a block from `cmeth_alloc_aligned(size,huge_pages)`. NULL is ignored.
+void cmeth_free_aligned(void* ptr,usize size,bool huge_pages) {
+  if(ptr==NULL) {
+    return;
+  }
+  if(_alloc_is_huge(size,huge_pages)) {
+    munmap(ptr,_alloc_round_up(size,CMETH_HUGE_PAGE_SIZE));
+  } else {
+    free(ptr);
+  }
+}
+
+
+/// Creates an empty arena that maps chunks of `chunk_size` bytes (rounded up to
+/// `CMETH_ALIGN`) as blocks are asked for, from huge pages when `huge_pages` is set.
+const Arena arena_new(usize chunk_size,bool huge_pages) {
+  return (Arena){
+    .chunk=NULL,
+    .used=0,
+    .chunk_size=_alloc_round_up(chunk_size>0? chunk_size : 1,CMETH_ALIGN),
+    .huge_pages=huge_pages
+  };
+}
+
+/// Returns `size` bytes aligned to `CMETH_ALIGN` from `self`, starting a new chunk when
+/// the current one is full. The block lives until `self` is reset or freed.
+///
+/// # Panics
+///
+/// Will panic if the allocation fails.
+void* arena_alloc(Arena* self,usize size) {
+  size=_alloc_round_up(size>0? size : 1,CMETH_ALIGN);
+  if(self->chunk==NULL || self->used+size>((_ArenaHeader*)self->chunk)->size) {
+    const usize need=size+CMETH_ALIGN;
+    const usize chunk_size=need>self->chunk_size? need : self->chunk_size;
+    _ArenaHeader* header=cmeth_alloc_aligned(chunk_size,self->huge_pages);
+    header->prev=self->chunk;
+    header->size=chunk_size;
+    self->chunk=header;
+    self->used=CMETH_ALIGN;
+  }
+  void* ptr=(u8*)self->chunk+self->used;
+  self->used+=size;
+  return ptr;
+}
+
+/// Gives back every block of `self` at once, keeping its newest chunk for the blocks that
+/// follow and freeing the others.
+void arena_reset(Arena* self) {
+  if(self->chunk==NULL) {
+    return;
+  }
+  _ArenaHeader* newest=self->chunk;
+  void* chunk=newest->prev;
+  while(chunk!=NULL) {
+    _ArenaHeader* header=chunk;
+    chunk=header->prev;
+    cmeth_free_aligned(header,header->size,self->huge_pages);
+  }
+  newest->prev=NULL;
+  self->used=CMETH_ALIGN;
+}
+
+/// Frees every chunk of `self` and leaves it empty.
+void arena_free(Arena* self) {
+  void* chunk=self->chunk;
+  while(chunk!=NULL) {
+    _ArenaHeader* header=chunk;
+    chunk=header->prev;
+    cmeth_free_aligned(header,header->size,self->huge_pages);
+  }
+  self->chunk=NULL;
+  self->used=0;
+}
+
+
+/// Creates an empty pool, whose blocks come from huge pages when `huge_pages` is set.
+const SizePool size_pool_new(bool huge_pages) {
+  SizePool pool;
+  memset(pool.free,0,sizeof(pool.free));
+  pool.huge_pages=huge_pages;
+  return pool;
+}
+
+static inline_always
+const usize _size_pool_class(usize size) {
+  usize k=0;
+  while(k+1<SIZE_POOL_CLASSES && ((usize)CMETH_ALIGN<<k)<size) {
+    k++;
+  }
+  return k;
+}
+
+/// Returns the size of the class a block of `size` bytes is served from, which the block
+/// can be grown to for free.
+///
+/// # Panics
+///
+/// Will panic if `size` is above the largest class when `cmeth_assert` is enabled.
+const usize size_pool_class_size(usize size) {
+  cmeth_assert(size<=((usize)CMETH_ALIGN<<(SIZE_POOL_CLASSES-1)));
+  return (usize)CMETH_ALIGN<<_size_pool_class(size);
+}
+
+/// Returns a block of at least `size` bytes aligned to `CMETH_ALIGN`, reusing a freed
+/// block of the same class when there is one.
+///
+/// # Panics
+///
+/// Will panic if the allocation fails, or if `size` is above the largest class when
+/// `cmeth_assert` is enabled.
+void* size_pool_alloc(SizePool* self,usize size) {
+  const usize k=_size_pool_class(size);
+  cmeth_assert(size<=((usize)CMETH_ALIGN<<k));
+  void* block=self->free[k];
+  if(block!=NULL) {
+    self->free[k]=*(void**)block;
+    return block;
+  }
+  return cmeth_alloc_aligned((usize)CMETH_ALIGN<<k,self->huge_pages);
+}
+
+/// Puts a block from `size_pool_alloc(self,size)` on the free list of its class.
+/// NULL is ignored.
+void size_pool_release(SizePool* self,void* ptr,usize size) {
+  if(ptr==NULL) {
+    return;
+  }
+  const usize k=_size_pool_class(size);
+  *(void**)ptr=self->free[k];
+  self->free[k]=ptr;
+}
+
+/// Frees the blocks on the free lists of `self`, which stays usable. Blocks still in use
+/// are not affected.
+void size_pool_free(SizePool* self) {
+  for(usize k=0;k<SIZE_POOL_CLASSES;k++) {
+    void* block=self->free[k];
+    while(block!=NULL) {
+      void* next=*(void**)block;
+      cmeth_free_aligned(block,(usize)CMETH_ALIGN<<k,self->huge_pages);
+      block=next;
+    }
+    self->free[k]=NULL;
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef CMETH_MEM_ALLOC_H
+#define CMETH_MEM_ALLOC_H
+#include "../prelude.h"
+
+
+/// Alignment of every block handed out here: a cache line, and an AVX-512 register.
+#define CMETH_ALIGN 64
+
+/// Blocks of at least this many bytes asked for with `huge_pages` are mapped on their
+/// own, aligned to it and advised to the kernel as transparent huge pages. Smaller ones
+/// come from the heap either way.
+#define CMETH_HUGE_PAGE_SIZE ((usize)2<<20)
+
+/// A bump allocator. Blocks are carved from the front of large chunks and are only given
+/// back all at once, by `arena_reset` or `arena_free`.
+///
+/// Not safe to share between threads without a lock.
+typedef struct {
+  /// The newest chunk, linked to the older ones through its header, or NULL.
+  void* chunk;
+  /// Bytes used in `chunk`, header included.
+  usize used;
+  /// Size of a new chunk, unless a block needs a larger one.
+  usize chunk_size;
+  bool huge_pages;
+} Arena;
+
+/// Size classes of a `SizePool`, `CMETH_ALIGN<<k` bytes for `k<SIZE_POOL_CLASSES`.
+#define SIZE_POOL_CLASSES 32
+
+/// A cache of freed blocks, one free list per power-of-two size class, so buffers that
+/// are dropped and re-made at the same sizes reuse memory instead of fragmenting the heap.
+///
+/// Not safe to share between threads without a lock.
+typedef struct {
+  /// Freed blocks of each class, linked through their first bytes.
+  void* free[SIZE_POOL_CLASSES];
+  bool huge_pages;
+} SizePool;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+void* cmeth_alloc_aligned(usize size,bool huge_pages);
+void cmeth_free_aligned(void* ptr,usize size,bool huge_pages);
+const Arena arena_new(usize chunk_size,bool huge_pages);
+void* arena_alloc(Arena* self,usize size);
+void arena_reset(Arena* self);
+void arena_free(Arena* self);
+const SizePool size_pool_new(bool huge_pages);
+const usize size_pool_class_size(usize size);
+void* size_pool_alloc(SizePool* self,usize size);
+void size_pool_release(SizePool* self,void* ptr,usize size);
+void size_pool_free(SizePool* self);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
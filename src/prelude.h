@@ -9,9 +9,21 @@
 #define inline_always __inline __attribute__ ((__always_inline__))
 #define MIN(X,Y) ((X)<(Y))?(X):(Y)
 #define MAX(X,Y) ((X)>(Y))?(X):(Y)
-#define panic(...) {( fprintf(stderr,__VA_ARGS__);exit(1); )}
+#define panic(...) { fprintf(stderr,__VA_ARGS__);exit(1); }
 #define cmeth_assert(...) assert(__VA_ARGS__)
 
+/// Linkage of the value-type API (`Vec3`, `BVec3`, `f32_*`).
+///
+/// By default every function is an external symbol in `libcmeth.a`. Defining
+/// `CMETH_HEADER_ONLY` before including any cmeth header turns the declarations into
+/// `static inline` ones and pulls the definitions into the including translation unit,
+/// so calls in hot loops can be inlined instead of going through the archive.
+#ifdef CMETH_HEADER_ONLY
+#define CMETH_API static inline
+#else
+#define CMETH_API
+#endif
+
 
 
 #endif
@@ -0,0 +1,348 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "pool.h"
+
+// One process-wide pool of persistent workers runs every `cmeth_parallel_for` job. The
+// workers start on the first job and sleep on a condition variable between jobs.
+//
+// A job cuts `[0,n)` into blocks of `grain` elements, widened so there are about
+// `THREAD_POOL_BLOCKS_PER_THREAD` blocks per thread, and hands every thread a contiguous
+// run of blocks in its own slot. A thread takes blocks from the front of its slot and,
+// once it is empty, steals the back half of the first non-empty slot after its own, so
+// uneven blocks even out while neighbouring blocks mostly stay on one thread. Every slot
+// sits on its own cache line behind a spinlock held for a few instructions.
+//
+// Jobs don't nest: a `cmeth_parallel_for` from inside a job, or from another thread while
+// one is running, runs its whole range on the calling thread. So parallel kernels can call
+// each other without ever running more threads than the pool has.
+
+
+/// Blocks per thread the grain is widened to, so stealing has something to even out.
+#define THREAD_POOL_BLOCKS_PER_THREAD 8
+
+
+/// A run of blocks `[begin,end)` owned by one thread.
+typedef struct {
+  u32 lock;
+  usize begin;
+  usize end;
+} __attribute__((aligned(64))) _ThreadPoolSlot;
+
+typedef struct {
+  ParallelForFn fn;
+  void* ctx;
+  usize n;
+  usize grain;
+  /// Threads taking part, the caller as thread 0. The other workers sit the job out.
+  usize threads;
+} _ThreadPoolJob;
+
+static struct {
+  pthread_mutex_t lock;
+  /// Signalled when a job is published or the workers are stopped.
+  pthread_cond_t wake;
+  /// Signalled when the last worker leaves a job.
+  pthread_cond_t idle;
+  ThreadPoolOptions options;
+  /// Threads the running workers make with the caller, or 0 before they are started.
+  usize threads;
+  pthread_t workers[THREAD_POOL_MAX_THREADS];
+  u64 generation;
+  /// `generation` when the workers were started, before their first job.
+  u64 started_at;
+  usize finished;
+  bool busy;
+  bool stop;
+  _ThreadPoolJob job;
+  _ThreadPoolSlot slots[THREAD_POOL_MAX_THREADS];
+} _pool={
+  .lock=PTHREAD_MUTEX_INITIALIZER,
+  .wake=PTHREAD_COND_INITIALIZER,
+  .idle=PTHREAD_COND_INITIALIZER,
+  .options={.threads=0,.pin=false}
+};
+
+/// Set on the workers, and on a caller while it runs its share of a job.
+static __thread bool _inside_job=false;
+
+
+static
+const usize _thread_pool_resolve(ThreadPoolOptions options) {
+  usize threads=options.threads;
+  if(threads==0) {
+    const char* value=getenv(CMETH_THREADS_ENV);
+    if(value!=NULL && *value!='\0') {
+      threads=(usize)strtoul(value,NULL,10);
+    }
+  }
+  if(threads==0) {
+    const long online=sysconf(_SC_NPROCESSORS_ONLN);
+    threads=online>0? (usize)online : 1;
+  }
+  return threads<THREAD_POOL_MAX_THREADS? threads : THREAD_POOL_MAX_THREADS;
+}
+
+static
+void _thread_pool_pin(usize worker) {
+  cpu_set_t allowed;
+  if(sched_getaffinity(0,sizeof(allowed),&allowed)!=0 || CPU_COUNT(&allowed)==0) {
+    return;
+  }
+  usize nth=worker%(usize)CPU_COUNT(&allowed);
+  for(usize cpu=0;cpu<CPU_SETSIZE;cpu++) {
+    if(!CPU_ISSET(cpu,&allowed)) {
+      continue;
+    }
+    if(nth--==0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu,&set);
+      pthread_setaffinity_np(pthread_self(),sizeof(set),&set);
+      return;
+    }
+  }
+}
+
+
+static inline_always
+void _thread_pool_slot_lock(_ThreadPoolSlot* slot) {
+  while(__atomic_exchange_n(&slot->lock,1,__ATOMIC_ACQUIRE)) {
+    while(__atomic_load_n(&slot->lock,__ATOMIC_RELAXED)) {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+    }
+  }
+}
+
+static inline_always
+void _thread_pool_slot_unlock(_ThreadPoolSlot* slot) {
+  __atomic_store_n(&slot->lock,0,__ATOMIC_RELEASE);
+}
+
+/// Takes the first block of the slot of `thread`.
+static
+bool _thread_pool_pop(usize thread,usize* block) {
+  _ThreadPoolSlot* slot=&_pool.slots[thread];
+  _thread_pool_slot_lock(slot);
+  const bool found=slot->begin<slot->end;
+  if(found) {
+    *block=slot->begin++;
+  }
+  _thread_pool_slot_unlock(slot);
+  return found;
+}
+
+/// Moves the back half of the first non-empty slot after the one of `thread` to it, and
+/// takes the first block of that half.
+static
+bool _thread_pool_steal(usize thread,usize threads,usize* block) {
+  for(usize k=1;k<threads;k++) {
+    _ThreadPoolSlot* victim=&_pool.slots[(thread+k)%threads];
+    _thread_pool_slot_lock(victim);
+    const usize left=victim->end-victim->begin;
+    if(left==0) {
+      _thread_pool_slot_unlock(victim);
+      continue;
+    }
+    const usize end=victim->end;
+    victim->end-=(left+1)/2;
+    const usize begin=victim->end;
+    _thread_pool_slot_unlock(victim);
+
+    _ThreadPoolSlot* slot=&_pool.slots[thread];
+    _thread_pool_slot_lock(slot);
+    slot->begin=begin+1;
+    slot->end=end;
+    _thread_pool_slot_unlock(slot);
+    *block=begin;
+    return true;
+  }
+  return false;
+}
+
+/// Runs blocks of `job` as `thread` until there are none left to take or steal.
+static
+void _thread_pool_run(const _ThreadPoolJob* job,usize thread) {
+  usize block;
+  while(_thread_pool_pop(thread,&block) || _thread_pool_steal(thread,job->threads,&block)) {
+    const usize begin=block*job->grain;
+    const usize end=job->n-begin<job->grain? job->n : begin+job->grain;
+    job->fn(job->ctx,begin,end);
+  }
+}
+
+static void* _thread_pool_worker_main(void* arg) {
+  const usize thread=(usize)arg;
+  _inside_job=true;
+  pthread_mutex_lock(&_pool.lock);
+  if(_pool.options.pin) {
+    _thread_pool_pin(thread);
+  }
+  // The caller that started this worker may have published its job already.
+  u64 seen=_pool.started_at;
+  for(;;) {
+    while(_pool.generation==seen && !_pool.stop) {
+      pthread_cond_wait(&_pool.wake,&_pool.lock);
+    }
+    if(_pool.stop) {
+      break;
+    }
+    seen=_pool.generation;
+    const _ThreadPoolJob job=_pool.job;
+    pthread_mutex_unlock(&_pool.lock);
+    if(thread<job.threads) {
+      _thread_pool_run(&job,thread);
+    }
+    pthread_mutex_lock(&_pool.lock);
+    if(++_pool.finished==_pool.threads-1) {
+      pthread_cond_signal(&_pool.idle);
+    }
+  }
+  pthread_mutex_unlock(&_pool.lock);
+  return NULL;
+}
+
+/// Starts the workers if they aren't running. Called with `_pool.lock` held.
+static
+void _thread_pool_start() {
+  if(_pool.threads>0) {
+    return;
+  }
+  const usize threads=_thread_pool_resolve(_pool.options);
+  _pool.started_at=_pool.generation;
+  usize started=1;
+  while(started<threads) {
+    if(pthread_create(&_pool.workers[started],NULL,_thread_pool_worker_main,(void*)started)!=0) {
+      break;
+    }
+    started++;
+  }
+  _pool.threads=started;
+}
+
+
+/// Sets up the pool for the jobs that follow, stopping its workers so the next job starts
+/// them with `options`.
+///
+/// # Panics
+///
+/// Will panic if a job is running when `cmeth_assert` is enabled.
+void cmeth_thread_pool_configure(ThreadPoolOptions options) {
+  cmeth_thread_pool_shutdown();
+  pthread_mutex_lock(&_pool.lock);
+  _pool.options=options;
+  pthread_mutex_unlock(&_pool.lock);
+}
+
+/// Stops the workers of the pool and waits for them to exit. The next job starts them
+/// again.
+///
+/// # Panics
+///
+/// Will panic if a job is running when `cmeth_assert` is enabled.
+void cmeth_thread_pool_shutdown() {
+  pthread_mutex_lock(&_pool.lock);
+  cmeth_assert(!_pool.busy);
+  const usize threads=_pool.threads;
+  _pool.stop=true;
+  pthread_cond_broadcast(&_pool.wake);
+  pthread_mutex_unlock(&_pool.lock);
+  for(usize k=1;k<threads;k++) {
+    pthread_join(_pool.workers[k],NULL);
+  }
+  pthread_mutex_lock(&_pool.lock);
+  _pool.threads=0;
+  _pool.stop=false;
+  pthread_mutex_unlock(&_pool.lock);
+}
+
+/// Returns how many threads a job runs on, the caller included.
+const usize cmeth_thread_pool_threads() {
+  pthread_mutex_lock(&_pool.lock);
+  const usize threads=_pool.threads>0? _pool.threads : _thread_pool_resolve(_pool.options);
+  pthread_mutex_unlock(&_pool.lock);
+  return threads;
+}
+
+/// Returns `true` on a thread running a share of a job, and on any thread while a job is
+/// running. A `cmeth_parallel_for` runs serially then, and so should code that starts
+/// threads of its own, like `bvh_build` and `kdtree_build`, lest it oversubscribe.
+const bool cmeth_thread_pool_in_job() {
+  if(_inside_job) {
+    return true;
+  }
+  pthread_mutex_lock(&_pool.lock);
+  const bool busy=_pool.busy;
+  pthread_mutex_unlock(&_pool.lock);
+  return busy;
+}
+
+/// Calls `fn(ctx,begin,end)` on disjoint ranges covering `[0,n)` on the threads of the
+/// pool, the calling one included, and returns once all of them are done.
+///
+/// Ranges hold `grain` elements at least (besides the last one) and start at multiples of
+/// it; 0 is taken as 1. Which thread runs a range, and in which order, is unspecified.
+void cmeth_parallel_for(usize n,usize grain,ParallelForFn fn,void* ctx) {
+  cmeth_parallel_for_threads(n,grain,0,fn,ctx);
+}
+
+/// Works like `cmeth_parallel_for` on at most `threads` threads of the pool (0 uses all
+/// of them).
+void cmeth_parallel_for_threads(usize n,usize grain,usize threads,ParallelForFn fn,void* ctx) {
+  if(n==0) {
+    return;
+  }
+  grain=grain>0? grain : 1;
+  if(_inside_job || n<=grain || threads==1) {
+    fn(ctx,0,n);
+    return;
+  }
+
+  pthread_mutex_lock(&_pool.lock);
+  if(_pool.busy) {
+    pthread_mutex_unlock(&_pool.lock);
+    fn(ctx,0,n);
+    return;
+  }
+  _thread_pool_start();
+  threads=threads==0 || threads>_pool.threads? _pool.threads : threads;
+  // Widen the grain to about `THREAD_POOL_BLOCKS_PER_THREAD` blocks per thread, keeping
+  // it a multiple of the one asked for.
+  const usize target=n/(threads*THREAD_POOL_BLOCKS_PER_THREAD);
+  if(target>grain) {
+    grain*=target/grain;
+  }
+  const usize blocks=(n+grain-1)/grain;
+  threads=threads<blocks? threads : blocks;
+  if(threads==1) {
+    pthread_mutex_unlock(&_pool.lock);
+    fn(ctx,0,n);
+    return;
+  }
+
+  for(usize k=0;k<threads;k++) {
+    _pool.slots[k].begin=blocks*k/threads;
+    _pool.slots[k].end=blocks*(k+1)/threads;
+  }
+  _pool.job=(_ThreadPoolJob){fn,ctx,n,grain,threads};
+  _pool.busy=true;
+  _pool.finished=0;
+  _pool.generation++;
+  pthread_cond_broadcast(&_pool.wake);
+  pthread_mutex_unlock(&_pool.lock);
+
+  _inside_job=true;
+  const _ThreadPoolJob job={fn,ctx,n,grain,threads};
+  _thread_pool_run(&job,0);
+  _inside_job=false;
+
+  pthread_mutex_lock(&_pool.lock);
+  while(_pool.finished<_pool.threads-1) {
+    pthread_cond_wait(&_pool.idle,&_pool.lock);
+  }
+  _pool.busy=false;
+  pthread_mutex_unlock(&_pool.lock);
+}
@@ -0,0 +1,46 @@
+#ifndef CMETH_THREAD_POOL_H
+#define CMETH_THREAD_POOL_H
+#include "../prelude.h"
+
+
+/// How the shared worker pool behind `cmeth_parallel_for` is set up.
+typedef struct {
+  /// Threads running a job, the caller included. 0 reads `CMETH_THREADS_ENV`, or uses
+  /// every online CPU when it is unset.
+  usize threads;
+  /// Binds worker `k` to the `k`-th CPU the process may run on, wrapping around.
+  bool pin;
+} ThreadPoolOptions;
+
+#define THREAD_POOL_OPTIONS_DEFAULT ((ThreadPoolOptions){.threads=0,.pin=false})
+
+/// Threads in the pool at most, the caller included.
+#define THREAD_POOL_MAX_THREADS 256
+
+/// Name of the environment variable read for the thread count when
+/// `ThreadPoolOptions.threads` is 0.
+#define CMETH_THREADS_ENV "CMETH_THREADS"
+
+/// Elements per chunk at least for the `_parallel` array kernels.
+///
+/// A multiple of every kernel's lane count, so only the last chunk runs a scalar tail, and
+/// large enough that a chunk outweighs stealing it.
+#define CMETH_PARALLEL_GRAIN 4096
+
+/// Runs on the elements `[begin,end)` of a `cmeth_parallel_for` range.
+typedef void (*ParallelForFn)(void* ctx,usize begin,usize end);
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+void cmeth_thread_pool_configure(ThreadPoolOptions options);
+void cmeth_thread_pool_shutdown();
+const usize cmeth_thread_pool_threads();
+const bool cmeth_thread_pool_in_job();
+void cmeth_parallel_for(usize n,usize grain,ParallelForFn fn,void* ctx);
+void cmeth_parallel_for_threads(usize n,usize grain,usize threads,ParallelForFn fn,void* ctx);
+#ifdef _cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef CMETH_U32_H
+#define CMETH_U32_H
+
+#include "uvec3.h"
+
+#endif
\ No newline at end of file
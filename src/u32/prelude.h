@@ -0,0 +1,6 @@
+#ifndef CMETH_U32_PRELUDE_H
+#define CMETH_U32_PRELUDE_H
+
+#include "../prelude.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,474 @@
+#include "uvec3.h"
+#include "../f32/math_impl.h"
+#include "prelude.h"
+
+
+/// Creates a 3-dimensional vector.
+inline_always
+const UVec3 uvec3(u32 x,u32 y,u32 z) {
+  return uvec3_new(x,y,z);
+}
+
+/// Creates a new vector.
+inline_always
+const UVec3 uvec3_new(u32 x,u32 y,u32 z) {
+  UVec3 vec={
+    .x=x,
+    .y=y,
+    .z=z
+  };
+  return vec;
+}
+
+/// Creates a vector with all elements set to `v`.
+inline
+const UVec3 uvec3_splat(u32 v) {
+  UVec3 vec={
+    .x=v,
+    .y=v,
+    .z=v
+  };
+  return vec;
+}
+
+/// `if_true` if `mask` and `if_false` otherwise, as a bitwise blend.
+static inline_always
+const u32 _uvec3_select_element(bool mask,u32 if_true,u32 if_false) {
+  const u32 bits=-(u32)mask;
+  return (if_true & bits) | (if_false & ~bits);
+}
+
+/// Creates a vector from the elements in `if_true` and `if_false`, selecting which to use
+/// for each element of `self`.
+///
+/// A true element in the mask uses the corresponding element from `if_true`, and false
+/// uses the element from `if_false`. It does not branch.
+inline
+const UVec3 uvec3_select(BVec3 mask,UVec3 if_true,UVec3 if_false) {
+  UVec3 vec={
+    .x=_uvec3_select_element(mask.x,if_true.x,if_false.x),
+    .y=_uvec3_select_element(mask.y,if_true.y,if_false.y),
+    .z=_uvec3_select_element(mask.z,if_true.z,if_false.z),
+  };
+
+  return vec;
+}
+
+/// Creates a new vector from an array.
+inline
+const UVec3 uvec3_from_array(u32 a[3]) {
+  UVec3 vec={
+    .x=a[0],
+    .y=a[1],
+    .z=a[2]
+  };
+  return vec;
+}
+
+/// Writes the elements of `self` to the first 3 elements in `slice`.
+inline
+void uvec3_write_to_slice(UVec3 self,u32* slice) {
+  slice[0]=self.x;
+  slice[1]=self.y;
+  slice[2]=self.z;
+}
+
+/// Creates a 3D vector from `self` with the given value of `x`.
+inline
+const UVec3 uvec3_with_x(UVec3 self,u32 x) {
+  self.x=x;
+  return self;
+}
+
+/// Creates a 3D vector from `self` with the given value of `y`.
+inline
+const UVec3 uvec3_with_y(UVec3 self,u32 y) {
+  self.y=y;
+  return self;
+}
+
+/// Creates a 3D vector from `self` with the given value of `z`.
+inline
+const UVec3 uvec3_with_z(UVec3 self,u32 z) {
+  self.z=z;
+  return self;
+}
+
+/// Computes the dot product of `self` and `rhs`, wrapping on overflow.
+inline
+const u32 uvec3_dot(UVec3 self,UVec3 rhs) {
+  return (self.x*rhs.x)+(self.y*rhs.y)+(self.z*rhs.z);
+}
+
+/// Computes the cross product of `self` and `rhs`, wrapping on overflow.
+inline
+const UVec3 uvec3_cross(UVec3 self,UVec3 rhs) {
+  UVec3 vec={
+    .x=self.y * rhs.z - rhs.y * self.z,
+    .y=self.z * rhs.x - rhs.z * self.x,
+    .z=self.x * rhs.y - rhs.x * self.y,
+  };
+
+  return vec;
+}
+
+/// Returns a vector containing the minimum values for each element of `self` and `rhs`.
+inline
+const UVec3 uvec3_min(UVec3 self,UVec3 rhs) {
+  UVec3 vec={
+    .x=self.x<rhs.x? self.x : rhs.x,
+    .y=self.y<rhs.y? self.y : rhs.y,
+    .z=self.z<rhs.z? self.z : rhs.z
+  };
+  return vec;
+}
+
+/// Returns a vector containing the maximum values for each element of `self` and `rhs`.
+inline
+const UVec3 uvec3_max(UVec3 self,UVec3 rhs) {
+  UVec3 vec={
+    .x=self.x>rhs.x? self.x : rhs.x,
+    .y=self.y>rhs.y? self.y : rhs.y,
+    .z=self.z>rhs.z? self.z : rhs.z
+  };
+  return vec;
+}
+
+/// Component-wise clamping of values.
+///
+/// Each element in `min` must be less-or-equal to the corresponding element in `max`.
+///
+/// # Panics
+///
+/// Will panic if `min` is greater than `max` when `cmeth_assert` is enabled.
+inline
+const UVec3 uvec3_clamp(UVec3 self,UVec3 min,UVec3 max) {
+  cmeth_assert(bvec3_all(uvec3_cmple(min,max)));
+  return uvec3_min(uvec3_max(self,min),max);
+}
+
+/// Returns the horizontal minimum of `self`.
+inline
+const u32 uvec3_min_element(UVec3 self) {
+  const u32 yz=self.y<self.z? self.y : self.z;
+  return self.x<yz? self.x : yz;
+}
+
+/// Returns the horizontal maximum of `self`.
+inline
+const u32 uvec3_max_element(UVec3 self) {
+  const u32 yz=self.y>self.z? self.y : self.z;
+  return self.x>yz? self.x : yz;
+}
+
+/// Returns the sum of all elements of `self`, wrapping on overflow.
+inline
+const u32 uvec3_element_sum(UVec3 self) {
+  return self.x+self.y+self.z;
+}
+
+/// Returns the product of all elements of `self`, wrapping on overflow.
+inline
+const u32 uvec3_element_product(UVec3 self) {
+  return self.x*self.y*self.z;
+}
+
+/// Returns a vector mask containing the result of a `==` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 uvec3_cmpeq(UVec3 self,UVec3 rhs) {
+  return bvec3_new(self.x==rhs.x,self.y==rhs.y,self.z==rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `!=` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 uvec3_cmpne(UVec3 self,UVec3 rhs) {
+  return bvec3_new(self.x!=rhs.x,self.y!=rhs.y,self.z!=rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `>=` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 uvec3_cmpge(UVec3 self,UVec3 rhs) {
+  return bvec3_new(self.x>=rhs.x,self.y>=rhs.y,self.z>=rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `>` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 uvec3_cmpgt(UVec3 self,UVec3 rhs) {
+  return bvec3_new(self.x>rhs.x,self.y>rhs.y,self.z>rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `<=` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 uvec3_cmple(UVec3 self,UVec3 rhs) {
+  return bvec3_new(self.x<=rhs.x,self.y<=rhs.y,self.z<=rhs.z);
+}
+
+/// Returns a vector mask containing the result of a `<` comparison for each element of
+/// `self` and `rhs`.
+inline
+const BVec3 uvec3_cmplt(UVec3 self,UVec3 rhs) {
+  return bvec3_new(self.x<rhs.x,self.y<rhs.y,self.z<rhs.z);
+}
+
+/// Returns `true` if all elements of `self` and `rhs` are equal.
+inline
+const bool uvec3_eq(UVec3 self,UVec3 rhs) {
+  return ((self.x^rhs.x) | (self.y^rhs.y) | (self.z^rhs.z))==0;
+}
+
+/// The splitmix64 finalizer: every input bit affects every output bit.
+static inline_always
+const u64 _uvec3_mix(u64 h) {
+  h=(h^(h>>30))*0xbf58476d1ce4e5b9u;
+  h=(h^(h>>27))*0x94d049bb133111ebu;
+  return h^(h>>31);
+}
+
+/// Hashes `self` to 64 well-mixed bits, for hash tables keyed by cell or voxel
+/// coordinates. Equal vectors hash equally; the hash is not seeded.
+inline
+const u64 uvec3_hash(UVec3 self) {
+  return _uvec3_mix(((u64)self.x | ((u64)self.y<<32))^_uvec3_mix(self.z));
+}
+
+/// Computes the squared length of `self`, wrapping on overflow.
+inline
+const u32 uvec3_len_squared(UVec3 self) {
+  return uvec3_dot(self,self);
+}
+
+static inline_always
+const u32 _uvec3_saturating_add(u32 a,u32 b) {
+  const u32 sum=a+b;
+  return sum<a? UINT32_MAX : sum;
+}
+
+static inline_always
+const u32 _uvec3_saturating_sub(u32 a,u32 b) {
+  return a>b? a-b : 0;
+}
+
+/// Returns the element-wise sum of `self` and `rhs`, saturating at `UINT32_MAX`.
+inline
+const UVec3 uvec3_saturating_add(UVec3 self,UVec3 rhs) {
+  UVec3 vec={
+    .x=_uvec3_saturating_add(self.x,rhs.x),
+    .y=_uvec3_saturating_add(self.y,rhs.y),
+    .z=_uvec3_saturating_add(self.z,rhs.z)
+  };
+  return vec;
+}
+
+/// Returns the element-wise difference of `self` and `rhs`, saturating at `0`.
+inline
+const UVec3 uvec3_saturating_sub(UVec3 self,UVec3 rhs) {
+  UVec3 vec={
+    .x=_uvec3_saturating_sub(self.x,rhs.x),
+    .y=_uvec3_saturating_sub(self.y,rhs.y),
+    .z=_uvec3_saturating_sub(self.z,rhs.z)
+  };
+  return vec;
+}
+
+/// Converts `self` to a `Vec3`, rounding elements above `2^24` to the nearest `f32`.
+inline
+const Vec3 uvec3_as_vec3(UVec3 self) {
+  return vec3_new((f32)self.x,(f32)self.y,(f32)self.z);
+}
+
+/// The integer part of `v`, saturated to `[0,UINT32_MAX]`. `NaN` is `0`.
+static inline_always
+const u32 _uvec3_saturate(f32 v) {
+  // Every f32 from 2^31 up is even, so the halving below is exact.
+  if(v>=0x1p32F) {
+    return UINT32_MAX;
+  }
+  if(v>=0x1p31F) {
+    return ((u32)(i32)(v-0x1p31F))|0x80000000u;
+  }
+  return v>-1.0F? (u32)(i32)v : 0;
+}
+
+/// Converts `v` to a `UVec3`, truncating each element towards zero.
+///
+/// Elements below `0` become `0`, elements at or above `2^32` become `UINT32_MAX` and `NaN`
+/// becomes `0`, rather than the undefined behaviour of a `(u32)` cast.
+inline
+const UVec3 vec3_as_uvec3(Vec3 v) {
+  return uvec3_new(_uvec3_saturate(v.x),_uvec3_saturate(v.y),_uvec3_saturate(v.z));
+}
+
+/// Converts `v` to a `UVec3` of the largest integers less than or equal to each element,
+/// saturating as `vec3_as_uvec3` does.
+inline
+const UVec3 vec3_floor_as_uvec3(Vec3 v) {
+  return vec3_as_uvec3(vec3_floor(v));
+}
+
+/// Returns a vector with all elements set to `0`.
+inline_always
+const UVec3 uvec3_default() {
+  return UVEC3_ZERO;
+}
+
+/// Returns the element-wise quotient of `self` and `rhs`, rounded towards zero.
+///
+/// # Panics
+///
+/// Will panic if any element of `rhs` is zero when `cmeth_assert` is enabled.
+inline
+const UVec3 uvec3_div(UVec3 self,UVec3 rhs) {
+  cmeth_assert(rhs.x!=0 && rhs.y!=0 && rhs.z!=0);
+  UVec3 vec={
+    .x=self.x/rhs.x,
+    .y=self.y/rhs.y,
+    .z=self.z/rhs.z
+  };
+  return vec;
+}
+
+inline
+void uvec3_div_assign(UVec3* self,UVec3 rhs) {
+  *self=uvec3_div(*self,rhs);
+}
+
+/// Returns `self` with every element divided by `rhs`.
+inline
+const UVec3 uvec3_div_u32(UVec3 self,u32 rhs) {
+  return uvec3_div(self,uvec3_splat(rhs));
+}
+
+inline
+void uvec3_div_assign_u32(UVec3* self,u32 rhs) {
+  *self=uvec3_div_u32(*self,rhs);
+}
+
+/// Returns the element-wise product of `self` and `rhs`, wrapping on overflow.
+inline
+const UVec3 uvec3_mul(UVec3 self,UVec3 rhs) {
+  UVec3 vec={
+    .x=self.x*rhs.x,
+    .y=self.y*rhs.y,
+    .z=self.z*rhs.z
+  };
+  return vec;
+}
+
+inline
+void uvec3_mul_assign(UVec3* self,UVec3 rhs) {
+  *self=uvec3_mul(*self,rhs);
+}
+
+/// Returns `self` with every element multiplied by `rhs`, wrapping on overflow.
+inline
+const UVec3 uvec3_mul_u32(UVec3 self,u32 rhs) {
+  return uvec3_mul(self,uvec3_splat(rhs));
+}
+
+inline
+void uvec3_mul_assign_u32(UVec3* self,u32 rhs) {
+  *self=uvec3_mul_u32(*self,rhs);
+}
+
+/// Returns the element-wise sum of `self` and `rhs`, wrapping on overflow.
+inline
+const UVec3 uvec3_add(UVec3 self,UVec3 rhs) {
+  UVec3 vec={
+    .x=self.x+rhs.x,
+    .y=self.y+rhs.y,
+    .z=self.z+rhs.z
+  };
+  return vec;
+}
+
+inline
+void uvec3_add_assign(UVec3* self,UVec3 rhs) {
+  *self=uvec3_add(*self,rhs);
+}
+
+/// Returns `self` with `rhs` added to every element, wrapping on overflow.
+inline
+const UVec3 uvec3_add_u32(UVec3 self,u32 rhs) {
+  return uvec3_add(self,uvec3_splat(rhs));
+}
+
+inline
+void uvec3_add_assign_u32(UVec3* self,u32 rhs) {
+  *self=uvec3_add_u32(*self,rhs);
+}
+
+/// Returns the element-wise difference of `self` and `rhs`, wrapping on overflow.
+inline
+const UVec3 uvec3_sub(UVec3 self,UVec3 rhs) {
+  UVec3 vec={
+    .x=self.x-rhs.x,
+    .y=self.y-rhs.y,
+    .z=self.z-rhs.z
+  };
+  return vec;
+}
+
+inline
+void uvec3_sub_assign(UVec3* self,UVec3 rhs) {
+  *self=uvec3_sub(*self,rhs);
+}
+
+/// Returns `self` with `rhs` subtracted from every element, wrapping on overflow.
+inline
+const UVec3 uvec3_sub_u32(UVec3 self,u32 rhs) {
+  return uvec3_sub(self,uvec3_splat(rhs));
+}
+
+inline
+void uvec3_sub_assign_u32(UVec3* self,u32 rhs) {
+  *self=uvec3_sub_u32(*self,rhs);
+}
+
+/// Returns the element-wise remainder of `self` and `rhs`.
+///
+/// # Panics
+///
+/// Will panic if any element of `rhs` is zero when `cmeth_assert` is enabled.
+inline
+const UVec3 uvec3_rem(UVec3 self,UVec3 rhs) {
+  cmeth_assert(rhs.x!=0 && rhs.y!=0 && rhs.z!=0);
+  UVec3 vec={
+    .x=self.x%rhs.x,
+    .y=self.y%rhs.y,
+    .z=self.z%rhs.z
+  };
+  return vec;
+}
+
+inline
+void uvec3_rem_assign(UVec3* self,UVec3 rhs) {
+  *self=uvec3_rem(*self,rhs);
+}
+
+inline
+const UVec3 uvec3_rem_u32(UVec3 self,u32 rhs) {
+  return uvec3_rem(self,uvec3_splat(rhs));
+}
+
+inline
+void uvec3_rem_assign_u32(UVec3* self,u32 rhs) {
+  *self=uvec3_rem_u32(*self,rhs);
+}
+
+/// Returns a pointer to the element at `index`.
+///
+/// Panics if `index` is greater than 2.
+inline
+const u32* uvec3_index(UVec3* self,usize index) {
+  switch(index) {
+    case 0: return &self->x;
+    case 1: return &self->y;
+    case 2: return &self->z;
+    default: panic("index out of bounds")
+  }
+}
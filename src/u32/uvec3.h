@@ -0,0 +1,102 @@
+#ifndef CMETH_U32_UVEC3_H
+#define CMETH_U32_UVEC3_H
+#include "../prelude.h"
+#include "../bool/bvec3.h"
+#include "../f32/vec3.h"
+
+
+typedef struct {
+  u32 x;
+  u32 y;
+  u32 z;
+} UVec3;
+
+#ifdef _cplusplus
+extern "C" {
+#endif
+CMETH_API const UVec3 uvec3(u32 x,u32 y,u32 z);
+CMETH_API const UVec3 uvec3_new(u32 x,u32 y,u32 z);
+CMETH_API const UVec3 uvec3_splat(u32 v);
+CMETH_API const UVec3 uvec3_select(BVec3 mask,UVec3 if_true,UVec3 if_false);
+CMETH_API const UVec3 uvec3_from_array(u32 a[3]);
+CMETH_API void uvec3_write_to_slice(UVec3 self,u32* slice);
+CMETH_API const UVec3 uvec3_with_x(UVec3 self,u32 x);
+CMETH_API const UVec3 uvec3_with_y(UVec3 self,u32 y);
+CMETH_API const UVec3 uvec3_with_z(UVec3 self,u32 z);
+CMETH_API const u32 uvec3_dot(UVec3 self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_cross(UVec3 self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_min(UVec3 self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_max(UVec3 self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_clamp(UVec3 self,UVec3 min,UVec3 max);
+CMETH_API const u32 uvec3_min_element(UVec3 self);
+CMETH_API const u32 uvec3_max_element(UVec3 self);
+CMETH_API const u32 uvec3_element_sum(UVec3 self);
+CMETH_API const u32 uvec3_element_product(UVec3 self);
+CMETH_API const BVec3 uvec3_cmpeq(UVec3 self,UVec3 rhs);
+CMETH_API const BVec3 uvec3_cmpne(UVec3 self,UVec3 rhs);
+CMETH_API const BVec3 uvec3_cmpge(UVec3 self,UVec3 rhs);
+CMETH_API const BVec3 uvec3_cmpgt(UVec3 self,UVec3 rhs);
+CMETH_API const BVec3 uvec3_cmple(UVec3 self,UVec3 rhs);
+CMETH_API const BVec3 uvec3_cmplt(UVec3 self,UVec3 rhs);
+CMETH_API const bool uvec3_eq(UVec3 self,UVec3 rhs);
+CMETH_API const u64 uvec3_hash(UVec3 self);
+CMETH_API const u32 uvec3_len_squared(UVec3 self);
+CMETH_API const UVec3 uvec3_saturating_add(UVec3 self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_saturating_sub(UVec3 self,UVec3 rhs);
+CMETH_API const Vec3 uvec3_as_vec3(UVec3 self);
+CMETH_API const UVec3 vec3_as_uvec3(Vec3 v);
+CMETH_API const UVec3 vec3_floor_as_uvec3(Vec3 v);
+CMETH_API const UVec3 uvec3_default();
+CMETH_API const UVec3 uvec3_div(UVec3 self,UVec3 rhs);
+CMETH_API void uvec3_div_assign(UVec3* self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_div_u32(UVec3 self,u32 rhs);
+CMETH_API void uvec3_div_assign_u32(UVec3* self,u32 rhs);
+CMETH_API const UVec3 uvec3_mul(UVec3 self,UVec3 rhs);
+CMETH_API void uvec3_mul_assign(UVec3* self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_mul_u32(UVec3 self,u32 rhs);
+CMETH_API void uvec3_mul_assign_u32(UVec3* self,u32 rhs);
+CMETH_API const UVec3 uvec3_add(UVec3 self,UVec3 rhs);
+CMETH_API void uvec3_add_assign(UVec3* self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_add_u32(UVec3 self,u32 rhs);
+CMETH_API void uvec3_add_assign_u32(UVec3* self,u32 rhs);
+CMETH_API const UVec3 uvec3_sub(UVec3 self,UVec3 rhs);
+CMETH_API void uvec3_sub_assign(UVec3* self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_sub_u32(UVec3 self,u32 rhs);
+CMETH_API void uvec3_sub_assign_u32(UVec3* self,u32 rhs);
+CMETH_API const UVec3 uvec3_rem(UVec3 self,UVec3 rhs);
+CMETH_API void uvec3_rem_assign(UVec3* self,UVec3 rhs);
+CMETH_API const UVec3 uvec3_rem_u32(UVec3 self,u32 rhs);
+CMETH_API void uvec3_rem_assign_u32(UVec3* self,u32 rhs);
+CMETH_API const u32* uvec3_index(UVec3* self,usize index);
+#ifdef _cplusplus
+}
+#endif
+
+
+/// All zeroes.
+#define UVEC3_ZERO uvec3_splat(0)
+
+/// All ones.
+#define UVEC3_ONE uvec3_splat(1)
+
+/// All `UINT32_MAX`.
+#define UVEC3_MAX uvec3_splat(UINT32_MAX)
+
+/// A unit vector pointing along the positive X axis.
+#define UVEC3_X uvec3_new(1,0,0)
+
+/// A unit vector pointing along the positive Y axis.
+#define UVEC3_Y uvec3_new(0,1,0)
+
+/// A unit vector pointing along the positive Z axis.
+#define UVEC3_Z uvec3_new(0,0,1)
+
+/// The unit axes.
+#define UVEC3_AXES {UVEC3_X,UVEC3_Y,UVEC3_Z}
+
+
+#ifdef CMETH_HEADER_ONLY
+#include "uvec3.c"
+#endif
+
+#endif
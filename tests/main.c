@@ -1,11 +1,554 @@
 #include "../src/f32/vec3.h"
+#include "../src/f32/vec3a.h"
+#include "../src/f32/vec3_soa.h"
+#include "../src/f32/vec3_batch.h"
+#include "../src/f32/math_impl.h"
+#include "../src/f32/trig.h"
+#include "../src/f32/math_batch.h"
+#include "../src/f32/mat4.h"
+#include "../src/f32/affine3a.h"
+#include "../src/f32/affine3a_batch.h"
+#include "../src/f32/quat.h"
+#include "../src/f32/quat_batch.h"
+#include "../src/f32/ray_batch.h"
+#include "../src/f32/bvh.h"
+#include "../src/f32/kdtree.h"
+#include "../src/f32/hash_grid.h"
+#include "../src/f32/vec3_packed.h"
+#include "../src/f32/vec3_buffer.h"
+#include "../src/f32/vec3_reduce.h"
+#include "../src/f64/dvec3.h"
+#include "../src/i32/ivec3.h"
+#include "../src/i32/ivec3_batch.h"
+#include "../src/f64/dvec3_batch.h"
+#include "../src/f64/math_impl.h"
+#include "../src/thread/pool.h"
 #include <stdio.h>
+#include <string.h>
+
+/// Builds a k-d tree and a BVH per element from inside a `cmeth_parallel_for` job.
+typedef struct {
+  const Vec3* points;
+  usize n;
+  const Vec3* vertices;
+  const u32* indices;
+  usize triangles;
+  bool in_job[2];
+  KdTree trees[2];
+  Bvh bvhs[2];
+} _NestedBuilds;
+
+static void _nested_builds(void* ctx,usize begin,usize end) {
+  _NestedBuilds* job=ctx;
+  for(usize i=begin;i<end;i++) {
+    job->in_job[i]=cmeth_thread_pool_in_job();
+    job->trees[i]=kdtree_build(job->points,job->n,4);
+    BvhOptions options=BVH_OPTIONS_DEFAULT;
+    options.threads=4;
+    job->bvhs[i]=bvh_build(job->vertices,job->indices,job->triangles,options);
+  }
+}
+
+/// Möller-Trumbore over every triangle, with the unfused arithmetic of the BVH leaves.
+/// The products are spelled out because the archive's `vec3_dot` and `vec3_cross`
+/// contract into FMA under `-march=native`, and contraction is off so this function does
+/// not fuse them either when the test itself is built that way.
+static __attribute__((optimize("fp-contract=off")))
+bool _soup_closest_hit(const Vec3* soup,usize triangles,Ray ray,BvhHit* hit) {
+  #define SOUP_DOT(a,b) ((a).x*(b).x+(a).y*(b).y+(a).z*(b).z)
+  #define SOUP_CROSS(a,b) vec3_new((a).y*(b).z-(b).y*(a).z,(a).z*(b).x-(b).z*(a).x,(a).x*(b).y-(b).x*(a).y)
+  bool found=false;
+  for(u32 i=0;i<triangles;i++) {
+    const Vec3 e1=vec3_sub(soup[3*i+1],soup[3*i]);
+    const Vec3 e2=vec3_sub(soup[3*i+2],soup[3*i]);
+    const Vec3 p=SOUP_CROSS(ray.dir,e2);
+    const f32 inv_det=1.0F/SOUP_DOT(e1,p);
+    const Vec3 s=vec3_sub(ray.origin,soup[3*i]);
+    const f32 u=SOUP_DOT(s,p)*inv_det;
+    const Vec3 q=SOUP_CROSS(s,e1);
+    const f32 v=SOUP_DOT(ray.dir,q)*inv_det;
+    const f32 t=SOUP_DOT(e2,q)*inv_det;
+    const bool closer=found? t<hit->t : t<=ray.t_max;
+    if(u>=0.0F && u<=1.0F && v>=0.0F && u+v<=1.0F && t>=ray.t_min && closer) {
+      *hit=(BvhHit){t,u,v,i};
+      found=true;
+    }
+  }
+  #undef SOUP_DOT
+  #undef SOUP_CROSS
+  return found;
+}
 
 int main() {
   Vec3 xd=vec3_splat(1.0F);
 
   printf("x: %f, y: %f, z: %f\n",xd.x,xd.y,xd.z);
 
+  Vec3 v=vec3_new(1.5F,-2.0F,3.25F);
+  Vec3A va=vec3a_from_vec3(v);
+  assert(vec3a_dot(va,va)==vec3_dot(v,v));
+  assert(bvec3a_bitmask(vec3a_cmplt(va,VEC3A_ZERO))==vec3_is_negative_bitmask(v));
+  const Vec3A diagonal=vec3a_new(1.0F,1.0F,0.0F);
+  assert(vec3a_abs_diff_eq(vec3a_project_into(diagonal,vec3a_new(2.0F,0.0F,0.0F)),vec3a_new(1.0F,0.0F,0.0F),0.0F));
+  assert(vec3a_abs_diff_eq(vec3a_reject_from(diagonal,vec3a_new(2.0F,0.0F,0.0F)),vec3a_new(0.0F,1.0F,0.0F),0.0F));
+  assert(vec3a_abs_diff_eq(vec3a_project_onto_normalized(diagonal,VEC3A_Y),vec3a_new(0.0F,1.0F,0.0F),0.0F));
+  assert(vec3a_abs_diff_eq(vec3a_reject_from_normalized(diagonal,VEC3A_Y),vec3a_new(1.0F,0.0F,0.0F),0.0F));
+  const BVec3 mask=vec3_cmplt(v,VEC3_ZERO);
+  assert(bvec3_bitmask(bvec3_from_bvec3a(bvec3a_from_bitmask(5)))==5 && bvec3_test(mask,1));
+  assert(bvec3_all(vec3_cmpeq(vec3_select(mask,VEC3_ZERO,v),vec3_new(1.5F,0.0F,3.25F))));
+  assert(vec3_abs_diff_eq(vec3_from_vec3a(vec3a_cross(va,VEC3A_X)),vec3_cross(v,VEC3_X),0.0F));
+  assert(f32_abs(vec3_len(vec3_normalize_fast(v))-1.0F)<=4e-7F);
+  assert(vec3_abs_diff_eq(vec3_normalize_or_zero_fast(VEC3_ZERO),VEC3_ZERO,0.0F));
+
+  f32 px[11],py[11],pz[11],lens[12];
+  for(usize i=0;i<11;i++) {
+    px[i]=(f32)i;
+    py[i]=0.0F;
+    pz[i]=0.0F;
+  }
+  lens[11]=-1.0F;
+  vec3_soa_len(vec3_soa(px,py,pz,11),lens);
+  assert(lens[10]==10.0F && lens[11]==-1.0F);
+
+  // The FMA kernels match the `_fma` value functions bit for bit; `px` is also `out`.
+  const Vec3 fa=vec3_new(0.1F,-3.0F,1e-3F),fb=vec3_new(7.0F,0.3F,-2.5F);
+  assert(vec3_dot_fma(fa,fb)==f32_mul_add(fa.z,fb.z,f32_mul_add(fa.y,fb.y,fa.x*fb.x)));
+  assert(vec3_abs_diff_eq(vec3_cross_fma(fa,fb),vec3_cross(fa,fb),1e-6F));
+  assert(vec3_abs_diff_eq(vec3_lerp_fma(fa,fb,0.0F),fa,0.0F) && vec3_abs_diff_eq(vec3_lerp_fma(fa,fb,1.0F),fb,0.0F));
+  f32 qx[11],qy[11],qz[11];
+  for(usize i=0;i<11;i++) {
+    qx[i]=0.3F*(f32)i;
+    qy[i]=1.0F/(f32)(i+1);
+    qz[i]=-0.7F;
+  }
+  const Vec3Soa fma_p=vec3_soa(px,py,pz,11),fma_q=vec3_soa(qx,qy,qz,11);
+  vec3_soa_axpy(0.1F,fma_q,fma_p);
+  assert(vec3_abs_diff_eq(vec3_soa_get(fma_p,10),vec3_mul_add(vec3_splat(0.1F),vec3_new(3.0F,1.0F/11.0F,-0.7F),vec3_new(10.0F,0.0F,0.0F)),0.0F));
+  const Vec3 lerp_from=vec3_soa_get(fma_p,7);
+  vec3_soa_lerp(fma_p,fma_q,0.3F,fma_p);
+  assert(vec3_abs_diff_eq(vec3_soa_get(fma_p,7),vec3_lerp_fma(lerp_from,vec3_soa_get(fma_q,7),0.3F),0.0F));
+  const Vec3 mul_add_from=vec3_soa_get(fma_p,9);
+  vec3_soa_mul_add(fma_p,fma_q,fma_q,fma_p);
+  assert(vec3_abs_diff_eq(vec3_soa_get(fma_p,9),vec3_mul_add(mul_add_from,vec3_soa_get(fma_q,9),vec3_soa_get(fma_q,9)),0.0F));
+
+  f32 angles[11],sines[12],cosines[12];
+  for(usize i=0;i<11;i++) {
+    angles[i]=(f32)i-5.0F;
+  }
+  sines[11]=-2.0F;
+  f32_sincos_batch(angles,sines,cosines,11);
+  assert(sines[11]==-2.0F);
+  for(usize i=0;i<11;i++) {
+    assert(f32_abs(sines[i]-sinf(angles[i]))<=2.0F*F32_EPSILON);
+    assert(f32_abs(cosines[i]-cosf(angles[i]))<=2.0F*F32_EPSILON);
+  }
+
+  // `_atan2f` and its lanes agree on the signed zeros, infinities and NaNs of every
+  // quadrant, bit for bit.
+  const f32 atan2_specials[]={0.0F,-0.0F,1.0F,-1.0F,F32_INFINITY,F32_NEG_INFINITY,F32_NAN};
+  for(usize i=0;i<7;i++) {
+    f32 ys[7],atan2_lanes[7];
+    for(usize j=0;j<7;j++) {
+      ys[j]=atan2_specials[i];
+    }
+    f32_atan2_batch(ys,atan2_specials,atan2_lanes,7);
+    for(usize j=0;j<7;j++) {
+      const f32 expected=atan2f(atan2_specials[i],atan2_specials[j]);
+      const f32 scalar=_atan2f(atan2_specials[i],atan2_specials[j]);
+      assert(f32_is_nan(expected)? f32_is_nan(scalar) : f32_to_bits(scalar)==f32_to_bits(expected));
+      assert(f32_is_nan(expected)? f32_is_nan(atan2_lanes[j]) : f32_to_bits(atan2_lanes[j])==f32_to_bits(expected));
+    }
+  }
+  // `_acos_approx_f32` clamps to [-1,1] first.
+  assert(_acos_approx_f32(2.0F)==0.0F && _acos_approx_f32(F32_NEG_INFINITY)==F32_PI);
+  assert(f32_is_nan(_acos_approx_f32(F32_NAN)));
+
+  // The rounding and Euclidean kernels match the scalar functions bit for bit, including
+  // the lanes past 2^23 that go back to them, and `f32_trunc` no longer wraps past 2^31.
+  assert(f32_trunc(3e9F)==3e9F && f32_to_bits(f32_trunc(-0.5F))==f32_to_bits(-0.0F));
+  assert(f32_div_euclid(-7.0F,2.0F)==-4.0F && f32_div_euclid(-7.0F,-2.0F)==4.0F && f32_rem_euclid(-7.0F,2.0F)==1.0F);
+  const f32 wrap_x[]={-7.0F,7.5F,-0.0F,-6.0F,0.49999997F,-2.5F,1e30F,-1e-30F,F32_INFINITY,F32_NAN,3e9F};
+  const f32 wrap_by[]={2.0F,-2.0F,3.0F,3.0F,0.1F,F32_INFINITY,7.0F,1.0F,1.0F,1.0F,-0.0F};
+  f32 wrap_div[11],wrap_rem[11],wrap_round[11],wrap_floor[11];
+  f32_div_euclid_batch(wrap_x,wrap_by,wrap_div,11);
+  f32_rem_euclid_batch(wrap_x,wrap_by,wrap_rem,11);
+  f32_round_batch(wrap_x,wrap_round,11);
+  f32_floor_batch(wrap_x,wrap_floor,11);
+  for(usize i=0;i<11;i++) {
+    const f32 div=f32_div_euclid(wrap_x[i],wrap_by[i]),rem=f32_rem_euclid(wrap_x[i],wrap_by[i]);
+    assert(f32_is_nan(div)? f32_is_nan(wrap_div[i]) : f32_to_bits(wrap_div[i])==f32_to_bits(div));
+    assert(f32_is_nan(rem)? f32_is_nan(wrap_rem[i]) : f32_to_bits(wrap_rem[i])==f32_to_bits(rem));
+    assert(f32_is_nan(wrap_x[i]) || f32_to_bits(wrap_round[i])==f32_to_bits(f32_round(wrap_x[i])));
+    assert(f32_is_nan(wrap_x[i]) || f32_to_bits(wrap_floor[i])==f32_to_bits(f32_floor(wrap_x[i])));
+  }
+  Vec3 wrap_points[3]={vec3_new(-7.0F,7.5F,-0.0F),vec3_new(-6.0F,0.49999997F,-2.5F),vec3_new(1e30F,-1e-30F,3e9F)};
+  const Vec3 wrap_boxes[3]={vec3_new(2.0F,-2.0F,3.0F),vec3_new(3.0F,0.1F,4.0F),vec3_new(7.0F,1.0F,5.0F)};
+  const Vec3 wrap_expected=vec3_rem_euclid(wrap_points[2],wrap_boxes[2]);
+  vec3_rem_euclid_batch(wrap_points,wrap_boxes,wrap_points,3);
+  assert(vec3_abs_diff_eq(wrap_points[2],wrap_expected,0.0F) && wrap_points[0].x==1.0F);
+
+  Affine3A tf=affine3a_from_mat3_translation(mat3_from_rotation_z(0.5F),vec3_new(1.0F,2.0F,3.0F));
+  assert(affine3a_abs_diff_eq(affine3a_mul_affine3a(tf,affine3a_inverse(tf)),AFFINE3A_IDENTITY,1e-6F));
+  assert(mat4_abs_diff_eq(mat4_mul_mat4(affine3a_to_mat4(tf),mat4_inverse(affine3a_to_mat4(tf))),MAT4_IDENTITY,1e-6F));
+  Vec3 points[11],moved[12];
+  for(usize i=0;i<11;i++) {
+    points[i]=vec3_new((f32)i,-(f32)i,0.5F);
+  }
+  moved[11]=VEC3_NEG_ONE;
+  affine3a_transform_points(&tf,points,moved,11);
+  assert(vec3_abs_diff_eq(moved[11],VEC3_NEG_ONE,0.0F));
+  for(usize i=0;i<11;i++) {
+    assert(vec3_abs_diff_eq(moved[i],affine3a_transform_point3(tf,points[i]),1e-5F));
+  }
+
+  // Packed formats: the batch kernels agree with the scalar codecs, and the tails are left
+  // alone.
+  Vec3F16 halves[12];
+  Vec3Oct32 octs[12];
+  halves[11]=vec3_to_f16(VEC3_NEG_ONE);
+  octs[11]=vec3_to_oct32(VEC3_NEG_ONE);
+  vec3_to_f16_batch(points,halves,11);
+  vec3_to_oct32_batch(moved,octs,11);
+  vec3_from_f16_batch(halves,moved,11);
+  assert(vec3_abs_diff_eq(moved[11],VEC3_NEG_ONE,0.0F));
+  for(usize i=0;i<11;i++) {
+    assert(vec3_abs_diff_eq(moved[i],points[i],0.0F));
+    assert(vec3_abs_diff_eq(vec3_from_oct32(octs[i]),vec3_normalize(affine3a_transform_point3(tf,points[i])),1e-4F));
+  }
+  vec3_from_oct32_batch(octs,moved,12);
+  assert(vec3_abs_diff_eq(moved[11],vec3_normalize(VEC3_NEG_ONE),1e-4F));
+  const Vec3Snorm16 snorm=vec3_to_snorm16(vec3_new(1.5F,-0.25F,F32_NAN));
+  assert(snorm.x==32767 && snorm.y==-8192 && snorm.z==-32767);
+
+  const Quat turn=quat_from_axis_angle(vec3_normalize(vec3_new(1.0F,2.0F,3.0F)),1.2F);
+  assert(vec3_abs_diff_eq(quat_mul_vec3(turn,points[3]),mat3_mul_vec3(mat3_from_quat(turn),points[3]),1e-5F));
+  Quat from[11],to[11],mid[12];
+  for(usize i=0;i<11;i++) {
+    from[i]=quat_from_rotation_x(0.3F*(f32)i);
+    to[i]=quat_from_rotation_y(-0.2F*(f32)i);
+  }
+  mid[11]=QUAT_NAN;
+  quat_slerp_batch(from,to,0.25F,mid,11);
+  assert(quat_is_nan(mid[11]));
+  for(usize i=0;i<11;i++) {
+    assert(quat_abs_diff_eq(mid[i],quat_slerp(from[i],to[i],0.25F),1e-5F));
+  }
+
+  const Aabb unit=aabb_new(VEC3_ZERO,VEC3_ONE);
+  assert(ray_intersect_aabb(ray_new(vec3_new(-1.0F,0.5F,0.5F),VEC3_X),unit)==1.0F);
+  assert(ray_intersect_aabb(ray_new(vec3_new(-1.0F,0.0F,0.5F),VEC3_X),unit)==1.0F);
+  assert(ray_intersect_aabb(ray_new(vec3_new(-1.0F,F32_NAN,0.5F),VEC3_X),unit)==F32_INFINITY);
+  Aabb boxes[11];
+  f32 t_hit[12];
+  for(usize i=0;i<11;i++) {
+    boxes[i]=aabb_from_point(points[i]);
+  }
+  boxes[4]=aabb_grow(unit,0.25F);
+  t_hit[11]=-1.0F;
+  const Ray probe=ray_new(vec3_new(0.5F,0.5F,-2.0F),VEC3_Z);
+  assert(ray_intersect_aabbs(&probe,boxes,t_hit,11)>=1);
+  assert(t_hit[4]==1.75F && t_hit[11]==-1.0F);
+  for(usize i=0;i<11;i++) {
+    assert(t_hit[i]==ray_intersect_aabb(probe,boxes[i]));
+  }
+
+  // Two unit quads facing +z at z=1 and z=3, split into triangles.
+  Vec3 quads[8];
+  u32 quad_indices[12];
+  for(u32 q=0;q<2;q++) {
+    const f32 z=1.0F+2.0F*(f32)q;
+    quads[4*q]=vec3_new(0.0F,0.0F,z);
+    quads[4*q+1]=vec3_new(1.0F,0.0F,z);
+    quads[4*q+2]=vec3_new(1.0F,1.0F,z);
+    quads[4*q+3]=vec3_new(0.0F,1.0F,z);
+    const u32 tris[6]={4*q,4*q+1,4*q+2,4*q,4*q+2,4*q+3};
+    __builtin_memcpy(quad_indices+6*q,tris,sizeof(tris));
+  }
+  for(u32 width=2;width<=8;width+=6) {
+    BvhOptions options=BVH_OPTIONS_DEFAULT;
+    options.width=width;
+    options.max_leaf_size=1;
+    Bvh bvh=bvh_build(quads,quad_indices,4,options);
+    assert(aabb_abs_diff_eq(bvh_bounds(&bvh),aabb_new(vec3_new(0.0F,0.0F,1.0F),vec3_new(1.0F,1.0F,3.0F)),0.0F));
+    BvhHit hit;
+    assert(bvh_closest_hit(&bvh,ray_new(vec3_new(0.25F,0.75F,5.0F),VEC3_NEG_Z),&hit));
+    assert(hit.t==2.0F && hit.triangle==3);
+    assert(bvh_closest_hit(&bvh,probe,&hit) && hit.t==3.0F && hit.triangle<2);
+    assert(bvh_any_hit(&bvh,ray_new_range(vec3_new(0.5F,0.5F,0.0F),VEC3_Z,0.0F,1.0F)));
+    assert(!bvh_any_hit(&bvh,ray_new_range(vec3_new(0.5F,0.5F,0.0F),VEC3_Z,0.0F,0.5F)));
+    assert(!bvh_any_hit(&bvh,ray_new(vec3_new(2.0F,0.5F,0.0F),VEC3_Z)));
+    bvh_free(&bvh);
+  }
+
+  // A soup of random triangles, enough for the build to hand subtrees to other threads.
+  // Both widths find what brute force finds, and the tree is the same on 1 and 4 threads.
+  enum { SOUP_TRIANGLES=8000, SOUP_RAYS=32 };
+  static Vec3 soup[3*SOUP_TRIANGLES];
+  static u32 soup_indices[3*SOUP_TRIANGLES];
+  u32 soup_rng=12345u;
+  f32 rnd[12];
+  #define SOUP_RANDOM(N) \
+    for(u32 k=0;k<(N);k++) { \
+      soup_rng=soup_rng*1664525u+1013904223u; \
+      rnd[k]=(f32)(soup_rng>>8)*0x1p-24F; \
+    }
+  for(u32 i=0;i<SOUP_TRIANGLES;i++) {
+    SOUP_RANDOM(12);
+    const Vec3 center=vec3_new(10.0F*rnd[9],10.0F*rnd[10],10.0F*rnd[11]);
+    for(u32 k=0;k<3;k++) {
+      soup[3*i+k]=vec3_add(center,vec3_new(rnd[3*k]-0.5F,rnd[3*k+1]-0.5F,rnd[3*k+2]-0.5F));
+      soup_indices[3*i+k]=3*i+k;
+    }
+  }
+  Ray soup_rays[SOUP_RAYS];
+  BvhHit soup_hits[SOUP_RAYS];
+  bool soup_found[SOUP_RAYS];
+  for(u32 r=0;r<SOUP_RAYS;r++) {
+    SOUP_RANDOM(6);
+    const Vec3 origin=vec3_new(30.0F*rnd[0]-10.0F,30.0F*rnd[1]-10.0F,-5.0F);
+    const Vec3 target=vec3_new(10.0F*rnd[2],10.0F*rnd[3],10.0F*rnd[4]);
+    soup_rays[r]=ray_new_range(origin,vec3_normalize(vec3_sub(target,origin)),0.0F,5.0F+10.0F*rnd[5]);
+    soup_found[r]=_soup_closest_hit(soup,SOUP_TRIANGLES,soup_rays[r],&soup_hits[r]);
+  }
+  #undef SOUP_RANDOM
+  u32 soup_hit_count=0;
+  for(u32 width=2;width<=8;width+=6) {
+    BvhOptions options=BVH_OPTIONS_DEFAULT;
+    options.width=width;
+    options.threads=1;
+    Bvh serial=bvh_build(soup,soup_indices,SOUP_TRIANGLES,options);
+    options.threads=4;
+    Bvh bvh=bvh_build(soup,soup_indices,SOUP_TRIANGLES,options);
+    assert(bvh.node_count==serial.node_count && bvh.depth==serial.depth);
+    assert(memcmp(bvh.triangles,serial.triangles,SOUP_TRIANGLES*sizeof(u32))==0);
+    if(width==2) {
+      assert(memcmp(bvh.nodes,serial.nodes,bvh.node_count*sizeof(BvhNode))==0);
+    } else {
+      assert(memcmp(bvh.wide_nodes,serial.wide_nodes,bvh.node_count*sizeof(BvhNode8))==0);
+    }
+    bvh_free(&serial);
+    for(u32 r=0;r<SOUP_RAYS;r++) {
+      BvhHit hit;
+      assert(bvh_closest_hit(&bvh,soup_rays[r],&hit)==soup_found[r]);
+      assert(bvh_any_hit(&bvh,soup_rays[r])==soup_found[r]);
+      if(soup_found[r]) {
+        assert(hit.t==soup_hits[r].t && hit.triangle==soup_hits[r].triangle);
+        // The hit itself must match exactly; its barycentrics get a few ulp of slack.
+        assert(f32_abs(hit.u-soup_hits[r].u)<=1e-6F && f32_abs(hit.v-soup_hits[r].v)<=1e-6F);
+        soup_hit_count++;
+      }
+    }
+    bvh_free(&bvh);
+  }
+  assert(soup_hit_count>SOUP_RAYS/2 && soup_hit_count<2*SOUP_RAYS);
+
+  // A 4x4x4 lattice of unit spacing. Next to a corner, the neighbours along x and y tie
+  // and come out by index.
+  Vec3 lattice[64];
+  for(u32 i=0;i<64;i++) {
+    lattice[i]=vec3_new((f32)(i%4),(f32)(i/4%4),(f32)(i/16));
+  }
+  KdTree tree=kdtree_build(lattice,64,2);
+  u32 nearest[10];
+  f32 nearest_d2[10];
+  assert(kdtree_nearest(&tree,vec3_new(0.0F,0.0F,-0.1F),5,F32_INFINITY,nearest,nearest_d2)==5);
+  assert(nearest[0]==0 && nearest[1]==1 && nearest[2]==4 && nearest[3]==16);
+  assert(nearest_d2[0]<0.0101F && nearest_d2[1]==nearest_d2[2]);
+  assert(kdtree_nearest(&tree,vec3_new(1.5F,1.5F,1.5F),5,0.75F,nearest,nearest_d2)==5);
+  assert(kdtree_nearest(&tree,vec3_new(-5.0F,0.0F,0.0F),5,1.0F,nearest,nearest_d2)==0);
+  assert(nearest[0]==KDTREE_NONE && nearest_d2[4]==F32_INFINITY);
+  usize within[2];
+  const Vec3 centers[2]={vec3_new(1.5F,1.5F,1.5F),vec3_new(0.0F,0.0F,0.0F)};
+  kdtree_radius_batch(&tree,centers,2,1.0F,5,nearest,nearest_d2,within,0);
+  assert(within[0]==8 && within[1]==4 && nearest[5]==0 && nearest_d2[5]==0.0F);
+  kdtree_free(&tree);
+
+  // The lattice point at (1,1,1) and its six neighbours at unit distance.
+  HashGrid grid=hash_grid_new(1.0F,2);
+  hash_grid_rebuild(&grid,lattice,64);
+  HashGridIter iter=hash_grid_neighbours(&grid,vec3_new(1.0F,1.0F,1.0F),1.0F);
+  u32 neighbour;
+  f32 neighbour_d2;
+  u32 neighbours=0;
+  f32 neighbours_d2=0.0F;
+  while(hash_grid_next(&iter,&neighbour,&neighbour_d2)) {
+    assert(vec3_distance_squared(lattice[neighbour],vec3_new(1.0F,1.0F,1.0F))==neighbour_d2);
+    neighbours++;
+    neighbours_d2+=neighbour_d2;
+  }
+  assert(neighbours==7 && neighbours_d2==6.0F);
+
+  // Points past +-2^31 cells saturate to one cell each, in the SIMD body and the scalar
+  // tail alike: 77 points are not a whole number of lanes on any tier, and the last one
+  // is in the tail.
+  Vec3 edge_points[77];
+  for(usize i=0;i<77;i++) {
+    edge_points[i]=vec3_new(i%2==0? -3e9F : 3e9F,0.0F,0.0F);
+  }
+  hash_grid_rebuild(&grid,edge_points,77);
+  u32 edge_buckets[77];
+  for(u32 b=0;b<grid.table_size;b++) {
+    for(u32 k=grid.bucket_start[b];k<grid.bucket_start[b+1];k++) {
+      edge_buckets[grid.indices[k]]=b;
+    }
+  }
+  for(usize i=0;i<77;i++) {
+    assert(edge_buckets[i]==edge_buckets[i%2]);
+  }
+  iter=hash_grid_neighbours(&grid,edge_points[0],1.0F);
+  neighbours=0;
+  while(hash_grid_next(&iter,&neighbour,&neighbour_d2)) {
+    assert(neighbour%2==0);
+    neighbours++;
+  }
+  assert(neighbours==39);
+  hash_grid_free(&grid);
+
+  // Earth-radius coordinates keep their centimetres relative to a nearby origin.
+  const DVec3 far=dvec3_new(6371000.25,-1.5,0.125);
+  assert(dvec3_len_squared(dvec3_new(1.0,2.0,2.0))==9.0 && dvec3_len(dvec3_new(1.0,2.0,2.0))==3.0);
+  assert(dvec3_abs_diff_eq(dvec3_cross(DVEC3_X,DVEC3_Y),DVEC3_Z,0.0));
+  assert((f64)dvec3_as_vec3(far).x!=far.x && f64_trunc(1e15+0.5)==1e15);
+  DVec3 far_points[5]={far,dvec3_add(far,DVEC3_ONE),far,far,dvec3_new(6371000.0,0.0,0.0)};
+  Vec3 near_points[6];
+  near_points[5]=VEC3_ONE;
+  dvec3_to_vec3_relative_batch(far_points,dvec3_new(6371000.0,0.0,0.0),near_points,5);
+  assert(near_points[0].x==0.25F && near_points[1].y==-0.5F && near_points[4].z==0.0F);
+  assert(near_points[5].x==1.0F);
+  DVec3 back[5];
+  vec3_to_dvec3_relative_batch(near_points,dvec3_new(6371000.0,0.0,0.0),back,5);
+  assert(back[1].x==6371001.25 && back[1].z==1.125);
+  f64 far_dot[5];
+  dvec3_normalize_or_zero_batch(far_points,back,5);
+  dvec3_dot_batch(back,back,far_dot,5);
+  assert(f64_abs(far_dot[3]-1.0)<1e-15 && dvec3_is_normalized(back[1]));
+
+  // Grid conversions saturate instead of overflowing, and NaN goes to zero.
+  const Vec3 grid_points[5]={vec3_new(-0.5F,2.5F,-2.5F),vec3_new(3e9F,-3e9F,F32_NAN),
+    vec3_new(0.49999997F,-1.0F,1e-40F),vec3_new(1.75F,-1.75F,0.0F),vec3_new(8.0F,-8.0F,7.99F)};
+  IVec3 cells[6];
+  cells[5]=IVEC3_ONE;
+  vec3_floor_as_ivec3_batch(grid_points,cells,5);
+  assert(ivec3_eq(cells[0],ivec3_new(-1,2,-3)) && ivec3_eq(cells[1],ivec3_new(INT32_MAX,INT32_MIN,0)));
+  assert(ivec3_eq(cells[5],IVEC3_ONE));
+  vec3_round_as_ivec3_batch(grid_points,cells,5);
+  assert(ivec3_eq(cells[0],ivec3_new(-1,3,-3)) && ivec3_eq(cells[2],ivec3_new(0,-1,0)));
+  vec3_as_ivec3_batch(grid_points,cells,5);
+  assert(ivec3_eq(cells[3],ivec3_new(1,-1,0)) && ivec3_eq(cells[1],vec3_as_ivec3(grid_points[1])));
+  vec3_grid_cells_batch(grid_points,vec3_new(0.0F,-8.0F,0.0F),2.0F,cells,5);
+  assert(ivec3_eq(cells[4],ivec3_new(4,0,3)) && ivec3_eq(cells[3],ivec3_new(0,3,0)));
+  assert(ivec3_eq(ivec3_div_euclid(ivec3_new(-7,7,-7),ivec3_new(2,-2,-2)),ivec3_new(-4,-3,4)));
+  assert(ivec3_eq(ivec3_rem_euclid(ivec3_new(-7,7,-7),ivec3_new(2,-2,-2)),IVEC3_ONE));
+  assert(ivec3_eq(ivec3_saturating_add(IVEC3_MAX,IVEC3_ONE),IVEC3_MAX) && ivec3_eq(ivec3_abs(IVEC3_MIN),IVEC3_MIN));
+  assert(uvec3_eq(vec3_as_uvec3(vec3_new(-0.5F,3e9F,5e9F)),uvec3_new(0,3000000000u,UINT32_MAX)));
+  assert(ivec3_hash(IVEC3_X)!=ivec3_hash(IVEC3_Y) && ivec3_hash(IVEC3_NEG_ONE)==uvec3_hash(UVEC3_MAX));
+
+  // The in-place transposes keep every point, across a partial last tile.
+  Arena arena=arena_new(4096,false);
+  SizePool size_pool=size_pool_new(false);
+  static Vec3 buffer_in[1000],buffer_out[1000];
+  for(usize i=0;i<1000;i++) {
+    buffer_in[i]=vec3_new((f32)i,-(f32)i*0.5F,(f32)(i%7));
+  }
+  Vec3Buffer buffers[3]={vec3_buffer_new(1000,false),vec3_buffer_new_in_arena(&arena,1000),vec3_buffer_new_in_pool(&size_pool,1000)};
+  for(usize k=0;k<3;k++) {
+    assert((usize)buffers[k].data%CMETH_ALIGN==0 && buffers[k].capacity>=1000);
+    vec3_buffer_assign(&buffers[k],buffer_in,1000);
+    vec3_buffer_to_soa(&buffers[k]);
+    const Vec3Soa planes=vec3_buffer_soa(&buffers[k]);
+    assert(planes.x[999]==999.0F && planes.y[999]==-499.5F && planes.z[999]==5.0F);
+    assert(vec3_abs_diff_eq(vec3_buffer_get(&buffers[k],3),buffer_in[3],0.0F));
+    vec3_buffer_to_aos(&buffers[k]);
+    assert(memcmp(vec3_buffer_aos(&buffers[k]),buffer_in,sizeof(buffer_in))==0);
+    vec3_buffer_free(&buffers[k]);
+  }
+  static f32 buffer_planes[3*1000];
+  const Vec3Soa buffer_soa=vec3_soa(buffer_planes,buffer_planes+1000,buffer_planes+2000,1000);
+  vec3_aos_to_soa(buffer_in,buffer_soa);
+  vec3_soa_to_aos(buffer_soa,buffer_out);
+  assert(memcmp(buffer_out,buffer_in,sizeof(buffer_in))==0);
+  arena_free(&arena);
+  size_pool_free(&size_pool);
+
+  // The `_parallel` kernels match the sequential ones bit for bit, stolen ranges included.
+  cmeth_thread_pool_configure((ThreadPoolOptions){.threads=4,.pin=false});
+  assert(cmeth_thread_pool_threads()==4);
+  static f32 wide_x[50001],wide_seq[50001],wide_par[50001];
+  static Vec3 wide_in[50001],wide_seq3[50001],wide_par3[50001];
+  for(usize i=0;i<50001;i++) {
+    wide_x[i]=(f32)i*0.37F-9000.0F;
+    wide_in[i]=vec3_new(wide_x[i],(f32)(i%97),-(f32)(i%13));
+  }
+  f32_sin_batch(wide_x,wide_seq,50001);
+  f32_sin_batch_parallel(wide_x,wide_par,50001);
+  for(usize i=0;i<50001;i++) {
+    assert(f32_to_bits(wide_seq[i])==f32_to_bits(wide_par[i]));
+  }
+  const Affine3A wide_transform=affine3a_from_mat3_translation(mat3_from_quat(quat_from_rotation_y(0.3F)),VEC3_ONE);
+  affine3a_transform_points(&wide_transform,wide_in,wide_seq3,50001);
+  affine3a_transform_points_parallel(&wide_transform,wide_in,wide_par3,50001);
+  for(usize i=0;i<50001;i++) {
+    assert(vec3_abs_diff_eq(wide_seq3[i],wide_par3[i],0.0F));
+  }
+  for(usize k=0;k<2;k++) {
+    const Vec3 wide_sum=vec3_sum(wide_in,50001,(Vec3Summation)k);
+    const Vec3 wide_sum_par=vec3_sum_parallel(wide_in,50001,(Vec3Summation)k);
+    assert(memcmp(&wide_sum,&wide_sum_par,sizeof(Vec3))==0);
+    const Mat3 wide_cov=vec3_covariance(wide_in,50001,(Vec3Summation)k);
+    const Mat3 wide_cov_par=vec3_covariance_parallel(wide_in,50001,(Vec3Summation)k);
+    assert(memcmp(&wide_cov,&wide_cov_par,sizeof(Mat3))==0);
+    assert(vec3_abs_diff_eq(vec3_mean(wide_in,50001,(Vec3Summation)k),vec3_new(250.0F,47.9765F,-5.9997F),0.001F));
+  }
+  assert(aabb_abs_diff_eq(vec3_bounds_parallel(wide_in,50001),aabb_from_points(wide_in,50001),0.0F));
+  // Builders started inside a job stay on its thread instead of adding their own, and
+  // build the same trees.
+  assert(!cmeth_thread_pool_in_job());
+  _NestedBuilds nested={wide_in,20000,soup,soup_indices,SOUP_TRIANGLES};
+  cmeth_parallel_for(2,1,_nested_builds,&nested);
+  KdTree wide_tree=kdtree_build(wide_in,20000,1);
+  BvhOptions soup_options=BVH_OPTIONS_DEFAULT;
+  soup_options.threads=1;
+  Bvh soup_bvh=bvh_build(soup,soup_indices,SOUP_TRIANGLES,soup_options);
+  for(usize i=0;i<2;i++) {
+    assert(nested.in_job[i]);
+    assert(memcmp(nested.trees[i].indices,wide_tree.indices,20000*sizeof(u32))==0);
+    assert(memcmp(nested.trees[i].axes,wide_tree.axes,20000)==0);
+    assert(nested.bvhs[i].node_count==soup_bvh.node_count);
+    assert(memcmp(nested.bvhs[i].nodes,soup_bvh.nodes,soup_bvh.node_count*sizeof(BvhNode))==0);
+    kdtree_free(&nested.trees[i]);
+    bvh_free(&nested.bvhs[i]);
+  }
+  kdtree_free(&wide_tree);
+  bvh_free(&soup_bvh);
+  f32_rem_euclid_batch(wide_x,&wide_in[0].y,wide_seq,50001);
+  f32_rem_euclid_batch_parallel(wide_x,&wide_in[0].y,wide_par,50001);
+  for(usize i=0;i<50001;i++) {
+    assert(f32_to_bits(wide_seq[i])==f32_to_bits(wide_par[i]));
+  }
+  const Vec3Soa wide_soa=vec3_soa(wide_x,&wide_seq3[0].x,&wide_seq3[0].y,50001);
+  vec3_soa_dot(wide_soa,wide_soa,wide_seq);
+  vec3_soa_dot_parallel(wide_soa,wide_soa,wide_par);
+  for(usize i=0;i<50001;i++) {
+    assert(f32_to_bits(wide_seq[i])==f32_to_bits(wide_par[i]));
+  }
+  // Ranges start on a point, so the origin stays in phase with the flat kernels.
+  static IVec3 wide_cells_seq[50001],wide_cells_par[50001];
+  vec3_grid_cells_batch(wide_in,vec3_new(0.5F,-1.0F,2.0F),0.75F,wide_cells_seq,50001);
+  vec3_grid_cells_batch_parallel(wide_in,vec3_new(0.5F,-1.0F,2.0F),0.75F,wide_cells_par,50001);
+  assert(memcmp(wide_cells_seq,wide_cells_par,sizeof(wide_cells_seq))==0);
+  static DVec3 wide_d[50001];
+  vec3_to_dvec3_relative_batch_parallel(wide_in,dvec3_new(6.371e6,-3.0,1e-3),wide_d,50001);
+  dvec3_to_vec3_relative_batch_parallel(wide_d,dvec3_new(6.371e6,-3.0,1e-3),wide_par3,50001);
+  dvec3_to_vec3_relative_batch(wide_d,dvec3_new(6.371e6,-3.0,1e-3),wide_seq3,50001);
+  assert(memcmp(wide_seq3,wide_par3,sizeof(wide_seq3))==0);
+  static Quat wide_q[50001],wide_q_seq[50001],wide_q_par[50001];
+  for(usize i=0;i<50001;i++) {
+    wide_q[i]=quat_from_rotation_y(wide_x[i]);
+  }
+  quat_slerp_batch(wide_q,wide_q+1,0.3F,wide_q_seq,50000);
+  quat_slerp_batch_parallel(wide_q,wide_q+1,0.3F,wide_q_par,50000);
+  assert(memcmp(wide_q_seq,wide_q_par,50000*sizeof(Quat))==0);
+  cmeth_thread_pool_shutdown();
+
   return 0;
 }
-